@@ -0,0 +1,289 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the hot paths of the library: module building, the
+// def-use and dominator analyses, the passes registered by
+// RegisterPerformancePasses, and binary validation.
+//
+// Build with -DSPIRV_BUILD_BENCHMARKS=ON and a checkout of Google Benchmark
+// under external/benchmark.  Run with --benchmark_format=json to produce
+// results that can be recorded and compared across releases.
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "source/opt/build_module.h"
+#include "source/opt/cfg.h"
+#include "source/opt/def_use_manager.h"
+#include "source/opt/dominator_analysis.h"
+#include "source/opt/ir_context.h"
+#include "spirv-tools/libspirv.hpp"
+#include "spirv-tools/optimizer.hpp"
+
+namespace {
+
+constexpr spv_target_env kBenchmarkEnv = SPV_ENV_UNIVERSAL_1_3;
+
+// The number of worker functions in the synthetic corpus module.
+constexpr int kCorpusFunctionCount = 16;
+
+// Returns the assembly text of a synthetic compute shader with
+// |num_functions| worker functions.  Each worker runs a counted loop over a
+// function-scope array with loads, stores, integer arithmetic, and a
+// selection construct, so the inliner, the load/store eliminators, the loop
+// unroller, and the scalar optimizations all have work to do.
+std::string MakeCorpusText(int num_functions) {
+  std::ostringstream text;
+  text << R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 64 1 1
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%uint = OpTypeInt 32 0
+%uintfn = OpTypeFunction %uint %uint
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%uint_3 = OpConstant %uint 3
+%uint_8 = OpConstant %uint 8
+%uint_16 = OpConstant %uint 16
+%arr = OpTypeArray %uint %uint_16
+%ptr_uint = OpTypePointer Function %uint
+%ptr_arr = OpTypePointer Function %arr
+)";
+
+  for (int i = 0; i < num_functions; ++i) {
+    const std::string f = "f" + std::to_string(i);
+    text << "%" << f << " = OpFunction %uint None %uintfn\n"
+         << "%" << f << "_p = OpFunctionParameter %uint\n"
+         << "%" << f << "_entry = OpLabel\n"
+         << "%" << f << "_var = OpVariable %ptr_arr Function\n"
+         << "OpBranch %" << f << "_header\n"
+         << "%" << f << "_header = OpLabel\n"
+         << "%" << f << "_i = OpPhi %uint %uint_0 %" << f << "_entry %" << f
+         << "_inext %" << f << "_continue\n"
+         << "%" << f << "_acc = OpPhi %uint %uint_0 %" << f << "_entry %" << f
+         << "_accnext %" << f << "_continue\n"
+         << "%" << f << "_cmp = OpULessThan %bool %" << f << "_i %uint_16\n"
+         << "OpLoopMerge %" << f << "_merge %" << f << "_continue None\n"
+         << "OpBranchConditional %" << f << "_cmp %" << f << "_body %" << f
+         << "_merge\n"
+         << "%" << f << "_body = OpLabel\n"
+         << "%" << f << "_t0 = OpIMul %uint %" << f << "_i %" << f << "_p\n"
+         << "%" << f << "_t1 = OpIAdd %uint %" << f << "_t0 %uint_3\n"
+         << "%" << f << "_gep = OpAccessChain %ptr_uint %" << f << "_var %"
+         << f << "_i\n"
+         << "OpStore %" << f << "_gep %" << f << "_t1\n"
+         << "%" << f << "_ld = OpLoad %uint %" << f << "_gep\n"
+         << "%" << f << "_c2 = OpULessThan %bool %" << f << "_ld %uint_8\n"
+         << "OpSelectionMerge %" << f << "_endif None\n"
+         << "OpBranchConditional %" << f << "_c2 %" << f << "_then %" << f
+         << "_else\n"
+         << "%" << f << "_then = OpLabel\n"
+         << "%" << f << "_v1 = OpIAdd %uint %" << f << "_ld %uint_1\n"
+         << "OpBranch %" << f << "_endif\n"
+         << "%" << f << "_else = OpLabel\n"
+         << "%" << f << "_v2 = OpShiftLeftLogical %uint %" << f
+         << "_ld %uint_1\n"
+         << "OpBranch %" << f << "_endif\n"
+         << "%" << f << "_endif = OpLabel\n"
+         << "%" << f << "_sel = OpPhi %uint %" << f << "_v1 %" << f
+         << "_then %" << f << "_v2 %" << f << "_else\n"
+         << "%" << f << "_accnext = OpIAdd %uint %" << f << "_acc %" << f
+         << "_sel\n"
+         << "OpBranch %" << f << "_continue\n"
+         << "%" << f << "_continue = OpLabel\n"
+         << "%" << f << "_inext = OpIAdd %uint %" << f << "_i %uint_1\n"
+         << "OpBranch %" << f << "_header\n"
+         << "%" << f << "_merge = OpLabel\n"
+         << "OpReturnValue %" << f << "_acc\n"
+         << "OpFunctionEnd\n";
+  }
+
+  text << "%main = OpFunction %void None %voidfn\n"
+       << "%main_entry = OpLabel\n";
+  std::string last_value = "%uint_3";
+  for (int i = 0; i < num_functions; ++i) {
+    const std::string result = "%main_r" + std::to_string(i);
+    text << result << " = OpFunctionCall %uint %f" << i << " " << last_value
+         << "\n";
+    last_value = result;
+  }
+  text << "OpReturn\n"
+       << "OpFunctionEnd\n";
+  return text.str();
+}
+
+// Returns the corpus module as a binary, assembled once on first use.
+const std::vector<uint32_t>& CorpusBinary() {
+  static const std::vector<uint32_t>* const binary = [] {
+    spvtools::SpirvTools tools(kBenchmarkEnv);
+    auto* result = new std::vector<uint32_t>();
+    if (!tools.Assemble(MakeCorpusText(kCorpusFunctionCount), result)) {
+      std::fprintf(stderr, "error: failed to assemble the corpus module\n");
+      std::exit(EXIT_FAILURE);
+    }
+    return result;
+  }();
+  return *binary;
+}
+
+std::unique_ptr<spvtools::opt::IRContext> BuildCorpusContext() {
+  const std::vector<uint32_t>& binary = CorpusBinary();
+  return spvtools::BuildModule(kBenchmarkEnv, nullptr, binary.data(),
+                               binary.size());
+}
+
+void BM_BuildModule(benchmark::State& state) {
+  const std::vector<uint32_t>& binary = CorpusBinary();
+  for (auto _ : state) {
+    std::unique_ptr<spvtools::opt::IRContext> context =
+        spvtools::BuildModule(kBenchmarkEnv, nullptr, binary.data(),
+                              binary.size());
+    benchmark::DoNotOptimize(context);
+  }
+}
+BENCHMARK(BM_BuildModule);
+
+void BM_AnalyzeDefUse(benchmark::State& state) {
+  std::unique_ptr<spvtools::opt::IRContext> context = BuildCorpusContext();
+  for (auto _ : state) {
+    spvtools::opt::analysis::DefUseManager manager(context->module());
+    benchmark::DoNotOptimize(&manager);
+  }
+}
+BENCHMARK(BM_AnalyzeDefUse);
+
+void BM_InitializeDominatorTree(benchmark::State& state) {
+  std::unique_ptr<spvtools::opt::IRContext> context = BuildCorpusContext();
+  const spvtools::opt::CFG* cfg = context->cfg();
+  for (auto _ : state) {
+    for (spvtools::opt::Function& fn : *context->module()) {
+      spvtools::opt::DominatorAnalysis analysis;
+      analysis.InitializeTree(*cfg, &fn);
+      benchmark::DoNotOptimize(&analysis);
+    }
+  }
+}
+BENCHMARK(BM_InitializeDominatorTree);
+
+void BM_Validate(benchmark::State& state) {
+  const std::vector<uint32_t>& binary = CorpusBinary();
+  spv_context context = spvContextCreate(kBenchmarkEnv);
+  for (auto _ : state) {
+    spv_diagnostic diagnostic = nullptr;
+    spv_result_t result =
+        spvValidateBinary(context, binary.data(), binary.size(), &diagnostic);
+    benchmark::DoNotOptimize(result);
+    spvDiagnosticDestroy(diagnostic);
+  }
+  spvContextDestroy(context);
+}
+BENCHMARK(BM_Validate);
+
+// Runs the passes registered by |register_passes| over the corpus.  Each
+// iteration includes building the module from the binary and serializing the
+// result, which is how the optimizer is used through its public interface.
+void RunPassBenchmark(benchmark::State& state,
+                      void (*register_passes)(spvtools::Optimizer*)) {
+  const std::vector<uint32_t>& binary = CorpusBinary();
+  spvtools::Optimizer optimizer(kBenchmarkEnv);
+  optimizer.SetMessageConsumer([](spv_message_level_t, const char*,
+                                  const spv_position_t&, const char*) {});
+  register_passes(&optimizer);
+  for (auto _ : state) {
+    std::vector<uint32_t> optimized;
+    if (!optimizer.Run(binary.data(), binary.size(), &optimized)) {
+      state.SkipWithError("optimizer run failed");
+      return;
+    }
+    benchmark::DoNotOptimize(optimized.data());
+  }
+}
+
+void BM_PerformancePasses(benchmark::State& state) {
+  RunPassBenchmark(state, [](spvtools::Optimizer* optimizer) {
+    optimizer->RegisterPerformancePasses();
+  });
+}
+BENCHMARK(BM_PerformancePasses);
+
+// Registers one benchmark per distinct pass used by
+// RegisterPerformancePasses, named after the pass flag.
+#define SPVTOOLS_PASS_BENCHMARK(flag, factory)                  \
+  benchmark::RegisterBenchmark(                                 \
+      "BM_Pass/" flag, [](benchmark::State& state) {            \
+        RunPassBenchmark(state, [](spvtools::Optimizer* opt) {  \
+          opt->RegisterPass(spvtools::factory);                 \
+        });                                                     \
+      })
+
+void RegisterPassBenchmarks() {
+  SPVTOOLS_PASS_BENCHMARK("wrap-opkill", CreateWrapOpKillPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-dead-branches",
+                          CreateDeadBranchElimPass());
+  SPVTOOLS_PASS_BENCHMARK("merge-return", CreateMergeReturnPass());
+  SPVTOOLS_PASS_BENCHMARK("inline-entry-points-exhaustive",
+                          CreateInlineExhaustivePass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-dead-functions",
+                          CreateEliminateDeadFunctionsPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-dead-code-aggressive",
+                          CreateAggressiveDCEPass());
+  SPVTOOLS_PASS_BENCHMARK("private-to-local", CreatePrivateToLocalPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-local-single-block",
+                          CreateLocalSingleBlockLoadStoreElimPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-local-single-store",
+                          CreateLocalSingleStoreElimPass());
+  SPVTOOLS_PASS_BENCHMARK("scalar-replacement",
+                          CreateScalarReplacementPass());
+  SPVTOOLS_PASS_BENCHMARK("convert-local-access-chains",
+                          CreateLocalAccessChainConvertPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-local-multi-store",
+                          CreateLocalMultiStoreElimPass());
+  SPVTOOLS_PASS_BENCHMARK("ccp", CreateCCPPass());
+  SPVTOOLS_PASS_BENCHMARK("loop-unroll", CreateLoopUnrollPass(true));
+  SPVTOOLS_PASS_BENCHMARK("redundancy-elimination",
+                          CreateRedundancyEliminationPass());
+  SPVTOOLS_PASS_BENCHMARK("combine-access-chains",
+                          CreateCombineAccessChainsPass());
+  SPVTOOLS_PASS_BENCHMARK("simplify-instructions",
+                          CreateSimplificationPass());
+  SPVTOOLS_PASS_BENCHMARK("ssa-rewrite", CreateSSARewritePass());
+  SPVTOOLS_PASS_BENCHMARK("vector-dce", CreateVectorDCEPass());
+  SPVTOOLS_PASS_BENCHMARK("eliminate-dead-inserts",
+                          CreateDeadInsertElimPass());
+  SPVTOOLS_PASS_BENCHMARK("if-conversion", CreateIfConversionPass());
+  SPVTOOLS_PASS_BENCHMARK("copy-propagate-arrays",
+                          CreateCopyPropagateArraysPass());
+  SPVTOOLS_PASS_BENCHMARK("reduce-load-size", CreateReduceLoadSizePass());
+  SPVTOOLS_PASS_BENCHMARK("merge-blocks", CreateBlockMergePass());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  RegisterPassBenchmarks();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return EXIT_FAILURE;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDE_SPIRV_TOOLS_EXTRACT_HPP_
+#define INCLUDE_SPIRV_TOOLS_EXTRACT_HPP_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "libspirv.hpp"
+
+namespace spvtools {
+
+// Extracts from |binary| the minimal standalone module for the entry point(s)
+// named |entry_point_name|, and writes it into |extracted_binary|.
+//
+// This is the inverse of linking: other entry points are removed along with
+// every function, global variable, type, constant, extended instruction set
+// import, name and decoration that the kept entry points do not reference,
+// in a single reachability walk over the module.  If several entry points
+// share |entry_point_name| (under different execution models), all of them
+// are kept.  Ids are compacted in the output.
+//
+// Capabilities, extensions and non-id debug information (sources, strings)
+// are kept as they are: deciding which capability declarations the remaining
+// instructions still require needs grammar-driven analysis that this API
+// does not attempt.
+//
+// Returns SPV_SUCCESS on success, SPV_ERROR_INVALID_BINARY if |binary| cannot
+// be parsed, and SPV_ERROR_INVALID_VALUE if no entry point is named
+// |entry_point_name|.  Messages are sent to the consumer of |context|.
+spv_result_t Extract(const Context& context,
+                     const std::vector<uint32_t>& binary,
+                     const std::string& entry_point_name,
+                     std::vector<uint32_t>* extracted_binary);
+
+}  // namespace spvtools
+
+#endif  // INCLUDE_SPIRV_TOOLS_EXTRACT_HPP_
@@ -579,6 +579,21 @@ SPIRV_TOOLS_EXPORT bool spvParseVulkanEnv(uint32_t vulkan_ver,
 // (particularly assembly and validation).
 SPIRV_TOOLS_EXPORT spv_context spvContextCreate(spv_target_env env);
 
+// Creates a context like spvContextCreate, but with the opcode and operand
+// grammar tables subsetted to a deployment profile.  Table entries that can
+// never be used under the given capabilities (SPIR-V capability enum
+// values) and extension names are dropped, and the surviving entries are
+// re-packed densely, shrinking the tables and the lookup loops that walk
+// them.  Unknown extension names are ignored.  The extended-instruction
+// tables are not subsetted: availability of their entries is governed by
+// the imported instruction set.  The filtered tables are cached, so
+// contexts created for the same profile share one copy.  Returns null if
+// env is invalid, or if an array argument is null while its count is
+// nonzero.
+SPIRV_TOOLS_EXPORT spv_context spvContextCreateForProfile(
+    spv_target_env env, const uint32_t* capabilities, size_t capability_count,
+    const char* const* extensions, size_t extension_count);
+
 // Destroys the given context object.
 SPIRV_TOOLS_EXPORT void spvContextDestroy(spv_context context);
 
@@ -689,6 +704,15 @@ SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetAllowLocalSizeId(
 SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetFriendlyNames(
     spv_validator_options options, bool val);
 
+// Records the number of threads the validator may use to check function
+// bodies.  The default is 1, which keeps validation single-threaded.  Values
+// above 1 allow the per-function checks to run on worker threads; diagnostics
+// are still reported deterministically, as if the module had been validated
+// front to back on one thread.  A value of 0 requests one thread per hardware
+// context.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetParallelValidation(
+    spv_validator_options options, uint32_t num_threads);
+
 // Creates an optimizer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvOptimizerOptionsDestroy|.
@@ -748,6 +772,24 @@ SPIRV_TOOLS_EXPORT void spvReducerOptionsSetFailOnValidationError(
 SPIRV_TOOLS_EXPORT void spvReducerOptionsSetTargetFunction(
     spv_reducer_options options, uint32_t target_function);
 
+// Sets the number of candidate reduction steps the reducer may evaluate
+// concurrently.  The default of 1 keeps reduction single-threaded; 0 means one
+// candidate per hardware thread.  When this is greater than 1 the
+// interestingness function must be safe to invoke from several threads at
+// once, and may be invoked on candidates that are subsequently discarded; the
+// sequence of reduction steps that is committed is the same as in the
+// single-threaded case.
+SPIRV_TOOLS_EXPORT void spvReducerOptionsSetParallelism(
+    spv_reducer_options options, uint32_t parallelism);
+
+// Sets whether the reducer should reduce hierarchically: passes that remove
+// whole functions run to completion first, then passes that remove blocks,
+// and only then the full set of passes.  Large modules typically reach a
+// reduced form in far fewer interestingness invocations this way.  The
+// committed end state is still a fixed point of every registered pass.
+SPIRV_TOOLS_EXPORT void spvReducerOptionsSetHierarchicalReduction(
+    spv_reducer_options options, bool hierarchical_reduction);
+
 // Creates a fuzzer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvFuzzerOptionsDestroy|.
@@ -824,10 +866,47 @@ SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToText(const spv_const_context context,
                                                 spv_text* text,
                                                 spv_diagnostic* diagnostic);
 
+// The caller-supplied sink for streamed disassembly text.  Invoked with
+// each chunk of text as it is produced; text points at length bytes that
+// are not nul-terminated and are only valid for the duration of the call.
+// Chunk boundaries are arbitrary and carry no meaning.  Returning anything
+// other than SPV_SUCCESS discards the remaining output and makes the
+// disassembly return that result.
+typedef spv_result_t (*spv_text_sink_fn_t)(void* user_data, const char* text,
+                                           size_t length);
+
+// Decodes the given SPIR-V binary representation to its assembly text,
+// delivering the text through the given sink instead of materializing it in
+// memory.  Peak memory use is independent of the module size, which makes
+// this variant suitable for disassembling very large modules.  The sink is
+// invoked with user_data as its first argument.  The parameters otherwise
+// match spvBinaryToText, except that the SPV_BINARY_TO_TEXT_OPTION_PRINT
+// option is ignored.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToTextStreamed(
+    const spv_const_context context, const uint32_t* binary,
+    const size_t word_count, const uint32_t options, spv_text_sink_fn_t sink,
+    void* user_data, spv_diagnostic* diagnostic);
+
 // Frees a binary stream from memory. This is a no-op if binary is a null
 // pointer.
 SPIRV_TOOLS_EXPORT void spvBinaryDestroy(spv_binary binary);
 
+// Creates a binary view over a caller-owned buffer of SPIR-V words, without
+// copying the words.  The caller retains ownership of the buffer and must keep
+// it alive and unchanged for the lifetime of the view.  This is intended for
+// parsing directly out of memory-mapped files: spvBinaryParse does not copy
+// instruction words when the module is in host endianness, so parsing a view
+// touches only the mapped pages.  The view must be destroyed with
+// spvBinaryViewDestroy, not spvBinaryDestroy.  Returns
+// SPV_ERROR_INVALID_POINTER if words or binary is a null pointer.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryViewCreate(const uint32_t* words,
+                                                    const size_t num_words,
+                                                    spv_binary* binary);
+
+// Frees a binary view created by spvBinaryViewCreate, without freeing the
+// underlying caller-owned words.  This is a no-op if binary is a null pointer.
+SPIRV_TOOLS_EXPORT void spvBinaryViewDestroy(spv_binary binary);
+
 // Validates a SPIR-V binary for correctness. Any errors will be written into
 // *diagnostic if diagnostic is non-null, otherwise the context's message
 // consumer will be used.
@@ -18,6 +18,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "spirv-tools/libspirv.h"
@@ -64,6 +65,14 @@ class Context {
   // invoked once for each message communicated from the library.
   void SetMessageConsumer(MessageConsumer consumer);
 
+  // Same as above, but additionally tells the library whether the consumer
+  // reads the message string.  When |consumes_text| is false - for example a
+  // consumer that only counts messages or inspects their severity - the
+  // consumer is still invoked once per message with the level and position,
+  // but the message text may be empty: the library skips formatting it,
+  // which avoids the string construction on failure-heavy workloads.
+  void SetMessageConsumer(MessageConsumer consumer, bool consumes_text);
+
   // Returns the underlying spv_context.
   spv_context& CContext();
   const spv_context& CContext() const;
@@ -158,6 +167,13 @@ class ValidatorOptions {
     spvValidatorOptionsSetFriendlyNames(options_, val);
   }
 
+  // Sets the number of threads used to validate function bodies.  The default
+  // of 1 keeps validation single-threaded; 0 means one thread per hardware
+  // context.  Diagnostics are reported deterministically either way.
+  void SetParallelValidation(uint32_t num_threads) {
+    spvValidatorOptionsSetParallelValidation(options_, num_threads);
+  }
+
  private:
   spv_validator_options options_;
 };
@@ -231,6 +247,17 @@ class ReducerOptions {
     spvReducerOptionsSetTargetFunction(options_, target_function);
   }
 
+  // See spvReducerOptionsSetParallelism.
+  void set_parallelism(uint32_t parallelism) {
+    spvReducerOptionsSetParallelism(options_, parallelism);
+  }
+
+  // See spvReducerOptionsSetHierarchicalReduction.
+  void set_hierarchical_reduction(bool hierarchical_reduction) {
+    spvReducerOptionsSetHierarchicalReduction(options_,
+                                              hierarchical_reduction);
+  }
+
  private:
   spv_reducer_options options_;
 };
@@ -384,6 +411,51 @@ class SpirvTools {
   bool Validate(const uint32_t* binary, size_t binary_size,
                 spv_validator_options options) const;
 
+  // Enables an on-disk cache of successful validation results, stored in the
+  // file at |path|.  The file is created if it does not exist.  Before running
+  // the validator, Validate() consults the cache using a hash of the binary
+  // words, the target environment, and the validator options; on a hit it
+  // returns true immediately.  Only successful results are cached, so failing
+  // modules are always re-validated and report their diagnostics as usual.
+  // The cache file is host-specific and versioned; a file written by an
+  // incompatible library version is ignored and overwritten.
+  // Returns false if the file exists but cannot be read or created.
+  bool EnableValidationCache(const std::string& path);
+
+  // Enables an in-memory cache of successful validation results, holding at
+  // most |max_entries| modules; passing 0 disables it.  It behaves like the
+  // on-disk cache enabled by EnableValidationCache() but lives only as long
+  // as this instance and needs no file.  It suits pipelines that re-validate
+  // a module after every transformation step: a step that leaves the module
+  // unchanged re-validates in the time it takes to hash the words.  Only
+  // successful results are cached; when the bound is reached the cache is
+  // reset rather than evicting individual entries.
+  void EnableInMemoryValidationCache(size_t max_entries);
+
+  // Computes a 64-bit content hash of the given SPIR-V |binary|, suitable as
+  // a key for caches of work derived from the module (validation results,
+  // optimized binaries, reflection data, ...).  The hash covers the version
+  // word and every instruction word; the generator, bound and schema header
+  // fields are ignored, so tools that only rewrite those fields do not
+  // change the key.  Returns 0 for a binary shorter than a module header.
+  static uint64_t ComputeContentHash(const uint32_t* binary,
+                                     size_t binary_size);
+  static uint64_t ComputeContentHash(const std::vector<uint32_t>& binary);
+
+  // Returns true if |lhs| and |rhs| are structurally equivalent SPIR-V
+  // modules: the same version and the same instruction stream once ids are
+  // renumbered in order of first appearance and debug-name instructions
+  // (OpName, OpMemberName, OpModuleProcessed) are dropped.  A module
+  // therefore compares equal to a copy of itself that has been relabeled,
+  // compacted, or stripped of names, while any semantic change is reported.
+  // The generator, bound, and schema header fields are ignored.  The
+  // comparison stops at the first instruction whose canonical form
+  // diverges.  Returns false if either binary fails to parse.
+  bool AreStructurallyEquivalent(const uint32_t* lhs, size_t lhs_size,
+                                 const uint32_t* rhs, size_t rhs_size) const;
+  bool AreStructurallyEquivalent(const std::vector<uint32_t>& lhs,
+                                 const std::vector<uint32_t>& rhs) const;
+
   // Was this object successfully constructed.
   bool IsValid() const;
 
@@ -392,6 +464,129 @@ class SpirvTools {
   std::unique_ptr<Impl> impl_;  // Unique pointer to implementation data.
 };
 
+// Validates a SPIR-V module delivered incrementally, e.g. as it arrives over
+// the network.  Callers push word ranges in arrival order; the validator
+// checks the header and the structure of each complete instruction as soon as
+// the words for it are available, so malformed modules are rejected before
+// the full download completes.  Checks that need the whole module (id
+// resolution, CFG rules, layout rules, ...) run in Finish().
+//
+// Words pushed in a non-host endianness are converted as they are buffered.
+class StreamingValidator {
+ public:
+  // Constructs a streaming validator for the given target environment.  If
+  // |options| is not null it must outlive this instance and is used for the
+  // final full validation.
+  explicit StreamingValidator(spv_target_env env,
+                              spv_validator_options options = nullptr);
+
+  // Destructs this instance.
+  ~StreamingValidator();
+
+  // Disables copy/move constructor/assignment operations.
+  StreamingValidator(const StreamingValidator&) = delete;
+  StreamingValidator& operator=(const StreamingValidator&) = delete;
+
+  // Sets the message consumer used for all diagnostics, both the early
+  // per-instruction ones and those from the final full validation.
+  void SetMessageConsumer(MessageConsumer consumer);
+
+  // Appends |num_words| words to the module being validated and runs the
+  // early checks over any newly completed instructions.  Returns false once
+  // the stream is known to be invalid; the caller may then stop pushing (the
+  // remaining input cannot make the module valid).
+  bool PushWords(const uint32_t* words, size_t num_words);
+
+  // Finalizes the stream and runs full validation over the accumulated
+  // module.  Returns true if the module is valid.
+  bool Finish();
+
+ private:
+  struct Impl;  // Opaque struct for holding the data fields used by this class.
+  std::unique_ptr<Impl> impl_;  // Unique pointer to implementation data.
+};
+
+// Stamps new specialization constant values directly into SPIR-V binary
+// words.
+//
+// Analyze() scans a module once and records where each scalar
+// OpSpecConstant, OpSpecConstantTrue, or OpSpecConstantFalse carrying a
+// SpecId decoration keeps its value.  Specialize() then patches those words
+// in a copy of the binary without constructing an IR, so an engine that
+// specializes one shader with many different constant sets pays a few word
+// writes per pipeline instead of a full IR round trip.
+//
+// Only scalar spec constants are patched.  OpSpecConstantComposite and
+// OpSpecConstantOp results are left alone; downstream consumers evaluate
+// them from the patched scalars.
+class SpecializationPlan {
+ public:
+  // Scans |binary| and records the location of every specializable scalar
+  // constant, replacing any previous plan.  The binary must be in host
+  // endianness.  Returns false if the header or an instruction word count
+  // is malformed; the plan is then empty.
+  bool Analyze(const uint32_t* binary, const size_t binary_size);
+  bool Analyze(const std::vector<uint32_t>& binary);
+
+  // Returns the number of specializable constants found by Analyze().
+  size_t NumSpecConstants() const { return constants_.size(); }
+
+  // Returns true if Analyze() found a scalar spec constant decorated with
+  // |spec_id|.
+  bool HasSpecId(uint32_t spec_id) const;
+
+  // Stamps each (SpecId, value) pair of |values| into |binary|, which must
+  // contain the same module words that were analyzed.  Boolean constants
+  // become OpSpecConstantTrue for a nonzero value and OpSpecConstantFalse
+  // otherwise; numeric constants take the low words of the value, so wider
+  // values are truncated to the constant's width.  Entries whose SpecId is
+  // not in the plan are ignored, mirroring how Vulkan treats unused entries
+  // in VkSpecializationInfo.  Returns false without modifying |binary| if
+  // its size does not match the analyzed module.
+  bool Specialize(std::vector<uint32_t>* binary,
+                  const std::unordered_map<uint32_t, uint64_t>& values) const;
+
+ private:
+  // Where one specializable scalar constant lives in the binary.
+  struct SpecConstant {
+    size_t opcode_offset;      // Word offset of the instruction itself.
+    uint32_t num_value_words;  // Literal words after the result id; zero
+                               // for boolean constants.
+  };
+
+  std::unordered_map<uint32_t, SpecConstant> constants_;  // Keyed by SpecId.
+  size_t num_words_ = 0;  // Word count of the analyzed module.
+};
+
+// A SPIR-V binary held compressed in memory.  Batch tools that keep many
+// modules in flight are limited by memory rather than CPU; storing queued
+// inputs and finished outputs in this form trades a cheap one-pass codec for
+// several times more resident modules.  The words are materialized again
+// with Decompress() when a module is actually operated on.
+class CompressedBinary {
+ public:
+  // Constructs an empty binary.
+  CompressedBinary() = default;
+
+  // Compresses |num_words| words of |words|.
+  CompressedBinary(const uint32_t* words, size_t num_words);
+  explicit CompressedBinary(const std::vector<uint32_t>& words);
+
+  // Decompresses the held module into |words|.  Returns false if this
+  // binary is empty.
+  bool Decompress(std::vector<uint32_t>* words) const;
+
+  // Returns the word count of the held module; zero when empty.
+  size_t num_words() const { return num_words_; }
+
+  // Returns the in-memory size of the compressed representation.
+  size_t compressed_bytes() const { return data_.size(); }
+
+ private:
+  std::vector<uint8_t> data_;  // Compressed bytes, including a format tag.
+  size_t num_words_ = 0;       // Word count of the original module.
+};
+
 }  // namespace spvtools
 
 #endif  // INCLUDE_SPIRV_TOOLS_LIBSPIRV_HPP_
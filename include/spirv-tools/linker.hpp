@@ -29,7 +29,8 @@ class LinkerOptions {
   LinkerOptions()
       : create_library_(false),
         verify_ids_(false),
-        allow_partial_linkage_(false) {}
+        allow_partial_linkage_(false),
+        parallelism_(1u) {}
 
   // Returns whether a library or an executable should be produced by the
   // linking phase.
@@ -63,10 +64,20 @@ class LinkerOptions {
     allow_partial_linkage_ = allow_partial_linkage;
   }
 
+  // Returns the number of threads used to parse the input modules.
+  uint32_t GetParallelism() const { return parallelism_; }
+
+  // Sets the number of threads used to parse the input modules.  The default
+  // of 1 keeps linking single-threaded; 0 means one thread per hardware
+  // context.  The output and any diagnostics are identical regardless of the
+  // thread count.
+  void SetParallelism(uint32_t parallelism) { parallelism_ = parallelism; }
+
  private:
   bool create_library_;
   bool verify_ids_;
   bool allow_partial_linkage_;
+  uint32_t parallelism_;
 };
 
 // Links one or more SPIR-V modules into a new SPIR-V module. That is, combine
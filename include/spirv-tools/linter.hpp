@@ -15,6 +15,8 @@
 #ifndef INCLUDE_SPIRV_TOOLS_LINTER_HPP_
 #define INCLUDE_SPIRV_TOOLS_LINTER_HPP_
 
+#include <vector>
+
 #include "libspirv.hpp"
 
 namespace spvtools {
@@ -39,6 +41,26 @@ class Linter {
 
   bool Run(const uint32_t* binary, size_t binary_size);
 
+  // Lints |binary| incrementally against |prev_binary|, a previously linted
+  // version of the same module.  Functions whose canonical hash (stable
+  // across id renumbering) also occurs in |prev_binary| are assumed to carry
+  // over their previous lint results and are skipped; only new or changed
+  // functions are re-analyzed.  Messages are only emitted for the functions
+  // that are re-analyzed, so the caller is expected to retain the messages
+  // from the previous run for the unchanged ones.  Returns true if the
+  // re-analyzed delta linted successfully.
+  bool RunIncremental(const uint32_t* prev_binary, size_t prev_binary_size,
+                      const uint32_t* binary, size_t binary_size);
+
+  // Lints every module in |binaries|, scheduling the modules across a pool
+  // of worker threads.  A |num_threads| of 0 selects the hardware
+  // concurrency.  Each worker buffers its messages, which are then replayed
+  // to the registered consumer on the calling thread, grouped per module in
+  // input order, so the output does not depend on scheduling.  Returns true
+  // if and only if every module was linted successfully.
+  bool RunBatch(const std::vector<std::vector<uint32_t>>& binaries,
+                size_t num_threads = 0);
+
  private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -15,6 +15,7 @@
 #ifndef INCLUDE_SPIRV_TOOLS_OPTIMIZER_HPP_
 #define INCLUDE_SPIRV_TOOLS_OPTIMIZER_HPP_
 
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -28,10 +29,56 @@
 namespace spvtools {
 
 namespace opt {
+class IRContext;
 class Pass;
 struct DescriptorSetAndBinding;
 }  // namespace opt
 
+// A machine-readable record of the resources consumed by a single executed
+// pass.  An instance is delivered to the callback registered with
+// Optimizer::SetPassReportConsumer() each time a pass finishes running, in
+// pass execution order.
+struct PassReport {
+  // The name of the pass, as reported by its --pass-name flag.
+  std::string pass_name;
+  // True if the pass reported that it changed the module.
+  bool changed = false;
+  // Wall-clock and CPU time spent running the pass, in seconds.  CPU time is
+  // -1.0 when the platform cannot measure it.
+  double wall_time = 0.0;
+  double cpu_time = 0.0;
+  // Growth of the process's peak resident set size across the pass, in
+  // kilobytes, or -1 when the library was built without SPIRV_TIMER_ENABLED.
+  // Note that a peak is monotonic: a pass that frees memory still reports 0.
+  long peak_rss_delta = -1;
+  // The number of instructions in the module before and after the pass,
+  // including debug and annotation instructions.
+  uint64_t instruction_count_before = 0;
+  uint64_t instruction_count_after = 0;
+  // The module's id bound before and after the pass.
+  uint32_t id_bound_before = 0;
+  uint32_t id_bound_after = 0;
+  // Bitmasks describing how the pass changed the set of valid cached
+  // analyses (def-use, CFG, dominators, ...).  |analyses_invalidated| holds
+  // the analyses that were valid before the pass but not after it;
+  // |analyses_built| holds the ones that became valid while the pass ran.
+  // The bits are the opt::IRContext::Analysis enumerators; they identify
+  // rebuild churn between passes without naming a stable ABI.
+  uint32_t analyses_invalidated = 0;
+  uint32_t analyses_built = 0;
+};
+
+// The callback type used to deliver a PassReport for each executed pass.
+using PassReportConsumer = std::function<void(const PassReport&)>;
+
+// The magic number identifying a module summary emitted through
+// Optimizer::SetEmitModuleSummary().  Spells "SPMS" in little-endian ASCII.
+constexpr uint32_t kModuleSummaryMagic = 0x534d5053u;
+
+// The layout version of the module summary.  Bumped whenever the word
+// layout documented on Optimizer::SetEmitModuleSummary() changes.
+constexpr uint32_t kModuleSummaryVersion = 1u;
+
 // C++ interface for SPIR-V optimization functionalities. It wraps the context
 // (including target environment and the corresponding SPIR-V grammar) and
 // provides methods for registering optimization passes and optimizing.
@@ -99,6 +146,17 @@ class Optimizer {
   // from time to time.
   Optimizer& RegisterPerformancePasses();
 
+  // Like RegisterPerformancePasses(), but the pipeline is chosen per module
+  // when Run() is called: cheap statistics gathered from the parsed module
+  // (loop and call presence, function body size) select between the full
+  // performance pipeline and a reduced one for small straight-line shaders,
+  // for which most of the full pipeline is no-ops that still pay analysis
+  // rebuild costs.  In this mode the pass manager also skips a repeated pass
+  // when its previous run reported no change and no later pass has changed
+  // the module since, as such a run cannot do anything.  The selection is
+  // repeated on every Run(), so one Optimizer can serve mixed workloads.
+  Optimizer& RegisterAdaptivePerformancePasses();
+
   // Registers passes that attempt to improve the size of generated code.
   // This sequence of passes is subject to constant review and will change
   // from time to time.
@@ -214,14 +272,123 @@ class Optimizer {
   // |out| output stream.
   Optimizer& SetTimeReport(std::ostream* out);
 
+  // Sets the callback that receives a PassReport after each pass executes.
+  // Unlike SetTimeReport(), the reports are generated whether or not the
+  // library was built with SPIRV_TIMER_ENABLED; fields the platform cannot
+  // measure are set to the sentinel documented on PassReport.  Pass a null
+  // |consumer| to disable reporting.
+  Optimizer& SetPassReportConsumer(PassReportConsumer consumer);
+
   // Sets the option to validate the module after each pass.
   Optimizer& SetValidateAfterAll(bool validate);
 
+  // Caches optimization results in |directory|, which must already exist.
+  // Run() first looks for an entry keyed by a hash of the input binary and a
+  // hash of the registered pass pipeline and optimizer options; on a hit the
+  // previously optimized binary is returned without parsing or optimizing
+  // the module again, and on a miss the result is stored for later runs.
+  // Entries are published with an atomic rename, so concurrent processes can
+  // share one cache directory.  Unreadable or unwritable entries are treated
+  // as misses and never fail the run.  An empty |directory| (the default)
+  // disables caching.
+  Optimizer& SetResultCacheDirectory(const std::string& directory);
+
+  // Writes a compact summary of the optimized module into |summary| at the
+  // end of every successful Run().  The summary answers the questions a
+  // build system or pipeline cache usually asks about a module without the
+  // reader having to parse SPIR-V at all.  Its layout is a flat word
+  // sequence and is stable across releases:
+  //
+  //   word 0              kModuleSummaryMagic
+  //   word 1              kModuleSummaryVersion
+  //   word 2              id bound of the module
+  //   word 3              total instruction count
+  //   word 4              1 if the module carries debug info, else 0
+  //   word 5              number of capabilities, N
+  //   word 6              number of entry points, M
+  //   words 7 .. 7+N-1    the N capability enum values, in module order
+  //   words 7+N .. end    the M entry point execution models, in module order
+  //
+  // |summary| must outlive all calls to Run().  The caller retains
+  // ownership; passing null (the default) disables summary emission.
+  Optimizer& SetEmitModuleSummary(std::vector<uint32_t>* summary);
+
+  // Restricts optimization to the code reachable from the entry points named
+  // in |entry_point_names|.  Before the registered passes run, Run() removes
+  // every other entry point along with its execution modes and any function
+  // only they reach, so the pass pipeline only pays for the requested slice.
+  // The optimized module therefore contains just the named entry points;
+  // callers needing the others keep the original binary.  Run() fails if a
+  // name does not match an OpEntryPoint in the module.  An empty list (the
+  // default) optimizes the whole module.
+  Optimizer& RestrictToEntryPoints(std::vector<std::string> entry_point_names);
+
  private:
+  // Selects and registers the performance pipeline fitted to |context|'s
+  // module.  Called from Run() when RegisterAdaptivePerformancePasses() was
+  // used.
+  void RegisterAdaptivePassesForModule(opt::IRContext* context);
+
   struct Impl;                  // Opaque struct for holding internal data.
   std::unique_ptr<Impl> impl_;  // Unique pointer to internal data.
 };
 
+// A pass pipeline parsed and validated once from a list of flags, for
+// callers that configure the same pipeline over and over.  Pass instances
+// are consumed by Optimizer::Run(), so every run needs freshly constructed
+// passes; a PassPipeline front-loads the flag parsing and argument
+// validation so that RegisterTo() can configure any number of Optimizer
+// instances without repeating the error checking.
+class PassPipeline {
+ public:
+  // Parses and validates |flags|.  Each flag must be a string of a form
+  // accepted by Optimizer::FlagHasValidForm().  On an invalid flag it
+  // reports the error to |consumer|, leaves the pipeline empty and returns
+  // false.  May be called again to replace the pipeline.
+  bool Parse(const std::vector<std::string>& flags, MessageConsumer consumer);
+
+  // Registers the parsed passes onto |optimizer|, in order.  The pipeline
+  // must have been parsed successfully; registration cannot fail.
+  void RegisterTo(Optimizer* optimizer) const;
+
+  // Returns the number of flags in the pipeline.
+  size_t size() const { return flags_.size(); }
+
+ private:
+  std::vector<std::string> flags_;  // Validated flags, in registration order.
+};
+
+// Optimizes a batch of SPIR-V binaries with the same pass pipeline,
+// scheduling modules across a pool of worker threads.  |pass_flags| uses the
+// same syntax as Optimizer::RegisterPassFromFlag (e.g. "--simplify-
+// instructions"); each worker instantiates its own pipeline from the flags
+// since pass objects are single use, while the process-wide grammar and
+// operand tables are shared read-only across all workers.  |num_threads| of 0
+// selects the hardware concurrency.  On return, (*optimized_binaries)[i]
+// holds the result for binaries[i].  |consumer| may be invoked from any
+// worker thread, but never from two threads at once.
+//
+// Returns true if and only if every binary validated and optimized
+// successfully.  Failed entries are left empty and the remaining entries are
+// still processed.
+bool OptimizeBatch(spv_target_env env,
+                   const std::vector<std::string>& pass_flags,
+                   const std::vector<std::vector<uint32_t>>& binaries,
+                   std::vector<std::vector<uint32_t>>* optimized_binaries,
+                   MessageConsumer consumer = nullptr, size_t num_threads = 0);
+
+// Same as above, but the modules rest in memory as CompressedBinary on both
+// sides: each worker decompresses its input just before optimizing and
+// compresses the result as soon as it is produced.  Only the modules
+// currently on a worker are resident in word form, so the number of modules
+// a batch can keep in flight is bounded by their compressed size.  A failed
+// entry is left as an empty CompressedBinary.
+bool OptimizeBatch(spv_target_env env,
+                   const std::vector<std::string>& pass_flags,
+                   const std::vector<CompressedBinary>& binaries,
+                   std::vector<CompressedBinary>* optimized_binaries,
+                   MessageConsumer consumer = nullptr, size_t num_threads = 0);
+
 // Creates a null pass.
 // A null pass does nothing to the SPIR-V module to be optimized.
 Optimizer::PassToken CreateNullPass();
@@ -355,6 +522,26 @@ Optimizer::PassToken CreateStrengthReductionPass();
 // these is left for future improvements.
 Optimizer::PassToken CreateBlockMergePass();
 
+// Creates a block layout pass.
+// This pass reorders each function's basic blocks so that likely control
+// flow falls through to the next block in the binary: loop bodies stay
+// contiguous, back edges are assumed taken, and branches that exit a loop
+// or jump straight to a merge block are assumed not taken.  Explicit branch
+// weights on OpBranchConditional take precedence over those heuristics.
+// The resulting order still places every block after its dominator, as the
+// SPIR-V block ordering rules require.
+Optimizer::PassToken CreateBlockLayoutPass();
+
+// Creates a tail-merge pass.
+// This pass merges duplicated tail blocks: blocks that end the function,
+// define no values used elsewhere, lie in the same structured construct,
+// and contain identical instruction streams once their own result ids are
+// matched up.  Branches to each duplicate are redirected to one surviving
+// copy and the duplicates are removed.  Switch-heavy modules whose case
+// constructs end in near-identical tails shrink considerably, which mainly
+// benefits downstream compile time.
+Optimizer::PassToken CreateTailMergePass();
+
 // Creates an exhaustive inline pass.
 // An exhaustive inline pass attempts to exhaustively inline all function
 // calls in all functions in an entry point call tree. The intent is to enable,
@@ -364,6 +551,18 @@ Optimizer::PassToken CreateBlockMergePass();
 // that are not in the call tree of an entry point are not changed.
 Optimizer::PassToken CreateInlineExhaustivePass();
 
+// Creates a heuristic inline pass.
+// A heuristic inline pass expands the most profitable inlinable call sites
+// first and stops once the module has grown by |growth_budget_percent|
+// percent of its size at the start of the pass.  Profitability favors call
+// sites in deeply nested loops, then smaller callees, so hot call overhead
+// goes first while cold helpers stay outlined.  This sits between
+// CreateInlineExhaustivePass, which ignores code growth entirely, and not
+// inlining at all.  Functions that are not in the call tree of an entry
+// point are not changed.
+Optimizer::PassToken CreateInlineHeuristicPass(
+    uint32_t growth_budget_percent = 25);
+
 // Creates an opaque inline pass.
 // An opaque inline pass inlines all function calls in all functions in all
 // entry point call trees where the called function contains an opaque type
@@ -530,6 +729,19 @@ Optimizer::PassToken CreateAggressiveDCEPass(bool preserve_interface);
 Optimizer::PassToken CreateAggressiveDCEPass(bool preserve_interface,
                                              bool remove_outputs);
 
+// Creates a combined dead code elimination pass.
+// This pass runs aggressive DCE (instruction granularity), vector DCE
+// (vector component granularity), and dead member elimination (struct
+// member granularity) to a combined fixed point, re-running an engine only
+// when another engine has changed the module since its last run. Use it in
+// place of looping the three passes in a pipeline.
+//
+// |preserve_interface| and |remove_outputs| are forwarded to the aggressive
+// DCE engine; see CreateAggressiveDCEPass.
+Optimizer::PassToken CreateCombinedDcePass();
+Optimizer::PassToken CreateCombinedDcePass(bool preserve_interface,
+                                           bool remove_outputs);
+
 // Creates a remove-unused-interface-variables pass.
 // Removes variables referenced on the |OpEntryPoint| instruction that are not
 // referenced in the entry point function or any function in its call tree. Note
@@ -610,6 +822,19 @@ Optimizer::PassToken CreateLoopFissionPass(size_t threshold);
 // loop stays under the threshold defined by |max_registers_per_loop|.
 Optimizer::PassToken CreateLoopFusionPass(size_t max_registers_per_loop);
 
+// Creates a loop fusion pass with a cache-locality cost model.
+// In addition to the register budget of |max_registers_per_loop|, a pair of
+// loops is only fused when the loops share at least
+// |min_reused_data_streams| access streams - memory locations indexed by
+// the same functions of the induction variable, so that fusion turns reuse
+// across the loops into reuse within one iteration - and the fused loop
+// touches at most |max_fused_data_streams| distinct streams.  Both bounds
+// are machine parameters to be tuned for the target's cache hierarchy;
+// passing zero for |max_fused_data_streams| disables the cost model.
+Optimizer::PassToken CreateLoopFusionPass(size_t max_registers_per_loop,
+                                          size_t max_fused_data_streams,
+                                          size_t min_reused_data_streams);
+
 // Creates a loop peeling pass.
 // This pass will look for conditions inside a loop that are true or false only
 // for the N first or last iteration. For loop with such condition, those N
@@ -653,6 +878,15 @@ Optimizer::PassToken CreatePrivateToLocalPass();
 // and computations with constant operands.
 Optimizer::PassToken CreateCCPPass();
 
+// Creates an interprocedural constant propagation pass.
+// For every function whose call sites are all known, parameters that receive
+// the same constant value from every call site have their uses replaced by
+// that constant.  Constants flow through chains of calls, including mutually
+// recursive ones, so intraprocedural folding passes can simplify the callee
+// bodies without exhaustive inlining.  Entry points and exported functions
+// are never changed.
+Optimizer::PassToken CreateIPConstantPropPass();
+
 // Creates a workaround driver bugs pass.  This pass attempts to work around
 // a known driver bug (issue #1209) by identifying the bad code sequences and
 // rewriting them.
@@ -670,6 +904,13 @@ Optimizer::PassToken CreateReplaceInvalidOpcodePass();
 // Creates a pass that simplifies instructions using the instruction folder.
 Optimizer::PassToken CreateSimplificationPass();
 
+// Creates a pass that applies several compatible peephole rule sets in one
+// module traversal: strength reduction of integer multiplies by constant
+// powers of two, plus the rewrites of the simplification pass.  One run of
+// this pass replaces running those passes back to back, walking the module
+// and invalidating analyses once instead of once per pass.
+Optimizer::PassToken CreateFusedPeepholePass();
+
 // Create loop unroller pass.
 // Creates a pass to unroll loops which have the "Unroll" loop control
 // mask set. The loops must meet a specific criteria in order to be unrolled
@@ -806,6 +1047,22 @@ Optimizer::PassToken CreateUpgradeMemoryModelPass();
 // where an instruction is moved into a more deeply nested construct.
 Optimizer::PassToken CreateCodeSinkingPass();
 
+// Creates a pressure-aware instruction scheduling pass.
+// Within each basic block, side-effect-free instructions are sunk, together
+// with their pure operand chains, to just before their first use, so fewer
+// values are live at once and downstream register allocators achieve better
+// occupancy.  A move is only made when it cannot increase the number of
+// simultaneously live values; memory operations, calls and barriers are
+// never reordered.
+Optimizer::PassToken CreatePressureSchedulingPass();
+
+// Creates a pass that embeds analysis results into the module.
+// Each function's dominator tree and loop structure are serialized into a
+// non-semantic extended instruction set, so later consumers of the module
+// can rehydrate them instead of recomputing them.  Metadata from an earlier
+// run of the pass is replaced.
+Optimizer::PassToken CreateEmbedAnalysisMetadataPass();
+
 // Create a pass to fix incorrect storage classes.  In order to make code
 // generation simpler, DXC may generate code where the storage classes do not
 // match up correctly.  This pass will fix the errors that it can.
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDE_SPIRV_TOOLS_REFLECTION_HPP_
+#define INCLUDE_SPIRV_TOOLS_REFLECTION_HPP_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "libspirv.hpp"
+
+namespace spvtools {
+
+// Value used for reflection fields whose decoration is absent.
+constexpr uint32_t kReflectionUnset = 0xffffffffu;
+
+// Metadata for one entry point declared by an OpEntryPoint instruction.
+// Enumerant fields hold the raw SPIR-V values so this header does not depend
+// on the SPIR-V enum headers.
+struct ReflectedEntryPoint {
+  // The execution model, as a raw spv::ExecutionModel value.
+  uint32_t execution_model = 0;
+  // The result id of the entry point's OpFunction.
+  uint32_t function_id = 0;
+  // The entry point's name.
+  std::string name;
+  // The ids of the module-scope variables forming the interface.
+  std::vector<uint32_t> interface_ids;
+  // The workgroup size from the LocalSize execution mode, or all zeros if
+  // the mode is absent.
+  uint32_t local_size[3] = {0, 0, 0};
+};
+
+// Metadata for one module-scope variable.
+struct ReflectedVariable {
+  // The variable's result id.
+  uint32_t id = 0;
+  // The variable's pointer type id.
+  uint32_t type_id = 0;
+  // The storage class, as a raw spv::StorageClass value.
+  uint32_t storage_class = 0;
+  // DescriptorSet, Binding and Location decorations, or kReflectionUnset
+  // when the variable does not carry the decoration.
+  uint32_t descriptor_set = kReflectionUnset;
+  uint32_t binding = kReflectionUnset;
+  uint32_t location = kReflectionUnset;
+};
+
+// Reflection data for a module: the header fields and the metadata needed to
+// bind the module's entry points and resources.
+struct ReflectionInfo {
+  // The version word from the module header.
+  uint32_t version = 0;
+  // The id bound from the module header.
+  uint32_t id_bound = 0;
+  std::vector<ReflectedEntryPoint> entry_points;
+  std::vector<ReflectedVariable> variables;
+};
+
+// Populates |info| from the module in |binary|, which contains |binary_size|
+// words.  The binary is parsed in a single pass that stops at the first
+// function body; no in-memory IR is constructed, so this is much cheaper
+// than building an optimizer module just to enumerate entry points and
+// descriptor bindings.  Any previous content of |info| is discarded.
+//
+// Returns SPV_SUCCESS on success; on failure, reports the parse error
+// through |context|'s message consumer and leaves |info| partially filled.
+spv_result_t GetReflectionInfo(const Context& context, const uint32_t* binary,
+                               size_t binary_size, ReflectionInfo* info);
+
+}  // namespace spvtools
+
+#endif  // INCLUDE_SPIRV_TOOLS_REFLECTION_HPP_
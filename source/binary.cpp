@@ -110,20 +110,47 @@ class Parser {
 
   // Parses an instruction operand with the given type, for an instruction
   // starting at inst_offset words into the SPIR-V binary.
-  // If the SPIR-V binary is the same endianness as the host, then the
-  // endian_converted_inst_words parameter is ignored.  Otherwise, this method
-  // appends the words for this operand, converted to host native endianness,
-  // to the end of endian_converted_inst_words.  This method also updates the
-  // expected_operands parameter, and the scalar members of the inst parameter.
+  // This method updates the expected_operands parameter, and the scalar
+  // members of the inst parameter.
   // On success, returns SPV_SUCCESS, advances past the operand, and pushes a
   // new entry on to the operands vector.  Otherwise returns an error code and
   // issues a diagnostic.
   spv_result_t parseOperand(size_t inst_offset, spv_parsed_instruction_t* inst,
                             const spv_operand_type_t type,
-                            std::vector<uint32_t>* endian_converted_inst_words,
                             std::vector<spv_parsed_operand_t>* operands,
                             spv_operand_pattern_t* expected_operands);
 
+  // Describes an instruction whose operands are all single words with
+  // context-free types: ids and plain literal integers, optionally followed
+  // by a variable-length run of ids or literal integers.  Such instructions
+  // (the bulk of a typical function body) can be decoded directly from the
+  // instruction words without running the generic operand-pattern machinery.
+  struct SimpleLayout {
+    // Whether the opcode qualifies for the direct decode path at all.
+    bool simple = false;
+    // Operand types of the fixed-size part, in order.
+    std::vector<spv_operand_type_t> fixed;
+    // SPV_OPERAND_TYPE_VARIABLE_ID or SPV_OPERAND_TYPE_VARIABLE_LITERAL_-
+    // INTEGER when the fixed part is followed by a variable-length tail,
+    // SPV_OPERAND_TYPE_NONE otherwise.
+    spv_operand_type_t variable = SPV_OPERAND_TYPE_NONE;
+  };
+
+  // Returns the simple-layout description for |opcode|, deriving it from
+  // |opcode_desc| on first use and caching it for the rest of the parse.
+  const SimpleLayout& simpleLayoutFor(uint16_t opcode,
+                                      const spv_opcode_desc_t* opcode_desc);
+
+  // Decodes an instruction with the given simple layout directly from the
+  // binary, filling in the scalar members of |inst| and the operands vector
+  // and advancing the parsing position.  Returns false without changing any
+  // parser state if the instruction does not decode cleanly; the caller then
+  // reruns it through the generic path so that diagnostics are identical to
+  // the ones it has always produced.
+  bool fastParseSimpleInstruction(const SimpleLayout& layout,
+                                  size_t inst_offset, uint16_t inst_word_count,
+                                  spv_parsed_instruction_t* inst);
+
   // Records the numeric type for an operand according to the type information
   // associated with the given non-zero type Id.  This can fail if the type Id
   // is not a type Id, or if the type Id does not reference a scalar numeric
@@ -173,7 +200,10 @@ class Parser {
   // Returns the endian-corrected word at the given position.
   uint32_t peekAt(size_t index) const {
     assert(index < _.num_words);
-    return spvFixWord(_.words[index], _.endian);
+    // When the module required endian conversion, the whole module was
+    // translated up front, so this is a plain load either way.
+    return _.requires_endian_conversion ? _.converted_words[index]
+                                        : _.words[index];
   }
 
   // Data members
@@ -203,9 +233,8 @@ class Parser {
           endian(),
           requires_endian_conversion(false) {
       // Temporary storage for parser state within a single instruction.
-      // Most instructions require fewer than 25 words or operands.
+      // Most instructions require fewer than 25 operands.
       operands.reserve(25);
-      endian_converted_words.reserve(25);
       expected_operands.reserve(25);
     }
     State() : State(0, 0, nullptr) {}
@@ -218,6 +247,11 @@ class Parser {
     // Is the SPIR-V binary in a different endianness from the host native
     // endianness?
     bool requires_endian_conversion;
+    // When the binary's endianness differs from the host's, holds the entire
+    // module translated to host endianness.  The translation is done once, up
+    // front, in a single pass that the compiler can vectorize, rather than a
+    // word at a time while parsing.
+    std::vector<uint32_t> converted_words;
 
     // Maps a result ID to its type ID.  By convention:
     //  - a result ID that is a type definition maps to itself.
@@ -231,8 +265,9 @@ class Parser {
 
     // Used by parseOperand
     std::vector<spv_parsed_operand_t> operands;
-    std::vector<uint32_t> endian_converted_words;
     spv_operand_pattern_t expected_operands;
+    // Cache of per-opcode simple-layout descriptions; see SimpleLayout.
+    std::unordered_map<uint16_t, SimpleLayout> simple_layouts;
   } _;
 };
 
@@ -262,6 +297,12 @@ spv_result_t Parser::parseModule() {
                         << _.words[0] << "'.";
   }
   _.requires_endian_conversion = !spvIsHostEndian(_.endian);
+  if (_.requires_endian_conversion) {
+    // Translate the whole module to host endianness in one pass so the rest
+    // of the parse can read and expose words directly.
+    _.converted_words.resize(_.num_words);
+    spvFixWords(_.words, _.converted_words.data(), _.num_words, _.endian);
+  }
 
   // Process the header.
   spv_header_t header;
@@ -299,12 +340,6 @@ spv_result_t Parser::parseInstruction() {
 
   const uint32_t first_word = peek();
 
-  // If the module's endianness is different from the host native endianness,
-  // then converted_words contains the endian-translated words in the
-  // instruction.
-  _.endian_converted_words.clear();
-  _.endian_converted_words.push_back(first_word);
-
   // After a successful parse of the instruction, the inst.operands member
   // will point to this vector's storage.
   _.operands.clear();
@@ -326,74 +361,75 @@ spv_result_t Parser::parseInstruction() {
   const size_t inst_offset = _.word_index;
   _.word_index++;
 
-  // Maintains the ordered list of expected operand types.
-  // For many instructions we only need the {numTypes, operandTypes}
-  // entries in opcode_desc.  However, sometimes we need to modify
-  // the list as we parse the operands. This occurs when an operand
-  // has its own logical operands (such as the LocalSize operand for
-  // ExecutionMode), or for extended instructions that may have their
-  // own operands depending on the selected extended instruction.
-  _.expected_operands.clear();
-  for (auto i = 0; i < opcode_desc->numTypes; i++)
-    _.expected_operands.push_back(
-        opcode_desc->operandTypes[opcode_desc->numTypes - i - 1]);
-
-  while (_.word_index < inst_offset + inst_word_count) {
-    const uint16_t inst_word_index = uint16_t(_.word_index - inst_offset);
-    if (_.expected_operands.empty()) {
-      return diagnostic() << "Invalid instruction Op" << opcode_desc->name
-                          << " starting at word " << inst_offset
-                          << ": expected no more operands after "
-                          << inst_word_index
-                          << " words, but stated word count is "
-                          << inst_word_count << ".";
-    }
+  // Decode instructions whose operands are all single words of context-free
+  // type directly from the binary.  Anything unusual, including every error
+  // case, falls through to the generic grammar-driven loop below.
+  bool fast_parsed = false;
+  const SimpleLayout& simple_layout =
+      simpleLayoutFor(inst.opcode, opcode_desc);
+  if (simple_layout.simple) {
+    fast_parsed = fastParseSimpleInstruction(simple_layout, inst_offset,
+                                             inst_word_count, &inst);
+  }
+
+  if (!fast_parsed) {
+    // Maintains the ordered list of expected operand types.
+    // For many instructions we only need the {numTypes, operandTypes}
+    // entries in opcode_desc.  However, sometimes we need to modify
+    // the list as we parse the operands. This occurs when an operand
+    // has its own logical operands (such as the LocalSize operand for
+    // ExecutionMode), or for extended instructions that may have their
+    // own operands depending on the selected extended instruction.
+    _.expected_operands.clear();
+    for (auto i = 0; i < opcode_desc->numTypes; i++)
+      _.expected_operands.push_back(
+          opcode_desc->operandTypes[opcode_desc->numTypes - i - 1]);
+
+    while (_.word_index < inst_offset + inst_word_count) {
+      const uint16_t inst_word_index = uint16_t(_.word_index - inst_offset);
+      if (_.expected_operands.empty()) {
+        return diagnostic() << "Invalid instruction Op" << opcode_desc->name
+                            << " starting at word " << inst_offset
+                            << ": expected no more operands after "
+                            << inst_word_index
+                            << " words, but stated word count is "
+                            << inst_word_count << ".";
+      }
 
-    spv_operand_type_t type =
-        spvTakeFirstMatchableOperand(&_.expected_operands);
+      spv_operand_type_t type =
+          spvTakeFirstMatchableOperand(&_.expected_operands);
 
-    if (auto error =
-            parseOperand(inst_offset, &inst, type, &_.endian_converted_words,
-                         &_.operands, &_.expected_operands)) {
-      return error;
+      if (auto error = parseOperand(inst_offset, &inst, type, &_.operands,
+                                    &_.expected_operands)) {
+        return error;
+      }
     }
-  }
 
-  if (!_.expected_operands.empty() &&
-      !spvOperandIsOptional(_.expected_operands.back())) {
-    return diagnostic() << "End of input reached while decoding Op"
-                        << opcode_desc->name << " starting at word "
-                        << inst_offset << ": expected more operands after "
-                        << inst_word_count << " words.";
-  }
+    if (!_.expected_operands.empty() &&
+        !spvOperandIsOptional(_.expected_operands.back())) {
+      return diagnostic() << "End of input reached while decoding Op"
+                          << opcode_desc->name << " starting at word "
+                          << inst_offset << ": expected more operands after "
+                          << inst_word_count << " words.";
+    }
 
-  if ((inst_offset + inst_word_count) != _.word_index) {
-    return diagnostic() << "Invalid word count: Op" << opcode_desc->name
-                        << " starting at word " << inst_offset
-                        << " says it has " << inst_word_count
-                        << " words, but found " << _.word_index - inst_offset
-                        << " words instead.";
+    if ((inst_offset + inst_word_count) != _.word_index) {
+      return diagnostic() << "Invalid word count: Op" << opcode_desc->name
+                          << " starting at word " << inst_offset
+                          << " says it has " << inst_word_count
+                          << " words, but found " << _.word_index - inst_offset
+                          << " words instead.";
+    }
   }
 
-  // Check the computed length of the endian-converted words vector against
-  // the declared number of words in the instruction.  If endian conversion
-  // is required, then they should match.  If no endian conversion was
-  // performed, then the vector only contains the initial opcode/word-count
-  // word.
-  assert(!_.requires_endian_conversion ||
-         (inst_word_count == _.endian_converted_words.size()));
-  assert(_.requires_endian_conversion ||
-         (_.endian_converted_words.size() == 1));
-
   recordNumberType(inst_offset, &inst);
 
+  // Point into the module-level copy that was endian-converted up front, or
+  // directly into the underlying binary when no conversion was required.
+  // Either way, no per-instruction copy is made.
   if (_.requires_endian_conversion) {
-    // We must wait until here to set this pointer, because the vector might
-    // have been be resized while we accumulated its elements.
-    inst.words = _.endian_converted_words.data();
+    inst.words = _.converted_words.data() + inst_offset;
   } else {
-    // If no conversion is required, then just point to the underlying binary.
-    // This saves time and space.
     inst.words = _.words + inst_offset;
   }
   inst.num_words = inst_word_count;
@@ -412,10 +448,123 @@ spv_result_t Parser::parseInstruction() {
   return SPV_SUCCESS;
 }
 
+const Parser::SimpleLayout& Parser::simpleLayoutFor(
+    uint16_t opcode, const spv_opcode_desc_t* opcode_desc) {
+  auto layout_iter = _.simple_layouts.find(opcode);
+  if (layout_iter != _.simple_layouts.end()) return layout_iter->second;
+
+  SimpleLayout& layout = _.simple_layouts[opcode];
+  layout.simple = true;
+  for (int32_t i = 0; i < opcode_desc->numTypes && layout.simple; i++) {
+    const spv_operand_type_t type = opcode_desc->operandTypes[i];
+    switch (type) {
+      case SPV_OPERAND_TYPE_TYPE_ID:
+      case SPV_OPERAND_TYPE_RESULT_ID:
+      case SPV_OPERAND_TYPE_ID:
+      case SPV_OPERAND_TYPE_LITERAL_INTEGER:
+        layout.fixed.push_back(type);
+        break;
+      case SPV_OPERAND_TYPE_VARIABLE_ID:
+      case SPV_OPERAND_TYPE_VARIABLE_LITERAL_INTEGER:
+        // A variable-length run is only decodable without the pattern
+        // machinery when it is the last logical operand.
+        if (i + 1 == opcode_desc->numTypes) {
+          layout.variable = type;
+        } else {
+          layout.simple = false;
+        }
+        break;
+      default:
+        // Enums, masks, strings, typed literals, and extended-instruction
+        // selectors all need the generic path.  OpExtInst in particular is
+        // excluded here, so the fast path never has to track extended
+        // instruction set types.
+        layout.simple = false;
+        break;
+    }
+  }
+  return layout;
+}
+
+bool Parser::fastParseSimpleInstruction(const SimpleLayout& layout,
+                                        size_t inst_offset,
+                                        uint16_t inst_word_count,
+                                        spv_parsed_instruction_t* inst) {
+  const size_t num_operand_words = inst_word_count - 1;
+  if (inst_offset + inst_word_count > _.num_words) return false;
+  if (num_operand_words < layout.fixed.size()) return false;
+  if (layout.variable == SPV_OPERAND_TYPE_NONE &&
+      num_operand_words != layout.fixed.size())
+    return false;
+
+  // Check everything before touching any parser state so that a failed
+  // decode can be rerun through the generic path from scratch.
+  uint32_t type_id = 0;
+  uint32_t result_id = 0;
+  for (size_t i = 0; i < layout.fixed.size(); i++) {
+    const uint32_t word = peekAt(inst_offset + 1 + i);
+    switch (layout.fixed[i]) {
+      case SPV_OPERAND_TYPE_TYPE_ID:
+        if (word == 0) return false;
+        type_id = word;
+        break;
+      case SPV_OPERAND_TYPE_RESULT_ID:
+        if (word == 0) return false;
+        if (_.id_to_type_id.find(word) != _.id_to_type_id.end()) return false;
+        result_id = word;
+        break;
+      case SPV_OPERAND_TYPE_ID:
+        if (word == 0) return false;
+        break;
+      default:
+        // Plain literal integers admit any word.
+        break;
+    }
+  }
+  if (layout.variable == SPV_OPERAND_TYPE_VARIABLE_ID) {
+    for (size_t i = layout.fixed.size(); i < num_operand_words; i++) {
+      if (peekAt(inst_offset + 1 + i) == 0) return false;
+    }
+  }
+
+  spv_parsed_operand_t operand;
+  operand.num_words = 1;
+  for (size_t i = 0; i < num_operand_words; i++) {
+    const spv_operand_type_t type =
+        i < layout.fixed.size()
+            ? layout.fixed[i]
+            : (layout.variable == SPV_OPERAND_TYPE_VARIABLE_ID
+                   ? SPV_OPERAND_TYPE_ID
+                   : SPV_OPERAND_TYPE_LITERAL_INTEGER);
+    operand.offset = uint16_t(1 + i);
+    operand.type = type;
+    if (type == SPV_OPERAND_TYPE_LITERAL_INTEGER) {
+      // Single-word literal integers are always unsigned.
+      operand.number_kind = SPV_NUMBER_UNSIGNED_INT;
+      operand.number_bit_width = 32;
+    } else {
+      operand.number_kind = SPV_NUMBER_NONE;
+      operand.number_bit_width = 0;
+    }
+    _.operands.push_back(operand);
+  }
+
+  inst->type_id = type_id;
+  inst->result_id = result_id;
+  if (result_id != 0) {
+    // A regular value maps to its type.  The result Id for a type-generating
+    // instruction (e.g. OpTypeInt) maps to itself.
+    _.id_to_type_id[result_id] =
+        spvOpcodeGeneratesType(static_cast<spv::Op>(inst->opcode)) ? result_id
+                                                                   : type_id;
+  }
+  _.word_index = inst_offset + inst_word_count;
+  return true;
+}
+
 spv_result_t Parser::parseOperand(size_t inst_offset,
                                   spv_parsed_instruction_t* inst,
                                   const spv_operand_type_t type,
-                                  std::vector<uint32_t>* words,
                                   std::vector<spv_parsed_operand_t>* operands,
                                   spv_operand_pattern_t* expected_operands) {
   const spv::Op opcode = static_cast<spv::Op>(inst->opcode);
@@ -440,10 +589,6 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
 
   const uint32_t word = peek();
 
-  // Do the words in this operand have to be converted to native endianness?
-  // True for all but literal strings.
-  bool convert_operand_endianness = true;
-
   switch (type) {
     case SPV_OPERAND_TYPE_TYPE_ID:
       if (!word)
@@ -589,8 +734,14 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
     case SPV_OPERAND_TYPE_LITERAL_STRING:
     case SPV_OPERAND_TYPE_OPTIONAL_LITERAL_STRING: {
       const size_t max_words = _.num_words - _.word_index;
-      std::string string =
-          spvtools::utils::MakeString(_.words + _.word_index, max_words, false);
+      // Strings are encoded in the word values, with characters packed
+      // little-endian within each word, so decode from the endian-corrected
+      // words.  Reading the raw words of a cross-endian module would garble
+      // the text, and with it the extended-instruction-set recognition below.
+      const uint32_t* string_words =
+          _.requires_endian_conversion ? _.converted_words.data() : _.words;
+      std::string string = spvtools::utils::MakeString(
+          string_words + _.word_index, max_words, false);
 
       if (string.length() == max_words * 4)
         return exhaustedInputDiagnostic(inst_offset, opcode, type);
@@ -746,21 +897,6 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
   if (_.num_words < index_after_operand)
     return exhaustedInputDiagnostic(inst_offset, opcode, type);
 
-  if (_.requires_endian_conversion) {
-    // Copy instruction words.  Translate to native endianness as needed.
-    if (convert_operand_endianness) {
-      const spv_endianness_t endianness = _.endian;
-      std::transform(_.words + _.word_index, _.words + index_after_operand,
-                     std::back_inserter(*words),
-                     [endianness](const uint32_t raw_word) {
-                       return spvFixWord(raw_word, endianness);
-                     });
-    } else {
-      words->insert(words->end(), _.words + _.word_index,
-                    _.words + index_after_operand);
-    }
-  }
-
   // Advance past the operand.
   _.word_index = index_after_operand;
 
@@ -831,6 +967,24 @@ void spvBinaryDestroy(spv_binary binary) {
   }
 }
 
+spv_result_t spvBinaryViewCreate(const uint32_t* words, const size_t num_words,
+                                 spv_binary* binary) {
+  if (!words || !binary) return SPV_ERROR_INVALID_POINTER;
+  spv_binary view = new spv_binary_t();
+  // The view aliases the caller's buffer.  The const_cast is safe because
+  // nothing in the library writes through an spv_binary it did not allocate,
+  // and spvBinaryViewDestroy never frees the code pointer.
+  view->code = const_cast<uint32_t*>(words);
+  view->wordCount = num_words;
+  *binary = view;
+  return SPV_SUCCESS;
+}
+
+void spvBinaryViewDestroy(spv_binary binary) {
+  // Unlike spvBinaryDestroy, do not free the code: it is caller-owned.
+  delete binary;
+}
+
 size_t spv_strnlen_s(const char* str, size_t strsz) {
   if (!str) return 0;
   for (size_t i = 0; i < strsz; i++) {
@@ -52,6 +52,16 @@ class CFA {
                              uint32_t id);
 
  public:
+  /// Reusable scratch storage for DepthFirstTraversal.  A traversal needs a
+  /// visited set and a traversal stack; callers that run many traversals (the
+  /// validator walks every function several times) can construct a single
+  /// workspace and pass it to each call so the containers' storage is reused
+  /// instead of being reallocated per call.
+  struct TraversalWorkspace {
+    std::unordered_set<uint32_t> processed;
+    std::vector<block_info> work_list;
+  };
+
   /// @brief Depth first traversal starting from the \p entry BasicBlock
   ///
   /// This function performs a depth first traversal from the \p entry
@@ -105,6 +115,16 @@ class CFA {
       std::function<void(cbb_ptr, cbb_ptr)> backedge,
       std::function<bool(cbb_ptr)> terminal);
 
+  /// Same as above, but reuses the containers held by |workspace| instead of
+  /// allocating fresh ones.  The workspace is cleared on entry, so it carries
+  /// no state between calls other than its allocated capacity.
+  static void DepthFirstTraversal(
+      const BB* entry, get_blocks_func successor_func,
+      std::function<void(cbb_ptr)> preorder,
+      std::function<void(cbb_ptr)> postorder,
+      std::function<void(cbb_ptr, cbb_ptr)> backedge,
+      std::function<bool(cbb_ptr)> terminal, TraversalWorkspace* workspace);
+
   /// @brief Calculates dominator edges for a set of blocks
   ///
   /// Computes dominators using the algorithm of Cooper, Harvey, and Kennedy
@@ -177,16 +197,31 @@ void CFA<BB>::DepthFirstTraversal(
     std::function<void(cbb_ptr)> postorder,
     std::function<void(cbb_ptr, cbb_ptr)> backedge,
     std::function<bool(cbb_ptr)> terminal) {
+  TraversalWorkspace workspace;
+  DepthFirstTraversal(entry, successor_func, preorder, postorder, backedge,
+                      terminal, &workspace);
+}
+
+template <class BB>
+void CFA<BB>::DepthFirstTraversal(
+    const BB* entry, get_blocks_func successor_func,
+    std::function<void(cbb_ptr)> preorder,
+    std::function<void(cbb_ptr)> postorder,
+    std::function<void(cbb_ptr, cbb_ptr)> backedge,
+    std::function<bool(cbb_ptr)> terminal, TraversalWorkspace* workspace) {
   assert(successor_func && "The successor function cannot be empty.");
   assert(preorder && "The preorder function cannot be empty.");
   assert(postorder && "The postorder function cannot be empty.");
   assert(terminal && "The terminal function cannot be empty.");
+  assert(workspace && "The workspace cannot be null.");
 
-  std::unordered_set<uint32_t> processed;
+  std::unordered_set<uint32_t>& processed = workspace->processed;
+  processed.clear();
 
   /// NOTE: work_list is the sequence of nodes from the root node to the node
   /// being processed in the traversal
-  std::vector<block_info> work_list;
+  std::vector<block_info>& work_list = workspace->work_list;
+  work_list.clear();
   work_list.reserve(10);
 
   work_list.push_back({entry, std::begin(*successor_func(entry))});
@@ -316,10 +351,13 @@ std::vector<BB*> CFA<BB>::TraversalRoots(const std::vector<BB*>& blocks,
   auto ignore_block = [](const BB*) {};
   auto no_terminal_blocks = [](const BB*) { return false; };
 
+  // One traversal is run per root, so share a single workspace between them.
+  TraversalWorkspace workspace;
   auto traverse_from_root = [&mark_visited, &succ_func, &ignore_block,
-                             &no_terminal_blocks](const BB* entry) {
+                             &no_terminal_blocks,
+                             &workspace](const BB* entry) {
     DepthFirstTraversal(entry, succ_func, mark_visited, ignore_block,
-                        no_terminal_blocks);
+                        /* backedge = */ {}, no_terminal_blocks, &workspace);
   };
 
   std::vector<BB*> result;
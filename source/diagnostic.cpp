@@ -75,17 +75,20 @@ DiagnosticStream::DiagnosticStream(DiagnosticStream&& other)
       position_(other.position_),
       consumer_(other.consumer_),
       disassembled_instruction_(std::move(other.disassembled_instruction_)),
-      error_(other.error_) {
+      error_(other.error_),
+      will_emit_(other.will_emit_),
+      format_(other.format_) {
   // Prevent the other object from emitting output during destruction.
   other.error_ = SPV_FAILED_MATCH;
+  other.will_emit_ = false;
   // Some platforms are missing support for std::ostringstream functionality,
   // including:  move constructor, swap method.  Either would have been a
   // better choice than copying the string.
-  stream_ << other.stream_.str();
+  if (format_) stream_ << other.stream_.str();
 }
 
 DiagnosticStream::~DiagnosticStream() {
-  if (error_ != SPV_FAILED_MATCH && consumer_ != nullptr) {
+  if (will_emit_) {
     auto level = SPV_MSG_ERROR;
     switch (error_) {
       case SPV_SUCCESS:
@@ -106,7 +109,7 @@ DiagnosticStream::~DiagnosticStream() {
       default:
         break;
     }
-    if (disassembled_instruction_.size() > 0)
+    if (format_ && disassembled_instruction_.size() > 0)
       stream_ << std::endl << "  " << disassembled_instruction_ << std::endl;
 
     consumer_(level, "input", position_, stream_.str().c_str());
@@ -28,13 +28,19 @@ namespace spvtools {
 // emitted during the destructor.
 class DiagnosticStream {
  public:
+  // |consumer_needs_text| tells the stream whether |consumer| reads the
+  // message string.  When false, the consumer is still invoked once with the
+  // level and position, but streamed values are discarded without being
+  // formatted and the message may be empty.
   DiagnosticStream(spv_position_t position, const MessageConsumer& consumer,
                    const std::string& disassembled_instruction,
-                   spv_result_t error)
+                   spv_result_t error, bool consumer_needs_text = true)
       : position_(position),
         consumer_(consumer),
         disassembled_instruction_(disassembled_instruction),
-        error_(error) {}
+        error_(error),
+        will_emit_(error != SPV_FAILED_MATCH && consumer_ != nullptr),
+        format_(will_emit_ && consumer_needs_text) {}
 
   // Creates a DiagnosticStream from an expiring DiagnosticStream.
   // The new object takes the contents of the other, and prevents the
@@ -46,10 +52,13 @@ class DiagnosticStream {
   // then emit the accumulated message to the consumer.
   ~DiagnosticStream();
 
-  // Adds the given value to the diagnostic message to be written.
+  // Adds the given value to the diagnostic message to be written.  Values
+  // streamed into a diagnostic that will never be emitted (failed match, no
+  // consumer) or whose consumer does not read the text are discarded without
+  // being formatted.
   template <typename T>
   DiagnosticStream& operator<<(const T& val) {
-    stream_ << val;
+    if (format_) stream_ << val;
     return *this;
   }
 
@@ -62,6 +71,11 @@ class DiagnosticStream {
   MessageConsumer consumer_;  // Message consumer callback.
   std::string disassembled_instruction_;
   spv_result_t error_;
+  // Whether the destructor will invoke the consumer.
+  bool will_emit_;
+  // Whether streamed values are formatted into |stream_|.  False when the
+  // message will not be emitted or its text will not be read.
+  bool format_;
 };
 
 // Changes the MessageConsumer in |context| to one that updates |diagnostic|
@@ -14,11 +14,14 @@
 
 #include "source/diff/diff.h"
 
+#include <bitset>
+
 #include "source/diff/lcs.h"
 #include "source/disassemble.h"
 #include "source/ext_inst.h"
 #include "source/latest_version_spirv_header.h"
 #include "source/print.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
@@ -230,6 +233,17 @@ class Differ {
     // Cache function bodies in canonicalization order.
     GetFunctionBodies(src_context_, &src_funcs_, &src_func_insts_);
     GetFunctionBodies(dst_context_, &dst_funcs_, &dst_func_insts_);
+
+    // Fingerprint the function bodies so identical functions can be detected
+    // cheaply when matching them.
+    for (const auto& func_insts : src_func_insts_) {
+      body_fingerprints_[&func_insts.second] =
+          HashFunctionBody(func_insts.second);
+    }
+    for (const auto& func_insts : dst_func_insts_) {
+      body_fingerprints_[&func_insts.second] =
+          HashFunctionBody(func_insts.second);
+    }
   }
 
   // Match ids or instructions of different sections.
@@ -381,6 +395,14 @@ class Differ {
   InstructionList GetFunctionBody(opt::IRContext* context,
                                   opt::Function& function);
   InstructionList GetFunctionHeader(const opt::Function& function);
+  // Returns a hash of the instruction words of a function body.  Bodies with
+  // different fingerprints cannot be word-identical.
+  uint64_t HashFunctionBody(const InstructionList& body) const;
+  // Returns a 64-bit SimHash sketch of the opcode trigrams of a function
+  // body.  Bodies with similar instruction sequences produce sketches at a
+  // small Hamming distance, so the sketch ranks match candidates without
+  // comparing the bodies themselves.
+  uint64_t SketchFunctionBody(const InstructionList& body) const;
   void GetFunctionBodies(opt::IRContext* context, FunctionMap* functions,
                          FunctionInstMap* function_insts);
   void GetFunctionHeaderInstructions(const opt::Module* module,
@@ -502,6 +524,11 @@ class Differ {
   FunctionInstMap dst_func_insts_;
   FunctionMap src_funcs_;
   FunctionMap dst_funcs_;
+
+  // Fingerprints of the function bodies above.  Matching fingerprints make
+  // two functions candidates for the identical-body early out in
+  // MatchFunctionBodies.
+  std::unordered_map<const InstructionList*, uint64_t> body_fingerprints_;
 };
 
 void IdMap::MapUnmatchedIds(IdMap& other_way) {
@@ -1493,6 +1520,63 @@ InstructionList Differ::GetFunctionHeader(const opt::Function& function) {
   return body;
 }
 
+uint64_t Differ::HashFunctionBody(const InstructionList& body) const {
+  // FNV-1a over every word of every instruction of the body.
+  constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+  uint64_t hash = 0xcbf29ce484222325ull;
+
+  const auto hash_word = [&hash](uint32_t word) {
+    hash = (hash ^ word) * kFnvPrime;
+  };
+
+  for (const opt::Instruction* inst : body) {
+    hash_word(static_cast<uint32_t>(inst->opcode()));
+    hash_word(inst->result_id());
+    hash_word(inst->type_id());
+    for (uint32_t in_operand_index = 0;
+         in_operand_index < inst->NumInOperands(); ++in_operand_index) {
+      const opt::Operand& operand = inst->GetInOperand(in_operand_index);
+      hash_word(static_cast<uint32_t>(operand.type));
+      for (const uint32_t word : operand.words) {
+        hash_word(word);
+      }
+    }
+  }
+
+  return hash;
+}
+
+uint64_t Differ::SketchFunctionBody(const InstructionList& body) const {
+  // SimHash: every opcode trigram votes on each of the 64 sketch bits, and
+  // each bit ends up as the sign of its tally.  Changing a few instructions
+  // flips only a few votes, so similar bodies land at a small Hamming
+  // distance while unrelated bodies differ in about half the bits.
+  int32_t votes[64] = {};
+
+  for (size_t index = 2; index < body.size(); ++index) {
+    uint64_t gram = static_cast<uint64_t>(body[index - 2]->opcode());
+    gram = (gram << 21) ^ static_cast<uint64_t>(body[index - 1]->opcode());
+    gram = (gram << 21) ^ static_cast<uint64_t>(body[index]->opcode());
+
+    // splitmix64 finalizer, to spread the packed trigram over all bits.
+    gram = (gram ^ (gram >> 30)) * 0xbf58476d1ce4e5b9ull;
+    gram = (gram ^ (gram >> 27)) * 0x94d049bb133111ebull;
+    gram ^= gram >> 31;
+
+    for (uint32_t bit = 0; bit < 64; ++bit) {
+      votes[bit] += (gram >> bit) & 1 ? 1 : -1;
+    }
+  }
+
+  uint64_t sketch = 0;
+  for (uint32_t bit = 0; bit < 64; ++bit) {
+    if (votes[bit] > 0) {
+      sketch |= uint64_t(1) << bit;
+    }
+  }
+  return sketch;
+}
+
 void Differ::GetFunctionBodies(opt::IRContext* context, FunctionMap* functions,
                                FunctionInstMap* function_insts) {
   for (opt::Function& function : *context->module()) {
@@ -1529,7 +1613,31 @@ void Differ::BestEffortMatchFunctions(const IdGroup& src_func_ids,
       return match_rate > other.match_rate;
     }
   };
-  std::vector<MatchResult> all_match_results;
+  // Gather the candidate pairs up front so the quadratic body matching below
+  // can be handed out to worker threads.  Neither this loop nor
+  // MatchFunctionBodies modifies the id map, so the candidate set and every
+  // match result are independent of the order the pairs are processed in.
+  std::vector<std::pair<uint32_t, uint32_t>> candidate_pairs;
+
+  // When a source function has many candidates - typically because every
+  // name changed and name matching failed, leaving every unmatched function
+  // paired with every other - only the few whose opcode-trigram sketch is
+  // closest in Hamming distance are compared exactly.  This is an arbitrary
+  // limit that should be tuned.
+  constexpr size_t kMaxSketchCandidates = 8;
+
+  std::unordered_map<uint32_t, uint64_t> dst_sketches;
+  const auto get_dst_sketch = [this, &dst_sketches,
+                               &dst_func_insts](uint32_t dst_func_id) {
+    auto iter = dst_sketches.find(dst_func_id);
+    if (iter == dst_sketches.end()) {
+      iter = dst_sketches
+                 .emplace(dst_func_id,
+                          SketchFunctionBody(dst_func_insts.at(dst_func_id)))
+                 .first;
+    }
+    return iter->second;
+  };
 
   for (const uint32_t src_func_id : src_func_ids) {
     if (id_map_.IsSrcMapped(src_func_id)) {
@@ -1537,6 +1645,7 @@ void Differ::BestEffortMatchFunctions(const IdGroup& src_func_ids,
     }
     const std::string src_name = GetSanitizedName(src_id_to_, src_func_id);
 
+    IdGroup dst_candidates;
     for (const uint32_t dst_func_id : dst_func_ids) {
       if (id_map_.IsDstMapped(dst_func_id)) {
         continue;
@@ -1548,19 +1657,85 @@ void Differ::BestEffortMatchFunctions(const IdGroup& src_func_ids,
         continue;
       }
 
-      DiffMatch src_match_result, dst_match_result;
-      float match_rate = MatchFunctionBodies(
-          src_func_insts.at(src_func_id), dst_func_insts.at(dst_func_id),
-          &src_match_result, &dst_match_result);
-
-      // Only consider the functions a match if there's at least 60% match.
-      // This is an arbitrary limit that should be tuned.
-      constexpr float pass_match_rate = 0.6f;
-      if (match_rate >= pass_match_rate) {
-        all_match_results.emplace_back(
-            MatchResult{src_func_id, dst_func_id, std::move(src_match_result),
-                        std::move(dst_match_result), match_rate});
+      dst_candidates.push_back(dst_func_id);
+    }
+
+    if (dst_candidates.size() > kMaxSketchCandidates) {
+      const uint64_t src_sketch =
+          SketchFunctionBody(src_func_insts.at(src_func_id));
+
+      // Rank the candidates by sketch distance, keep the closest few and put
+      // them back in their original order so the surviving pairs are
+      // processed exactly as they would have been without the pruning.
+      std::vector<std::pair<size_t, size_t>> ranked;  // {distance, position}
+      ranked.reserve(dst_candidates.size());
+      for (size_t position = 0; position < dst_candidates.size(); ++position) {
+        const uint64_t dst_sketch = get_dst_sketch(dst_candidates[position]);
+        ranked.push_back(
+            {std::bitset<64>(src_sketch ^ dst_sketch).count(), position});
       }
+      std::sort(ranked.begin(), ranked.end());
+      ranked.resize(kMaxSketchCandidates);
+      std::sort(ranked.begin(), ranked.end(),
+                [](const std::pair<size_t, size_t>& a,
+                   const std::pair<size_t, size_t>& b) {
+                  return a.second < b.second;
+                });
+
+      IdGroup closest_candidates;
+      for (const auto& entry : ranked) {
+        closest_candidates.push_back(dst_candidates[entry.second]);
+      }
+      dst_candidates = std::move(closest_candidates);
+    }
+
+    for (const uint32_t dst_func_id : dst_candidates) {
+      candidate_pairs.push_back({src_func_id, dst_func_id});
+    }
+  }
+
+  // Take the diff of every candidate pair, on worker threads if requested.
+  // Results are stored per pair and visited in the original pair order below,
+  // so the diff is identical no matter how many threads are used.
+  std::vector<MatchResult> pair_results(candidate_pairs.size());
+
+  auto match_pair = [this, &candidate_pairs, &pair_results, &src_func_insts,
+                     &dst_func_insts](size_t pair_index) {
+    const uint32_t src_func_id = candidate_pairs[pair_index].first;
+    const uint32_t dst_func_id = candidate_pairs[pair_index].second;
+    MatchResult& result = pair_results[pair_index];
+
+    result.src_id = src_func_id;
+    result.dst_id = dst_func_id;
+    result.match_rate = MatchFunctionBodies(
+        src_func_insts.at(src_func_id), dst_func_insts.at(dst_func_id),
+        &result.src_match, &result.dst_match);
+  };
+
+  const size_t num_threads = options_.num_threads == 0
+                                 ? utils::ThreadPool::DefaultThreadCount()
+                                 : options_.num_threads;
+  if (num_threads > 1 && candidate_pairs.size() > 1) {
+    utils::ThreadPool pool(std::min(num_threads, candidate_pairs.size()));
+    for (size_t pair_index = 0; pair_index < candidate_pairs.size();
+         ++pair_index) {
+      pool.Schedule([&match_pair, pair_index]() { match_pair(pair_index); });
+    }
+    pool.Wait();
+  } else {
+    for (size_t pair_index = 0; pair_index < candidate_pairs.size();
+         ++pair_index) {
+      match_pair(pair_index);
+    }
+  }
+
+  // Only consider the functions a match if there's at least 60% match.  This
+  // is an arbitrary limit that should be tuned.
+  constexpr float pass_match_rate = 0.6f;
+  std::vector<MatchResult> all_match_results;
+  for (MatchResult& match_result : pair_results) {
+    if (match_result.match_rate >= pass_match_rate) {
+      all_match_results.push_back(std::move(match_result));
     }
   }
 
@@ -1628,6 +1803,32 @@ float Differ::MatchFunctionBodies(const InstructionList& src_body,
                                   const InstructionList& dst_body,
                                   DiffMatch* src_match_result,
                                   DiffMatch* dst_match_result) {
+  // Early out for identical functions, common when diffing the before and
+  // after snapshots of an optimization where most functions are untouched.
+  // The fingerprints cheaply reject non-identical bodies; for bodies that
+  // could be identical, verify with a linear pairwise pass instead of the
+  // quadratic LCS below.  When every instruction fuzzily matches its
+  // counterpart, the only longest common subsequence of two equal-length
+  // sequences is the sequences themselves, so this produces the exact match
+  // result the LCS would.
+  if (src_body.size() == dst_body.size()) {
+    const auto src_fingerprint = body_fingerprints_.find(&src_body);
+    const auto dst_fingerprint = body_fingerprints_.find(&dst_body);
+    if (src_fingerprint != body_fingerprints_.end() &&
+        dst_fingerprint != body_fingerprints_.end() &&
+        src_fingerprint->second == dst_fingerprint->second) {
+      bool identical = true;
+      for (size_t index = 0; identical && index < src_body.size(); ++index) {
+        identical = DoInstructionsMatchFuzzy(src_body[index], dst_body[index]);
+      }
+      if (identical) {
+        src_match_result->assign(src_body.size(), true);
+        dst_match_result->assign(dst_body.size(), true);
+        return 1.0f;
+      }
+    }
+  }
+
   LongestCommonSubsequence<std::vector<const opt::Instruction*>> lcs(src_body,
                                                                      dst_body);
 
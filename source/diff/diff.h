@@ -27,6 +27,11 @@ struct Options {
   bool no_header = false;
   bool color_output = false;
   bool dump_id_map = false;
+  // Number of threads used for the best-effort matching of functions between
+  // the two modules.  0 means one thread per hardware thread context; 1 (the
+  // default) keeps all matching on the calling thread.  The diff produced is
+  // identical regardless of this value.
+  uint32_t num_threads = 1;
 };
 
 // Given two SPIR-V modules, this function outputs the textual diff of their
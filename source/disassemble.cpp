@@ -24,6 +24,8 @@
 #include <cstring>
 #include <iomanip>
 #include <memory>
+#include <ostream>
+#include <streambuf>
 #include <unordered_map>
 #include <utility>
 
@@ -43,19 +45,107 @@
 namespace spvtools {
 namespace {
 
+// A streambuf that appends everything written to it to a std::string owned
+// by the caller.  Writing through this rather than a std::stringstream lets
+// the string's capacity be recycled across disassemblies.
+class StringSinkStreambuf : public std::streambuf {
+ public:
+  explicit StringSinkStreambuf(std::string* sink) : sink_(sink) {}
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize count) override {
+    sink_->append(s, static_cast<size_t>(count));
+    return count;
+  }
+  int overflow(int c) override {
+    if (c != traits_type::eof()) sink_->push_back(static_cast<char>(c));
+    return c;
+  }
+
+ private:
+  std::string* sink_;
+};
+
+// A streambuf that hands everything written to it to a caller-supplied
+// callback in bounded chunks, so peak memory stays independent of the
+// amount of text produced.  A callback failure is latched: further output
+// is discarded and the failure is reported through status().
+class CallbackSinkStreambuf : public std::streambuf {
+ public:
+  CallbackSinkStreambuf(spv_text_sink_fn_t sink, void* user_data)
+      : sink_(sink), user_data_(user_data) {
+    buffer_.reserve(kChunkSize);
+  }
+
+  // Hands any buffered text to the callback.
+  void Flush() {
+    if (status_ == SPV_SUCCESS && !buffer_.empty()) {
+      status_ = sink_(user_data_, buffer_.data(), buffer_.size());
+    }
+    buffer_.clear();
+  }
+
+  spv_result_t status() const { return status_; }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize count) override {
+    if (status_ == SPV_SUCCESS) {
+      buffer_.append(s, static_cast<size_t>(count));
+      if (buffer_.size() >= kChunkSize) Flush();
+    }
+    return count;
+  }
+  int overflow(int c) override {
+    if (c != traits_type::eof()) {
+      const char ch = static_cast<char>(c);
+      xsputn(&ch, 1);
+    }
+    return c;
+  }
+
+ private:
+  static constexpr size_t kChunkSize = 64 * 1024;
+  spv_text_sink_fn_t sink_;
+  void* user_data_;
+  std::string buffer_;
+  spv_result_t status_ = SPV_SUCCESS;
+};
+
+// Returns a starting output-buffer size for disassembling |word_count| words
+// of binary.  Disassembly usually comes to fewer than ten bytes of text per
+// binary word, so this slightly overshoots to make reallocation rare without
+// pinning a large buffer for small modules.
+size_t EstimateTextSize(size_t word_count) { return word_count * 12; }
+
 // A Disassembler instance converts a SPIR-V binary to its assembly
 // representation.
 class Disassembler {
  public:
+  // If |text_sink| is non-null, text is written to it and the
+  // SPV_BINARY_TO_TEXT_OPTION_PRINT option is ignored; otherwise text
+  // accumulates in an internal buffer to be fetched with SaveTextResult.
   Disassembler(const AssemblyGrammar& grammar, uint32_t options,
-               NameMapper name_mapper)
-      : print_(spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options)),
+               NameMapper name_mapper, std::ostream* text_sink = nullptr)
+      : print_(!text_sink &&
+               spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options)),
         text_(),
-        out_(print_ ? out_stream() : out_stream(text_)),
-        instruction_disassembler_(grammar, out_.get(), options, name_mapper),
+        text_buf_(&text_),
+        text_stream_(&text_buf_),
+        instruction_disassembler_(
+            grammar,
+            text_sink ? *text_sink
+                      : (print_ ? static_cast<std::ostream&>(std::cout)
+                                : text_stream_),
+            options, name_mapper),
         header_(!spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_NO_HEADER, options)),
         byte_offset_(0) {}
 
+  // Grows the internal text buffer to a size suitable for a module of
+  // |word_count| words, so that emitting the text does not reallocate.
+  void ReserveOutput(size_t word_count) {
+    if (!print_) text_.reserve(EstimateTextSize(word_count));
+  }
+
   // Emits the assembly header for the module, and sets up internal state
   // so subsequent callbacks can handle the cases where the entire module
   // is either big-endian or little-endian.
@@ -72,8 +162,9 @@ class Disassembler {
  private:
   const bool print_;  // Should we also print to the standard output stream?
   spv_endianness_t endian_;  // The detected endianness of the binary.
-  std::stringstream text_;   // Captures the text, if not printing.
-  out_stream out_;  // The Output stream.  Either to text_ or standard output.
+  std::string text_;         // Captures the text, if not printing.
+  StringSinkStreambuf text_buf_;  // Appends formatted output to text_.
+  std::ostream text_stream_;      // Formats output into text_buf_.
   disassemble::InstructionDisassembler instruction_disassembler_;
   const bool header_;   // Should we output header as the leading comment?
   size_t byte_offset_;  // The number of bytes processed so far.
@@ -115,10 +206,11 @@ spv_result_t Disassembler::HandleInstruction(
 
 spv_result_t Disassembler::SaveTextResult(spv_text* text_result) const {
   if (!print_) {
-    size_t length = text_.str().size();
+    size_t length = text_.size();
     char* str = new char[length + 1];
     if (!str) return SPV_ERROR_OUT_OF_MEMORY;
-    strncpy(str, text_.str().c_str(), length + 1);
+    memcpy(str, text_.data(), length);
+    str[length] = '\0';
     spv_text text = new spv_text_t();
     if (!text) {
       delete[] str;
@@ -528,6 +620,80 @@ std::string spvInstructionBinaryToText(const spv_target_env env,
 
   return output;
 }
+
+DisassemblyContext::DisassemblyContext(spv_target_env env, uint32_t options)
+    : context_(spvContextCreate(env)),
+      grammar_(context_ ? MakeUnique<AssemblyGrammar>(context_) : nullptr),
+      options_(options) {}
+
+DisassemblyContext::~DisassemblyContext() { spvContextDestroy(context_); }
+
+bool DisassemblyContext::IsValid() const {
+  return context_ != nullptr && grammar_->isValid();
+}
+
+NameMapper DisassemblyContext::GetNameMapperForModule(
+    const uint32_t* binary, size_t word_count,
+    std::unique_ptr<FriendlyNameMapper>* friendly_mapper) const {
+  // Generate friendly names for Ids if requested.  This is the one piece of
+  // per-module state: names depend on the module's own debug instructions.
+  if (options_ & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
+    *friendly_mapper =
+        MakeUnique<FriendlyNameMapper>(context_, binary, word_count);
+    return (*friendly_mapper)->GetNameMapper();
+  }
+  return GetTrivialNameMapper();
+}
+
+bool DisassemblyContext::Disassemble(const uint32_t* binary, size_t word_count,
+                                     std::string* text) {
+  if (text == nullptr) return false;
+  text->clear();
+  if (!IsValid()) return false;
+
+  // Write straight into the caller's string, so its capacity carries over to
+  // the next module; pre-size it from the binary size so emitting the text
+  // does not reallocate.
+  text->reserve(EstimateTextSize(word_count));
+  StringSinkStreambuf sink_buf(text);
+  std::ostream stream(&sink_buf);
+  if (!Disassemble(binary, word_count, &stream)) {
+    text->clear();
+    return false;
+  }
+  return true;
+}
+
+bool DisassemblyContext::Disassemble(const uint32_t* binary, size_t word_count,
+                                     std::ostream* sink) {
+  if (sink == nullptr || !IsValid()) return false;
+
+  std::unique_ptr<FriendlyNameMapper> friendly_mapper;
+  NameMapper name_mapper =
+      GetNameMapperForModule(binary, word_count, &friendly_mapper);
+
+  Disassembler disassembler(*grammar_, options_, name_mapper, sink);
+  return spvBinaryParse(context_, &disassembler, binary, word_count,
+                        DisassembleHeader, DisassembleInstruction,
+                        nullptr) == SPV_SUCCESS;
+}
+
+bool DisassemblyContext::Disassemble(const std::vector<uint32_t>& binary,
+                                     std::string* text) {
+  return Disassemble(binary.data(), binary.size(), text);
+}
+
+bool DisassemblyContext::DisassembleBatch(
+    const std::vector<std::vector<uint32_t>>& binaries,
+    std::vector<std::string>* texts) {
+  if (texts == nullptr) return false;
+  texts->resize(binaries.size());
+  bool all_succeeded = true;
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    all_succeeded = Disassemble(binaries[i], &(*texts)[i]) && all_succeeded;
+  }
+  return all_succeeded;
+}
 }  // namespace spvtools
 
 spv_result_t spvBinaryToText(const spv_const_context context,
@@ -554,6 +720,7 @@ spv_result_t spvBinaryToText(const spv_const_context context,
 
   // Now disassemble!
   spvtools::Disassembler disassembler(grammar, options, name_mapper);
+  disassembler.ReserveOutput(wordCount);
   if (auto error =
           spvBinaryParse(&hijack_context, &disassembler, code, wordCount,
                          spvtools::DisassembleHeader,
@@ -563,3 +730,45 @@ spv_result_t spvBinaryToText(const spv_const_context context,
 
   return disassembler.SaveTextResult(pText);
 }
+
+spv_result_t spvBinaryToTextStreamed(const spv_const_context context,
+                                     const uint32_t* code,
+                                     const size_t wordCount,
+                                     const uint32_t options,
+                                     spv_text_sink_fn_t sink, void* user_data,
+                                     spv_diagnostic* pDiagnostic) {
+  if (sink == nullptr) return SPV_ERROR_INVALID_POINTER;
+
+  spv_context_t hijack_context = *context;
+  if (pDiagnostic) {
+    *pDiagnostic = nullptr;
+    spvtools::UseDiagnosticAsMessageConsumer(&hijack_context, pDiagnostic);
+  }
+
+  const spvtools::AssemblyGrammar grammar(&hijack_context);
+  if (!grammar.isValid()) return SPV_ERROR_INVALID_TABLE;
+
+  // Generate friendly names for Ids if requested.
+  std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper;
+  spvtools::NameMapper name_mapper = spvtools::GetTrivialNameMapper();
+  if (options & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
+    friendly_mapper = spvtools::MakeUnique<spvtools::FriendlyNameMapper>(
+        &hijack_context, code, wordCount);
+    name_mapper = friendly_mapper->GetNameMapper();
+  }
+
+  // Now disassemble, forwarding the text to the caller's sink as it is
+  // produced instead of materializing it.
+  spvtools::CallbackSinkStreambuf sink_buf(sink, user_data);
+  std::ostream stream(&sink_buf);
+  spvtools::Disassembler disassembler(grammar, options, name_mapper, &stream);
+  if (auto error =
+          spvBinaryParse(&hijack_context, &disassembler, code, wordCount,
+                         spvtools::DisassembleHeader,
+                         spvtools::DisassembleInstruction, pDiagnostic)) {
+    return error;
+  }
+
+  sink_buf.Flush();
+  return sink_buf.status();
+}
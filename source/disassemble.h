@@ -16,7 +16,9 @@
 #define SOURCE_DISASSEMBLE_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "source/name_mapper.h"
 #include "spirv-tools/libspirv.h"
@@ -37,6 +39,68 @@ std::string spvInstructionBinaryToText(const spv_target_env env,
                                        const uint32_t options);
 
 class AssemblyGrammar;
+
+// A reusable disassembly session.  Where spvBinaryToText builds its grammar
+// tables and output buffer afresh on every call, a DisassemblyContext builds
+// them once at construction and reuses them for each module it is given,
+// which makes disassembling a large number of modules in a row considerably
+// cheaper.  The friendly-name mapper is the one piece of state that is still
+// rebuilt per module, since names depend on the module being disassembled.
+//
+// The SPV_BINARY_TO_TEXT_OPTION_PRINT option is ignored; text is always
+// delivered through the output string or stream.
+//
+// A DisassemblyContext may be used from several threads at once, provided
+// each concurrent call is given its own output string or stream: the shared
+// state is only read after construction.
+class DisassemblyContext {
+ public:
+  // Creates a session for the given target environment.  |options| is a bit
+  // field of spv_binary_to_text_options_t, applied to every disassembly.
+  DisassemblyContext(spv_target_env env, uint32_t options);
+  ~DisassemblyContext();
+
+  DisassemblyContext(const DisassemblyContext&) = delete;
+  DisassemblyContext& operator=(const DisassemblyContext&) = delete;
+
+  // Returns true if the underlying context and grammar tables were built
+  // successfully.
+  bool IsValid() const;
+
+  // Disassembles the module of |word_count| words at |binary| and overwrites
+  // |*text| with its assembly text.  The string is pre-sized from the binary
+  // size and its capacity is retained, so passing the same string for
+  // successive modules avoids reallocation.  Returns true on success; on
+  // failure |*text| is left empty.
+  bool Disassemble(const uint32_t* binary, size_t word_count,
+                   std::string* text);
+  bool Disassemble(const std::vector<uint32_t>& binary, std::string* text);
+
+  // Disassembles the module of |word_count| words at |binary|, writing the
+  // assembly text directly to |*sink| with no intermediate buffering.
+  // Returns true on success; text emitted before a parse failure is not
+  // rolled back.
+  bool Disassemble(const uint32_t* binary, size_t word_count,
+                   std::ostream* sink);
+
+  // Disassembles each module in |binaries|, leaving one string per module in
+  // |*texts|, in the same order.  Modules that fail to disassemble yield an
+  // empty string.  Returns true if every module succeeded.
+  bool DisassembleBatch(const std::vector<std::vector<uint32_t>>& binaries,
+                        std::vector<std::string>* texts);
+
+ private:
+  // Returns the name mapper to use for the given module, storing any
+  // per-module friendly-name state in |*friendly_mapper|.
+  NameMapper GetNameMapperForModule(
+      const uint32_t* binary, size_t word_count,
+      std::unique_ptr<FriendlyNameMapper>* friendly_mapper) const;
+
+  spv_context context_;
+  std::unique_ptr<AssemblyGrammar> grammar_;
+  const uint32_t options_;
+};
+
 namespace disassemble {
 
 // Shared code with other tools (than the disassembler) that might need to
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "source/latest_version_spirv_header.h"
+#include "source/util/bitutils.h"
 #include "source/util/make_unique.h"
 
 namespace spvtools {
@@ -101,10 +102,12 @@ class EnumSet {
   bool Contains(EnumType c) const { return ContainsWord(ToWord(c)); }
 
   // Applies f to each enum in the set, in order from smallest enum
-  // value to largest.
+  // value to largest.  Count-trailing-zeros jumps from one set mask bit
+  // to the next, so the cost scales with the number of members rather
+  // than with the width of the mask.
   void ForEach(std::function<void(EnumType)> f) const {
-    for (uint32_t i = 0; i < 64; ++i) {
-      if (mask_ & AsMask(i)) f(static_cast<EnumType>(i));
+    for (uint64_t bits = mask_; bits != 0; bits &= bits - 1) {
+      f(static_cast<EnumType>(utils::CountTrailingZeros(bits)));
     }
     if (overflow_) {
       for (uint32_t c : *overflow_) f(static_cast<EnumType>(c));
@@ -134,6 +137,34 @@ class EnumSet {
     return false;
   }
 
+  // Adds every element of |other| to the set.  The mask parts merge with a
+  // single bitwise-or, so this is much cheaper than adding the elements of
+  // |other| one at a time.
+  void AddAll(const EnumSet<EnumType>& other) {
+    mask_ |= other.mask_;
+    if (other.overflow_) {
+      Overflow().insert(other.overflow_->begin(), other.overflow_->end());
+    }
+  }
+
+  // Removes every element that is not also in |other|.
+  void IntersectWith(const EnumSet<EnumType>& other) {
+    mask_ &= other.mask_;
+    if (!overflow_) return;
+    if (!other.overflow_) {
+      overflow_.reset(nullptr);
+      return;
+    }
+    for (auto it = overflow_->begin(); it != overflow_->end();) {
+      if (other.overflow_->count(*it)) {
+        ++it;
+      } else {
+        it = overflow_->erase(it);
+      }
+    }
+    if (overflow_->empty()) overflow_.reset(nullptr);
+  }
+
  private:
   // Adds the given enum value (as a 32-bit word) to the set.  This has no
   // effect if the enum value is already in the set.
@@ -0,0 +1,275 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "spirv-tools/extract.hpp"
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "source/diagnostic.h"
+#include "source/opt/build_module.h"
+#include "source/opt/compact_ids_pass.h"
+#include "source/opt/eliminate_dead_functions_util.h"
+#include "source/opt/ir_context.h"
+#include "source/opt/pass_manager.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace {
+
+using opt::Function;
+using opt::Instruction;
+using opt::IRContext;
+using opt::Module;
+using opt::analysis::DefUseManager;
+
+// In-operand indices of OpEntryPoint.
+constexpr uint32_t kEntryPointFunctionIdInIdx = 1;
+constexpr uint32_t kEntryPointNameInIdx = 2;
+
+// Marks ids transitively referenced by the roots recorded in |used| and
+// |work|.  Referencing a function id pulls in every id its body uses;
+// referencing a module-scope definition pulls in its type and operands.
+class ReferenceMarker {
+ public:
+  explicit ReferenceMarker(IRContext* ir) : ir_(ir) {}
+
+  bool IsUsed(uint32_t id) const { return used_.count(id) != 0; }
+
+  size_t NumUsed() const { return used_.size(); }
+
+  void MarkId(uint32_t id) {
+    if (id != 0 && used_.insert(id).second) work_.push_back(id);
+  }
+
+  // Marks every id |inst| references: its result type and all in-operand
+  // ids.  The result id itself is not marked.
+  void MarkIdsOf(const Instruction& inst) {
+    MarkId(inst.type_id());
+    inst.ForEachInId([this](const uint32_t* id) { MarkId(*id); });
+    for (const Instruction& line : inst.dbg_line_insts()) MarkIdsOf(line);
+  }
+
+  // Follows all outstanding ids to a fixpoint.
+  void Close() {
+    DefUseManager* def_use = ir_->get_def_use_mgr();
+    while (!work_.empty()) {
+      const uint32_t id = work_.back();
+      work_.pop_back();
+      Instruction* def = def_use->GetDef(id);
+      if (def == nullptr) continue;
+      if (def->opcode() == spv::Op::OpFunction) {
+        Function* func = ir_->GetFunction(id);
+        if (func == nullptr) continue;
+        func->ForEachInst(
+            [this](const Instruction* inst) { MarkIdsOf(*inst); },
+            /* run_on_debug_line_insts = */ true,
+            /* run_on_non_semantic_insts = */ true);
+      } else {
+        MarkIdsOf(*def);
+      }
+    }
+  }
+
+ private:
+  IRContext* ir_;
+  std::unordered_set<uint32_t> used_;
+  std::vector<uint32_t> work_;
+};
+
+// Returns true if the annotation section uses decoration groups.  Group
+// members are shared between targets, so per-target pruning would have to
+// rewrite group instructions; modules using this deprecated feature keep
+// their annotation section intact instead.
+bool HasGroupDecorations(const Module& module) {
+  for (const Instruction& inst : module.annotations()) {
+    switch (inst.opcode()) {
+      case spv::Op::OpDecorationGroup:
+      case spv::Op::OpGroupDecorate:
+      case spv::Op::OpGroupMemberDecorate:
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+// Returns true if |id| is defined by a function or module-scope variable
+// that is not in the used set.  These are the definitions the sweep will
+// remove, so module-scope debug instructions referencing them must go too.
+bool IsDoomedAnchor(uint32_t id, const ReferenceMarker& marker,
+                    DefUseManager* def_use) {
+  if (marker.IsUsed(id)) return false;
+  const Instruction* def = def_use->GetDef(id);
+  if (def == nullptr) return false;
+  return def->opcode() == spv::Op::OpFunction ||
+         def->opcode() == spv::Op::OpVariable;
+}
+
+}  // namespace
+
+spv_result_t Extract(const Context& context,
+                     const std::vector<uint32_t>& binary,
+                     const std::string& entry_point_name,
+                     std::vector<uint32_t>* extracted_binary) {
+  spv_position_t position = {};
+  const spv_context& c_context = context.CContext();
+  const MessageConsumer& consumer = c_context->consumer;
+
+  extracted_binary->clear();
+  std::unique_ptr<IRContext> ir = BuildModule(
+      c_context->target_env, consumer, binary.data(), binary.size());
+  if (ir == nullptr)
+    return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
+           << "Failed to build module out of binary.";
+
+  Module* module = ir->module();
+  DefUseManager* def_use = ir->get_def_use_mgr();
+
+  // Phase 1: Find the entry points to keep and seed the reachability walk
+  // from them and their execution modes.
+  std::unordered_set<const Instruction*> kept_entry_points;
+  std::unordered_set<uint32_t> kept_entry_fn_ids;
+  ReferenceMarker marker(ir.get());
+  for (const Instruction& inst : module->entry_points()) {
+    if (inst.GetInOperand(kEntryPointNameInIdx).AsString() !=
+        entry_point_name) {
+      continue;
+    }
+    kept_entry_points.insert(&inst);
+    kept_entry_fn_ids.insert(
+        inst.GetSingleWordInOperand(kEntryPointFunctionIdInIdx));
+    marker.MarkIdsOf(inst);
+  }
+  if (kept_entry_points.empty())
+    return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_VALUE)
+           << "No entry point named \"" << entry_point_name << "\".";
+  for (const Instruction& inst : module->execution_modes()) {
+    if (kept_entry_fn_ids.count(inst.GetSingleWordInOperand(0u)))
+      marker.MarkIdsOf(inst);
+  }
+
+  const bool keep_all_annotations = HasGroupDecorations(*module);
+  if (keep_all_annotations) {
+    for (const Instruction& inst : module->annotations()) {
+      marker.MarkIdsOf(inst);
+    }
+  }
+  marker.Close();
+
+  // Phase 2: Kept annotations can themselves reference ids (OpDecorateId),
+  // and those ids can make further annotations relevant, so iterate to a
+  // fixpoint.
+  if (!keep_all_annotations) {
+    size_t used_before = 0;
+    while (used_before != marker.NumUsed()) {
+      used_before = marker.NumUsed();
+      for (const Instruction& inst : module->annotations()) {
+        if (marker.IsUsed(inst.GetSingleWordInOperand(0u)))
+          marker.MarkIdsOf(inst);
+      }
+      marker.Close();
+    }
+  }
+
+  // Phase 3: Module-scope extended debug instructions are kept unless they
+  // reference a definition the sweep removes (directly or through another
+  // dropped debug instruction).  Kept ones then pin their own operands,
+  // e.g. the constants spelling out type sizes.
+  std::unordered_set<uint32_t> dropped_debug;
+  bool debug_changed = true;
+  while (debug_changed) {
+    debug_changed = false;
+    for (const Instruction& inst : module->ext_inst_debuginfo()) {
+      if (dropped_debug.count(inst.result_id())) continue;
+      bool drop = false;
+      inst.ForEachInId([&drop, &dropped_debug, &marker,
+                        def_use](const uint32_t* id) {
+        if (drop) return;
+        if (dropped_debug.count(*id) ||
+            IsDoomedAnchor(*id, marker, def_use)) {
+          drop = true;
+        }
+      });
+      if (drop) {
+        dropped_debug.insert(inst.result_id());
+        debug_changed = true;
+      }
+    }
+  }
+  for (const Instruction& inst : module->ext_inst_debuginfo()) {
+    if (!dropped_debug.count(inst.result_id())) marker.MarkIdsOf(inst);
+  }
+  marker.Close();
+
+  // Phase 4: Sweep.  Collect module-scope instructions first, then kill, so
+  // the decisions above never read partially-deleted state.
+  std::vector<Instruction*> to_kill;
+  for (Instruction& inst : module->entry_points()) {
+    if (!kept_entry_points.count(&inst)) to_kill.push_back(&inst);
+  }
+  for (Instruction& inst : module->execution_modes()) {
+    if (!kept_entry_fn_ids.count(inst.GetSingleWordInOperand(0u)))
+      to_kill.push_back(&inst);
+  }
+  for (Instruction& inst : module->debugs2()) {
+    if (!marker.IsUsed(inst.GetSingleWordInOperand(0u)))
+      to_kill.push_back(&inst);
+  }
+  if (!keep_all_annotations) {
+    for (Instruction& inst : module->annotations()) {
+      if (!marker.IsUsed(inst.GetSingleWordInOperand(0u)))
+        to_kill.push_back(&inst);
+    }
+  }
+  for (Instruction& inst : module->ext_inst_debuginfo()) {
+    if (dropped_debug.count(inst.result_id())) to_kill.push_back(&inst);
+  }
+  for (Instruction& inst : module->ext_inst_imports()) {
+    if (!marker.IsUsed(inst.result_id())) to_kill.push_back(&inst);
+  }
+  for (Instruction& inst : module->types_values()) {
+    if (inst.HasResultId()) {
+      if (!marker.IsUsed(inst.result_id())) to_kill.push_back(&inst);
+    } else if (inst.opcode() == spv::Op::OpTypeForwardPointer) {
+      if (!marker.IsUsed(inst.GetSingleWordInOperand(0u)))
+        to_kill.push_back(&inst);
+    }
+  }
+  for (Instruction* inst : to_kill) ir->KillInst(inst);
+  for (auto func_iter = module->begin(); func_iter != module->end();) {
+    if (marker.IsUsed(func_iter->result_id())) {
+      ++func_iter;
+    } else {
+      func_iter =
+          opt::eliminatedeadfunctionsutil::EliminateFunction(ir.get(),
+                                                             &func_iter);
+    }
+  }
+
+  // Phase 5: Compact the ids and emit the binary.
+  opt::PassManager manager;
+  manager.SetMessageConsumer(consumer);
+  manager.AddPass<opt::CompactIdsPass>();
+  if (manager.Run(ir.get()) == opt::Pass::Status::Failure)
+    return DiagnosticStream(position, consumer, "", SPV_ERROR_INTERNAL)
+           << "Failed to compact ids in the extracted module.";
+
+  module->ToBinary(extracted_binary, true);
+  return SPV_SUCCESS;
+}
+
+}  // namespace spvtools
@@ -222,6 +222,7 @@ void AddUnreachableEdgeAndUpdateOpPhis(
   const bool from_to_edge_already_exists = bb_from->IsSuccessor(bb_to);
   *bb_from->terminator() = CreateUnreachableEdgeInstruction(
       context, bb_from->id(), bb_to->id(), bool_id);
+  context->UpdateDefUse(bb_from->terminator());
 
   // Update OpPhi instructions in the target block if this branch adds a
   // previously non-existent edge from source to target.
@@ -235,9 +236,17 @@ void AddUnreachableEdgeAndUpdateOpPhis(
              "There should be at least one phi id per OpPhi instruction.");
       inst.AddOperand({SPV_OPERAND_TYPE_ID, {phi_ids[phi_index]}});
       inst.AddOperand({SPV_OPERAND_TYPE_ID, {bb_from->id()}});
+      context->UpdateDefUse(&inst);
       phi_index++;
     }
   }
+
+  // The new terminator names |bb_to| as one more successor label, exactly as
+  // a rebuild of the CFG would see it, so record the extra predecessor edge
+  // if the CFG is currently valid.
+  if (context->AreAnalysesValid(opt::IRContext::kAnalysisCFG)) {
+    context->cfg()->AddEdge(bb_from->id(), bb_to->id());
+  }
 }
 
 bool BlockIsBackEdge(opt::IRContext* context, uint32_t block_id,
@@ -546,10 +555,10 @@ bool IsValidAndWellFormed(const opt::IRContext* ir_context,
 }
 
 std::unique_ptr<opt::IRContext> CloneIRContext(opt::IRContext* context) {
-  std::vector<uint32_t> binary;
-  context->module()->ToBinary(&binary, false);
-  return BuildModule(context->grammar().target_env(), nullptr, binary.data(),
-                     binary.size());
+  // Structurally cloning the module is much cheaper than serializing it and
+  // parsing the resulting binary back, and fuzzer passes clone modules
+  // frequently, e.g. to try out a transformation on the clone first.
+  return context->Clone();
 }
 
 bool IsNonFunctionTypeId(opt::IRContext* ir_context, uint32_t id) {
@@ -15,6 +15,7 @@
 #include "source/fuzz/replayer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -25,6 +26,7 @@
 #include "source/fuzz/transformation_context.h"
 #include "source/opt/build_module.h"
 #include "source/util/make_unique.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace fuzz {
@@ -47,7 +49,9 @@ Replayer::Replayer(
 
 Replayer::~Replayer() = default;
 
-Replayer::ReplayerResult Replayer::Run() {
+Replayer::ReplayerResultStatus Replayer::Prepare(
+    spvtools::SpirvTools* tools, std::unique_ptr<opt::IRContext>* ir_context,
+    std::unique_ptr<TransformationContext>* transformation_context) {
   // Check compatibility between the library version being linked with and the
   // header files being used.
   GOOGLE_PROTOBUF_VERIFY_VERSION;
@@ -58,43 +62,33 @@ Replayer::ReplayerResult Replayer::Run() {
     consumer_(SPV_MSG_ERROR, nullptr, {},
               "The number of transformations to be replayed must not "
               "exceed the size of the transformation sequence.");
-    return {Replayer::ReplayerResultStatus::kTooManyTransformationsRequested,
-            nullptr, nullptr, protobufs::TransformationSequence()};
+    return ReplayerResultStatus::kTooManyTransformationsRequested;
   }
 
-  spvtools::SpirvTools tools(target_env_);
-  if (!tools.IsValid()) {
+  if (!tools->IsValid()) {
     consumer_(SPV_MSG_ERROR, nullptr, {},
               "Failed to create SPIRV-Tools interface; stopping.");
-    return {Replayer::ReplayerResultStatus::kFailedToCreateSpirvToolsInterface,
-            nullptr, nullptr, protobufs::TransformationSequence()};
+    return ReplayerResultStatus::kFailedToCreateSpirvToolsInterface;
   }
 
   // Initial binary should be valid.
-  if (!tools.Validate(&binary_in_[0], binary_in_.size(), validator_options_)) {
+  if (!tools->Validate(&binary_in_[0], binary_in_.size(),
+                       validator_options_)) {
     consumer_(SPV_MSG_INFO, nullptr, {},
               "Initial binary is invalid; stopping.");
-    return {Replayer::ReplayerResultStatus::kInitialBinaryInvalid, nullptr,
-            nullptr, protobufs::TransformationSequence()};
+    return ReplayerResultStatus::kInitialBinaryInvalid;
   }
 
   // Build the module from the input binary.
-  std::unique_ptr<opt::IRContext> ir_context =
+  *ir_context =
       BuildModule(target_env_, consumer_, binary_in_.data(), binary_in_.size());
-  assert(ir_context);
-
-  // For replay validation, we track the last valid SPIR-V binary that was
-  // observed. Initially this is the input binary.
-  std::vector<uint32_t> last_valid_binary;
-  if (validate_during_replay_) {
-    last_valid_binary = binary_in_;
-  }
+  assert(*ir_context);
 
   // We find the smallest id that is (a) not in use by the original module, and
   // (b) not used by any transformation in the sequence to be replayed.  This
   // serves as a starting id from which to issue overflow ids if they are
   // required during replay.
-  uint32_t first_overflow_id = ir_context->module()->id_bound();
+  uint32_t first_overflow_id = (*ir_context)->module()->id_bound();
   for (auto& transformation : transformation_sequence_in_.transformation()) {
     auto fresh_ids = Transformation::FromMessage(transformation)->GetFreshIds();
     if (!fresh_ids.empty()) {
@@ -104,12 +98,31 @@ Replayer::ReplayerResult Replayer::Run() {
     }
   }
 
-  std::unique_ptr<TransformationContext> transformation_context =
-      MakeUnique<TransformationContext>(
-          MakeUnique<FactManager>(ir_context.get()), validator_options_,
-          MakeUnique<CounterOverflowIdSource>(first_overflow_id));
-  transformation_context->GetFactManager()->AddInitialFacts(consumer_,
-                                                            initial_facts_);
+  *transformation_context = MakeUnique<TransformationContext>(
+      MakeUnique<FactManager>(ir_context->get()), validator_options_,
+      MakeUnique<CounterOverflowIdSource>(first_overflow_id));
+  (*transformation_context)
+      ->GetFactManager()
+      ->AddInitialFacts(consumer_, initial_facts_);
+  return ReplayerResultStatus::kComplete;
+}
+
+Replayer::ReplayerResult Replayer::Run() {
+  spvtools::SpirvTools tools(target_env_);
+  std::unique_ptr<opt::IRContext> ir_context;
+  std::unique_ptr<TransformationContext> transformation_context;
+  auto setup_status = Prepare(&tools, &ir_context, &transformation_context);
+  if (setup_status != ReplayerResultStatus::kComplete) {
+    return {setup_status, nullptr, nullptr,
+            protobufs::TransformationSequence()};
+  }
+
+  // For replay validation, we track the last valid SPIR-V binary that was
+  // observed. Initially this is the input binary.
+  std::vector<uint32_t> last_valid_binary;
+  if (validate_during_replay_) {
+    last_valid_binary = binary_in_;
+  }
 
   // We track the largest id bound observed, to ensure that it only increases
   // as transformations are applied.
@@ -166,5 +179,109 @@ Replayer::ReplayerResult Replayer::Run() {
           std::move(transformation_sequence_out)};
 }
 
+Replayer::ReplayerResult Replayer::RunStaged(uint32_t stage_size) {
+  assert(stage_size > 0 && "A stage must hold at least one transformation.");
+  if (!validate_during_replay_ || stage_size <= 1) {
+    // Staging only changes the granularity at which the validator runs, so
+    // there is nothing to gain over the classic engine here.
+    return Run();
+  }
+
+  spvtools::SpirvTools tools(target_env_);
+  std::unique_ptr<opt::IRContext> ir_context;
+  std::unique_ptr<TransformationContext> transformation_context;
+  auto setup_status = Prepare(&tools, &ir_context, &transformation_context);
+  if (setup_status != ReplayerResultStatus::kComplete) {
+    return {setup_status, nullptr, nullptr,
+            protobufs::TransformationSequence()};
+  }
+
+  // We track the largest id bound observed, to ensure that it only increases
+  // as transformations are applied.
+  uint32_t max_observed_id_bound = ir_context->module()->id_bound();
+  (void)(max_observed_id_bound);  // Keep release-mode compilers happy.
+
+  protobufs::TransformationSequence transformation_sequence_out;
+
+  // Snapshots of the module taken at each stage boundary are validated on
+  // worker threads while this thread carries on applying the next stage.
+  // Each task owns its snapshot and uses its own SpirvTools instance, so the
+  // tasks are independent of one another and of the evolving module;
+  // |stage_failed| lets them skip work once any snapshot has proved invalid.
+  const size_t num_stages =
+      (num_transformations_to_apply_ + stage_size - 1) / stage_size;
+  utils::ThreadPool pool(
+      std::min(utils::ThreadPool::DefaultThreadCount(), num_stages));
+  std::atomic<bool> stage_failed(false);
+
+  auto schedule_stage_validation = [this, &pool, &stage_failed,
+                                    &ir_context]() {
+    auto snapshot = std::make_shared<std::vector<uint32_t>>();
+    ir_context->module()->ToBinary(snapshot.get(), false);
+    pool.Schedule([this, snapshot, &stage_failed] {
+      if (stage_failed.load()) {
+        return;
+      }
+      // A fresh SpirvTools instance per task: validation runs off the main
+      // thread, and instances must not be shared across threads.  Its default
+      // message consumer is silent; failures are reported on the main thread.
+      spvtools::SpirvTools stage_tools(target_env_);
+      if (!stage_tools.Validate(snapshot->data(), snapshot->size(),
+                                validator_options_)) {
+        stage_failed.store(true);
+      }
+    });
+  };
+
+  // Consider the transformation proto messages in turn.
+  uint32_t counter = 0;
+  uint32_t applied_in_stage = 0;
+  for (auto& message : transformation_sequence_in_.transformation()) {
+    if (counter >= num_transformations_to_apply_) {
+      break;
+    }
+    counter++;
+
+    auto transformation = Transformation::FromMessage(message);
+
+    // Check whether the transformation can be applied.
+    if (transformation->IsApplicable(ir_context.get(),
+                                     *transformation_context)) {
+      // The transformation is applicable, so apply it, and copy it to the
+      // sequence of transformations that were applied.
+      transformation->Apply(ir_context.get(), transformation_context.get());
+      *transformation_sequence_out.add_transformation() = message;
+
+      assert(ir_context->module()->id_bound() >= max_observed_id_bound &&
+             "The module's id bound should only increase due to applying "
+             "transformations.");
+      max_observed_id_bound = ir_context->module()->id_bound();
+
+      if (++applied_in_stage == stage_size) {
+        schedule_stage_validation();
+        applied_in_stage = 0;
+      }
+    }
+  }
+  // Validate the final, partial stage so that every applied transformation is
+  // covered by some snapshot.
+  if (applied_in_stage > 0) {
+    schedule_stage_validation();
+  }
+
+  pool.Wait();
+  if (stage_failed.load()) {
+    consumer_(SPV_MSG_INFO, nullptr, {},
+              "Binary became invalid during replay (replay without staging "
+              "to pinpoint the offending transformation); stopping.");
+    return {Replayer::ReplayerResultStatus::kReplayValidationFailure, nullptr,
+            nullptr, protobufs::TransformationSequence()};
+  }
+
+  return {Replayer::ReplayerResultStatus::kComplete, std::move(ir_context),
+          std::move(transformation_context),
+          std::move(transformation_sequence_out)};
+}
+
 }  // namespace fuzz
 }  // namespace spvtools
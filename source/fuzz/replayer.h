@@ -73,7 +73,31 @@ class Replayer {
   // sequence, and null pointers for the IR context and transformation context.
   ReplayerResult Run();
 
+  // As Run(), but validates the module once per stage of up to |stage_size|
+  // applied transformations instead of after every transformation, with the
+  // validation of each stage's snapshot running on worker threads while the
+  // main thread carries on applying the next stage.  Transformations are
+  // still applied strictly in sequence order: each one reads module state its
+  // predecessors wrote, so the sequence itself is the dependency order.
+  //
+  // The result is as for Run(), except that a validation failure is only
+  // detected at stage granularity; replay the sequence with Run() to pinpoint
+  // the offending transformation.  Intended for bulk replay of sequences that
+  // are expected to validate, where per-transformation validation dominates
+  // replay time.
+  ReplayerResult RunStaged(uint32_t stage_size);
+
  private:
+  // Performs the setup shared by the replay engines: checks that the number
+  // of transformations requested is in range, that |tools| is usable and that
+  // |binary_in_| is valid, then builds |ir_context| from the binary and
+  // populates |transformation_context| with the initial facts.  Returns
+  // ReplayerResultStatus::kComplete on success; otherwise communicates the
+  // problem via |consumer_| and returns the status the run should report.
+  ReplayerResultStatus Prepare(
+      spvtools::SpirvTools* tools, std::unique_ptr<opt::IRContext>* ir_context,
+      std::unique_ptr<TransformationContext>* transformation_context);
+
   // Target environment.
   const spv_target_env target_env_;
 
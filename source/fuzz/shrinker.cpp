@@ -14,6 +14,8 @@
 
 #include "source/fuzz/shrinker.h"
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 
 #include "source/fuzz/added_function_reducer.h"
@@ -23,6 +25,7 @@
 #include "source/opt/ir_context.h"
 #include "source/spirv_fuzzer_options.h"
 #include "source/util/make_unique.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace fuzz {
@@ -60,6 +63,38 @@ protobufs::TransformationSequence RemoveChunk(
   return result;
 }
 
+// A helper to return a transformation sequence identical to |transformations|,
+// except that every chunk of size |chunk_size| whose index appears in
+// |chunk_indices| is removed.
+protobufs::TransformationSequence RemoveChunks(
+    const protobufs::TransformationSequence& transformations,
+    const std::vector<uint32_t>& chunk_indices, uint32_t chunk_size) {
+  protobufs::TransformationSequence result;
+  for (uint32_t j = 0; j < NumRemainingTransformations(transformations); j++) {
+    const uint32_t enclosing_chunk = j / chunk_size;
+    if (std::find(chunk_indices.begin(), chunk_indices.end(),
+                  enclosing_chunk) != chunk_indices.end()) {
+      continue;
+    }
+    *result.mutable_transformation()->Add() =
+        transformations.transformation()[j];
+  }
+  return result;
+}
+
+// State for one speculative chunk-removal attempt, filled in by the worker
+// that replays it.
+struct SpeculativeAttempt {
+  // The current best sequence with the attempt's chunk removed.
+  protobufs::TransformationSequence transformations;
+  // The subsequence of |transformations| that replay managed to apply.
+  protobufs::TransformationSequence applied_transformations;
+  // The binary resulting from replay.
+  std::vector<uint32_t> binary;
+  bool replay_succeeded = false;
+  bool interesting = false;
+};
+
 }  // namespace
 
 Shrinker::Shrinker(
@@ -69,7 +104,7 @@ Shrinker::Shrinker(
     const protobufs::TransformationSequence& transformation_sequence_in,
     const InterestingnessFunction& interestingness_function,
     uint32_t step_limit, bool validate_during_replay,
-    spv_validator_options validator_options)
+    spv_validator_options validator_options, uint32_t num_threads)
     : target_env_(target_env),
       consumer_(std::move(consumer)),
       binary_in_(binary_in),
@@ -78,7 +113,8 @@ Shrinker::Shrinker(
       interestingness_function_(interestingness_function),
       step_limit_(step_limit),
       validate_during_replay_(validate_during_replay),
-      validator_options_(validator_options) {}
+      validator_options_(validator_options),
+      num_threads_(num_threads) {}
 
 Shrinker::~Shrinker() = default;
 
@@ -144,6 +180,19 @@ Shrinker::ShrinkerResult Shrinker::Run() {
                             // shrinker will try to remove in one go; starts
                             // high and decreases during the shrinking process.
 
+  // Workers replay speculative chunk removals concurrently when more than
+  // one thread was requested.  With no workers the pool runs every attempt
+  // on this thread inside Wait(), which keeps the serial behaviour.
+  utils::ThreadPool pool(num_threads_ > 1 ? num_threads_ : 0);
+  std::mutex consumer_mutex;
+  MessageConsumer guarded_consumer =
+      [this, &consumer_mutex](spv_message_level_t level, const char* source,
+                              const spv_position_t& position,
+                              const char* message) {
+        const std::lock_guard<std::mutex> lock(consumer_mutex);
+        consumer_(level, source, position, message);
+      };
+
   // Keep shrinking until we:
   // - reach the step limit,
   // - run out of transformations to remove, or
@@ -176,55 +225,129 @@ Shrinker::ShrinkerResult Shrinker::Run() {
 
     // We go through the transformations in reverse, in chunks of size
     // |chunk_size|, using |chunk_index| to track which chunk to try removing
-    // next.  The loop exits early if we reach the shrinking step limit.
+    // next.  Up to |num_threads_| disjoint chunks are removed speculatively
+    // in one batch, each replaying on its own module; the loop exits early if
+    // we reach the shrinking step limit.
     for (int chunk_index = num_chunks - 1;
-         attempt < step_limit_ && chunk_index >= 0; chunk_index--) {
-      // Remove a chunk of transformations according to the current index and
-      // chunk size.
-      auto transformations_with_chunk_removed =
-          RemoveChunk(current_best_transformations,
-                      static_cast<uint32_t>(chunk_index), chunk_size);
-
-      // Replay the smaller sequence of transformations to get a next binary and
-      // transformation sequence. Note that the transformations arising from
-      // replay might be even smaller than the transformations with the chunk
-      // removed, because removing those transformations might make further
-      // transformations inapplicable.
-      auto replay_result =
-          Replayer(
-              target_env_, consumer_, binary_in_, initial_facts_,
-              transformations_with_chunk_removed,
-              static_cast<uint32_t>(
-                  transformations_with_chunk_removed.transformation_size()),
-              validate_during_replay_, validator_options_)
-              .Run();
-      if (replay_result.status != Replayer::ReplayerResultStatus::kComplete) {
-        // Replay should not fail; if it does, we need to abort shrinking.
-        return {ShrinkerResultStatus::kReplayFailed, std::vector<uint32_t>(),
-                protobufs::TransformationSequence()};
+         attempt < step_limit_ && chunk_index >= 0;) {
+      // Work downwards from |chunk_index|, without exceeding the remaining
+      // step budget.
+      const uint32_t batch_size =
+          std::min({std::max(1u, num_threads_),
+                    static_cast<uint32_t>(chunk_index) + 1,
+                    step_limit_ - attempt});
+
+      // Remove each chunk of transformations in the batch from the current
+      // best sequence.  The removals are disjoint, so each candidate is valid
+      // against the same baseline.
+      std::vector<SpeculativeAttempt> attempts(batch_size);
+      for (uint32_t slot = 0; slot < batch_size; slot++) {
+        attempts[slot].transformations =
+            RemoveChunk(current_best_transformations,
+                        static_cast<uint32_t>(chunk_index) - slot, chunk_size);
+      }
+
+      // Replay the smaller sequences of transformations to get the next
+      // binaries and transformation sequences. Note that the transformations
+      // arising from replay might be even smaller than the transformations
+      // with the chunk removed, because removing those transformations might
+      // make further transformations inapplicable.
+      for (uint32_t slot = 0; slot < batch_size; slot++) {
+        SpeculativeAttempt* speculative_attempt = &attempts[slot];
+        const uint32_t interestingness_counter = attempt + slot;
+        pool.Schedule([this, speculative_attempt, interestingness_counter,
+                       &guarded_consumer] {
+          const auto& candidate = speculative_attempt->transformations;
+          auto replay_result =
+              Replayer(target_env_, guarded_consumer, binary_in_,
+                       initial_facts_, candidate,
+                       static_cast<uint32_t>(candidate.transformation_size()),
+                       validate_during_replay_, validator_options_)
+                  .Run();
+          speculative_attempt->replay_succeeded =
+              replay_result.status == Replayer::ReplayerResultStatus::kComplete;
+          if (!speculative_attempt->replay_succeeded) {
+            return;
+          }
+          replay_result.transformed_module->module()->ToBinary(
+              &speculative_attempt->binary, false);
+          speculative_attempt->applied_transformations =
+              std::move(replay_result.applied_transformations);
+          speculative_attempt->interesting = interestingness_function_(
+              speculative_attempt->binary, interestingness_counter);
+        });
+      }
+      pool.Wait();
+      // Whether successful or not, each slot was a shrink attempt, so add the
+      // batch to our count of shrink attempts.
+      attempt += batch_size;
+
+      std::vector<uint32_t> successful_slots;
+      for (uint32_t slot = 0; slot < batch_size; slot++) {
+        if (!attempts[slot].replay_succeeded) {
+          // Replay should not fail; if it does, we need to abort shrinking.
+          return {ShrinkerResultStatus::kReplayFailed, std::vector<uint32_t>(),
+                  protobufs::TransformationSequence()};
+        }
+        assert(NumRemainingTransformations(
+                   attempts[slot].applied_transformations) >=
+                   (static_cast<uint32_t>(chunk_index) - slot) * chunk_size &&
+               "Removing this chunk of transformations should not have an "
+               "effect on earlier chunks.");
+        if (attempts[slot].interesting) {
+          successful_slots.push_back(slot);
+        }
       }
 
-      assert(
-          NumRemainingTransformations(replay_result.applied_transformations) >=
-              chunk_index * chunk_size &&
-          "Removing this chunk of transformations should not have an effect "
-          "on earlier chunks.");
-
-      std::vector<uint32_t> transformed_binary;
-      replay_result.transformed_module->module()->ToBinary(&transformed_binary,
-                                                           false);
-      if (interestingness_function_(transformed_binary, attempt)) {
-        // If the binary arising from the smaller transformation sequence is
-        // interesting, this becomes our current best binary and transformation
-        // sequence.
-        current_best_binary = std::move(transformed_binary);
-        current_best_transformations =
-            std::move(replay_result.applied_transformations);
+      if (!successful_slots.empty()) {
         progress_this_round = true;
+        bool merged = false;
+        if (successful_slots.size() > 1 && attempt < step_limit_) {
+          // Several disjoint removals succeeded against the same baseline.
+          // Try merging them into a single removal, falling back on the first
+          // success alone if the merged sequence conflicts (i.e. is no longer
+          // interesting).
+          std::vector<uint32_t> chunks_to_remove;
+          for (uint32_t slot : successful_slots) {
+            chunks_to_remove.push_back(static_cast<uint32_t>(chunk_index) -
+                                       slot);
+          }
+          auto merged_transformations = RemoveChunks(
+              current_best_transformations, chunks_to_remove, chunk_size);
+          auto merged_replay_result =
+              Replayer(target_env_, consumer_, binary_in_, initial_facts_,
+                       merged_transformations,
+                       static_cast<uint32_t>(
+                           merged_transformations.transformation_size()),
+                       validate_during_replay_, validator_options_)
+                  .Run();
+          if (merged_replay_result.status !=
+              Replayer::ReplayerResultStatus::kComplete) {
+            return {ShrinkerResultStatus::kReplayFailed,
+                    std::vector<uint32_t>(),
+                    protobufs::TransformationSequence()};
+          }
+          std::vector<uint32_t> merged_binary;
+          merged_replay_result.transformed_module->module()->ToBinary(
+              &merged_binary, false);
+          if (interestingness_function_(merged_binary, attempt)) {
+            current_best_binary = std::move(merged_binary);
+            current_best_transformations =
+                std::move(merged_replay_result.applied_transformations);
+            merged = true;
+          }
+          attempt++;
+        }
+        if (!merged) {
+          // The binary arising from the first successful removal becomes our
+          // current best binary and transformation sequence.
+          SpeculativeAttempt& accepted = attempts[successful_slots[0]];
+          current_best_binary = std::move(accepted.binary);
+          current_best_transformations =
+              std::move(accepted.applied_transformations);
+        }
       }
-      // Either way, this was a shrink attempt, so increment our count of shrink
-      // attempts.
-      attempt++;
+      chunk_index -= batch_size;
     }
     if (!progress_this_round) {
       // If we didn't manage to remove any chunks at this chunk size, try a
@@ -56,13 +56,19 @@ class Shrinker {
   using InterestingnessFunction = std::function<bool(
       const std::vector<uint32_t>& binary, uint32_t counter)>;
 
+  // |num_threads| is the number of speculative chunk removals to try in
+  // parallel; each one replays on its own module cloned from the input
+  // binary.  When |num_threads| is greater than 1 the interestingness
+  // function must be safe to invoke concurrently.  A value of 0 or 1 keeps
+  // the serial behaviour.
   Shrinker(spv_target_env target_env, MessageConsumer consumer,
            const std::vector<uint32_t>& binary_in,
            const protobufs::FactSequence& initial_facts,
            const protobufs::TransformationSequence& transformation_sequence_in,
            const InterestingnessFunction& interestingness_function,
            uint32_t step_limit, bool validate_during_replay,
-           spv_validator_options validator_options);
+           spv_validator_options validator_options,
+           uint32_t num_threads = 1);
 
   // Disables copy/move constructor/assignment operations.
   Shrinker(const Shrinker&) = delete;
@@ -120,6 +126,9 @@ class Shrinker {
 
   // Options to control validation.
   spv_validator_options validator_options_;
+
+  // Number of speculative chunk removals to try in parallel.
+  const uint32_t num_threads_;
 };
 
 }  // namespace fuzz
@@ -189,9 +189,19 @@ void TransformationAddDeadBreak::Apply(
                                        message_.break_condition_value(), false),
       message_.phi_id());
 
-  // Invalidate all analyses
+  // The new edge is maintained in def-use and the CFG by
+  // AddUnreachableEdgeAndUpdateOpPhis, no instruction moved between blocks,
+  // and no types, constants or decorations changed, so those analyses stay
+  // valid.  Dominance, loop and structured-CFG information genuinely change.
   ir_context->InvalidateAnalysesExceptFor(
-      opt::IRContext::Analysis::kAnalysisNone);
+      opt::IRContext::Analysis::kAnalysisDefUse |
+      opt::IRContext::Analysis::kAnalysisInstrToBlockMapping |
+      opt::IRContext::Analysis::kAnalysisCFG |
+      opt::IRContext::Analysis::kAnalysisDecorations |
+      opt::IRContext::Analysis::kAnalysisCombinators |
+      opt::IRContext::Analysis::kAnalysisNameMap |
+      opt::IRContext::Analysis::kAnalysisConstants |
+      opt::IRContext::Analysis::kAnalysisTypes);
 }
 
 protobufs::Transformation TransformationAddDeadBreak::ToMessage() const {
@@ -14,16 +14,179 @@
 
 #include "spirv-tools/libspirv.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "source/latest_version_spirv_header.h"
+#include "source/operand.h"
+#include "source/spirv_constant.h"
+#include "source/spirv_validator_options.h"
 #include "source/table.h"
+#include "source/util/compressed_words.h"
+#include "source/util/make_unique.h"
 
 namespace spvtools {
 
+namespace {
+
+// Identifies a validation cache file and the record format it contains.
+const uint32_t kValidationCacheMagic = 0x53505643;  // "SPVC"
+const uint32_t kValidationCacheVersion = 1;
+
+// Accumulates |num_bytes| bytes at |data| into the FNV-1a hash |hash|.
+uint64_t Fnv1a64(const void* data, size_t num_bytes, uint64_t hash) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < num_bytes; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Returns the cache key for validating |num_words| words at |words| against
+// |env| with |options|.  Every option that can affect the outcome is folded
+// into the key.  The parallel validation thread count is deliberately
+// excluded: it changes how validation runs, not what it reports.
+uint64_t ValidationCacheKey(spv_target_env env,
+                            spv_const_validator_options options,
+                            const uint32_t* words, size_t num_words) {
+  uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+  const uint32_t scalars[] = {
+      static_cast<uint32_t>(env),
+      options->universal_limits_.max_struct_members,
+      options->universal_limits_.max_struct_depth,
+      options->universal_limits_.max_local_variables,
+      options->universal_limits_.max_global_variables,
+      options->universal_limits_.max_switch_branches,
+      options->universal_limits_.max_function_args,
+      options->universal_limits_.max_control_flow_nesting_depth,
+      options->universal_limits_.max_access_chain_indexes,
+      options->universal_limits_.max_id_bound,
+  };
+  const uint8_t flags[] = {
+      options->relax_struct_store,
+      options->relax_logical_pointer,
+      options->relax_block_layout,
+      options->uniform_buffer_standard_layout,
+      options->scalar_block_layout,
+      options->workgroup_scalar_block_layout,
+      options->skip_block_layout,
+      options->allow_localsizeid,
+      options->before_hlsl_legalization,
+      options->use_friendly_names,
+  };
+  hash = Fnv1a64(scalars, sizeof(scalars), hash);
+  hash = Fnv1a64(flags, sizeof(flags), hash);
+  return Fnv1a64(words, num_words * sizeof(uint32_t), hash);
+}
+
+// An append-only on-disk set of keys for modules that have validated
+// successfully.  The file starts with a magic number and a format version,
+// followed by raw 64-bit keys in host byte order: the cache is host-specific,
+// like any other build artifact cache.  See
+// SpirvTools::EnableValidationCache.
+class ValidationResultCache {
+ public:
+  // Loads the cache file at |path|, creating or resetting it if it is absent
+  // or was written by an incompatible version.  Returns false if the file
+  // cannot be read or created.
+  bool Open(const std::string& path) {
+    path_ = path;
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+      uint32_t magic = 0;
+      uint32_t version = 0;
+      file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+      file.read(reinterpret_cast<char*>(&version), sizeof(version));
+      if (file && magic == kValidationCacheMagic &&
+          version == kValidationCacheVersion) {
+        uint64_t key;
+        while (
+            file.read(reinterpret_cast<char*>(&key), sizeof(key)).good()) {
+          keys_.insert(key);
+        }
+        return true;
+      }
+    }
+    // Absent, truncated, or incompatible: start a fresh cache file.
+    std::ofstream fresh(path, std::ios::binary | std::ios::trunc);
+    fresh.write(reinterpret_cast<const char*>(&kValidationCacheMagic),
+                sizeof(kValidationCacheMagic));
+    fresh.write(reinterpret_cast<const char*>(&kValidationCacheVersion),
+                sizeof(kValidationCacheVersion));
+    return fresh.good();
+  }
+
+  bool Contains(uint64_t key) const { return keys_.count(key) != 0; }
+
+  // Records |key| in memory and appends it to the cache file.
+  void Insert(uint64_t key) {
+    if (!keys_.insert(key).second) return;
+    std::ofstream file(path_, std::ios::binary | std::ios::app);
+    file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+  }
+
+ private:
+  std::string path_;
+  std::unordered_set<uint64_t> keys_;
+};
+
+// Renumbers a module's ids in order of first appearance, so that two modules
+// differing only in id numbering canonicalize to identical word sequences.
+// See SpirvTools::AreStructurallyEquivalent.
+struct CanonicalIdMap {
+  uint32_t Map(uint32_t id) {
+    auto insertion = ids.emplace(id, next_id);
+    if (insertion.second) ++next_id;
+    return insertion.first->second;
+  }
+
+  std::unordered_map<uint32_t, uint32_t> ids;
+  uint32_t next_id = 1;
+};
+
+// Returns true if |opcode| only attaches a debug name or a tool note and
+// never affects the module's semantics.
+bool IsDebugNameInstruction(uint16_t opcode) {
+  switch (static_cast<spv::Op>(opcode)) {
+    case spv::Op::OpName:
+    case spv::Op::OpMemberName:
+    case spv::Op::OpModuleProcessed:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Appends the canonical form of |inst| to |out|: the opcode word unchanged,
+// id operands renumbered through |id_map|, and literal words verbatim.
+// Debug-name instructions contribute nothing.
+void AppendCanonicalForm(const spv_parsed_instruction_t& inst,
+                         CanonicalIdMap* id_map, std::vector<uint32_t>* out) {
+  if (IsDebugNameInstruction(inst.opcode)) return;
+  out->push_back(inst.words[0]);
+  for (uint16_t i = 0; i < inst.num_operands; ++i) {
+    const spv_parsed_operand_t& operand = inst.operands[i];
+    if (spvIsIdType(operand.type)) {
+      assert(operand.num_words == 1 && "Id operands occupy a single word.");
+      out->push_back(id_map->Map(inst.words[operand.offset]));
+    } else {
+      out->insert(out->end(), inst.words + operand.offset,
+                  inst.words + operand.offset + operand.num_words);
+    }
+  }
+}
+
+}  // namespace
+
 Context::Context(spv_target_env env) : context_(spvContextCreate(env)) {}
 
 Context::Context(Context&& other) : context_(other.context_) {
@@ -44,6 +207,10 @@ void Context::SetMessageConsumer(MessageConsumer consumer) {
   SetContextMessageConsumer(context_, std::move(consumer));
 }
 
+void Context::SetMessageConsumer(MessageConsumer consumer, bool consumes_text) {
+  SetContextMessageConsumer(context_, std::move(consumer), consumes_text);
+}
+
 spv_context& Context::CContext() { return context_; }
 
 const spv_context& Context::CContext() const { return context_; }
@@ -58,6 +225,22 @@ struct SpirvTools::Impl {
   ~Impl() { spvContextDestroy(context); }
 
   spv_context context;  // C interface context object.
+  // Cache of successful validation results, when enabled.
+  std::unique_ptr<ValidationResultCache> validation_cache;
+  // In-memory cache of successful validation results, when enabled.  Holds
+  // at most |session_cache_capacity| keys; 0 means disabled.
+  std::unordered_set<uint64_t> session_cache_keys;
+  size_t session_cache_capacity = 0;
+
+  // Records |key| in the in-memory cache, resetting the cache first if it is
+  // already at capacity.
+  void RememberSessionKey(uint64_t key) {
+    if (session_cache_keys.size() >= session_cache_capacity &&
+        session_cache_keys.count(key) == 0) {
+      session_cache_keys.clear();
+    }
+    session_cache_keys.insert(key);
+  }
 };
 
 SpirvTools::SpirvTools(spv_target_env env) : impl_(new Impl(env)) {
@@ -148,12 +331,45 @@ bool SpirvTools::Validate(const std::vector<uint32_t>& binary) const {
 
 bool SpirvTools::Validate(const uint32_t* binary,
                           const size_t binary_size) const {
-  return spvValidateBinary(impl_->context, binary, binary_size, nullptr) ==
-         SPV_SUCCESS;
+  uint64_t cache_key = 0;
+  const bool use_cache =
+      impl_->validation_cache || impl_->session_cache_capacity > 0;
+  if (use_cache) {
+    // spvValidateBinary validates with default options.
+    const spv_validator_options_t default_options;
+    cache_key = ValidationCacheKey(impl_->context->target_env,
+                                   &default_options, binary, binary_size);
+    if (impl_->session_cache_keys.count(cache_key) != 0) return true;
+    if (impl_->validation_cache &&
+        impl_->validation_cache->Contains(cache_key)) {
+      return true;
+    }
+  }
+  const bool valid = spvValidateBinary(impl_->context, binary, binary_size,
+                                       nullptr) == SPV_SUCCESS;
+  if (valid) {
+    if (impl_->session_cache_capacity > 0) {
+      impl_->RememberSessionKey(cache_key);
+    }
+    if (impl_->validation_cache) impl_->validation_cache->Insert(cache_key);
+  }
+  return valid;
 }
 
 bool SpirvTools::Validate(const uint32_t* binary, const size_t binary_size,
                           spv_validator_options options) const {
+  uint64_t cache_key = 0;
+  const bool use_cache =
+      impl_->validation_cache || impl_->session_cache_capacity > 0;
+  if (use_cache) {
+    cache_key = ValidationCacheKey(impl_->context->target_env, options, binary,
+                                   binary_size);
+    if (impl_->session_cache_keys.count(cache_key) != 0) return true;
+    if (impl_->validation_cache &&
+        impl_->validation_cache->Contains(cache_key)) {
+      return true;
+    }
+  }
   spv_const_binary_t the_binary{binary, binary_size};
   spv_diagnostic diagnostic = nullptr;
   bool valid = spvValidateWithOptions(impl_->context, options, &the_binary,
@@ -163,9 +379,116 @@ bool SpirvTools::Validate(const uint32_t* binary, const size_t binary_size,
         SPV_MSG_ERROR, nullptr, diagnostic->position, diagnostic->error);
   }
   spvDiagnosticDestroy(diagnostic);
+  if (valid) {
+    if (impl_->session_cache_capacity > 0) {
+      impl_->RememberSessionKey(cache_key);
+    }
+    if (impl_->validation_cache) impl_->validation_cache->Insert(cache_key);
+  }
   return valid;
 }
 
+bool SpirvTools::EnableValidationCache(const std::string& path) {
+  auto cache = MakeUnique<ValidationResultCache>();
+  if (!cache->Open(path)) return false;
+  impl_->validation_cache = std::move(cache);
+  return true;
+}
+
+void SpirvTools::EnableInMemoryValidationCache(size_t max_entries) {
+  impl_->session_cache_capacity = max_entries;
+  if (max_entries == 0) impl_->session_cache_keys.clear();
+}
+
+uint64_t SpirvTools::ComputeContentHash(const uint32_t* binary,
+                                        size_t binary_size) {
+  if (binary_size < SPV_INDEX_INSTRUCTION) return 0;
+  uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+  hash = Fnv1a64(&binary[SPV_INDEX_VERSION_NUMBER], sizeof(uint32_t), hash);
+  return Fnv1a64(&binary[SPV_INDEX_INSTRUCTION],
+                 (binary_size - SPV_INDEX_INSTRUCTION) * sizeof(uint32_t),
+                 hash);
+}
+
+uint64_t SpirvTools::ComputeContentHash(const std::vector<uint32_t>& binary) {
+  return ComputeContentHash(binary.data(), binary.size());
+}
+
+bool SpirvTools::AreStructurallyEquivalent(const uint32_t* lhs,
+                                           size_t lhs_size,
+                                           const uint32_t* rhs,
+                                           size_t rhs_size) const {
+  if (lhs_size < SPV_INDEX_INSTRUCTION || rhs_size < SPV_INDEX_INSTRUCTION) {
+    return false;
+  }
+  if (lhs[SPV_INDEX_VERSION_NUMBER] != rhs[SPV_INDEX_VERSION_NUMBER]) {
+    return false;
+  }
+
+  // Canonicalize the reference module in full.
+  struct ReferenceState {
+    CanonicalIdMap ids;
+    std::vector<uint32_t> words;
+  } reference;
+  spv_parsed_instruction_fn_t append_fn =
+      [](void* user_data, const spv_parsed_instruction_t* inst) {
+        auto* state = reinterpret_cast<ReferenceState*>(user_data);
+        AppendCanonicalForm(*inst, &state->ids, &state->words);
+        return SPV_SUCCESS;
+      };
+  if (spvBinaryParse(impl_->context, &reference, lhs, lhs_size, nullptr,
+                     append_fn, nullptr) != SPV_SUCCESS) {
+    return false;
+  }
+
+  // Stream the other module against the reference, stopping at the first
+  // instruction whose canonical form diverges.
+  struct CompareState {
+    const std::vector<uint32_t>& reference;
+    CanonicalIdMap ids;
+    std::vector<uint32_t> scratch;
+    size_t cursor = 0;
+  } compare{reference.words, {}, {}, 0};
+  spv_parsed_instruction_fn_t compare_fn =
+      [](void* user_data, const spv_parsed_instruction_t* inst) {
+        auto* state = reinterpret_cast<CompareState*>(user_data);
+        state->scratch.clear();
+        AppendCanonicalForm(*inst, &state->ids, &state->scratch);
+        if (state->cursor + state->scratch.size() > state->reference.size() ||
+            !std::equal(state->scratch.begin(), state->scratch.end(),
+                        state->reference.begin() + state->cursor)) {
+          return SPV_REQUESTED_TERMINATION;
+        }
+        state->cursor += state->scratch.size();
+        return SPV_SUCCESS;
+      };
+  if (spvBinaryParse(impl_->context, &compare, rhs, rhs_size, nullptr,
+                     compare_fn, nullptr) != SPV_SUCCESS) {
+    return false;
+  }
+  return compare.cursor == reference.words.size();
+}
+
+bool SpirvTools::AreStructurallyEquivalent(
+    const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs) const {
+  return AreStructurallyEquivalent(lhs.data(), lhs.size(), rhs.data(),
+                                   rhs.size());
+}
+
 bool SpirvTools::IsValid() const { return impl_->context != nullptr; }
 
+CompressedBinary::CompressedBinary(const uint32_t* words, size_t num_words)
+    : data_(utils::CompressWords(words, num_words)), num_words_(num_words) {}
+
+CompressedBinary::CompressedBinary(const std::vector<uint32_t>& words)
+    : CompressedBinary(words.data(), words.size()) {}
+
+bool CompressedBinary::Decompress(std::vector<uint32_t>* words) const {
+  if (num_words_ == 0) {
+    words->clear();
+    return false;
+  }
+  return utils::DecompressWords(data_, num_words_, words);
+}
+
 }  // namespace spvtools
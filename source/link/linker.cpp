@@ -18,8 +18,8 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
-#include <numeric>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -39,6 +39,7 @@
 #include "source/spirv_constant.h"
 #include "source/spirv_target_env.h"
 #include "source/util/make_unique.h"
+#include "source/util/thread_pool.h"
 #include "source/util/string_utils.h"
 #include "spirv-tools/libspirv.hpp"
 
@@ -74,16 +75,21 @@ struct LinkageEntry {
 };
 using LinkageTable = std::vector<LinkageEntry>;
 
-// Shifts the IDs used in each binary of |modules| so that they occupy a
-// disjoint range from the other binaries, and compute the new ID bound which
-// is returned in |max_id_bound|.
+// The modules were loaded with the pre-partitioned id ranges in |id_offsets|,
+// computed from their header bounds, so their ids are already disjoint.
+// Loading can however allocate a few extra ids past a module's declared range
+// (extra line tracking clones NonSemantic DebugLine instructions); this walks
+// the modules in order, shifts any module whose predecessors overflowed into
+// its range, and computes the final ID bound which is returned in
+// |max_id_bound|.
 //
 // Both |modules| and |max_id_bound| should not be null, and |modules| should
 // not be empty either. Furthermore |modules| should not contain any null
-// pointers.
-spv_result_t ShiftIdsInModules(const MessageConsumer& consumer,
-                               std::vector<opt::Module*>* modules,
-                               uint32_t* max_id_bound);
+// pointers, and |id_offsets| should have one entry per module.
+spv_result_t FixupPartitionedIds(const MessageConsumer& consumer,
+                                 std::vector<opt::Module*>* modules,
+                                 const std::vector<uint32_t>& id_offsets,
+                                 uint32_t* max_id_bound);
 
 // Generates the header for the linked module and returns it in |header|.
 //
@@ -156,47 +162,68 @@ spv_result_t VerifyIds(const MessageConsumer& consumer,
 spv_result_t VerifyLimits(const MessageConsumer& consumer,
                           const opt::IRContext& linked_context);
 
-spv_result_t ShiftIdsInModules(const MessageConsumer& consumer,
-                               std::vector<opt::Module*>* modules,
-                               uint32_t* max_id_bound) {
+spv_result_t FixupPartitionedIds(const MessageConsumer& consumer,
+                                 std::vector<opt::Module*>* modules,
+                                 const std::vector<uint32_t>& id_offsets,
+                                 uint32_t* max_id_bound) {
   spv_position_t position = {};
 
   if (modules == nullptr)
     return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
-           << "|modules| of ShiftIdsInModules should not be null.";
+           << "|modules| of FixupPartitionedIds should not be null.";
   if (modules->empty())
     return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
-           << "|modules| of ShiftIdsInModules should not be empty.";
+           << "|modules| of FixupPartitionedIds should not be empty.";
   if (max_id_bound == nullptr)
     return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
-           << "|max_id_bound| of ShiftIdsInModules should not be null.";
-
-  const size_t id_bound =
-      std::accumulate(modules->begin(), modules->end(), static_cast<size_t>(1),
-                      [](const size_t& accumulation, opt::Module* module) {
-                        return accumulation + module->IdBound() - 1u;
-                      });
-  if (id_bound > std::numeric_limits<uint32_t>::max())
-    return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
-           << "Too many IDs (" << id_bound
-           << "): combining all modules would overflow the 32-bit word of the "
-              "SPIR-V header.";
-
-  *max_id_bound = static_cast<uint32_t>(id_bound);
-
-  uint32_t id_offset = modules->front()->IdBound() - 1u;
-  for (auto module_iter = modules->begin() + 1; module_iter != modules->end();
-       ++module_iter) {
-    Module* module = *module_iter;
-    module->ForEachInst([&id_offset](Instruction* insn) {
-      insn->ForEachId([&id_offset](uint32_t* id) { *id += id_offset; });
-    });
-    id_offset += module->IdBound() - 1u;
-
-    // Invalidate the DefUseManager
-    module->context()->InvalidateAnalyses(opt::IRContext::kAnalysisDefUse);
+           << "|max_id_bound| of FixupPartitionedIds should not be null.";
+
+  uint32_t extra = 0u;
+  for (size_t i = 0u; i < modules->size(); ++i) {
+    Module* module = (*modules)[i];
+    if (extra != 0u) {
+      if (module->IdBound() > std::numeric_limits<uint32_t>::max() - extra)
+        return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
+               << "Too many IDs ("
+               << static_cast<size_t>(module->IdBound()) + extra
+               << "): combining all modules would overflow the 32-bit word of "
+                  "the SPIR-V header.";
+      // Also visit attached line instructions, and remap the ids held in
+      // debug scopes; neither is covered by ForEachId.
+      module->ForEachInst(
+          [extra](Instruction* insn) {
+            insn->ForEachId([extra](uint32_t* id) { *id += extra; });
+            const opt::DebugScope& scope = insn->GetDebugScope();
+            if (scope.GetLexicalScope() != opt::kNoDebugScope ||
+                scope.GetInlinedAt() != opt::kNoInlinedAt) {
+              const uint32_t lexical_scope =
+                  scope.GetLexicalScope() == opt::kNoDebugScope
+                      ? opt::kNoDebugScope
+                      : scope.GetLexicalScope() + extra;
+              const uint32_t inlined_at =
+                  scope.GetInlinedAt() == opt::kNoInlinedAt
+                      ? opt::kNoInlinedAt
+                      : scope.GetInlinedAt() + extra;
+              insn->SetDebugScope(
+                  opt::DebugScope(lexical_scope, inlined_at));
+            }
+          },
+          /* run_on_debug_line_insts = */ true);
+      module->SetIdBound(module->IdBound() + extra);
+
+      // Invalidate the DefUseManager
+      module->context()->InvalidateAnalyses(opt::IRContext::kAnalysisDefUse);
+    }
+    if (i + 1u < modules->size()) {
+      // The loader raised the module's bound past its declared partition end
+      // (|id_offsets[i + 1]| + 1) if extra line tracking had to allocate ids;
+      // those spilled ids push all later modules further up.
+      extra = module->IdBound() - 1u - id_offsets[i + 1u];
+    }
   }
 
+  *max_id_bound = modules->back()->IdBound();
+
   return SPV_SUCCESS;
 }
 
@@ -410,7 +437,20 @@ spv_result_t GetImportExportPairs(const MessageConsumer& consumer,
            << "|linkings_to_do| of GetImportExportPairs should not be empty.";
 
   std::vector<LinkageSymbolInfo> imports;
-  std::unordered_map<std::string, std::vector<LinkageSymbolInfo>> exports;
+  // The symbol table: every export is hashed once, keyed by name, and each
+  // import then resolves with a single lookup.  Only the first export seen
+  // for a name is remembered, together with how many there were; that is all
+  // that resolution and duplicate detection need.
+  struct ExportRecord {
+    LinkageSymbolInfo symbol;
+    uint32_t count;
+  };
+  std::unordered_map<std::string, ExportRecord> exports;
+
+  // Maps function result ids to the corresponding function, built on first
+  // need so that each symbol's parameters are found with a lookup instead of
+  // a scan over every function in the linked module.
+  std::unordered_map<uint32_t, const opt::Function*> functions_by_id;
 
   // Figure out the imports and exports
   for (const auto& decoration : linked_context.annotations()) {
@@ -454,14 +494,20 @@ spv_result_t GetImportExportPairs(const MessageConsumer& consumer,
     } else if (def_inst->opcode() == spv::Op::OpFunction) {
       symbol_info.type_id = def_inst->GetSingleWordInOperand(1u);
 
-      // range-based for loop calls begin()/end(), but never cbegin()/cend(),
-      // which will not work here.
-      for (auto func_iter = linked_context.module()->cbegin();
-           func_iter != linked_context.module()->cend(); ++func_iter) {
-        if (func_iter->result_id() != id) continue;
-        func_iter->ForEachParam([&symbol_info](const Instruction* inst) {
-          symbol_info.parameter_ids.push_back(inst->result_id());
-        });
+      if (functions_by_id.empty()) {
+        // range-based for loop calls begin()/end(), but never
+        // cbegin()/cend(), which will not work here.
+        for (auto func_iter = linked_context.module()->cbegin();
+             func_iter != linked_context.module()->cend(); ++func_iter) {
+          functions_by_id.emplace(func_iter->result_id(), &*func_iter);
+        }
+      }
+      const auto func_iter = functions_by_id.find(id);
+      if (func_iter != functions_by_id.end()) {
+        func_iter->second->ForEachParam(
+            [&symbol_info](const Instruction* inst) {
+              symbol_info.parameter_ids.push_back(inst->result_id());
+            });
       }
     } else {
       return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
@@ -469,27 +515,32 @@ spv_result_t GetImportExportPairs(const MessageConsumer& consumer,
              << " LinkageAttributes; " << id << " is neither of them.\n";
     }
 
-    if (spv::LinkageType(type) == spv::LinkageType::Import)
+    if (spv::LinkageType(type) == spv::LinkageType::Import) {
       imports.push_back(symbol_info);
-    else if (spv::LinkageType(type) == spv::LinkageType::Export)
-      exports[symbol_info.name].push_back(symbol_info);
+    } else if (spv::LinkageType(type) == spv::LinkageType::Export) {
+      auto result =
+          exports.emplace(symbol_info.name, ExportRecord{symbol_info, 1u});
+      if (!result.second) ++result.first->second.count;
+    }
   }
 
   // Find the import/export pairs
   for (const auto& import : imports) {
-    std::vector<LinkageSymbolInfo> possible_exports;
-    const auto& exp = exports.find(import.name);
-    if (exp != exports.end()) possible_exports = exp->second;
-    if (possible_exports.empty() && !allow_partial_linkage)
-      return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
-             << "Unresolved external reference to \"" << import.name << "\".";
-    else if (possible_exports.size() > 1u)
+    const auto export_iter = exports.find(import.name);
+    if (export_iter == exports.end()) {
+      if (!allow_partial_linkage)
+        return DiagnosticStream(position, consumer, "",
+                                SPV_ERROR_INVALID_BINARY)
+               << "Unresolved external reference to \"" << import.name
+               << "\".";
+      continue;
+    }
+    if (export_iter->second.count > 1u)
       return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
-             << "Too many external references, " << possible_exports.size()
+             << "Too many external references, " << export_iter->second.count
              << ", were found for \"" << import.name << "\".";
 
-    if (!possible_exports.empty())
-      linkings_to_do->emplace_back(import, possible_exports.front());
+    linkings_to_do->emplace_back(import, export_iter->second.symbol);
   }
 
   return SPV_SUCCESS;
@@ -724,9 +775,12 @@ spv_result_t Link(const Context& context, const uint32_t* const* binaries,
     return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
            << "No modules were given.";
 
-  std::vector<std::unique_ptr<IRContext>> ir_contexts;
-  std::vector<Module*> modules;
-  modules.reserve(num_binaries);
+  std::vector<std::unique_ptr<IRContext>> ir_contexts(num_binaries);
+  // Assign each module a disjoint id range up front, based on the id bound
+  // from its header, so that the loader can shift the ids while parsing and
+  // no rewrite pass over the merged ids is needed.
+  std::vector<uint32_t> id_offsets(num_binaries);
+  size_t total_id_bound = 1u;
   for (size_t i = 0u; i < num_binaries; ++i) {
     const uint32_t schema = binaries[i][4u];
     if (schema != 0u) {
@@ -734,21 +788,74 @@ spv_result_t Link(const Context& context, const uint32_t* const* binaries,
       return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
              << "Schema is non-zero for module " << i + 1 << ".";
     }
+    id_offsets[i] = static_cast<uint32_t>(total_id_bound - 1u);
+    total_id_bound += binaries[i][SPV_INDEX_BOUND] - 1u;
+  }
+  if (total_id_bound > std::numeric_limits<uint32_t>::max())
+    return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_DATA)
+           << "Too many IDs (" << total_id_bound
+           << "): combining all modules would overflow the 32-bit word of the "
+              "SPIR-V header.";
+
+  // Parse the input binaries.  Each module gets its own IRContext, so with
+  // more than one thread the modules are built concurrently; messages emitted
+  // while parsing are buffered per module and replayed in input order below,
+  // so diagnostics are identical to a single-threaded link.
+  size_t num_threads = options.GetParallelism();
+  if (num_threads == 0u) num_threads = utils::ThreadPool::DefaultThreadCount();
+  num_threads = std::min(num_threads, num_binaries);
+
+  struct BufferedMessage {
+    spv_message_level_t level;
+    std::string source;
+    spv_position_t position;
+    std::string message;
+  };
+  std::vector<std::vector<BufferedMessage>> buffered_messages(num_binaries);
+  {
+    utils::ThreadPool pool(num_threads);
+    for (size_t i = 0u; i < num_binaries; ++i) {
+      pool.Schedule([&, i] {
+        auto buffering_consumer =
+            [&buffered_messages, i](spv_message_level_t level,
+                                    const char* source,
+                                    const spv_position_t& message_position,
+                                    const char* message) {
+              buffered_messages[i].push_back({level,
+                                              source ? source : "",
+                                              message_position, message});
+            };
+        ir_contexts[i] = BuildModule(c_context->target_env, buffering_consumer,
+                                     binaries[i], binary_sizes[i],
+                                     /* extra_line_tracking = */ true,
+                                     id_offsets[i]);
+      });
+    }
+    pool.Wait();
+  }
 
-    std::unique_ptr<IRContext> ir_context = BuildModule(
-        c_context->target_env, consumer, binaries[i], binary_sizes[i]);
-    if (ir_context == nullptr)
+  std::vector<Module*> modules;
+  modules.reserve(num_binaries);
+  for (size_t i = 0u; i < num_binaries; ++i) {
+    for (const BufferedMessage& message : buffered_messages[i]) {
+      if (consumer) {
+        consumer(message.level, message.source.c_str(), message.position,
+                 message.message.c_str());
+      }
+    }
+    if (ir_contexts[i] == nullptr)
       return DiagnosticStream(position, consumer, "", SPV_ERROR_INVALID_BINARY)
              << "Failed to build module " << i + 1 << " out of " << num_binaries
              << ".";
-    modules.push_back(ir_context->module());
-    ir_contexts.push_back(std::move(ir_context));
+    modules.push_back(ir_contexts[i]->module());
   }
 
-  // Phase 1: Shift the IDs used in each binary so that they occupy a disjoint
-  //          range from the other binaries, and compute the new ID bound.
+  // Phase 1: The loader already shifted each module into its pre-partitioned
+  //          id range; absorb any ids that spilled past a declared range and
+  //          compute the new ID bound.
   uint32_t max_id_bound = 0u;
-  spv_result_t res = ShiftIdsInModules(consumer, &modules, &max_id_bound);
+  spv_result_t res =
+      FixupPartitionedIds(consumer, &modules, id_offsets, &max_id_bound);
   if (res != SPV_SUCCESS) return res;
 
   // Phase 2: Generate the header
@@ -114,8 +114,15 @@ class DivergenceAnalysis : public opt::ForwardDataFlowAnalysis {
     return it->second;
   }
 
+  // Runs the analysis with the fixpoint loop dispatched on the concrete
+  // type: the hook overrides below are |final|, so the per-instruction
+  // transfer calls bind directly instead of going through the vtable. This
+  // shadows the generic DataFlowAnalysis::Run, which remains usable when the
+  // analysis is driven through a base pointer.
+  void Run(opt::Function* function) { RunImpl(this, function); }
+
   void InitializeWorklist(opt::Function* function,
-                          bool is_first_iteration) override {
+                          bool is_first_iteration) final {
     // Since |EnqueueSuccessors| is complete, we only need one pass.
     if (is_first_iteration) {
       Setup(function);
@@ -123,9 +130,9 @@ class DivergenceAnalysis : public opt::ForwardDataFlowAnalysis {
     }
   }
 
-  void EnqueueSuccessors(opt::Instruction* inst) override;
+  void EnqueueSuccessors(opt::Instruction* inst) final;
 
-  VisitResult Visit(opt::Instruction* inst) override;
+  VisitResult Visit(opt::Instruction* inst) final;
 
  private:
   VisitResult VisitBlock(uint32_t id);
@@ -12,9 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "source/diagnostic.h"
 #include "source/lint/divergence_analysis.h"
@@ -26,6 +28,7 @@
 #include "source/opt/dominator_analysis.h"
 #include "source/opt/instruction.h"
 #include "source/opt/ir_context.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 
 namespace spvtools {
@@ -145,10 +148,51 @@ void PrintDivergenceFlow(opt::IRContext* context, DivergenceAnalysis div,
 }  // namespace
 
 bool CheckDivergentDerivatives(opt::IRContext* context) {
-  DivergenceAnalysis div(*context);
+  std::vector<opt::Function*> functions;
   for (opt::Function& func : *context->module()) {
-    div.Run(&func);
-    for (const opt::BasicBlock& bb : func) {
+    functions.push_back(&func);
+  }
+  return CheckDivergentDerivatives(context, functions);
+}
+
+bool CheckDivergentDerivatives(opt::IRContext* context,
+                               const std::vector<opt::Function*>& functions) {
+  // The dataflow is function-local, so the functions are analyzed
+  // concurrently, each with its own DivergenceAnalysis instance.  Warnings
+  // are emitted serially afterwards, in module order, so the output does not
+  // depend on scheduling.
+
+  // The workers only read shared IRContext state, so every lazily built
+  // analysis they query must be materialized before the pool starts.
+  context->BuildInvalidAnalyses(
+      opt::IRContext::kAnalysisDefUse | opt::IRContext::kAnalysisCFG |
+      opt::IRContext::kAnalysisInstrToBlockMapping |
+      opt::IRContext::kAnalysisDecorations | opt::IRContext::kAnalysisTypes);
+  context->get_feature_mgr();
+  for (opt::Function* func : functions) {
+    // Creates the deferred map entry so the workers never mutate the map.
+    // The postdominator tree itself is built by the first dominance query,
+    // which comes from the one worker analyzing |func|.
+    context->GetPostDominatorAnalysis(func);
+  }
+
+  std::vector<DivergenceAnalysis> divs;
+  divs.reserve(functions.size());
+  for (size_t i = 0; i < functions.size(); ++i) {
+    divs.emplace_back(*context);
+  }
+  {
+    utils::ThreadPool pool(std::min(
+        utils::ThreadPool::DefaultThreadCount(), functions.size()));
+    for (size_t i = 0; i < functions.size(); ++i) {
+      pool.Schedule([&functions, &divs, i] { divs[i].Run(functions[i]); });
+    }
+    pool.Wait();
+  }
+
+  for (size_t i = 0; i < functions.size(); ++i) {
+    DivergenceAnalysis& div = divs[i];
+    for (const opt::BasicBlock& bb : *functions[i]) {
       for (const opt::Instruction& inst : bb) {
         if (InstructionHasDerivative(inst) &&
             div.GetDivergenceLevel(bb.id()) >
@@ -14,13 +14,118 @@
 
 #include "spirv-tools/linter.hpp"
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "source/lint/lints.h"
+#include "source/operand.h"
 #include "source/opt/build_module.h"
+#include "source/opt/function.h"
+#include "source/opt/instruction.h"
 #include "source/opt/ir_context.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+uint64_t FnvMix(uint64_t hash, uint32_t word) {
+  return (hash ^ word) * kFnvPrime;
+}
+
+// Hashes functions into a canonical form that is stable across result-id
+// renumbering: ids defined inside a function are replaced by their order of
+// definition, and ids of module-level definitions (types, constants, global
+// variables, callees) are replaced by a hash of their defining instruction.
+// Two functions with equal hashes are identical up to id naming, so lint
+// results computed for one carry over to the other.
+class FunctionHasher {
+ public:
+  explicit FunctionHasher(opt::IRContext* context) : context_(context) {}
+
+  uint64_t Hash(const opt::Function& func) {
+    // Collect the locally defined ids up front, so uses that precede the
+    // definition (e.g. merge block labels) canonicalize the same way as
+    // uses after it.
+    std::unordered_map<uint32_t, uint32_t> local_ordinals;
+    func.ForEachInst([&local_ordinals](const opt::Instruction* inst) {
+      if (inst->result_id() != 0) {
+        local_ordinals.emplace(inst->result_id(),
+                               static_cast<uint32_t>(local_ordinals.size()));
+      }
+    });
+
+    uint64_t hash = kFnvOffsetBasis;
+    func.ForEachInst([this, &hash, &local_ordinals](
+                         const opt::Instruction* inst) {
+      hash = FnvMix(hash, static_cast<uint32_t>(inst->opcode()));
+      for (auto op = inst->begin(); op != inst->end(); ++op) {
+        hash = FnvMix(hash, static_cast<uint32_t>(op->type));
+        if (spvIsIdType(op->type)) {
+          const uint32_t id = op->words[0];
+          auto local = local_ordinals.find(id);
+          if (local != local_ordinals.end()) {
+            hash = FnvMix(hash, local->second);
+          } else {
+            const uint64_t global = HashGlobalId(id);
+            hash = FnvMix(hash, static_cast<uint32_t>(global));
+            hash = FnvMix(hash, static_cast<uint32_t>(global >> 32));
+          }
+        } else {
+          for (uint32_t word : op->words) hash = FnvMix(hash, word);
+        }
+      }
+    });
+    return hash;
+  }
+
+ private:
+  // Hashes the module-level definition of |id| by its defining instruction,
+  // recursing into id operands so that, for example, two pointer types hash
+  // equal exactly when their pointee types do.  Memoized across functions.
+  uint64_t HashGlobalId(uint32_t id) {
+    auto it = global_hashes_.find(id);
+    if (it != global_hashes_.end()) return it->second;
+    if (!in_progress_.insert(id).second) {
+      // A cycle through OpTypeForwardPointer: the back edge hashes as a
+      // fixed marker.
+      return kFnvOffsetBasis;
+    }
+    uint64_t hash = kFnvOffsetBasis;
+    const opt::Instruction* def = context_->get_def_use_mgr()->GetDef(id);
+    if (def != nullptr) {
+      hash = FnvMix(hash, static_cast<uint32_t>(def->opcode()));
+      for (auto op = def->begin(); op != def->end(); ++op) {
+        if (op->type == SPV_OPERAND_TYPE_RESULT_ID) continue;
+        hash = FnvMix(hash, static_cast<uint32_t>(op->type));
+        if (spvIsIdType(op->type)) {
+          const uint64_t sub = HashGlobalId(op->words[0]);
+          hash = FnvMix(hash, static_cast<uint32_t>(sub));
+          hash = FnvMix(hash, static_cast<uint32_t>(sub >> 32));
+        } else {
+          for (uint32_t word : op->words) hash = FnvMix(hash, word);
+        }
+      }
+    }
+    in_progress_.erase(id);
+    global_hashes_[id] = hash;
+    return hash;
+  }
+
+  opt::IRContext* context_;
+  std::unordered_map<uint32_t, uint64_t> global_hashes_;
+  std::unordered_set<uint32_t> in_progress_;
+};
+
+}  // namespace
 
 struct Linter::Impl {
   explicit Impl(spv_target_env env) : target_env(env) {
@@ -56,4 +161,94 @@ bool Linter::Run(const uint32_t* binary, size_t binary_size) {
   return result;
 }
 
+bool Linter::RunIncremental(const uint32_t* prev_binary,
+                            size_t prev_binary_size, const uint32_t* binary,
+                            size_t binary_size) {
+  std::unique_ptr<opt::IRContext> prev_context = BuildModule(
+      SPV_ENV_VULKAN_1_2, Consumer(), prev_binary, prev_binary_size);
+  // Without a usable previous module there is nothing to carry over.
+  if (prev_context == nullptr) return Run(binary, binary_size);
+
+  std::unique_ptr<opt::IRContext> context =
+      BuildModule(SPV_ENV_VULKAN_1_2, Consumer(), binary, binary_size);
+  if (context == nullptr) return false;
+
+  std::unordered_set<uint64_t> prev_hashes;
+  {
+    FunctionHasher prev_hasher(prev_context.get());
+    for (opt::Function& func : *prev_context->module()) {
+      prev_hashes.insert(prev_hasher.Hash(func));
+    }
+  }
+
+  // A function whose canonical hash already occurs in the previous module is
+  // unchanged up to id naming; its previous lint results stand and it is not
+  // re-analyzed.
+  std::vector<opt::Function*> changed;
+  FunctionHasher hasher(context.get());
+  for (opt::Function& func : *context->module()) {
+    if (prev_hashes.count(hasher.Hash(func)) == 0) {
+      changed.push_back(&func);
+    }
+  }
+  if (changed.empty()) return true;
+
+  bool result = true;
+  result &= lint::lints::CheckDivergentDerivatives(context.get(), changed);
+
+  return result;
+}
+
+bool Linter::RunBatch(const std::vector<std::vector<uint32_t>>& binaries,
+                      size_t num_threads) {
+  // A worker's messages are buffered here and replayed to the registered
+  // consumer once all workers are done, so the output is grouped per module
+  // and ordered like |binaries| regardless of scheduling.
+  struct Message {
+    spv_message_level_t level;
+    std::string source;
+    spv_position_t position;
+    std::string text;
+  };
+  struct ModuleResult {
+    bool passed = false;
+    std::vector<Message> messages;
+  };
+  std::vector<ModuleResult> results(binaries.size());
+
+  if (num_threads == 0) num_threads = utils::ThreadPool::DefaultThreadCount();
+  {
+    utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < binaries.size(); ++i) {
+      pool.Schedule([this, &binaries, &results, i] {
+        // Each worker lints through its own Linter so its messages land in
+        // its own buffer; the grammar tables behind it are process-wide
+        // statics shared read-only by every worker.
+        Linter linter(impl_->target_env);
+        linter.SetMessageConsumer(
+            [&results, i](spv_message_level_t level, const char* source,
+                          const spv_position_t& position,
+                          const char* message) {
+              results[i].messages.push_back({level, source ? source : "",
+                                             position,
+                                             message ? message : ""});
+            });
+        results[i].passed =
+            linter.Run(binaries[i].data(), binaries[i].size());
+      });
+    }
+    pool.Wait();
+  }
+
+  bool all_passed = true;
+  for (const ModuleResult& result : results) {
+    for (const Message& message : result.messages) {
+      Consumer()(message.level, message.source.c_str(), message.position,
+                 message.text.c_str());
+    }
+    all_passed = all_passed && result.passed;
+  }
+  return all_passed;
+}
+
 }  // namespace spvtools
@@ -15,6 +15,9 @@
 #ifndef SOURCE_LINT_LINTS_H_
 #define SOURCE_LINT_LINTS_H_
 
+#include <vector>
+
+#include "source/opt/function.h"
 #include "source/opt/ir_context.h"
 
 namespace spvtools {
@@ -27,6 +30,12 @@ namespace lints {
 
 bool CheckDivergentDerivatives(opt::IRContext* context);
 
+// Same as above, but analyzes only the given |functions|, which must belong
+// to |context|.  Used by the incremental linting path to re-lint just the
+// functions that changed since the last run.
+bool CheckDivergentDerivatives(opt::IRContext* context,
+                               const std::vector<opt::Function*>& functions);
+
 }  // namespace lints
 }  // namespace lint
 }  // namespace spvtools
@@ -67,15 +67,16 @@ std::string FriendlyNameMapper::NameForId(uint32_t id) {
 
 std::string FriendlyNameMapper::Sanitize(const std::string& suggested_name) {
   if (suggested_name.empty()) return "_";
-  // Otherwise, replace invalid characters by '_'.
+  // Otherwise, replace invalid characters by '_'.  Valid characters are
+  // ASCII letters, digits, and underscore; testing them directly avoids a
+  // linear scan of an alphabet string per character.
   std::string result;
-  std::string valid =
-      "abcdefghijklmnopqrstuvwxyz"
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-      "_0123456789";
   std::transform(suggested_name.begin(), suggested_name.end(),
-                 std::back_inserter(result), [&valid](const char c) {
-                   return (std::string::npos == valid.find(c)) ? '_' : c;
+                 std::back_inserter(result), [](const char c) {
+                   const bool valid =
+                       ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+                       ('0' <= c && c <= '9') || c == '_';
+                   return valid ? c : '_';
                  });
   return result;
 }
@@ -89,7 +90,11 @@ void FriendlyNameMapper::SaveName(uint32_t id,
   auto inserted = used_names_.insert(name);
   if (!inserted.second) {
     const std::string base_name = sanitized_suggested_name + "_";
-    for (uint32_t index = 0; !inserted.second; ++index) {
+    // Resume from the next unused numeric suffix for this base name rather
+    // than retrying from zero each time; ids that share a popular base name
+    // would otherwise make collision resolution quadratic.
+    uint32_t& index = next_suffix_for_name_[base_name];
+    for (; !inserted.second; ++index) {
       name = base_name + to_string(index);
       inserted = used_names_.insert(name);
     }
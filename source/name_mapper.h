@@ -113,6 +113,10 @@ class FriendlyNameMapper {
   std::unordered_map<uint32_t, std::string> name_for_id_;
   // The set of names that have a mapping in name_for_id_;
   std::unordered_set<std::string> used_names_;
+  // For each base name that has collided, the next numeric suffix to try.
+  // This makes resolving each collision amortized constant time instead of
+  // rescanning suffixes from zero.
+  std::unordered_map<std::string, uint32_t> next_suffix_for_name_;
   // The assembly grammar for the current context.
   const AssemblyGrammar grammar_;
 };
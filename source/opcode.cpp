@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <vector>
 
 #include "source/instruction.h"
 #include "source/macro.h"
@@ -52,6 +53,131 @@ const VendorTool vendor_tools[] = {
 #include "generators.inc"
 };
 
+// Hash-based index over kOpcodeTable, built once on first use.  The grammar
+// tables are fixed when this library is built, so one index serves every
+// lookup; building it lazily keeps the cost off of process startup for tools
+// that never look opcodes up by name.  Hashing is FNV-1a, as elsewhere in
+// this code base.
+class OpcodeTableIndex {
+ public:
+  static const OpcodeTableIndex& Get() {
+    static const OpcodeTableIndex index;
+    return index;
+  }
+
+  // Returns the index of the first table entry whose name consists of the
+  // |name_length| characters at |name|, or -1 when no entry has that name.
+  // Later entries with the same name are reached via NextWithSameName.
+  int32_t FirstWithName(const char* name, size_t name_length) const {
+    const size_t mask = name_slots_.size() - 1;
+    for (size_t slot = HashName(name, name_length) & mask;;
+         slot = (slot + 1) & mask) {
+      const int32_t entry = name_slots_[slot] - 1;
+      if (entry < 0) return -1;
+      const char* entry_name = kOpcodeTable.entries[entry].name;
+      if (!strncmp(entry_name, name, name_length) &&
+          entry_name[name_length] == '\0') {
+        return entry;
+      }
+    }
+  }
+
+  // Returns the index of the next table entry with the same name as |entry|,
+  // or -1 when |entry| is the last one.
+  int32_t NextWithSameName(int32_t entry) const {
+    return next_with_name_[entry];
+  }
+
+  // Returns the index of the first table entry with the given opcode value,
+  // or -1 when no entry has that value.  Entries sharing a value are
+  // contiguous in the table, so callers can walk forward from the result.
+  int32_t FirstWithValue(uint32_t value) const {
+    const size_t mask = value_slots_.size() - 1;
+    for (size_t slot = HashValue(value) & mask;; slot = (slot + 1) & mask) {
+      const int32_t entry = value_slots_[slot] - 1;
+      if (entry < 0) return -1;
+      if (static_cast<uint32_t>(kOpcodeTable.entries[entry].opcode) == value) {
+        return entry;
+      }
+    }
+  }
+
+ private:
+  OpcodeTableIndex() {
+    // Size the tables to a power of two with at most 50% occupancy.
+    size_t slot_count = 2;
+    while (slot_count < kOpcodeTable.count * 2) slot_count *= 2;
+    name_slots_.resize(slot_count, 0);
+    value_slots_.resize(slot_count, 0);
+    next_with_name_.resize(kOpcodeTable.count, -1);
+    for (uint32_t i = 0; i < kOpcodeTable.count; ++i) {
+      const spv_opcode_desc_t& entry = kOpcodeTable.entries[i];
+      InsertName(entry.name, static_cast<int32_t>(i));
+      // The table is sorted by opcode value, so only the first entry of a
+      // run of duplicates goes into the value index.
+      if (i == 0 || kOpcodeTable.entries[i - 1].opcode != entry.opcode) {
+        InsertValue(static_cast<uint32_t>(entry.opcode),
+                    static_cast<int32_t>(i));
+      }
+    }
+  }
+
+  void InsertName(const char* name, int32_t entry) {
+    const size_t mask = name_slots_.size() - 1;
+    for (size_t slot = HashName(name, strlen(name)) & mask;;
+         slot = (slot + 1) & mask) {
+      int32_t head = name_slots_[slot] - 1;
+      if (head < 0) {
+        name_slots_[slot] = entry + 1;
+        return;
+      }
+      if (!strcmp(kOpcodeTable.entries[head].name, name)) {
+        // A later entry with the same name: append it to the chain, so that
+        // lookups see entries in table order.
+        while (next_with_name_[head] >= 0) head = next_with_name_[head];
+        next_with_name_[head] = entry;
+        return;
+      }
+    }
+  }
+
+  void InsertValue(uint32_t value, int32_t entry) {
+    const size_t mask = value_slots_.size() - 1;
+    for (size_t slot = HashValue(value) & mask;; slot = (slot + 1) & mask) {
+      if (value_slots_[slot] == 0) {
+        value_slots_[slot] = entry + 1;
+        return;
+      }
+    }
+  }
+
+  static uint64_t HashName(const char* name, size_t name_length) {
+    uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+    for (size_t i = 0; i < name_length; ++i) {
+      hash ^= static_cast<uint8_t>(name[i]);
+      hash *= 0x100000001b3ull;  // FNV-1a prime.
+    }
+    return hash;
+  }
+
+  static uint64_t HashValue(uint32_t value) {
+    uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+    for (int i = 0; i < 4; ++i) {
+      hash ^= (value >> (8 * i)) & 0xffu;
+      hash *= 0x100000001b3ull;  // FNV-1a prime.
+    }
+    return hash;
+  }
+
+  // Entry index plus one of the head of each name chain; 0 is an empty slot.
+  std::vector<int32_t> name_slots_;
+  // For each entry, the next entry with the same name, or -1.
+  std::vector<int32_t> next_with_name_;
+  // Entry index plus one of the first entry with each opcode value; 0 is an
+  // empty slot.
+  std::vector<int32_t> value_slots_;
+};
+
 }  // anonymous namespace
 
 // TODO(dneto): Move this to another file.  It doesn't belong with opcode
@@ -95,12 +221,30 @@ spv_result_t spvOpcodeTableNameLookup(spv_target_env env,
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
   if (!table) return SPV_ERROR_INVALID_TABLE;
 
-  // TODO: This lookup of the Opcode table is suboptimal! Binary sort would be
-  // preferable but the table requires sorting on the Opcode name, but it's
-  // static const initialized and matches the order of the spec.
+  // The table is ordered by opcode value, not by name, so a hash index over
+  // the names stands in for the sorted order a binary search would need.
   const size_t nameLength = strlen(name);
   const auto version = spvVersionForTargetEnv(env);
-  for (uint64_t opcodeIndex = 0; opcodeIndex < table->count; ++opcodeIndex) {
+  if (table != &kOpcodeTable) {
+    // A subsetted table re-packs its entries, so the index built over the
+    // full table does not apply to it; the subset is small enough to scan.
+    for (uint32_t i = 0; i < table->count; ++i) {
+      const spv_opcode_desc_t& entry = table->entries[i];
+      if (strncmp(entry.name, name, nameLength) ||
+          entry.name[nameLength] != '\0') {
+        continue;
+      }
+      if ((version >= entry.minVersion && version <= entry.lastVersion) ||
+          entry.numExtensions > 0u || entry.numCapabilities > 0u) {
+        *pEntry = &entry;
+        return SPV_SUCCESS;
+      }
+    }
+    return SPV_ERROR_INVALID_LOOKUP;
+  }
+  const OpcodeTableIndex& index = OpcodeTableIndex::Get();
+  for (int32_t opcodeIndex = index.FirstWithName(name, nameLength);
+       opcodeIndex >= 0; opcodeIndex = index.NextWithSameName(opcodeIndex)) {
     const spv_opcode_desc_t& entry = table->entries[opcodeIndex];
     // We considers the current opcode as available as long as
     // 1. The target environment satisfies the minimal requirement of the
@@ -110,10 +254,8 @@ spv_result_t spvOpcodeTableNameLookup(spv_target_env env,
     // Note that the second rule assumes the extension enabling this instruction
     // is indeed requested in the SPIR-V code; checking that should be
     // validator's work.
-    if (((version >= entry.minVersion && version <= entry.lastVersion) ||
-         entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
-        nameLength == strlen(entry.name) &&
-        !strncmp(name, entry.name, nameLength)) {
+    if ((version >= entry.minVersion && version <= entry.lastVersion) ||
+        entry.numExtensions > 0u || entry.numCapabilities > 0u) {
       // NOTE: Found out Opcode!
       *pEntry = &entry;
       return SPV_SUCCESS;
@@ -130,24 +272,40 @@ spv_result_t spvOpcodeTableValueLookup(spv_target_env env,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
-  const auto beg = table->entries;
   const auto end = table->entries + table->count;
 
-  spv_opcode_desc_t needle = {"",    opcode, 0, nullptr, 0,   {},
-                              false, false,  0, nullptr, ~0u, ~0u};
+  if (table != &kOpcodeTable) {
+    // A subsetted table keeps the sort by opcode value but re-packs entry
+    // positions, so the index built over the full table does not apply to
+    // it; binary-search the subset directly.
+    const auto version = spvVersionForTargetEnv(env);
+    auto it = std::lower_bound(
+        table->entries, end, opcode,
+        [](const spv_opcode_desc_t& entry, const spv::Op value) {
+          return entry.opcode < value;
+        });
+    for (; it != end && it->opcode == opcode; ++it) {
+      if ((version >= it->minVersion && version <= it->lastVersion) ||
+          it->numExtensions > 0u || it->numCapabilities > 0u) {
+        *pEntry = it;
+        return SPV_SUCCESS;
+      }
+    }
+    return SPV_ERROR_INVALID_LOOKUP;
+  }
 
-  auto comp = [](const spv_opcode_desc_t& lhs, const spv_opcode_desc_t& rhs) {
-    return lhs.opcode < rhs.opcode;
-  };
+  const int32_t first =
+      OpcodeTableIndex::Get().FirstWithValue(static_cast<uint32_t>(opcode));
+  if (first < 0) return SPV_ERROR_INVALID_LOOKUP;
 
   // We need to loop here because there can exist multiple symbols for the same
   // opcode value, and they can be introduced in different target environments,
   // which means they can have different minimal version requirements.
   // Assumes the underlying table is already sorted ascendingly according to
-  // opcode value.
+  // opcode value, so all such symbols follow the first one directly.
   const auto version = spvVersionForTargetEnv(env);
-  for (auto it = std::lower_bound(beg, end, needle, comp);
-       it != end && it->opcode == opcode; ++it) {
+  for (auto it = table->entries + first; it != end && it->opcode == opcode;
+       ++it) {
     // We considers the current opcode as available as long as
     // 1. The target environment satisfies the minimal requirement of the
     //    opcode; or
@@ -20,6 +20,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "DebugInfo.h"
 #include "OpenCLDebugInfo100.h"
@@ -40,6 +41,196 @@ static const spv_operand_table_t kOperandTable = {
     ARRAY_SIZE(pygen_variable_OperandInfoTable),
     pygen_variable_OperandInfoTable};
 
+namespace {
+
+// Indexes over kOperandTable, one per operand-type group, built once on
+// first use.  The grammar tables are fixed when this library is built, so
+// one set of indexes serves every lookup; building them lazily keeps the
+// cost off of process startup.
+//
+// The operand type resolves to its group through a dense array indexed by
+// the type enum.  Values resolve through a dense array over the group's
+// value range when that range is compact (most enum kinds count up from
+// zero), and otherwise - bitmask kinds, whose values spread exponentially -
+// through a hash table.  Names always resolve through a hash table, FNV-1a
+// as elsewhere in this code base.
+class OperandTableIndex {
+ public:
+  static const OperandTableIndex& Get() {
+    static const OperandTableIndex index;
+    return index;
+  }
+
+  // Returns the index within kOperandTable.types of the group holding the
+  // entries of the given operand |type|, or -1 when no group does.
+  int32_t GroupForType(spv_operand_type_t type) const {
+    const size_t index = static_cast<size_t>(type);
+    if (index >= group_of_type_.size()) return -1;
+    return group_of_type_[index];
+  }
+
+  // Returns the index within group |type_index| of the first entry whose
+  // name consists of the |name_length| characters at |name|, or -1 when the
+  // group has no entry with that name.
+  int32_t FirstWithName(uint64_t type_index, const char* name,
+                        size_t name_length) const {
+    const std::vector<int32_t>& slots = groups_[type_index].name_slots;
+    const size_t mask = slots.size() - 1;
+    const auto& group = kOperandTable.types[type_index];
+    for (size_t slot = HashName(name, name_length) & mask;;
+         slot = (slot + 1) & mask) {
+      const int32_t entry = slots[slot] - 1;
+      if (entry < 0) return -1;
+      const char* entry_name = group.entries[entry].name;
+      if (!strncmp(entry_name, name, name_length) &&
+          entry_name[name_length] == '\0') {
+        return entry;
+      }
+    }
+  }
+
+  // Returns the index within group |type_index| of the first entry with the
+  // given value, or -1 when the group has no entry with that value.  Entries
+  // sharing a value are contiguous, so callers can walk forward from the
+  // result.
+  int32_t FirstWithValue(uint64_t type_index, uint32_t value) const {
+    const GroupIndex& group_index = groups_[type_index];
+    if (!group_index.dense_value_slots.empty()) {
+      // The subtraction wraps for values below the base, making the offset
+      // fall out of range.
+      const uint32_t offset = value - group_index.dense_value_base;
+      if (offset >= group_index.dense_value_slots.size()) return -1;
+      return group_index.dense_value_slots[offset] - 1;
+    }
+    const std::vector<int32_t>& slots = group_index.value_slots;
+    const size_t mask = slots.size() - 1;
+    const auto& group = kOperandTable.types[type_index];
+    for (size_t slot = HashValue(value) & mask;; slot = (slot + 1) & mask) {
+      const int32_t entry = slots[slot] - 1;
+      if (entry < 0) return -1;
+      if (group.entries[entry].value == value) return entry;
+    }
+  }
+
+ private:
+  // Entry index plus one of the first entry with each name or value; 0 is an
+  // empty slot.  Only the first entry of a run of duplicates is recorded,
+  // matching the linear scans these indexes replace.  A group gets either
+  // the dense value array or the value hash table, never both.
+  struct GroupIndex {
+    std::vector<int32_t> name_slots;
+    std::vector<int32_t> value_slots;
+    std::vector<int32_t> dense_value_slots;
+    uint32_t dense_value_base = 0;
+  };
+
+  OperandTableIndex()
+      : groups_(kOperandTable.count),
+        group_of_type_(SPV_OPERAND_TYPE_NUM_OPERAND_TYPES, -1) {
+    for (uint64_t type_index = 0; type_index < kOperandTable.count;
+         ++type_index) {
+      const auto& group = kOperandTable.types[type_index];
+      const size_t type = static_cast<size_t>(group.type);
+      if (type < group_of_type_.size()) {
+        group_of_type_[type] = static_cast<int32_t>(type_index);
+      }
+      // Size each hash table to a power of two with at most 50% occupancy.
+      size_t slot_count = 2;
+      while (slot_count < group.count * 2) slot_count *= 2;
+      GroupIndex& group_index = groups_[type_index];
+      group_index.name_slots.resize(slot_count, 0);
+      if (group.count == 0) {
+        group_index.value_slots.resize(slot_count, 0);
+        continue;
+      }
+      // Each group is sorted by value, so its value range is delimited by
+      // its first and last entries.  Use the dense array when that range is
+      // compact; bitmask kinds fail this test and fall back to hashing.
+      const uint32_t min_value = group.entries[0].value;
+      const uint32_t max_value = group.entries[group.count - 1].value;
+      const uint64_t span = static_cast<uint64_t>(max_value) - min_value + 1;
+      const bool dense = span <= 2 * static_cast<uint64_t>(group.count) + 64;
+      if (dense) {
+        group_index.dense_value_base = min_value;
+        group_index.dense_value_slots.resize(static_cast<size_t>(span), 0);
+      } else {
+        group_index.value_slots.resize(slot_count, 0);
+      }
+      for (uint32_t i = 0; i < group.count; ++i) {
+        const spv_operand_desc_t& entry = group.entries[i];
+        InsertName(&group_index, group, entry.name, static_cast<int32_t>(i));
+        // Only the first entry of a run of duplicate values goes into the
+        // value index.
+        if (i == 0 || group.entries[i - 1].value != entry.value) {
+          if (dense) {
+            group_index.dense_value_slots[entry.value - min_value] =
+                static_cast<int32_t>(i) + 1;
+          } else {
+            InsertValue(&group_index, entry.value, static_cast<int32_t>(i));
+          }
+        }
+      }
+    }
+  }
+
+  static void InsertName(GroupIndex* group_index,
+                         const spv_operand_desc_group_t& group,
+                         const char* name, int32_t entry) {
+    std::vector<int32_t>& slots = group_index->name_slots;
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = HashName(name, strlen(name)) & mask;;
+         slot = (slot + 1) & mask) {
+      const int32_t head = slots[slot] - 1;
+      if (head < 0) {
+        slots[slot] = entry + 1;
+        return;
+      }
+      // A later entry with a name already in the index is unreachable by
+      // name, just as it was for the linear scan; leave the first one.
+      if (!strcmp(group.entries[head].name, name)) return;
+    }
+  }
+
+  static void InsertValue(GroupIndex* group_index, uint32_t value,
+                          int32_t entry) {
+    std::vector<int32_t>& slots = group_index->value_slots;
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = HashValue(value) & mask;; slot = (slot + 1) & mask) {
+      if (slots[slot] == 0) {
+        slots[slot] = entry + 1;
+        return;
+      }
+    }
+  }
+
+  static uint64_t HashName(const char* name, size_t name_length) {
+    uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+    for (size_t i = 0; i < name_length; ++i) {
+      hash ^= static_cast<uint8_t>(name[i]);
+      hash *= 0x100000001b3ull;  // FNV-1a prime.
+    }
+    return hash;
+  }
+
+  static uint64_t HashValue(uint32_t value) {
+    uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a offset basis.
+    for (int i = 0; i < 4; ++i) {
+      hash ^= (value >> (8 * i)) & 0xffu;
+      hash *= 0x100000001b3ull;  // FNV-1a prime.
+    }
+    return hash;
+  }
+
+  // One index per entry of kOperandTable.types, in table order.
+  std::vector<GroupIndex> groups_;
+
+  // The group index for each operand type, or -1 when the table has no
+  // group for that type.  Indexed directly by spv_operand_type_t.
+  std::vector<int32_t> group_of_type_;
+};
+
+}  // anonymous namespace
+
 spv_result_t spvOperandTableGet(spv_operand_table* pOperandTable,
                                 spv_target_env) {
   if (!pOperandTable) return SPV_ERROR_INVALID_POINTER;
@@ -58,10 +249,38 @@ spv_result_t spvOperandTableNameLookup(spv_target_env env,
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
 
   const auto version = spvVersionForTargetEnv(env);
-  for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+  if (table != &kOperandTable) {
+    // A subsetted table re-packs its groups and entries, so the index built
+    // over the full table does not apply to it; the subset is small enough
+    // to scan.
+    for (uint32_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+      const auto& group = table->types[typeIndex];
+      if (group.type != type) continue;
+      for (uint32_t index = 0; index < group.count; ++index) {
+        const auto& entry = group.entries[index];
+        if (strncmp(entry.name, name, nameLength) ||
+            entry.name[nameLength] != '\0') {
+          continue;
+        }
+        if ((version >= entry.minVersion && version <= entry.lastVersion) ||
+            entry.numExtensions > 0u || entry.numCapabilities > 0u) {
+          *pEntry = &entry;
+          return SPV_SUCCESS;
+        }
+        // if there is no extension/capability then the version is wrong
+        return SPV_ERROR_WRONG_VERSION;
+      }
+      break;
+    }
+    return SPV_ERROR_INVALID_LOOKUP;
+  }
+  const OperandTableIndex& table_index = OperandTableIndex::Get();
+  const int32_t typeIndex = table_index.GroupForType(type);
+  if (typeIndex >= 0) {
     const auto& group = table->types[typeIndex];
-    if (type != group.type) continue;
-    for (uint64_t index = 0; index < group.count; ++index) {
+    const int32_t index = table_index.FirstWithName(typeIndex, name,
+                                                    nameLength);
+    if (index >= 0) {
       const auto& entry = group.entries[index];
       // We consider the current operand as available as long as
       // 1. The target environment satisfies the minimal requirement of the
@@ -72,16 +291,13 @@ spv_result_t spvOperandTableNameLookup(spv_target_env env,
       // Note that the second rule assumes the extension enabling this operand
       // is indeed requested in the SPIR-V code; checking that should be
       // validator's work.
-      if (nameLength == strlen(entry.name) &&
-          !strncmp(entry.name, name, nameLength)) {
-        if ((version >= entry.minVersion && version <= entry.lastVersion) ||
-            entry.numExtensions > 0u || entry.numCapabilities > 0u) {
-          *pEntry = &entry;
-          return SPV_SUCCESS;
-        } else {
-          // if there is no extension/capability then the version is wrong
-          return SPV_ERROR_WRONG_VERSION;
-        }
+      if ((version >= entry.minVersion && version <= entry.lastVersion) ||
+          entry.numExtensions > 0u || entry.numCapabilities > 0u) {
+        *pEntry = &entry;
+        return SPV_SUCCESS;
+      } else {
+        // if there is no extension/capability then the version is wrong
+        return SPV_ERROR_WRONG_VERSION;
       }
     }
   }
@@ -97,19 +313,42 @@ spv_result_t spvOperandTableValueLookup(spv_target_env env,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
-  spv_operand_desc_t needle = {"", value, 0, nullptr, 0, nullptr, {}, ~0u, ~0u};
-
-  auto comp = [](const spv_operand_desc_t& lhs, const spv_operand_desc_t& rhs) {
-    return lhs.value < rhs.value;
-  };
+  if (table != &kOperandTable) {
+    // A subsetted table keeps each group's sort by value but re-packs group
+    // and entry positions, so the index built over the full table does not
+    // apply to it; find the group by scanning and binary-search its entries.
+    const auto version = spvVersionForTargetEnv(env);
+    for (uint32_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+      const auto& group = table->types[typeIndex];
+      if (group.type != type) continue;
+      const auto end = group.entries + group.count;
+      auto it = std::lower_bound(
+          group.entries, end, value,
+          [](const spv_operand_desc_t& entry, const uint32_t target) {
+            return entry.value < target;
+          });
+      for (; it != end && it->value == value; ++it) {
+        if ((version >= it->minVersion && version <= it->lastVersion) ||
+            it->numExtensions > 0u || it->numCapabilities > 0u) {
+          *pEntry = it;
+          return SPV_SUCCESS;
+        }
+      }
+      break;
+    }
+    return SPV_ERROR_INVALID_LOOKUP;
+  }
 
-  for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+  const OperandTableIndex& table_index = OperandTableIndex::Get();
+  const int32_t typeIndex = table_index.GroupForType(type);
+  if (typeIndex >= 0) {
     const auto& group = table->types[typeIndex];
-    if (type != group.type) continue;
 
-    const auto beg = group.entries;
     const auto end = group.entries + group.count;
 
+    const int32_t first = table_index.FirstWithValue(typeIndex, value);
+    if (first < 0) return SPV_ERROR_INVALID_LOOKUP;
+
     // We need to loop here because there can exist multiple symbols for the
     // same operand value, and they can be introduced in different target
     // environments, which means they can have different minimal version
@@ -119,10 +358,10 @@ spv_result_t spvOperandTableValueLookup(spv_target_env env,
     // value as SubgroupEqMaskKHR, is available in core SPIR-V without extension
     // requirements.
     // Assumes the underlying table is already sorted ascendingly according to
-    // opcode value.
+    // opcode value, so all such symbols follow the first one directly.
     const auto version = spvVersionForTargetEnv(env);
-    for (auto it = std::lower_bound(beg, end, needle, comp);
-         it != end && it->value == value; ++it) {
+    for (auto it = group.entries + first; it != end && it->value == value;
+         ++it) {
       // We consider the current operand as available as long as
       // 1. The target environment satisfies the minimal requirement of the
       //    operand; or
@@ -483,34 +722,6 @@ spv_operand_pattern_t spvAlternatePatternFollowingImmediate(
   return {SPV_OPERAND_TYPE_OPTIONAL_CIV};
 }
 
-bool spvIsIdType(spv_operand_type_t type) {
-  switch (type) {
-    case SPV_OPERAND_TYPE_ID:
-    case SPV_OPERAND_TYPE_TYPE_ID:
-    case SPV_OPERAND_TYPE_RESULT_ID:
-    case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
-    case SPV_OPERAND_TYPE_SCOPE_ID:
-      return true;
-    default:
-      return false;
-  }
-}
-
-bool spvIsInIdType(spv_operand_type_t type) {
-  if (!spvIsIdType(type)) {
-    // If it is not an ID it cannot be an input ID.
-    return false;
-  }
-  switch (type) {
-    // Deny non-input IDs.
-    case SPV_OPERAND_TYPE_TYPE_ID:
-    case SPV_OPERAND_TYPE_RESULT_ID:
-      return false;
-    default:
-      return true;
-  }
-}
-
 std::function<bool(unsigned)> spvOperandCanBeForwardDeclaredFunction(
     spv::Op opcode) {
   std::function<bool(unsigned index)> out;
@@ -128,11 +128,33 @@ spv_operand_type_t spvTakeFirstMatchableOperand(spv_operand_pattern_t* pattern);
 spv_operand_pattern_t spvAlternatePatternFollowingImmediate(
     const spv_operand_pattern_t& pattern);
 
-// Is the operand an ID?
-bool spvIsIdType(spv_operand_type_t type);
+// Is the operand an ID?  Defined inline: this predicate sits in the inner
+// loop of every id walk over a module, so it must compile down to a bit of
+// arithmetic at the call site rather than a function call.
+inline bool spvIsIdType(spv_operand_type_t type) {
+  switch (type) {
+    case SPV_OPERAND_TYPE_ID:
+    case SPV_OPERAND_TYPE_TYPE_ID:
+    case SPV_OPERAND_TYPE_RESULT_ID:
+    case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
+    case SPV_OPERAND_TYPE_SCOPE_ID:
+      return true;
+    default:
+      return false;
+  }
+}
 
 // Is the operand an input ID?
-bool spvIsInIdType(spv_operand_type_t type);
+inline bool spvIsInIdType(spv_operand_type_t type) {
+  switch (type) {
+    case SPV_OPERAND_TYPE_ID:
+    case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
+    case SPV_OPERAND_TYPE_SCOPE_ID:
+      return true;
+    default:
+      return false;
+  }
+}
 
 // Takes the opcode of an instruction and returns
 // a function object that will return true if the index
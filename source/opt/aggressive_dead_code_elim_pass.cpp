@@ -186,12 +186,11 @@ bool AggressiveDCEPass::IsTargetDead(Instruction* inst) {
 void AggressiveDCEPass::ProcessLoad(Function* func, uint32_t varId) {
   // Only process locals
   if (!IsLocalVar(varId, func)) return;
-  // Return if already processed
-  if (live_local_vars_.find(varId) != live_local_vars_.end()) return;
+  // Return if already processed, otherwise cache varId as processed
+  if (live_local_vars_.Set(varId)) return;
+  live_local_var_ids_.push_back(varId);
   // Mark all stores to varId as live
   AddStores(func, varId);
-  // Cache varId as processed
-  live_local_vars_.insert(varId);
 }
 
 void AggressiveDCEPass::AddBranch(uint32_t labelId, BasicBlock* bp) {
@@ -264,7 +263,10 @@ void AggressiveDCEPass::AddBreaksAndContinuesToWorklist(
 bool AggressiveDCEPass::AggressiveDCE(Function* func) {
   std::list<BasicBlock*> structured_order;
   cfg()->ComputeStructuredOrder(func, &*func->begin(), &structured_order);
-  live_local_vars_.clear();
+  for (uint32_t varId : live_local_var_ids_) {
+    live_local_vars_.Clear(varId);
+  }
+  live_local_var_ids_.clear();
   InitializeWorkList(func, structured_order);
   ProcessWorkList(func);
   return KillDeadInstructions(func, structured_order);
@@ -327,15 +329,18 @@ bool AggressiveDCEPass::KillDeadInstructions(
 }
 
 void AggressiveDCEPass::ProcessWorkList(Function* func) {
-  while (!worklist_.empty()) {
-    Instruction* live_inst = worklist_.front();
-    worklist_.pop();
+  while (worklist_next_ < worklist_.size()) {
+    Instruction* live_inst = worklist_[worklist_next_++];
     AddOperandsToWorkList(live_inst);
     MarkBlockAsLive(live_inst);
     MarkLoadedVariablesAsLive(func, live_inst);
     AddDecorationsToWorkList(live_inst);
     AddDebugInstructionsToWorkList(live_inst);
   }
+  // The worklist has been fully consumed; recycle its storage for the next
+  // function.
+  worklist_.clear();
+  worklist_next_ = 0;
 }
 
 void AggressiveDCEPass::AddDebugScopeToWorkList(const Instruction* inst) {
@@ -20,7 +20,6 @@
 #include <algorithm>
 #include <list>
 #include <map>
-#include <queue>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -91,7 +90,7 @@ class AggressiveDCEPass : public MemPass {
   // Add |inst| to worklist_ and live_insts_.
   void AddToWorklist(Instruction* inst) {
     if (!live_insts_.Set(inst->unique_id())) {
-      worklist_.push(inst);
+      worklist_.push_back(inst);
     }
   }
 
@@ -242,14 +241,21 @@ class AggressiveDCEPass : public MemPass {
   // if it might have a side effect, either directly or indirectly.
   // If we don't know, then add it to this list.  Instructions are
   // removed from this list as the algorithm traces side effects,
-  // building up the live instructions set |live_insts_|.
-  std::queue<Instruction*> worklist_;
+  // building up the live instructions set |live_insts_|.  Backed by a flat
+  // array with a consumed-prefix cursor instead of a queue, so the storage
+  // is drained in FIFO order but reused across functions rather than
+  // reallocated for each one.
+  std::vector<Instruction*> worklist_;
+  size_t worklist_next_ = 0;
 
   // Live Instructions
   utils::BitVector live_insts_;
 
-  // Live Local Variables
-  std::unordered_set<uint32_t> live_local_vars_;
+  // Live Local Variables, tracked by result id.  The companion vector
+  // remembers which bits are set so the next function can clear just those
+  // instead of discarding the allocation.
+  utils::BitVector live_local_vars_;
+  std::vector<uint32_t> live_local_var_ids_;
 
   // List of instructions to delete. Deletion is delayed until debug and
   // annotation instructions are processed.
@@ -0,0 +1,141 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/analysis_metadata.h"
+
+#include <utility>
+
+#include "source/opt/dominator_analysis.h"
+#include "source/opt/loop_descriptor.h"
+#include "source/util/make_unique.h"
+#include "source/util/string_utils.h"
+
+namespace spvtools {
+namespace opt {
+
+const char kAnalysisMetadataSetName[] =
+    "NonSemantic.SPIRV-Tools.AnalysisMetadata";
+
+Pass::Status EmbedAnalysisMetadataPass::Process() {
+  RemoveStaleMetadata();
+  const uint32_t set_id = GetMetadataSetId();
+  for (Function& function : *get_module()) {
+    if (function.begin() == function.end()) continue;
+    EmbedDominatorTree(set_id, &function);
+    EmbedLoops(set_id, &function);
+  }
+  return Status::SuccessWithChange;
+}
+
+bool EmbedAnalysisMetadataPass::RemoveStaleMetadata() {
+  uint32_t set_id = 0;
+  for (Instruction& inst : get_module()->ext_inst_imports()) {
+    if (inst.GetInOperand(0).AsString() == kAnalysisMetadataSetName) {
+      set_id = inst.result_id();
+    }
+  }
+  if (set_id == 0) return false;
+
+  // A round trip through a binary may have moved earlier metadata after the
+  // last function, so scan the whole module rather than one section.
+  std::vector<Instruction*> stale;
+  get_module()->ForEachInst([set_id, &stale](Instruction* inst) {
+    if (inst->opcode() == spv::Op::OpExtInst &&
+        inst->GetSingleWordInOperand(0) == set_id) {
+      stale.push_back(inst);
+    }
+  });
+  for (Instruction* inst : stale) {
+    context()->KillInst(inst);
+  }
+  return !stale.empty();
+}
+
+uint32_t EmbedAnalysisMetadataPass::GetMetadataSetId() {
+  const uint32_t existing_id =
+      get_module()->GetExtInstImportId(kAnalysisMetadataSetName);
+  if (existing_id != 0) return existing_id;
+
+  const uint32_t set_id = TakeNextId();
+  std::vector<uint32_t> words = utils::MakeVector(kAnalysisMetadataSetName);
+  auto import = MakeUnique<Instruction>(
+      context(), spv::Op::OpExtInstImport, 0, set_id,
+      std::initializer_list<Operand>{
+          Operand{SPV_OPERAND_TYPE_LITERAL_STRING, std::move(words)}});
+  Instruction* import_inst = import.get();
+  get_module()->AddExtInstImport(std::move(import));
+  context()->AnalyzeDefUse(import_inst);
+
+  if (get_module()->version() < SPV_SPIRV_VERSION_WORD(1, 6) &&
+      !get_feature_mgr()->HasExtension(kSPV_KHR_non_semantic_info)) {
+    context()->AddExtension("SPV_KHR_non_semantic_info");
+  }
+  // Reanalyze the feature list, since we added an extended instruction set
+  // import.
+  context()->get_feature_mgr()->Analyze(context()->module());
+  return set_id;
+}
+
+void EmbedAnalysisMetadataPass::EmbedDominatorTree(uint32_t set_id,
+                                                   Function* function) {
+  DominatorAnalysis* dominators = context()->GetDominatorAnalysis(function);
+  std::vector<uint32_t> values;
+  values.push_back(function->result_id());
+  for (DominatorTreeNode& node : dominators->GetDomTree()) {
+    values.push_back(node.id());
+    // The parent of the entry block is the placeholder node, whose id is 0.
+    values.push_back(node.parent_ != nullptr ? node.parent_->id() : 0);
+  }
+  EmitInstruction(set_id, kAnalysisMetadataDominatorTree, values);
+}
+
+void EmbedAnalysisMetadataPass::EmbedLoops(uint32_t set_id,
+                                           Function* function) {
+  LoopDescriptor* loops = context()->GetLoopDescriptor(function);
+  if (loops->NumLoops() == 0) return;
+  std::vector<uint32_t> values;
+  values.push_back(function->result_id());
+  for (size_t i = 0; i < loops->NumLoops(); ++i) {
+    Loop& loop = loops->GetLoopByIndex(i);
+    values.push_back(loop.GetHeaderBlock()->id());
+    Loop* parent = loop.GetParent();
+    values.push_back(parent != nullptr ? parent->GetHeaderBlock()->id() : 0);
+  }
+  EmitInstruction(set_id, kAnalysisMetadataLoops, values);
+}
+
+void EmbedAnalysisMetadataPass::EmitInstruction(
+    uint32_t set_id, uint32_t inst_number,
+    const std::vector<uint32_t>& values) {
+  analysis::ConstantManager* const_mgr = context()->get_constant_mgr();
+  std::vector<Operand> operands;
+  operands.push_back({SPV_OPERAND_TYPE_ID, {set_id}});
+  operands.push_back(
+      {SPV_OPERAND_TYPE_EXTENSION_INSTRUCTION_NUMBER, {inst_number}});
+  for (uint32_t value : values) {
+    const uint32_t const_id = const_mgr->GetUIntConstId(value);
+    operands.push_back({SPV_OPERAND_TYPE_ID, {const_id}});
+  }
+  auto inst = MakeUnique<Instruction>(
+      context(), spv::Op::OpExtInst, context()->get_type_mgr()->GetVoidTypeId(),
+      TakeNextId(), operands);
+  Instruction* inst_ptr = inst.get();
+  // Global non-semantic instructions live at the end of the global values,
+  // after the constants they reference.
+  get_module()->AddGlobalValue(std::move(inst));
+  context()->AnalyzeDefUse(inst_ptr);
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,88 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_ANALYSIS_METADATA_H_
+#define SOURCE_OPT_ANALYSIS_METADATA_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "source/opt/function.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Name of the non-semantic extended instruction set holding analysis
+// results embedded by EmbedAnalysisMetadataPass.
+extern const char kAnalysisMetadataSetName[];
+
+// Instructions of the analysis metadata set. Every operand is the id of a
+// 32-bit integer constant, as SPV_KHR_non_semantic_info requires.
+enum AnalysisMetadataInst : uint32_t {
+  // The dominator tree of one function: the function's result id, then one
+  // (block id, immediate dominator id) pair per reachable basic block, with
+  // 0 recorded as the immediate dominator of the entry block.
+  kAnalysisMetadataDominatorTree = 1,
+  // The loops of one function: the function's result id, then one
+  // (header block id, parent loop header id) pair per loop, with 0 recorded
+  // as the parent of outermost loops.
+  kAnalysisMetadataLoops = 2,
+};
+
+// Serializes each function's dominator tree and loop structure into
+// non-semantic extended instructions, so that downstream consumers of the
+// module can rehydrate them (see IRContext::LoadEmbeddedAnalysisMetadata)
+// instead of recomputing them from the CFG. Any metadata left over from an
+// earlier embedding is replaced.
+class EmbedAnalysisMetadataPass : public Pass {
+ public:
+  const char* name() const override { return "embed-analysis-metadata"; }
+  Status Process() override;
+
+  IRContext::Analysis GetPreservedAnalyses() override {
+    return IRContext::kAnalysisDefUse |
+           IRContext::kAnalysisInstrToBlockMapping |
+           IRContext::kAnalysisCombinators | IRContext::kAnalysisCFG |
+           IRContext::kAnalysisDominatorAnalysis |
+           IRContext::kAnalysisLoopAnalysis | IRContext::kAnalysisNameMap |
+           IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
+  }
+
+ private:
+  // Removes metadata instructions left by a previous run of this pass.
+  // Returns true if any were removed.
+  bool RemoveStaleMetadata();
+
+  // Returns the id of the metadata extended instruction set import, creating
+  // the import (and, below SPIR-V 1.6, the SPV_KHR_non_semantic_info
+  // extension) on first use.
+  uint32_t GetMetadataSetId();
+
+  // Serializes the dominator tree of |function|.
+  void EmbedDominatorTree(uint32_t set_id, Function* function);
+
+  // Serializes the loop nest of |function|.
+  void EmbedLoops(uint32_t set_id, Function* function);
+
+  // Appends one metadata instruction of kind |inst_number| whose operands
+  // are integer constants holding |values|, in order.
+  void EmitInstruction(uint32_t set_id, uint32_t inst_number,
+                       const std::vector<uint32_t>& values);
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_ANALYSIS_METADATA_H_
@@ -277,6 +277,10 @@ BasicBlock* BasicBlock::SplitBasicBlock(IRContext* context, uint32_t label_id,
     });
   }
 
+  if (context->AreAnalysesValid(IRContext::kAnalysisCFG)) {
+    context->cfg()->OnBlockSplit(this, new_block);
+  }
+
   return new_block;
 }
 
@@ -145,6 +145,19 @@ class BasicBlock {
   inline bool WhileEachInst(const std::function<bool(const Instruction*)>& f,
                             bool run_on_debug_line_insts = false) const;
 
+  // Same as the overloads above, but call |f| directly instead of through a
+  // std::function.  Overload resolution prefers these whenever |f| is a
+  // lambda or another plain functor, which keeps hot traversals free of
+  // type erasure.
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false);
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false) const;
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false);
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false) const;
+
   // Runs the given function |f| on each Phi instruction in this basic block,
   // and optionally on the debug line instructions that might precede them.
   inline void ForEachPhiInst(const std::function<void(Instruction*)>& f,
@@ -310,6 +323,59 @@ inline void BasicBlock::ForEachInst(
       run_on_debug_line_insts);
 }
 
+template <typename F>
+bool BasicBlock::WhileEachInst(F&& f, bool run_on_debug_line_insts) {
+  if (label_) {
+    if (!label_->WhileEachInst(f, run_on_debug_line_insts)) return false;
+  }
+  if (insts_.empty()) {
+    return true;
+  }
+
+  Instruction* inst = &insts_.front();
+  while (inst != nullptr) {
+    Instruction* next_instruction = inst->NextNode();
+    if (!inst->WhileEachInst(f, run_on_debug_line_insts)) return false;
+    inst = next_instruction;
+  }
+  return true;
+}
+
+template <typename F>
+bool BasicBlock::WhileEachInst(F&& f, bool run_on_debug_line_insts) const {
+  if (label_) {
+    if (!static_cast<const Instruction*>(label_.get())
+             ->WhileEachInst(f, run_on_debug_line_insts))
+      return false;
+  }
+  for (const auto& inst : insts_) {
+    if (!static_cast<const Instruction*>(&inst)->WhileEachInst(
+            f, run_on_debug_line_insts))
+      return false;
+  }
+  return true;
+}
+
+template <typename F>
+void BasicBlock::ForEachInst(F&& f, bool run_on_debug_line_insts) {
+  WhileEachInst(
+      [&f](Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts);
+}
+
+template <typename F>
+void BasicBlock::ForEachInst(F&& f, bool run_on_debug_line_insts) const {
+  WhileEachInst(
+      [&f](const Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts);
+}
+
 inline bool BasicBlock::WhileEachPhiInst(
     const std::function<bool(Instruction*)>& f, bool run_on_debug_line_insts) {
   if (insts_.empty()) {
@@ -0,0 +1,192 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/block_layout_pass.h"
+
+#include <list>
+#include <unordered_set>
+
+#include "source/opt/ir_context.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+// Operand indices of OpBranchConditional.
+constexpr uint32_t kBranchCondTrueLabIdInIdx = 1;
+constexpr uint32_t kBranchCondFalseLabIdInIdx = 2;
+constexpr uint32_t kBranchCondTrueWeightInIdx = 3;
+constexpr uint32_t kBranchCondFalseWeightInIdx = 4;
+// Operand index of the default target of OpSwitch.
+constexpr uint32_t kSwitchDefaultLabIdInIdx = 1;
+}  // namespace
+
+Pass::Status BlockLayoutPass::Process() {
+  // ComputeStructuredOrder, which seeds the layout, requires structured
+  // control flow.
+  if (!context()->get_feature_mgr()->HasCapability(spv::Capability::Shader)) {
+    return Status::SuccessWithoutChange;
+  }
+
+  bool modified = false;
+  for (Function& func : *get_module()) {
+    if (func.IsDeclaration()) continue;
+    modified |= LayoutFunction(&func);
+  }
+  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+}
+
+bool BlockLayoutPass::LayoutFunction(Function* func) {
+  std::vector<BasicBlock*> original;
+  for (BasicBlock& block : *func) original.push_back(&block);
+  if (original.size() < 3) return false;
+
+  std::list<BasicBlock*> structured;
+  cfg()->ComputeStructuredOrder(func, original[0], &structured);
+  const std::vector<BasicBlock*> skeleton(structured.begin(),
+                                          structured.end());
+
+  DominatorAnalysis* dominators = context()->GetDominatorAnalysis(func);
+  const LoopDescriptor& loops = *context()->GetLoopDescriptor(func);
+
+  std::unordered_set<uint32_t> placed;
+  std::vector<BasicBlock*> order;
+  order.reserve(original.size());
+  auto place = [&placed, &order](BasicBlock* block) {
+    placed.insert(block->id());
+    order.push_back(block);
+  };
+  // A block may be emitted once its immediate dominator has been: the
+  // validator requires every block to appear after its dominator.  Blocks
+  // without an immediate dominator are unreachable and may go anywhere.
+  auto is_ready = [&placed, dominators](BasicBlock* block) {
+    BasicBlock* idom = dominators->ImmediateDominator(block);
+    return idom == nullptr || idom == block || placed.count(idom->id()) != 0;
+  };
+  // A chain only falls through into a block whose other forward edges have
+  // all been laid out; otherwise a merge block would be pulled above the
+  // arms that branch to it.  Back edges, whose sources the block dominates,
+  // do not hold a block back.
+  auto is_chain_target = [this, &placed, dominators](BasicBlock* block) {
+    for (uint32_t pred_id : cfg()->preds(block->id())) {
+      if (placed.count(pred_id) == 0 &&
+          !dominators->Dominates(block->id(), pred_id)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Grow chains of likely fall-throughs.  Whenever no successor of the last
+  // placed block can be placed, restart from the first unplaced block of
+  // the structured order.  All of that block's structured-order
+  // predecessors, including its dominator, are already placed, so progress
+  // is guaranteed.
+  BasicBlock* current = original[0];
+  place(current);
+  size_t cursor = 1;
+  while (order.size() < skeleton.size()) {
+    BasicBlock* next = nullptr;
+    for (uint32_t succ_id : PreferredSuccessors(current, loops)) {
+      BasicBlock* succ = cfg()->block(succ_id);
+      if (placed.count(succ_id) == 0 && is_ready(succ) &&
+          is_chain_target(succ)) {
+        next = succ;
+        break;
+      }
+    }
+    if (next == nullptr) {
+      while (cursor < skeleton.size() &&
+             placed.count(skeleton[cursor]->id()) != 0) {
+        ++cursor;
+      }
+      if (cursor == skeleton.size()) break;
+      next = skeleton[cursor];
+    }
+    place(next);
+    current = next;
+  }
+
+  // Blocks the structured order never reaches are unreachable; keep them at
+  // the end in their original relative order.
+  for (BasicBlock* block : original) {
+    if (placed.count(block->id()) == 0) place(block);
+  }
+
+  if (order == original) return false;
+  func->ReorderBasicBlocks(order.begin(), order.end());
+  return true;
+}
+
+std::vector<uint32_t> BlockLayoutPass::PreferredSuccessors(
+    BasicBlock* block, const LoopDescriptor& loops) {
+  Instruction* terminator = block->terminator();
+  std::vector<uint32_t> successors;
+  switch (terminator->opcode()) {
+    case spv::Op::OpBranch:
+      successors.push_back(terminator->GetSingleWordInOperand(0));
+      break;
+    case spv::Op::OpBranchConditional: {
+      const uint32_t true_id =
+          terminator->GetSingleWordInOperand(kBranchCondTrueLabIdInIdx);
+      const uint32_t false_id =
+          terminator->GetSingleWordInOperand(kBranchCondFalseLabIdInIdx);
+      bool true_first = true;
+      if (terminator->NumInOperands() > kBranchCondFalseWeightInIdx) {
+        // Explicit branch weights trump the structural heuristics.
+        true_first =
+            terminator->GetSingleWordInOperand(kBranchCondTrueWeightInIdx) >=
+            terminator->GetSingleWordInOperand(kBranchCondFalseWeightInIdx);
+      } else {
+        true_first = EdgeLikelihood(block, true_id, loops) >=
+                     EdgeLikelihood(block, false_id, loops);
+      }
+      successors.push_back(true_first ? true_id : false_id);
+      successors.push_back(true_first ? false_id : true_id);
+      break;
+    }
+    case spv::Op::OpSwitch:
+      // Prefer the cases in declaration order; the default target is often
+      // the cold path, so it goes last.
+      for (uint32_t i = kSwitchDefaultLabIdInIdx + 2;
+           i < terminator->NumInOperands(); i += 2) {
+        successors.push_back(terminator->GetSingleWordInOperand(i));
+      }
+      successors.push_back(
+          terminator->GetSingleWordInOperand(kSwitchDefaultLabIdInIdx));
+      break;
+    default:
+      break;
+  }
+  return successors;
+}
+
+int BlockLayoutPass::EdgeLikelihood(BasicBlock* block, uint32_t target,
+                                    const LoopDescriptor& loops) {
+  if (Loop* loop = loops[block->id()]) {
+    // Loops iterate more often than they exit: a back edge is the most
+    // likely edge out of a block and an edge leaving the loop the least.
+    if (target == loop->GetHeaderBlock()->id()) return 2;
+    if (!loop->IsInsideLoop(target)) return -2;
+  }
+  // An edge that jumps straight to the block's own merge block skips the
+  // construct; assume the construct body runs.
+  Instruction* merge = block->GetMergeInst();
+  if (merge != nullptr && target == merge->GetSingleWordInOperand(0)) {
+    return -1;
+  }
+  return 0;
+}
+
+}  // namespace opt
+}  // namespace spvtools
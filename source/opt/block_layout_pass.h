@@ -0,0 +1,71 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_BLOCK_LAYOUT_PASS_H_
+#define SOURCE_OPT_BLOCK_LAYOUT_PASS_H_
+
+#include <vector>
+
+#include "source/opt/basic_block.h"
+#include "source/opt/function.h"
+#include "source/opt/loop_descriptor.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Reorders each function's basic blocks so that likely control flow falls
+// through to the next block in the binary.  Downstream compilers that keep
+// the module's block order then place hot paths contiguously, which reduces
+// branch mispredictions and instruction cache misses.
+//
+// Blocks are laid out greedily: starting from the entry block, the chain is
+// extended with the most likely unplaced successor of the last placed block.
+// A conditional branch prefers an explicit branch weight when one is
+// present; otherwise back edges are assumed taken and branches that leave
+// the innermost loop or jump straight to the block's own merge block are
+// assumed not taken.  When the chain cannot be extended, it restarts at the
+// first unplaced block of the structured order, so merge and continue
+// blocks still come after the constructs they close.
+//
+// Every block is emitted only after its immediate dominator, so the layout
+// satisfies the SPIR-V block ordering rules.  Modules without the Shader
+// capability are left untouched.
+class BlockLayoutPass : public Pass {
+ public:
+  const char* name() const override { return "block-layout"; }
+  Status Process() override;
+
+ private:
+  // Reorders the blocks of |func| as described above.  Returns true if the
+  // block order changed.
+  bool LayoutFunction(Function* func);
+
+  // Returns the successor ids of |block|, most likely first.  Successors
+  // reached by a back edge come first and successors that exit the
+  // innermost loop of |block| or match its own merge declaration come last,
+  // unless the terminator carries explicit branch weights.
+  std::vector<uint32_t> PreferredSuccessors(BasicBlock* block,
+                                            const LoopDescriptor& loops);
+
+  // Returns a likelihood score for the edge from |block| to |target|;
+  // higher means more likely taken.
+  int EdgeLikelihood(BasicBlock* block, uint32_t target,
+                     const LoopDescriptor& loops);
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_BLOCK_LAYOUT_PASS_H_
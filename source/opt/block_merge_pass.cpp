@@ -24,17 +24,29 @@ namespace opt {
 
 bool BlockMergePass::MergeBlocks(Function* func) {
   bool modified = false;
-  for (auto bi = func->begin(); bi != func->end();) {
+  for (auto bi = func->begin(); bi != func->end(); ++bi) {
+    if (bi->GetLabelInst()->opcode() == spv::Op::OpNop) {
+      // Already merged into a predecessor; the block is removed by the sweep
+      // below.
+      continue;
+    }
     // Don't bother trying to merge unreachable blocks.
-    if (context()->IsReachable(*bi) &&
-        blockmergeutil::CanMergeWithSuccessor(context(), &*bi)) {
-      blockmergeutil::MergeWithSuccessor(context(), func, bi);
-      // Reprocess block.
+    if (!context()->IsReachable(*bi)) {
+      continue;
+    }
+    // Grow the merge chain rooted at this block as far as it will go.  Each
+    // merged successor is spliced into this block in constant time and left
+    // behind empty, so the function's block list is compacted only once, at
+    // the end.
+    while (blockmergeutil::CanMergeWithSuccessor(context(), &*bi)) {
+      blockmergeutil::MergeWithSuccessorLeavingEmptyBlock(context(), func,
+                                                          &*bi);
       modified = true;
-    } else {
-      ++bi;
     }
   }
+  if (modified) {
+    func->RemoveEmptyBlocks();
+  }
   return modified;
 }
 
@@ -45,7 +45,10 @@ class BlockMergePass : public Pass {
            IRContext::kAnalysisInstrToBlockMapping |
            IRContext::kAnalysisDecorations | IRContext::kAnalysisCombinators |
            IRContext::kAnalysisNameMap | IRContext::kAnalysisConstants |
-           IRContext::kAnalysisTypes;
+           IRContext::kAnalysisTypes | IRContext::kAnalysisCFG |
+           // Preserved because MergeWithSuccessor invalidates the structured
+           // CFG information for just the function it changes.
+           IRContext::kAnalysisStructuredCFG;
   }
 
  private:
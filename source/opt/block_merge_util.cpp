@@ -75,6 +75,67 @@ void EliminateOpPhiInstructions(IRContext* context, BasicBlock* block) {
   });
 }
 
+// Merges the contents of |succ_block| into |block|: |block|'s branch is
+// killed, |succ_block|'s instructions are spliced into |block|, and
+// |succ_block|'s label is killed, leaving |succ_block| empty.  Removing the
+// emptied block from |func| is left to the caller.
+void MergeWithSuccessorImpl(IRContext* context, Function* func,
+                            BasicBlock* block, BasicBlock* succ_block) {
+  const uint32_t lab_id = succ_block->id();
+  Instruction* merge_inst = block->GetMergeInst();
+  bool pred_is_header = IsHeader(block);
+
+  // Merge blocks.
+  context->KillInst(block->terminator());
+
+  // Update the inst-to-block mapping for the instructions in succ_block.
+  for (auto& inst : *succ_block) {
+    context->set_instr_block(&inst, block);
+  }
+
+  EliminateOpPhiInstructions(context, succ_block);
+
+  // Now actually move the instructions.
+  block->AddInstructions(succ_block);
+
+  if (merge_inst) {
+    if (pred_is_header && lab_id == merge_inst->GetSingleWordInOperand(0u)) {
+      // Merging the header and merge blocks, so remove the structured control
+      // flow declaration.
+      context->KillInst(merge_inst);
+    } else {
+      // Move OpLine/OpNoLine information to merge_inst. This solves
+      // the validation error that OpLine is placed between OpLoopMerge
+      // and OpBranchConditional.
+      auto terminator = block->terminator();
+      if (terminator->has_dbg_line_insts()) {
+        auto& vec = terminator->dbg_line_insts();
+        merge_inst->ClearDbgLineInsts();
+        auto& new_vec = merge_inst->dbg_line_insts();
+        new_vec.insert(new_vec.end(), vec.begin(), vec.end());
+        terminator->ClearDbgLineInsts();
+        for (auto& l_inst : new_vec)
+          context->get_def_use_mgr()->AnalyzeInstDefUse(&l_inst);
+      }
+      // Clear debug scope of terminator to avoid DebugScope
+      // emitted between terminator and merge.
+      terminator->SetDebugScope(DebugScope(kNoDebugScope, kNoInlinedAt));
+      // Move the merge instruction to just before the terminator.
+      merge_inst->InsertBefore(terminator);
+    }
+  }
+  context->ReplaceAllUsesWith(lab_id, block->id());
+  context->KillInst(succ_block->GetLabelInst());
+
+  if (context->AreAnalysesValid(IRContext::kAnalysisCFG)) {
+    context->cfg()->OnBlocksMerged(block->id(), lab_id);
+  }
+
+  // The merge changed the block structure of |func|, so any structured CFG
+  // information cached for it is stale.  Other functions are unaffected.
+  context->InvalidateStructuredCFGAnalysis(func);
+}
+
 }  // Anonymous namespace
 
 bool CanMergeWithSuccessor(IRContext* context, BasicBlock* block) {
@@ -155,15 +216,7 @@ void MergeWithSuccessor(IRContext* context, Function* func,
          "Precondition failure for MergeWithSuccessor: it must be legal to "
          "merge the block and its successor.");
 
-  auto ii = bi->end();
-  --ii;
-  Instruction* br = &*ii;
-  const uint32_t lab_id = br->GetSingleWordInOperand(0);
-  Instruction* merge_inst = bi->GetMergeInst();
-  bool pred_is_header = IsHeader(&*bi);
-
-  // Merge blocks.
-  context->KillInst(br);
+  const uint32_t lab_id = bi->terminator()->GetSingleWordInOperand(0);
   auto sbi = bi;
   for (; sbi != func->end(); ++sbi)
     if (sbi->id() == lab_id) break;
@@ -171,52 +224,23 @@ void MergeWithSuccessor(IRContext* context, Function* func,
   // sbi must follow bi in func's ordering.
   assert(sbi != func->end());
 
-  if (sbi->tail()->opcode() == spv::Op::OpSwitch &&
-      sbi->MergeBlockIdIfAny() != 0) {
-    context->InvalidateAnalyses(IRContext::Analysis::kAnalysisStructuredCFG);
-  }
-
-  // Update the inst-to-block mapping for the instructions in sbi.
-  for (auto& inst : *sbi) {
-    context->set_instr_block(&inst, &*bi);
-  }
-
-  EliminateOpPhiInstructions(context, &*sbi);
-
-  // Now actually move the instructions.
-  bi->AddInstructions(&*sbi);
-
-  if (merge_inst) {
-    if (pred_is_header && lab_id == merge_inst->GetSingleWordInOperand(0u)) {
-      // Merging the header and merge blocks, so remove the structured control
-      // flow declaration.
-      context->KillInst(merge_inst);
-    } else {
-      // Move OpLine/OpNoLine information to merge_inst. This solves
-      // the validation error that OpLine is placed between OpLoopMerge
-      // and OpBranchConditional.
-      auto terminator = bi->terminator();
-      auto& vec = terminator->dbg_line_insts();
-      if (vec.size() > 0) {
-        merge_inst->ClearDbgLineInsts();
-        auto& new_vec = merge_inst->dbg_line_insts();
-        new_vec.insert(new_vec.end(), vec.begin(), vec.end());
-        terminator->ClearDbgLineInsts();
-        for (auto& l_inst : new_vec)
-          context->get_def_use_mgr()->AnalyzeInstDefUse(&l_inst);
-      }
-      // Clear debug scope of terminator to avoid DebugScope
-      // emitted between terminator and merge.
-      terminator->SetDebugScope(DebugScope(kNoDebugScope, kNoInlinedAt));
-      // Move the merge instruction to just before the terminator.
-      merge_inst->InsertBefore(terminator);
-    }
-  }
-  context->ReplaceAllUsesWith(lab_id, bi->id());
-  context->KillInst(sbi->GetLabelInst());
+  MergeWithSuccessorImpl(context, func, &*bi, &*sbi);
   (void)sbi.Erase();
 }
 
+void MergeWithSuccessorLeavingEmptyBlock(IRContext* context, Function* func,
+                                         BasicBlock* block) {
+  assert(CanMergeWithSuccessor(context, block) &&
+         "Precondition failure for MergeWithSuccessorLeavingEmptyBlock: it "
+         "must be legal to merge the block and its successor.");
+
+  const uint32_t lab_id = block->terminator()->GetSingleWordInOperand(0);
+  BasicBlock* succ_block = context->get_instr_block(lab_id);
+  assert(succ_block != nullptr &&
+         "The successor must be a block of the function.");
+  MergeWithSuccessorImpl(context, func, block, succ_block);
+}
+
 }  // namespace blockmergeutil
 }  // namespace opt
 }  // namespace spvtools
@@ -37,6 +37,15 @@ bool CanMergeWithSuccessor(IRContext* context, BasicBlock* block);
 void MergeWithSuccessor(IRContext* context, Function* func,
                         Function::iterator bi);
 
+// As MergeWithSuccessor, but leaves the successor behind in |func| as an
+// empty block whose label has been killed (turned into OpNop).  This lets a
+// caller performing many merges splice each pair in constant time and remove
+// all of the emptied blocks in one sweep with Function::RemoveEmptyBlocks,
+// instead of paying for a block-list erase per merge.  The emptied blocks
+// must not be otherwise touched before that sweep.
+void MergeWithSuccessorLeavingEmptyBlock(IRContext* context, Function* func,
+                                         BasicBlock* block);
+
 }  // namespace blockmergeutil
 }  // namespace opt
 }  // namespace spvtools
@@ -57,13 +57,15 @@ std::unique_ptr<opt::IRContext> BuildModule(spv_target_env env,
                                             MessageConsumer consumer,
                                             const uint32_t* binary,
                                             const size_t size,
-                                            bool extra_line_tracking) {
+                                            bool extra_line_tracking,
+                                            uint32_t id_offset) {
   auto context = spvContextCreate(env);
   SetContextMessageConsumer(context, consumer);
 
   auto irContext = MakeUnique<opt::IRContext>(env, consumer);
   opt::IrLoader loader(consumer, irContext->module());
   loader.SetExtraLineTracking(extra_line_tracking);
+  loader.SetIdOffset(id_offset);
 
   spv_result_t status = spvBinaryParse(context, &loader, binary, size,
                                        SetSpvHeader, SetSpvInst, nullptr);
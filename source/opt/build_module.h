@@ -29,11 +29,21 @@ namespace spvtools {
 // decoded according to the given target |env|. Returns nullptr if errors occur
 // and sends the errors to |consumer|.  When |extra_line_tracking| is true,
 // extra OpLine instructions are injected to better presere line numbers while
-// later transforms mutate the module.
+// later transforms mutate the module.  A non-zero |id_offset| is added to
+// every id while loading, so the module occupies a shifted id range; see
+// opt::IrLoader::SetIdOffset().
+//
+// |binary| is borrowed: it is read in place (a host-endian module is parsed
+// without any copy of the words, see spvBinaryParse) and nothing in the
+// returned IRContext references it, so the caller may release or reuse the
+// buffer as soon as the call returns.  A caller holding the binary in a
+// cache therefore pays for the IR structures only, not for a second copy of
+// the binary.
 std::unique_ptr<opt::IRContext> BuildModule(spv_target_env env,
                                             MessageConsumer consumer,
                                             const uint32_t* binary, size_t size,
-                                            bool extra_line_tracking);
+                                            bool extra_line_tracking,
+                                            uint32_t id_offset = 0);
 
 // Like above, with extra line tracking turned on.
 std::unique_ptr<opt::IRContext> BuildModule(spv_target_env env,
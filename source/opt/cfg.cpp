@@ -14,10 +14,10 @@
 
 #include "source/opt/cfg.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
-#include "source/cfa.h"
 #include "source/opt/ir_builder.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
@@ -26,8 +26,6 @@ namespace spvtools {
 namespace opt {
 namespace {
 
-using cbb_ptr = const opt::BasicBlock*;
-
 // Universal Limit of ResultID + 1
 constexpr int kMaxResultId = 0x400000;
 
@@ -84,22 +82,74 @@ void CFG::ComputeStructuredOrder(Function* func, BasicBlock* root,
              spv::Capability::Shader) &&
          "This only works on structured control flow");
 
-  // Compute structured successors and do DFS.
-  ComputeStructuredSuccessors(func);
-  auto ignore_block = [](cbb_ptr) {};
-  auto terminal = [end](cbb_ptr bb) { return bb == end; };
-
-  auto get_structured_successors = [this](const BasicBlock* b) {
-    return &(block2structured_succs_[b]);
-  };
-
-  // TODO(greg-lunarg): Get rid of const_cast by making moving const
-  // out of the cfa.h prototypes and into the invoking code.
-  auto post_order = [&](cbb_ptr b) {
-    order->push_front(const_cast<BasicBlock*>(b));
-  };
-  CFA<BasicBlock>::DepthFirstTraversal(root, get_structured_successors,
-                                       ignore_block, post_order, terminal);
+  // Assign each block a dense index in layout order, with the pseudo entry
+  // block last.  The successor, visited, and stack structures below are then
+  // flat vectors over those small integers, so the traversal walks linear
+  // memory instead of chasing pointer-keyed hash maps.
+  std::vector<BasicBlock*> index2block;
+  std::unordered_map<uint32_t, uint32_t> id2index;
+  for (auto& blk : *func) {
+    id2index[blk.id()] = static_cast<uint32_t>(index2block.size());
+    index2block.push_back(&blk);
+  }
+  const uint32_t pseudo_entry_index = static_cast<uint32_t>(index2block.size());
+  index2block.push_back(&pseudo_entry_block_);
+
+  // A block's structured successors are the blocks it branches to together
+  // with its declared merge block and continue block if it has them.  The
+  // merge block and continue block always appear first.  This assures a
+  // correct depth first search in the presence of early returns and kills; if
+  // a successor list contains duplicates of the merge or continue blocks,
+  // they are safely ignored by the DFS.  The pseudo entry block has every
+  // block without predecessors in the function as a successor.
+  std::vector<std::vector<uint32_t>> successors(index2block.size());
+  for (auto& blk : *func) {
+    if (label2preds_[blk.id()].empty()) {
+      successors[pseudo_entry_index].push_back(id2index[blk.id()]);
+    }
+
+    std::vector<uint32_t>& succs = successors[id2index[blk.id()]];
+    uint32_t mbid = blk.MergeBlockIdIfAny();
+    if (mbid != 0) {
+      succs.push_back(id2index.at(mbid));
+      uint32_t cbid = blk.ContinueBlockIdIfAny();
+      if (cbid != 0) {
+        succs.push_back(id2index.at(cbid));
+      }
+    }
+    const auto& const_blk = blk;
+    const_blk.ForEachSuccessorLabel([&succs, &id2index](const uint32_t sbid) {
+      succs.push_back(id2index.at(sbid));
+    });
+  }
+
+  // Depth first traversal emitting blocks in reverse post order.  The
+  // successors of |end| are not followed, but |end| itself is emitted.  Each
+  // work list entry holds a block index and the position of the next
+  // successor to visit; the reserve keeps entry references stable across
+  // pushes since a block enters the work list at most once.
+  const uint32_t root_index = root == &pseudo_entry_block_
+                                  ? pseudo_entry_index
+                                  : id2index.at(root->id());
+  std::vector<bool> processed(index2block.size(), false);
+  std::vector<std::pair<uint32_t, size_t>> work_list;
+  work_list.reserve(index2block.size());
+  work_list.emplace_back(root_index, 0);
+  processed[root_index] = true;
+  while (!work_list.empty()) {
+    std::pair<uint32_t, size_t>& top = work_list.back();
+    BasicBlock* top_block = index2block[top.first];
+    if (top_block == end || top.second == successors[top.first].size()) {
+      order->push_front(top_block);
+      work_list.pop_back();
+    } else {
+      const uint32_t child = successors[top.first][top.second++];
+      if (!processed[child]) {
+        processed[child] = true;
+        work_list.emplace_back(child, 0);
+      }
+    }
+  }
 }
 
 void CFG::ForEachBlockInPostOrder(BasicBlock* bb,
@@ -139,32 +189,6 @@ bool CFG::WhileEachBlockInReversePostOrder(
   return true;
 }
 
-void CFG::ComputeStructuredSuccessors(Function* func) {
-  block2structured_succs_.clear();
-  for (auto& blk : *func) {
-    // If no predecessors in function, make successor to pseudo entry.
-    if (label2preds_[blk.id()].size() == 0)
-      block2structured_succs_[&pseudo_entry_block_].push_back(&blk);
-
-    // If header, make merge block first successor and continue block second
-    // successor if there is one.
-    uint32_t mbid = blk.MergeBlockIdIfAny();
-    if (mbid != 0) {
-      block2structured_succs_[&blk].push_back(block(mbid));
-      uint32_t cbid = blk.ContinueBlockIdIfAny();
-      if (cbid != 0) {
-        block2structured_succs_[&blk].push_back(block(cbid));
-      }
-    }
-
-    // Add true successors.
-    const auto& const_blk = blk;
-    const_blk.ForEachSuccessorLabel([&blk, this](const uint32_t sbid) {
-      block2structured_succs_[&blk].push_back(block(sbid));
-    });
-  }
-}
-
 void CFG::ComputePostOrderTraversal(BasicBlock* bb,
                                     std::vector<BasicBlock*>* order,
                                     std::unordered_set<BasicBlock*>* seen) {
@@ -189,6 +213,39 @@ void CFG::ComputePostOrderTraversal(BasicBlock* bb,
   }
 }
 
+void CFG::OnBlockSplit(const BasicBlock* original, BasicBlock* new_block) {
+  const uint32_t original_id = original->id();
+  const uint32_t new_block_id = new_block->id();
+  id2block_[new_block_id] = new_block;
+  // Force the creation of an entry, as RegisterBlock does: the new block has
+  // no predecessors until the caller branches to it.
+  label2preds_[new_block_id];
+  // The new block took over |original|'s terminator, so replace |original|
+  // with the new block in the predecessor lists of its former successors.
+  const BasicBlock* const_new_block = new_block;
+  const_new_block->ForEachSuccessorLabel(
+      [this, original_id, new_block_id](const uint32_t succ_id) {
+        auto& preds_list = label2preds_[succ_id];
+        std::replace(preds_list.begin(), preds_list.end(), original_id,
+                     new_block_id);
+      });
+}
+
+void CFG::OnBlocksMerged(uint32_t pred_blk_id, uint32_t succ_blk_id) {
+  // The predecessor has already taken over the merged block's terminator, so
+  // its current successors are the ones that record |succ_blk_id| as a
+  // predecessor.
+  const BasicBlock* merged = block(pred_blk_id);
+  merged->ForEachSuccessorLabel(
+      [this, pred_blk_id, succ_blk_id](const uint32_t succ_id) {
+        auto& preds_list = label2preds_[succ_id];
+        std::replace(preds_list.begin(), preds_list.end(), succ_blk_id,
+                     pred_blk_id);
+      });
+  id2block_.erase(succ_blk_id);
+  label2preds_.erase(succ_blk_id);
+}
+
 BasicBlock* CFG::SplitLoopHeader(BasicBlock* bb) {
   assert(bb->GetLoopMergeInst() && "Expecting bb to be the header of a loop.");
 
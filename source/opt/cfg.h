@@ -41,6 +41,13 @@ class CFG {
   // |blk_id|.
   BasicBlock* block(uint32_t blk_id) const { return id2block_.at(blk_id); }
 
+  // Return a pointer to the basic block instance corresponding to the label
+  // |blk_id|, or nullptr if no such block is known to the CFG.
+  BasicBlock* LookupBlock(uint32_t blk_id) const {
+    auto it = id2block_.find(blk_id);
+    return it == id2block_.end() ? nullptr : it->second;
+  }
+
   // Return the pseudo entry and exit blocks.
   const BasicBlock* pseudo_entry_block() const { return &pseudo_entry_block_; }
   BasicBlock* pseudo_entry_block() { return &pseudo_entry_block_; }
@@ -136,6 +143,22 @@ class CFG {
         [bb, this](uint32_t succ_id) { RemoveEdge(bb->id(), succ_id); });
   }
 
+  // Updates the CFG for a block that has just been split: |new_block| has
+  // taken over |original|'s terminator, so it inherits |original|'s successor
+  // edges and is registered in the cfg.  |original| is left without successor
+  // edges; the caller is responsible for adding an edge once it gives
+  // |original| a new terminator.  This is called by
+  // BasicBlock::SplitBasicBlock when the cfg analysis is valid.
+  void OnBlockSplit(const BasicBlock* original, BasicBlock* new_block);
+
+  // Updates the CFG after the block with id |succ_blk_id| has been merged
+  // into its single predecessor |pred_blk_id|: the predecessor takes over
+  // the successor edges of |succ_blk_id|, and |succ_blk_id| is forgotten.
+  // The predecessor must already have taken over the merged block's
+  // terminator.  This is called by blockmergeutil::MergeWithSuccessor when
+  // the cfg analysis is valid.
+  void OnBlocksMerged(uint32_t pred_blk_id, uint32_t succ_blk_id);
+
   // Divides |block| into two basic blocks.  The first block will have the same
   // id as |block| and will become a preheader for the loop.  The other block
   // is a new block that will be the new loop header.
@@ -145,15 +168,6 @@ class CFG {
   BasicBlock* SplitLoopHeader(BasicBlock* bb);
 
  private:
-  // Compute structured successors for function |func|. A block's structured
-  // successors are the blocks it branches to together with its declared merge
-  // block and continue block if it has them. When order matters, the merge
-  // block and continue block always appear first. This assures correct depth
-  // first search in the presence of early returns and kills. If the successor
-  // vector contain duplicates of the merge or continue blocks, they are safely
-  // ignored by DFS.
-  void ComputeStructuredSuccessors(Function* func);
-
   // Computes the post-order traversal of the cfg starting at |bb| skipping
   // nodes in |seen|.  The order of the traversal is appended to |order|, and
   // all nodes in the traversal are added to |seen|.
@@ -164,11 +178,6 @@ class CFG {
   // Module for this CFG.
   Module* module_;
 
-  // Map from block to its structured successor blocks. See
-  // ComputeStructuredSuccessors() for definition.
-  std::unordered_map<const BasicBlock*, std::vector<BasicBlock*>>
-      block2structured_succs_;
-
   // Extra block whose successors are all blocks with no predecessors
   // in function.
   BasicBlock pseudo_entry_block_;
@@ -75,7 +75,7 @@ BasicBlock* CodeSinkingPass::FindNewBasicBlockFor(Instruction* inst) {
   BasicBlock* original_bb = context()->get_instr_block(inst);
   BasicBlock* bb = original_bb;
 
-  std::unordered_set<uint32_t> bbs_with_uses;
+  utils::SmallSet<uint32_t, 8> bbs_with_uses;
   get_def_use_mgr()->ForEachUse(
       inst, [&bbs_with_uses, this](Instruction* use, uint32_t idx) {
         if (use->opcode() != spv::Op::OpPhi) {
@@ -292,10 +292,10 @@ bool CodeSinkingPass::HasPossibleStore(Instruction* var_inst) {
 }
 
 bool CodeSinkingPass::IntersectsPath(uint32_t start, uint32_t end,
-                                     const std::unordered_set<uint32_t>& set) {
+                                     const utils::SmallSet<uint32_t, 8>& set) {
   std::vector<uint32_t> worklist;
   worklist.push_back(start);
-  std::unordered_set<uint32_t> already_done;
+  utils::SmallSet<uint32_t, 8> already_done;
   already_done.insert(start);
 
   while (!worklist.empty()) {
@@ -15,11 +15,10 @@
 #ifndef SOURCE_OPT_CODE_SINK_H_
 #define SOURCE_OPT_CODE_SINK_H_
 
-#include <unordered_map>
-
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
 #include "source/opt/pass.h"
+#include "source/util/small_set.h"
 
 namespace spvtools {
 namespace opt {
@@ -86,7 +85,7 @@ class CodeSinkingPass : public Pass {
   // Returns true if one of the basic blocks in |set| exists on a path from the
   // basic block |start| to |end|.
   bool IntersectsPath(uint32_t start, uint32_t end,
-                      const std::unordered_set<uint32_t>& set);
+                      const utils::SmallSet<uint32_t, 8>& set);
 
   // Returns true if |mem_semantics_id| is the id of a constant that, when
   // interpreted as a memory semantics mask enforces synchronization of uniform
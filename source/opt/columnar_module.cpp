@@ -0,0 +1,80 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/columnar_module.h"
+
+#include "source/operand.h"
+#include "source/table.h"
+
+namespace spvtools {
+namespace opt {
+
+spv_result_t ColumnarModule::SetHeader(void* module, spv_endianness_t,
+                                       uint32_t, uint32_t, uint32_t,
+                                       uint32_t id_bound, uint32_t) {
+  ColumnarModule* columns = reinterpret_cast<ColumnarModule*>(module);
+  columns->id_bound_ = id_bound;
+  columns->defs_.assign(id_bound, kNoInst);
+  return SPV_SUCCESS;
+}
+
+spv_result_t ColumnarModule::AddInst(void* module,
+                                     const spv_parsed_instruction_t* inst) {
+  ColumnarModule* columns = reinterpret_cast<ColumnarModule*>(module);
+  const uint32_t inst_offset = static_cast<uint32_t>(columns->words_.size());
+  columns->words_.insert(columns->words_.end(), inst->words,
+                         inst->words + inst->num_words);
+  columns->opcodes_.push_back(inst->opcode);
+  columns->result_ids_.push_back(inst->result_id);
+  columns->type_ids_.push_back(inst->type_id);
+  for (uint16_t i = 0; i < inst->num_operands; ++i) {
+    const spv_parsed_operand_t& operand = inst->operands[i];
+    if (operand.type == SPV_OPERAND_TYPE_RESULT_ID ||
+        operand.type == SPV_OPERAND_TYPE_TYPE_ID) {
+      continue;
+    }
+    columns->operand_offsets_.push_back(inst_offset + operand.offset);
+    columns->operand_is_id_.push_back(spvIsIdType(operand.type) ? 1 : 0);
+  }
+  columns->operand_starts_.push_back(
+      static_cast<uint32_t>(columns->operand_offsets_.size()));
+  if (inst->result_id != 0) {
+    columns->defs_[inst->result_id] =
+        static_cast<uint32_t>(columns->opcodes_.size()) - 1;
+  }
+  return SPV_SUCCESS;
+}
+
+std::unique_ptr<ColumnarModule> ColumnarModule::Build(spv_target_env env,
+                                                      MessageConsumer consumer,
+                                                      const uint32_t* binary,
+                                                      size_t word_count) {
+  auto context = spvContextCreate(env);
+  SetContextMessageConsumer(context, consumer);
+
+  std::unique_ptr<ColumnarModule> columns(new ColumnarModule());
+  columns->words_.reserve(word_count);
+  columns->operand_starts_.push_back(0);
+
+  spv_result_t status = spvBinaryParse(context, columns.get(), binary,
+                                       word_count, SetHeader, AddInst,
+                                       nullptr);
+
+  spvContextDestroy(context);
+
+  return status == SPV_SUCCESS ? std::move(columns) : nullptr;
+}
+
+}  // namespace opt
+}  // namespace spvtools
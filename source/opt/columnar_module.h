@@ -0,0 +1,148 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_COLUMNAR_MODULE_H_
+#define SOURCE_OPT_COLUMNAR_MODULE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "source/latest_version_spirv_header.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace opt {
+
+// Read-only structure-of-arrays representation of a SPIR-V module for
+// analysis-dominant workloads that only scan instructions and never mutate
+// them. Opcodes, result ids, type ids and operand offsets are stored in
+// parallel arrays over one shared word pool, so a pass over one column
+// touches only the bytes it needs instead of pulling whole Instruction
+// objects through the cache. The representation is built directly from a
+// binary by a specialized spvBinaryParse() loader; it never constructs
+// Instruction or Module objects.
+//
+// The accessors on ColumnarModule::Inst mirror the Instruction query surface
+// that read-only analyses use: opcode(), result_id(), type_id(),
+// NumInOperands() and GetSingleWordInOperand(). Instructions are addressed by
+// their index in module order.
+class ColumnarModule {
+ public:
+  // Returned by GetDefIndex() for ids without a defining instruction.
+  static constexpr uint32_t kNoInst = std::numeric_limits<uint32_t>::max();
+
+  // Lightweight accessor for the instruction at one index. It is a (module,
+  // index) pair and must not outlive its module.
+  class Inst {
+   public:
+    spv::Op opcode() const {
+      return static_cast<spv::Op>(module_->opcodes_[index_]);
+    }
+    uint32_t result_id() const { return module_->result_ids_[index_]; }
+    uint32_t type_id() const { return module_->type_ids_[index_]; }
+    bool HasResultId() const { return result_id() != 0; }
+
+    // Returns the number of logical input operands, excluding the result id
+    // and the type id.
+    uint32_t NumInOperands() const {
+      return module_->operand_starts_[index_ + 1] -
+             module_->operand_starts_[index_];
+    }
+    // Returns the first word of the input operand at logical |index|.
+    uint32_t GetSingleWordInOperand(uint32_t index) const {
+      assert(index < NumInOperands() && "operand index out of bound");
+      return module_->words_
+          [module_->operand_offsets_[module_->operand_starts_[index_] +
+                                     index]];
+    }
+    // Returns true if the input operand at logical |index| is an id.
+    bool IsInOperandId(uint32_t index) const {
+      assert(index < NumInOperands() && "operand index out of bound");
+      return module_->operand_is_id_[module_->operand_starts_[index_] +
+                                     index] != 0;
+    }
+
+   private:
+    friend class ColumnarModule;
+    Inst(const ColumnarModule* module, uint32_t index)
+        : module_(module), index_(index) {}
+
+    const ColumnarModule* module_;
+    uint32_t index_;
+  };
+
+  // Builds the columnar representation of the |word_count| word |binary|.
+  // Returns nullptr if the binary does not parse; errors are communicated
+  // through |consumer|.
+  static std::unique_ptr<ColumnarModule> Build(spv_target_env env,
+                                               MessageConsumer consumer,
+                                               const uint32_t* binary,
+                                               size_t word_count);
+
+  uint32_t NumInstructions() const {
+    return static_cast<uint32_t>(opcodes_.size());
+  }
+  Inst GetInst(uint32_t index) const {
+    assert(index < NumInstructions() && "instruction index out of bound");
+    return Inst(this, index);
+  }
+
+  // Returns the id bound from the module header. Defs and uses of every id
+  // fit in arrays of this size.
+  uint32_t IdBound() const { return id_bound_; }
+
+  // Returns the index of the instruction defining |id|, or kNoInst if the
+  // module does not define it.
+  uint32_t GetDefIndex(uint32_t id) const {
+    assert(id < id_bound_ && "id out of bound");
+    return defs_[id];
+  }
+
+ private:
+  ColumnarModule() = default;
+
+  // Callbacks meeting the interface requirements of spvBinaryParse().
+  static spv_result_t SetHeader(void* module, spv_endianness_t,
+                                uint32_t magic, uint32_t version,
+                                uint32_t generator, uint32_t id_bound,
+                                uint32_t reserved);
+  static spv_result_t AddInst(void* module,
+                              const spv_parsed_instruction_t* inst);
+
+  uint32_t id_bound_ = 0;
+  // Shared pool holding the words of every instruction in module order.
+  std::vector<uint32_t> words_;
+  // One entry per instruction, in module order.
+  std::vector<uint16_t> opcodes_;
+  std::vector<uint32_t> result_ids_;
+  std::vector<uint32_t> type_ids_;
+  // operand_starts_[i] is the index into operand_offsets_ of instruction
+  // |i|'s first input operand; the vector has one trailing sentinel entry so
+  // operand_starts_[i + 1] is always the end.
+  std::vector<uint32_t> operand_starts_;
+  // Word-pool offset of the first word of each logical input operand, and
+  // whether that operand is an id, across all instructions.
+  std::vector<uint32_t> operand_offsets_;
+  std::vector<uint8_t> operand_is_id_;
+  // defs_[id] is the index of the instruction defining |id|, or kNoInst.
+  std::vector<uint32_t> defs_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_COLUMNAR_MODULE_H_
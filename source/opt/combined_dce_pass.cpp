@@ -0,0 +1,82 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/combined_dce_pass.h"
+
+#include "source/opt/aggressive_dead_code_elim_pass.h"
+#include "source/opt/eliminate_dead_members_pass.h"
+#include "source/opt/vector_dce.h"
+
+namespace spvtools {
+namespace opt {
+
+Pass::Status CombinedDcePass::RunSubPass(Pass* pass) {
+  pass->SetMessageConsumer(consumer());
+  return pass->Run(context());
+}
+
+Pass::Status CombinedDcePass::Process() {
+  Status status = Status::SuccessWithoutChange;
+
+  // A pass instance may only run once, so each round builds fresh engines.
+  // An engine is scheduled when another engine has changed the module since
+  // its last run: its removals may have exposed dead code at this engine's
+  // granularity.
+  bool run_instruction_dce = true;
+  bool run_vector_dce = true;
+  bool run_member_dce = true;
+
+  while (run_instruction_dce || run_vector_dce || run_member_dce) {
+    if (run_instruction_dce) {
+      run_instruction_dce = false;
+      AggressiveDCEPass adce(preserve_interface_, remove_outputs_);
+      const Status sub_status = RunSubPass(&adce);
+      if (sub_status == Status::Failure) return sub_status;
+      if (sub_status == Status::SuccessWithChange) {
+        status = Status::SuccessWithChange;
+        run_vector_dce = true;
+        run_member_dce = true;
+      }
+    }
+
+    if (run_vector_dce) {
+      run_vector_dce = false;
+      VectorDCE vector_dce;
+      const Status sub_status = RunSubPass(&vector_dce);
+      if (sub_status == Status::Failure) return sub_status;
+      if (sub_status == Status::SuccessWithChange) {
+        status = Status::SuccessWithChange;
+        run_instruction_dce = true;
+        run_member_dce = true;
+      }
+    }
+
+    if (run_member_dce) {
+      run_member_dce = false;
+      EliminateDeadMembersPass member_dce;
+      const Status sub_status = RunSubPass(&member_dce);
+      if (sub_status == Status::Failure) return sub_status;
+      if (sub_status == Status::SuccessWithChange) {
+        status = Status::SuccessWithChange;
+        run_instruction_dce = true;
+        run_vector_dce = true;
+      }
+    }
+  }
+
+  return status;
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_COMBINED_DCE_PASS_H_
+#define SOURCE_OPT_COMBINED_DCE_PASS_H_
+
+#include "source/opt/ir_context.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Runs dead code elimination at instruction granularity (aggressive DCE),
+// vector component granularity (vector DCE), and struct member granularity
+// (dead member elimination) to a combined fixed point inside one pass
+// invocation.
+//
+// Each engine is re-run only when another engine has changed the module
+// since its last run, since only then can new opportunities have cascaded
+// across granularities.  Every re-run is triggered by a strict shrink of
+// the module, so the fixed point is reached after a bounded number of
+// rounds.  This replaces scheduling the three passes in a pipeline loop,
+// which re-runs all of them whenever any of them makes progress.
+class CombinedDcePass : public Pass {
+ public:
+  // |preserve_interface| and |remove_outputs| are forwarded to the
+  // instruction-granularity engine; see AggressiveDCEPass.
+  CombinedDcePass(bool preserve_interface = false, bool remove_outputs = false)
+      : preserve_interface_(preserve_interface),
+        remove_outputs_(remove_outputs) {}
+
+  const char* name() const override { return "combined-dce"; }
+  Status Process() override;
+
+  IRContext::Analysis GetPreservedAnalyses() override {
+    // The intersection of what the three engines preserve.
+    return IRContext::kAnalysisDefUse | IRContext::kAnalysisInstrToBlockMapping;
+  }
+
+ private:
+  // Runs a fresh instance of |pass| over the module.  Returns its status.
+  Status RunSubPass(Pass* pass);
+
+  bool preserve_interface_;
+  bool remove_outputs_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_COMBINED_DCE_PASS_H_
@@ -15,7 +15,7 @@
 #include "source/opt/compact_ids_pass.h"
 
 #include <cassert>
-#include <unordered_map>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 
@@ -23,26 +23,33 @@ namespace spvtools {
 namespace opt {
 namespace {
 
-// Returns the remapped id of |id| from |result_id_mapping|. If the remapped
-// id does not exist, adds a new one to |result_id_mapping| and returns it.
-uint32_t GetRemappedId(
-    std::unordered_map<uint32_t, uint32_t>* result_id_mapping, uint32_t id) {
-  auto it = result_id_mapping->find(id);
-  if (it == result_id_mapping->end()) {
-    const uint32_t new_id =
-        static_cast<uint32_t>(result_id_mapping->size()) + 1;
-    const auto insertion_result = result_id_mapping->emplace(id, new_id);
-    it = insertion_result.first;
-    assert(insertion_result.second);
+// Returns the remapped id of |id| from |result_id_mapping|, a dense table
+// indexed directly by the original id (0 marks an id not seen yet).  If |id|
+// has no remapped id, assigns it the next compact id, |*next_id| + 1.
+uint32_t GetRemappedId(std::vector<uint32_t>* result_id_mapping,
+                       uint32_t* next_id, uint32_t id) {
+  if (id >= result_id_mapping->size()) {
+    // Ids at or above the module's declared bound should not occur, but grow
+    // the table rather than read out of bounds on an invalid module.
+    result_id_mapping->resize(id + 1, 0);
   }
-  return it->second;
+  uint32_t& new_id = (*result_id_mapping)[id];
+  if (new_id == 0) {
+    new_id = ++*next_id;
+  }
+  return new_id;
 }
 
 }  // namespace
 
 Pass::Status CompactIdsPass::Process() {
   bool modified = false;
-  std::unordered_map<uint32_t, uint32_t> result_id_mapping;
+  // Ids are remapped in order of first use, so the table is consulted for
+  // every operand of every instruction.  A dense vector indexed by the
+  // original id keeps each of those lookups a single array access; on a
+  // module whose ids are already compact the sweep then rewrites nothing.
+  std::vector<uint32_t> result_id_mapping(context()->module()->id_bound(), 0);
+  uint32_t next_id = 0;
 
   // Disable automatic DebugInfo analysis for the life of the CompactIds pass.
   // The DebugInfo manager requires the SPIR-V to be valid to run, but this is
@@ -50,14 +57,14 @@ Pass::Status CompactIdsPass::Process() {
   context()->InvalidateAnalyses(IRContext::kAnalysisDebugInfo);
 
   context()->module()->ForEachInst(
-      [&result_id_mapping, &modified](Instruction* inst) {
+      [&result_id_mapping, &next_id, &modified](Instruction* inst) {
         auto operand = inst->begin();
         while (operand != inst->end()) {
           const auto type = operand->type;
           if (spvIsIdType(type)) {
             assert(operand->words.size() == 1);
             uint32_t& id = operand->words[0];
-            uint32_t new_id = GetRemappedId(&result_id_mapping, id);
+            uint32_t new_id = GetRemappedId(&result_id_mapping, &next_id, id);
             if (id != new_id) {
               modified = true;
               id = new_id;
@@ -74,7 +81,8 @@ Pass::Status CompactIdsPass::Process() {
 
         uint32_t scope_id = inst->GetDebugScope().GetLexicalScope();
         if (scope_id != kNoDebugScope) {
-          uint32_t new_id = GetRemappedId(&result_id_mapping, scope_id);
+          uint32_t new_id =
+              GetRemappedId(&result_id_mapping, &next_id, scope_id);
           if (scope_id != new_id) {
             inst->UpdateLexicalScope(new_id);
             modified = true;
@@ -82,7 +90,8 @@ Pass::Status CompactIdsPass::Process() {
         }
         uint32_t inlinedat_id = inst->GetDebugInlinedAt();
         if (inlinedat_id != kNoInlinedAt) {
-          uint32_t new_id = GetRemappedId(&result_id_mapping, inlinedat_id);
+          uint32_t new_id =
+              GetRemappedId(&result_id_mapping, &next_id, inlinedat_id);
           if (inlinedat_id != new_id) {
             inst->UpdateDebugInlinedAt(new_id);
             modified = true;
@@ -91,10 +100,9 @@ Pass::Status CompactIdsPass::Process() {
       },
       true);
 
-  if (context()->module()->id_bound() != result_id_mapping.size() + 1) {
+  if (context()->module()->id_bound() != next_id + 1) {
     modified = true;
-    context()->module()->SetIdBound(
-        static_cast<uint32_t>(result_id_mapping.size() + 1));
+    context()->module()->SetIdBound(next_id + 1);
     // There are ids in the feature manager that could now be invalid
     context()->ResetFeatureManager();
   }
@@ -705,6 +705,81 @@ ConstantFoldingRule FoldFPBinaryOp(BinaryScalarFoldingRule scalar_rule) {
   };
 }
 
+// Folds componentwise floating-point arithmetic on a pair of vector constants
+// by applying |op| to the raw component values gathered into flat arrays.
+// Intermediate results stay in those arrays; |analysis::Constant| objects are
+// only materialized for the components of the final result.  Returns |nullptr|
+// if the element type is not a 32-bit or 64-bit float.
+template <typename Op>
+const analysis::Constant* FoldFPVectorArithOp(
+    Op op, const analysis::Vector* vector_type,
+    const std::vector<const analysis::Constant*>& a_components,
+    const std::vector<const analysis::Constant*>& b_components,
+    analysis::ConstantManager* const_mgr) {
+  const analysis::Type* element_type = vector_type->element_type();
+  const analysis::Float* float_type = element_type->AsFloat();
+  if (float_type == nullptr) {
+    return nullptr;
+  }
+
+  std::vector<uint32_t> ids;
+  ids.reserve(a_components.size());
+  if (float_type->width() == 32) {
+    std::vector<float> results(a_components.size());
+    for (size_t i = 0; i < a_components.size(); ++i) {
+      results[i] = op(a_components[i]->GetFloat(), b_components[i]->GetFloat());
+    }
+    for (float result : results) {
+      utils::FloatProxy<float> proxy(result);
+      const analysis::Constant* element =
+          const_mgr->GetConstant(element_type, proxy.GetWords());
+      ids.push_back(const_mgr->GetDefiningInstruction(element)->result_id());
+    }
+  } else if (float_type->width() == 64) {
+    std::vector<double> results(a_components.size());
+    for (size_t i = 0; i < a_components.size(); ++i) {
+      results[i] =
+          op(a_components[i]->GetDouble(), b_components[i]->GetDouble());
+    }
+    for (double result : results) {
+      utils::FloatProxy<double> proxy(result);
+      const analysis::Constant* element =
+          const_mgr->GetConstant(element_type, proxy.GetWords());
+      ids.push_back(const_mgr->GetDefiningInstruction(element)->result_id());
+    }
+  } else {
+    return nullptr;
+  }
+  return const_mgr->GetConstant(vector_type, ids);
+}
+
+// Returns a |ConstantFoldingRule| for componentwise floating-point arithmetic.
+// Scalars fold through |scalar_rule| as in |FoldFPBinaryOp|; vectors take a
+// batched path that applies |op| directly to the raw component values instead
+// of folding one |analysis::Constant| at a time.
+template <typename Op>
+ConstantFoldingRule FoldFPArithOp(BinaryScalarFoldingRule scalar_rule, Op op) {
+  return [scalar_rule, op](
+             IRContext* context, Instruction* inst,
+             const std::vector<const analysis::Constant*>& constants)
+             -> const analysis::Constant* {
+    if (!inst->IsFloatingPointFoldingAllowed()) {
+      return nullptr;
+    }
+    if (constants[0] != nullptr && constants[1] != nullptr) {
+      analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+      const analysis::Type* result_type =
+          context->get_type_mgr()->GetType(inst->type_id());
+      if (const analysis::Vector* vector_type = result_type->AsVector()) {
+        return FoldFPVectorArithOp(
+            op, vector_type, constants[0]->GetVectorComponents(const_mgr),
+            constants[1]->GetVectorComponents(const_mgr), const_mgr);
+      }
+    }
+    return FoldFPBinaryOp(scalar_rule, inst->type_id(), constants, context);
+  };
+}
+
 // This macro defines a |UnaryScalarFoldingRule| that performs float to
 // integer conversion.
 // TODO(greg-lunarg): Support for 64-bit integer types.
@@ -830,9 +905,18 @@ ConstantFoldingRule FoldQuantizeToF16() {
 
 // Define the folding rules for subtraction, addition, multiplication, and
 // division for floating point values.
-ConstantFoldingRule FoldFSub() { return FoldFPBinaryOp(FOLD_FPARITH_OP(-)); }
-ConstantFoldingRule FoldFAdd() { return FoldFPBinaryOp(FOLD_FPARITH_OP(+)); }
-ConstantFoldingRule FoldFMul() { return FoldFPBinaryOp(FOLD_FPARITH_OP(*)); }
+ConstantFoldingRule FoldFSub() {
+  return FoldFPArithOp(FOLD_FPARITH_OP(-),
+                       [](auto a, auto b) { return a - b; });
+}
+ConstantFoldingRule FoldFAdd() {
+  return FoldFPArithOp(FOLD_FPARITH_OP(+),
+                       [](auto a, auto b) { return a + b; });
+}
+ConstantFoldingRule FoldFMul() {
+  return FoldFPArithOp(FOLD_FPARITH_OP(*),
+                       [](auto a, auto b) { return a * b; });
+}
 
 // Returns the constant that results from evaluating |numerator| / 0.0.  Returns
 // |nullptr| if the result could not be evaluated.
@@ -1645,6 +1729,60 @@ void ConstantFoldingRules::AddFoldingRules() {
         FoldFPBinaryOp(FoldFTranscendentalBinary(std::atan2)));
     ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Pow}].push_back(
         FoldFPBinaryOp(FoldFTranscendentalBinary(std::pow)));
+
+    // The rounding, sign, and unit-conversion instructions fold through the
+    // same scalar machinery as the transcendentals.  The shims cover the
+    // cases with no direct <cmath> counterpart.  RoundEven relies on
+    // nearbyint under the default round-to-nearest-even mode.
+    auto fsign_shim = [](double v) -> double {
+      if (v > 0.0) return 1.0;
+      if (v < 0.0) return -1.0;
+      return 0.0;
+    };
+    auto fract_shim = [](double v) -> double { return v - std::floor(v); };
+    auto inverse_sqrt_shim = [](double v) -> double {
+      return 1.0 / std::sqrt(v);
+    };
+    auto radians_shim = [](double v) -> double {
+      return v * (3.14159265358979323846 / 180.0);
+    };
+    auto degrees_shim = [](double v) -> double {
+      return v * (180.0 / 3.14159265358979323846);
+    };
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Round}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::round)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450RoundEven}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::nearbyint)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Trunc}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::trunc)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450FAbs}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::fabs)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450FSign}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(fsign_shim)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Floor}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::floor)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Ceil}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::ceil)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Fract}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(fract_shim)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450InverseSqrt}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(inverse_sqrt_shim)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Radians}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(radians_shim)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Degrees}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(degrees_shim)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Sinh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::sinh)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Cosh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::cosh)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Tanh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::tanh)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Asinh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::asinh)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Acosh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::acosh)));
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Atanh}].push_back(
+        FoldFPUnaryOp(FoldFTranscendentalUnary(std::atanh)));
   }
 }
 }  // namespace opt
@@ -15,6 +15,7 @@
 #ifndef SOURCE_OPT_CONST_FOLDING_RULES_H_
 #define SOURCE_OPT_CONST_FOLDING_RULES_H_
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
@@ -88,17 +89,18 @@ class ConstantFoldingRules {
   // Returns true if there is at least 1 folding rule for |inst|.
   const std::vector<ConstantFoldingRule>& GetRulesForInstruction(
       const Instruction* inst) const {
+    if (!index_built_) BuildIndex();
     if (inst->opcode() != spv::Op::OpExtInst) {
-      auto it = rules_.find(inst->opcode());
-      if (it != rules_.end()) {
-        return it->second.value;
+      const uint32_t opcode = static_cast<uint32_t>(inst->opcode());
+      if (opcode < opcode_index_.size() && opcode_index_[opcode]) {
+        return opcode_index_[opcode]->value;
       }
     } else {
       uint32_t ext_inst_id = inst->GetSingleWordInOperand(0);
       uint32_t ext_opcode = inst->GetSingleWordInOperand(1);
-      auto it = ext_rules_.find({ext_inst_id, ext_opcode});
-      if (it != ext_rules_.end()) {
-        return it->second.value;
+      auto it = ext_index_.find((uint64_t(ext_inst_id) << 32) | ext_opcode);
+      if (it != ext_index_.end()) {
+        return it->second->value;
       }
     }
     return empty_vector_;
@@ -122,12 +124,38 @@ class ConstantFoldingRules {
   std::map<Key, Value> ext_rules_;
 
  private:
+  // Builds the dense dispatch index over |rules_| and |ext_rules_| so a
+  // lookup is an array load instead of a hash probe.  All rules must be
+  // registered before the first lookup: the index is built once and does not
+  // observe later insertions.  The rule sets live in node-based maps, so the
+  // cached pointers stay valid.
+  void BuildIndex() const {
+    uint32_t max_opcode = 0;
+    for (const auto& kv : rules_) {
+      max_opcode = std::max(max_opcode, static_cast<uint32_t>(kv.first));
+    }
+    opcode_index_.assign(max_opcode + 1, nullptr);
+    for (const auto& kv : rules_) {
+      opcode_index_[static_cast<uint32_t>(kv.first)] = &kv.second;
+    }
+    for (const auto& kv : ext_rules_) {
+      ext_index_[(uint64_t(kv.first.instruction_set) << 32) |
+                 kv.first.opcode] = &kv.second;
+    }
+    index_built_ = true;
+  }
+
   // The context that the instruction to be folded will be a part of.
   IRContext* context_;
 
   // The empty set of rules to be used as the default return value in
   // |GetRulesForInstruction|.
   std::vector<ConstantFoldingRule> empty_vector_;
+
+  // Dense dispatch index, built lazily by the first lookup.
+  mutable std::vector<const Value*> opcode_index_;
+  mutable std::unordered_map<uint64_t, const Value*> ext_index_;
+  mutable bool index_built_ = false;
 };
 
 }  // namespace opt
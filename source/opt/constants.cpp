@@ -21,6 +21,30 @@
 namespace spvtools {
 namespace opt {
 namespace analysis {
+namespace {
+
+// Returns true and fills |key| if a constant of |type| defined by
+// |literal_words| can use the scalar fast path of the constant pool: a Bool,
+// Integer or Float constant of at most two words.
+bool MakeScalarConstantKey(const Type* type,
+                           const std::vector<uint32_t>& literal_words,
+                           ScalarConstantKey* key) {
+  if (literal_words.empty() || literal_words.size() > 2) {
+    return false;
+  }
+  if (!type->AsBool() && !type->AsInteger() && !type->AsFloat()) {
+    return false;
+  }
+  key->type = type;
+  key->value = literal_words[0];
+  if (literal_words.size() == 2) {
+    key->value |= static_cast<uint64_t>(literal_words[1]) << 32;
+  }
+  key->num_words = static_cast<uint32_t>(literal_words.size());
+  return true;
+}
+
+}  // namespace
 
 float Constant::GetFloat() const {
   assert(type()->AsFloat() != nullptr && type()->AsFloat()->width() == 32);
@@ -144,12 +168,29 @@ int64_t Constant::GetSignExtendedValue() const {
 ConstantManager::ConstantManager(IRContext* ctx) : ctx_(ctx) {
   // Populate the constant table with values from constant declarations in the
   // module.  The values of each OpConstant declaration is the identity
-  // assignment (i.e., each constant is its own value).
-  for (const auto& inst : ctx_->module()->GetConstants()) {
+  // assignment (i.e., each constant is its own value).  Size the tables up
+  // front so that mapping the module's constants does not rehash, and size
+  // the id-indexed table by the module's id bound so that mapping existing
+  // constants never grows it.
+  const auto constants = ctx_->module()->GetConstants();
+  const_pool_.reserve(constants.size());
+  scalar_pool_.reserve(constants.size());
+  const_val_to_id_.reserve(constants.size());
+  id_to_const_val_.resize(ctx_->module()->IdBound(), nullptr);
+  for (const auto& inst : constants) {
     MapInst(inst);
   }
 }
 
+void ConstantManager::AddScalarToPool(const Constant* cst) {
+  const ScalarConstant* scalar = cst->AsScalarConstant();
+  ScalarConstantKey key;
+  if (scalar != nullptr &&
+      MakeScalarConstantKey(scalar->type(), scalar->words(), &key)) {
+    scalar_pool_.insert({key, cst});
+  }
+}
+
 Type* ConstantManager::GetType(const Instruction* inst) const {
   return context()->get_type_mgr()->GetType(inst->type_id());
 }
@@ -386,6 +427,16 @@ std::unique_ptr<Instruction> ConstantManager::CreateCompositeInstruction(
 
 const Constant* ConstantManager::GetConstant(
     const Type* type, const std::vector<uint32_t>& literal_words_or_ids) {
+  // For small scalars, probe the pool with an inline key before allocating a
+  // Constant instance: these lookups dominate constant folding and usually
+  // hit an existing constant.
+  ScalarConstantKey key;
+  if (MakeScalarConstantKey(type, literal_words_or_ids, &key)) {
+    auto it = scalar_pool_.find(key);
+    if (it != scalar_pool_.end()) {
+      return it->second;
+    }
+  }
   auto cst = CreateConstant(type, literal_words_or_ids);
   return cst ? RegisterConstant(std::move(cst)) : nullptr;
 }
@@ -16,7 +16,6 @@
 #define SOURCE_OPT_CONSTANTS_H_
 
 #include <cinttypes>
-#include <map>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -26,6 +25,7 @@
 #include "source/opt/module.h"
 #include "source/opt/type_manager.h"
 #include "source/opt/types.h"
+#include "source/util/hash_combine.h"
 #include "source/util/hex_float.h"
 #include "source/util/make_unique.h"
 
@@ -446,32 +446,22 @@ class NullConstant : public Constant {
 // Hash function for Constant instances. Use the structure of the constant as
 // the key.
 struct ConstantHash {
-  void add_pointer(std::u32string* h, const void* p) const {
-    uint64_t ptr_val = reinterpret_cast<uint64_t>(p);
-    h->push_back(static_cast<uint32_t>(ptr_val >> 32));
-    h->push_back(static_cast<uint32_t>(ptr_val));
-  }
-
   size_t operator()(const Constant* const_val) const {
-    std::u32string h;
-    add_pointer(&h, const_val->type());
+    size_t hash = utils::hash_combine(
+        0, reinterpret_cast<uintptr_t>(const_val->type()));
     if (const auto scalar = const_val->AsScalarConstant()) {
-      for (const auto& w : scalar->words()) {
-        h.push_back(w);
-      }
+      return utils::hash_combine(hash, scalar->words());
     } else if (const auto composite = const_val->AsCompositeConstant()) {
       for (const auto& c : composite->GetComponents()) {
-        add_pointer(&h, c);
+        hash = utils::hash_combine(hash, reinterpret_cast<uintptr_t>(c));
       }
+      return hash;
     } else if (const_val->AsNullConstant()) {
-      h.push_back(0);
-    } else {
-      assert(
-          false &&
-          "Tried to compute the hash value of an invalid Constant instance.");
+      return utils::hash_combine(hash, 0u);
     }
-
-    return std::hash<std::u32string>()(h);
+    assert(false &&
+           "Tried to compute the hash value of an invalid Constant instance.");
+    return hash;
   }
 };
 
@@ -498,6 +488,28 @@ struct ConstantEqual {
   }
 };
 
+// Key for the scalar fast path of the constant pool: a Bool, Integer or Float
+// constant of at most 64 bits is identified by its type and its literal words
+// held inline, so it can be interned without allocating a temporary Constant
+// instance first.
+struct ScalarConstantKey {
+  const Type* type;
+  uint64_t value;
+  uint32_t num_words;
+
+  bool operator==(const ScalarConstantKey& that) const {
+    return type == that.type && value == that.value &&
+           num_words == that.num_words;
+  }
+};
+
+struct ScalarConstantKeyHash {
+  size_t operator()(const ScalarConstantKey& key) const {
+    return utils::hash_combine(0, reinterpret_cast<uintptr_t>(key.type),
+                               key.value, key.num_words);
+  }
+};
+
 // This class represents a pool of constants.
 class ConstantManager {
  public:
@@ -577,8 +589,7 @@ class ConstantManager {
   // Returns the pointer to the Constant instance in case it is found.
   // Otherwise, it returns a null pointer.
   const Constant* FindDeclaredConstant(uint32_t id) const {
-    auto iter = id_to_const_val_.find(id);
-    return (iter != id_to_const_val_.end()) ? iter->second : nullptr;
+    return (id < id_to_const_val_.size()) ? id_to_const_val_[id] : nullptr;
   }
 
   // A helper function to get the id of a collected constant with the pointer
@@ -601,6 +612,7 @@ class ConstantManager {
   const Constant* RegisterConstant(std::unique_ptr<Constant> cst) {
     auto ret = const_pool_.insert(cst.get());
     if (ret.second) {
+      AddScalarToPool(cst.get());
       owned_constants_.emplace_back(std::move(cst));
     }
     return *ret.first;
@@ -629,18 +641,31 @@ class ConstantManager {
   }
 
   void RemoveId(uint32_t id) {
-    auto it = id_to_const_val_.find(id);
-    if (it != id_to_const_val_.end()) {
-      const_val_to_id_.erase(it->second);
-      id_to_const_val_.erase(it);
+    if (id >= id_to_const_val_.size() || id_to_const_val_[id] == nullptr) {
+      return;
     }
+    // Constants are interned, so other ids may map to the same Constant
+    // instance; drop only the mirror entry for |id|.
+    auto range = const_val_to_id_.equal_range(id_to_const_val_[id]);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == id) {
+        const_val_to_id_.erase(it);
+        break;
+      }
+    }
+    id_to_const_val_[id] = nullptr;
   }
 
   // Records a new mapping between |inst| and |const_value|. This updates the
   // two mappings |id_to_const_val_| and |const_val_to_id_|.
   void MapConstantToInst(const Constant* const_value, Instruction* inst) {
-    if (id_to_const_val_.insert({inst->result_id(), const_value}).second) {
-      const_val_to_id_.insert({const_value, inst->result_id()});
+    const uint32_t id = inst->result_id();
+    if (id >= id_to_const_val_.size()) {
+      id_to_const_val_.resize(id + 1, nullptr);
+    }
+    if (id_to_const_val_[id] == nullptr) {
+      id_to_const_val_[id] = const_value;
+      const_val_to_id_.insert({const_value, id});
     }
   }
 
@@ -708,24 +733,39 @@ class ConstantManager {
       uint32_t result_id, const CompositeConstant* cc,
       uint32_t type_id = 0) const;
 
+  // Adds |cst| to |scalar_pool_| if it is a scalar constant of at most 64
+  // bits.  Other constants are left to the generic |const_pool_| only.
+  void AddScalarToPool(const Constant* cst);
+
   // IR context that owns this constant manager.
   IRContext* ctx_;
 
   // A mapping from the result ids of Normal Constants to their
-  // Constant instances. All Normal Constants in the module, either
-  // existing ones before optimization or the newly generated ones, should have
-  // their Constant instance stored and their result id registered in this map.
-  std::unordered_map<uint32_t, const Constant*> id_to_const_val_;
+  // Constant instances, held as a flat vector indexed by result id.  Module
+  // id spaces are dense, so a direct index beats hashing on this lookup,
+  // which is on the hot path of both folding engines.  Ids that do not name
+  // a Normal Constant hold nullptr.  All Normal Constants in the module,
+  // either existing ones before optimization or the newly generated ones,
+  // should have their Constant instance stored and their result id
+  // registered here.
+  std::vector<const Constant*> id_to_const_val_;
 
   // A mapping from the Constant instance of Normal Constants to their
-  // result id in the module. This is a mirror map of |id_to_const_val_|. All
-  // Normal Constants that defining instructions in the module should have
-  // their Constant and their result id registered here.
-  std::multimap<const Constant*, uint32_t> const_val_to_id_;
+  // result id in the module. This is a mirror map of |id_to_const_val_|.
+  // Constants are interned in |const_pool_|, so the keys are canonical
+  // pointers and a probe hashes the pointer value without inspecting the
+  // constant itself.
+  std::unordered_multimap<const Constant*, uint32_t> const_val_to_id_;
 
   // The constant pool.  All created constants are registered here.
   std::unordered_set<const Constant*, ConstantHash, ConstantEqual> const_pool_;
 
+  // Interning table for scalar constants of at most 64 bits.  Entries mirror
+  // |const_pool_| and let |GetConstant| find an existing scalar from its
+  // literal words without building a temporary Constant instance.
+  std::unordered_map<ScalarConstantKey, const Constant*, ScalarConstantKeyHash>
+      scalar_pool_;
+
   // The constant that are owned by the constant manager.  Every constant in
   // |const_pool_| should be in |owned_constants_| as well.
   std::vector<std::unique_ptr<Constant>> owned_constants_;
@@ -14,9 +14,11 @@
 
 #include "source/opt/copy_prop_arrays.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "source/opt/ir_builder.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace opt {
@@ -38,7 +40,19 @@ bool IsDebugDeclareOrValue(Instruction* di) {
 }  // namespace
 
 Pass::Status CopyPropagateArrays::Process() {
-  bool modified = false;
+  // A variable with a single whole-object store, and the source object the
+  // analysis phase found for it, if any.
+  struct Candidate {
+    Instruction* var_inst;
+    Instruction* store_inst;
+    std::unique_ptr<MemoryObject> source_object;
+  };
+
+  // Phase 1: collect the candidate variables.  This runs single threaded, so
+  // it also forces every analysis the parallel phase reads (def-use, types,
+  // constants, block mapping, dominators) to be built up front.
+  std::vector<Candidate> candidates;
+  get_constant_mgr();
   for (Function& function : *get_module()) {
     if (function.IsDeclaration()) {
       continue;
@@ -59,15 +73,57 @@ Pass::Status CopyPropagateArrays::Process() {
         continue;
       }
 
-      std::unique_ptr<MemoryObject> source_object =
-          FindSourceObjectIfPossible(&*var_inst, store_inst);
+      context()->get_instr_block(store_inst);
+      // A dominance query materializes the lazily built dominator tree, so
+      // the parallel phase never builds one.
+      context()->GetDominatorAnalysis(&function)->Dominates(store_inst,
+                                                            store_inst);
+      candidates.push_back({&*var_inst, store_inst, nullptr});
+    }
+  }
 
-      if (source_object != nullptr) {
-        if (CanUpdateUses(&*var_inst, source_object->GetPointerTypeId(this))) {
-          modified = true;
-          PropagateObject(&*var_inst, source_object.get(), store_inst);
-        }
-      }
+  // Phase 2: analyze the candidates.  FindSourceObjectIfPossible only reads
+  // the analyses built above, and each candidate's analysis is independent,
+  // so the candidates can be farmed out across worker threads.  The result
+  // stays valid across the rewrites in phase 3: a propagation target has a
+  // store while every variable an analysis inspects is store-free, so no
+  // rewrite touches an instruction another candidate's analysis depends on.
+  const size_t num_threads = std::min(max_threads(), candidates.size());
+  if (num_threads <= 1) {
+    for (Candidate& candidate : candidates) {
+      candidate.source_object =
+          FindSourceObjectIfPossible(candidate.var_inst, candidate.store_inst);
+    }
+  } else {
+    utils::ThreadPool pool(num_threads);
+    for (Candidate& candidate : candidates) {
+      Candidate* c = &candidate;
+      pool.Schedule([this, c] {
+        c->source_object =
+            FindSourceObjectIfPossible(c->var_inst, c->store_inst);
+      });
+    }
+    pool.Wait();
+  }
+
+  // Phase 3: rewrite the uses serially.  CanUpdateUses stays here because it
+  // can create the new pointer types it checks for.
+  bool modified = false;
+  for (Candidate& candidate : candidates) {
+    if (candidate.source_object == nullptr) {
+      continue;
+    }
+    if (CanUpdateUses(candidate.var_inst,
+                      candidate.source_object->GetPointerTypeId(this))) {
+      modified = true;
+      // UpdateUses rewrites whole trees of uses and re-analyzes each
+      // rewritten instruction.  Batch the def-use maintenance so every
+      // instruction is re-analyzed once when the propagation finishes.
+      // The batch must close before the next variable is rewritten.
+      context()->BeginDefUseBatch();
+      PropagateObject(candidate.var_inst, candidate.source_object.get(),
+                      candidate.store_inst);
+      context()->CommitDefUseBatch();
     }
   }
   return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
@@ -27,30 +27,6 @@ bool DataFlowAnalysis::Enqueue(Instruction* inst) {
   return true;
 }
 
-DataFlowAnalysis::VisitResult DataFlowAnalysis::RunOnce(
-    Function* function, bool is_first_iteration) {
-  InitializeWorklist(function, is_first_iteration);
-  VisitResult ret = VisitResult::kResultFixed;
-  while (!worklist_.empty()) {
-    Instruction* top = worklist_.front();
-    worklist_.pop();
-    on_worklist_[top] = false;
-    VisitResult result = Visit(top);
-    if (result == VisitResult::kResultChanged) {
-      EnqueueSuccessors(top);
-      ret = VisitResult::kResultChanged;
-    }
-  }
-  return ret;
-}
-
-void DataFlowAnalysis::Run(Function* function) {
-  VisitResult result = RunOnce(function, true);
-  while (result == VisitResult::kResultChanged) {
-    result = RunOnce(function, false);
-  }
-}
-
 void ForwardDataFlowAnalysis::InitializeWorklist(Function* function,
                                                  bool /*is_first_iteration*/) {
   context().cfg()->ForEachBlockInReversePostOrder(
@@ -15,6 +15,7 @@
 #ifndef SOURCE_OPT_DATAFLOW_H_
 #define SOURCE_OPT_DATAFLOW_H_
 
+#include <cassert>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -48,7 +49,7 @@ class DataFlowAnalysis {
 
   // Run this analysis on a given function.
   // For analyses which work interprocedurally, |function| may be ignored.
-  void Run(Function* function);
+  void Run(Function* function) { RunImpl(this, function); }
 
  protected:
   DataFlowAnalysis(IRContext& context) : context_(context) {}
@@ -77,10 +78,44 @@ class DataFlowAnalysis {
 
   IRContext& context() { return context_; }
 
+  // The fixpoint loop, parameterized on the static type of the analysis.
+  // |analysis| must be |this|. When called with the concrete analysis type -
+  // and the concrete class declares its |InitializeWorklist|,
+  // |EnqueueSuccessors| and |Visit| overrides |final| - the per-instruction
+  // hook calls bind directly and the transfer function inlines into the loop,
+  // instead of costing a virtual dispatch per visit. |Run| above calls this
+  // with the base type, which preserves the fully virtual behavior for
+  // analyses driven polymorphically.
+  template <typename Analysis>
+  void RunImpl(Analysis* analysis, Function* function) {
+    assert(analysis == this);
+    VisitResult result = RunOnceImpl(analysis, function, true);
+    while (result == VisitResult::kResultChanged) {
+      result = RunOnceImpl(analysis, function, false);
+    }
+  }
+
  private:
   // Runs one pass, calling |InitializeWorklist| and then iterating through the
-  // worklist until all fixed.
-  VisitResult RunOnce(Function* function, bool is_first_iteration);
+  // worklist until all fixed. Hook calls are dispatched on the static type of
+  // |analysis|; see |RunImpl|.
+  template <typename Analysis>
+  VisitResult RunOnceImpl(Analysis* analysis, Function* function,
+                          bool is_first_iteration) {
+    analysis->InitializeWorklist(function, is_first_iteration);
+    VisitResult ret = VisitResult::kResultFixed;
+    while (!worklist_.empty()) {
+      Instruction* top = worklist_.front();
+      worklist_.pop();
+      on_worklist_[top] = false;
+      VisitResult result = analysis->Visit(top);
+      if (result == VisitResult::kResultChanged) {
+        analysis->EnqueueSuccessors(top);
+        ret = VisitResult::kResultChanged;
+      }
+    }
+    return ret;
+  }
 
   IRContext& context_;
   std::unordered_map<Instruction*, bool> on_worklist_;
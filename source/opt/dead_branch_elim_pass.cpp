@@ -88,11 +88,12 @@ BasicBlock* DeadBranchElimPass::GetParentBlock(uint32_t id) {
   return context()->get_instr_block(get_def_use_mgr()->GetDef(id));
 }
 
-bool DeadBranchElimPass::MarkLiveBlocks(
-    Function* func, std::unordered_set<BasicBlock*>* live_blocks) {
-  std::vector<std::pair<BasicBlock*, uint32_t>> conditions_to_simplify;
-  std::unordered_set<BasicBlock*> blocks_with_backedge;
-  std::vector<BasicBlock*> stack;
+bool DeadBranchElimPass::MarkLiveBlocks(Function* func,
+                                        BlockSet* live_blocks) {
+  utils::ScratchVector<std::pair<BasicBlock*, uint32_t>>
+      conditions_to_simplify(scratch());
+  BlockSet blocks_with_backedge(scratch());
+  utils::ScratchVector<BasicBlock*> stack(scratch());
   stack.push_back(&*func->begin());
   bool modified = false;
   while (!stack.empty()) {
@@ -190,6 +191,9 @@ bool DeadBranchElimPass::SimplifyBranch(BasicBlock* block,
                                         uint32_t live_lab_id) {
   Instruction* merge_inst = block->GetMergeInst();
   Instruction* terminator = block->terminator();
+  CFG* cfg = context()->AreAnalysesValid(IRContext::kAnalysisCFG)
+                 ? context()->cfg()
+                 : nullptr;
   if (merge_inst && merge_inst->opcode() == spv::Op::OpSelectionMerge) {
     if (merge_inst->NextNode()->opcode() == spv::Op::OpSwitch &&
         SwitchHasNestedBreak(block->id())) {
@@ -200,11 +204,13 @@ bool DeadBranchElimPass::SimplifyBranch(BasicBlock* block,
       }
       // We have to keep the switch because it has a nest break, so we
       // remove all cases except for the live one.
+      if (cfg) cfg->RemoveSuccessorEdges(block);
       Instruction::OperandList new_operands;
       new_operands.push_back(terminator->GetInOperand(0));
       new_operands.push_back({SPV_OPERAND_TYPE_ID, {live_lab_id}});
       terminator->SetInOperands(std::move(new_operands));
       context()->UpdateDefUse(terminator);
+      if (cfg) cfg->AddEdges(block);
     } else {
       // Check if the merge instruction is still needed because of a
       // non-nested break from the construct.  Move the merge instruction if
@@ -217,8 +223,10 @@ bool DeadBranchElimPass::SimplifyBranch(BasicBlock* block,
           cfg_analysis->LoopContinueBlock(live_lab_id),
           cfg_analysis->SwitchMergeBlock(live_lab_id));
 
+      if (cfg) cfg->RemoveSuccessorEdges(block);
       AddBranch(live_lab_id, block);
       context()->KillInst(terminator);
+      if (cfg) cfg->AddEdges(block);
       if (first_break == nullptr) {
         context()->KillInst(merge_inst);
       } else {
@@ -229,16 +237,17 @@ bool DeadBranchElimPass::SimplifyBranch(BasicBlock* block,
       }
     }
   } else {
+    if (cfg) cfg->RemoveSuccessorEdges(block);
     AddBranch(live_lab_id, block);
     context()->KillInst(terminator);
+    if (cfg) cfg->AddEdges(block);
   }
   return true;
 }
 
 void DeadBranchElimPass::MarkUnreachableStructuredTargets(
-    const std::unordered_set<BasicBlock*>& live_blocks,
-    std::unordered_set<BasicBlock*>* unreachable_merges,
-    std::unordered_map<BasicBlock*, BasicBlock*>* unreachable_continues) {
+    const BlockSet& live_blocks, BlockSet* unreachable_merges,
+    BlockToBlockMap* unreachable_continues) {
   for (auto block : live_blocks) {
     if (auto merge_id = block->MergeBlockIdIfAny()) {
       BasicBlock* merge_block = GetParentBlock(merge_id);
@@ -256,8 +265,8 @@ void DeadBranchElimPass::MarkUnreachableStructuredTargets(
 }
 
 bool DeadBranchElimPass::FixPhiNodesInLiveBlocks(
-    Function* func, const std::unordered_set<BasicBlock*>& live_blocks,
-    const std::unordered_map<BasicBlock*, BasicBlock*>& unreachable_continues) {
+    Function* func, const BlockSet& live_blocks,
+    const BlockToBlockMap& unreachable_continues) {
   bool modified = false;
   for (auto& block : *func) {
     if (live_blocks.count(&block)) {
@@ -366,10 +375,13 @@ bool DeadBranchElimPass::FixPhiNodesInLiveBlocks(
 }
 
 bool DeadBranchElimPass::EraseDeadBlocks(
-    Function* func, const std::unordered_set<BasicBlock*>& live_blocks,
-    const std::unordered_set<BasicBlock*>& unreachable_merges,
-    const std::unordered_map<BasicBlock*, BasicBlock*>& unreachable_continues) {
+    Function* func, const BlockSet& live_blocks,
+    const BlockSet& unreachable_merges,
+    const BlockToBlockMap& unreachable_continues) {
   bool modified = false;
+  CFG* cfg = context()->AreAnalysesValid(IRContext::kAnalysisCFG)
+                 ? context()->cfg()
+                 : nullptr;
   for (auto ebi = func->begin(); ebi != func->end();) {
     if (unreachable_continues.count(&*ebi)) {
       uint32_t cont_id = unreachable_continues.find(&*ebi)->second->id();
@@ -377,6 +389,7 @@ bool DeadBranchElimPass::EraseDeadBlocks(
           ebi->terminator()->opcode() != spv::Op::OpBranch ||
           ebi->terminator()->GetSingleWordInOperand(0u) != cont_id) {
         // Make unreachable, but leave the label.
+        if (cfg) cfg->RemoveSuccessorEdges(&*ebi);
         KillAllInsts(&*ebi, false);
         // Add unconditional branch to header.
         assert(unreachable_continues.count(&*ebi));
@@ -385,6 +398,7 @@ bool DeadBranchElimPass::EraseDeadBlocks(
             std::initializer_list<Operand>{{SPV_OPERAND_TYPE_ID, {cont_id}}}));
         get_def_use_mgr()->AnalyzeInstUse(&*ebi->tail());
         context()->set_instr_block(&*ebi->tail(), &*ebi);
+        if (cfg) cfg->AddEdges(&*ebi);
         modified = true;
       }
       ++ebi;
@@ -392,6 +406,7 @@ bool DeadBranchElimPass::EraseDeadBlocks(
       if (ebi->begin() != ebi->tail() ||
           ebi->terminator()->opcode() != spv::Op::OpUnreachable) {
         // Make unreachable, but leave the label.
+        if (cfg) cfg->RemoveSuccessorEdges(&*ebi);
         KillAllInsts(&*ebi, false);
         // Add unreachable terminator.
         ebi->AddInstruction(
@@ -404,6 +419,7 @@ bool DeadBranchElimPass::EraseDeadBlocks(
       ++ebi;
     } else if (!live_blocks.count(&*ebi)) {
       // Kill this block.
+      if (cfg) cfg->ForgetBlock(&*ebi);
       KillAllInsts(&*ebi);
       ebi = ebi.Erase();
       modified = true;
@@ -421,11 +437,24 @@ bool DeadBranchElimPass::EliminateDeadBranches(Function* func) {
   }
 
   bool modified = false;
-  std::unordered_set<BasicBlock*> live_blocks;
+  BlockSet live_blocks(scratch());
   modified |= MarkLiveBlocks(func, &live_blocks);
 
-  std::unordered_set<BasicBlock*> unreachable_merges;
-  std::unordered_map<BasicBlock*, BasicBlock*> unreachable_continues;
+  // The reachability walk doubles as the seed scan: if it rewrote no
+  // terminator and reached every block, the sweeps below cannot change
+  // anything.  Pipelines run this pass several times and later runs
+  // commonly find no work, so skip the per-phi and per-block sweeps then.
+  if (!modified) {
+    size_t block_count = 0;
+    for (auto& bb : *func) {
+      (void)bb;
+      ++block_count;
+    }
+    if (live_blocks.size() == block_count) return false;
+  }
+
+  BlockSet unreachable_merges(scratch());
+  BlockToBlockMap unreachable_continues(scratch());
   MarkUnreachableStructuredTargets(live_blocks, &unreachable_merges,
                                    &unreachable_continues);
   modified |= FixPhiNodesInLiveBlocks(func, live_blocks, unreachable_continues);
@@ -435,11 +464,17 @@ bool DeadBranchElimPass::EliminateDeadBranches(Function* func) {
   return modified;
 }
 
-void DeadBranchElimPass::FixBlockOrder() {
+void DeadBranchElimPass::FixBlockOrder(
+    const std::unordered_set<Function*>& modified_funcs) {
   context()->BuildInvalidAnalyses(IRContext::kAnalysisCFG |
                                   IRContext::kAnalysisDominatorAnalysis);
+  // Functions this pass did not touch still satisfy the ordering rules, so
+  // only the modified ones are reordered.
+
   // Reorders blocks according to DFS of dominator tree.
-  ProcessFunction reorder_dominators = [this](Function* function) {
+  ProcessFunction reorder_dominators = [this,
+                                        &modified_funcs](Function* function) {
+    if (!modified_funcs.count(function)) return false;
     DominatorAnalysis* dominators = context()->GetDominatorAnalysis(function);
     std::vector<BasicBlock*> blocks;
     for (auto iter = dominators->GetDomTree().begin();
@@ -455,7 +490,8 @@ void DeadBranchElimPass::FixBlockOrder() {
   };
 
   // Reorders blocks according to structured order.
-  ProcessFunction reorder_structured = [](Function* function) {
+  ProcessFunction reorder_structured = [&modified_funcs](Function* function) {
+    if (!modified_funcs.count(function)) return false;
     function->ReorderBasicBlocksInStructuredOrder();
     return true;
   };
@@ -476,11 +512,14 @@ Pass::Status DeadBranchElimPass::Process() {
     if (ai.opcode() == spv::Op::OpGroupDecorate)
       return Status::SuccessWithoutChange;
   // Process all entry point functions
-  ProcessFunction pfn = [this](Function* fp) {
-    return EliminateDeadBranches(fp);
+  std::unordered_set<Function*> modified_funcs;
+  ProcessFunction pfn = [this, &modified_funcs](Function* fp) {
+    if (!EliminateDeadBranches(fp)) return false;
+    modified_funcs.insert(fp);
+    return true;
   };
   bool modified = context()->ProcessReachableCallTree(pfn);
-  if (modified) FixBlockOrder();
+  if (modified) FixBlockOrder(modified_funcs);
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
 
@@ -593,13 +632,13 @@ Instruction* DeadBranchElimPass::FindFirstExitFromSelectionMerge(
 
 void DeadBranchElimPass::AddBlocksWithBackEdge(
     uint32_t cont_id, uint32_t header_id, uint32_t merge_id,
-    std::unordered_set<BasicBlock*>* blocks_with_back_edges) {
-  std::unordered_set<uint32_t> visited;
+    BlockSet* blocks_with_back_edges) {
+  utils::ScratchSet<uint32_t> visited(scratch());
   visited.insert(cont_id);
   visited.insert(header_id);
   visited.insert(merge_id);
 
-  std::vector<uint32_t> work_list;
+  utils::ScratchVector<uint32_t> work_list(scratch());
   work_list.push_back(cont_id);
 
   while (!work_list.empty()) {
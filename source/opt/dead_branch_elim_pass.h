@@ -29,6 +29,7 @@
 #include "source/opt/def_use_manager.h"
 #include "source/opt/mem_pass.h"
 #include "source/opt/module.h"
+#include "source/util/scratch_arena.h"
 
 namespace spvtools {
 namespace opt {
@@ -46,10 +47,17 @@ class DeadBranchElimPass : public MemPass {
   IRContext::Analysis GetPreservedAnalyses() override {
     return IRContext::kAnalysisDefUse |
            IRContext::kAnalysisInstrToBlockMapping |
-           IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
+           IRContext::kAnalysisConstants | IRContext::kAnalysisTypes |
+           IRContext::kAnalysisCFG;
   }
 
  private:
+  // Transient containers used while processing a function draw from the
+  // pass's scratch arena (see Pass::scratch()), so their nodes are reclaimed
+  // wholesale instead of being freed one by one.
+  using BlockSet = utils::ScratchSet<BasicBlock*>;
+  using BlockToBlockMap = utils::ScratchMap<BasicBlock*, BasicBlock*>;
+
   // If |condId| is boolean constant, return conditional value in |condVal| and
   // return true, otherwise return false.
   bool GetConstCondition(uint32_t condId, bool* condVal);
@@ -80,8 +88,7 @@ class DeadBranchElimPass : public MemPass {
   // It is careful not to eliminate backedges even if they are dead, but the
   // header is live. Likewise, unreachable merge blocks named in live merge
   // instruction must be retained (though they may be clobbered).
-  bool MarkLiveBlocks(Function* func,
-                      std::unordered_set<BasicBlock*>* live_blocks);
+  bool MarkLiveBlocks(Function* func, BlockSet* live_blocks);
 
   // Checks for unreachable merge and continue blocks with live headers; those
   // blocks must be retained. Continues are tracked separately so that a live
@@ -91,9 +98,8 @@ class DeadBranchElimPass : public MemPass {
   // |unreachable_continues| maps the id of an unreachable continue target to
   // the header block that declares it.
   void MarkUnreachableStructuredTargets(
-      const std::unordered_set<BasicBlock*>& live_blocks,
-      std::unordered_set<BasicBlock*>* unreachable_merges,
-      std::unordered_map<BasicBlock*, BasicBlock*>* unreachable_continues);
+      const BlockSet& live_blocks, BlockSet* unreachable_merges,
+      BlockToBlockMap* unreachable_continues);
 
   // Fix phis in reachable blocks so that only live (or unremovable) incoming
   // edges are present. If the block now only has a single live incoming edge,
@@ -107,10 +113,8 @@ class DeadBranchElimPass : public MemPass {
   //
   // |unreachable_continues| maps continue targets that cannot be reached to
   // merge instruction that declares them.
-  bool FixPhiNodesInLiveBlocks(
-      Function* func, const std::unordered_set<BasicBlock*>& live_blocks,
-      const std::unordered_map<BasicBlock*, BasicBlock*>&
-          unreachable_continues);
+  bool FixPhiNodesInLiveBlocks(Function* func, const BlockSet& live_blocks,
+                               const BlockToBlockMap& unreachable_continues);
 
   // Erases dead blocks. Any block captured in |unreachable_merges| or
   // |unreachable_continues| is a dead block that is required to remain due to
@@ -123,15 +127,14 @@ class DeadBranchElimPass : public MemPass {
   //
   // |unreachable_continues| maps continue targets that cannot be reached to
   // corresponding header block that declares them.
-  bool EraseDeadBlocks(
-      Function* func, const std::unordered_set<BasicBlock*>& live_blocks,
-      const std::unordered_set<BasicBlock*>& unreachable_merges,
-      const std::unordered_map<BasicBlock*, BasicBlock*>&
-          unreachable_continues);
+  bool EraseDeadBlocks(Function* func, const BlockSet& live_blocks,
+                       const BlockSet& unreachable_merges,
+                       const BlockToBlockMap& unreachable_continues);
 
-  // Reorders blocks in reachable functions so that they satisfy dominator
-  // block ordering rules.
-  void FixBlockOrder();
+  // Reorders blocks in the functions in |modified_funcs| so that they
+  // satisfy dominator block ordering rules.  Untouched functions already
+  // satisfy them and are left alone.
+  void FixBlockOrder(const std::unordered_set<Function*>& modified_funcs);
 
   // Return the first branch instruction that is a conditional branch to
   // |merge_block_id|. Returns |nullptr| if no such branch exists. If there are
@@ -154,9 +157,9 @@ class DeadBranchElimPass : public MemPass {
   // basic block |cont_id| to |header_id| and |merge_id|.  The intention is that
   // |cond_id| is a the continue target of a loop, |header_id| is the header of
   // the loop, and |merge_id| is the merge block of the loop.
-  void AddBlocksWithBackEdge(
-      uint32_t cont_id, uint32_t header_id, uint32_t merge_id,
-      std::unordered_set<BasicBlock*>* blocks_with_back_edges);
+  void AddBlocksWithBackEdge(uint32_t cont_id, uint32_t header_id,
+                             uint32_t merge_id,
+                             BlockSet* blocks_with_back_edges);
 
   // Returns true if there is a branch to the merge node of the selection
   // construct |switch_header_id| that is inside a nested selection construct or
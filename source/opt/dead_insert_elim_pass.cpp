@@ -62,7 +62,7 @@ uint32_t DeadInsertElimPass::NumComponents(Instruction* typeInst) {
 
 void DeadInsertElimPass::MarkInsertChain(
     Instruction* insertChain, std::vector<uint32_t>* pExtIndices,
-    uint32_t extOffset, std::unordered_set<uint32_t>* visited_phis) {
+    uint32_t extOffset, utils::SmallSet<uint32_t, 8>* visited_phis) {
   // Not currently optimizing array inserts.
   Instruction* typeInst = get_def_use_mgr()->GetDef(insertChain->type_id());
   if (typeInst->opcode() == spv::Op::OpTypeArray) return;
@@ -79,7 +79,7 @@ void DeadInsertElimPass::MarkInsertChain(
       for (uint32_t i = 0; i < cnum; i++) {
         extIndices.clear();
         extIndices.push_back(i);
-        std::unordered_set<uint32_t> sub_visited_phis;
+        utils::SmallSet<uint32_t, 8> sub_visited_phis;
         MarkInsertChain(insertChain, &extIndices, 0, &sub_visited_phis);
       }
       return;
@@ -97,7 +97,7 @@ void DeadInsertElimPass::MarkInsertChain(
     if (pExtIndices == nullptr) {
       liveInserts_.insert(insInst->result_id());
       uint32_t objId = insInst->GetSingleWordInOperand(kInsertObjectIdInIdx);
-      std::unordered_set<uint32_t> obj_visited_phis;
+      utils::SmallSet<uint32_t, 8> obj_visited_phis;
       MarkInsertChain(get_def_use_mgr()->GetDef(objId), nullptr, 0,
                       &obj_visited_phis);
     // If extract indices match insert, we are done. Mark insert and
@@ -105,7 +105,7 @@ void DeadInsertElimPass::MarkInsertChain(
     } else if (ExtInsMatch(*pExtIndices, insInst, extOffset)) {
       liveInserts_.insert(insInst->result_id());
       uint32_t objId = insInst->GetSingleWordInOperand(kInsertObjectIdInIdx);
-      std::unordered_set<uint32_t> obj_visited_phis;
+      utils::SmallSet<uint32_t, 8> obj_visited_phis;
       MarkInsertChain(get_def_use_mgr()->GetDef(objId), nullptr, 0,
                       &obj_visited_phis);
       break;
@@ -117,7 +117,7 @@ void DeadInsertElimPass::MarkInsertChain(
       uint32_t numInsertIndices = insInst->NumInOperands() - 2;
       if (pExtIndices->size() - extOffset > numInsertIndices) {
         uint32_t objId = insInst->GetSingleWordInOperand(kInsertObjectIdInIdx);
-        std::unordered_set<uint32_t> obj_visited_phis;
+        utils::SmallSet<uint32_t, 8> obj_visited_phis;
         MarkInsertChain(get_def_use_mgr()->GetDef(objId), pExtIndices,
                         extOffset + numInsertIndices, &obj_visited_phis);
         break;
@@ -125,7 +125,7 @@ void DeadInsertElimPass::MarkInsertChain(
       // continue up chain.
       } else {
         uint32_t objId = insInst->GetSingleWordInOperand(kInsertObjectIdInIdx);
-        std::unordered_set<uint32_t> obj_visited_phis;
+        utils::SmallSet<uint32_t, 8> obj_visited_phis;
         MarkInsertChain(get_def_use_mgr()->GetDef(objId), nullptr, 0,
                         &obj_visited_phis);
       }
@@ -208,7 +208,7 @@ bool DeadInsertElimPass::EliminateDeadInsertsOnePass(Function* func) {
               ++icnt;
             });
             // Mark all inserts in chain that intersect with extract
-            std::unordered_set<uint32_t> visited_phis;
+            utils::SmallSet<uint32_t, 8> visited_phis;
             MarkInsertChain(&*ii, &extIndices, 0, &visited_phis);
           } break;
           default: {
@@ -29,6 +29,7 @@
 #include "source/opt/ir_context.h"
 #include "source/opt/mem_pass.h"
 #include "source/opt/module.h"
+#include "source/util/small_set.h"
 
 namespace spvtools {
 namespace opt {
@@ -61,7 +62,7 @@ class DeadInsertElimPass : public MemPass {
   // Mark all inserts in chain if |extIndices| is nullptr.
   void MarkInsertChain(Instruction* insertChain,
                        std::vector<uint32_t>* extIndices, uint32_t extOffset,
-                       std::unordered_set<uint32_t>* visited_phis);
+                       utils::SmallSet<uint32_t, 8>* visited_phis);
 
   // Perform EliminateDeadInsertsOnePass(|func|) until no modification is
   // made. Return true if modified.
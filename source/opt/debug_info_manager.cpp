@@ -16,6 +16,7 @@
 #include "source/opt/debug_info_manager.h"
 
 #include <cassert>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 
@@ -36,6 +37,8 @@ constexpr uint32_t kDebugFunctionDefinitionOperandOpFunctionIndex = 5;
 constexpr uint32_t kDebugFunctionOperandParentIndex = 9;
 constexpr uint32_t kDebugTypeCompositeOperandParentIndex = 9;
 constexpr uint32_t kDebugLexicalBlockOperandParentIndex = 7;
+constexpr uint32_t kDebugInlinedAtOperandLineIndex = 4;
+constexpr uint32_t kDebugInlinedAtOperandScopeIndex = 5;
 constexpr uint32_t kDebugInlinedAtOperandInlinedIndex = 6;
 constexpr uint32_t kDebugExpressOperandOperationIndex = 4;
 constexpr uint32_t kDebugDeclareOperandLocalVariableIndex = 4;
@@ -79,7 +82,9 @@ bool IsEmptyDebugExpression(Instruction* instr) {
 }  // namespace
 
 DebugInfoManager::DebugInfoManager(IRContext* c) : context_(c) {
-  AnalyzeDebugInsts(*c->module());
+  // Indexing is deferred: each index family is built by a module walk on its
+  // first query, and a module without a debug-info import never walks at
+  // all.  See EnsureDebugInstIndices() and EnsureScopeUserIndices().
 }
 
 uint32_t DebugInfoManager::GetDbgSetImportId() {
@@ -93,6 +98,7 @@ uint32_t DebugInfoManager::GetDbgSetImportId() {
 }
 
 Instruction* DebugInfoManager::GetDbgInst(uint32_t id) {
+  EnsureDebugInstIndices();
   auto dbg_inst_it = id_to_dbg_inst_.find(id);
   return dbg_inst_it == id_to_dbg_inst_.end() ? nullptr : dbg_inst_it->second;
 }
@@ -173,6 +179,8 @@ uint32_t DebugInfoManager::CreateDebugInlinedAt(const Instruction* line,
 
   if (setId == 0) return kNoInlinedAt;
 
+  EnsureDebugInstIndices();
+
   spv_operand_type_t line_number_type =
       spv_operand_type_t::SPV_OPERAND_TYPE_LITERAL_INTEGER;
 
@@ -240,6 +248,12 @@ uint32_t DebugInfoManager::CreateDebugInlinedAt(const Instruction* line,
     }
   }
 
+  // Reuse an existing node with identical operands instead of growing the
+  // debug section with a duplicate.
+  const uint32_t existing_id = LookupConsedDebugInlinedAt(
+      line_number, scope.GetLexicalScope(), scope.GetInlinedAt());
+  if (existing_id != kNoInlinedAt) return existing_id;
+
   uint32_t result_id = context()->TakeNextId();
   std::unique_ptr<Instruction> inlined_at(new Instruction(
       context(), spv::Op::OpExtInst, context()->get_type_mgr()->GetVoidTypeId(),
@@ -261,6 +275,8 @@ uint32_t DebugInfoManager::CreateDebugInlinedAt(const Instruction* line,
   if (context()->AreAnalysesValid(IRContext::Analysis::kAnalysisDefUse))
     context()->get_def_use_mgr()->AnalyzeInstDefUse(inlined_at.get());
   context()->module()->AddExtInstDebugInfo(std::move(inlined_at));
+  inlined_at_cons_[std::make_tuple(line_number, scope.GetLexicalScope(),
+                                   scope.GetInlinedAt())] = result_id;
   return result_id;
 }
 
@@ -295,32 +311,25 @@ uint32_t DebugInfoManager::BuildDebugInlinedAtChain(
     return new_dbg_inlined_at_id;
   }
 
-  uint32_t chain_head_id = kNoInlinedAt;
-  uint32_t chain_iter_id = callee_inlined_at;
-  Instruction* last_inlined_at_in_chain = nullptr;
-  do {
-    Instruction* new_inlined_at_in_chain = CloneDebugInlinedAt(
-        chain_iter_id, /* insert_before */ last_inlined_at_in_chain);
-    assert(new_inlined_at_in_chain != nullptr);
-
-    // Set DebugInlinedAt of the new scope as the head of the chain.
-    if (chain_head_id == kNoInlinedAt)
-      chain_head_id = new_inlined_at_in_chain->result_id();
-
-    // Previous DebugInlinedAt of the chain must point to the new
-    // DebugInlinedAt as its Inlined operand to build a recursive
-    // chain.
-    if (last_inlined_at_in_chain != nullptr) {
-      SetInlinedOperand(last_inlined_at_in_chain,
-                        new_inlined_at_in_chain->result_id());
-    }
-    last_inlined_at_in_chain = new_inlined_at_in_chain;
-
-    chain_iter_id = GetInlinedOperand(new_inlined_at_in_chain);
-  } while (chain_iter_id != kNoInlinedAt);
+  // Collect the callee chain, then rebuild it from the tail so that every
+  // node's Inlined operand is known when the node is created.  Creating the
+  // nodes fully formed lets inlining events whose chains end identically
+  // share the nodes of that suffix instead of cloning the whole chain.
+  std::vector<Instruction*> callee_chain;
+  for (uint32_t chain_iter_id = callee_inlined_at;
+       chain_iter_id != kNoInlinedAt;) {
+    Instruction* inlined_at_in_chain = GetDebugInlinedAt(chain_iter_id);
+    assert(inlined_at_in_chain != nullptr);
+    callee_chain.push_back(inlined_at_in_chain);
+    chain_iter_id = GetInlinedOperand(inlined_at_in_chain);
+  }
 
   // Put |new_dbg_inlined_at_id| into the end of the chain.
-  SetInlinedOperand(last_inlined_at_in_chain, new_dbg_inlined_at_id);
+  uint32_t chain_head_id = new_dbg_inlined_at_id;
+  for (auto node_itr = callee_chain.rbegin(); node_itr != callee_chain.rend();
+       ++node_itr) {
+    chain_head_id = GetOrCloneDebugInlinedAt(*node_itr, chain_head_id);
+  }
 
   // Keep the new chain information that will be reused it.
   inlined_at_ctx->SetDebugInlinedAtChain(callee_inlined_at, chain_head_id);
@@ -328,6 +337,7 @@ uint32_t DebugInfoManager::BuildDebugInlinedAtChain(
 }
 
 Instruction* DebugInfoManager::GetDebugOperationWithDeref() {
+  EnsureDebugInstIndices();
   if (deref_operation_ != nullptr) return deref_operation_;
 
   uint32_t result_id = context()->TakeNextId();
@@ -387,6 +397,7 @@ Instruction* DebugInfoManager::DerefDebugExpression(Instruction* dbg_expr) {
 }
 
 Instruction* DebugInfoManager::GetDebugInfoNone() {
+  EnsureDebugInstIndices();
   if (debug_info_none_inst_ != nullptr) return debug_info_none_inst_;
 
   uint32_t result_id = context()->TakeNextId();
@@ -411,6 +422,7 @@ Instruction* DebugInfoManager::GetDebugInfoNone() {
 }
 
 Instruction* DebugInfoManager::GetEmptyDebugExpression() {
+  EnsureDebugInstIndices();
   if (empty_debug_expr_inst_ != nullptr) return empty_debug_expr_inst_;
 
   uint32_t result_id = context()->TakeNextId();
@@ -458,12 +470,55 @@ Instruction* DebugInfoManager::CloneDebugInlinedAt(uint32_t clone_inlined_at_id,
       std::move(new_inlined_at));
 }
 
+uint32_t DebugInfoManager::LookupConsedDebugInlinedAt(uint32_t line,
+                                                      uint32_t scope,
+                                                      uint32_t inlined) {
+  auto cons_itr = inlined_at_cons_.find(std::make_tuple(line, scope, inlined));
+  if (cons_itr == inlined_at_cons_.end()) return kNoInlinedAt;
+  // The recorded node may have been killed, or another transformation may
+  // have rewritten its operands since it was recorded.  Such an entry is
+  // stale; drop it rather than aliasing debug information.
+  const uint32_t recorded_id = cons_itr->second;
+  Instruction* recorded = GetDebugInlinedAt(recorded_id);
+  if (recorded == nullptr ||
+      recorded->GetSingleWordOperand(kDebugInlinedAtOperandLineIndex) != line ||
+      recorded->GetSingleWordOperand(kDebugInlinedAtOperandScopeIndex) !=
+          scope ||
+      GetInlinedOperand(recorded) != inlined) {
+    inlined_at_cons_.erase(cons_itr);
+    return kNoInlinedAt;
+  }
+  return recorded_id;
+}
+
+uint32_t DebugInfoManager::GetOrCloneDebugInlinedAt(Instruction* node,
+                                                    uint32_t inlined_id) {
+  const uint32_t line =
+      node->GetSingleWordOperand(kDebugInlinedAtOperandLineIndex);
+  const uint32_t scope =
+      node->GetSingleWordOperand(kDebugInlinedAtOperandScopeIndex);
+  const uint32_t existing_id =
+      LookupConsedDebugInlinedAt(line, scope, inlined_id);
+  if (existing_id != kNoInlinedAt) return existing_id;
+
+  Instruction* new_inlined_at = CloneDebugInlinedAt(node->result_id());
+  assert(new_inlined_at != nullptr);
+  SetInlinedOperand(new_inlined_at, inlined_id);
+  if (context()->AreAnalysesValid(IRContext::Analysis::kAnalysisDefUse))
+    context()->UpdateDefUse(new_inlined_at);
+  inlined_at_cons_[std::make_tuple(line, scope, inlined_id)] =
+      new_inlined_at->result_id();
+  return new_inlined_at->result_id();
+}
+
 bool DebugInfoManager::IsVariableDebugDeclared(uint32_t variable_id) {
+  EnsureDebugInstIndices();
   auto dbg_decl_itr = var_id_to_dbg_decl_.find(variable_id);
   return dbg_decl_itr != var_id_to_dbg_decl_.end();
 }
 
 bool DebugInfoManager::KillDebugDeclares(uint32_t variable_id) {
+  EnsureDebugInstIndices();
   bool modified = false;
   auto dbg_decl_itr = var_id_to_dbg_decl_.find(variable_id);
   if (dbg_decl_itr != var_id_to_dbg_decl_.end()) {
@@ -564,6 +619,7 @@ bool DebugInfoManager::AddDebugValueForVariable(Instruction* scope_and_line,
                                                 Instruction* insert_pos) {
   assert(scope_and_line != nullptr);
 
+  EnsureDebugInstIndices();
   auto dbg_decl_itr = var_id_to_dbg_decl_.find(variable_id);
   if (dbg_decl_itr == var_id_to_dbg_decl_.end()) return false;
 
@@ -672,6 +728,7 @@ bool DebugInfoManager::IsDebugDeclare(Instruction* instr) {
 void DebugInfoManager::ReplaceAllUsesInDebugScopeWithPredicate(
     uint32_t before, uint32_t after,
     const std::function<bool(Instruction*)>& predicate) {
+  EnsureScopeUserIndices();
   auto scope_id_to_users_itr = scope_id_to_users_.find(before);
   if (scope_id_to_users_itr != scope_id_to_users_.end()) {
     for (Instruction* inst : scope_id_to_users_itr->second) {
@@ -691,6 +748,9 @@ void DebugInfoManager::ReplaceAllUsesInDebugScopeWithPredicate(
 }
 
 void DebugInfoManager::ClearDebugScopeAndInlinedAtUses(Instruction* inst) {
+  // Nothing to erase while the user maps are pending their lazy build: the
+  // build walks the module after |inst| has been removed from it.
+  if (!scope_user_indices_built_) return;
   auto scope_id_to_users_itr = scope_id_to_users_.find(inst->result_id());
   if (scope_id_to_users_itr != scope_id_to_users_.end()) {
     scope_id_to_users_.erase(scope_id_to_users_itr);
@@ -703,6 +763,11 @@ void DebugInfoManager::ClearDebugScopeAndInlinedAtUses(Instruction* inst) {
 }
 
 void DebugInfoManager::AnalyzeDebugInst(Instruction* inst) {
+  if (scope_user_indices_built_) AnalyzeScopeAndInlinedAtUses(inst);
+  if (dbg_inst_indices_built_) AnalyzeDebugInstForIndices(inst);
+}
+
+void DebugInfoManager::AnalyzeScopeAndInlinedAtUses(Instruction* inst) {
   if (inst->GetDebugScope().GetLexicalScope() != kNoDebugScope) {
     auto& users = scope_id_to_users_[inst->GetDebugScope().GetLexicalScope()];
     users.insert(inst);
@@ -711,7 +776,9 @@ void DebugInfoManager::AnalyzeDebugInst(Instruction* inst) {
     auto& users = inlinedat_id_to_users_[inst->GetDebugInlinedAt()];
     users.insert(inst);
   }
+}
 
+void DebugInfoManager::AnalyzeDebugInstForIndices(Instruction* inst) {
   if (!inst->IsCommonDebugInstr()) return;
 
   RegisterDbgInst(inst);
@@ -747,6 +814,18 @@ void DebugInfoManager::AnalyzeDebugInst(Instruction* inst) {
     empty_debug_expr_inst_ = inst;
   }
 
+  if (inst->GetCommonDebugOpcode() == CommonDebugInfoDebugInlinedAt) {
+    // Seed the hash-consing index so that later inlining reuses nodes that
+    // already exist in the module.  The first node registered for a given
+    // operand triple wins; duplicates keep their own ids.
+    inlined_at_cons_.emplace(
+        std::make_tuple(
+            inst->GetSingleWordOperand(kDebugInlinedAtOperandLineIndex),
+            inst->GetSingleWordOperand(kDebugInlinedAtOperandScopeIndex),
+            GetInlinedOperand(inst)),
+        inst->result_id());
+  }
+
   if (inst->GetCommonDebugOpcode() == CommonDebugInfoDebugDeclare) {
     uint32_t var_id =
         inst->GetSingleWordOperand(kDebugDeclareOperandVariableIndex);
@@ -808,11 +887,26 @@ void DebugInfoManager::ConvertDebugGlobalToLocalVariable(
   }
 }
 
-void DebugInfoManager::AnalyzeDebugInsts(Module& module) {
-  deref_operation_ = nullptr;
-  debug_info_none_inst_ = nullptr;
-  empty_debug_expr_inst_ = nullptr;
-  module.ForEachInst([this](Instruction* cpi) { AnalyzeDebugInst(cpi); });
+void DebugInfoManager::EnsureScopeUserIndices() {
+  if (scope_user_indices_built_) return;
+  // Set the flag up front so the walk below may re-enter this method.
+  scope_user_indices_built_ = true;
+  // DebugScope and DebugInlinedAt reference debug-info extension
+  // instructions, so a stripped module has no users to record.
+  if (GetDbgSetImportId() == 0) return;
+  context()->module()->ForEachInst(
+      [this](Instruction* cpi) { AnalyzeScopeAndInlinedAtUses(cpi); });
+}
+
+void DebugInfoManager::EnsureDebugInstIndices() {
+  if (dbg_inst_indices_built_) return;
+  // Set the flag up front: the walk below reaches GetDbgInst(), which calls
+  // back into this method.
+  dbg_inst_indices_built_ = true;
+  if (GetDbgSetImportId() == 0) return;
+  Module& module = *context()->module();
+  module.ForEachInst(
+      [this](Instruction* cpi) { AnalyzeDebugInstForIndices(cpi); });
 
   // Move |empty_debug_expr_inst_| to the beginning of the debug instruction
   // list.
@@ -834,6 +928,7 @@ void DebugInfoManager::AnalyzeDebugInsts(Module& module) {
 }
 
 void DebugInfoManager::ClearDebugInfo(Instruction* instr) {
+  if (!scope_user_indices_built_ && !dbg_inst_indices_built_) return;
   auto scope_id_to_users_itr =
       scope_id_to_users_.find(instr->GetDebugScope().GetLexicalScope());
   if (scope_id_to_users_itr != scope_id_to_users_.end()) {
@@ -851,6 +946,17 @@ void DebugInfoManager::ClearDebugInfo(Instruction* instr) {
 
   id_to_dbg_inst_.erase(instr->result_id());
 
+  if (instr->GetCommonDebugOpcode() == CommonDebugInfoDebugInlinedAt) {
+    auto cons_itr = inlined_at_cons_.find(std::make_tuple(
+        instr->GetSingleWordOperand(kDebugInlinedAtOperandLineIndex),
+        instr->GetSingleWordOperand(kDebugInlinedAtOperandScopeIndex),
+        GetInlinedOperand(instr)));
+    if (cons_itr != inlined_at_cons_.end() &&
+        cons_itr->second == instr->result_id()) {
+      inlined_at_cons_.erase(cons_itr);
+    }
+  }
+
   if (instr->GetOpenCL100DebugOpcode() == OpenCLDebugInfo100DebugFunction) {
     auto fn_id =
         instr->GetSingleWordOperand(kDebugFunctionOperandFunctionIndex);
@@ -15,7 +15,9 @@
 #ifndef SOURCE_OPT_DEBUG_INFO_MANAGER_H_
 #define SOURCE_OPT_DEBUG_INFO_MANAGER_H_
 
+#include <map>
 #include <set>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -70,6 +72,12 @@ class DebugInlinedAtContext {
 
 // A class for analyzing, managing, and creating OpenCL.DebugInfo.100 and
 // NonSemantic.Shader.DebugInfo.100 extension instructions.
+//
+// The indices over the module's debug instructions are built lazily: the
+// per-id/per-function/per-variable maps and the DebugScope/DebugInlinedAt
+// user maps are each populated by a module walk on their first query.  A
+// module without a debug-info ExtInstImport skips the walks entirely, so
+// passes running on stripped modules pay nothing for this analysis.
 class DebugInfoManager {
  public:
   // Constructs a debug information manager from the given |context|.
@@ -86,7 +94,9 @@ class DebugInfoManager {
     return !(lhs == rhs);
   }
 
-  // Analyzes DebugInfo instruction |dbg_inst|.
+  // Analyzes DebugInfo instruction |dbg_inst|.  Only indices that have
+  // already been built are updated; an index still pending its lazy build
+  // picks |dbg_inst| up from the module when it is first queried.
   void AnalyzeDebugInst(Instruction* dbg_inst);
 
   // Creates new DebugInlinedAt and returns its id. Its line operand is the
@@ -110,6 +120,7 @@ class DebugInfoManager {
   // Returns DebugFunction whose Function operand is |fn_id|. If it does not
   // exist, return nullptr.
   Instruction* GetDebugFunction(uint32_t fn_id) {
+    EnsureDebugInstIndices();
     auto dbg_fn_it = fn_id_to_dbg_fn_.find(fn_id);
     return dbg_fn_it == fn_id_to_dbg_fn_.end() ? nullptr : dbg_fn_it->second;
   }
@@ -192,9 +203,20 @@ class DebugInfoManager {
  private:
   IRContext* context() { return context_; }
 
-  // Analyzes DebugInfo instructions in the given |module| and
-  // populates data structures in this class.
-  void AnalyzeDebugInsts(Module& module);
+  // Builds |id_to_dbg_inst_|, |fn_id_to_dbg_fn_|, |var_id_to_dbg_decl_| and
+  // the cached singleton instructions on first use.  A no-op when the module
+  // has no debug-info ExtInstImport.
+  void EnsureDebugInstIndices();
+
+  // Builds |scope_id_to_users_| and |inlinedat_id_to_users_| on first use.
+  // A no-op when the module has no debug-info ExtInstImport.
+  void EnsureScopeUserIndices();
+
+  // Populates the debug-instruction indices from |dbg_inst|.
+  void AnalyzeDebugInstForIndices(Instruction* dbg_inst);
+
+  // Records |inst| in the DebugScope and DebugInlinedAt user maps.
+  void AnalyzeScopeAndInlinedAtUses(Instruction* inst);
 
   // Get the DebugInfo ExtInstImport Id, or 0 if no DebugInfo is available.
   uint32_t GetDbgSetImportId();
@@ -233,6 +255,21 @@ class DebugInfoManager {
   // Returns the parent scope of the scope |child_scope|.
   uint32_t GetParentScope(uint32_t child_scope);
 
+  // Returns the id recorded in |inlined_at_cons_| for a DebugInlinedAt with
+  // the given Line, Scope and Inlined operand words, or kNoInlinedAt if no
+  // node with exactly those operands is known.  A recorded node that was
+  // killed or had its operands rewritten since is dropped from the index
+  // instead of being returned.
+  uint32_t LookupConsedDebugInlinedAt(uint32_t line, uint32_t scope,
+                                      uint32_t inlined);
+
+  // Returns the id of a DebugInlinedAt with the Line and Scope operands of
+  // |node| and |inlined_id| as its Inlined operand, reusing an existing
+  // node when one is recorded in |inlined_at_cons_|.  Otherwise |node| is
+  // cloned and the clone's Inlined operand is set before the clone is
+  // published, so hash-consed nodes are never mutated afterwards.
+  uint32_t GetOrCloneDebugInlinedAt(Instruction* node, uint32_t inlined_id);
+
   IRContext* context_;
 
   // Mapping from ids of DebugInfo extension instructions.
@@ -266,16 +303,29 @@ class DebugInfoManager {
       inlinedat_id_to_users_;
 
   // DebugOperation whose OpCode is OpenCLDebugInfo100Deref.
-  Instruction* deref_operation_;
+  Instruction* deref_operation_ = nullptr;
 
   // DebugInfoNone instruction. We need only a single DebugInfoNone.
   // To reuse the existing one, we keep it using this member variable.
-  Instruction* debug_info_none_inst_;
+  Instruction* debug_info_none_inst_ = nullptr;
 
   // DebugExpression instruction without Operation operands. We need only
   // a single DebugExpression without Operation operands. To reuse the
   // existing one, we keep it using this member variable.
-  Instruction* empty_debug_expr_inst_;
+  Instruction* empty_debug_expr_inst_ = nullptr;
+
+  // Hash-consing index for DebugInlinedAt: maps (Line operand word, Scope
+  // id, Inlined id) to the id of a node with exactly those operands.
+  // Chains are immutable linked lists through the Inlined operand, so two
+  // inlining events whose chains share a suffix share the nodes of that
+  // suffix instead of cloning them.  Entries are validated on lookup, so a
+  // node that was killed or rewritten behind our back simply misses.
+  std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t>
+      inlined_at_cons_;
+
+  // Whether the lazily built index families are populated yet.
+  bool dbg_inst_indices_built_ = false;
+  bool scope_user_indices_built_ = false;
 };
 
 }  // namespace analysis
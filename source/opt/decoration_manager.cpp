@@ -18,15 +18,16 @@
 #include <memory>
 #include <set>
 #include <stack>
+#include <string>
 #include <utility>
 
 #include "source/opt/ir_context.h"
+#include "source/util/hash_combine.h"
 
 namespace spvtools {
 namespace opt {
 namespace analysis {
 namespace {
-using InstructionVector = std::vector<const spvtools::opt::Instruction*>;
 using DecorationSet = std::set<std::u32string>;
 
 // Returns true if |a| is a subet of |b|.
@@ -60,6 +61,10 @@ bool DecorationManager::RemoveDecorationsFrom(
     return was_modified;
   }
 
+  // Everything below mutates tracked decorations, including group
+  // instructions shared with other targets.
+  canonical_cache_.clear();
+
   TargetData& decorations_info = ids_iter->second;
   auto context = module_->context();
   std::vector<Instruction*> insts_to_kill;
@@ -190,135 +195,101 @@ std::vector<const Instruction*> DecorationManager::GetDecorationsFor(
 
 bool DecorationManager::HaveTheSameDecorations(uint32_t id1,
                                                uint32_t id2) const {
-  const InstructionVector decorations_for1 = GetDecorationsFor(id1, false);
-  const InstructionVector decorations_for2 = GetDecorationsFor(id2, false);
-
-  // This function splits the decoration instructions into different sets,
-  // based on their opcode; only OpDecorate, OpDecorateId,
-  // OpDecorateStringGOOGLE, and OpMemberDecorate are considered, the other
-  // opcodes are ignored.
-  const auto fillDecorationSets =
-      [](const InstructionVector& decoration_list, DecorationSet* decorate_set,
-         DecorationSet* decorate_id_set, DecorationSet* decorate_string_set,
-         DecorationSet* member_decorate_set) {
-        for (const Instruction* inst : decoration_list) {
-          std::u32string decoration_payload;
-          // Ignore the opcode and the target as we do not want them to be
-          // compared.
-          for (uint32_t i = 1u; i < inst->NumInOperands(); ++i) {
-            for (uint32_t word : inst->GetInOperand(i).words) {
-              decoration_payload.push_back(word);
-            }
-          }
-
-          switch (inst->opcode()) {
-            case spv::Op::OpDecorate:
-              decorate_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpMemberDecorate:
-              member_decorate_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpDecorateId:
-              decorate_id_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpDecorateStringGOOGLE:
-              decorate_string_set->emplace(std::move(decoration_payload));
-              break;
-            default:
-              break;
-          }
-        }
-      };
-
-  DecorationSet decorate_set_for1;
-  DecorationSet decorate_id_set_for1;
-  DecorationSet decorate_string_set_for1;
-  DecorationSet member_decorate_set_for1;
-  fillDecorationSets(decorations_for1, &decorate_set_for1,
-                     &decorate_id_set_for1, &decorate_string_set_for1,
-                     &member_decorate_set_for1);
-
-  DecorationSet decorate_set_for2;
-  DecorationSet decorate_id_set_for2;
-  DecorationSet decorate_string_set_for2;
-  DecorationSet member_decorate_set_for2;
-  fillDecorationSets(decorations_for2, &decorate_set_for2,
-                     &decorate_id_set_for2, &decorate_string_set_for2,
-                     &member_decorate_set_for2);
-
-  const bool result = decorate_set_for1 == decorate_set_for2 &&
-                      decorate_id_set_for1 == decorate_id_set_for2 &&
-                      member_decorate_set_for1 == member_decorate_set_for2 &&
-                      // Compare string sets last in case the strings are long.
-                      decorate_string_set_for1 == decorate_string_set_for2;
-  return result;
+  const CanonicalDecorations& canonical1 = GetCanonicalDecorations(id1);
+  const CanonicalDecorations& canonical2 = GetCanonicalDecorations(id2);
+
+  // Equal sets have equal fingerprints, so a fingerprint mismatch proves the
+  // decorations differ without touching the sets.  Deduplication loops
+  // compare mostly-unequal pairs, making this the common exit.
+  if (canonical1.fingerprint != canonical2.fingerprint) return false;
+
+  return canonical1.decorate_set == canonical2.decorate_set &&
+         canonical1.decorate_id_set == canonical2.decorate_id_set &&
+         canonical1.member_decorate_set == canonical2.member_decorate_set &&
+         // Compare string sets last in case the strings are long.
+         canonical1.decorate_string_set == canonical2.decorate_string_set;
 }
 
 bool DecorationManager::HaveSubsetOfDecorations(uint32_t id1,
                                                 uint32_t id2) const {
-  const InstructionVector decorations_for1 = GetDecorationsFor(id1, false);
-  const InstructionVector decorations_for2 = GetDecorationsFor(id2, false);
-
-  // This function splits the decoration instructions into different sets,
-  // based on their opcode; only OpDecorate, OpDecorateId,
-  // OpDecorateStringGOOGLE, and OpMemberDecorate are considered, the other
-  // opcodes are ignored.
-  const auto fillDecorationSets =
-      [](const InstructionVector& decoration_list, DecorationSet* decorate_set,
-         DecorationSet* decorate_id_set, DecorationSet* decorate_string_set,
-         DecorationSet* member_decorate_set) {
-        for (const Instruction* inst : decoration_list) {
-          std::u32string decoration_payload;
-          // Ignore the opcode and the target as we do not want them to be
-          // compared.
-          for (uint32_t i = 1u; i < inst->NumInOperands(); ++i) {
-            for (uint32_t word : inst->GetInOperand(i).words) {
-              decoration_payload.push_back(word);
-            }
-          }
+  const CanonicalDecorations& canonical1 = GetCanonicalDecorations(id1);
+  const CanonicalDecorations& canonical2 = GetCanonicalDecorations(id2);
+
+  // Equal fingerprints for equal-sized sets mean the decorations are the
+  // same, and every set is a subset of itself.
+  if (canonical1.fingerprint == canonical2.fingerprint &&
+      canonical1.decorate_set.size() == canonical2.decorate_set.size() &&
+      canonical1.decorate_id_set.size() ==
+          canonical2.decorate_id_set.size() &&
+      canonical1.member_decorate_set.size() ==
+          canonical2.member_decorate_set.size() &&
+      canonical1.decorate_string_set.size() ==
+          canonical2.decorate_string_set.size()) {
+    return HaveTheSameDecorations(id1, id2);
+  }
 
-          switch (inst->opcode()) {
-            case spv::Op::OpDecorate:
-              decorate_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpMemberDecorate:
-              member_decorate_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpDecorateId:
-              decorate_id_set->emplace(std::move(decoration_payload));
-              break;
-            case spv::Op::OpDecorateStringGOOGLE:
-              decorate_string_set->emplace(std::move(decoration_payload));
-              break;
-            default:
-              break;
-          }
-        }
-      };
+  return IsSubset(canonical1.decorate_set, canonical2.decorate_set) &&
+         IsSubset(canonical1.decorate_id_set, canonical2.decorate_id_set) &&
+         IsSubset(canonical1.member_decorate_set,
+                  canonical2.member_decorate_set) &&
+         // Compare string sets last in case the strings are long.
+         IsSubset(canonical1.decorate_string_set,
+                  canonical2.decorate_string_set);
+}
+
+const DecorationManager::CanonicalDecorations&
+DecorationManager::GetCanonicalDecorations(uint32_t id) const {
+  auto iter = canonical_cache_.find(id);
+  if (iter != canonical_cache_.end()) return iter->second;
+
+  CanonicalDecorations canonical;
+
+  // Split the decoration instructions into different sets, based on their
+  // opcode; only OpDecorate, OpDecorateId, OpDecorateStringGOOGLE, and
+  // OpMemberDecorate are considered, the other opcodes are ignored.
+  for (const Instruction* inst : GetDecorationsFor(id, false)) {
+    std::u32string decoration_payload;
+    // Ignore the opcode and the target as we do not want them to be
+    // compared.
+    for (uint32_t i = 1u; i < inst->NumInOperands(); ++i) {
+      for (uint32_t word : inst->GetInOperand(i).words) {
+        decoration_payload.push_back(word);
+      }
+    }
+
+    switch (inst->opcode()) {
+      case spv::Op::OpDecorate:
+        canonical.decorate_set.emplace(std::move(decoration_payload));
+        break;
+      case spv::Op::OpMemberDecorate:
+        canonical.member_decorate_set.emplace(std::move(decoration_payload));
+        break;
+      case spv::Op::OpDecorateId:
+        canonical.decorate_id_set.emplace(std::move(decoration_payload));
+        break;
+      case spv::Op::OpDecorateStringGOOGLE:
+        canonical.decorate_string_set.emplace(std::move(decoration_payload));
+        break;
+      default:
+        break;
+    }
+  }
 
-  DecorationSet decorate_set_for1;
-  DecorationSet decorate_id_set_for1;
-  DecorationSet decorate_string_set_for1;
-  DecorationSet member_decorate_set_for1;
-  fillDecorationSets(decorations_for1, &decorate_set_for1,
-                     &decorate_id_set_for1, &decorate_string_set_for1,
-                     &member_decorate_set_for1);
-
-  DecorationSet decorate_set_for2;
-  DecorationSet decorate_id_set_for2;
-  DecorationSet decorate_string_set_for2;
-  DecorationSet member_decorate_set_for2;
-  fillDecorationSets(decorations_for2, &decorate_set_for2,
-                     &decorate_id_set_for2, &decorate_string_set_for2,
-                     &member_decorate_set_for2);
-
-  const bool result =
-      IsSubset(decorate_set_for1, decorate_set_for2) &&
-      IsSubset(decorate_id_set_for1, decorate_id_set_for2) &&
-      IsSubset(member_decorate_set_for1, member_decorate_set_for2) &&
-      // Compare string sets last in case the strings are long.
-      IsSubset(decorate_string_set_for1, decorate_string_set_for2);
-  return result;
+  // Fingerprint the four sets.  std::set iterates in sorted order, so equal
+  // sets produce identical fingerprints; the sizes separate the sets from
+  // one another.
+  size_t fingerprint = 0;
+  for (const auto* set :
+       {&canonical.decorate_set, &canonical.decorate_id_set,
+        &canonical.member_decorate_set, &canonical.decorate_string_set}) {
+    fingerprint = utils::hash_combine(fingerprint, set->size());
+    for (const std::u32string& payload : *set) {
+      fingerprint = utils::hash_combine(fingerprint, payload);
+    }
+  }
+  canonical.fingerprint = fingerprint;
+
+  return canonical_cache_.emplace(id, std::move(canonical)).first->second;
 }
 
 // TODO(pierremoreau): If OpDecorateId is referencing an OpConstant, one could
@@ -347,6 +318,24 @@ bool DecorationManager::AreDecorationsTheSame(const Instruction* inst1,
   return true;
 }
 
+void DecorationManager::RemapAllIds(
+    const std::unordered_map<uint32_t, uint32_t>& id_map) {
+  if (!module_) return;
+
+  for (Instruction& inst : module_->annotations()) {
+    inst.ForEachId([&id_map](uint32_t* id) {
+      const auto it = id_map.find(*id);
+      if (it != id_map.end()) *id = it->second;
+    });
+  }
+
+  // One rebuild of the index replaces the per-edit maintenance that renaming
+  // each target individually would have triggered.
+  id_to_decoration_insts_.clear();
+  canonical_cache_.clear();
+  AnalyzeDecorations();
+}
+
 void DecorationManager::AnalyzeDecorations() {
   if (!module_) return;
 
@@ -357,6 +346,9 @@ void DecorationManager::AnalyzeDecorations() {
 }
 
 void DecorationManager::AddDecoration(Instruction* inst) {
+  // A new decoration invalidates the cached canonical form of every target
+  // it reaches; a group decoration can reach many, so drop the whole cache.
+  canonical_cache_.clear();
   switch (inst->opcode()) {
     case spv::Op::OpDecorate:
     case spv::Op::OpDecorateId:
@@ -596,6 +588,7 @@ void DecorationManager::CloneDecorations(
 }
 
 void DecorationManager::RemoveDecoration(Instruction* inst) {
+  canonical_cache_.clear();
   const auto remove_from_container = [inst](std::vector<Instruction*>& v) {
     v.erase(std::remove(v.begin(), v.end(), inst), v.end());
   };
@@ -16,6 +16,8 @@
 #define SOURCE_OPT_DECORATION_MANAGER_H_
 
 #include <functional>
+#include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -63,6 +65,14 @@ class DecorationManager {
   // will be removed, and no actual instruction.
   void RemoveDecoration(Instruction* inst);
 
+  // Rewrites every id mentioned by the annotation instructions of the module
+  // according to |id_map| (ids absent from the map are left unchanged), then
+  // rebuilds the manager's index once.  This is the bulk counterpart to
+  // editing decorations one target at a time, for callers renaming many ids
+  // in one go.  The caller is responsible for updating other analyses (such
+  // as def-use) that reference the rewritten operands.
+  void RemapAllIds(const std::unordered_map<uint32_t, uint32_t>& id_map);
+
   // Returns a vector of all decorations affecting |id|. If a group is applied
   // to |id|, the decorations of that group are returned rather than the group
   // decoration instruction. If |include_linkage| is not set, linkage
@@ -158,6 +168,23 @@ class DecorationManager {
   template <typename T>
   std::vector<T> InternalGetDecorationsFor(uint32_t id, bool include_linkage);
 
+  // The canonical form of the decorations applying to an id: the decoration
+  // payloads grouped per opcode, with decoration groups expanded and linkage
+  // decorations excluded, exactly as HaveTheSameDecorations() compares them.
+  // |fingerprint| hashes the four sets, so ids whose fingerprints differ are
+  // guaranteed to have different decorations.
+  struct CanonicalDecorations {
+    std::set<std::u32string> decorate_set;
+    std::set<std::u32string> decorate_id_set;
+    std::set<std::u32string> decorate_string_set;
+    std::set<std::u32string> member_decorate_set;
+    size_t fingerprint = 0;
+  };
+
+  // Returns the canonical decorations for |id|, building and caching them on
+  // first use.
+  const CanonicalDecorations& GetCanonicalDecorations(uint32_t id) const;
+
   // Tracks decoration information of an ID.
   struct TargetData {
     std::vector<Instruction*> direct_decorations;    // All decorate
@@ -200,6 +227,14 @@ class DecorationManager {
   // spv::Op::OpMemberDecorate and spv::Op::OpDecorateId), or indirectly
   // (spv::Op::OpGroupDecorate, spv::Op::OpMemberGroupDecorate).
   std::unordered_map<uint32_t, TargetData> id_to_decoration_insts_;
+  // Cache of canonical decorations, keyed by target id.  Repeated equality
+  // checks (RemoveDuplicatesPass, the linker) hit this cache instead of
+  // rebuilding the sets for every pairwise comparison.  It is invalidated
+  // wholesale whenever a tracked decoration changes: a group decoration can
+  // affect many targets, so clearing everything is both simpler and cheaper
+  // than working out which entries a given mutation reaches.  Mutable since
+  // caching does not change the observable decorations.
+  mutable std::unordered_map<uint32_t, CanonicalDecorations> canonical_cache_;
   // The enclosing module.
   Module* module_;
 };
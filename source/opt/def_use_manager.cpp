@@ -14,6 +14,12 @@
 
 #include "source/opt/def_use_manager.h"
 
+#include <set>
+#include <unordered_set>
+#include <utility>
+
+#include "source/opt/ir_context.h"
+
 namespace spvtools {
 namespace opt {
 namespace analysis {
@@ -44,23 +50,39 @@ void DefUseManager::AnalyzeInstUse(Instruction* inst) {
   }
   used_ids->clear();  // It might have existed before.
 
-  for (uint32_t i = 0; i < inst->NumOperands(); ++i) {
-    switch (inst->GetOperand(i).type) {
-      // For any id type but result id type
-      case SPV_OPERAND_TYPE_ID:
-      case SPV_OPERAND_TYPE_TYPE_ID:
-      case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
-      case SPV_OPERAND_TYPE_SCOPE_ID: {
-        uint32_t use_id = inst->GetSingleWordOperand(i);
-        Instruction* def = GetDef(use_id);
-        assert(def && "Definition is not registered.");
-        id_to_users_.insert(UserEntry{def, inst});
-        used_ids->push_back(use_id);
-      } break;
-      default:
-        break;
+  bool function_known = false;
+  const Function* function = AttributedFunction(inst, &function_known);
+
+  // Walk the operands directly: this is the hottest loop in the analysis,
+  // so it avoids the indexed accessors and iterates every id type except
+  // the result id (the type id counts as a use).
+  for (auto operand = inst->begin(); operand != inst->end(); ++operand) {
+    if (!spvIsIdType(operand->type) ||
+        operand->type == SPV_OPERAND_TYPE_RESULT_ID) {
+      continue;
+    }
+    const uint32_t use_id = operand->words[0];
+    Instruction* def = GetDef(use_id);
+    assert(def && "Definition is not registered.");
+    id_to_users_[def].Insert(inst, function, function_known);
+    used_ids->push_back(use_id);
+  }
+}
+
+const Function* DefUseManager::AttributedFunction(Instruction* inst,
+                                                 bool* known) const {
+  if (analysis_function_known_) {
+    *known = true;
+    return analysis_function_;
+  }
+  if (IRContext* context = inst->context()) {
+    if (BasicBlock* block = context->get_instr_block(inst)) {
+      *known = true;
+      return block->GetParent();
     }
   }
+  *known = false;
+  return nullptr;
 }
 
 void DefUseManager::AnalyzeInstDefUse(Instruction* inst) {
@@ -68,7 +90,9 @@ void DefUseManager::AnalyzeInstDefUse(Instruction* inst) {
   AnalyzeInstUse(inst);
   // Analyze lines last otherwise they will be cleared when inst is
   // cleared by preceding two calls
-  for (auto& l_inst : inst->dbg_line_insts()) AnalyzeInstDefUse(&l_inst);
+  if (inst->has_dbg_line_insts()) {
+    for (auto& l_inst : inst->dbg_line_insts()) AnalyzeInstDefUse(&l_inst);
+  }
 }
 
 void DefUseManager::UpdateDefUse(Instruction* inst) {
@@ -82,6 +106,46 @@ void DefUseManager::UpdateDefUse(Instruction* inst) {
   AnalyzeInstUse(inst);
 }
 
+void DefUseManager::BeginBatchedUpdates() {
+  assert(!batching_updates_ && "Update batches do not nest.");
+  batching_updates_ = true;
+}
+
+void DefUseManager::RecordModifiedInst(Instruction* inst) {
+  assert(batching_updates_ &&
+         "RecordModifiedInst is only valid inside an update batch.");
+  batched_modified_insts_.insert(inst);
+}
+
+void DefUseManager::RecordDeletedInst(Instruction* inst) {
+  // The instruction may be freed before the batch ends, so clear its records
+  // now and make sure we do not touch it again at commit time.
+  batched_modified_insts_.erase(inst);
+  ClearInst(inst);
+}
+
+void DefUseManager::EndBatchedUpdates() {
+  assert(batching_updates_ && "No update batch is open.");
+  // Register every modified def first: a buffered instruction may use an id
+  // whose (re)definition is also buffered, and AnalyzeInstUse requires the
+  // definition to be registered.  Skip instructions that already define
+  // their id; re-registering them would clear their own user list.
+  for (Instruction* inst : batched_modified_insts_) {
+    const uint32_t def_id = inst->result_id();
+    if (def_id != 0 && GetDef(def_id) != inst) {
+      AnalyzeInstDef(inst);
+    }
+  }
+  for (Instruction* inst : batched_modified_insts_) {
+    AnalyzeInstUse(inst);
+    if (inst->has_dbg_line_insts()) {
+      for (auto& l_inst : inst->dbg_line_insts()) AnalyzeInstDefUse(&l_inst);
+    }
+  }
+  batched_modified_insts_.clear();
+  batching_updates_ = false;
+}
+
 Instruction* DefUseManager::GetDef(uint32_t id) {
   auto iter = id_to_def_.find(id);
   if (iter == id_to_def_.end()) return nullptr;
@@ -94,23 +158,65 @@ const Instruction* DefUseManager::GetDef(uint32_t id) const {
   return iter->second;
 }
 
-DefUseManager::IdToUsersMap::const_iterator DefUseManager::UsersBegin(
-    const Instruction* def) const {
-  return id_to_users_.lower_bound(
-      UserEntry{const_cast<Instruction*>(def), nullptr});
+void UserList::Insert(Instruction* user, const Function* function,
+                      bool function_known) {
+  const uint32_t slot = static_cast<uint32_t>(users.size());
+  if (!position.emplace(user, slot).second) return;
+  users.push_back(user);
+  slot_functions.push_back(function_known ? function : nullptr);
+  if (function_known) {
+    slots_by_function[function].push_back(slot);
+  } else {
+    unattributed_slots.push_back(slot);
+  }
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const IdToUsersMap::const_iterator& cached_end,
-                                const Instruction* inst) const {
-  return (iter != cached_end && iter->def == inst);
+void UserList::Erase(const Instruction* user) {
+  auto iter = position.find(user);
+  if (iter == position.end()) return;
+  users[iter->second] = nullptr;
+  position.erase(iter);
+  // Reclaim tombstones once they dominate the vector, unless a walk is in
+  // progress: walks iterate by index and rely on slots staying put.
+  if (active_walks == 0 && position.size() * 2 < users.size()) Compact();
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const Instruction* inst) const {
-  return UsersNotEnd(iter, id_to_users_.end(), inst);
+void UserList::Compact() {
+  const std::unordered_set<uint32_t> unattributed(unattributed_slots.begin(),
+                                                  unattributed_slots.end());
+  slots_by_function.clear();
+  unattributed_slots.clear();
+  size_t live = 0;
+  for (size_t i = 0; i < users.size(); ++i) {
+    Instruction* user = users[i];
+    if (!user) continue;
+    const uint32_t slot = static_cast<uint32_t>(live);
+    position[user] = slot;
+    users[live] = user;
+    slot_functions[live] = slot_functions[i];
+    if (unattributed.count(static_cast<uint32_t>(i))) {
+      unattributed_slots.push_back(slot);
+    } else {
+      slots_by_function[slot_functions[i]].push_back(slot);
+    }
+    ++live;
+  }
+  users.resize(live);
+  slot_functions.resize(live);
 }
 
+namespace {
+// Tracks a walk over a UserList for the duration of a scope, so that erasures
+// during the walk only tombstone slots instead of moving them.
+struct UserListWalkGuard {
+  explicit UserListWalkGuard(const UserList* l) : list(l) {
+    ++list->active_walks;
+  }
+  ~UserListWalkGuard() { --list->active_walks; }
+  const UserList* list;
+};
+}  // namespace
+
 bool DefUseManager::WhileEachUser(
     const Instruction* def, const std::function<bool(Instruction*)>& f) const {
   // Ensure that |def| has been registered.
@@ -118,9 +224,15 @@ bool DefUseManager::WhileEachUser(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    if (!f(iter->user)) return false;
+  auto iter = id_to_users_.find(def);
+  if (iter == id_to_users_.end()) return true;
+  const UserList& list = iter->second;
+  UserListWalkGuard guard(&list);
+  // Iterate by index: |f| may insert or erase use records, which can grow the
+  // vector or tombstone entries, but never moves live slots mid-walk.
+  for (size_t i = 0; i < list.users.size(); ++i) {
+    Instruction* user = list.users[i];
+    if (user && !f(user)) return false;
   }
   return true;
 }
@@ -130,6 +242,50 @@ bool DefUseManager::WhileEachUser(
   return WhileEachUser(GetDef(id), f);
 }
 
+bool DefUseManager::WhileEachUser(
+    const Instruction* def, const Function* function,
+    const std::function<bool(Instruction*)>& f) const {
+  // Ensure that |def| has been registered.
+  assert(def && (!def->HasResultId() || def == GetDef(def->result_id())) &&
+         "Definition is not registered.");
+  assert(function && "A function to scope the walk to is required.");
+  if (!def->HasResultId()) return true;
+
+  auto iter = id_to_users_.find(def);
+  if (iter == id_to_users_.end()) return true;
+  const UserList& list = iter->second;
+  UserListWalkGuard guard(&list);
+  // Walk the partition attributed to |function|.  Hold a reference rather
+  // than an iterator: |f| may add use records, and rehashing moves iterators
+  // but not the mapped vectors.  Iterate by index, as the base walk does.
+  auto partition_iter = list.slots_by_function.find(function);
+  if (partition_iter != list.slots_by_function.end()) {
+    const std::vector<uint32_t>& partition = partition_iter->second;
+    for (size_t i = 0; i < partition.size(); ++i) {
+      Instruction* user = list.users[partition[i]];
+      if (user && !f(user)) return false;
+    }
+  }
+  // Users recorded before their containing function was known are resolved
+  // against the instruction-to-block mapping now.
+  for (size_t i = 0; i < list.unattributed_slots.size(); ++i) {
+    Instruction* user = list.users[list.unattributed_slots[i]];
+    if (!user) continue;
+    IRContext* context = user->context();
+    if (!context) continue;
+    BasicBlock* block = context->get_instr_block(user);
+    if (!block || block->GetParent() != function) continue;
+    if (!f(user)) return false;
+  }
+  return true;
+}
+
+bool DefUseManager::WhileEachUser(
+    uint32_t id, const Function* function,
+    const std::function<bool(Instruction*)>& f) const {
+  return WhileEachUser(GetDef(id), function, f);
+}
+
 void DefUseManager::ForEachUser(
     const Instruction* def, const std::function<void(Instruction*)>& f) const {
   WhileEachUser(def, [&f](Instruction* user) {
@@ -143,6 +299,21 @@ void DefUseManager::ForEachUser(
   ForEachUser(GetDef(id), f);
 }
 
+void DefUseManager::ForEachUser(
+    const Instruction* def, const Function* function,
+    const std::function<void(Instruction*)>& f) const {
+  WhileEachUser(def, function, [&f](Instruction* user) {
+    f(user);
+    return true;
+  });
+}
+
+void DefUseManager::ForEachUser(
+    uint32_t id, const Function* function,
+    const std::function<void(Instruction*)>& f) const {
+  ForEachUser(GetDef(id), function, f);
+}
+
 bool DefUseManager::WhileEachUse(
     const Instruction* def,
     const std::function<bool(Instruction*, uint32_t)>& f) const {
@@ -151,9 +322,13 @@ bool DefUseManager::WhileEachUse(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    Instruction* user = iter->user;
+  auto iter = id_to_users_.find(def);
+  if (iter == id_to_users_.end()) return true;
+  const UserList& list = iter->second;
+  UserListWalkGuard guard(&list);
+  for (size_t i = 0; i < list.users.size(); ++i) {
+    Instruction* user = list.users[i];
+    if (!user) continue;
     for (uint32_t idx = 0; idx != user->NumOperands(); ++idx) {
       const Operand& op = user->GetOperand(idx);
       if (op.type != SPV_OPERAND_TYPE_RESULT_ID && spvIsIdType(op.type)) {
@@ -224,9 +399,30 @@ void DefUseManager::AnalyzeDefUse(Module* module) {
   module->ForEachInst(
       std::bind(&DefUseManager::AnalyzeInstDef, this, std::placeholders::_1),
       true);
+  // Track the containing function directly while walking the uses, so each
+  // use record can be attributed without an instruction-to-block lookup.
+  // The block mapping may not be built yet when the analysis runs.
+  std::unordered_map<const Instruction*, const Function*> func_by_def_inst;
+  for (Function& function : *module) {
+    func_by_def_inst[&function.DefInst()] = &function;
+  }
+  analysis_function_ = nullptr;
+  analysis_function_known_ = true;
   module->ForEachInst(
-      std::bind(&DefUseManager::AnalyzeInstUse, this, std::placeholders::_1),
+      [this, &func_by_def_inst](Instruction* inst) {
+        if (inst->opcode() == spv::Op::OpFunction) {
+          auto iter = func_by_def_inst.find(inst);
+          analysis_function_ =
+              iter == func_by_def_inst.end() ? nullptr : iter->second;
+        }
+        AnalyzeInstUse(inst);
+        if (inst->opcode() == spv::Op::OpFunctionEnd) {
+          analysis_function_ = nullptr;
+        }
+      },
       true);
+  analysis_function_known_ = false;
+  analysis_function_ = nullptr;
 }
 
 void DefUseManager::ClearInst(Instruction* inst) {
@@ -235,12 +431,7 @@ void DefUseManager::ClearInst(Instruction* inst) {
     EraseUseRecordsOfOperandIds(inst);
     if (inst->result_id() != 0) {
       // Remove all uses of this inst.
-      auto users_begin = UsersBegin(inst);
-      auto end = id_to_users_.end();
-      auto new_end = users_begin;
-      for (; UsersNotEnd(new_end, end, inst); ++new_end) {
-      }
-      id_to_users_.erase(users_begin, new_end);
+      id_to_users_.erase(inst);
       id_to_def_.erase(inst->result_id());
     }
   }
@@ -252,8 +443,10 @@ void DefUseManager::EraseUseRecordsOfOperandIds(const Instruction* inst) {
   auto iter = inst_to_used_ids_.find(inst);
   if (iter != inst_to_used_ids_.end()) {
     for (auto use_id : iter->second) {
-      id_to_users_.erase(
-          UserEntry{GetDef(use_id), const_cast<Instruction*>(inst)});
+      auto users_iter = id_to_users_.find(GetDef(use_id));
+      if (users_iter != id_to_users_.end()) {
+        users_iter->second.Erase(inst);
+      }
     }
     inst_to_used_ids_.erase(iter);
   }
@@ -277,14 +470,27 @@ bool CompareAndPrintDifferences(const DefUseManager& lhs,
     same = false;
   }
 
-  if (lhs.id_to_users_ != rhs.id_to_users_) {
-    for (auto p : lhs.id_to_users_) {
-      if (rhs.id_to_users_.count(p) == 0) {
+  // Compare the live (def, user) pairs; vector slot order and tombstones are
+  // layout details that do not affect equivalence.
+  const auto collect_users = [](const DefUseManager& manager) {
+    std::set<std::pair<const Instruction*, const Instruction*>> entries;
+    for (const auto& kv : manager.id_to_users_) {
+      for (const Instruction* user : kv.second.users) {
+        if (user) entries.insert({kv.first, user});
+      }
+    }
+    return entries;
+  };
+  const auto lhs_users = collect_users(lhs);
+  const auto rhs_users = collect_users(rhs);
+  if (lhs_users != rhs_users) {
+    for (const auto& p : lhs_users) {
+      if (rhs_users.count(p) == 0) {
         printf("Diff in id_to_users: missing value in rhs\n");
       }
     }
-    for (auto p : rhs.id_to_users_) {
-      if (lhs.id_to_users_.count(p) == 0) {
+    for (const auto& p : rhs_users) {
+      if (lhs_users.count(p) == 0) {
         printf("Diff in id_to_users: missing value in lhs\n");
       }
     }
@@ -15,8 +15,8 @@
 #ifndef SOURCE_OPT_DEF_USE_MANAGER_H_
 #define SOURCE_OPT_DEF_USE_MANAGER_H_
 
-#include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "source/opt/instruction.h"
@@ -49,48 +49,47 @@ inline bool operator<(const Use& lhs, const Use& rhs) {
   return lhs.operand_index < rhs.operand_index;
 }
 
-// Definition should never be null. User can be null, however, such an entry
-// should be used only for searching (e.g. all users of a particular definition)
-// and never stored in a container.
-struct UserEntry {
-  Instruction* def;
-  Instruction* user;
-};
-
-inline bool operator==(const UserEntry& lhs, const UserEntry& rhs) {
-  return lhs.def == rhs.def && lhs.user == rhs.user;
-}
-
-// Orders UserEntry for use in associative containers (i.e. less than ordering).
-//
-// The definition of an UserEntry is treated as the major key and the users as
-// the minor key so that all the users of a particular definition are
-// consecutive in a container.
+// Stores the unique users of a single definition as a flat vector so that
+// use-list walks touch contiguous memory instead of chasing tree nodes.
+// Users appear in insertion order.  Erasing a user tombstones its slot with
+// nullptr; slots are reclaimed once dead entries outnumber live ones, and
+// reclamation is deferred while any walk is in progress so that callbacks may
+// erase or insert use records without invalidating the walk.
 //
-// A null user always compares less than a real user. This is done to provide
-// easy values to search for the beginning of the users of a particular
-// definition (i.e. using {def, nullptr}).
-struct UserEntryLess {
-  bool operator()(const UserEntry& lhs, const UserEntry& rhs) const {
-    // If lhs.def and rhs.def are both null, fall through to checking the
-    // second entries.
-    if (!lhs.def && rhs.def) return true;
-    if (lhs.def && !rhs.def) return false;
-
-    // If neither definition is null, then compare unique ids.
-    if (lhs.def && rhs.def) {
-      if (lhs.def->unique_id() < rhs.def->unique_id()) return true;
-      if (rhs.def->unique_id() < lhs.def->unique_id()) return false;
-    }
-
-    // Return false on equality.
-    if (!lhs.user && !rhs.user) return false;
-    if (!lhs.user) return true;
-    if (!rhs.user) return false;
-
-    // If neither user is null then compare unique ids.
-    return lhs.user->unique_id() < rhs.user->unique_id();
-  }
+// Slots are additionally partitioned by the function containing the user, so
+// function-scoped walks only touch the partition they ask for instead of
+// filtering the whole list.
+struct UserList {
+  // Unique user instructions in insertion order; nullptr marks a tombstone.
+  std::vector<Instruction*> users;
+  // Function attributed to each slot, parallel to |users|: the function
+  // whose body contains the user, or nullptr for module-scope users and for
+  // slots listed in |unattributed_slots|.
+  std::vector<const Function*> slot_functions;
+  // Position in |users| of each live user.
+  std::unordered_map<const Instruction*, uint32_t> position;
+  // Slots grouped by attributed function; the nullptr key groups module-
+  // scope users.  Entries may refer to tombstoned slots, which walks skip.
+  std::unordered_map<const Function*, std::vector<uint32_t>> slots_by_function;
+  // Slots recorded without a known containing function, e.g. because the
+  // user was analyzed before being inserted into a block.  Function-scoped
+  // walks resolve these against the instruction-to-block mapping at query
+  // time.
+  std::vector<uint32_t> unattributed_slots;
+  // Number of walks currently traversing |users|.  Compaction is deferred
+  // while this is nonzero.
+  mutable uint32_t active_walks = 0;
+
+  // Adds |user| if not already present, attributed to |function| when
+  // |function_known| is true and to the unattributed bucket otherwise.
+  void Insert(Instruction* user, const Function* function,
+              bool function_known);
+
+  // Tombstones |user|'s slot.  Does nothing if |user| is not present.
+  void Erase(const Instruction* user);
+
+  // Drops tombstoned slots and reindexes the live users.
+  void Compact();
 };
 
 // A class for analyzing and managing defs and uses in an Module.
@@ -137,6 +136,19 @@ class DefUseManager {
   void ForEachUser(uint32_t id,
                    const std::function<void(Instruction*)>& f) const;
 
+  // Runs the given function |f| on each unique user of |def| (or |id|) whose
+  // use site lies in |function|.  Module-scope users such as decorations and
+  // names are not visited.  The walk is backed by the per-function
+  // partitions of the user index, so it does not traverse users in other
+  // functions.  A user that moved to a different function is reflected here
+  // once it is re-analyzed, like any other def-use update.
+  //
+  // |def| (or |id|) must be registered as a definition.
+  void ForEachUser(const Instruction* def, const Function* function,
+                   const std::function<void(Instruction*)>& f) const;
+  void ForEachUser(uint32_t id, const Function* function,
+                   const std::function<void(Instruction*)>& f) const;
+
   // Runs the given function |f| on each unique user instruction of |def| (or
   // |id|). If |f| returns false, iteration is terminated and this function
   // returns false.
@@ -150,6 +162,13 @@ class DefUseManager {
   bool WhileEachUser(uint32_t id,
                      const std::function<bool(Instruction*)>& f) const;
 
+  // Function-scoped variants of the above; see the function-scoped
+  // ForEachUser for the exact semantics.
+  bool WhileEachUser(const Instruction* def, const Function* function,
+                     const std::function<bool(Instruction*)>& f) const;
+  bool WhileEachUser(uint32_t id, const Function* function,
+                     const std::function<bool(Instruction*)>& f) const;
+
   // Runs the given function |f| on each unique use of |def| (or
   // |id|).
   //
@@ -214,35 +233,63 @@ class DefUseManager {
   // uses.
   void UpdateDefUse(Instruction* inst);
 
+  // Starts buffering incremental updates.  Between BeginBatchedUpdates() and
+  // EndBatchedUpdates(), instructions reported through RecordModifiedInst()
+  // are not re-analyzed immediately; the manager patches the affected
+  // |id_to_def_| and |id_to_users_| entries once when the batch ends.  This
+  // lets passes that rewrite many instructions keep the analysis valid
+  // without either re-analyzing an instruction per operand edit or dropping
+  // the whole analysis and rescanning the module.  Batches do not nest.
+  void BeginBatchedUpdates();
+
+  // Records that the operands or result id of |inst| have changed and its
+  // def-use records must be refreshed when the current batch ends.  Must only
+  // be called between BeginBatchedUpdates() and EndBatchedUpdates().
+  void RecordModifiedInst(Instruction* inst);
+
+  // Records that |inst| is about to be deleted.  Its records are cleared
+  // immediately (the instruction's memory may be freed before the batch
+  // ends), and any pending modification record for it is dropped.
+  void RecordDeletedInst(Instruction* inst);
+
+  // Applies all pending modification records and stops buffering.  Missing
+  // defs are registered before any uses so records may refer to each other
+  // in any order.
+  void EndBatchedUpdates();
+
+  // Returns true if an update batch is open.
+  bool BatchingUpdates() const { return batching_updates_; }
+
  private:
-  using IdToUsersMap = std::set<UserEntry, UserEntryLess>;
+  using IdToUsersMap = std::unordered_map<const Instruction*, UserList>;
   using InstToUsedIdsMap =
       std::unordered_map<const Instruction*, std::vector<uint32_t>>;
 
-  // Returns the first location that {|def|, nullptr} could be inserted into the
-  // users map without violating ordering.
-  IdToUsersMap::const_iterator UsersBegin(const Instruction* def) const;
-
-  // Returns true if |iter| has not reached the end of |def|'s users.
-  //
-  // In the first version |iter| is compared against the end of the map for
-  // validity before other checks. In the second version, |iter| is compared
-  // against |cached_end| for validity before other checks. This allows caching
-  // the map's end which is a performance improvement on some platforms.
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const Instruction* def) const;
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const IdToUsersMap::const_iterator& cached_end,
-                   const Instruction* def) const;
-
   // Analyzes the defs and uses in the given |module| and populates data
   // structures in this class. Does nothing if |module| is nullptr.
   void AnalyzeDefUse(Module* module);
 
+  // Returns the function to attribute a use by |inst| to, setting |known| to
+  // false if it cannot be determined.  During the bulk module analysis the
+  // containing function is tracked directly; for incremental updates it is
+  // looked up through the instruction-to-block mapping.
+  const Function* AttributedFunction(Instruction* inst, bool* known) const;
+
   IdToDefMap id_to_def_;      // Mapping from ids to their definitions
   IdToUsersMap id_to_users_;  // Mapping from ids to their users
   // Mapping from instructions to the ids used in the instruction.
   InstToUsedIdsMap inst_to_used_ids_;
+
+  // Function currently being walked by the bulk module analysis, valid only
+  // while |analysis_function_known_| is true; nullptr for the module-scope
+  // sections.
+  const Function* analysis_function_ = nullptr;
+  bool analysis_function_known_ = false;
+
+  // True while an update batch is open.
+  bool batching_updates_ = false;
+  // Instructions whose records must be refreshed when the batch ends.
+  std::unordered_set<Instruction*> batched_modified_insts_;
 };
 
 }  // namespace analysis
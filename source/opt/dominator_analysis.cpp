@@ -52,6 +52,7 @@ bool DominatorAnalysisBase::Dominates(Instruction* a, Instruction* b) const {
   BasicBlock* bb_b = b->context()->get_instr_block(b);
 
   if (bb_a != bb_b) {
+    EnsureInitialized();
     return tree_.Dominates(bb_a, bb_b);
   }
 
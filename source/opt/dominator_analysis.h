@@ -30,9 +30,33 @@ class DominatorAnalysisBase {
 
   // Calculates the dominator (or postdominator) tree for given function |f|.
   inline void InitializeTree(const CFG& cfg, const Function* f) {
+    deferred_cfg_ = nullptr;
+    deferred_function_ = nullptr;
     tree_.InitializeTree(cfg, f);
   }
 
+  // Records |cfg| and |f| without computing the tree.  The tree is
+  // materialized by the first query, so functions that are never asked a
+  // dominance question never pay for tree construction.  |cfg| and |f| must
+  // stay valid until then.
+  inline void DeferInitialization(const CFG& cfg, const Function* f) {
+    tree_.ClearTree();
+    deferred_cfg_ = &cfg;
+    deferred_function_ = f;
+  }
+
+  // Rebuilds the tree for |f| from the recorded immediate dominators |idoms|
+  // instead of computing it from |cfg|. Returns false and leaves the
+  // analysis uninitialized when the recording is malformed or, when |verify|
+  // is set, inconsistent with the CFG.
+  inline bool InitializeFromIdoms(const CFG& cfg, const Function* f,
+                                  const std::map<uint32_t, uint32_t>& idoms,
+                                  bool verify) {
+    deferred_cfg_ = nullptr;
+    deferred_function_ = nullptr;
+    return tree_.InitializeFromIdoms(cfg, f, idoms, verify);
+  }
+
   // Returns true if BasicBlock |a| dominates BasicBlock |b|.
   inline bool Dominates(const BasicBlock* a, const BasicBlock* b) const {
     if (!a || !b) return false;
@@ -42,6 +66,7 @@ class DominatorAnalysisBase {
   // Returns true if BasicBlock |a| dominates BasicBlock |b|. Same as above only
   // using the BasicBlock IDs.
   inline bool Dominates(uint32_t a, uint32_t b) const {
+    EnsureInitialized();
     return tree_.Dominates(a, b);
   }
 
@@ -58,6 +83,7 @@ class DominatorAnalysisBase {
   // Returns true if BasicBlock |a| strictly dominates BasicBlock |b|. Same as
   // above only using the BasicBlock IDs.
   inline bool StrictlyDominates(uint32_t a, uint32_t b) const {
+    EnsureInitialized();
     return tree_.StrictlyDominates(a, b);
   }
 
@@ -65,50 +91,73 @@ class DominatorAnalysisBase {
   // no dominator.
   inline BasicBlock* ImmediateDominator(const BasicBlock* node) const {
     if (!node) return nullptr;
+    EnsureInitialized();
     return tree_.ImmediateDominator(node);
   }
 
   // Returns the immediate dominator of |node_id| or returns nullptr if it is
   // has no dominator. Same as above but operates on IDs.
   inline BasicBlock* ImmediateDominator(uint32_t node_id) const {
+    EnsureInitialized();
     return tree_.ImmediateDominator(node_id);
   }
 
   // Returns true if |node| is reachable from the entry.
   inline bool IsReachable(const BasicBlock* node) const {
     if (!node) return false;
+    EnsureInitialized();
     return tree_.ReachableFromRoots(node->id());
   }
 
   // Returns true if |node_id| is reachable from the entry.
   inline bool IsReachable(uint32_t node_id) const {
+    EnsureInitialized();
     return tree_.ReachableFromRoots(node_id);
   }
 
   // Dump the tree structure into the given |out| stream in the dot format.
-  inline void DumpAsDot(std::ostream& out) const { tree_.DumpTreeAsDot(out); }
+  inline void DumpAsDot(std::ostream& out) const {
+    EnsureInitialized();
+    tree_.DumpTreeAsDot(out);
+  }
 
   // Returns true if this is a postdomiator tree.
   inline bool IsPostDominator() const { return tree_.IsPostDominator(); }
 
+  // Returns true if the tree has been materialized.  A deferred tree is
+  // built from the current CFG on first query, so it cannot be stale.
+  inline bool IsMaterialized() const { return deferred_function_ == nullptr; }
+
   // Returns the tree itself for manual operations, such as traversing the
   // roots.
   // For normal dominance relationships the methods above should be used.
-  inline DominatorTree& GetDomTree() { return tree_; }
-  inline const DominatorTree& GetDomTree() const { return tree_; }
+  inline DominatorTree& GetDomTree() {
+    EnsureInitialized();
+    return tree_;
+  }
+  inline const DominatorTree& GetDomTree() const {
+    EnsureInitialized();
+    return tree_;
+  }
 
   // Force the dominator tree to be removed
-  inline void ClearTree() { tree_.ClearTree(); }
+  inline void ClearTree() {
+    deferred_cfg_ = nullptr;
+    deferred_function_ = nullptr;
+    tree_.ClearTree();
+  }
 
   // Applies the std::function |func| to dominator tree nodes in dominator
   // order.
   void Visit(std::function<bool(DominatorTreeNode*)> func) {
+    EnsureInitialized();
     tree_.Visit(func);
   }
 
   // Applies the std::function |func| to dominator tree nodes in dominator
   // order.
   void Visit(std::function<bool(const DominatorTreeNode*)> func) const {
+    EnsureInitialized();
     tree_.Visit(func);
   }
 
@@ -117,7 +166,25 @@ class DominatorAnalysisBase {
   BasicBlock* CommonDominator(BasicBlock* b1, BasicBlock* b2) const;
 
  protected:
+  // Builds the tree recorded by DeferInitialization if it has not been built
+  // yet.  Queries are logically const, so the lazily materialized tree is
+  // mutable state.
+  inline void EnsureInitialized() const {
+    if (!deferred_function_) return;
+    const CFG* cfg = deferred_cfg_;
+    const Function* f = deferred_function_;
+    deferred_cfg_ = nullptr;
+    deferred_function_ = nullptr;
+    const_cast<DominatorTree&>(tree_).InitializeTree(*cfg, f);
+  }
+
   DominatorTree tree_;
+
+ private:
+  // Function (and CFG) whose tree construction has been deferred, or null if
+  // the tree is already materialized.
+  mutable const CFG* deferred_cfg_ = nullptr;
+  mutable const Function* deferred_function_ = nullptr;
 };
 
 // Derived class for normal dominator analysis.
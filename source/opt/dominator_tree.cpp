@@ -344,6 +344,106 @@ void DominatorTree::InitializeTree(const CFG& cfg, const Function* f) {
   ResetDFNumbering();
 }
 
+bool DominatorTree::InitializeFromIdoms(
+    const CFG& cfg, const Function* f,
+    const std::map<uint32_t, uint32_t>& idoms, bool verify) {
+  ClearTree();
+
+  // Skip over empty functions.
+  if (f->cbegin() == f->cend()) {
+    return idoms.empty();
+  }
+
+  // BB are derived from F, so we need to const cast it at some point
+  // no modification is made on F.
+  Function* function = const_cast<Function*>(f);
+  std::map<uint32_t, BasicBlock*> blocks;
+  for (BasicBlock& bb : *function) {
+    blocks[bb.id()] = &bb;
+  }
+
+  // The recorded tree hangs off the same placeholder node the computed tree
+  // uses; an idom of 0 links a block directly below it.
+  BasicBlock* placeholder = const_cast<BasicBlock*>(
+      postdominator_ ? cfg.pseudo_exit_block() : cfg.pseudo_entry_block());
+  DominatorTreeNode* root = GetOrInsertNode(placeholder);
+  roots_.push_back(root);
+
+  for (const auto& pair : idoms) {
+    auto block_iter = blocks.find(pair.first);
+    if (block_iter == blocks.end()) {
+      ClearTree();
+      return false;
+    }
+    DominatorTreeNode* parent = root;
+    if (pair.second != 0) {
+      auto parent_iter = blocks.find(pair.second);
+      if (parent_iter == blocks.end() || idoms.count(pair.second) == 0) {
+        ClearTree();
+        return false;
+      }
+      parent = GetOrInsertNode(parent_iter->second);
+    }
+    DominatorTreeNode* node = GetOrInsertNode(block_iter->second);
+    node->parent_ = parent;
+    parent->children_.push_back(node);
+  }
+  ResetDFNumbering();
+
+  // A cycle among the recorded parents leaves its nodes unreachable from the
+  // root, and therefore unnumbered.
+  for (const auto& node : nodes_) {
+    if (node.second.dfs_num_pre_ < 0) {
+      ClearTree();
+      return false;
+    }
+  }
+
+  if (verify && !postdominator_) {
+    // The dominator tree is a fixpoint of the usual dataflow equations: the
+    // immediate dominator of every block is the nearest common ancestor of
+    // the block's reachable predecessors, and the entry hangs off the
+    // placeholder root. Check that the recorded tree satisfies them; walking
+    // parents from a predecessor to the common ancestor keeps this close to
+    // linear on structured control flow.
+    std::map<uint32_t, DominatorTreeNode*> pred_ancestor;
+    bool consistent = true;
+    for (BasicBlock& bb : *function) {
+      DominatorTreeNode* from = GetTreeNode(bb.id());
+      if (from == nullptr) continue;
+      bb.ForEachSuccessorLabel(
+          [this, from, &pred_ancestor, &consistent](uint32_t to_id) {
+            if (GetTreeNode(to_id) == nullptr) {
+              // A reachable block branches to a block the recording calls
+              // unreachable.
+              consistent = false;
+              return;
+            }
+            auto iter = pred_ancestor.find(to_id);
+            if (iter == pred_ancestor.end()) {
+              pred_ancestor[to_id] = from;
+              return;
+            }
+            DominatorTreeNode* ancestor = iter->second;
+            while (!Dominates(ancestor, from)) ancestor = ancestor->parent_;
+            iter->second = ancestor;
+          });
+    }
+    for (const auto& node : nodes_) {
+      if (&node.second == root) continue;
+      auto iter = pred_ancestor.find(node.first);
+      DominatorTreeNode* expected =
+          iter == pred_ancestor.end() ? root : iter->second;
+      if (node.second.parent_ != expected) consistent = false;
+    }
+    if (!consistent) {
+      ClearTree();
+      return false;
+    }
+  }
+  return true;
+}
+
 void DominatorTree::ResetDFNumbering() {
   int index = 0;
   auto preFunc = [&index](const DominatorTreeNode* node) {
@@ -160,6 +160,18 @@ class DominatorTree {
   // existing data in the dominator tree will be overwritten
   void InitializeTree(const CFG& cfg, const Function* f);
 
+  // Build the tree for |f| from recorded immediate dominators instead of
+  // computing them. |idoms| maps the id of each reachable basic block to the
+  // id of its immediate dominator; the function entry (or, for a
+  // postdominator tree, each exit) records 0 and hangs off the same
+  // placeholder root InitializeTree uses. Returns false and clears the tree
+  // when the recording does not describe a tree over |f|'s blocks, or, when
+  // |verify| is set, when a linear-time consistency check against the CFG
+  // fails.
+  bool InitializeFromIdoms(const CFG& cfg, const Function* f,
+                           const std::map<uint32_t, uint32_t>& idoms,
+                           bool verify);
+
   // Check if the basic block |a| dominates the basic block |b|.
   bool Dominates(const BasicBlock* a, const BasicBlock* b) const;
 
@@ -202,6 +214,9 @@ class DominatorTree {
   // Returns true if this tree is a post dominator tree.
   bool IsPostDominator() const { return postdominator_; }
 
+  // Returns true if the tree contains no nodes.
+  bool empty() const { return nodes_.empty(); }
+
   // Clean up the tree.
   void ClearTree() {
     nodes_.clear();
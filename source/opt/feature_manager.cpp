@@ -14,12 +14,104 @@
 
 #include "source/opt/feature_manager.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "source/enum_string_mapping.h"
+#include "source/table.h"
 
 namespace spvtools {
 namespace opt {
+namespace {
+
+// Transitive closures of the capability implication graph, built once per
+// target environment on first use and shared by every module processed
+// afterwards.  AddCapability used to walk the graph with one grammar lookup
+// per implied capability for every module; with the closures an addition is
+// one table probe and a set union.
+class CapabilityClosure {
+ public:
+  // Returns the closure table for |grammar|'s target environment.  The
+  // grammar tables are fixed when this library is built, so the tables can
+  // be cached for the lifetime of the process.
+  static const CapabilityClosure& Get(const AssemblyGrammar& grammar) {
+    static std::mutex cache_mutex;
+    static auto* cache =
+        new std::map<spv_target_env, std::unique_ptr<CapabilityClosure>>();
+
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    std::unique_ptr<CapabilityClosure>& entry = (*cache)[grammar.target_env()];
+    if (entry == nullptr) {
+      entry.reset(new CapabilityClosure(grammar));
+    }
+    return *entry;
+  }
+
+  // Returns the set holding |cap| and every capability it transitively
+  // implies, or nullptr when the grammar does not know |cap|.
+  const CapabilitySet* GetImpliedCapabilities(spv::Capability cap) const {
+    auto it = closures_.find(static_cast<uint32_t>(cap));
+    return it == closures_.end() ? nullptr : &it->second;
+  }
+
+ private:
+  explicit CapabilityClosure(const AssemblyGrammar& grammar) {
+    // The env-filtered AssemblyGrammar interface can only look up individual
+    // values, so enumerate the capabilities through the operand table.
+    spv_operand_table table = nullptr;
+    if (spvOperandTableGet(&table, grammar.target_env()) != SPV_SUCCESS) {
+      return;
+    }
+
+    // Seed each capability with itself and its direct implications.  Going
+    // through |grammar| keeps the choice among aliased entries identical to
+    // the lookup done for each capability before the closures existed.
+    for (uint32_t group_index = 0; group_index < table->count; ++group_index) {
+      const spv_operand_desc_group_t& group = table->types[group_index];
+      if (group.type != SPV_OPERAND_TYPE_CAPABILITY) continue;
+      for (uint32_t i = 0; i < group.count; ++i) {
+        const uint32_t value = group.entries[i].value;
+        if (closures_.count(value)) continue;  // Aliases share a value.
+        CapabilitySet& closure = closures_[value];
+        closure.Add(static_cast<spv::Capability>(value));
+        spv_operand_desc desc = {};
+        if (SPV_SUCCESS == grammar.lookupOperand(SPV_OPERAND_TYPE_CAPABILITY,
+                                                 value, &desc)) {
+          for (uint32_t j = 0; j < desc->numCapabilities; ++j) {
+            closure.Add(desc->capabilities[j]);
+          }
+        }
+      }
+    }
+
+    // Expand the direct implications to the transitive closure.  The graph
+    // is tiny, so a fixpoint iteration is cheaper than maintaining a
+    // topological order, and it does not care whether the graph has cycles.
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (auto& entry : closures_) {
+        CapabilitySet expanded = entry.second;
+        entry.second.ForEach([this, &expanded](spv::Capability member) {
+          auto it = closures_.find(static_cast<uint32_t>(member));
+          if (it == closures_.end()) return;
+          expanded.AddAll(it->second);
+        });
+        if (expanded != entry.second) {
+          entry.second = std::move(expanded);
+          changed = true;
+        }
+      }
+    }
+  }
+
+  std::unordered_map<uint32_t, CapabilitySet> closures_;
+};
+
+}  // namespace
 
 void FeatureManager::Analyze(Module* module) {
   AddExtensions(module);
@@ -52,14 +144,13 @@ void FeatureManager::RemoveExtension(Extension ext) {
 void FeatureManager::AddCapability(spv::Capability cap) {
   if (capabilities_.Contains(cap)) return;
 
-  capabilities_.Add(cap);
-
-  spv_operand_desc desc = {};
-  if (SPV_SUCCESS == grammar_.lookupOperand(SPV_OPERAND_TYPE_CAPABILITY,
-                                            uint32_t(cap), &desc)) {
-    CapabilitySet(desc->numCapabilities, desc->capabilities)
-        .ForEach([this](spv::Capability c) { AddCapability(c); });
+  const CapabilitySet* closure =
+      CapabilityClosure::Get(grammar_).GetImpliedCapabilities(cap);
+  if (closure == nullptr) {
+    capabilities_.Add(cap);
+    return;
   }
+  capabilities_.AddAll(*closure);
 }
 
 void FeatureManager::RemoveCapability(spv::Capability cap) {
@@ -73,6 +164,16 @@ void FeatureManager::AddCapabilities(Module* module) {
   }
 }
 
+void FeatureManager::RecomputeCapabilities(Module* module) {
+  capabilities_ = CapabilitySet();
+  AddCapabilities(module);
+}
+
+void FeatureManager::RecomputeExtensions(Module* module) {
+  extensions_ = ExtensionSet();
+  AddExtensions(module);
+}
+
 void FeatureManager::AddExtInstImportIds(Module* module) {
   extinst_importid_GLSLstd450_ = module->GetExtInstImportId("GLSL.std.450");
   extinst_importid_OpenCL100DebugInfo_ =
@@ -44,6 +44,16 @@ class FeatureManager {
   // Analyzes |module| and records enabled extensions and capabilities.
   void Analyze(Module* module);
 
+  // Recomputes the enabled capabilities from the OpCapability instructions
+  // remaining in |module|.  Called after a declaration was removed: the
+  // removed capability may still be implied by another declaration, so the
+  // set is rebuilt from the declaration section instead of just dropping it.
+  void RecomputeCapabilities(Module* module);
+
+  // Recomputes the enabled extensions from the OpExtension instructions
+  // remaining in |module|, after a declaration was removed.
+  void RecomputeExtensions(Module* module);
+
   CapabilitySet* GetCapabilities() { return &capabilities_; }
   const CapabilitySet* GetCapabilities() const { return &capabilities_; }
 
@@ -623,6 +623,30 @@ bool InstructionFolder::IsFoldableConstant(
     return cst->AsNullConstant() != nullptr;
 }
 
+std::vector<uint32_t> InstructionFolder::GetFoldToConstantCacheKey(
+    const Instruction* inst,
+    const std::function<uint32_t(uint32_t)>& id_map) const {
+  std::vector<uint32_t> key;
+  key.reserve(3 + inst->NumInOperandWords());
+  key.push_back(static_cast<uint32_t>(inst->opcode()));
+  key.push_back(inst->type_id());
+  // The floating-point folding rules consult IsFloatingPointFoldingAllowed,
+  // which depends on the instruction's own NoContraction decoration as well
+  // as module-wide capabilities.  Two instructions that agree on opcode,
+  // type, and operands can still fold differently when only one of them is
+  // decorated, so the verdict must be part of the key.
+  key.push_back(static_cast<uint32_t>(inst->IsFloatingPointFoldingAllowed()));
+  for (uint32_t i = 0; i < inst->NumInOperands(); ++i) {
+    const Operand& operand = inst->GetInOperand(i);
+    if (spvIsInIdType(operand.type)) {
+      key.push_back(id_map(operand.words[0]));
+    } else {
+      key.insert(key.end(), operand.words.begin(), operand.words.end());
+    }
+  }
+  return key;
+}
+
 Instruction* InstructionFolder::FoldInstructionToConstant(
     Instruction* inst, std::function<uint32_t(uint32_t)> id_map) const {
   analysis::ConstantManager* const_mgr = context_->get_constant_mgr();
@@ -630,6 +654,25 @@ Instruction* InstructionFolder::FoldInstructionToConstant(
   if (!inst->IsFoldableByFoldScalar() && !HasConstFoldingRule(inst)) {
     return nullptr;
   }
+
+  // The fold result is a deterministic function of the opcode, the result
+  // type, and the operands after |id_map| substitution, so repeated attempts
+  // can reuse the recorded outcome.
+  std::vector<uint32_t> cache_key = GetFoldToConstantCacheKey(inst, id_map);
+  auto cache_entry = fold_to_constant_cache_.find(cache_key);
+  if (cache_entry != fold_to_constant_cache_.end()) {
+    if (cache_entry->second == 0) {
+      return nullptr;
+    }
+    Instruction* cached_inst =
+        context_->get_def_use_mgr()->GetDef(cache_entry->second);
+    if (cached_inst != nullptr) {
+      return cached_inst;
+    }
+    // The cached constant has been removed from the module; fall through and
+    // redo the fold, which will refresh the entry.
+  }
+
   // Collect the values of the constant parameters.
   std::vector<const analysis::Constant*> constants;
   bool missing_constants = false;
@@ -652,11 +695,13 @@ Instruction* InstructionFolder::FoldInstructionToConstant(
       Instruction* const_inst =
           const_mgr->GetDefiningInstruction(folded_const, inst->type_id());
       if (const_inst == nullptr) {
+        // Running out of ids is transient; do not record the failure.
         return nullptr;
       }
       assert(const_inst->type_id() == inst->type_id());
       // May be a new instruction that needs to be analysed.
       context_->UpdateDefUse(const_inst);
+      fold_to_constant_cache_[std::move(cache_key)] = const_inst->result_id();
       return const_inst;
     }
   }
@@ -678,8 +723,12 @@ Instruction* InstructionFolder::FoldInstructionToConstant(
         const_mgr->GetConstant(const_mgr->GetType(inst), {result_val});
     Instruction* folded_inst =
         const_mgr->GetDefiningInstruction(result_const, inst->type_id());
+    if (folded_inst != nullptr) {
+      fold_to_constant_cache_[std::move(cache_key)] = folded_inst->result_id();
+    }
     return folded_inst;
   }
+  fold_to_constant_cache_[std::move(cache_key)] = 0;
   return nullptr;
 }
 
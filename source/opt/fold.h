@@ -16,12 +16,14 @@
 #define SOURCE_OPT_FOLD_H_
 
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include "source/opt/const_folding_rules.h"
 #include "source/opt/constants.h"
 #include "source/opt/def_use_manager.h"
 #include "source/opt/folding_rules.h"
+#include "source/util/hash_combine.h"
 
 namespace spvtools {
 namespace opt {
@@ -115,6 +117,11 @@ class InstructionFolder {
     return GetConstantFoldingRules().HasFoldingRule(inst);
   }
 
+  // Drops every memoized result of |FoldInstructionToConstant|.  The
+  // IRContext calls this when it invalidates the def-use or constant
+  // analyses, which the memo table depends on.
+  void ClearFoldToConstantCache() const { fold_to_constant_cache_.clear(); }
+
  private:
   // Returns a reference to the ConstnatFoldingRules instance.
   const ConstantFoldingRules& GetConstantFoldingRules() const {
@@ -172,6 +179,22 @@ class InstructionFolder {
                                const std::function<uint32_t(uint32_t)>& id_map,
                                uint32_t* result) const;
 
+  // Returns the memo key for folding |inst| to a constant with the input ids
+  // substituted using |id_map|: the opcode, result type id, and the verdict
+  // of IsFloatingPointFoldingAllowed (which varies per instruction via the
+  // NoContraction decoration), followed by every in operand word, with id
+  // operands mapped through |id_map|.
+  std::vector<uint32_t> GetFoldToConstantCacheKey(
+      const Instruction* inst,
+      const std::function<uint32_t(uint32_t)>& id_map) const;
+
+  // Hashing functor for memo keys.
+  struct FoldToConstantCacheKeyHash {
+    size_t operator()(const std::vector<uint32_t>& key) const {
+      return utils::hash_combine(0, key);
+    }
+  };
+
   IRContext* context_;
 
   // Folding rules used by |FoldInstructionToConstant| and |FoldInstruction|.
@@ -179,6 +202,16 @@ class InstructionFolder {
 
   // Folding rules used by |FoldInstruction|.
   std::unique_ptr<FoldingRules> folding_rules_;
+
+  // Memoized outcomes of |FoldInstructionToConstant|, keyed as described on
+  // |GetFoldToConstantCacheKey|.  The value is the result id of the folded
+  // constant, or 0 when the fold attempt failed.  Fixpoint loops such as
+  // CCPPass::PropagateConstants retry identical folds many times; recording
+  // the outcome makes the retries cache probes.  Mutable because memoizing
+  // does not change the observable behavior of the folder.
+  mutable std::unordered_map<std::vector<uint32_t>, uint32_t,
+                             FoldToConstantCacheKeyHash>
+      fold_to_constant_cache_;
 };
 
 }  // namespace opt
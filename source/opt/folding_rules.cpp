@@ -21,6 +21,7 @@
 #include "ir_builder.h"
 #include "source/latest_version_glsl_std_450_header.h"
 #include "source/opt/ir_context.h"
+#include "source/util/small_set.h"
 
 namespace spvtools {
 namespace opt {
@@ -2541,6 +2542,134 @@ FoldingRule RedundantFMix() {
   };
 }
 
+// Collapses a min/max chain when the outer call repeats one of the inner
+// call's operands:
+//   min(min(a, b), a) = min(a, b), and the same for max.
+FoldingRule RedundantMinMaxChain() {
+  return [](IRContext* context, Instruction* inst,
+            const std::vector<const analysis::Constant*>&) {
+    assert(inst->opcode() == spv::Op::OpExtInst &&
+           "Wrong opcode.  Should be OpExtInst.");
+
+    uint32_t inst_set_id =
+        context->get_feature_mgr()->GetExtInstImportId_GLSLstd450();
+    if (inst->GetSingleWordInOperand(kExtInstSetIdInIdx) != inst_set_id) {
+      return false;
+    }
+
+    const uint32_t ext_inst =
+        inst->GetSingleWordInOperand(kExtInstInstructionInIdx);
+    switch (ext_inst) {
+      case GLSLstd450FMin:
+      case GLSLstd450FMax:
+        if (!inst->IsFloatingPointFoldingAllowed()) return false;
+        break;
+      case GLSLstd450SMin:
+      case GLSLstd450SMax:
+      case GLSLstd450UMin:
+      case GLSLstd450UMax:
+        break;
+      default:
+        return false;
+    }
+
+    analysis::DefUseManager* def_use_mgr = context->get_def_use_mgr();
+    const uint32_t operands[] = {inst->GetSingleWordInOperand(2),
+                                 inst->GetSingleWordInOperand(3)};
+    for (uint32_t i = 0; i < 2; ++i) {
+      Instruction* chain = def_use_mgr->GetDef(operands[i]);
+      if (chain->opcode() != spv::Op::OpExtInst) continue;
+      if (chain->GetSingleWordInOperand(kExtInstSetIdInIdx) != inst_set_id ||
+          chain->GetSingleWordInOperand(kExtInstInstructionInIdx) !=
+              ext_inst) {
+        continue;
+      }
+      const uint32_t other = operands[1 - i];
+      if (chain->GetSingleWordInOperand(2) == other ||
+          chain->GetSingleWordInOperand(3) == other) {
+        inst->SetOpcode(spv::Op::OpCopyObject);
+        inst->SetInOperands({{SPV_OPERAND_TYPE_ID, {operands[i]}}});
+        return true;
+      }
+    }
+    return false;
+  };
+}
+
+// Returns true and writes |value| if |constant| is a scalar floating point
+// constant, or a vector constant whose components all hold the same
+// floating point value.
+bool GetFpScalarOrSplatValue(IRContext* context,
+                             const analysis::Constant* constant,
+                             double* value) {
+  if (constant == nullptr) return false;
+  if (constant->AsVectorConstant() != nullptr) {
+    const std::vector<const analysis::Constant*> components =
+        constant->GetVectorComponents(context->get_constant_mgr());
+    if (components.empty()) return false;
+    if (components[0]->AsFloatConstant() == nullptr) return false;
+    for (const analysis::Constant* component : components) {
+      if (component != components[0]) return false;
+    }
+    *value = components[0]->GetValueAsDouble();
+    return true;
+  }
+  if (constant->AsFloatConstant() == nullptr) return false;
+  *value = constant->GetValueAsDouble();
+  return true;
+}
+
+// Strength-reduces pow against a known exponent:
+//   pow(x, 1.0) = x, pow(x, 2.0) = x * x, pow(x, 0.5) = sqrt(x).
+// GLSL pow is undefined for x < 0, which is the only place these could
+// disagree with the library call.
+FoldingRule StrengthReducePow() {
+  return [](IRContext* context, Instruction* inst,
+            const std::vector<const analysis::Constant*>& constants) {
+    assert(inst->opcode() == spv::Op::OpExtInst &&
+           "Wrong opcode.  Should be OpExtInst.");
+
+    if (!inst->IsFloatingPointFoldingAllowed()) {
+      return false;
+    }
+
+    uint32_t inst_set_id =
+        context->get_feature_mgr()->GetExtInstImportId_GLSLstd450();
+    if (inst->GetSingleWordInOperand(kExtInstSetIdInIdx) != inst_set_id ||
+        inst->GetSingleWordInOperand(kExtInstInstructionInIdx) !=
+            GLSLstd450Pow) {
+      return false;
+    }
+    assert(constants.size() == 4);
+
+    double exponent = 0.0;
+    if (!GetFpScalarOrSplatValue(context, constants[3], &exponent)) {
+      return false;
+    }
+
+    const uint32_t x = inst->GetSingleWordInOperand(2);
+    if (exponent == 1.0) {
+      inst->SetOpcode(spv::Op::OpCopyObject);
+      inst->SetInOperands({{SPV_OPERAND_TYPE_ID, {x}}});
+      return true;
+    }
+    if (exponent == 2.0) {
+      inst->SetOpcode(spv::Op::OpFMul);
+      inst->SetInOperands(
+          {{SPV_OPERAND_TYPE_ID, {x}}, {SPV_OPERAND_TYPE_ID, {x}}});
+      return true;
+    }
+    if (exponent == 0.5) {
+      inst->SetInOperands(
+          {{SPV_OPERAND_TYPE_ID, {inst_set_id}},
+           {SPV_OPERAND_TYPE_LITERAL_INTEGER, {GLSLstd450Sqrt}},
+           {SPV_OPERAND_TYPE_ID, {x}}});
+      return true;
+    }
+    return false;
+  };
+}
+
 // This rule handles addition of zero for integers.
 FoldingRule RedundantIAdd() {
   return [](IRContext* context, Instruction* inst,
@@ -2676,6 +2805,124 @@ FoldingRule StoringUndef() {
   };
 }
 
+// Collapses a chain of OpVectorShuffle instructions into a single shuffle.
+// Each output lane is traced through the feeding shuffles to the non-shuffle
+// vector it ultimately reads.  When at most two distinct vectors remain, the
+// whole chain folds in one step instead of one link per simplification
+// round, and the rewritten shuffle reads only the vectors it needs.
+FoldingRule CollapseVectorShuffleChain() {
+  return [](IRContext* context, Instruction* inst,
+            const std::vector<const analysis::Constant*>&) {
+    assert(inst->opcode() == spv::Op::OpVectorShuffle &&
+           "Wrong opcode.  Should be OpVectorShuffle.");
+
+    analysis::DefUseManager* def_use_mgr = context->get_def_use_mgr();
+    analysis::TypeManager* type_mgr = context->get_type_mgr();
+    const uint32_t undef_literal = 0xffffffff;
+
+    if (def_use_mgr->GetDef(inst->GetSingleWordInOperand(0))->opcode() !=
+            spv::Op::OpVectorShuffle &&
+        def_use_mgr->GetDef(inst->GetSingleWordInOperand(1))->opcode() !=
+            spv::Op::OpVectorShuffle) {
+      return false;
+    }
+
+    auto vector_length = [def_use_mgr, type_mgr](uint32_t id) {
+      Instruction* def = def_use_mgr->GetDef(id);
+      return type_mgr->GetType(def->type_id())->AsVector()->element_count();
+    };
+
+    // Trace each output lane to the (vector id, lane) pair it reads once
+    // every feeding shuffle is looked through.  A vector id of 0 marks an
+    // undefined lane.
+    std::vector<std::pair<uint32_t, uint32_t>> provenance;
+    for (uint32_t op = 2; op < inst->NumInOperands(); ++op) {
+      uint32_t lane = inst->GetSingleWordInOperand(op);
+      uint32_t vec_id = 0;
+      if (lane != undef_literal) {
+        uint32_t op0_length = vector_length(inst->GetSingleWordInOperand(0));
+        if (lane < op0_length) {
+          vec_id = inst->GetSingleWordInOperand(0);
+        } else {
+          vec_id = inst->GetSingleWordInOperand(1);
+          lane -= op0_length;
+        }
+        while (vec_id != 0) {
+          Instruction* def = def_use_mgr->GetDef(vec_id);
+          if (def->opcode() == spv::Op::OpUndef) {
+            vec_id = 0;
+            break;
+          }
+          if (def->opcode() != spv::Op::OpVectorShuffle) break;
+          lane = def->GetSingleWordInOperand(lane + 2);
+          if (lane == undef_literal) {
+            vec_id = 0;
+            break;
+          }
+          uint32_t feeder_op0_length =
+              vector_length(def->GetSingleWordInOperand(0));
+          if (lane < feeder_op0_length) {
+            vec_id = def->GetSingleWordInOperand(0);
+          } else {
+            vec_id = def->GetSingleWordInOperand(1);
+            lane -= feeder_op0_length;
+          }
+        }
+      }
+      if (vec_id == 0) lane = undef_literal;
+      provenance.push_back({vec_id, lane});
+    }
+
+    // An OpVectorShuffle can read at most two vectors.
+    uint32_t new_x = 0;
+    uint32_t new_y = 0;
+    for (const auto& source : provenance) {
+      if (source.first == 0 || source.first == new_x ||
+          source.first == new_y) {
+        continue;
+      }
+      if (new_x == 0) {
+        new_x = source.first;
+      } else if (new_y == 0) {
+        new_y = source.first;
+      } else {
+        return false;
+      }
+    }
+    if (new_x == 0) {
+      // Every lane is undefined.  Leave the operand rewriting to the
+      // one-step rule below, which substitutes a null vector.
+      return false;
+    }
+    if (new_y == 0) new_y = new_x;
+    uint32_t new_x_length = vector_length(new_x);
+
+    std::vector<Operand> new_operands;
+    new_operands.push_back({SPV_OPERAND_TYPE_ID, {new_x}});
+    new_operands.push_back({SPV_OPERAND_TYPE_ID, {new_y}});
+    for (const auto& source : provenance) {
+      uint32_t component = source.second;
+      if (source.first != 0 && source.first == new_y && new_y != new_x) {
+        component += new_x_length;
+      }
+      new_operands.push_back(
+          {SPV_OPERAND_TYPE_LITERAL_INTEGER, {component}});
+    }
+
+    bool changed = false;
+    for (uint32_t op = 0; op < inst->NumInOperands(); ++op) {
+      if (new_operands[op].words[0] != inst->GetSingleWordInOperand(op)) {
+        changed = true;
+        break;
+      }
+    }
+    if (!changed) return false;
+
+    inst->SetInOperands(std::move(new_operands));
+    return true;
+  };
+}
+
 FoldingRule VectorShuffleFeedingShuffle() {
   return [](IRContext* context, Instruction* inst,
             const std::vector<const analysis::Constant*>&) {
@@ -2812,7 +3059,7 @@ FoldingRule RemoveRedundantOperands() {
     assert(inst->opcode() == spv::Op::OpEntryPoint &&
            "Wrong opcode.  Should be OpEntryPoint.");
     bool has_redundant_operand = false;
-    std::unordered_set<uint32_t> seen_operands;
+    utils::SmallSet<uint32_t, 8> seen_operands;
     std::vector<Operand> new_operands;
 
     new_operands.emplace_back(inst->GetOperand(0));
@@ -2978,6 +3225,7 @@ void FoldingRules::AddFoldingRules() {
 
   rules_[spv::Op::OpStore].push_back(StoringUndef());
 
+  rules_[spv::Op::OpVectorShuffle].push_back(CollapseVectorShuffleChain());
   rules_[spv::Op::OpVectorShuffle].push_back(VectorShuffleFeedingShuffle());
 
   rules_[spv::Op::OpImageSampleImplicitLod].push_back(UpdateImageOperands());
@@ -3027,6 +3275,20 @@ void FoldingRules::AddFoldingRules() {
   if (ext_inst_glslstd450_id != 0) {
     ext_rules_[{ext_inst_glslstd450_id, GLSLstd450FMix}].push_back(
         RedundantFMix());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450FMin}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450FMax}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450SMin}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450SMax}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450UMin}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450UMax}].push_back(
+        RedundantMinMaxChain());
+    ext_rules_[{ext_inst_glslstd450_id, GLSLstd450Pow}].push_back(
+        StrengthReducePow());
   }
 }
 }  // namespace opt
@@ -143,6 +143,23 @@ class Function {
                      bool run_on_debug_line_insts = false,
                      bool run_on_non_semantic_insts = false) const;
 
+  // Same as the overloads above, but call |f| directly instead of through a
+  // std::function.  Overload resolution prefers these whenever |f| is a
+  // lambda or another plain functor, which keeps hot traversals free of
+  // type erasure.
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false,
+                     bool run_on_non_semantic_insts = false);
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false,
+                     bool run_on_non_semantic_insts = false) const;
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false,
+                   bool run_on_non_semantic_insts = false);
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false,
+                   bool run_on_non_semantic_insts = false) const;
+
   // Runs the given function |f| on each parameter instruction in this function,
   // in order, and optionally on debug line instructions that might precede
   // them.
@@ -290,6 +307,124 @@ void Function::ReorderBasicBlocks(It begin, It end) {
   });
 }
 
+template <typename F>
+bool Function::WhileEachInst(F&& f, bool run_on_debug_line_insts,
+                             bool run_on_non_semantic_insts) {
+  if (def_inst_) {
+    if (!def_inst_->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  for (auto& param : params_) {
+    if (!param->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  if (!debug_insts_in_header_.empty()) {
+    Instruction* di = &debug_insts_in_header_.front();
+    while (di != nullptr) {
+      Instruction* next_instruction = di->NextNode();
+      if (!di->WhileEachInst(f, run_on_debug_line_insts)) return false;
+      di = next_instruction;
+    }
+  }
+
+  for (auto& bb : blocks_) {
+    if (!bb->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  if (end_inst_) {
+    if (!end_inst_->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  if (run_on_non_semantic_insts) {
+    for (auto& non_semantic : non_semantic_) {
+      if (!non_semantic->WhileEachInst(f, run_on_debug_line_insts)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+template <typename F>
+bool Function::WhileEachInst(F&& f, bool run_on_debug_line_insts,
+                             bool run_on_non_semantic_insts) const {
+  if (def_inst_) {
+    if (!static_cast<const Instruction*>(def_inst_.get())
+             ->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  for (const auto& param : params_) {
+    if (!static_cast<const Instruction*>(param.get())
+             ->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  for (const auto& di : debug_insts_in_header_) {
+    if (!static_cast<const Instruction*>(&di)->WhileEachInst(
+            f, run_on_debug_line_insts))
+      return false;
+  }
+
+  for (const auto& bb : blocks_) {
+    if (!static_cast<const BasicBlock*>(bb.get())->WhileEachInst(
+            f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  if (end_inst_) {
+    if (!static_cast<const Instruction*>(end_inst_.get())
+             ->WhileEachInst(f, run_on_debug_line_insts)) {
+      return false;
+    }
+  }
+
+  if (run_on_non_semantic_insts) {
+    for (auto& non_semantic : non_semantic_) {
+      if (!static_cast<const Instruction*>(non_semantic.get())
+               ->WhileEachInst(f, run_on_debug_line_insts)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+template <typename F>
+void Function::ForEachInst(F&& f, bool run_on_debug_line_insts,
+                           bool run_on_non_semantic_insts) {
+  WhileEachInst(
+      [&f](Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts, run_on_non_semantic_insts);
+}
+
+template <typename F>
+void Function::ForEachInst(F&& f, bool run_on_debug_line_insts,
+                           bool run_on_non_semantic_insts) const {
+  WhileEachInst(
+      [&f](const Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts, run_on_non_semantic_insts);
+}
+
 template <class It>
 bool Function::ContainsAllBlocksInTheFunction(It begin, It end) {
   std::unordered_multiset<BasicBlock*> range(begin, end);
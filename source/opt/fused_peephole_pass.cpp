@@ -0,0 +1,94 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/fused_peephole_pass.h"
+
+#include <utility>
+
+#include "source/opt/constants.h"
+#include "source/opt/types.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+// Returns true if |value| has exactly one bit set.
+bool IsPowerOf2(uint32_t value) {
+  return value != 0 && ((value - 1) & value) == 0;
+}
+
+// Returns the number of trailing zeros in |value|, which must be non-zero.
+uint32_t CountTrailingZeros(uint32_t value) {
+  uint32_t count = 0;
+  while ((value & 1) == 0) {
+    ++count;
+    value >>= 1;
+  }
+  return count;
+}
+
+// The strength-reduction rule set: rewrites a 32-bit integer multiply by a
+// constant power of two into a left shift, in place.
+bool ReduceMultiplyToShift(IRContext* context, Instruction* inst) {
+  if (inst->opcode() != spv::Op::OpIMul) return false;
+
+  analysis::TypeManager* type_mgr = context->get_type_mgr();
+  const analysis::Type* type = type_mgr->GetType(inst->type_id());
+  if (type == nullptr) return false;
+  const analysis::Integer* int_type = type->AsInteger();
+  if (int_type == nullptr || int_type->width() != 32) return false;
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    Instruction* operand_inst =
+        context->get_def_use_mgr()->GetDef(inst->GetSingleWordInOperand(i));
+    if (operand_inst->opcode() != spv::Op::OpConstant ||
+        operand_inst->type_id() != inst->type_id()) {
+      continue;
+    }
+    const uint32_t value = operand_inst->GetSingleWordInOperand(0);
+    if (!IsPowerOf2(value)) continue;
+
+    analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+    const analysis::Constant* shift_amount =
+        const_mgr->GetConstant(type, {CountTrailingZeros(value)});
+    Instruction* shift_inst = const_mgr->GetDefiningInstruction(shift_amount);
+    if (shift_inst == nullptr) return false;
+
+    const uint32_t other_id = inst->GetSingleWordInOperand(1 - i);
+    inst->SetOpcode(spv::Op::OpShiftLeftLogical);
+    inst->SetInOperands({{SPV_OPERAND_TYPE_ID, {other_id}},
+                         {SPV_OPERAND_TYPE_ID, {shift_inst->result_id()}}});
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+FusedPeepholePass::FusedPeepholePass() {
+  rules_.push_back(ReduceMultiplyToShift);
+}
+
+bool FusedPeepholePass::RewriteInstruction(Instruction* inst) {
+  bool modified = false;
+  for (const Rule& rule : rules_) {
+    modified |= rule(context(), inst);
+  }
+  // The folder runs last so it can fold through what the rules produced.
+  modified |= SimplificationPass::RewriteInstruction(inst);
+  return modified;
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_FUSED_PEEPHOLE_PASS_H_
+#define SOURCE_OPT_FUSED_PEEPHOLE_PASS_H_
+
+#include <functional>
+#include <vector>
+
+#include "source/opt/instruction.h"
+#include "source/opt/ir_context.h"
+#include "source/opt/simplification_pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// See optimizer.hpp for documentation.
+//
+// Applies the rule sets of several compatible peephole passes in a single
+// module traversal instead of one traversal per pass.  The driver reuses
+// the simplification pass's worklist machinery: every instruction is
+// visited once in dominance order, each registered rule gets a chance to
+// rewrite it, and the users of a rewritten instruction are revisited until
+// nothing changes.  Analyses are invalidated once for the whole run rather
+// than once per fused pass.
+class FusedPeepholePass : public SimplificationPass {
+ public:
+  // A local rewrite applied to one instruction.  Returns true if it changed
+  // the instruction; the driver re-analyzes the instruction's uses and
+  // pushes them onto the shared work list.  A rule must only rewrite the
+  // instruction it is given (in place or by inserting new instructions that
+  // the instruction then uses), never unrelated instructions.
+  using Rule = std::function<bool(IRContext*, Instruction*)>;
+
+  // Creates the driver with the built-in rule set: strength reduction of
+  // integer multiplies by a constant power of two, followed by the
+  // instruction folder used by the simplification pass.
+  FusedPeepholePass();
+
+  const char* name() const override { return "fused-peephole"; }
+
+  // Registers an extra rule, applied after the built-in ones.
+  void AddRule(Rule rule) { rules_.push_back(std::move(rule)); }
+
+ protected:
+  bool RewriteInstruction(Instruction* inst) override;
+
+ private:
+  // The fused rules, applied in registration order before the folder.
+  std::vector<Rule> rules_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_FUSED_PEEPHOLE_PASS_H_
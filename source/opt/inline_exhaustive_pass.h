@@ -38,6 +38,10 @@ class InlineExhaustivePass : public InlinePass {
 
   const char* name() const override { return "inline-entry-points-exhaustive"; }
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitHasFunctionCalls;
+  }
+
  private:
   // Exhaustively inline all function calls in func as well as in
   // all code that is inlined into func. Returns the status.
@@ -0,0 +1,136 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/inline_heuristic_pass.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "source/opt/loop_descriptor.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+constexpr int kSpvFunctionCallFunctionId = 2;
+
+}  // namespace
+
+InlineHeuristicPass::InlineHeuristicPass(uint32_t growth_budget_percent)
+    : growth_budget_percent_(growth_budget_percent) {}
+
+Pass::Status InlineHeuristicPass::Process() {
+  InitializeInline();
+  cost_cache_.clear();
+  return ProcessImpl();
+}
+
+uint32_t InlineHeuristicPass::FunctionCost(Function* func) {
+  auto it = cost_cache_.find(func->result_id());
+  if (it != cost_cache_.end()) return it->second;
+  uint32_t cost = 0;
+  func->ForEachInst([&cost](Instruction*) { ++cost; });
+  cost_cache_[func->result_id()] = cost;
+  return cost;
+}
+
+bool InlineHeuristicPass::InlineCallSite(const CallSite& site) {
+  // Earlier inlining into the same caller may have moved the call into a
+  // different block, so locate its iterators by scanning the caller.
+  for (auto bi = site.caller->begin(); bi != site.caller->end(); ++bi) {
+    for (auto ii = bi->begin(); ii != bi->end(); ++ii) {
+      if (&*ii != site.call_inst) continue;
+      std::vector<std::unique_ptr<BasicBlock>> new_blocks;
+      std::vector<std::unique_ptr<Instruction>> new_vars;
+      if (!GenInlineCode(&new_blocks, &new_vars, ii, bi)) {
+        return false;
+      }
+      if (new_blocks.size() > 1) UpdateSucceedingPhis(new_blocks);
+      bi = bi.Erase();
+      for (auto& bb : new_blocks) {
+        bb->SetParent(site.caller);
+      }
+      bi = bi.InsertBefore(&new_blocks);
+      if (new_vars.size() > 0) {
+        site.caller->begin()->begin().InsertBefore(std::move(new_vars));
+      }
+      // The caller's body changed, so cached facts about it as a callee and
+      // its cached cost are stale.
+      InvalidateCalleeInfo(site.caller->result_id());
+      cost_cache_.erase(site.caller->result_id());
+      return true;
+    }
+  }
+  return true;
+}
+
+Pass::Status InlineHeuristicPass::ProcessImpl() {
+  // The budget is a fraction of the module's size when the pass starts.
+  uint64_t module_size = 0;
+  for (Function& func : *get_module()) {
+    func.ForEachInst([&module_size](Instruction*) { ++module_size; });
+  }
+  const uint64_t budget = module_size * growth_budget_percent_ / 100;
+
+  // Gather every inlinable call site in the reachable call tree along with
+  // its loop depth and the callee's size.  Costs are measured now; sites
+  // exposed or grown by inlining are left for a later run of the pass.
+  std::vector<CallSite> candidates;
+  uint32_t order = 0;
+  ProcessFunction pfn = [this, &candidates, &order](Function* fp) {
+    LoopDescriptor* loop_desc = context()->GetLoopDescriptor(fp);
+    for (BasicBlock& block : *fp) {
+      const Loop* loop = (*loop_desc)[block.id()];
+      const uint32_t depth =
+          loop ? static_cast<uint32_t>(loop->GetDepth()) : 0;
+      for (Instruction& inst : block) {
+        if (!IsInlinableFunctionCall(&inst)) continue;
+        Function* callee =
+            id2function_[inst.GetSingleWordOperand(kSpvFunctionCallFunctionId)];
+        candidates.push_back({fp, &inst, depth, FunctionCost(callee), order++});
+      }
+    }
+    return false;
+  };
+  context()->ProcessReachableCallTree(pfn);
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const CallSite& lhs, const CallSite& rhs) {
+              if (lhs.loop_depth != rhs.loop_depth)
+                return lhs.loop_depth > rhs.loop_depth;
+              if (lhs.callee_cost != rhs.callee_cost)
+                return lhs.callee_cost < rhs.callee_cost;
+              return lhs.order < rhs.order;
+            });
+
+  bool modified = false;
+  uint64_t spent = 0;
+  for (const CallSite& site : candidates) {
+    // Expanding the callee replaces the one call instruction with roughly
+    // the callee's body.  A site that does not fit is skipped rather than
+    // ending the walk: a smaller callee further down the queue may fit.
+    const uint64_t growth = site.callee_cost > 0 ? site.callee_cost - 1 : 0;
+    if (spent + growth > budget) continue;
+    if (!InlineCallSite(site)) {
+      return Status::Failure;
+    }
+    spent += growth;
+    modified = true;
+  }
+
+  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_INLINE_HEURISTIC_PASS_H_
+#define SOURCE_OPT_INLINE_HEURISTIC_PASS_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "source/opt/inline_pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// See optimizer.hpp for documentation.
+class InlineHeuristicPass : public InlinePass {
+ public:
+  explicit InlineHeuristicPass(uint32_t growth_budget_percent = 25);
+  Status Process() override;
+
+  const char* name() const override { return "inline-heuristic"; }
+
+ private:
+  // A call site considered for inlining.  Sites are processed most
+  // profitable first: deeper loop nesting wins, then smaller callees, then
+  // discovery order so the result is deterministic.
+  struct CallSite {
+    Function* caller;
+    Instruction* call_inst;
+    // Loop nesting depth of the calling block; 0 outside any loop.
+    uint32_t loop_depth;
+    // Instruction count of the callee when the site was gathered.
+    uint32_t callee_cost;
+    // Position in discovery order, used to break ties.
+    uint32_t order;
+  };
+
+  Pass::Status ProcessImpl();
+
+  // Returns the instruction count of |func|, caching the result per callee.
+  uint32_t FunctionCost(Function* func);
+
+  // Inlines the call at |site| by locating its iterators in the caller and
+  // expanding it in place, as InlineExhaustivePass does.  Returns false if
+  // code generation failed.
+  bool InlineCallSite(const CallSite& site);
+
+  // Additional instructions the module may gain, as a percentage of its
+  // size when the pass starts.
+  uint32_t growth_budget_percent_;
+
+  // Instruction counts keyed by function result id.
+  std::unordered_map<uint32_t, uint32_t> cost_cache_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_INLINE_HEURISTIC_PASS_H_
@@ -91,6 +91,9 @@ Pass::Status InlineOpaquePass::InlineOpaque(Function* func) {
       }
     }
   }
+  // The body of |func| changed, so any cached facts about it as a callee
+  // are stale.
+  if (modified) InvalidateCalleeInfo(func->result_id());
   return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
 }
 
@@ -38,6 +38,10 @@ class InlineOpaquePass : public InlinePass {
 
   const char* name() const override { return "inline-entry-points-opaque"; }
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitHasFunctionCalls;
+  }
+
  private:
   // Return true if |typeId| is or contains opaque type
   bool IsOpaqueType(uint32_t typeId);
@@ -366,7 +366,7 @@ std::unique_ptr<BasicBlock> InlinePass::InlineReturn(
     const std::unordered_map<uint32_t, uint32_t>& callee2caller,
     std::vector<std::unique_ptr<BasicBlock>>* new_blocks,
     std::unique_ptr<BasicBlock> new_blk_ptr,
-    analysis::DebugInlinedAtContext* inlined_at_ctx, Function* calleeFn,
+    analysis::DebugInlinedAtContext* inlined_at_ctx, bool callee_has_abort,
     const Instruction* inst, uint32_t returnVarId) {
   // Store return value to return variable.
   if (inst->opcode() == spv::Op::OpReturnValue) {
@@ -382,12 +382,8 @@ std::unique_ptr<BasicBlock> InlinePass::InlineReturn(
   }
 
   uint32_t returnLabelId = 0;
-  for (auto callee_block_itr = calleeFn->begin();
-       callee_block_itr != calleeFn->end(); ++callee_block_itr) {
-    if (spvOpcodeIsAbort(callee_block_itr->tail()->opcode())) {
-      returnLabelId = context()->TakeNextId();
-      break;
-    }
+  if (callee_has_abort) {
+    returnLabelId = context()->TakeNextId();
   }
   if (returnLabelId == 0) return new_blk_ptr;
 
@@ -543,6 +539,31 @@ void InlinePass::UpdateSingleBlockLoopContinueTarget(
   merge_inst->SetInOperand(1u, {new_id});
 }
 
+void InlinePass::InvalidateCalleeInfo(uint32_t func_id) {
+  callee_info_.erase(func_id);
+}
+
+const InlinePass::CalleeInfo& InlinePass::GetCalleeInfo(Function* calleeFn) {
+  auto info_itr = callee_info_.find(calleeFn->result_id());
+  if (info_itr != callee_info_.end()) {
+    return info_itr->second;
+  }
+
+  CalleeInfo& info = callee_info_[calleeFn->result_id()];
+  calleeFn->ForEachInst([&info](const Instruction* cpi) {
+    if (cpi->result_id() != 0) {
+      info.result_ids.push_back(cpi->result_id());
+    }
+  });
+  for (auto& blk : *calleeFn) {
+    if (spvOpcodeIsAbort(blk.tail()->opcode())) {
+      info.has_abort_terminator = true;
+      break;
+    }
+  }
+  return info;
+}
+
 bool InlinePass::GenInlineCode(
     std::vector<std::unique_ptr<BasicBlock>>* new_blocks,
     std::vector<std::unique_ptr<Instruction>>* new_vars,
@@ -576,6 +597,9 @@ bool InlinePass::GenInlineCode(
   Function* calleeFn = id2function_[call_inst_itr->GetSingleWordOperand(
       kSpvFunctionCallFunctionId)];
 
+  // Look up facts about the callee that are identical at every call site.
+  const CalleeInfo& callee_info = GetCalleeInfo(calleeFn);
+
   // Map parameters to actual arguments.
   MapParams(calleeFn, call_inst_itr, &callee2caller);
 
@@ -621,16 +645,16 @@ bool InlinePass::GenInlineCode(
     }
   }
 
-  calleeFn->WhileEachInst([&callee2caller, this](const Instruction* cpi) {
-    // Create set of callee result ids. Used to detect forward references
-    const uint32_t rid = cpi->result_id();
-    if (rid != 0 && callee2caller.find(rid) == callee2caller.end()) {
+  // Map the remaining callee result ids to fresh caller ids. Mapping every
+  // result id up front allows forward references to be remapped.
+  callee2caller.reserve(callee2caller.size() + callee_info.result_ids.size());
+  for (const uint32_t rid : callee_info.result_ids) {
+    if (callee2caller.find(rid) == callee2caller.end()) {
       const uint32_t nid = context()->TakeNextId();
       if (nid == 0) return false;
       callee2caller[rid] = nid;
     }
-    return true;
-  });
+  }
 
   // Inline DebugClare instructions in the callee's header.
   calleeFn->ForEachDebugInstructionsInHeader(
@@ -654,7 +678,7 @@ bool InlinePass::GenInlineCode(
   if (new_blk_ptr == nullptr) return false;
 
   new_blk_ptr = InlineReturn(callee2caller, new_blocks, std::move(new_blk_ptr),
-                             &inlined_at_ctx, calleeFn,
+                             &inlined_at_ctx, callee_info.has_abort_terminator,
                              &*(calleeFn->tail()->tail()), returnVarId);
 
   // Load return value into result id of call, if it exists.
@@ -827,6 +851,7 @@ void InlinePass::InitializeInline() {
   id2function_.clear();
   id2block_.clear();
   inlinable_.clear();
+  callee_info_.clear();
   no_return_in_loop_.clear();
   early_return_funcs_.clear();
   funcs_called_from_continue_ =
@@ -150,6 +150,11 @@ class InlinePass : public Pass {
   // Initialize state for optimization of |module|
   void InitializeInline();
 
+  // Drops any cached facts about the function with result id |func_id|.
+  // Must be called after inlining modifies the body of a function, since
+  // that function may later be inlined itself.
+  void InvalidateCalleeInfo(uint32_t func_id);
+
   // Map from function's result id to function.
   std::unordered_map<uint32_t, Function*> id2function_;
 
@@ -202,11 +207,13 @@ class InlinePass : public Pass {
       uint32_t dbg_inlined_at);
 
   // Inlines the return instruction of the callee function.
+  // |callee_has_abort| is true if some block of the callee ends in an abort
+  // instruction, in which case an exit block must be created.
   std::unique_ptr<BasicBlock> InlineReturn(
       const std::unordered_map<uint32_t, uint32_t>& callee2caller,
       std::vector<std::unique_ptr<BasicBlock>>* new_blocks,
       std::unique_ptr<BasicBlock> new_blk_ptr,
-      analysis::DebugInlinedAtContext* inlined_at_ctx, Function* calleeFn,
+      analysis::DebugInlinedAtContext* inlined_at_ctx, bool callee_has_abort,
       const Instruction* inst, uint32_t returnVarId);
 
   // Inlines the entry block of the callee function.
@@ -241,6 +248,23 @@ class InlinePass : public Pass {
   // structural dominance.
   void UpdateSingleBlockLoopContinueTarget(
       uint32_t new_id, std::vector<std::unique_ptr<BasicBlock>>* new_blocks);
+
+  // Facts about a callee that are the same at every call site.  A function
+  // inlined at many call sites is analyzed once and the results are reused
+  // for each subsequent call site.
+  struct CalleeInfo {
+    // Result ids defined by the callee, in instruction order.  Each call
+    // site maps these to fresh caller ids.
+    std::vector<uint32_t> result_ids;
+    // True if some block of the callee ends in an abort instruction.
+    bool has_abort_terminator = false;
+  };
+
+  // Returns the cached facts about |calleeFn|, computing them on first use.
+  const CalleeInfo& GetCalleeInfo(Function* calleeFn);
+
+  // Cache of per-callee facts, keyed by function result id.
+  std::unordered_map<uint32_t, CalleeInfo> callee_info_;
 };
 
 }  // namespace opt
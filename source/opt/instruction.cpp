@@ -15,8 +15,11 @@
 #include "source/opt/instruction.h"
 
 #include <initializer_list>
+#include <utility>
 
 #include "OpenCLDebugInfo100.h"
+#include "source/util/make_unique.h"
+#include "source/util/slot_pool.h"
 #include "source/disassemble.h"
 #include "source/opt/fold.h"
 #include "source/opt/ir_context.h"
@@ -43,16 +46,32 @@ constexpr uint32_t kDebugNoScopeNumWords = 5;
 // Number of operands of an OpBranchConditional instruction
 // with weights.
 constexpr uint32_t kOpBranchConditionalWithWeightsNumOperands = 5;
+
+// Pool of fixed-size instruction slots; see source/util/slot_pool.h.
+using InstructionPool =
+    utils::SlotPool<sizeof(Instruction), alignof(Instruction)>;
 }  // namespace
 
+void* Instruction::operator new(size_t size) {
+  if (size != sizeof(Instruction)) return ::operator new(size);
+  return InstructionPool::ThreadLocal().Allocate();
+}
+
+void Instruction::operator delete(void* ptr, size_t size) {
+  if (size != sizeof(Instruction)) {
+    ::operator delete(ptr);
+    return;
+  }
+  InstructionPool::ThreadLocal().Deallocate(ptr);
+}
+
 Instruction::Instruction(IRContext* c)
     : utils::IntrusiveNodeBase<Instruction>(),
       context_(c),
       opcode_(spv::Op::OpNop),
       has_type_id_(false),
       has_result_id_(false),
-      unique_id_(c->TakeNextUniqueId()),
-      dbg_scope_(kNoDebugScope, kNoInlinedAt) {}
+      unique_id_(c->TakeNextUniqueId()) {}
 
 Instruction::Instruction(IRContext* c, spv::Op op)
     : utils::IntrusiveNodeBase<Instruction>(),
@@ -60,8 +79,7 @@ Instruction::Instruction(IRContext* c, spv::Op op)
       opcode_(op),
       has_type_id_(false),
       has_result_id_(false),
-      unique_id_(c->TakeNextUniqueId()),
-      dbg_scope_(kNoDebugScope, kNoInlinedAt) {}
+      unique_id_(c->TakeNextUniqueId()) {}
 
 Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
                          std::vector<Instruction>&& dbg_line)
@@ -70,9 +88,10 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
       opcode_(static_cast<spv::Op>(inst.opcode)),
       has_type_id_(inst.type_id != 0),
       has_result_id_(inst.result_id != 0),
-      unique_id_(c->TakeNextUniqueId()),
-      dbg_line_insts_(std::move(dbg_line)),
-      dbg_scope_(kNoDebugScope, kNoInlinedAt) {
+      unique_id_(c->TakeNextUniqueId()) {
+  if (!dbg_line.empty()) {
+    GetOrCreateDebugInfo()->line_insts = std::move(dbg_line);
+  }
   operands_.reserve(inst.num_operands);
   for (uint32_t i = 0; i < inst.num_operands; ++i) {
     const auto& current_payload = inst.operands[i];
@@ -80,7 +99,7 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
         current_payload.type, inst.words + current_payload.offset,
         inst.words + current_payload.offset + current_payload.num_words);
   }
-  assert((!IsLineInst() || dbg_line.empty()) &&
+  assert((!IsLineInst() || !has_dbg_line_insts()) &&
          "Op(No)Line attaching to Op(No)Line found");
 }
 
@@ -91,8 +110,8 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
       opcode_(static_cast<spv::Op>(inst.opcode)),
       has_type_id_(inst.type_id != 0),
       has_result_id_(inst.result_id != 0),
-      unique_id_(c->TakeNextUniqueId()),
-      dbg_scope_(dbg_scope) {
+      unique_id_(c->TakeNextUniqueId()) {
+  SetDebugScope(dbg_scope);
   operands_.reserve(inst.num_operands);
   for (uint32_t i = 0; i < inst.num_operands; ++i) {
     const auto& current_payload = inst.operands[i];
@@ -110,8 +129,7 @@ Instruction::Instruction(IRContext* c, spv::Op op, uint32_t ty_id,
       has_type_id_(ty_id != 0),
       has_result_id_(res_id != 0),
       unique_id_(c->TakeNextUniqueId()),
-      operands_(),
-      dbg_scope_(kNoDebugScope, kNoInlinedAt) {
+      operands_() {
   size_t operands_size = in_operands.size();
   if (has_type_id_) {
     operands_size++;
@@ -131,6 +149,32 @@ Instruction::Instruction(IRContext* c, spv::Op op, uint32_t ty_id,
   operands_.insert(operands_.end(), in_operands.begin(), in_operands.end());
 }
 
+Instruction::Instruction(const Instruction& that)
+    : utils::IntrusiveNodeBase<Instruction>(that),
+      context_(that.context_),
+      opcode_(that.opcode_),
+      has_type_id_(that.has_type_id_),
+      has_result_id_(that.has_result_id_),
+      unique_id_(that.unique_id_),
+      operands_(that.operands_) {
+  if (that.debug_info_) {
+    debug_info_ = MakeUnique<DebugInfo>(*that.debug_info_);
+  }
+}
+
+Instruction& Instruction::operator=(const Instruction& that) {
+  utils::IntrusiveNodeBase<Instruction>::operator=(that);
+  context_ = that.context_;
+  opcode_ = that.opcode_;
+  has_type_id_ = that.has_type_id_;
+  has_result_id_ = that.has_result_id_;
+  unique_id_ = that.unique_id_;
+  operands_ = that.operands_;
+  debug_info_ =
+      that.debug_info_ ? MakeUnique<DebugInfo>(*that.debug_info_) : nullptr;
+  return *this;
+}
+
 Instruction::Instruction(Instruction&& that)
     : utils::IntrusiveNodeBase<Instruction>(),
       context_(that.context_),
@@ -139,10 +183,11 @@ Instruction::Instruction(Instruction&& that)
       has_result_id_(that.has_result_id_),
       unique_id_(that.unique_id_),
       operands_(std::move(that.operands_)),
-      dbg_line_insts_(std::move(that.dbg_line_insts_)),
-      dbg_scope_(that.dbg_scope_) {
-  for (auto& i : dbg_line_insts_) {
-    i.dbg_scope_ = that.dbg_scope_;
+      debug_info_(std::move(that.debug_info_)) {
+  if (debug_info_) {
+    for (auto& i : debug_info_->line_insts) {
+      i.SetDebugScope(debug_info_->scope);
+    }
   }
 }
 
@@ -153,11 +198,22 @@ Instruction& Instruction::operator=(Instruction&& that) {
   has_result_id_ = that.has_result_id_;
   unique_id_ = that.unique_id_;
   operands_ = std::move(that.operands_);
-  dbg_line_insts_ = std::move(that.dbg_line_insts_);
-  dbg_scope_ = that.dbg_scope_;
+  debug_info_ = std::move(that.debug_info_);
   return *this;
 }
 
+Instruction::DebugInfo* Instruction::GetOrCreateDebugInfo() {
+  if (debug_info_ == nullptr) {
+    debug_info_ = MakeUnique<DebugInfo>();
+  }
+  return debug_info_.get();
+}
+
+const std::vector<Instruction>& Instruction::NoDbgLineInsts() {
+  static const std::vector<Instruction> kNoLineInsts;
+  return kNoLineInsts;
+}
+
 Instruction* Instruction::Clone(IRContext* c) const {
   Instruction* clone = new Instruction(c);
   clone->opcode_ = opcode_;
@@ -165,12 +221,13 @@ Instruction* Instruction::Clone(IRContext* c) const {
   clone->has_result_id_ = has_result_id_;
   clone->unique_id_ = c->TakeNextUniqueId();
   clone->operands_ = operands_;
-  clone->dbg_line_insts_ = dbg_line_insts_;
-  for (auto& i : clone->dbg_line_insts_) {
-    i.unique_id_ = c->TakeNextUniqueId();
-    if (i.IsDebugLineInst()) i.SetResultId(c->TakeNextId());
+  if (debug_info_) {
+    clone->debug_info_ = MakeUnique<DebugInfo>(*debug_info_);
+    for (auto& i : clone->debug_info_->line_insts) {
+      i.unique_id_ = c->TakeNextUniqueId();
+      if (i.IsDebugLineInst()) i.SetResultId(c->TakeNextId());
+    }
   }
-  clone->dbg_scope_ = dbg_scope_;
   return clone;
 }
 
@@ -518,9 +575,12 @@ bool Instruction::IsReadOnlyPointerKernel() const {
 }
 
 void Instruction::UpdateLexicalScope(uint32_t scope) {
-  dbg_scope_.SetLexicalScope(scope);
-  for (auto& i : dbg_line_insts_) {
-    i.dbg_scope_.SetLexicalScope(scope);
+  if (debug_info_ != nullptr || scope != kNoDebugScope) {
+    DebugInfo* info = GetOrCreateDebugInfo();
+    info->scope.SetLexicalScope(scope);
+    for (auto& i : info->line_insts) {
+      i.GetOrCreateDebugInfo()->scope.SetLexicalScope(scope);
+    }
   }
   if (!IsLineInst() &&
       context()->AreAnalysesValid(IRContext::kAnalysisDebugInfo)) {
@@ -529,9 +589,12 @@ void Instruction::UpdateLexicalScope(uint32_t scope) {
 }
 
 void Instruction::UpdateDebugInlinedAt(uint32_t new_inlined_at) {
-  dbg_scope_.SetInlinedAt(new_inlined_at);
-  for (auto& i : dbg_line_insts_) {
-    i.dbg_scope_.SetInlinedAt(new_inlined_at);
+  if (debug_info_ != nullptr || new_inlined_at != kNoInlinedAt) {
+    DebugInfo* info = GetOrCreateDebugInfo();
+    info->scope.SetInlinedAt(new_inlined_at);
+    for (auto& i : info->line_insts) {
+      i.GetOrCreateDebugInfo()->scope.SetInlinedAt(new_inlined_at);
+    }
   }
   if (!IsLineInst() &&
       context()->AreAnalysesValid(IRContext::kAnalysisDebugInfo)) {
@@ -540,9 +603,12 @@ void Instruction::UpdateDebugInlinedAt(uint32_t new_inlined_at) {
 }
 
 void Instruction::ClearDbgLineInsts() {
+  if (debug_info_ == nullptr) return;
   if (context()->AreAnalysesValid(IRContext::kAnalysisDefUse)) {
     auto def_use_mgr = context()->get_def_use_mgr();
-    for (auto& l_inst : dbg_line_insts_) def_use_mgr->ClearInst(&l_inst);
+    for (auto& l_inst : debug_info_->line_insts) {
+      def_use_mgr->ClearInst(&l_inst);
+    }
   }
   clear_dbg_line_insts();
 }
@@ -550,7 +616,7 @@ void Instruction::ClearDbgLineInsts() {
 void Instruction::UpdateDebugInfoFrom(const Instruction* from) {
   if (from == nullptr) return;
   ClearDbgLineInsts();
-  if (!from->dbg_line_insts().empty())
+  if (from->has_dbg_line_insts())
     AddDebugLine(&from->dbg_line_insts().back());
   SetDebugScope(from->GetDebugScope());
   if (!IsLineInst() &&
@@ -560,12 +626,13 @@ void Instruction::UpdateDebugInfoFrom(const Instruction* from) {
 }
 
 void Instruction::AddDebugLine(const Instruction* inst) {
-  dbg_line_insts_.push_back(*inst);
-  dbg_line_insts_.back().unique_id_ = context()->TakeNextUniqueId();
+  std::vector<Instruction>& line_insts = GetOrCreateDebugInfo()->line_insts;
+  line_insts.push_back(*inst);
+  line_insts.back().unique_id_ = context()->TakeNextUniqueId();
   if (inst->IsDebugLineInst())
-    dbg_line_insts_.back().SetResultId(context_->TakeNextId());
+    line_insts.back().SetResultId(context_->TakeNextId());
   if (context()->AreAnalysesValid(IRContext::kAnalysisDefUse))
-    context()->get_def_use_mgr()->AnalyzeInstDefUse(&dbg_line_insts_.back());
+    context()->get_def_use_mgr()->AnalyzeInstDefUse(&line_insts.back());
 }
 
 bool Instruction::IsDebugLineInst() const {
@@ -78,7 +78,10 @@ class InstructionList;
 // A *logical* operand to a SPIR-V instruction. It can be the type id, result
 // id, or other additional operands carried in an instruction.
 struct Operand {
-  using OperandData = utils::SmallVector<uint32_t, 2>;
+  // The overwhelming majority of operands are exactly one word (ids and
+  // 32-bit literals), so only a single word is stored inline; the rare
+  // multi-word literals and strings spill to the vector's heap storage.
+  using OperandData = utils::SmallVector<uint32_t, 1>;
   Operand(spv_operand_type_t t, OperandData&& w)
       : type(t), words(std::move(w)) {}
 
@@ -193,8 +196,7 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
         opcode_(spv::Op::OpNop),
         has_type_id_(false),
         has_result_id_(false),
-        unique_id_(0),
-        dbg_scope_(kNoDebugScope, kNoInlinedAt) {}
+        unique_id_(0) {}
 
   // Creates a default OpNop instruction.
   Instruction(IRContext*);
@@ -218,14 +220,23 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
 
   // TODO: I will want to remove these, but will first have to remove the use of
   // std::vector<Instruction>.
-  Instruction(const Instruction&) = default;
-  Instruction& operator=(const Instruction&) = default;
+  Instruction(const Instruction&);
+  Instruction& operator=(const Instruction&);
 
   Instruction(Instruction&&);
   Instruction& operator=(Instruction&&);
 
   ~Instruction() override = default;
 
+  // Instructions are allocated from a thread-local chunked free-list pool.
+  // Passes allocate and free instructions at a high rate, and pooling both
+  // removes the general-purpose allocator from that path and keeps ilist
+  // nodes clustered in memory for better cache locality during traversal.
+  // Allocations whose size does not match sizeof(Instruction) fall back to
+  // the default allocator.
+  void* operator new(size_t size);
+  void operator delete(void* ptr, size_t size);
+
   // Returns a newly allocated instruction that has the same operands, result,
   // and type as |this|.  The new instruction is not linked into any list.
   // It is the responsibility of the caller to make sure that the storage is
@@ -252,18 +263,31 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
     return unique_id_;
   }
   // Returns the vector of line-related debug instructions attached to this
-  // instruction and the caller can directly modify them.
-  std::vector<Instruction>& dbg_line_insts() { return dbg_line_insts_; }
+  // instruction and the caller can directly modify them.  This allocates the
+  // out-of-line debug metadata storage if the instruction has none yet, so
+  // read-only callers holding a non-const instruction should check
+  // |has_dbg_line_insts| first.
+  std::vector<Instruction>& dbg_line_insts() {
+    return GetOrCreateDebugInfo()->line_insts;
+  }
   const std::vector<Instruction>& dbg_line_insts() const {
-    return dbg_line_insts_;
+    return debug_info_ ? debug_info_->line_insts : NoDbgLineInsts();
+  }
+
+  // Returns true if any line-related debug instructions are attached to this
+  // instruction.  Unlike |dbg_line_insts|, never allocates.
+  bool has_dbg_line_insts() const {
+    return debug_info_ && !debug_info_->line_insts.empty();
   }
 
   const Instruction* dbg_line_inst() const {
-    return dbg_line_insts_.empty() ? nullptr : &dbg_line_insts_[0];
+    return has_dbg_line_insts() ? &debug_info_->line_insts[0] : nullptr;
   }
 
   // Clear line-related debug instructions attached to this instruction.
-  void clear_dbg_line_insts() { dbg_line_insts_.clear(); }
+  void clear_dbg_line_insts() {
+    if (debug_info_) debug_info_->line_insts.clear();
+  }
 
   // Same semantics as in the base class except the list the InstructionList
   // containing |pos| will now assume ownership of |this|.
@@ -314,7 +338,10 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   inline bool HasResultId() const { return has_result_id_; }
   // Sets DebugScope.
   inline void SetDebugScope(const DebugScope& scope);
-  inline const DebugScope& GetDebugScope() const { return dbg_scope_; }
+  inline const DebugScope& GetDebugScope() const {
+    static const DebugScope kNoScope(kNoDebugScope, kNoInlinedAt);
+    return debug_info_ ? debug_info_->scope : kNoScope;
+  }
   // Add debug line inst. Renew result id if Debug[No]Line
   void AddDebugLine(const Instruction* inst);
   // Updates DebugInlinedAt of DebugScope and OpLine.
@@ -331,7 +358,7 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   // Return true if OpNoLine or Shader100:DebugNoLine
   bool IsNoLine() const;
   inline uint32_t GetDebugInlinedAt() const {
-    return dbg_scope_.GetInlinedAt();
+    return debug_info_ ? debug_info_->scope.GetInlinedAt() : kNoInlinedAt;
   }
   // Updates lexical scope of DebugScope and OpLine.
   void UpdateLexicalScope(uint32_t scope);
@@ -387,6 +414,19 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   inline bool WhileEachInst(const std::function<bool(const Instruction*)>& f,
                             bool run_on_debug_line_insts = false) const;
 
+  // Same as the overloads above, but call |f| directly instead of through a
+  // std::function, so the compiler can inline the callback.  Overload
+  // resolution prefers these whenever |f| is a lambda or another plain
+  // functor, which keeps the hot traversal paths free of type erasure.
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false);
+  template <typename F>
+  bool WhileEachInst(F&& f, bool run_on_debug_line_insts = false) const;
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false);
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false) const;
+
   // Runs the given function |f| on all operand ids.
   //
   // |f| should not transform an ID into 0, as 0 is an invalid ID.
@@ -403,6 +443,31 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   inline bool WhileEachInId(
       const std::function<bool(const uint32_t*)>& f) const;
 
+  // Raw id-word iteration.  These templates visit only the operand words
+  // that hold ids and call the functor directly, so unlike the
+  // std::function overloads above there is no type erasure between the
+  // operand walk and the callback; both inline into the caller.  Id walking
+  // is the inner loop of most analyses, which makes the difference
+  // measurable on large modules.  |f| is invoked as f(uint32_t*) (or
+  // f(const uint32_t*) for the const overloads); the While variants expect
+  // a bool result and stop at the first false.
+  //
+  // ForEachIdWord covers every id including the result id; the InIdWord
+  // variants cover the "in" operand ids only.  As with ForEachId, |f| must
+  // not transform an id into 0.
+  template <typename F>
+  inline void ForEachIdWord(F&& f);
+  template <typename F>
+  inline void ForEachIdWord(F&& f) const;
+  template <typename F>
+  inline bool WhileEachInIdWord(F&& f);
+  template <typename F>
+  inline bool WhileEachInIdWord(F&& f) const;
+  template <typename F>
+  inline void ForEachInIdWord(F&& f);
+  template <typename F>
+  inline void ForEachInIdWord(F&& f) const;
+
   // Runs the given function |f| on all "in" operands.
   inline void ForEachInOperand(const std::function<void(uint32_t*)>& f);
   inline void ForEachInOperand(
@@ -624,6 +689,28 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   // instruction that samples a image, reads an image, or writes to an image.
   bool IsValidBaseImage() const;
 
+  // The debug metadata attached to an instruction.  Most instructions carry
+  // none of it, so it lives behind a lazily allocated pointer: the hot fields
+  // that traversal loops touch stay compact, and the cold ones are only paid
+  // for by the instructions that use them.
+  struct DebugInfo {
+    // Op[No]Line or Debug[No]Line instructions preceding this instruction.
+    // Note that for Instructions representing Op[No]Line or Debug[No]Line
+    // themselves, this field should be empty.
+    std::vector<Instruction> line_insts;
+
+    // DebugScope that wraps this instruction.
+    DebugScope scope = DebugScope(kNoDebugScope, kNoInlinedAt);
+  };
+
+  // Returns the debug metadata of this instruction, allocating its storage on
+  // first use.
+  DebugInfo* GetOrCreateDebugInfo();
+
+  // Returns the shared empty line-instruction vector that const accessors
+  // return for instructions carrying no debug metadata.
+  static const std::vector<Instruction>& NoDbgLineInsts();
+
   IRContext* context_;  // IR Context
   spv::Op opcode_;      // Opcode
   bool has_type_id_;    // True if the instruction has a type id
@@ -631,13 +718,8 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   uint32_t unique_id_;  // Unique instruction id
   // All logical operands, including result type id and result id.
   OperandList operands_;
-  // Op[No]Line or Debug[No]Line instructions preceding this instruction. Note
-  // that for Instructions representing Op[No]Line or Debug[No]Line themselves,
-  // this field should be empty.
-  std::vector<Instruction> dbg_line_insts_;
-
-  // DebugScope that wraps this instruction.
-  DebugScope dbg_scope_;
+  // Debug metadata, or nullptr if this instruction carries none.
+  std::unique_ptr<DebugInfo> debug_info_;
 
   friend InstructionList;
 };
@@ -711,9 +793,15 @@ inline void Instruction::SetResultId(uint32_t res_id) {
 }
 
 inline void Instruction::SetDebugScope(const DebugScope& scope) {
-  dbg_scope_ = scope;
-  for (auto& i : dbg_line_insts_) {
-    i.dbg_scope_ = scope;
+  if (debug_info_ == nullptr && scope.GetLexicalScope() == kNoDebugScope &&
+      scope.GetInlinedAt() == kNoInlinedAt) {
+    // The default scope needs no storage.
+    return;
+  }
+  DebugInfo* info = GetOrCreateDebugInfo();
+  info->scope = scope;
+  for (auto& i : info->line_insts) {
+    i.SetDebugScope(scope);
   }
 }
 
@@ -745,8 +833,8 @@ inline void Instruction::ToNop() {
 
 inline bool Instruction::WhileEachInst(
     const std::function<bool(Instruction*)>& f, bool run_on_debug_line_insts) {
-  if (run_on_debug_line_insts) {
-    for (auto& dbg_line : dbg_line_insts_) {
+  if (run_on_debug_line_insts && debug_info_) {
+    for (auto& dbg_line : debug_info_->line_insts) {
       if (!f(&dbg_line)) return false;
     }
   }
@@ -756,8 +844,8 @@ inline bool Instruction::WhileEachInst(
 inline bool Instruction::WhileEachInst(
     const std::function<bool(const Instruction*)>& f,
     bool run_on_debug_line_insts) const {
-  if (run_on_debug_line_insts) {
-    for (auto& dbg_line : dbg_line_insts_) {
+  if (run_on_debug_line_insts && debug_info_) {
+    for (auto& dbg_line : debug_info_->line_insts) {
       if (!f(&dbg_line)) return false;
     }
   }
@@ -785,6 +873,46 @@ inline void Instruction::ForEachInst(
       run_on_debug_line_insts);
 }
 
+template <typename F>
+bool Instruction::WhileEachInst(F&& f, bool run_on_debug_line_insts) {
+  if (run_on_debug_line_insts && debug_info_) {
+    for (auto& dbg_line : debug_info_->line_insts) {
+      if (!f(&dbg_line)) return false;
+    }
+  }
+  return f(this);
+}
+
+template <typename F>
+bool Instruction::WhileEachInst(F&& f, bool run_on_debug_line_insts) const {
+  if (run_on_debug_line_insts && debug_info_) {
+    for (const auto& dbg_line : debug_info_->line_insts) {
+      if (!f(&dbg_line)) return false;
+    }
+  }
+  return f(this);
+}
+
+template <typename F>
+void Instruction::ForEachInst(F&& f, bool run_on_debug_line_insts) {
+  WhileEachInst(
+      [&f](Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts);
+}
+
+template <typename F>
+void Instruction::ForEachInst(F&& f, bool run_on_debug_line_insts) const {
+  WhileEachInst(
+      [&f](const Instruction* inst) {
+        f(inst);
+        return true;
+      },
+      run_on_debug_line_insts);
+}
+
 inline void Instruction::ForEachId(const std::function<void(uint32_t*)>& f) {
   for (auto& operand : operands_)
     if (spvIsIdType(operand.type)) f(&operand.words[0]);
@@ -796,6 +924,52 @@ inline void Instruction::ForEachId(
     if (spvIsIdType(operand.type)) f(&operand.words[0]);
 }
 
+template <typename F>
+inline void Instruction::ForEachIdWord(F&& f) {
+  for (auto& operand : operands_)
+    if (spvIsIdType(operand.type)) f(&operand.words[0]);
+}
+
+template <typename F>
+inline void Instruction::ForEachIdWord(F&& f) const {
+  for (const auto& operand : operands_)
+    if (spvIsIdType(operand.type)) f(&operand.words[0]);
+}
+
+template <typename F>
+inline bool Instruction::WhileEachInIdWord(F&& f) {
+  for (auto& operand : operands_) {
+    if (spvIsInIdType(operand.type) && !f(&operand.words[0])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F>
+inline bool Instruction::WhileEachInIdWord(F&& f) const {
+  for (const auto& operand : operands_) {
+    if (spvIsInIdType(operand.type) && !f(&operand.words[0])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F>
+inline void Instruction::ForEachInIdWord(F&& f) {
+  for (auto& operand : operands_) {
+    if (spvIsInIdType(operand.type)) f(&operand.words[0]);
+  }
+}
+
+template <typename F>
+inline void Instruction::ForEachInIdWord(F&& f) const {
+  for (const auto& operand : operands_) {
+    if (spvIsInIdType(operand.type)) f(&operand.words[0]);
+  }
+}
+
 inline bool Instruction::WhileEachInId(
     const std::function<bool(uint32_t*)>& f) {
   for (auto& operand : operands_) {
@@ -122,6 +122,18 @@ class InstructionList : public utils::IntrusiveList<Instruction> {
       i->ForEachInst(f, run_on_debug_line_insts);
     }
   }
+
+  // Same as above, but calls |f| directly instead of through a
+  // std::function.  Overload resolution prefers this whenever |f| is a
+  // lambda or another plain functor.
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts) {
+    auto next = begin();
+    for (auto i = next; i != end(); i = next) {
+      ++next;
+      i->ForEachInst(f, run_on_debug_line_insts);
+    }
+  }
 };
 
 InstructionList::~InstructionList() { clear(); }
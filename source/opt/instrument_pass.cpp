@@ -930,6 +930,9 @@ uint32_t InstrumentPass::GetDirectReadFunctionId(uint32_t param_cnt) {
   InstructionBuilder builder(
       context(), &*new_blk_ptr,
       IRContext::kAnalysisDefUse | IRContext::kAnalysisInstrToBlockMapping);
+  // The whole function body is synthesized in one go, so register the new
+  // instructions with the analyses as one batch.
+  InstructionBuilder::BatchScope batch_scope(&builder);
   // For each offset parameter, generate new offset with parameter, adding last
   // loaded value if it exists, and load value from input buffer at new offset.
   // Return last loaded value.
@@ -957,6 +960,7 @@ uint32_t InstrumentPass::GetDirectReadFunctionId(uint32_t param_cnt) {
         builder.AddLoad(ibuf_type_id, ac_inst->result_id())->result_id();
   }
   (void)builder.AddUnaryOp(0, spv::Op::OpReturnValue, last_value_id);
+  batch_scope.Flush();
   // Close block and function and add function to module
   input_func->AddBasicBlock(std::move(new_blk_ptr));
   input_func->SetFunctionEnd(EndFunction());
@@ -1001,7 +1005,11 @@ bool InstrumentPass::InstrumentFunction(Function* func, uint32_t stage_idx,
   bool modified = false;
   // Apply instrumentation function to each instruction.
   // Using block iterators here because of block erasures and insertions.
+  // An instrumented site expands into at most four blocks (prelude, valid,
+  // invalid and merge), so one up-front reservation covers every site; the
+  // capacity survives the per-site clear() below.
   std::vector<std::unique_ptr<BasicBlock>> new_blks;
+  new_blks.reserve(4);
   for (auto bi = func->begin(); bi != func->end(); ++bi) {
     for (auto ii = bi->begin(); ii != bi->end();) {
       // Split all executable instructions out of first block into a following
@@ -1190,7 +1198,7 @@ void InstrumentPass::InitializeInstrument() {
     (void)i;
     ++module_offset;
   }
-  for (auto& i : module->types_values()) {
+  for (const auto& i : module->types_values()) {
     module_offset += 1;
     module_offset += static_cast<uint32_t>(i.dbg_line_insts().size());
   }
@@ -1204,7 +1212,7 @@ void InstrumentPass::InitializeInstrument() {
     for (auto& blk : *curr_fn) {
       // Count label
       module_offset += 1;
-      for (auto& inst : blk) {
+      for (const auto& inst : blk) {
         module_offset += static_cast<uint32_t>(inst.dbg_line_insts().size());
         uid2offset_[inst.unique_id()] = module_offset;
         module_offset += 1;
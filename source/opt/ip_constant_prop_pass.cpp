@@ -0,0 +1,219 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/ip_constant_prop_pass.h"
+
+#include <algorithm>
+
+#include "source/opt/constants.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+constexpr uint32_t kEntryPointFunctionIdInIdx = 1;
+constexpr uint32_t kFunctionCallFunctionIdInIdx = 0;
+constexpr uint32_t kFunctionCallFirstArgInIdx = 1;
+}  // namespace
+
+Pass::Status IPConstantPropPass::Process() {
+  CollectExternallyVisibleFunctions();
+  CollectCallSites();
+  if (call_sites_.empty()) {
+    return Status::SuccessWithoutChange;
+  }
+
+  bool modified = false;
+  for (const std::vector<Function*>& component : OrderCallersFirst()) {
+    // Functions in earlier components have final call-site arguments, so a
+    // single sweep settles a component unless its members are mutually
+    // recursive.  Iterating to a fixed point covers that case.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (Function* func : component) {
+        changed |= PropagateConstantArguments(func);
+      }
+      modified |= changed;
+    }
+  }
+  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+}
+
+void IPConstantPropPass::CollectExternallyVisibleFunctions() {
+  for (auto& entry_point : get_module()->entry_points()) {
+    externally_visible_.insert(
+        entry_point.GetSingleWordInOperand(kEntryPointFunctionIdInIdx));
+  }
+  for (auto& annotation : get_module()->annotations()) {
+    if (annotation.opcode() != spv::Op::OpDecorate) continue;
+    if (spv::Decoration(annotation.GetSingleWordOperand(1)) !=
+        spv::Decoration::LinkageAttributes) {
+      continue;
+    }
+    const uint32_t last_operand = annotation.NumOperands() - 1;
+    if (spv::LinkageType(annotation.GetSingleWordOperand(last_operand)) ==
+        spv::LinkageType::Export) {
+      externally_visible_.insert(annotation.GetSingleWordOperand(0));
+    }
+  }
+}
+
+void IPConstantPropPass::CollectCallSites() {
+  for (Function& func : *get_module()) {
+    func.ForEachInst([this](Instruction* inst) {
+      if (inst->opcode() == spv::Op::OpFunctionCall) {
+        call_sites_[inst->GetSingleWordInOperand(kFunctionCallFunctionIdInIdx)]
+            .push_back(inst);
+      }
+    });
+  }
+}
+
+std::vector<std::vector<Function*>> IPConstantPropPass::OrderCallersFirst() {
+  std::unordered_map<uint32_t, std::vector<uint32_t>> callees;
+  std::vector<uint32_t> function_ids;
+  for (Function& func : *get_module()) {
+    const uint32_t func_id = func.result_id();
+    function_ids.push_back(func_id);
+    std::vector<uint32_t>& targets = callees[func_id];
+    func.ForEachInst([this, &targets](Instruction* inst) {
+      if (inst->opcode() == spv::Op::OpFunctionCall) {
+        const uint32_t callee_id =
+            inst->GetSingleWordInOperand(kFunctionCallFunctionIdInIdx);
+        if (context()->GetFunction(callee_id) != nullptr) {
+          targets.push_back(callee_id);
+        }
+      }
+    });
+  }
+
+  // Tarjan's algorithm, iterative to keep the stack depth independent of the
+  // call graph depth.  It emits components callees-first, so the result is
+  // reversed before returning.
+  struct Frame {
+    uint32_t func_id;
+    size_t next_callee;
+  };
+  std::unordered_map<uint32_t, uint32_t> indices;
+  std::unordered_map<uint32_t, uint32_t> low_links;
+  std::unordered_set<uint32_t> on_stack;
+  std::vector<uint32_t> stack;
+  std::vector<std::vector<Function*>> components;
+  uint32_t next_index = 0;
+
+  for (const uint32_t root : function_ids) {
+    if (indices.count(root) != 0) continue;
+    std::vector<Frame> work_list{{root, 0}};
+    indices[root] = low_links[root] = next_index++;
+    stack.push_back(root);
+    on_stack.insert(root);
+    while (!work_list.empty()) {
+      Frame& frame = work_list.back();
+      const std::vector<uint32_t>& targets = callees[frame.func_id];
+      if (frame.next_callee < targets.size()) {
+        const uint32_t callee_id = targets[frame.next_callee++];
+        if (indices.count(callee_id) == 0) {
+          indices[callee_id] = low_links[callee_id] = next_index++;
+          stack.push_back(callee_id);
+          on_stack.insert(callee_id);
+          work_list.push_back({callee_id, 0});
+        } else if (on_stack.count(callee_id) != 0) {
+          low_links[frame.func_id] =
+              std::min(low_links[frame.func_id], indices[callee_id]);
+        }
+      } else {
+        const uint32_t func_id = frame.func_id;
+        work_list.pop_back();
+        if (!work_list.empty()) {
+          low_links[work_list.back().func_id] =
+              std::min(low_links[work_list.back().func_id],
+                       low_links[func_id]);
+        }
+        if (low_links[func_id] == indices[func_id]) {
+          components.emplace_back();
+          uint32_t member_id;
+          do {
+            member_id = stack.back();
+            stack.pop_back();
+            on_stack.erase(member_id);
+            components.back().push_back(context()->GetFunction(member_id));
+          } while (member_id != func_id);
+        }
+      }
+    }
+  }
+
+  std::reverse(components.begin(), components.end());
+  return components;
+}
+
+bool IPConstantPropPass::PropagateConstantArguments(Function* func) {
+  const uint32_t func_id = func->result_id();
+  if (func->IsDeclaration() || externally_visible_.count(func_id) != 0) {
+    return false;
+  }
+  const auto sites_iter = call_sites_.find(func_id);
+  if (sites_iter == call_sites_.end()) {
+    return false;
+  }
+  const std::vector<Instruction*>& sites = sites_iter->second;
+
+  analysis::ConstantManager* const_mgr = context()->get_constant_mgr();
+  analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+  bool modified = false;
+  uint32_t param_index = 0;
+  func->ForEachParam([this, &sites, const_mgr, def_use_mgr, &modified,
+                      &param_index](Instruction* param) {
+    const uint32_t param_id = param->result_id();
+    const analysis::Constant* agreed_value = nullptr;
+    uint32_t replacement_id = 0;
+    for (Instruction* call : sites) {
+      const uint32_t arg_id =
+          call->GetSingleWordInOperand(kFunctionCallFirstArgInIdx +
+                                       param_index);
+      // A recursive call that forwards the parameter unchanged places no
+      // constraint on its value.
+      if (arg_id == param_id) continue;
+      // Spec constants have no known value, so only accept arguments defined
+      // by normal constant instructions.
+      if (!def_use_mgr->GetDef(arg_id)->IsConstant()) {
+        replacement_id = 0;
+        break;
+      }
+      // Constants are interned by the constant manager, so arguments with
+      // distinct ids but equal values compare equal here.
+      const analysis::Constant* value = const_mgr->FindDeclaredConstant(arg_id);
+      if (value == nullptr ||
+          (agreed_value != nullptr && value != agreed_value)) {
+        replacement_id = 0;
+        break;
+      }
+      agreed_value = value;
+      if (replacement_id == 0) replacement_id = arg_id;
+    }
+    // ReplaceAllUsesWith reports a change whether or not any use existed, so
+    // it cannot drive the caller's fixed-point loop.  A parameter whose uses
+    // were already replaced on an earlier sweep has no users left; skipping
+    // it keeps the sweep idempotent so the loop terminates.
+    if (replacement_id != 0 && def_use_mgr->NumUsers(param_id) != 0) {
+      context()->ReplaceAllUsesWith(param_id, replacement_id);
+      modified = true;
+    }
+    ++param_index;
+  });
+  return modified;
+}
+
+}  // namespace opt
+}  // namespace spvtools
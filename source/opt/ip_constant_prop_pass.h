@@ -0,0 +1,84 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_IP_CONSTANT_PROP_PASS_H_
+#define SOURCE_OPT_IP_CONSTANT_PROP_PASS_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "source/opt/function.h"
+#include "source/opt/ir_context.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Interprocedural constant propagation.  For every function whose call sites
+// are all known (i.e. it is neither an entry point nor exported), if every
+// call site passes the same constant value for a parameter, the uses of that
+// parameter are replaced by that constant.  Intraprocedural passes can then
+// fold the function body without it having to be inlined first.
+//
+// Functions are visited callers-first, grouping strongly connected components
+// of the call graph, so that constants flow through chains of forwarded
+// parameters in a single sweep.  Mutually recursive functions are iterated to
+// a fixed point within their component; a recursive call that forwards a
+// parameter unchanged does not prevent that parameter from being propagated.
+class IPConstantPropPass : public Pass {
+ public:
+  const char* name() const override { return "ip-constant-prop"; }
+  Status Process() override;
+
+  IRContext::Analysis GetPreservedAnalyses() override {
+    return IRContext::kAnalysisDefUse |
+           IRContext::kAnalysisInstrToBlockMapping |
+           IRContext::kAnalysisDecorations | IRContext::kAnalysisCombinators |
+           IRContext::kAnalysisCFG | IRContext::kAnalysisDominatorAnalysis |
+           IRContext::kAnalysisNameMap | IRContext::kAnalysisConstants |
+           IRContext::kAnalysisTypes;
+  }
+
+ private:
+  // Records the ids of functions that can be called from outside the module:
+  // entry points and functions exported through linkage attributes.  Their
+  // parameters can never be propagated.
+  void CollectExternallyVisibleFunctions();
+
+  // Records every OpFunctionCall in the module in |call_sites_|, keyed by the
+  // id of the callee.
+  void CollectCallSites();
+
+  // Returns the strongly connected components of the call graph ordered so
+  // that callers come before their callees.  Functions in the same component
+  // are grouped together.
+  std::vector<std::vector<Function*>> OrderCallersFirst();
+
+  // Replaces the uses of each parameter of |func| for which every known call
+  // site passes the same constant value.  Returns true if any use was
+  // replaced.
+  bool PropagateConstantArguments(Function* func);
+
+  // The ids of the functions that can be called from outside the module.
+  std::unordered_set<uint32_t> externally_visible_;
+
+  // All calls to a function, keyed by the id of the callee.
+  std::unordered_map<uint32_t, std::vector<Instruction*>> call_sites_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_IP_CONSTANT_PROP_PASS_H_
@@ -41,6 +41,57 @@ class InstructionBuilder {
  public:
   using InsertionPointTy = BasicBlock::iterator;
 
+  // RAII scope that batches analysis registration of created instructions.
+  // While a scope is active on a builder, instructions it creates are
+  // accumulated instead of being registered with the def-use and
+  // instruction-to-block analyses one at a time; the whole batch is
+  // registered in one pass when the scope is flushed or destroyed.  Use it
+  // around stretches that synthesize many instructions in a row.
+  //
+  // Code running inside the scope must not query the deferred analyses for
+  // the created instructions or kill any of them before the flush.  Scopes
+  // must not nest on the same builder and must not outlive the builder.
+  class BatchScope {
+   public:
+    explicit BatchScope(InstructionBuilder* builder) : builder_(builder) {
+      assert(builder_->batch_ == nullptr &&
+             "Batch scopes cannot nest on one builder");
+      builder_->batch_ = this;
+    }
+
+    ~BatchScope() {
+      Flush();
+      builder_->batch_ = nullptr;
+    }
+
+    // Registers all accumulated instructions with the analyses the builder
+    // preserves.
+    void Flush() {
+      const bool update_def_use =
+          builder_->IsAnalysisUpdateRequested(IRContext::kAnalysisDefUse);
+      const bool update_block_mapping = builder_->IsAnalysisUpdateRequested(
+          IRContext::kAnalysisInstrToBlockMapping);
+      IRContext* context = builder_->GetContext();
+      for (const auto& pending : pending_) {
+        if (update_block_mapping && pending.second != nullptr) {
+          context->set_instr_block(pending.first, pending.second);
+        }
+        if (update_def_use) {
+          context->get_def_use_mgr()->AnalyzeInstDefUse(pending.first);
+        }
+      }
+      pending_.clear();
+    }
+
+   private:
+    friend class InstructionBuilder;
+
+    InstructionBuilder* builder_;
+    // Created instructions with the block they were inserted into, in
+    // creation order.
+    std::vector<std::pair<Instruction*, BasicBlock*>> pending_;
+  };
+
   // Creates an InstructionBuilder, all new instructions will be inserted before
   // the instruction |insert_before|.
   InstructionBuilder(
@@ -580,8 +631,12 @@ class InstructionBuilder {
   // Inserts the new instruction before the insertion point.
   Instruction* AddInstruction(std::unique_ptr<Instruction>&& insn) {
     Instruction* insn_ptr = &*insert_before_.InsertBefore(std::move(insn));
-    UpdateInstrToBlockMapping(insn_ptr);
-    UpdateDefUseMgr(insn_ptr);
+    if (batch_ != nullptr) {
+      batch_->pending_.push_back({insn_ptr, parent_});
+    } else {
+      UpdateInstrToBlockMapping(insn_ptr);
+      UpdateDefUseMgr(insn_ptr);
+    }
     return insn_ptr;
   }
 
@@ -650,6 +705,8 @@ class InstructionBuilder {
   BasicBlock* parent_;
   InsertionPointTy insert_before_;
   const IRContext::Analysis preserved_analyses_;
+  // The active batch scope, if any; see BatchScope.
+  BatchScope* batch_ = nullptr;
 };
 
 }  // namespace opt
@@ -18,8 +18,10 @@
 
 #include "OpenCLDebugInfo100.h"
 #include "source/latest_version_glsl_std_450_header.h"
+#include "source/opt/analysis_metadata.h"
 #include "source/opt/log.h"
 #include "source/opt/reflect.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace opt {
@@ -37,6 +39,22 @@ constexpr uint32_t kDebugFunctionOperandFunctionIndex = 13;
 constexpr uint32_t kDebugGlobalVariableOperandVariableIndex = 11;
 }  // namespace
 
+std::unique_ptr<IRContext> IRContext::Clone() const {
+  auto clone = MakeUnique<IRContext>(grammar_.target_env(), consumer_);
+  module_->CloneInto(clone.get());
+  return clone;
+}
+
+void IRContext::RestoreFrom(const IRContext& snapshot) {
+  // CloneInto expects an empty destination module, so start from a fresh
+  // one rather than clearing the current module in place.
+  module_ = MakeUnique<Module>();
+  module_->SetContext(this);
+  snapshot.module()->CloneInto(this);
+  InvalidateAnalysesExceptFor(kAnalysisNone);
+  ResetFeatureManager();
+}
+
 void IRContext::BuildInvalidAnalyses(IRContext::Analysis set) {
   set = Analysis(set & ~valid_analyses_);
 
@@ -53,7 +71,7 @@ void IRContext::BuildInvalidAnalyses(IRContext::Analysis set) {
     BuildCFG();
   }
   if (set & kAnalysisDominatorAnalysis) {
-    ResetDominatorAnalysis();
+    BuildDominatorAnalyses();
   }
   if (set & kAnalysisLoopAnalysis) {
     ResetLoopAnalysis();
@@ -90,13 +108,74 @@ void IRContext::BuildInvalidAnalyses(IRContext::Analysis set) {
   }
 }
 
+void IRContext::Freeze() {
+  assert(!frozen_ && "The context is already frozen.");
+
+  // Build every module-level analysis that a query could otherwise
+  // construct lazily.
+  BuildInvalidAnalyses(static_cast<Analysis>(
+      kAnalysisDefUse | kAnalysisInstrToBlockMapping | kAnalysisDecorations |
+      kAnalysisCFG | kAnalysisDominatorAnalysis | kAnalysisNameMap |
+      kAnalysisStructuredCFG | kAnalysisIdToFuncMapping | kAnalysisConstants |
+      kAnalysisTypes | kAnalysisDebugInfo));
+  get_feature_mgr();
+  if (!AreAnalysesValid(kAnalysisCombinators)) {
+    InitializeCombinators();
+  }
+
+  // The per-function pieces are created (and, for dominator trees, deferred)
+  // on first query even when the owning analysis is valid, so touch each
+  // function explicitly.  GetDomTree() forces a deferred tree to be built.
+  for (Function& fn : *module()) {
+    if (fn.IsDeclaration()) continue;
+    GetDominatorAnalysis(&fn)->GetDomTree();
+    GetPostDominatorAnalysis(&fn)->GetDomTree();
+    GetLoopDescriptor(&fn);
+    GetStructuredCFGAnalysis()->ContainingConstruct(fn.entry()->id());
+  }
+
+  frozen_ = true;
+}
+
 void IRContext::InvalidateAnalysesExceptFor(
     IRContext::Analysis preserved_analyses) {
   uint32_t analyses_to_invalidate = valid_analyses_ & (~preserved_analyses);
   InvalidateAnalyses(static_cast<IRContext::Analysis>(analyses_to_invalidate));
 }
 
+void IRContext::InvalidateAnalysesForFunction(
+    const Function* func, IRContext::Analysis analyses_to_invalidate) {
+  uint32_t module_wide = analyses_to_invalidate;
+  if (analyses_to_invalidate & kAnalysisDominatorAnalysis) {
+    dominator_trees_.erase(func);
+    post_dominator_trees_.erase(func);
+    module_wide &= ~kAnalysisDominatorAnalysis;
+  }
+  if (analyses_to_invalidate & kAnalysisLoopAnalysis) {
+    loop_descriptors_.erase(func);
+    module_wide &= ~kAnalysisLoopAnalysis;
+  }
+  if (analyses_to_invalidate & kAnalysisStructuredCFG) {
+    InvalidateStructuredCFGAnalysis(func);
+    module_wide &= ~kAnalysisStructuredCFG;
+  }
+  // The remaining analyses keep no per-function state, so a request to drop
+  // them for one function can only be honored module-wide.
+  if (module_wide) {
+    InvalidateAnalyses(static_cast<IRContext::Analysis>(module_wide));
+  }
+}
+
 void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
+  assert(!frozen_ && "A frozen context must not be mutated.");
+  // The dirty-block record is maintained through the def-use entry points and
+  // located through the instruction-to-block mapping; if either goes away the
+  // record can no longer be trusted.
+  if (analyses_to_invalidate &
+      (kAnalysisDefUse | kAnalysisInstrToBlockMapping)) {
+    StopDirtyBlockTracking();
+  }
+
   // The ConstantManager and DebugInfoManager contain Type pointers. If the
   // TypeManager goes away, the ConstantManager and DebugInfoManager have to
   // go away.
@@ -112,6 +191,15 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
     analyses_to_invalidate |= kAnalysisDominatorAnalysis;
   }
 
+  // The folder's memo of constant-fold results is keyed by ids and resolved
+  // through the def-use and constant managers, so it has to be dropped with
+  // them.  In particular, passes that remap ids rebuild both analyses.
+  if (analyses_to_invalidate & (kAnalysisDefUse | kAnalysisConstants)) {
+    if (inst_folder_) {
+      inst_folder_->ClearFoldToConstantCache();
+    }
+  }
+
   if (analyses_to_invalidate & kAnalysisDefUse) {
     def_use_mgr_.reset(nullptr);
   }
@@ -164,18 +252,31 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
 }
 
 Instruction* IRContext::KillInst(Instruction* inst) {
+  assert(!frozen_ && "A frozen context must not be mutated.");
   if (!inst) {
     return nullptr;
   }
 
+  MarkInstDirty(inst);
+
   KillNamesAndDecorates(inst);
 
   KillOperandFromDebugInstructions(inst);
 
   if (AreAnalysesValid(kAnalysisDefUse)) {
     analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
-    def_use_mgr->ClearInst(inst);
-    for (auto& l_inst : inst->dbg_line_insts()) def_use_mgr->ClearInst(&l_inst);
+    if (def_use_mgr->BatchingUpdates()) {
+      // Clears the records now and drops any pending modification record:
+      // the instruction may be freed before the batch commits.
+      def_use_mgr->RecordDeletedInst(inst);
+    } else {
+      def_use_mgr->ClearInst(inst);
+    }
+    if (inst->has_dbg_line_insts()) {
+      for (auto& l_inst : inst->dbg_line_insts()) {
+        def_use_mgr->ClearInst(&l_inst);
+      }
+    }
   }
   if (AreAnalysesValid(kAnalysisInstrToBlockMapping)) {
     instr_to_block_.erase(inst);
@@ -195,15 +296,15 @@ Instruction* IRContext::KillInst(Instruction* inst) {
   if (constant_mgr_ && IsConstantInst(inst->opcode())) {
     constant_mgr_->RemoveId(inst->result_id());
   }
-  if (inst->opcode() == spv::Op::OpCapability ||
-      inst->opcode() == spv::Op::OpExtension) {
-    // We reset the feature manager, instead of updating it, because it is just
-    // as much work.  We would have to remove all capabilities implied by this
-    // capability that are not also implied by the remaining OpCapability
-    // instructions. We could update extensions, but we will see if it is
-    // needed.
-    ResetFeatureManager();
-  }
+  // The removed capability or extension may still be implied by one of the
+  // remaining declarations, so the feature manager rescans the declaration
+  // section once the instruction is gone.  That is much cheaper than
+  // resetting the manager, which would re-derive extensions, capabilities
+  // and import ids from the whole module on the next query.
+  const bool update_capabilities =
+      feature_mgr_ != nullptr && inst->opcode() == spv::Op::OpCapability;
+  const bool update_extensions =
+      feature_mgr_ != nullptr && inst->opcode() == spv::Op::OpExtension;
 
   RemoveFromIdToName(inst);
 
@@ -217,6 +318,10 @@ Instruction* IRContext::KillInst(Instruction* inst) {
     // OpFunction, OpFunctionEnd, etc..
     inst->ToNop();
   }
+
+  if (update_capabilities) feature_mgr_->RecomputeCapabilities(module());
+  if (update_extensions) feature_mgr_->RecomputeExtensions(module());
+
   return next_instruction;
 }
 
@@ -259,6 +364,7 @@ bool IRContext::ReplaceAllUsesWith(uint32_t before, uint32_t after) {
 bool IRContext::ReplaceAllUsesWithPredicate(
     uint32_t before, uint32_t after,
     const std::function<bool(Instruction*)>& predicate) {
+  assert(!frozen_ && "A frozen context must not be mutated.");
   if (before == after) return false;
 
   if (AreAnalysesValid(kAnalysisDebugInfo)) {
@@ -351,6 +457,29 @@ bool IRContext::IsConsistent() {
     return false;
   }
 
+  if (AreAnalysesValid(kAnalysisDominatorAnalysis)) {
+    // Cross-validate every surviving dominator tree against one computed
+    // from the current CFG, so that a pass declaring per-function
+    // preservation too widely is caught here.  A deferred or never-built
+    // tree is materialized from the current CFG on first query and so
+    // cannot be stale.
+    for (auto& cached : dominator_trees_) {
+      const Function* fn = cached.first;
+      const DominatorAnalysis& analysis = cached.second;
+      if (!analysis.IsMaterialized() || analysis.GetDomTree().empty()) {
+        continue;
+      }
+      DominatorAnalysis fresh;
+      fresh.InitializeTree(*cfg(), fn);
+      for (const BasicBlock& block : *fn) {
+        if (analysis.ImmediateDominator(block.id()) !=
+            fresh.ImmediateDominator(block.id())) {
+          return false;
+        }
+      }
+    }
+  }
+
   if (AreAnalysesValid(kAnalysisDecorations)) {
     analysis::DecorationManager* dec_mgr = get_decoration_mgr();
     analysis::DecorationManager current(module());
@@ -372,9 +501,27 @@ bool IRContext::IsConsistent() {
 #endif
 }
 
+void IRContext::BeginDefUseBatch() {
+  if (AreAnalysesValid(kAnalysisDefUse)) {
+    get_def_use_mgr()->BeginBatchedUpdates();
+  }
+}
+
+void IRContext::CommitDefUseBatch() {
+  if (AreAnalysesValid(kAnalysisDefUse) &&
+      get_def_use_mgr()->BatchingUpdates()) {
+    get_def_use_mgr()->EndBatchedUpdates();
+  }
+}
+
 void IRContext::ForgetUses(Instruction* inst) {
   if (AreAnalysesValid(kAnalysisDefUse)) {
-    get_def_use_mgr()->EraseUseRecordsOfOperandIds(inst);
+    analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+    if (def_use_mgr->BatchingUpdates()) {
+      def_use_mgr->RecordModifiedInst(inst);
+    } else {
+      def_use_mgr->EraseUseRecordsOfOperandIds(inst);
+    }
   }
   if (AreAnalysesValid(kAnalysisDecorations)) {
     if (inst->IsDecoration()) {
@@ -385,11 +532,17 @@ void IRContext::ForgetUses(Instruction* inst) {
     get_debug_info_mgr()->ClearDebugInfo(inst);
   }
   RemoveFromIdToName(inst);
+  MarkInstDirty(inst);
 }
 
 void IRContext::AnalyzeUses(Instruction* inst) {
   if (AreAnalysesValid(kAnalysisDefUse)) {
-    get_def_use_mgr()->AnalyzeInstUse(inst);
+    analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+    if (def_use_mgr->BatchingUpdates()) {
+      def_use_mgr->RecordModifiedInst(inst);
+    } else {
+      def_use_mgr->AnalyzeInstUse(inst);
+    }
   }
   if (AreAnalysesValid(kAnalysisDecorations)) {
     if (inst->IsDecoration()) {
@@ -403,6 +556,7 @@ void IRContext::AnalyzeUses(Instruction* inst) {
                       inst->opcode() == spv::Op::OpMemberName)) {
     id_to_name_->insert({inst->GetSingleWordInOperand(0), inst});
   }
+  MarkInstDirty(inst);
 }
 
 void IRContext::KillNamesAndDecorates(uint32_t id) {
@@ -954,7 +1108,7 @@ void IRContext::EmitErrorMessage(std::string message, Instruction* inst) {
 
   Instruction* line_inst = inst;
   while (line_inst != nullptr) {  // Stop at the beginning of the basic block.
-    if (!line_inst->dbg_line_insts().empty()) {
+    if (line_inst->has_dbg_line_insts()) {
       line_inst = &line_inst->dbg_line_insts().back();
       if (line_inst->IsNoLine()) {
         line_inst = nullptr;
@@ -983,6 +1137,36 @@ void IRContext::EmitErrorMessage(std::string message, Instruction* inst) {
              message.c_str());
 }
 
+void IRContext::BuildDominatorAnalyses() {
+  SPIRV_PROFILE_SCOPED("build-dominators");
+  ResetDominatorAnalysis();
+
+  // Make sure the CFG exists before any worker runs: the trees only need its
+  // pseudo entry and exit blocks, but building it lazily from a worker would
+  // race.
+  CFG* the_cfg = cfg();
+
+  // Each tree construction reads only its own function's blocks and writes
+  // only its own DominatorAnalysis, so the functions can be processed
+  // concurrently.  Materialize the map entries up front; the workers then
+  // initialize disjoint objects.
+  std::vector<std::pair<DominatorAnalysis*, const Function*>> work;
+  for (Function& fn : *module()) {
+    if (fn.IsDeclaration()) continue;
+    work.emplace_back(&dominator_trees_[&fn], &fn);
+  }
+
+  utils::ThreadPool pool(
+      std::min(utils::ThreadPool::DefaultThreadCount(), work.size()));
+  for (const auto& entry : work) {
+    DominatorAnalysis* analysis = entry.first;
+    const Function* fn = entry.second;
+    pool.Schedule(
+        [analysis, fn, the_cfg]() { analysis->InitializeTree(*the_cfg, fn); });
+  }
+  pool.Wait();
+}
+
 // Gets the dominator analysis for function |f|.
 DominatorAnalysis* IRContext::GetDominatorAnalysis(const Function* f) {
   if (!AreAnalysesValid(kAnalysisDominatorAnalysis)) {
@@ -990,7 +1174,10 @@ DominatorAnalysis* IRContext::GetDominatorAnalysis(const Function* f) {
   }
 
   if (dominator_trees_.find(f) == dominator_trees_.end()) {
-    dominator_trees_[f].InitializeTree(*cfg(), f);
+    // Defer tree construction until the first dominance query: many passes
+    // fetch the analysis for every function but only ask questions about a
+    // few of them.
+    dominator_trees_[f].DeferInitialization(*cfg(), f);
   }
 
   return &dominator_trees_[f];
@@ -1003,12 +1190,92 @@ PostDominatorAnalysis* IRContext::GetPostDominatorAnalysis(const Function* f) {
   }
 
   if (post_dominator_trees_.find(f) == post_dominator_trees_.end()) {
-    post_dominator_trees_[f].InitializeTree(*cfg(), f);
+    post_dominator_trees_[f].DeferInitialization(*cfg(), f);
   }
 
   return &post_dominator_trees_[f];
 }
 
+bool IRContext::LoadEmbeddedAnalysisMetadata(bool verify) {
+  const uint32_t set_id =
+      module()->GetExtInstImportId(kAnalysisMetadataSetName);
+  if (set_id == 0) return false;
+
+  // The metadata may sit in the global values or, after a round trip through
+  // a binary, after the last function; scan the whole module.
+  std::vector<Instruction*> records;
+  module()->ForEachInst([set_id, &records](Instruction* inst) {
+    if (inst->opcode() == spv::Op::OpExtInst &&
+        inst->GetSingleWordInOperand(0) == set_id) {
+      records.push_back(inst);
+    }
+  });
+  if (records.empty()) return false;
+
+  if (!AreAnalysesValid(kAnalysisDominatorAnalysis)) {
+    ResetDominatorAnalysis();
+  }
+
+  bool loaded_any = false;
+  bool all_ok = true;
+  for (Instruction* record : records) {
+    bool ok = true;
+    // Every metadata operand is the id of a 32-bit integer constant.
+    auto value_of = [this, &ok](uint32_t id) -> uint32_t {
+      Instruction* def = get_def_use_mgr()->GetDef(id);
+      if (def == nullptr || def->opcode() != spv::Op::OpConstant) {
+        ok = false;
+        return 0;
+      }
+      return def->GetSingleWordInOperand(0);
+    };
+
+    const uint32_t num_in = record->NumInOperands();
+    const uint32_t kind = record->GetSingleWordInOperand(1);
+    if (num_in < 3 || (num_in - 3) % 2 != 0) {
+      all_ok = false;
+      continue;
+    }
+    const uint32_t fn_id = value_of(record->GetSingleWordInOperand(2));
+    Function* function = ok ? GetFunction(fn_id) : nullptr;
+    if (!ok || function == nullptr) {
+      all_ok = false;
+      continue;
+    }
+
+    if (kind == kAnalysisMetadataDominatorTree) {
+      std::map<uint32_t, uint32_t> idoms;
+      for (uint32_t i = 3; ok && i + 1 < num_in; i += 2) {
+        const uint32_t block = value_of(record->GetSingleWordInOperand(i));
+        const uint32_t idom = value_of(record->GetSingleWordInOperand(i + 1));
+        ok = ok && idoms.emplace(block, idom).second;
+      }
+      if (ok && dominator_trees_[function].InitializeFromIdoms(
+                    *cfg(), function, idoms, verify)) {
+        loaded_any = true;
+      } else {
+        dominator_trees_[function].DeferInitialization(*cfg(), function);
+        all_ok = false;
+      }
+    } else if (kind == kAnalysisMetadataLoops && verify) {
+      // Loop structure is rederived from the dominator tree in linear time,
+      // so the loop records only get a consistency check: every recorded
+      // header must be a block of the function carrying an OpLoopMerge.
+      for (uint32_t i = 3; ok && i + 1 < num_in; i += 2) {
+        const uint32_t header = value_of(record->GetSingleWordInOperand(i));
+        value_of(record->GetSingleWordInOperand(i + 1));
+        BasicBlock* block = ok ? get_instr_block(header) : nullptr;
+        if (block == nullptr || block->GetParent() != function ||
+            block->GetLoopMergeInst() == nullptr) {
+          ok = false;
+        }
+      }
+      if (!ok) all_ok = false;
+    }
+  }
+  return loaded_any && all_ok;
+}
+
 bool IRContext::CheckCFG() {
   std::unordered_map<uint32_t, std::vector<uint32_t>> real_preds;
   if (!AreAnalysesValid(kAnalysisCFG)) {
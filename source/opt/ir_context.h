@@ -16,6 +16,7 @@
 #define SOURCE_OPT_IR_CONTEXT_H_
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -44,6 +45,7 @@
 #include "source/opt/type_manager.h"
 #include "source/opt/value_number_table.h"
 #include "source/util/make_unique.h"
+#include "source/util/profiler.h"
 #include "source/util/string_utils.h"
 
 namespace spvtools {
@@ -86,6 +88,13 @@ class IRContext {
     kAnalysisEnd = 1 << 17
   };
 
+  // The analyses that keep per-function state, which
+  // InvalidateAnalysesForFunction can drop one function at a time.  See
+  // Pass::GetPreservedAnalysesForUnmodifiedFunctions.
+  static constexpr Analysis kPerFunctionAnalyses = static_cast<Analysis>(
+      static_cast<int>(kAnalysisDominatorAnalysis) | kAnalysisLoopAnalysis |
+      kAnalysisStructuredCFG);
+
   using ProcessFunction = std::function<bool(Function*)>;
 
   friend inline Analysis operator|(Analysis lhs, Analysis rhs);
@@ -136,6 +145,21 @@ class IRContext {
 
   Module* module() const { return module_.get(); }
 
+  // Returns a structural deep copy of this context, suitable as a cheap
+  // checkpoint: callers can mutate the clone speculatively and fall back to
+  // this context if the result is unwanted.  The module is cloned natively,
+  // without serializing it to a SPIR-V binary and re-parsing that binary.
+  // Cached analyses are not copied; the clone rebuilds them on demand.  The
+  // message consumer is shared with this context.
+  std::unique_ptr<IRContext> Clone() const;
+
+  // Replaces this context's module with a deep copy of |snapshot|'s module
+  // and drops every cached analysis.  |snapshot| is typically a Clone() of
+  // this context taken before a speculative transformation; restoring rolls
+  // the module back to that checkpoint.  |snapshot| itself is left
+  // untouched, so it can serve several rollbacks.
+  void RestoreFrom(const IRContext& snapshot);
+
   // Returns a vector of pointers to constant-creation instructions in this
   // context.
   inline std::vector<Instruction*> GetConstants();
@@ -277,6 +301,15 @@ class IRContext {
     return struct_cfg_analysis_.get();
   }
 
+  // Drops the structured CFG information cached for |func|, without
+  // invalidating the analysis for the rest of the module.  |func| will be
+  // re-analyzed the next time one of its blocks is queried.
+  void InvalidateStructuredCFGAnalysis(const Function* func) {
+    if (AreAnalysesValid(kAnalysisStructuredCFG)) {
+      struct_cfg_analysis_->InvalidateFunction(func);
+    }
+  }
+
   // Returns a pointer to a liveness analysis.  If the liveness analysis is
   // invalid, it is rebuilt first.
   LivenessAnalysis* GetLivenessAnalysis() {
@@ -399,6 +432,15 @@ class IRContext {
   // Invalidates the analyses marked in |analyses_to_invalidate|.
   void InvalidateAnalyses(Analysis analyses_to_invalidate);
 
+  // Invalidates the cached state that the analyses marked in
+  // |analyses_to_invalidate| hold for just |func|.  The analyses stay valid
+  // for every other function and rebuild their state for |func| on demand.
+  // Only the dominator, loop and structured-CFG analyses keep per-function
+  // state; any other analysis requested here is whole-module and is
+  // forwarded to InvalidateAnalyses.
+  void InvalidateAnalysesForFunction(const Function* func,
+                                     Analysis analyses_to_invalidate);
+
   // Deletes the instruction defining the given |id|. Returns true on
   // success, false if the given |id| is not defined at all. This method also
   // erases the name, decorations, and definition of |id|.
@@ -434,6 +476,26 @@ class IRContext {
   // Returns true if all of the given analyses are valid.
   bool AreAnalysesValid(Analysis set) { return (set & valid_analyses_) == set; }
 
+  // Returns the set of analyses that are currently valid.
+  Analysis GetValidAnalyses() const { return valid_analyses_; }
+
+  // Materializes the analyses that queries otherwise build lazily and marks
+  // the context frozen.  From this point on the context must not be mutated;
+  // in debug builds the main mutation entry points assert that.  A frozen
+  // context can then be queried from multiple threads without
+  // synchronization through the read-only analysis interfaces: def-use, the
+  // CFG, dominator and postdominator trees, loop descriptors, the structured
+  // CFG analysis, names, decorations, and lookups of existing constants and
+  // types.  Interfaces that intern new objects on lookup, such as
+  // TypeManager::GetTypeInstruction or constant registration, still mutate
+  // the context and must not be used after freezing.  Pass-support caches
+  // (scalar evolution, value numbering, liveness, register pressure) are not
+  // materialized.
+  void Freeze();
+
+  // Returns true if Freeze() has been called on this context.
+  bool IsFrozen() const { return frozen_; }
+
   // Replaces all uses of |before| id with |after| id. Returns true if any
   // replacement happens. This method does not kill the definition of the
   // |before| id. If |after| is the same as |before|, does nothing and returns
@@ -477,12 +539,14 @@ class IRContext {
   // Change operands of debug instruction to DebugInfoNone.
   void KillOperandFromDebugInstructions(Instruction* inst);
 
-  // Returns the next unique id for use by an instruction.
+  // Returns the next unique id for use by an instruction.  Thread-safe:
+  // relaxed ordering suffices because callers only need distinct values.
   inline uint32_t TakeNextUniqueId() {
+    assert(!frozen_ && "A frozen context must not create new instructions.");
     assert(unique_id_ != std::numeric_limits<uint32_t>::max());
 
     // Skip zero.
-    return ++unique_id_;
+    return unique_id_.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
   // Returns true if |inst| is a combinator in the current context.
@@ -520,6 +584,15 @@ class IRContext {
   // Gets the postdominator analysis for function |f|.
   PostDominatorAnalysis* GetPostDominatorAnalysis(const Function* f);
 
+  // Rehydrates the dominator trees recorded in the module by the
+  // embed-analysis-metadata pass, making them available without
+  // recomputation. When |verify| is set, each recorded tree is checked for
+  // consistency against the CFG in linear time and rejected when the check
+  // fails. Returns true when at least one tree was rehydrated and none was
+  // rejected; functions whose recording is rejected fall back to the normal
+  // on-demand computation.
+  bool LoadEmbeddedAnalysisMetadata(bool verify);
+
   // Remove the dominator tree of |f| from the cache.
   inline void RemoveDominatorAnalysis(const Function* f) {
     dominator_trees_.erase(f);
@@ -555,6 +628,20 @@ class IRContext {
     return next_id;
   }
 
+  // Reserves |count| consecutive fresh SSA ids and returns the first one, or
+  // 0 if the maximum SSA id would be exceeded.  This is the foundation for
+  // parallel transforms: the coordinating thread reserves one block per
+  // worker before fanning out, and each worker then mints ids from its own
+  // block without synchronization.
+  inline uint32_t ReserveIds(uint32_t count) {
+    uint32_t first_id = module()->TakeNextIdBoundBlock(count);
+    if (first_id == 0 && consumer()) {
+      std::string message = "ID overflow. Try running compact-ids.";
+      consumer()(SPV_MSG_ERROR, "", {0, 0, 0}, message.c_str());
+    }
+    return first_id;
+  }
+
   FeatureManager* get_feature_mgr() {
     if (!feature_mgr_.get()) {
       AnalyzeFeatures();
@@ -571,6 +658,60 @@ class IRContext {
   // its definitions and uses.
   inline void UpdateDefUse(Instruction* inst);
 
+  // Starts a batched def-use update scope.  Until CommitDefUseBatch() is
+  // called, AnalyzeDefUse, UpdateDefUse, ForgetUses and AnalyzeUses defer the
+  // re-analysis of uses: definitions stay current so ids always resolve, but
+  // use records of modified instructions are refreshed in bulk when the batch
+  // commits.  An instruction rewritten several times inside the batch is then
+  // re-analyzed once instead of once per edit.  While the batch is open, use
+  // queries (ForEachUser and friends) for modified instructions reflect the
+  // state at the start of the batch, so callers must not grow a definition's
+  // user set and then rely on querying it before the commit.  Batches do not
+  // nest.
+  void BeginDefUseBatch();
+
+  // Applies all deferred def-use updates and closes the batch opened by
+  // BeginDefUseBatch().  Does nothing if the def-use analysis was invalidated
+  // while the batch was open.
+  void CommitDefUseBatch();
+
+  // Block-granular dirty tracking.  SimplificationPass uses this to skip
+  // blocks that no pass has touched since its previous run.  While tracking
+  // is active, the def-use maintenance entry points (AnalyzeUses, ForgetUses,
+  // UpdateDefUse, AnalyzeDefUse and KillInst) record the enclosing block of
+  // every instruction they are handed.  The record is only sound while the
+  // def-use manager and the instruction-to-block mapping stay valid; a pass
+  // that invalidates either of them drops the tracking, which makes every
+  // block count as dirty again.
+
+  // Starts recording touched blocks, clearing any previous record.
+  void StartDirtyBlockTracking() {
+    dirty_block_tracking_ = true;
+    dirty_blocks_.clear();
+    dirty_global_ids_.clear();
+  }
+
+  // Stops recording touched blocks.  Every block counts as dirty afterwards.
+  void StopDirtyBlockTracking() {
+    dirty_block_tracking_ = false;
+    dirty_blocks_.clear();
+    dirty_global_ids_.clear();
+  }
+
+  // Returns true if touched blocks are currently being recorded.
+  bool HasDirtyBlockTracking() const { return dirty_block_tracking_; }
+
+  // Returns the ids of the blocks touched since tracking started.
+  const std::unordered_set<uint32_t>& dirty_blocks() const {
+    return dirty_blocks_;
+  }
+
+  // Returns the result ids of touched instructions that live outside any
+  // block, such as constants and global values.
+  const std::unordered_set<uint32_t>& dirty_global_ids() const {
+    return dirty_global_ids_;
+  }
+
   const InstructionFolder& get_instruction_folder() {
     if (!inst_folder_) {
       inst_folder_ = MakeUnique<InstructionFolder>(this);
@@ -659,6 +800,7 @@ class IRContext {
  private:
   // Builds the def-use manager from scratch, even if it was already valid.
   void BuildDefUseManager() {
+    SPIRV_PROFILE_SCOPED("build-def-use");
     def_use_mgr_ = MakeUnique<analysis::DefUseManager>(module());
     valid_analyses_ = valid_analyses_ | kAnalysisDefUse;
   }
@@ -671,6 +813,7 @@ class IRContext {
 
   // Builds the instruction-block map for the whole module.
   void BuildInstrToBlockMapping() {
+    SPIRV_PROFILE_SCOPED("build-instr-to-block");
     instr_to_block_.clear();
     for (auto& fn : *module_) {
       for (auto& block : fn) {
@@ -692,15 +835,23 @@ class IRContext {
   }
 
   void BuildDecorationManager() {
+    SPIRV_PROFILE_SCOPED("build-decorations");
     decoration_mgr_ = MakeUnique<analysis::DecorationManager>(module());
     valid_analyses_ = valid_analyses_ | kAnalysisDecorations;
   }
 
   void BuildCFG() {
+    SPIRV_PROFILE_SCOPED("build-cfg");
     cfg_ = MakeUnique<CFG>(module());
     valid_analyses_ = valid_analyses_ | kAnalysisCFG;
   }
 
+  // Resets the dominator analysis and then builds the dominator tree of every
+  // function in the module, spreading the independent per-function
+  // constructions across a thread pool.  Postdominator trees stay lazy; they
+  // are only materialized by the first query.
+  void BuildDominatorAnalyses();
+
   void BuildScalarEvolutionAnalysis() {
     scalar_evolution_analysis_ = MakeUnique<ScalarEvolutionAnalysis>(this);
     valid_analyses_ = valid_analyses_ | kAnalysisScalarEvolution;
@@ -715,6 +866,7 @@ class IRContext {
   // Builds the value number table analysis from scratch, even if it was already
   // valid.
   void BuildValueNumberTable() {
+    SPIRV_PROFILE_SCOPED("build-value-number-table");
     vn_table_ = MakeUnique<ValueNumberTable>(this);
     valid_analyses_ = valid_analyses_ | kAnalysisValueNumberTable;
   }
@@ -729,6 +881,7 @@ class IRContext {
   // Builds the constant manager from scratch, even if it was already
   // valid.
   void BuildConstantManager() {
+    SPIRV_PROFILE_SCOPED("build-constants");
     constant_mgr_ = MakeUnique<analysis::ConstantManager>(this);
     valid_analyses_ = valid_analyses_ | kAnalysisConstants;
   }
@@ -736,6 +889,7 @@ class IRContext {
   // Builds the type manager from scratch, even if it was already
   // valid.
   void BuildTypeManager() {
+    SPIRV_PROFILE_SCOPED("build-types");
     type_mgr_ = MakeUnique<analysis::TypeManager>(consumer(), this);
     valid_analyses_ = valid_analyses_ | kAnalysisTypes;
   }
@@ -789,6 +943,22 @@ class IRContext {
   // Remove |inst| from |id_to_name_| if it is in map.
   void RemoveFromIdToName(const Instruction* inst);
 
+  // Records |inst|'s enclosing block (or |inst| itself, for instructions
+  // outside any block) as dirty.  No-op unless tracking is active; drops the
+  // tracking if the instruction-to-block mapping is not valid.
+  void MarkInstDirty(Instruction* inst) {
+    if (!dirty_block_tracking_) return;
+    if (!AreAnalysesValid(kAnalysisInstrToBlockMapping)) {
+      StopDirtyBlockTracking();
+      return;
+    }
+    if (BasicBlock* bb = get_instr_block(inst)) {
+      dirty_blocks_.insert(bb->id());
+    } else if (inst->result_id() != 0) {
+      dirty_global_ids_.insert(inst->result_id());
+    }
+  }
+
   // Returns true if it is suppose to be valid but it is incorrect.  Returns
   // true if the cfg is invalidated.
   bool CheckCFG();
@@ -808,11 +978,12 @@ class IRContext {
   AssemblyGrammar grammar_;
 
   // An unique identifier for instructions in |module_|. Can be used to order
-  // instructions in a container.
+  // instructions in a container.  Atomic so that worker threads building
+  // instructions concurrently get distinct values.
   //
   // This member is initialized to 0, but always issues this value plus one.
   // Therefore, 0 is not a valid unique id for an instruction.
-  uint32_t unique_id_;
+  std::atomic<uint32_t> unique_id_;
 
   // The module being processed within this IR context.
   std::unique_ptr<Module> module_;
@@ -846,6 +1017,19 @@ class IRContext {
   // A bitset indicating which analyzes are currently valid.
   Analysis valid_analyses_;
 
+  // True once Freeze() has been called: the context is read-only and shared
+  // queries no longer build analysis state.
+  bool frozen_ = false;
+
+  // True while touched blocks are being recorded for SimplificationPass.
+  bool dirty_block_tracking_ = false;
+
+  // Ids of the blocks touched since StartDirtyBlockTracking.
+  std::unordered_set<uint32_t> dirty_blocks_;
+
+  // Result ids of touched instructions that live outside any block.
+  std::unordered_set<uint32_t> dirty_global_ids_;
+
   // Opcodes of shader capability core executable instructions
   // without side-effect.
   std::unordered_map<uint32_t, std::unordered_set<uint32_t>> combinator_ops_;
@@ -1179,14 +1363,39 @@ void IRContext::AddFunction(std::unique_ptr<Function>&& f) {
 
 void IRContext::AnalyzeDefUse(Instruction* inst) {
   if (AreAnalysesValid(kAnalysisDefUse)) {
-    get_def_use_mgr()->AnalyzeInstDefUse(inst);
+    analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+    if (def_use_mgr->BatchingUpdates()) {
+      // Register the def now so ids resolve inside the batch; the use
+      // analysis is applied when the batch commits.
+      if (inst->result_id() != 0 &&
+          def_use_mgr->GetDef(inst->result_id()) != inst) {
+        def_use_mgr->AnalyzeInstDef(inst);
+      }
+      def_use_mgr->RecordModifiedInst(inst);
+    } else {
+      def_use_mgr->AnalyzeInstDefUse(inst);
+    }
+  }
+  if (AreAnalysesValid(kAnalysisValueNumberTable) && inst->result_id() != 0) {
+    vn_table_->AddInstruction(inst);
   }
+  MarkInstDirty(inst);
 }
 
 void IRContext::UpdateDefUse(Instruction* inst) {
   if (AreAnalysesValid(kAnalysisDefUse)) {
-    get_def_use_mgr()->UpdateDefUse(inst);
+    analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+    if (def_use_mgr->BatchingUpdates()) {
+      if (inst->result_id() != 0 &&
+          def_use_mgr->GetDef(inst->result_id()) != inst) {
+        def_use_mgr->AnalyzeInstDef(inst);
+      }
+      def_use_mgr->RecordModifiedInst(inst);
+    } else {
+      def_use_mgr->UpdateDefUse(inst);
+    }
   }
+  MarkInstDirty(inst);
 }
 
 void IRContext::BuildIdToNameMap() {
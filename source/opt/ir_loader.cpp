@@ -52,12 +52,18 @@ bool IsLineInst(const spv_parsed_instruction_t* inst) {
          ext_inst_key == NonSemanticShaderDebugInfo100DebugNoLine;
 }
 
+void IrLoader::OffsetInstructionIds(Instruction* inst) const {
+  const uint32_t offset = id_offset_;
+  inst->ForEachId([offset](uint32_t* id) { *id += offset; });
+}
+
 bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
   ++inst_index_;
   if (IsLineInst(inst)) {
     module()->SetContainsDebugInfo();
     last_line_inst_.reset();
     dbg_line_info_.emplace_back(module()->context(), *inst, last_dbg_scope_);
+    if (id_offset_ != 0u) OffsetInstructionIds(&dbg_line_info_.back());
     return true;
   }
 
@@ -77,8 +83,8 @@ bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
         uint32_t inlined_at = 0;
         if (inst->num_words > kInlinedAtIndex)
           inlined_at = inst->words[kInlinedAtIndex];
-        last_dbg_scope_ =
-            DebugScope(inst->words[kLexicalScopeIndex], inlined_at);
+        last_dbg_scope_ = DebugScope(
+            OffsetId(inst->words[kLexicalScopeIndex]), OffsetId(inlined_at));
         module()->SetContainsDebugInfo();
         return true;
       }
@@ -94,8 +100,8 @@ bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
         uint32_t inlined_at = 0;
         if (inst->num_words > kInlinedAtIndex)
           inlined_at = inst->words[kInlinedAtIndex];
-        last_dbg_scope_ =
-            DebugScope(inst->words[kLexicalScopeIndex], inlined_at);
+        last_dbg_scope_ = DebugScope(
+            OffsetId(inst->words[kLexicalScopeIndex]), OffsetId(inlined_at));
         module()->SetContainsDebugInfo();
         return true;
       }
@@ -109,7 +115,10 @@ bool IrLoader::AddInstruction(const spv_parsed_instruction_t* inst) {
 
   std::unique_ptr<Instruction> spv_inst(
       new Instruction(module()->context(), *inst, std::move(dbg_line_info_)));
-  if (!spv_inst->dbg_line_insts().empty()) {
+  // The attached line instructions were already shifted when they were
+  // gathered above.
+  if (id_offset_ != 0u) OffsetInstructionIds(spv_inst.get());
+  if (spv_inst->has_dbg_line_insts()) {
     if (extra_line_tracking_ &&
         (!spv_inst->dbg_line_insts().back().IsNoLine())) {
       last_line_inst_ = std::unique_ptr<Instruction>(
@@ -48,10 +48,13 @@ class IrLoader {
 
   Module* module() const { return module_; }
 
-  // Sets the fields in the module's header to the given parameters.
+  // Sets the fields in the module's header to the given parameters.  The id
+  // bound is raised by the id offset, so that ids the loader allocates
+  // itself also land in the shifted range.
   void SetModuleHeader(uint32_t magic, uint32_t version, uint32_t generator,
                        uint32_t bound, uint32_t reserved) {
-    module_->SetHeader({magic, version, generator, bound, reserved});
+    module_->SetHeader({magic, version, generator, bound + id_offset_,
+                        reserved});
   }
   // Adds an instruction to the module. Returns true if no error occurs. This
   // method will properly capture and store the data provided in |inst| so that
@@ -67,7 +70,22 @@ class IrLoader {
   // track line information.
   void SetExtraLineTracking(bool flag) { extra_line_tracking_ = flag; }
 
+  // Makes the loader add |offset| to every id as instructions stream in,
+  // including debug scope and line references, so the loaded module occupies
+  // the id range [offset + 1, offset + bound).  The linker uses this to give
+  // each input module a disjoint id range without a rewrite pass after
+  // loading.  Must be called before any instruction is added.
+  void SetIdOffset(uint32_t offset) { id_offset_ = offset; }
+
  private:
+  // Returns |id| shifted by the id offset; the null id stays null.
+  uint32_t OffsetId(uint32_t id) const {
+    return id == 0u ? 0u : id + id_offset_;
+  }
+
+  // Adds the id offset to every id operand of |inst|.
+  void OffsetInstructionIds(Instruction* inst) const;
+
   // Consumer for communicating messages to outside.
   const MessageConsumer& consumer_;
   // The module to be built.
@@ -93,6 +111,9 @@ class IrLoader {
   // instructions will be injected to help track line info more robustly during
   // transformations.
   bool extra_line_tracking_ = true;
+
+  // Constant added to every id while loading; see SetIdOffset().
+  uint32_t id_offset_ = 0;
 };
 
 }  // namespace opt
@@ -15,9 +15,11 @@
 #include "source/opt/licm_pass.h"
 
 #include <queue>
+#include <string>
 
 #include "source/opt/module.h"
 #include "source/opt/pass.h"
+#include "source/util/string_utils.h"
 
 namespace spvtools {
 namespace opt {
@@ -31,7 +33,11 @@ Pass::Status LICMPass::ProcessIRContext() {
   // Process each function in the module
   for (auto func = module->begin();
        func != module->end() && status != Status::Failure; ++func) {
-    status = CombineStatus(status, ProcessFunction(&*func));
+    const Status function_status = ProcessFunction(&*func);
+    if (function_status == Status::SuccessWithChange) {
+      MarkFunctionModified(&*func);
+    }
+    status = CombineStatus(status, function_status);
   }
   return status;
 }
@@ -39,6 +45,7 @@ Pass::Status LICMPass::ProcessIRContext() {
 Pass::Status LICMPass::ProcessFunction(Function* f) {
   Status status = Status::SuccessWithoutChange;
   LoopDescriptor* loop_descriptor = context()->GetLoopDescriptor(f);
+  summaries_.clear();
 
   // Process each loop in the function
   for (auto it = loop_descriptor->begin();
@@ -63,28 +70,185 @@ Pass::Status LICMPass::ProcessLoop(Loop* loop, Function* f) {
     status = CombineStatus(status, ProcessLoop(nested_loop, f));
   }
 
+  // Build the safety summary for this loop once; every hoisting candidate in
+  // the loop consults it instead of re-walking the loop body.
+  const LoopSummary& summary = GetLoopSummary(loop, f);
+
   std::vector<BasicBlock*> loop_bbs{};
   status = CombineStatus(
-      status,
-      AnalyseAndHoistFromBB(loop, f, loop->GetHeaderBlock(), &loop_bbs));
+      status, AnalyseAndHoistFromBB(loop, f, summary, loop->GetHeaderBlock(),
+                                    &loop_bbs));
 
   for (size_t i = 0; i < loop_bbs.size() && status != Status::Failure; ++i) {
     BasicBlock* bb = loop_bbs[i];
     // do not delete the element
-    status =
-        CombineStatus(status, AnalyseAndHoistFromBB(loop, f, bb, &loop_bbs));
+    status = CombineStatus(
+        status, AnalyseAndHoistFromBB(loop, f, summary, bb, &loop_bbs));
   }
 
   return status;
 }
 
+const LICMPass::LoopSummary& LICMPass::GetLoopSummary(Loop* loop,
+                                                      Function* f) {
+  auto where = summaries_.find(loop);
+  if (where != summaries_.end()) {
+    return where->second;
+  }
+
+  LoopSummary summary;
+  // Loops are processed from the inside out, so the summaries of nested
+  // loops already exist; merge them instead of re-walking their blocks.
+  for (Loop* nested_loop : *loop) {
+    const LoopSummary& nested = GetLoopSummary(nested_loop, f);
+    summary.written_objects.insert(nested.written_objects.begin(),
+                                   nested.written_objects.end());
+    summary.has_barrier |= nested.has_barrier;
+    summary.has_unknown_write |= nested.has_unknown_write;
+  }
+
+  CFG* cfg = context()->cfg();
+  for (uint32_t bb_id : loop->GetBlocks()) {
+    BasicBlock* bb = cfg->block(bb_id);
+    if (!IsImmediatelyContainedInLoop(loop, f, bb)) {
+      continue;
+    }
+    for (Instruction& inst : *bb) {
+      AddInstructionToSummary(&inst, &summary);
+    }
+  }
+  return summaries_.emplace(loop, std::move(summary)).first->second;
+}
+
+void LICMPass::AddInstructionToSummary(Instruction* inst,
+                                       LoopSummary* summary) {
+  switch (inst->opcode()) {
+    case spv::Op::OpControlBarrier:
+    case spv::Op::OpMemoryBarrier:
+    case spv::Op::OpMemoryNamedBarrier:
+      summary->has_barrier = true;
+      return;
+    case spv::Op::OpFunctionCall:
+    case spv::Op::OpImageWrite:
+      summary->has_unknown_write = true;
+      return;
+    case spv::Op::OpExtInst:
+      AddExtInstToSummary(inst, summary);
+      return;
+    case spv::Op::OpStore:
+    case spv::Op::OpCopyMemory:
+    case spv::Op::OpCopyMemorySized:
+      break;
+    default:
+      if (!inst->IsAtomicOp()) {
+        return;
+      }
+      break;
+  }
+
+  // The instruction writes through its pointer operand.  Attribute the write
+  // to the underlying variable when the pointer leads back to one.
+  Instruction* base = inst->GetBaseAddress();
+  if (base != nullptr && base->opcode() == spv::Op::OpVariable) {
+    summary->written_objects.insert(base->result_id());
+  } else {
+    summary->has_unknown_write = true;
+  }
+}
+
+void LICMPass::AddExtInstToSummary(Instruction* inst, LoopSummary* summary) {
+  analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+  Instruction* import =
+      def_use_mgr->GetDef(inst->GetSingleWordInOperand(0u));
+  const std::string import_name = import->GetInOperand(0u).AsString();
+  if (import_name != "GLSL.std.450") {
+    // Non-semantic instructions have no effect on memory.  Other sets
+    // (OpenCL.std in particular) contain instructions that write through
+    // pointer operands, so treat them as writes we cannot attribute.
+    if (!utils::starts_with(import_name, "NonSemantic.")) {
+      summary->has_unknown_write = true;
+    }
+    return;
+  }
+  const uint32_t ext_inst = inst->GetSingleWordInOperand(1u);
+  if (ext_inst != GLSLstd450Modf && ext_inst != GLSLstd450Frexp) {
+    // Every other GLSL.std.450 instruction computes a pure value.
+    return;
+  }
+
+  // Modf and Frexp store the integral part or exponent through their last
+  // operand.  Attribute the write to the underlying variable, chasing the
+  // pointer the same way GetBaseAddress does for memory instructions.
+  Instruction* base = def_use_mgr->GetDef(
+      inst->GetSingleWordInOperand(inst->NumInOperands() - 1));
+  bool done = false;
+  while (!done) {
+    switch (base->opcode()) {
+      case spv::Op::OpAccessChain:
+      case spv::Op::OpInBoundsAccessChain:
+      case spv::Op::OpPtrAccessChain:
+      case spv::Op::OpInBoundsPtrAccessChain:
+      case spv::Op::OpCopyObject:
+        base = def_use_mgr->GetDef(base->GetSingleWordInOperand(0));
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+  if (base->opcode() == spv::Op::OpVariable) {
+    summary->written_objects.insert(base->result_id());
+  } else {
+    summary->has_unknown_write = true;
+  }
+}
+
+bool LICMPass::ShouldHoistInstruction(Loop* loop, const LoopSummary& summary,
+                                      const Instruction& inst) {
+  if (!inst.IsOpcodeCodeMotionSafe() ||
+      !loop->AreAllOperandsOutsideLoop(inst)) {
+    return false;
+  }
+  if (!inst.IsLoad()) {
+    return true;
+  }
+  if (inst.IsReadOnlyLoad()) {
+    return true;
+  }
+
+  // A load carrying memory operands (Volatile, Aliased, ...) must stay put.
+  if (inst.NumInOperands() > 1) {
+    return false;
+  }
+
+  // The load may be hoisted when nothing in the loop can write the memory it
+  // reads.  Only function-local and private variables qualify: nothing
+  // outside the current invocation can write those, so it is enough to check
+  // that the loop itself has no write to the variable, no write we failed to
+  // attribute, and no barrier another write could synchronize through.
+  if (summary.has_barrier || summary.has_unknown_write) {
+    return false;
+  }
+  Instruction* base = inst.GetBaseAddress();
+  if (base == nullptr || base->opcode() != spv::Op::OpVariable) {
+    return false;
+  }
+  const auto storage_class =
+      spv::StorageClass(base->GetSingleWordInOperand(0));
+  if (storage_class != spv::StorageClass::Function &&
+      storage_class != spv::StorageClass::Private) {
+    return false;
+  }
+  return summary.written_objects.count(base->result_id()) == 0;
+}
+
 Pass::Status LICMPass::AnalyseAndHoistFromBB(
-    Loop* loop, Function* f, BasicBlock* bb,
+    Loop* loop, Function* f, const LoopSummary& summary, BasicBlock* bb,
     std::vector<BasicBlock*>* loop_bbs) {
   bool modified = false;
   std::function<bool(Instruction*)> hoist_inst =
-      [this, &loop, &modified](Instruction* inst) {
-        if (loop->ShouldHoistInstruction(*inst)) {
+      [this, &loop, &summary, &modified](Instruction* inst) {
+        if (ShouldHoistInstruction(loop, summary, *inst)) {
           if (!HoistInstruction(loop, inst)) {
             return false;
           }
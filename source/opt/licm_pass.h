@@ -16,6 +16,8 @@
 #define SOURCE_OPT_LICM_PASS_H_
 
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "source/opt/basic_block.h"
@@ -33,7 +35,32 @@ class LICMPass : public Pass {
   const char* name() const override { return "loop-invariant-code-motion"; }
   Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
+  IRContext::Analysis GetPreservedAnalysesForUnmodifiedFunctions() override {
+    // Hoisting only moves instructions within one function, so the
+    // dominator trees, loop descriptors, and structured-CFG state of the
+    // functions it leaves alone stay valid.
+    return IRContext::kPerFunctionAnalyses;
+  }
+
  private:
+  // Safety facts about the body of one loop, gathered in a single sweep over
+  // its blocks and shared by every hoisting candidate in that loop.
+  struct LoopSummary {
+    // Result ids of the OpVariables written somewhere in the loop, found by
+    // chasing the pointer operand of each store with GetBaseAddress.
+    std::unordered_set<uint32_t> written_objects;
+    // True if the loop contains a barrier instruction.
+    bool has_barrier = false;
+    // True if the loop contains an instruction that may write memory we
+    // cannot attribute to a particular variable, such as a function call or
+    // a store through a pointer that does not lead back to an OpVariable.
+    bool has_unknown_write = false;
+  };
+
   // Searches the IRContext for functions and processes each, moving invariants
   // outside loops within the function where possible.
   // Returns the status depending on whether or not there was a failure or
@@ -55,15 +82,41 @@ class LICMPass : public Pass {
   // Each child of |bb| wrt to |dom_tree| is pushed to |loop_bbs|
   // Returns the status depending on whether or not there was a failure or
   // change.
-  Pass::Status AnalyseAndHoistFromBB(Loop* loop, Function* f, BasicBlock* bb,
+  Pass::Status AnalyseAndHoistFromBB(Loop* loop, Function* f,
+                                     const LoopSummary& summary,
+                                     BasicBlock* bb,
                                      std::vector<BasicBlock*>* loop_bbs);
 
+  // Returns the cached summary for |loop|, building it on first use.  A
+  // summary sweeps only the blocks immediately contained in |loop| and merges
+  // the already-built summaries of its nested loops, so each block in a loop
+  // nest is visited exactly once regardless of nesting depth.
+  const LoopSummary& GetLoopSummary(Loop* loop, Function* f);
+
+  // Records the effects of |inst| in |summary|.
+  void AddInstructionToSummary(Instruction* inst, LoopSummary* summary);
+
+  // Records the effects of the OpExtInst |inst| in |summary|.  GLSL.std.450
+  // Modf and Frexp write through their pointer operand; instructions from
+  // sets we do not know to be side-effect free count as unknown writes.
+  void AddExtInstToSummary(Instruction* inst, LoopSummary* summary);
+
+  // Returns true if |inst| can be hoisted out of |loop|.  The opcode and
+  // operand checks are those of Loop::ShouldHoistInstruction; in addition, a
+  // load of a function-local or private variable may be hoisted when
+  // |summary| shows that nothing in the loop can write the loaded memory.
+  bool ShouldHoistInstruction(Loop* loop, const LoopSummary& summary,
+                              const Instruction& inst);
+
   // Returns true if |bb| is immediately contained in |loop|
   bool IsImmediatelyContainedInLoop(Loop* loop, Function* f, BasicBlock* bb);
 
   // Move the instruction to the preheader of |loop|.
   // This method will update the instruction to block mapping for the context
   bool HoistInstruction(Loop* loop, Instruction* inst);
+
+  // Summaries built so far for the function being processed, keyed by loop.
+  std::unordered_map<const Loop*, LoopSummary> summaries_;
 };
 
 }  // namespace opt
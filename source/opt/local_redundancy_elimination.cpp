@@ -21,16 +21,25 @@ namespace opt {
 
 Pass::Status LocalRedundancyEliminationPass::Process() {
   bool modified = false;
-  ValueNumberTable vnTable(context());
+  const ValueNumberTable& vnTable = *context()->GetValueNumberTable();
+
+  // For each value number, the id in the current block that holds that value.
+  // The array is shared between blocks: the entries written while processing
+  // a block are recorded in |assigned_values| and cleared before moving on,
+  // so only the touched slots are reset.
+  std::vector<uint32_t> value_to_ids(vnTable.NumValueNumbers(), 0);
+  std::vector<uint32_t> assigned_values;
 
   for (auto& func : *get_module()) {
     for (auto& bb : func) {
-      // Keeps track of all ids that contain a given value number. We keep
-      // track of multiple values because they could have the same value, but
-      // different decorations.
-      std::map<uint32_t, uint32_t> value_to_ids;
-      if (EliminateRedundanciesInBB(&bb, vnTable, &value_to_ids))
+      if (EliminateRedundanciesInBB(&bb, vnTable, &value_to_ids,
+                                    &assigned_values)) {
         modified = true;
+      }
+      for (uint32_t value : assigned_values) {
+        value_to_ids[value] = 0;
+      }
+      assigned_values.clear();
     }
   }
   return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
@@ -38,10 +47,12 @@ Pass::Status LocalRedundancyEliminationPass::Process() {
 
 bool LocalRedundancyEliminationPass::EliminateRedundanciesInBB(
     BasicBlock* block, const ValueNumberTable& vnTable,
-    std::map<uint32_t, uint32_t>* value_to_ids) {
+    std::vector<uint32_t>* value_to_ids,
+    std::vector<uint32_t>* assigned_values) {
   bool modified = false;
 
-  auto func = [this, &vnTable, &modified, value_to_ids](Instruction* inst) {
+  auto func = [this, &vnTable, &modified, value_to_ids,
+               assigned_values](Instruction* inst) {
     if (inst->result_id() == 0) {
       return;
     }
@@ -52,10 +63,13 @@ bool LocalRedundancyEliminationPass::EliminateRedundanciesInBB(
       return;
     }
 
-    auto candidate = value_to_ids->insert({value, inst->result_id()});
-    if (!candidate.second) {
+    uint32_t& dominating_id = (*value_to_ids)[value];
+    if (dominating_id == 0) {
+      dominating_id = inst->result_id();
+      assigned_values->push_back(value);
+    } else {
       context()->KillNamesAndDecorates(inst);
-      context()->ReplaceAllUsesWith(inst->result_id(), candidate.first->second);
+      context()->ReplaceAllUsesWith(inst->result_id(), dominating_id);
       context()->KillInst(inst);
       modified = true;
     }
@@ -15,7 +15,7 @@
 #ifndef SOURCE_OPT_LOCAL_REDUNDANCY_ELIMINATION_H_
 #define SOURCE_OPT_LOCAL_REDUNDANCY_ELIMINATION_H_
 
-#include <map>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 #include "source/opt/pass.h"
@@ -42,7 +42,8 @@ class LocalRedundancyEliminationPass : public Pass {
            IRContext::kAnalysisDecorations | IRContext::kAnalysisCombinators |
            IRContext::kAnalysisCFG | IRContext::kAnalysisDominatorAnalysis |
            IRContext::kAnalysisNameMap | IRContext::kAnalysisConstants |
-           IRContext::kAnalysisTypes;
+           IRContext::kAnalysisTypes |
+           IRContext::kAnalysisValueNumberTable;
   }
 
  protected:
@@ -52,14 +53,18 @@ class LocalRedundancyEliminationPass : public Pass {
   // |vnTable| must have computed a value number for every result id defined
   // in |bb|.
   //
-  // |value_to_ids| is a map from value number to ids.  If {vn, id} is in
-  // |value_to_ids| then vn is the value number of id, and the definition of id
-  // dominates |bb|.
+  // |value_to_ids| is indexed by value number and must have at least
+  // |vnTable.NumValueNumbers()| entries.  If |(*value_to_ids)[vn]| is a
+  // nonzero id, then vn is the value number of that id, and the definition
+  // of the id dominates |bb|.  Every entry this call fills in is appended to
+  // |assigned_values| so that the caller can roll the array back when it
+  // leaves the scope of |block|.
   //
   // Returns true if the module is changed.
   bool EliminateRedundanciesInBB(BasicBlock* block,
                                  const ValueNumberTable& vnTable,
-                                 std::map<uint32_t, uint32_t>* value_to_ids);
+                                 std::vector<uint32_t>* value_to_ids,
+                                 std::vector<uint32_t>* assigned_values);
 };
 
 }  // namespace opt
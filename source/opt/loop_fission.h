@@ -59,6 +59,17 @@ class LoopFissionPass : public Pass {
 
   Pass::Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
+  // The pass registers every loop it splits with the loop descriptor (see
+  // the InvalidateAnalysesExceptFor call after a split), so a following loop
+  // pass does not need to rebuild the descriptors.
+  IRContext::Analysis GetPreservedAnalyses() override {
+    return IRContext::kAnalysisLoopAnalysis;
+  }
+
   // Checks if |loop| meets the register pressure criteria to be split.
   bool ShouldSplitLoop(const Loop& loop, IRContext* context);
 
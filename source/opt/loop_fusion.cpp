@@ -379,6 +379,65 @@ LoopFusion::GetLoadsAndStoresInLoop(Loop* loop) {
   return std::make_pair(loads, stores);
 }
 
+std::set<LoopFusion::AccessStream> LoopFusion::GetAccessStreams(
+    Loop* loop, ScalarEvolutionAnalysis* scalar_analysis) {
+  auto loads_stores = GetLoadsAndStoresInLoop(loop);
+  std::vector<Instruction*> mem_ops = std::move(loads_stores.first);
+  mem_ops.insert(mem_ops.end(), loads_stores.second.begin(),
+                 loads_stores.second.end());
+
+  std::set<AccessStream> streams{};
+  for (auto instruction : mem_ops) {
+    auto access_location = context_->get_def_use_mgr()->GetDef(
+        instruction->GetSingleWordInOperand(0));
+
+    std::vector<const void*> access_function{};
+    while (access_location->opcode() == spv::Op::OpAccessChain) {
+      for (uint32_t i = 1; i < access_location->NumInOperands(); ++i) {
+        auto index = context_->get_def_use_mgr()->GetDef(
+            access_location->GetSingleWordInOperand(i));
+        SENode* index_node = scalar_analysis->SimplifyExpression(
+            scalar_analysis->AnalyzeInstruction(index));
+        if (index_node->IsCantCompute()) {
+          access_function.push_back(index);
+        } else {
+          access_function.push_back(index_node);
+        }
+      }
+      access_location = context_->get_def_use_mgr()->GetDef(
+          access_location->GetSingleWordInOperand(0));
+    }
+
+    streams.insert({access_location, std::move(access_function)});
+  }
+
+  return streams;
+}
+
+bool LoopFusion::IsProfitable(size_t max_fused_data_streams,
+                              size_t min_reused_data_streams) {
+  // Use a local scalar evolution instance so that pretending the loops are
+  // the same does not leak into the analysis cached on the context.
+  ScalarEvolutionAnalysis scalar_analysis(context_);
+  scalar_analysis.AddLoopsToPretendAreTheSame({loop_0_, loop_1_});
+
+  auto streams_0 = GetAccessStreams(loop_0_, &scalar_analysis);
+  auto streams_1 = GetAccessStreams(loop_1_, &scalar_analysis);
+
+  size_t reused_streams = 0;
+  for (const auto& stream : streams_1) {
+    if (streams_0.count(stream) != 0) {
+      ++reused_streams;
+    }
+  }
+
+  const size_t fused_streams =
+      streams_0.size() + streams_1.size() - reused_streams;
+
+  return reused_streams >= min_reused_data_streams &&
+         fused_streams <= max_fused_data_streams;
+}
+
 bool LoopFusion::IsUsedInLoop(Instruction* instruction, Loop* loop) {
   auto not_used = context_->get_def_use_mgr()->WhileEachUser(
       instruction, [this, loop](Instruction* user) {
@@ -55,6 +55,20 @@ class LoopFusion {
   // * there are no function calls in the loops (could have side-effects)
   bool IsLegal();
 
+  // Checks if fusing compatible and legal |loop_0| and |loop_1| is expected
+  // to improve data locality.  The loads and stores of each loop are grouped
+  // into access streams - a base variable together with the scalar-evolution
+  // access functions of its access chain indices - and fusion is deemed
+  // profitable when the loops share at least |min_reused_data_streams|
+  // streams (so fusion turns cross-loop reuse into reuse within one
+  // iteration) while the fused loop touches at most |max_fused_data_streams|
+  // distinct streams (so the combined working set does not thrash the
+  // cache).  Both bounds are machine parameters to be tuned for the target's
+  // cache hierarchy.  Accesses whose index expressions cannot be analysed
+  // count towards the footprint but never as reuse.
+  bool IsProfitable(size_t max_fused_data_streams,
+                    size_t min_reused_data_streams);
+
   // Perform the actual fusion of |loop_0_| and |loop_1_|. The loops have to be
   // compatible and the fusion has to be legal.
   void Fuse();
@@ -94,6 +108,20 @@ class LoopFusion {
   std::map<Instruction*, std::vector<Instruction*>> LocationToMemOps(
       const std::vector<Instruction*>& mem_ops);
 
+  // An access stream: the base variable of a load or store together with one
+  // entry per access chain index.  An index that scalar evolution can
+  // analyse is represented by its SENode, which |scalar_analysis| uniques,
+  // so equal streams compare equal; an unanalysable index is represented by
+  // the index instruction itself, so it only ever matches accesses through
+  // that same instruction.
+  using AccessStream = std::pair<Instruction*, std::vector<const void*>>;
+
+  // Returns the distinct access streams of the loads and stores of |loop|.
+  // |scalar_analysis| must pretend that the loops to be fused are the same
+  // so that streams from the two loops are directly comparable.
+  std::set<AccessStream> GetAccessStreams(
+      Loop* loop, ScalarEvolutionAnalysis* scalar_analysis);
+
   IRContext* context_;
 
   // The original loops to be fused.
@@ -47,6 +47,12 @@ bool LoopFusionPass::ProcessFunction(Function* function) {
       LoopFusion fusion(context(), &loop_0, &loop_1);
 
       if (fusion.AreCompatible() && fusion.IsLegal()) {
+        if (max_fused_data_streams_ != 0 &&
+            !fusion.IsProfitable(max_fused_data_streams_,
+                                 min_reused_data_streams_)) {
+          continue;
+        }
+
         RegisterLiveness liveness(context(), function);
         RegisterLiveness::RegionRegisterLiveness reg_pressure{};
         liveness.SimulateFusion(loop_0, loop_1, &reg_pressure);
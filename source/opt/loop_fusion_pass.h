@@ -24,10 +24,22 @@ namespace opt {
 // This pass will look for adjacent loops that are compatible and legal to be
 // fused. It will fuse all such loops as long as the register usage for the
 // fused loop stays under the threshold defined by |max_registers_per_loop|.
+//
+// When |max_fused_data_streams| is non-zero a cache-locality cost model is
+// applied on top: a pair of loops is only fused when they share at least
+// |min_reused_data_streams| access streams (see LoopFusion::IsProfitable)
+// and the fused loop touches at most |max_fused_data_streams| distinct
+// streams.  With the default of zero every legal fusion within the register
+// budget is performed, as before.
 class LoopFusionPass : public Pass {
  public:
-  explicit LoopFusionPass(size_t max_registers_per_loop)
-      : Pass(), max_registers_per_loop_(max_registers_per_loop) {}
+  explicit LoopFusionPass(size_t max_registers_per_loop,
+                          size_t max_fused_data_streams = 0,
+                          size_t min_reused_data_streams = 1)
+      : Pass(),
+        max_registers_per_loop_(max_registers_per_loop),
+        max_fused_data_streams_(max_fused_data_streams),
+        min_reused_data_streams_(min_reused_data_streams) {}
 
   const char* name() const override { return "loop-fusion"; }
 
@@ -36,6 +48,10 @@ class LoopFusionPass : public Pass {
   // successful to indicate whether changes have been made to the module.
   Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
  private:
   // Fuse loops in |function| if compatible, legal and the fused loop won't use
   // too many registers.
@@ -43,6 +59,14 @@ class LoopFusionPass : public Pass {
 
   // The maximum number of registers a fused loop is allowed to use.
   size_t max_registers_per_loop_;
+
+  // The maximum number of distinct access streams a fused loop may touch.
+  // Zero disables the cache-locality cost model.
+  size_t max_fused_data_streams_;
+
+  // The minimum number of access streams two loops must share for fusion to
+  // be considered profitable when the cost model is enabled.
+  size_t min_reused_data_streams_;
 };
 
 }  // namespace opt
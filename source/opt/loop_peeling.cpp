@@ -587,8 +587,6 @@ bool LoopPeelingPass::ProcessFunction(Function* f) {
     to_process_loop.push_back(&l);
   }
 
-  ScalarEvolutionAnalysis scev_analysis(context());
-
   for (Loop* loop : to_process_loop) {
     CodeMetrics loop_size;
     loop_size.Analyze(*loop);
@@ -264,6 +264,17 @@ class LoopPeelingPass : public Pass {
   // successful to indicate whether changes have been made to the module.
   Pass::Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
+  // The pass keeps the loop descriptors up to date as it peels (see the
+  // InvalidateAnalysesExceptFor calls in LoopUtils), so a following loop
+  // pass does not need to rebuild them.
+  IRContext::Analysis GetPreservedAnalyses() override {
+    return IRContext::kAnalysisLoopAnalysis;
+  }
+
  private:
   // Describes the peeling direction.
   enum class CmpOperator {
@@ -873,8 +873,10 @@ void LoopUnrollerUtilsImpl::AssignNewResultIds(BasicBlock* basic_block) {
 
   for (Instruction& inst : *basic_block) {
     // Do def/use analysis on new lines
-    for (auto& line : inst.dbg_line_insts())
-      def_use_mgr->AnalyzeInstDefUse(&line);
+    if (inst.has_dbg_line_insts()) {
+      for (auto& line : inst.dbg_line_insts())
+        def_use_mgr->AnalyzeInstDefUse(&line);
+    }
 
     uint32_t old_id = inst.result_id();
 
@@ -1119,6 +1121,20 @@ Pass::Status LoopUnroller::Process() {
       continue;
     }
 
+    // Building a loop descriptor computes the dominator tree and the loop
+    // forest of the function; skip that work when the function cannot
+    // contain a loop at all.
+    bool has_loops = false;
+    for (const BasicBlock& block : f) {
+      if (block.IsLoopHeader()) {
+        has_loops = true;
+        break;
+      }
+    }
+    if (!has_loops) {
+      continue;
+    }
+
     LoopDescriptor* LD = context()->GetLoopDescriptor(&f);
     for (Loop& loop : *LD) {
       LoopUtils loop_utils{context(), &loop};
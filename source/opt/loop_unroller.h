@@ -30,12 +30,20 @@ class LoopUnroller : public Pass {
 
   Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
+  // kAnalysisLoopAnalysis is preserved because the unroller maintains the
+  // loop descriptors while it works (it invalidates everything except them
+  // after each unrolled loop), so a following loop pass does not need to
+  // rebuild them.
   IRContext::Analysis GetPreservedAnalyses() override {
     return IRContext::kAnalysisDefUse |
            IRContext::kAnalysisInstrToBlockMapping |
            IRContext::kAnalysisDecorations | IRContext::kAnalysisCombinators |
            IRContext::kAnalysisNameMap | IRContext::kAnalysisConstants |
-           IRContext::kAnalysisTypes;
+           IRContext::kAnalysisTypes | IRContext::kAnalysisLoopAnalysis;
   }
 
  private:
@@ -33,6 +33,10 @@ class LoopUnswitchPass : public Pass {
   // successful to indicate whether changes have been made to the module.
   Pass::Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+
  private:
   bool ProcessFunction(Function* f);
 };
@@ -427,9 +427,17 @@ void LoopUtils::CreateLoopDedicatedExits() {
   }
 
   if (made_change) {
+    // Only |function| gained blocks, so drop the dominator and structured-CFG
+    // information for it alone; both analyses remain valid for every other
+    // function in the module.
     context_->InvalidateAnalysesExceptFor(
         PreservedAnalyses | IRContext::kAnalysisCFG |
-        IRContext::Analysis::kAnalysisLoopAnalysis);
+        IRContext::Analysis::kAnalysisLoopAnalysis |
+        IRContext::Analysis::kAnalysisDominatorAnalysis |
+        IRContext::Analysis::kAnalysisStructuredCFG);
+    context_->InvalidateAnalysesForFunction(
+        function, IRContext::Analysis::kAnalysisDominatorAnalysis |
+                      IRContext::Analysis::kAnalysisStructuredCFG);
   }
 }
 
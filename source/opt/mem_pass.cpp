@@ -442,6 +442,15 @@ bool MemPass::RemoveUnreachableBlocks(Function* func) {
     block->ForMergeAndContinueLabel(mark_reachable);
   }
 
+  // If every block is reachable there is nothing to prune, so skip the phi
+  // and block sweeps below.
+  size_t block_count = 0;
+  for (auto& block : *func) {
+    (void)block;
+    ++block_count;
+  }
+  if (reachable_blocks.size() == block_count) return false;
+
   // Update operands of Phi nodes that reference unreachable blocks.
   for (auto& block : *func) {
     // If the block is about to be removed, don't bother updating its
@@ -21,6 +21,7 @@
 #include "source/operand.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/reflect.h"
+#include "source/util/hash_combine.h"
 
 namespace spvtools {
 namespace opt {
@@ -37,6 +38,20 @@ uint32_t Module::TakeNextIdBound() {
   return header_.bound++;
 }
 
+uint32_t Module::TakeNextIdBoundBlock(uint32_t count) {
+  const uint32_t max_bound =
+      context() ? context()->max_id_bound() : kDefaultMaxIdBound;
+  // The block [bound, bound + count) must stay below the maximum, mirroring
+  // the single-id overflow check above.  Rearranged to avoid overflow.
+  if (count == 0 || count > max_bound || id_bound() > max_bound - count) {
+    return 0;
+  }
+
+  const uint32_t first = header_.bound;
+  header_.bound += count;
+  return first;
+}
+
 std::vector<Instruction*> Module::GetTypes() {
   std::vector<Instruction*> type_insts;
   for (auto& inst : types_values_) {
@@ -139,6 +154,19 @@ void Module::ForEachInst(const std::function<void(const Instruction*)>& f,
 }
 
 void Module::ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const {
+  // Pre-size the output: summing instruction word counts in one cheap walk
+  // avoids repeatedly regrowing |binary| during emission.  The estimate is
+  // not exact — DebugScope, DebugNoLine and OpNoLine instructions
+  // synthesized below add a few words and folded line instructions remove
+  // some — but it is close enough to make reallocation rare.
+  size_t expected_words = 5;
+  ForEachInst(
+      [&expected_words](const Instruction* i) {
+        expected_words += 1 + i->NumOperandWords();
+      },
+      true);
+  binary->reserve(binary->size() + expected_words);
+
   binary->push_back(header_.magic_number);
   binary->push_back(header_.version);
   // TODO(antiagainst): should we change the generator number?
@@ -172,7 +200,7 @@ void Module::ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const {
                 })) {
           return;
         }
-      } else if (!i->IsNoLine() && i->dbg_line_insts().empty()) {
+      } else if (!i->IsNoLine() && !i->has_dbg_line_insts()) {
         // If the current instruction does not have the line information,
         // the last line information is not effective any more. Emit OpNoLine
         // or DebugNoLine to specify it.
@@ -240,6 +268,54 @@ void Module::ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const {
   binary->data()[bound_idx] = header_.bound;
 }
 
+void Module::CloneInto(IRContext* new_context) const {
+  Module* clone = new_context->module();
+  assert(clone->functions_.empty() && clone->capabilities_.empty() &&
+         "Expected to clone into an empty module");
+
+  // Copy the header first: cloning an instruction consumes a fresh unique id
+  // from |new_context|, and cloned debug line instructions additionally take
+  // fresh result ids from the id bound.
+  clone->SetHeader(header_);
+  if (contains_debug_info_) clone->SetContainsDebugInfo();
+
+  const auto clone_insts = [new_context](const InstructionList& source,
+                                         InstructionList* dest) {
+    for (const Instruction& inst : source) {
+      dest->push_back(std::unique_ptr<Instruction>(inst.Clone(new_context)));
+    }
+  };
+  clone_insts(capabilities_, &clone->capabilities_);
+  clone_insts(extensions_, &clone->extensions_);
+  clone_insts(ext_inst_imports_, &clone->ext_inst_imports_);
+  if (memory_model_) {
+    clone->memory_model_.reset(memory_model_->Clone(new_context));
+  }
+  if (sampled_image_address_mode_) {
+    clone->sampled_image_address_mode_.reset(
+        sampled_image_address_mode_->Clone(new_context));
+  }
+  clone_insts(entry_points_, &clone->entry_points_);
+  clone_insts(execution_modes_, &clone->execution_modes_);
+  clone_insts(debugs1_, &clone->debugs1_);
+  clone_insts(debugs2_, &clone->debugs2_);
+  clone_insts(debugs3_, &clone->debugs3_);
+  clone_insts(ext_inst_debuginfo_, &clone->ext_inst_debuginfo_);
+  clone_insts(annotations_, &clone->annotations_);
+  clone_insts(types_values_, &clone->types_values_);
+
+  clone->functions_.reserve(functions_.size());
+  for (const auto& function : functions_) {
+    clone->functions_.emplace_back(function->Clone(new_context));
+  }
+
+  clone->trailing_dbg_line_info_.reserve(trailing_dbg_line_info_.size());
+  for (const Instruction& inst : trailing_dbg_line_info_) {
+    std::unique_ptr<Instruction> cloned_inst(inst.Clone(new_context));
+    clone->trailing_dbg_line_info_.push_back(std::move(*cloned_inst));
+  }
+}
+
 uint32_t Module::ComputeIdBound() const {
   uint32_t highest = 0;
 
@@ -256,6 +332,63 @@ uint32_t Module::ComputeIdBound() const {
   return highest + 1;
 }
 
+ModuleContentHash Module::ComputeContentHash() const {
+  ModuleContentHash hash;
+
+  // Folds the words of |inst| and of its attached debug line instructions
+  // into |seed|.  |words| is hoisted out so all instructions share one
+  // buffer.
+  std::vector<uint32_t> words;
+  auto hash_inst = [&words](size_t seed, const Instruction* inst) {
+    words.clear();
+    for (const auto& line : inst->dbg_line_insts()) {
+      line.ToBinaryWithoutAttachedDebugInsts(&words);
+    }
+    inst->ToBinaryWithoutAttachedDebugInsts(&words);
+    return utils::hash_combine(seed, words);
+  };
+  auto hash_list = [&hash_inst](size_t seed, const InstructionList& list) {
+    for (const auto& inst : list) seed = hash_inst(seed, &inst);
+    return seed;
+  };
+
+  size_t preamble = hash_list(0, capabilities_);
+  preamble = hash_list(preamble, extensions_);
+  preamble = hash_list(preamble, ext_inst_imports_);
+  if (memory_model_) preamble = hash_inst(preamble, memory_model_.get());
+  if (sampled_image_address_mode_) {
+    preamble = hash_inst(preamble, sampled_image_address_mode_.get());
+  }
+  preamble = hash_list(preamble, entry_points_);
+  hash.preamble = hash_list(preamble, execution_modes_);
+
+  size_t debug = hash_list(0, debugs1_);
+  debug = hash_list(debug, debugs2_);
+  debug = hash_list(debug, debugs3_);
+  hash.debug_and_annotations = hash_list(debug, annotations_);
+
+  size_t globals = hash_list(0, types_values_);
+  hash.types_and_globals = hash_list(globals, ext_inst_debuginfo_);
+
+  size_t combined = utils::hash_combine(size_t(0), header_.version);
+  combined = utils::hash_combine(combined, hash.preamble);
+  combined = utils::hash_combine(combined, hash.debug_and_annotations);
+  combined = utils::hash_combine(combined, hash.types_and_globals);
+  for (const auto& func : functions_) {
+    size_t func_hash = 0;
+    static_cast<const Function*>(func.get())->ForEachInst(
+        [&func_hash, &hash_inst](const Instruction* inst) {
+          func_hash = hash_inst(func_hash, inst);
+        },
+        /* run_on_debug_line_insts = */ false,
+        /* run_on_non_semantic_insts = */ true);
+    hash.functions[func->result_id()] = func_hash;
+    combined = utils::hash_combine(combined, func_hash);
+  }
+  hash.combined = combined;
+  return hash;
+}
+
 bool Module::HasExplicitCapability(uint32_t cap) {
   for (auto& ci : capabilities_) {
     uint32_t tcap = ci.GetSingleWordOperand(0);
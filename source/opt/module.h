@@ -39,6 +39,26 @@ struct ModuleHeader {
   uint32_t schema;
 };
 
+// Per-section content hashes of a module, produced by
+// Module::ComputeContentHash().  Only instruction words contribute, so two
+// modules that differ solely in the generator, bound or schema header fields
+// hash section-for-section equal.  |functions| is keyed by the OpFunction
+// result id, which lets a caller diff two snapshots of the same module and
+// re-process only the functions whose hash changed.
+struct ModuleContentHash {
+  // Capabilities through execution modes (layout sections 1-6).
+  uint64_t preamble = 0;
+  // Debug and annotation instructions (layout sections 7-8).
+  uint64_t debug_and_annotations = 0;
+  // Types, constants and module-scope variables (layout section 9), plus the
+  // DebugInfo extension instructions interleaved with them.
+  uint64_t types_and_globals = 0;
+  // Hash of each function, keyed by its result id.
+  std::unordered_map<uint32_t, uint64_t> functions;
+  // Hash of the module version and every section above, in layout order.
+  uint64_t combined = 0;
+};
+
 // A SPIR-V module. It contains all the information for a SPIR-V module and
 // serves as the backbone of optimization transformations.
 class Module {
@@ -71,6 +91,13 @@ class Module {
   // TODO(1841): Update the uses to check for a 0 return value.
   uint32_t TakeNextIdBound();
 
+  // Returns the first id of a contiguous block of |count| fresh ids and
+  // increases the Id bound past the block.  Returns 0 if |count| is 0 or the
+  // block would take the Id bound over its maximum.  Reserving a block per
+  // worker thread up front lets the threads mint ids without touching the
+  // shared bound.
+  uint32_t TakeNextIdBoundBlock(uint32_t count);
+
   // Appends a capability instruction to this module.
   inline void AddCapability(std::unique_ptr<Instruction> c);
 
@@ -255,13 +282,36 @@ class Module {
   void ForEachInst(const std::function<void(const Instruction*)>& f,
                    bool run_on_debug_line_insts = false) const;
 
+  // Same as the overloads above, but call |f| directly instead of through a
+  // std::function.  Overload resolution prefers these whenever |f| is a
+  // lambda or another plain functor, which keeps hot traversals free of
+  // type erasure.
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false);
+  template <typename F>
+  void ForEachInst(F&& f, bool run_on_debug_line_insts = false) const;
+
   // Pushes the binary segments for this instruction into the back of *|binary|.
   // If |skip_nop| is true and this is a OpNop, do nothing.
   void ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const;
 
+  // Fills |new_context|'s module, which must be empty, with a deep copy of
+  // this module: the header and every instruction and function are cloned so
+  // that they are owned by |new_context|.  This is much cheaper than
+  // serializing the module and parsing the binary back, and yields the same
+  // result.  Analyses of |new_context| are not built.
+  void CloneInto(IRContext* new_context) const;
+
   // Returns 1 more than the maximum Id value mentioned in the module.
   uint32_t ComputeIdBound() const;
 
+  // Computes per-section content hashes for this module in a single walk of
+  // the IR, without serializing it to a binary.  Callers that cache work per
+  // pipeline stage can compare the sections of two snapshots and redo only
+  // the work for sections - typically individual functions - whose hash
+  // changed.
+  ModuleContentHash ComputeContentHash() const;
+
   // Returns true if module has capability |cap|
   bool HasExplicitCapability(uint32_t cap);
 
@@ -543,6 +593,58 @@ inline Module::const_iterator Module::cend() const {
   return const_iterator(&functions_, functions_.cend());
 }
 
+template <typename F>
+void Module::ForEachInst(F&& f, bool run_on_debug_line_insts) {
+  capabilities_.ForEachInst(f, run_on_debug_line_insts);
+  extensions_.ForEachInst(f, run_on_debug_line_insts);
+  ext_inst_imports_.ForEachInst(f, run_on_debug_line_insts);
+  if (memory_model_) memory_model_->ForEachInst(f, run_on_debug_line_insts);
+  if (sampled_image_address_mode_)
+    sampled_image_address_mode_->ForEachInst(f, run_on_debug_line_insts);
+  entry_points_.ForEachInst(f, run_on_debug_line_insts);
+  execution_modes_.ForEachInst(f, run_on_debug_line_insts);
+  debugs1_.ForEachInst(f, run_on_debug_line_insts);
+  debugs2_.ForEachInst(f, run_on_debug_line_insts);
+  debugs3_.ForEachInst(f, run_on_debug_line_insts);
+  ext_inst_debuginfo_.ForEachInst(f, run_on_debug_line_insts);
+  annotations_.ForEachInst(f, run_on_debug_line_insts);
+  types_values_.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : functions_) {
+    i->ForEachInst(f, run_on_debug_line_insts,
+                   /* run_on_non_semantic_insts = */ true);
+  }
+}
+
+template <typename F>
+void Module::ForEachInst(F&& f, bool run_on_debug_line_insts) const {
+  for (auto& i : capabilities_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : extensions_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : ext_inst_imports_) i.ForEachInst(f, run_on_debug_line_insts);
+  if (memory_model_)
+    static_cast<const Instruction*>(memory_model_.get())
+        ->ForEachInst(f, run_on_debug_line_insts);
+  if (sampled_image_address_mode_)
+    static_cast<const Instruction*>(sampled_image_address_mode_.get())
+        ->ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : entry_points_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : execution_modes_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : debugs1_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : debugs2_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : debugs3_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : annotations_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : types_values_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : ext_inst_debuginfo_) i.ForEachInst(f, run_on_debug_line_insts);
+  for (auto& i : functions_) {
+    static_cast<const Function*>(i.get())->ForEachInst(
+        f, run_on_debug_line_insts,
+        /* run_on_non_semantic_insts = */ true);
+  }
+  if (run_on_debug_line_insts) {
+    for (auto& i : trailing_dbg_line_info_)
+      i.ForEachInst(f, run_on_debug_line_insts);
+  }
+}
+
 }  // namespace opt
 }  // namespace spvtools
 
@@ -0,0 +1,225 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/module_waves.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_set>
+
+#include "source/latest_version_spirv_header.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+constexpr size_t kHeaderWords = 5;
+constexpr size_t kHeaderBoundIndex = 3;
+constexpr size_t kFunctionResultIdIndex = 2;
+
+void Fail(const MessageConsumer& consumer, const std::string& message) {
+  if (consumer != nullptr) {
+    consumer(SPV_MSG_ERROR, "", {0, 0, 0}, message.c_str());
+  }
+}
+
+spv::Op OpcodeAt(const uint32_t* words, size_t offset) {
+  return spv::Op(words[offset] & 0xffff);
+}
+
+size_t WordCountAt(const uint32_t* words, size_t offset) {
+  return words[offset] >> 16;
+}
+
+// Finds the first word offset at or after |offset| holding an OpFunction
+// instruction, or |size| if there is none.  Returns false on a malformed
+// instruction stream.
+bool SkipToNextFunction(const uint32_t* words, size_t size, size_t* offset) {
+  while (*offset < size && OpcodeAt(words, *offset) != spv::Op::OpFunction) {
+    const size_t word_count = WordCountAt(words, *offset);
+    if (word_count == 0 || word_count > size - *offset) return false;
+    *offset += word_count;
+  }
+  return *offset <= size;
+}
+
+// Finds the word offset just past the OpFunctionEnd that closes the function
+// starting at |offset|.  Returns false on a malformed instruction stream.
+bool SkipPastFunctionEnd(const uint32_t* words, size_t size, size_t* offset) {
+  while (*offset < size) {
+    const size_t word_count = WordCountAt(words, *offset);
+    if (word_count == 0 || word_count > size - *offset) return false;
+    const spv::Op opcode = OpcodeAt(words, *offset);
+    *offset += word_count;
+    if (opcode == spv::Op::OpFunctionEnd) return true;
+  }
+  return false;
+}
+
+// Returns true if the function in [begin, end) has a body, i.e. contains at
+// least one basic block.
+bool FunctionHasBody(const uint32_t* words, size_t begin, size_t end) {
+  for (size_t offset = begin; offset < end;
+       offset += WordCountAt(words, offset)) {
+    if (OpcodeAt(words, offset) == spv::Op::OpLabel) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ModuleWaves::Split(const uint32_t* binary, size_t size,
+                        const MessageConsumer& consumer) {
+  if (binary == nullptr || size < kHeaderWords) {
+    Fail(consumer, "Module is too small to hold a SPIR-V header.");
+    return false;
+  }
+  if (spv::MagicNumber != binary[0]) {
+    Fail(consumer,
+         "Invalid SPIR-V magic number; wave splitting requires a module in "
+         "host endianness.");
+    return false;
+  }
+
+  binary_ = binary;
+  size_t offset = kHeaderWords;
+  if (!SkipToNextFunction(binary, size, &offset)) {
+    Fail(consumer, "Malformed instruction stream in module-scope section.");
+    return false;
+  }
+  prefix_.assign(binary, binary + offset);
+
+  while (offset < size) {
+    Range function = {offset, offset};
+    if (!SkipPastFunctionEnd(binary, size, &function.end)) {
+      Fail(consumer, "Function without a matching OpFunctionEnd.");
+      return false;
+    }
+    functions_.push_back(function);
+    offset = function.end;
+    if (!SkipToNextFunction(binary, size, &offset)) {
+      Fail(consumer, "Malformed instruction stream between functions.");
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> ModuleWaves::MakeWaveBinary(size_t first, size_t count) {
+  std::vector<uint32_t> wave = prefix_;
+  window_ids_.clear();
+  for (size_t index = 0; index < functions_.size(); ++index) {
+    const Range& function = functions_[index];
+    if (index >= first && index < first + count) {
+      wave.insert(wave.end(), binary_ + function.begin,
+                  binary_ + function.end);
+      window_ids_.push_back(
+          binary_[function.begin + kFunctionResultIdIndex]);
+      continue;
+    }
+    // Keep only the signature of out-of-window functions so their ids, and
+    // the ids of their parameters, keep resolving.
+    for (size_t offset = function.begin; offset < function.end;
+         offset += WordCountAt(binary_, offset)) {
+      const spv::Op opcode = OpcodeAt(binary_, offset);
+      if (opcode == spv::Op::OpFunction ||
+          opcode == spv::Op::OpFunctionParameter) {
+        wave.insert(wave.end(), binary_ + offset,
+                    binary_ + offset + WordCountAt(binary_, offset));
+      }
+    }
+    wave.push_back((1u << 16) | uint32_t(spv::Op::OpFunctionEnd));
+  }
+  return wave;
+}
+
+bool ModuleWaves::AcceptWaveBinary(const std::vector<uint32_t>& wave,
+                                   const MessageConsumer& consumer) {
+  const uint32_t* words = wave.data();
+  const size_t size = wave.size();
+  if (size < kHeaderWords) {
+    Fail(consumer, "Optimized wave is too small to hold a SPIR-V header.");
+    return false;
+  }
+  size_t offset = kHeaderWords;
+  if (!SkipToNextFunction(words, size, &offset)) {
+    Fail(consumer, "Malformed module-scope section in optimized wave.");
+    return false;
+  }
+
+  // Check that every pinned module-scope instruction survived the wave.
+  // Instructions may move and new ones may appear, so compare multisets.
+  std::map<std::vector<uint32_t>, size_t> new_instructions;
+  for (size_t at = kHeaderWords; at < offset;
+       at += WordCountAt(words, at)) {
+    ++new_instructions[{words + at, words + at + WordCountAt(words, at)}];
+  }
+  for (size_t at = kHeaderWords; at < prefix_.size();
+       at += WordCountAt(prefix_.data(), at)) {
+    const std::vector<uint32_t> instruction(
+        prefix_.begin() + at,
+        prefix_.begin() + at + WordCountAt(prefix_.data(), at));
+    auto iter = new_instructions.find(instruction);
+    if (iter == new_instructions.end() || iter->second == 0) {
+      Fail(consumer,
+           "A pass removed a pinned module-scope instruction; the registered "
+           "passes cannot be used with waves.");
+      return false;
+    }
+    --iter->second;
+  }
+  prefix_.assign(words, words + offset);
+
+  // Collect the optimized bodies and check that no window function was
+  // removed; other waves may still call it.
+  std::unordered_set<uint32_t> bodies_seen;
+  while (offset < size) {
+    Range function = {offset, offset};
+    if (!SkipPastFunctionEnd(words, size, &function.end)) {
+      Fail(consumer, "Malformed function in optimized wave.");
+      return false;
+    }
+    if (FunctionHasBody(words, function.begin, function.end)) {
+      optimized_functions_.insert(optimized_functions_.end(),
+                                  words + function.begin,
+                                  words + function.end);
+      bodies_seen.insert(words[function.begin + kFunctionResultIdIndex]);
+    }
+    offset = function.end;
+    if (!SkipToNextFunction(words, size, &offset)) {
+      Fail(consumer, "Malformed instruction stream in optimized wave.");
+      return false;
+    }
+  }
+  for (const uint32_t id : window_ids_) {
+    if (bodies_seen.count(id) == 0) {
+      Fail(consumer,
+           "A pass removed function " + std::to_string(id) +
+               "; the registered passes cannot be used with waves.");
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> ModuleWaves::Finish() const {
+  std::vector<uint32_t> binary = prefix_;
+  binary.insert(binary.end(), optimized_functions_.begin(),
+                optimized_functions_.end());
+  return binary;
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_MODULE_WAVES_H_
+#define SOURCE_OPT_MODULE_WAVES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace opt {
+
+// Splits a SPIR-V binary into its module-scope section and per-function word
+// ranges without building any IR, so that the functions can be optimized in
+// bounded-memory waves: each wave module holds the module-scope section, the
+// full bodies of a window of functions, and body-less declarations for every
+// other function so all ids keep resolving.  Optimized waves are folded back
+// in order and stitched into the final binary.
+//
+// Module-scope instructions are pinned: a wave may add to the module-scope
+// section (additions are carried into the following waves and into the final
+// binary), but removing an instruction from it, or removing a function in
+// the window, is rejected, since other waves may depend on it.  Pipelines
+// used with waves must therefore not strip unreferenced module-scope
+// instructions or dead functions.
+class ModuleWaves {
+ public:
+  // Scans |binary| with |size| words and records the module-scope section
+  // and the range of every function.  The binary must be in host endianness.
+  // On failure, sends a message to |consumer| and returns false.
+  bool Split(const uint32_t* binary, size_t size,
+             const MessageConsumer& consumer);
+
+  // Returns the number of functions found by Split().
+  size_t function_count() const { return functions_.size(); }
+
+  // Returns a standalone module holding the current module-scope section,
+  // the full bodies of functions [first, first + count), and body-less
+  // declarations for every other function.
+  std::vector<uint32_t> MakeWaveBinary(size_t first, size_t count);
+
+  // Folds the optimized |wave| back in.  Its module-scope section replaces
+  // the current one after checking that every pinned instruction is still
+  // present, and its function bodies are collected for Finish().  Every
+  // function of the last MakeWaveBinary() window must still have a body.
+  // On failure, sends a message to |consumer| and returns false.
+  bool AcceptWaveBinary(const std::vector<uint32_t>& wave,
+                        const MessageConsumer& consumer);
+
+  // Returns the stitched module: the final module-scope section followed by
+  // every collected function body, in the original function order.
+  std::vector<uint32_t> Finish() const;
+
+ private:
+  // A range of words [begin, end) in the binary given to Split().
+  struct Range {
+    size_t begin;
+    size_t end;
+  };
+
+  const uint32_t* binary_ = nullptr;
+
+  // The current module-scope words, including the header.  Starts as the
+  // scanned section and is replaced by each accepted wave's section.
+  std::vector<uint32_t> prefix_;
+
+  // The range of each function in |binary_|, in module order.
+  std::vector<Range> functions_;
+
+  // The result ids of the functions in the last MakeWaveBinary() window.
+  std::vector<uint32_t> window_ids_;
+
+  // The optimized function bodies accepted so far, concatenated in order.
+  std::vector<uint32_t> optimized_functions_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_MODULE_WAVES_H_
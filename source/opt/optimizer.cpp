@@ -14,13 +14,20 @@
 
 #include "spirv-tools/optimizer.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "source/latest_version_spirv_header.h"
 #include "source/opt/build_module.h"
 #include "source/opt/graphics_robust_access_pass.h"
 #include "source/opt/log.h"
@@ -29,6 +36,7 @@
 #include "source/spirv_optimizer_options.h"
 #include "source/util/make_unique.h"
 #include "source/util/string_utils.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 
@@ -61,6 +69,17 @@ struct Optimizer::Impl {
   spv_target_env target_env;      // Target environment.
   opt::PassManager pass_manager;  // Internal implementation pass manager.
   std::unordered_set<uint32_t> live_locs;  // Arg to debug dead output passes
+  // When true, Run() registers a performance pipeline fitted to each module
+  // instead of running the passes registered up front.
+  bool adaptive_performance = false;
+  // When non-empty, Run() reduces the module to the code reachable from
+  // these entry points before running the registered passes.
+  std::vector<std::string> entry_point_names;
+  // When non-empty, Run() caches optimized binaries in this directory.
+  std::string cache_directory;
+  // When non-null, Run() writes a module summary of the optimized binary
+  // here on success.
+  std::vector<uint32_t>* module_summary = nullptr;
 };
 
 Optimizer::Optimizer(spv_target_env env) : impl_(new Impl(env)) {
@@ -207,6 +226,76 @@ Optimizer& Optimizer::RegisterPerformancePasses() {
       .RegisterPass(CreateSimplificationPass());
 }
 
+Optimizer& Optimizer::RegisterAdaptivePerformancePasses() {
+  impl_->adaptive_performance = true;
+  // Both pipelines repeat arg-less passes under their flag names only, so
+  // provably no-op re-runs can be skipped safely.
+  impl_->pass_manager.SetSkipRedundantReruns(true);
+  return *this;
+}
+
+void Optimizer::RegisterAdaptivePassesForModule(opt::IRContext* context) {
+  // A cheap fingerprint of the module: how big the function bodies are and
+  // whether there is anything for the loop and call related passes to do.
+  bool has_loops = false;
+  bool has_calls = false;
+  uint32_t function_inst_count = 0;
+  for (opt::Function& func : *context->module()) {
+    func.ForEachInst([&has_loops, &has_calls,
+                      &function_inst_count](opt::Instruction* inst) {
+      ++function_inst_count;
+      if (inst->opcode() == spv::Op::OpLoopMerge) {
+        has_loops = true;
+      } else if (inst->opcode() == spv::Op::OpFunctionCall) {
+        has_calls = true;
+      }
+    });
+  }
+
+  // Modules with loops, or with enough code that pass ordering interactions
+  // matter, get the full tuned pipeline.
+  constexpr uint32_t kSmallModuleInstCount = 1024;
+  if (has_loops || function_inst_count > kSmallModuleInstCount) {
+    RegisterPerformancePasses();
+    return;
+  }
+
+  // Small straight-line modules: drop the loop passes and the repeated
+  // clean-up rounds that exist to expose loop and inlining opportunities.
+  // Call related passes are only worth their analysis rebuilds when there
+  // are calls to inline.
+  if (has_calls) {
+    RegisterPass(CreateWrapOpKillPass())
+        .RegisterPass(CreateDeadBranchElimPass())
+        .RegisterPass(CreateMergeReturnPass())
+        .RegisterPass(CreateInlineExhaustivePass())
+        .RegisterPass(CreateEliminateDeadFunctionsPass())
+        .RegisterPass(CreatePrivateToLocalPass());
+  } else {
+    RegisterPass(CreateDeadBranchElimPass());
+  }
+  RegisterPass(CreateAggressiveDCEPass())
+      .RegisterPass(CreateLocalSingleBlockLoadStoreElimPass())
+      .RegisterPass(CreateLocalSingleStoreElimPass())
+      .RegisterPass(CreateScalarReplacementPass())
+      .RegisterPass(CreateLocalAccessChainConvertPass())
+      .RegisterPass(CreateLocalMultiStoreElimPass())
+      .RegisterPass(CreateCCPPass())
+      .RegisterPass(CreateAggressiveDCEPass())
+      .RegisterPass(CreateRedundancyEliminationPass())
+      .RegisterPass(CreateCombineAccessChainsPass())
+      .RegisterPass(CreateSimplificationPass())
+      .RegisterPass(CreateSSARewritePass())
+      .RegisterPass(CreateVectorDCEPass())
+      .RegisterPass(CreateDeadInsertElimPass())
+      .RegisterPass(CreateIfConversionPass())
+      .RegisterPass(CreateCopyPropagateArraysPass())
+      .RegisterPass(CreateReduceLoadSizePass())
+      .RegisterPass(CreateAggressiveDCEPass())
+      .RegisterPass(CreateBlockMergePass())
+      .RegisterPass(CreateSimplificationPass());
+}
+
 Optimizer& Optimizer::RegisterSizePasses() {
   return RegisterPass(CreateWrapOpKillPass())
       .RegisterPass(CreateDeadBranchElimPass())
@@ -236,6 +325,7 @@ Optimizer& Optimizer::RegisterSizePasses() {
       .RegisterPass(CreateEliminateDeadMembersPass())
       .RegisterPass(CreateLocalSingleStoreElimPass())
       .RegisterPass(CreateBlockMergePass())
+      .RegisterPass(CreateTailMergePass())
       .RegisterPass(CreateLocalMultiStoreElimPass())
       .RegisterPass(CreateRedundancyEliminationPass())
       .RegisterPass(CreateSimplificationPass())
@@ -243,6 +333,133 @@ Optimizer& Optimizer::RegisterSizePasses() {
       .RegisterPass(CreateCFGCleanupPass());
 }
 
+namespace {
+
+// Factory for a pass whose flag takes no arguments.
+using NoArgPassFactory = Optimizer::PassToken (*)();
+
+// Returns the registry mapping each argument-free pass flag to its factory.
+// The table is built once per process, so registering such a flag is a
+// single hash lookup instead of a walk down a comparison chain.  Flags whose
+// passes take arguments, or that expand to several passes, keep their
+// explicit handling in RegisterPassFromFlag().
+const std::unordered_map<std::string, NoArgPassFactory>&
+GetNoArgPassFactories() {
+  static const auto* factories =
+      new std::unordered_map<std::string, NoArgPassFactory>({
+          {"strip-debug", [] { return CreateStripDebugInfoPass(); }},
+          {"strip-reflect", [] { return CreateStripReflectInfoPass(); }},
+          {"strip-nonsemantic",
+           [] { return CreateStripNonSemanticInfoPass(); }},
+          {"if-conversion", [] { return CreateIfConversionPass(); }},
+          {"freeze-spec-const",
+           [] { return CreateFreezeSpecConstantValuePass(); }},
+          {"inline-entry-points-exhaustive",
+           [] { return CreateInlineExhaustivePass(); }},
+          {"inline-entry-points-opaque",
+           [] { return CreateInlineOpaquePass(); }},
+          {"combine-access-chains",
+           [] { return CreateCombineAccessChainsPass(); }},
+          {"convert-local-access-chains",
+           [] { return CreateLocalAccessChainConvertPass(); }},
+          {"replace-desc-array-access-using-var-index",
+           [] { return CreateReplaceDescArrayAccessUsingVarIndexPass(); }},
+          {"spread-volatile-semantics",
+           [] { return CreateSpreadVolatileSemanticsPass(); }},
+          {"descriptor-scalar-replacement",
+           [] { return CreateDescriptorScalarReplacementPass(); }},
+          {"eliminate-dead-code-aggressive",
+           [] { return CreateAggressiveDCEPass(); }},
+          {"combined-dce", [] { return CreateCombinedDcePass(); }},
+          {"eliminate-insert-extract",
+           [] { return CreateInsertExtractElimPass(); }},
+          {"eliminate-local-single-block",
+           [] { return CreateLocalSingleBlockLoadStoreElimPass(); }},
+          {"eliminate-local-single-store",
+           [] { return CreateLocalSingleStoreElimPass(); }},
+          {"merge-blocks", [] { return CreateBlockMergePass(); }},
+          {"block-layout", [] { return CreateBlockLayoutPass(); }},
+          {"merge-return", [] { return CreateMergeReturnPass(); }},
+          {"tail-merge", [] { return CreateTailMergePass(); }},
+          {"eliminate-dead-branches",
+           [] { return CreateDeadBranchElimPass(); }},
+          {"eliminate-dead-functions",
+           [] { return CreateEliminateDeadFunctionsPass(); }},
+          {"eliminate-local-multi-store",
+           [] { return CreateLocalMultiStoreElimPass(); }},
+          {"eliminate-dead-const",
+           [] { return CreateEliminateDeadConstantPass(); }},
+          {"eliminate-dead-inserts",
+           [] { return CreateDeadInsertElimPass(); }},
+          {"eliminate-dead-variables",
+           [] { return CreateDeadVariableEliminationPass(); }},
+          {"eliminate-dead-members",
+           [] { return CreateEliminateDeadMembersPass(); }},
+          {"fold-spec-const-op-composite",
+           [] { return CreateFoldSpecConstantOpAndCompositePass(); }},
+          {"loop-unswitch", [] { return CreateLoopUnswitchPass(); }},
+          {"strength-reduction",
+           [] { return CreateStrengthReductionPass(); }},
+          {"unify-const", [] { return CreateUnifyConstantPass(); }},
+          {"flatten-decorations",
+           [] { return CreateFlattenDecorationPass(); }},
+          {"compact-ids", [] { return CreateCompactIdsPass(); }},
+          {"cfg-cleanup", [] { return CreateCFGCleanupPass(); }},
+          {"local-redundancy-elimination",
+           [] { return CreateLocalRedundancyEliminationPass(); }},
+          {"loop-invariant-code-motion",
+           [] { return CreateLoopInvariantCodeMotionPass(); }},
+          {"redundancy-elimination",
+           [] { return CreateRedundancyEliminationPass(); }},
+          {"private-to-local", [] { return CreatePrivateToLocalPass(); }},
+          {"remove-duplicates", [] { return CreateRemoveDuplicatesPass(); }},
+          {"workaround-1209", [] { return CreateWorkaround1209Pass(); }},
+          {"replace-invalid-opcode",
+           [] { return CreateReplaceInvalidOpcodePass(); }},
+          {"convert-relaxed-to-half",
+           [] { return CreateConvertRelaxedToHalfPass(); }},
+          {"relax-float-ops", [] { return CreateRelaxFloatOpsPass(); }},
+          {"inst-debug-printf",
+           [] { return CreateInstDebugPrintfPass(7, 23); }},
+          {"simplify-instructions",
+           [] { return CreateSimplificationPass(); }},
+          {"fused-peephole", [] { return CreateFusedPeepholePass(); }},
+          {"ssa-rewrite", [] { return CreateSSARewritePass(); }},
+          {"copy-propagate-arrays",
+           [] { return CreateCopyPropagateArraysPass(); }},
+          {"loop-unroll", [] { return CreateLoopUnrollPass(true); }},
+          {"upgrade-memory-model",
+           [] { return CreateUpgradeMemoryModelPass(); }},
+          {"vector-dce", [] { return CreateVectorDCEPass(); }},
+          {"loop-peeling", [] { return CreateLoopPeelingPass(); }},
+          {"ccp", [] { return CreateCCPPass(); }},
+          {"ip-constant-prop", [] { return CreateIPConstantPropPass(); }},
+          {"code-sink", [] { return CreateCodeSinkingPass(); }},
+          {"pressure-scheduling",
+           [] { return CreatePressureSchedulingPass(); }},
+          {"embed-analysis-metadata",
+           [] { return CreateEmbedAnalysisMetadataPass(); }},
+          {"fix-storage-class", [] { return CreateFixStorageClassPass(); }},
+          {"remove-unused-interface-variables",
+           [] { return CreateRemoveUnusedInterfaceVariablesPass(); }},
+          {"graphics-robust-access",
+           [] { return CreateGraphicsRobustAccessPass(); }},
+          {"wrap-opkill", [] { return CreateWrapOpKillPass(); }},
+          {"amd-ext-to-khr", [] { return CreateAmdExtToKhrPass(); }},
+          {"interpolate-fixup",
+           [] { return CreateInterpolateFixupPass(); }},
+          {"remove-dont-inline",
+           [] { return CreateRemoveDontInlinePass(); }},
+          {"eliminate-dead-input-components",
+           [] { return CreateEliminateDeadInputComponentsSafePass(); }},
+          {"fix-func-call-param",
+           [] { return CreateFixFuncCallArgumentsPass(); }},
+      });
+  return *factories;
+}
+
+}  // namespace
+
 bool Optimizer::RegisterPassesFromFlags(const std::vector<std::string>& flags) {
   for (const auto& flag : flags) {
     if (!RegisterPassFromFlag(flag)) {
@@ -278,20 +495,20 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
   std::string pass_name = p.first;
   std::string pass_args = p.second;
 
-  // FIXME(dnovillo): This should be re-factored so that pass names can be
-  // automatically checked against Pass::name() and PassToken instances created
-  // via a template function.  Additionally, class Pass should have a desc()
-  // method that describes the pass (so it can be used in --help).
-  //
-  // Both Pass::name() and Pass::desc() should be static class members so they
-  // can be invoked without creating a pass instance.
-  if (pass_name == "strip-debug") {
-    RegisterPass(CreateStripDebugInfoPass());
-  } else if (pass_name == "strip-reflect") {
-    RegisterPass(CreateStripReflectInfoPass());
-  } else if (pass_name == "strip-nonsemantic") {
-    RegisterPass(CreateStripNonSemanticInfoPass());
-  } else if (pass_name == "set-spec-const-default-value") {
+  // Argument-free passes are looked up in the precompiled registry; only the
+  // flags below carry arguments or expand to several passes.
+  const auto& factories = GetNoArgPassFactories();
+  const auto factory = factories.find(pass_name);
+  if (factory != factories.end()) {
+    RegisterPass(factory->second());
+    return true;
+  }
+
+  // FIXME(dnovillo): Class Pass should have a desc() method that describes
+  // the pass (so it can be used in --help).  Both Pass::name() and
+  // Pass::desc() should be static class members so they can be invoked
+  // without creating a pass instance.
+  if (pass_name == "set-spec-const-default-value") {
     if (pass_args.size() > 0) {
       auto spec_ids_vals =
           opt::SetSpecConstantDefaultValuePass::ParseDefaultValuesString(
@@ -311,54 +528,6 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
              pass_args.c_str());
       return false;
     }
-  } else if (pass_name == "if-conversion") {
-    RegisterPass(CreateIfConversionPass());
-  } else if (pass_name == "freeze-spec-const") {
-    RegisterPass(CreateFreezeSpecConstantValuePass());
-  } else if (pass_name == "inline-entry-points-exhaustive") {
-    RegisterPass(CreateInlineExhaustivePass());
-  } else if (pass_name == "inline-entry-points-opaque") {
-    RegisterPass(CreateInlineOpaquePass());
-  } else if (pass_name == "combine-access-chains") {
-    RegisterPass(CreateCombineAccessChainsPass());
-  } else if (pass_name == "convert-local-access-chains") {
-    RegisterPass(CreateLocalAccessChainConvertPass());
-  } else if (pass_name == "replace-desc-array-access-using-var-index") {
-    RegisterPass(CreateReplaceDescArrayAccessUsingVarIndexPass());
-  } else if (pass_name == "spread-volatile-semantics") {
-    RegisterPass(CreateSpreadVolatileSemanticsPass());
-  } else if (pass_name == "descriptor-scalar-replacement") {
-    RegisterPass(CreateDescriptorScalarReplacementPass());
-  } else if (pass_name == "eliminate-dead-code-aggressive") {
-    RegisterPass(CreateAggressiveDCEPass());
-  } else if (pass_name == "eliminate-insert-extract") {
-    RegisterPass(CreateInsertExtractElimPass());
-  } else if (pass_name == "eliminate-local-single-block") {
-    RegisterPass(CreateLocalSingleBlockLoadStoreElimPass());
-  } else if (pass_name == "eliminate-local-single-store") {
-    RegisterPass(CreateLocalSingleStoreElimPass());
-  } else if (pass_name == "merge-blocks") {
-    RegisterPass(CreateBlockMergePass());
-  } else if (pass_name == "merge-return") {
-    RegisterPass(CreateMergeReturnPass());
-  } else if (pass_name == "eliminate-dead-branches") {
-    RegisterPass(CreateDeadBranchElimPass());
-  } else if (pass_name == "eliminate-dead-functions") {
-    RegisterPass(CreateEliminateDeadFunctionsPass());
-  } else if (pass_name == "eliminate-local-multi-store") {
-    RegisterPass(CreateLocalMultiStoreElimPass());
-  } else if (pass_name == "eliminate-dead-const") {
-    RegisterPass(CreateEliminateDeadConstantPass());
-  } else if (pass_name == "eliminate-dead-inserts") {
-    RegisterPass(CreateDeadInsertElimPass());
-  } else if (pass_name == "eliminate-dead-variables") {
-    RegisterPass(CreateDeadVariableEliminationPass());
-  } else if (pass_name == "eliminate-dead-members") {
-    RegisterPass(CreateEliminateDeadMembersPass());
-  } else if (pass_name == "fold-spec-const-op-composite") {
-    RegisterPass(CreateFoldSpecConstantOpAndCompositePass());
-  } else if (pass_name == "loop-unswitch") {
-    RegisterPass(CreateLoopUnswitchPass());
   } else if (pass_name == "scalar-replacement") {
     if (pass_args.size() == 0) {
       RegisterPass(CreateScalarReplacementPass());
@@ -377,20 +546,24 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
         return false;
       }
     }
-  } else if (pass_name == "strength-reduction") {
-    RegisterPass(CreateStrengthReductionPass());
-  } else if (pass_name == "unify-const") {
-    RegisterPass(CreateUnifyConstantPass());
-  } else if (pass_name == "flatten-decorations") {
-    RegisterPass(CreateFlattenDecorationPass());
-  } else if (pass_name == "compact-ids") {
-    RegisterPass(CreateCompactIdsPass());
-  } else if (pass_name == "cfg-cleanup") {
-    RegisterPass(CreateCFGCleanupPass());
-  } else if (pass_name == "local-redundancy-elimination") {
-    RegisterPass(CreateLocalRedundancyEliminationPass());
-  } else if (pass_name == "loop-invariant-code-motion") {
-    RegisterPass(CreateLoopInvariantCodeMotionPass());
+  } else if (pass_name == "inline-heuristic") {
+    if (pass_args.size() == 0) {
+      RegisterPass(CreateInlineHeuristicPass());
+    } else {
+      int budget = -1;
+      if (pass_args.find_first_not_of("0123456789") == std::string::npos) {
+        budget = atoi(pass_args.c_str());
+      }
+
+      if (budget >= 0) {
+        RegisterPass(CreateInlineHeuristicPass(budget));
+      } else {
+        Error(consumer(), nullptr, {},
+              "--inline-heuristic must have no arguments or a non-negative "
+              "integer argument");
+        return false;
+      }
+    }
   } else if (pass_name == "reduce-load-size") {
     if (pass_args.size() == 0) {
       RegisterPass(CreateReduceLoadSizePass());
@@ -409,16 +582,6 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
         return false;
       }
     }
-  } else if (pass_name == "redundancy-elimination") {
-    RegisterPass(CreateRedundancyEliminationPass());
-  } else if (pass_name == "private-to-local") {
-    RegisterPass(CreatePrivateToLocalPass());
-  } else if (pass_name == "remove-duplicates") {
-    RegisterPass(CreateRemoveDuplicatesPass());
-  } else if (pass_name == "workaround-1209") {
-    RegisterPass(CreateWorkaround1209Pass());
-  } else if (pass_name == "replace-invalid-opcode") {
-    RegisterPass(CreateReplaceInvalidOpcodePass());
   } else if (pass_name == "inst-bindless-check") {
     RegisterPass(CreateInstBindlessCheckPass(7, 23, false, false));
     RegisterPass(CreateSimplificationPass());
@@ -440,18 +603,6 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
   } else if (pass_name == "inst-buff-addr-check") {
     RegisterPass(CreateInstBuffAddrCheckPass(7, 23));
     RegisterPass(CreateAggressiveDCEPass(true));
-  } else if (pass_name == "convert-relaxed-to-half") {
-    RegisterPass(CreateConvertRelaxedToHalfPass());
-  } else if (pass_name == "relax-float-ops") {
-    RegisterPass(CreateRelaxFloatOpsPass());
-  } else if (pass_name == "inst-debug-printf") {
-    RegisterPass(CreateInstDebugPrintfPass(7, 23));
-  } else if (pass_name == "simplify-instructions") {
-    RegisterPass(CreateSimplificationPass());
-  } else if (pass_name == "ssa-rewrite") {
-    RegisterPass(CreateSSARewritePass());
-  } else if (pass_name == "copy-propagate-arrays") {
-    RegisterPass(CreateCopyPropagateArraysPass());
   } else if (pass_name == "loop-fission") {
     int register_threshold_to_split =
         (pass_args.size() > 0) ? atoi(pass_args.c_str()) : -1;
@@ -474,12 +625,6 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
             "--loop-fusion must have a positive integer argument");
       return false;
     }
-  } else if (pass_name == "loop-unroll") {
-    RegisterPass(CreateLoopUnrollPass(true));
-  } else if (pass_name == "upgrade-memory-model") {
-    RegisterPass(CreateUpgradeMemoryModelPass());
-  } else if (pass_name == "vector-dce") {
-    RegisterPass(CreateVectorDCEPass());
   } else if (pass_name == "loop-unroll-partial") {
     int factor = (pass_args.size() > 0) ? atoi(pass_args.c_str()) : 0;
     if (factor > 0) {
@@ -489,8 +634,6 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
             "--loop-unroll-partial must have a positive integer argument");
       return false;
     }
-  } else if (pass_name == "loop-peeling") {
-    RegisterPass(CreateLoopPeelingPass());
   } else if (pass_name == "loop-peeling-threshold") {
     int factor = (pass_args.size() > 0) ? atoi(pass_args.c_str()) : 0;
     if (factor > 0) {
@@ -500,34 +643,12 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
             "--loop-peeling-threshold must have a positive integer argument");
       return false;
     }
-  } else if (pass_name == "ccp") {
-    RegisterPass(CreateCCPPass());
-  } else if (pass_name == "code-sink") {
-    RegisterPass(CreateCodeSinkingPass());
-  } else if (pass_name == "fix-storage-class") {
-    RegisterPass(CreateFixStorageClassPass());
   } else if (pass_name == "O") {
     RegisterPerformancePasses();
   } else if (pass_name == "Os") {
     RegisterSizePasses();
   } else if (pass_name == "legalize-hlsl") {
     RegisterLegalizationPasses();
-  } else if (pass_name == "remove-unused-interface-variables") {
-    RegisterPass(CreateRemoveUnusedInterfaceVariablesPass());
-  } else if (pass_name == "graphics-robust-access") {
-    RegisterPass(CreateGraphicsRobustAccessPass());
-  } else if (pass_name == "wrap-opkill") {
-    RegisterPass(CreateWrapOpKillPass());
-  } else if (pass_name == "amd-ext-to-khr") {
-    RegisterPass(CreateAmdExtToKhrPass());
-  } else if (pass_name == "interpolate-fixup") {
-    RegisterPass(CreateInterpolateFixupPass());
-  } else if (pass_name == "remove-dont-inline") {
-    RegisterPass(CreateRemoveDontInlinePass());
-  } else if (pass_name == "eliminate-dead-input-components") {
-    RegisterPass(CreateEliminateDeadInputComponentsSafePass());
-  } else if (pass_name == "fix-func-call-param") {
-    RegisterPass(CreateFixFuncCallArgumentsPass());
   } else if (pass_name == "convert-to-sampled-image") {
     if (pass_args.size() > 0) {
       auto descriptor_set_binding_pairs =
@@ -558,10 +679,241 @@ bool Optimizer::RegisterPassFromFlag(const std::string& flag) {
   return true;
 }
 
+bool PassPipeline::Parse(const std::vector<std::string>& flags,
+                         MessageConsumer consumer) {
+  flags_.clear();
+  // Registering onto a scratch optimizer performs the full name lookup and
+  // argument validation; the target environment does not influence flag
+  // parsing.
+  Optimizer scratch(SPV_ENV_UNIVERSAL_1_0);
+  scratch.SetMessageConsumer(std::move(consumer));
+  if (!scratch.RegisterPassesFromFlags(flags)) {
+    return false;
+  }
+  flags_ = flags;
+  return true;
+}
+
+void PassPipeline::RegisterTo(Optimizer* optimizer) const {
+  for (const auto& flag : flags_) {
+    // Cannot fail: Parse() already validated every flag.
+    optimizer->RegisterPassFromFlag(flag);
+  }
+}
+
 void Optimizer::SetTargetEnv(const spv_target_env env) {
   impl_->target_env = env;
 }
 
+Optimizer& Optimizer::RestrictToEntryPoints(
+    std::vector<std::string> entry_point_names) {
+  impl_->entry_point_names = std::move(entry_point_names);
+  return *this;
+}
+
+namespace {
+// Indices of operands in OpEntryPoint and OpExecutionMode instructions.
+constexpr uint32_t kEntryPointFunctionIdInIdx = 1;
+constexpr uint32_t kEntryPointNameInIdx = 2;
+constexpr uint32_t kExecutionModeEntryPointIdInIdx = 0;
+
+// Removes every entry point not named in |entry_point_names|, along with its
+// execution modes, then eliminates the functions that are no longer
+// reachable.  |modified| is set when the module changed.  Returns false if a
+// requested name does not match any OpEntryPoint in the module.
+bool RestrictModuleToEntryPoints(
+    opt::IRContext* context, const std::vector<std::string>& entry_point_names,
+    const MessageConsumer& consumer, bool* modified) {
+  const std::unordered_set<std::string> requested(entry_point_names.begin(),
+                                                  entry_point_names.end());
+  std::unordered_set<std::string> found;
+  std::unordered_set<uint32_t> retained_function_ids;
+  std::vector<opt::Instruction*> to_kill;
+
+  for (opt::Instruction& entry : context->module()->entry_points()) {
+    const std::string name =
+        entry.GetInOperand(kEntryPointNameInIdx).AsString();
+    if (requested.count(name) != 0) {
+      found.insert(name);
+      retained_function_ids.insert(
+          entry.GetSingleWordInOperand(kEntryPointFunctionIdInIdx));
+    } else {
+      to_kill.push_back(&entry);
+    }
+  }
+
+  if (found.size() != requested.size()) {
+    for (const std::string& name : entry_point_names) {
+      if (found.count(name) == 0) {
+        const std::string message = "no entry point named '" + name + "'";
+        consumer(SPV_MSG_ERROR, "", {0, 0, 0}, message.c_str());
+      }
+    }
+    return false;
+  }
+
+  // Execution modes of a removed entry point would reference a function that
+  // is about to disappear; drop them unless the function is also retained
+  // under one of the requested names.
+  for (opt::Instruction& mode : context->module()->execution_modes()) {
+    if (retained_function_ids.count(mode.GetSingleWordInOperand(
+            kExecutionModeEntryPointIdInIdx)) == 0) {
+      to_kill.push_back(&mode);
+    }
+  }
+
+  for (opt::Instruction* inst : to_kill) {
+    context->KillInst(inst);
+  }
+  *modified |= !to_kill.empty();
+
+  // With the other entry points gone, the functions only they reached are
+  // dead; eliminate them so the registered passes only process the requested
+  // slice.
+  opt::EliminateDeadFunctionsPass eliminate_dead_functions;
+  eliminate_dead_functions.SetMessageConsumer(consumer);
+  const opt::Pass::Status status = eliminate_dead_functions.Run(context);
+  *modified |= status == opt::Pass::Status::SuccessWithChange;
+  return status != opt::Pass::Status::Failure;
+}
+
+// Accumulates |num_bytes| bytes at |data| into the FNV-1a hash |hash|.
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+uint64_t Fnv1a64(const void* data, size_t num_bytes, uint64_t hash) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < num_bytes; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Accumulates |str| and a terminator into |hash|, so "ab" + "c" and
+// "a" + "bc" hash differently.
+uint64_t HashString(const std::string& str, uint64_t hash) {
+  hash = Fnv1a64(str.data(), str.size(), hash);
+  const char terminator = '\0';
+  return Fnv1a64(&terminator, 1, hash);
+}
+
+// Returns the path of the cache entry for |module_hash| and |key_hash| in
+// |directory|.  Entries are stored as plain SPIR-V binaries, so a cache file
+// can be inspected with the regular tools.
+std::string CacheEntryPath(const std::string& directory, uint64_t module_hash,
+                           uint64_t key_hash) {
+  char name[64];
+  snprintf(name, sizeof(name), "/%016" PRIx64 "-%016" PRIx64 ".spv",
+           module_hash, key_hash);
+  return directory + name;
+}
+
+// Reads the binary stored at |path| into |words|.  Returns false if the
+// entry is missing or does not look like a SPIR-V module.
+bool ReadCacheEntry(const std::string& path, std::vector<uint32_t>* words) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return false;
+  const std::streamoff file_size = file.tellg();
+  if (file_size < static_cast<std::streamoff>(5 * sizeof(uint32_t)) ||
+      file_size % sizeof(uint32_t) != 0) {
+    return false;
+  }
+  words->resize(static_cast<size_t>(file_size) / sizeof(uint32_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(words->data()), file_size);
+  return file.good() && (*words)[0] == spv::MagicNumber;
+}
+
+// Stores |words| at |path|.  The data is written to a temporary file in the
+// same directory and renamed into place, so readers never observe a partial
+// entry.  Failures are silently ignored; the cache is best effort.
+void WriteCacheEntry(const std::string& path,
+                     const std::vector<uint32_t>& words) {
+  // The counter disambiguates writers in this process; the counter's address
+  // varies across processes under address space randomization.
+  static std::atomic<uint64_t> temp_counter(0);
+  const uint64_t nonce = temp_counter.fetch_add(1) ^
+                         static_cast<uint64_t>(
+                             reinterpret_cast<uintptr_t>(&temp_counter));
+  const std::string temp_path = path + "." + std::to_string(nonce) + ".tmp";
+
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file) return;
+    file.write(reinterpret_cast<const char*>(words.data()),
+               words.size() * sizeof(uint32_t));
+    if (!file.good()) {
+      file.close();
+      std::remove(temp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    // Another writer already published the same entry: renaming onto an
+    // existing file fails on some platforms.
+    std::remove(temp_path.c_str());
+  }
+}
+
+// Fills |summary| with the module summary of |binary| in the layout
+// documented on Optimizer::SetEmitModuleSummary().  Works from the encoded
+// words rather than an IRContext so result-cache hits, which never parse
+// the module, can be summarized the same way as regular runs.
+void ComputeModuleSummary(const std::vector<uint32_t>& binary,
+                          std::vector<uint32_t>* summary) {
+  summary->clear();
+  if (binary.size() < 5) return;
+
+  uint32_t instruction_count = 0;
+  uint32_t has_debug_info = 0;
+  std::vector<uint32_t> capabilities;
+  std::vector<uint32_t> entry_point_models;
+
+  for (size_t index = 5; index < binary.size();) {
+    const uint32_t num_words = binary[index] >> 16;
+    const auto opcode = static_cast<spv::Op>(binary[index] & 0xffff);
+    if (num_words == 0 || index + num_words > binary.size()) break;
+    ++instruction_count;
+    switch (opcode) {
+      case spv::Op::OpCapability:
+        capabilities.push_back(binary[index + 1]);
+        break;
+      case spv::Op::OpEntryPoint:
+        entry_point_models.push_back(binary[index + 1]);
+        break;
+      case spv::Op::OpLine:
+      case spv::Op::OpNoLine:
+        has_debug_info = 1;
+        break;
+      case spv::Op::OpExtInstImport:
+        if (num_words > 2) {
+          // The import name is a nul-terminated string starting at word 2.
+          const char* name = reinterpret_cast<const char*>(&binary[index + 2]);
+          const size_t max_len = (num_words - 2) * sizeof(uint32_t);
+          if (std::string(name, strnlen(name, max_len)).find("DebugInfo") !=
+              std::string::npos) {
+            has_debug_info = 1;
+          }
+        }
+        break;
+      default:
+        break;
+    }
+    index += num_words;
+  }
+
+  summary->push_back(kModuleSummaryMagic);
+  summary->push_back(kModuleSummaryVersion);
+  summary->push_back(binary[3]);  // Id bound.
+  summary->push_back(instruction_count);
+  summary->push_back(has_debug_info);
+  summary->push_back(static_cast<uint32_t>(capabilities.size()));
+  summary->push_back(static_cast<uint32_t>(entry_point_models.size()));
+  summary->insert(summary->end(), capabilities.begin(), capabilities.end());
+  summary->insert(summary->end(), entry_point_models.begin(),
+                  entry_point_models.end());
+}
+}  // namespace
+
 bool Optimizer::Run(const uint32_t* original_binary,
                     const size_t original_binary_size,
                     std::vector<uint32_t>* optimized_binary) const {
@@ -585,6 +937,48 @@ bool Optimizer::Run(const uint32_t* original_binary,
                     const size_t original_binary_size,
                     std::vector<uint32_t>* optimized_binary,
                     const spv_optimizer_options opt_options) const {
+  std::string cache_entry_path;
+  if (!impl_->cache_directory.empty()) {
+    const uint64_t module_hash =
+        Fnv1a64(original_binary, original_binary_size * sizeof(uint32_t),
+                  kFnvOffsetBasis);
+    // Everything that can change the optimized binary for a given input has
+    // to take part in the key: the pass pipeline, the options applied to the
+    // context below, and the target environment.
+    uint64_t key_hash = kFnvOffsetBasis;
+    key_hash = Fnv1a64(&impl_->target_env, sizeof(impl_->target_env),
+                         key_hash);
+    for (uint32_t i = 0; i < impl_->pass_manager.NumPasses(); ++i) {
+      key_hash = HashString(impl_->pass_manager.GetPass(i)->name(), key_hash);
+    }
+    key_hash = Fnv1a64(&impl_->adaptive_performance,
+                         sizeof(impl_->adaptive_performance), key_hash);
+    for (const std::string& name : impl_->entry_point_names) {
+      key_hash = HashString(name, key_hash);
+    }
+    key_hash = Fnv1a64(&opt_options->run_validator_,
+                         sizeof(opt_options->run_validator_), key_hash);
+    key_hash = Fnv1a64(&opt_options->max_id_bound_,
+                         sizeof(opt_options->max_id_bound_), key_hash);
+    key_hash = Fnv1a64(&opt_options->preserve_bindings_,
+                         sizeof(opt_options->preserve_bindings_), key_hash);
+    key_hash = Fnv1a64(&opt_options->preserve_spec_constants_,
+                         sizeof(opt_options->preserve_spec_constants_),
+                         key_hash);
+
+    cache_entry_path =
+        CacheEntryPath(impl_->cache_directory, module_hash, key_hash);
+    // A hit is the result of an earlier run over the identical input with
+    // the identical configuration, so parsing, validation and the passes are
+    // all skipped.
+    if (ReadCacheEntry(cache_entry_path, optimized_binary)) {
+      if (impl_->module_summary != nullptr) {
+        ComputeModuleSummary(*optimized_binary, impl_->module_summary);
+      }
+      return true;
+    }
+  }
+
   spvtools::SpirvTools tools(impl_->target_env);
   tools.SetMessageConsumer(impl_->pass_manager.consumer());
   if (opt_options->run_validator_ &&
@@ -601,6 +995,23 @@ bool Optimizer::Run(const uint32_t* original_binary,
   context->set_preserve_bindings(opt_options->preserve_bindings_);
   context->set_preserve_spec_constants(opt_options->preserve_spec_constants_);
 
+  // Reduce the module to the requested entry points before anything else, so
+  // the passes (and, below, the adaptive pipeline selection) only see the
+  // slice that is actually being optimized.
+  bool sliced = false;
+  if (!impl_->entry_point_names.empty() &&
+      !RestrictModuleToEntryPoints(context.get(), impl_->entry_point_names,
+                                   consumer(), &sliced)) {
+    return false;
+  }
+
+  if (impl_->adaptive_performance) {
+    // Pipeline selection needs the parsed module, so it has to wait until
+    // here.  Registering passes does not change observable Optimizer state.
+    const_cast<Optimizer*>(this)->RegisterAdaptivePassesForModule(
+        context.get());
+  }
+
   impl_->pass_manager.SetValidatorOptions(&opt_options->val_options_);
   impl_->pass_manager.SetTargetEnv(impl_->target_env);
   auto status = impl_->pass_manager.Run(context.get());
@@ -616,7 +1027,7 @@ bool Optimizer::Run(const uint32_t* original_binary,
   // the debug information through transformations results in integrity
   // check failures. We want to skip the integrity check when the module
   // contains DebugScope or OpLine/OpNoLine instructions.
-  if (status == opt::Pass::Status::SuccessWithoutChange &&
+  if (status == opt::Pass::Status::SuccessWithoutChange && !sliced &&
       !context->module()->ContainsDebugInfo()) {
     std::vector<uint32_t> optimized_binary_with_nop;
     context->module()->ToBinary(&optimized_binary_with_nop,
@@ -642,9 +1053,108 @@ bool Optimizer::Run(const uint32_t* original_binary,
   optimized_binary->clear();
   context->module()->ToBinary(optimized_binary, /* skip_nop = */ true);
 
+  if (!cache_entry_path.empty()) {
+    WriteCacheEntry(cache_entry_path, *optimized_binary);
+  }
+
+  if (impl_->module_summary != nullptr) {
+    ComputeModuleSummary(*optimized_binary, impl_->module_summary);
+  }
+
   return true;
 }
 
+bool OptimizeBatch(spv_target_env env,
+                   const std::vector<std::string>& pass_flags,
+                   const std::vector<std::vector<uint32_t>>& binaries,
+                   std::vector<std::vector<uint32_t>>* optimized_binaries,
+                   MessageConsumer consumer, size_t num_threads) {
+  optimized_binaries->clear();
+  optimized_binaries->resize(binaries.size());
+  if (binaries.empty()) return true;
+
+  if (num_threads == 0) num_threads = utils::ThreadPool::DefaultThreadCount();
+  // Consumers are not required to be thread safe; serialize calls to it.
+  std::mutex consumer_mutex;
+  MessageConsumer locked_consumer;
+  if (consumer) {
+    locked_consumer = [&consumer_mutex, &consumer](
+                          spv_message_level_t level, const char* source,
+                          const spv_position_t& position,
+                          const char* message) {
+      const std::lock_guard<std::mutex> lock(consumer_mutex);
+      consumer(level, source, position, message);
+    };
+  }
+
+  std::atomic<bool> all_succeeded(true);
+  utils::ThreadPool pool(num_threads);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    pool.Schedule([env, &pass_flags, &binaries, optimized_binaries,
+                   &locked_consumer, &all_succeeded, i] {
+      // Pass instances are single use, so each module gets its own pipeline;
+      // the opcode/operand grammar tables are process-wide statics and are
+      // shared read-only by every worker.
+      Optimizer optimizer(env);
+      if (locked_consumer) optimizer.SetMessageConsumer(locked_consumer);
+      if (!optimizer.RegisterPassesFromFlags(pass_flags) ||
+          !optimizer.Run(binaries[i].data(), binaries[i].size(),
+                         &(*optimized_binaries)[i])) {
+        (*optimized_binaries)[i].clear();
+        all_succeeded.store(false, std::memory_order_relaxed);
+      }
+    });
+  }
+  pool.Wait();
+  return all_succeeded.load();
+}
+
+bool OptimizeBatch(spv_target_env env,
+                   const std::vector<std::string>& pass_flags,
+                   const std::vector<CompressedBinary>& binaries,
+                   std::vector<CompressedBinary>* optimized_binaries,
+                   MessageConsumer consumer, size_t num_threads) {
+  optimized_binaries->clear();
+  optimized_binaries->resize(binaries.size());
+  if (binaries.empty()) return true;
+
+  if (num_threads == 0) num_threads = utils::ThreadPool::DefaultThreadCount();
+  std::mutex consumer_mutex;
+  MessageConsumer locked_consumer;
+  if (consumer) {
+    locked_consumer = [&consumer_mutex, &consumer](
+                          spv_message_level_t level, const char* source,
+                          const spv_position_t& position,
+                          const char* message) {
+      const std::lock_guard<std::mutex> lock(consumer_mutex);
+      consumer(level, source, position, message);
+    };
+  }
+
+  std::atomic<bool> all_succeeded(true);
+  utils::ThreadPool pool(num_threads);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    pool.Schedule([env, &pass_flags, &binaries, optimized_binaries,
+                   &locked_consumer, &all_succeeded, i] {
+      // Only this worker's module exists in word form; everything else in
+      // the batch stays compressed.
+      std::vector<uint32_t> words;
+      std::vector<uint32_t> optimized_words;
+      Optimizer optimizer(env);
+      if (locked_consumer) optimizer.SetMessageConsumer(locked_consumer);
+      if (binaries[i].Decompress(&words) &&
+          optimizer.RegisterPassesFromFlags(pass_flags) &&
+          optimizer.Run(words.data(), words.size(), &optimized_words)) {
+        (*optimized_binaries)[i] = CompressedBinary(optimized_words);
+      } else {
+        all_succeeded.store(false, std::memory_order_relaxed);
+      }
+    });
+  }
+  pool.Wait();
+  return all_succeeded.load();
+}
+
 Optimizer& Optimizer::SetPrintAll(std::ostream* out) {
   impl_->pass_manager.SetPrintAll(out);
   return *this;
@@ -655,6 +1165,21 @@ Optimizer& Optimizer::SetTimeReport(std::ostream* out) {
   return *this;
 }
 
+Optimizer& Optimizer::SetPassReportConsumer(PassReportConsumer consumer) {
+  impl_->pass_manager.SetPassReportConsumer(std::move(consumer));
+  return *this;
+}
+
+Optimizer& Optimizer::SetResultCacheDirectory(const std::string& directory) {
+  impl_->cache_directory = directory;
+  return *this;
+}
+
+Optimizer& Optimizer::SetEmitModuleSummary(std::vector<uint32_t>* summary) {
+  impl_->module_summary = summary;
+  return *this;
+}
+
 Optimizer& Optimizer::SetValidateAfterAll(bool validate) {
   impl_->pass_manager.SetValidateAfterAll(validate);
   return *this;
@@ -740,11 +1265,21 @@ Optimizer::PassToken CreateBlockMergePass() {
       MakeUnique<opt::BlockMergePass>());
 }
 
+Optimizer::PassToken CreateBlockLayoutPass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::BlockLayoutPass>());
+}
+
 Optimizer::PassToken CreateInlineExhaustivePass() {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::InlineExhaustivePass>());
 }
 
+Optimizer::PassToken CreateInlineHeuristicPass(uint32_t growth_budget_percent) {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::InlineHeuristicPass>(growth_budget_percent));
+}
+
 Optimizer::PassToken CreateInlineOpaquePass() {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::InlineOpaquePass>());
@@ -801,6 +1336,17 @@ Optimizer::PassToken CreateAggressiveDCEPass(bool preserve_interface,
       MakeUnique<opt::AggressiveDCEPass>(preserve_interface, remove_outputs));
 }
 
+Optimizer::PassToken CreateCombinedDcePass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::CombinedDcePass>(false, false));
+}
+
+Optimizer::PassToken CreateCombinedDcePass(bool preserve_interface,
+                                           bool remove_outputs) {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::CombinedDcePass>(preserve_interface, remove_outputs));
+}
+
 Optimizer::PassToken CreateRemoveUnusedInterfaceVariablesPass() {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::RemoveUnusedInterfaceVariablesPass>());
@@ -848,8 +1394,16 @@ Optimizer::PassToken CreateLoopFissionPass(size_t threshold) {
 }
 
 Optimizer::PassToken CreateLoopFusionPass(size_t max_registers_per_loop) {
+  return CreateLoopFusionPass(max_registers_per_loop, 0, 1);
+}
+
+Optimizer::PassToken CreateLoopFusionPass(size_t max_registers_per_loop,
+                                          size_t max_fused_data_streams,
+                                          size_t min_reused_data_streams) {
   return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopFusionPass>(max_registers_per_loop));
+      MakeUnique<opt::LoopFusionPass>(max_registers_per_loop,
+                                      max_fused_data_streams,
+                                      min_reused_data_streams));
 }
 
 Optimizer::PassToken CreateLoopInvariantCodeMotionPass() {
@@ -890,6 +1444,11 @@ Optimizer::PassToken CreateCCPPass() {
   return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::CCPPass>());
 }
 
+Optimizer::PassToken CreateIPConstantPropPass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::IPConstantPropPass>());
+}
+
 Optimizer::PassToken CreateWorkaround1209Pass() {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::Workaround1209>());
@@ -910,6 +1469,11 @@ Optimizer::PassToken CreateSimplificationPass() {
       MakeUnique<opt::SimplificationPass>());
 }
 
+Optimizer::PassToken CreateFusedPeepholePass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::FusedPeepholePass>());
+}
+
 Optimizer::PassToken CreateLoopUnrollPass(bool fully_unroll, int factor) {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::LoopUnroller>(fully_unroll, factor));
@@ -982,6 +1546,21 @@ Optimizer::PassToken CreateCodeSinkingPass() {
       MakeUnique<opt::CodeSinkingPass>());
 }
 
+Optimizer::PassToken CreatePressureSchedulingPass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::PressureSchedulingPass>());
+}
+
+Optimizer::PassToken CreateTailMergePass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::TailMergePass>());
+}
+
+Optimizer::PassToken CreateEmbedAnalysisMetadataPass() {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<opt::EmbedAnalysisMetadataPass>());
+}
+
 Optimizer::PassToken CreateFixStorageClassPass() {
   return MakeUnique<Optimizer::PassToken::Impl>(
       MakeUnique<opt::FixStorageClass>());
@@ -16,8 +16,11 @@
 
 #include "source/opt/pass.h"
 
+#include <atomic>
+
 #include "source/opt/ir_builder.h"
 #include "source/opt/iterator.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace opt {
@@ -38,13 +41,47 @@ Pass::Status Pass::Run(IRContext* ctx) {
   context_ = nullptr;
 
   if (status == Status::SuccessWithChange) {
-    ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
+    const IRContext::Analysis preserved = GetPreservedAnalyses();
+    // Analyses preserved everywhere except in the functions the pass
+    // reported as modified: keep them module-wide, then drop the
+    // per-function state of each modified function.
+    const IRContext::Analysis scoped = static_cast<IRContext::Analysis>(
+        GetPreservedAnalysesForUnmodifiedFunctions() &
+        IRContext::kPerFunctionAnalyses & ~preserved);
+    ctx->InvalidateAnalysesExceptFor(preserved | scoped);
+    if (scoped != IRContext::kAnalysisNone) {
+      for (const Function* func : modified_functions_) {
+        ctx->InvalidateAnalysesForFunction(func, scoped);
+      }
+    }
   }
   if (!(status == Status::Failure || ctx->IsConsistent()))
     assert(false && "An analysis in the context is out of date.");
   return status;
 }
 
+bool Pass::ProcessFunctionsInParallel(const ProcessFunction& per_function) {
+  Module* module = get_module();
+  if (max_threads() <= 1) {
+    bool modified = false;
+    for (Function& function : *module) {
+      modified |= per_function(&function);
+    }
+    return modified;
+  }
+
+  std::atomic<bool> modified(false);
+  utils::ThreadPool pool(max_threads());
+  for (Function& function : *module) {
+    Function* fn = &function;
+    pool.Schedule([fn, &per_function, &modified] {
+      if (per_function(fn)) modified.store(true, std::memory_order_relaxed);
+    });
+  }
+  pool.Wait();
+  return modified.load(std::memory_order_relaxed);
+}
+
 uint32_t Pass::GetPointeeTypeId(const Instruction* ptrInst) const {
   const uint32_t ptrTypeId = ptrInst->type_id();
   const Instruction* ptrTypeInst = get_def_use_mgr()->GetDef(ptrTypeId);
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "source/opt/def_use_manager.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
+#include "source/util/scratch_arena.h"
 #include "spirv-tools/libspirv.hpp"
 #include "types.h"
 
@@ -38,6 +40,20 @@
 namespace spvtools {
 namespace opt {
 
+// Cheap, conservatively computed properties of a module that gate whether a
+// pass can find anything to act on.  See Pass::RequiredModuleTraits().
+enum ModuleTrait : uint32_t {
+  kTraitNone = 0,
+  // Some branch targets a block at or before the branching block in layout
+  // order.  Every cycle in a CFG contains such an edge, so a module without
+  // this trait provably has no loops; the converse does not hold.
+  kTraitMaybeHasLoops = 1 << 0,
+  // The module contains an OpFunctionCall.
+  kTraitHasFunctionCalls = 1 << 1,
+  // Some function contains an OpVariable.
+  kTraitHasFunctionVariables = 1 << 2,
+};
+
 // Abstract class of a pass. All passes should implement this abstract class
 // and all analysis and transformation is done via the Process() method.
 class Pass {
@@ -113,6 +129,26 @@ class Pass {
     return IRContext::kAnalysisNone;
   }
 
+  // Returns the ModuleTrait bits that must all be present for this pass to
+  // be able to change the module.  The pass manager skips the pass, treating
+  // it as a no-change run, when the module provably lacks one of them.  The
+  // default requires nothing, so the pass always runs.
+  virtual uint32_t RequiredModuleTraits() const { return kTraitNone; }
+
+  // Returns the set of analyses whose per-function state this pass preserves
+  // in every function it did not report through MarkFunctionModified().
+  // Only analyses that keep per-function state can be scoped this way (see
+  // IRContext::kPerFunctionAnalyses); other bits are ignored.  A pass that
+  // overrides this must call MarkFunctionModified() for every function it
+  // changes, including functions it removes (before removing them).  With
+  // SPIRV_CHECK_CONTEXT defined, the consistency check after the pass
+  // cross-validates surviving dominator trees against freshly computed ones,
+  // so declarations can be widened with confidence.  The default preserves
+  // nothing, which leaves the behaviour of GetPreservedAnalyses() unchanged.
+  virtual IRContext::Analysis GetPreservedAnalysesForUnmodifiedFunctions() {
+    return IRContext::kAnalysisNone;
+  }
+
   // Return type id for |ptrInst|'s pointee
   uint32_t GetPointeeTypeId(const Instruction* ptrInst) const;
 
@@ -126,7 +162,52 @@ class Pass {
   // Return the id of OpConstantNull of type |type_id|. Create if necessary.
   uint32_t GetNullId(uint32_t type_id);
 
+  // Sets the maximum number of worker threads this pass may use when fanning
+  // out function-local work with ProcessFunctionsInParallel().  Set by the
+  // pass manager before Run(); a count of 0 or 1 means serial execution.
+  void SetMaxThreads(size_t count) { max_threads_ = count == 0 ? 1 : count; }
+
+  // Returns the maximum number of worker threads this pass may use.
+  size_t max_threads() const { return max_threads_; }
+
+  // Sets the scratch arena this pass should use for transient containers.
+  // Set by the pass manager before Run(); the manager resets the arena
+  // between passes so one set of blocks is reused across the pipeline.
+  void SetScratchArena(utils::ScratchArena* arena) { scratch_arena_ = arena; }
+
+  // Returns the scratch arena for transient, pass-local allocations.  The
+  // storage is reclaimed wholesale after the pass runs, so nothing allocated
+  // from it may outlive Process().  Falls back to a privately owned arena
+  // when the pass runs without a pass manager.
+  utils::ScratchArena* scratch() {
+    if (scratch_arena_ == nullptr) {
+      owned_scratch_arena_ = MakeUnique<utils::ScratchArena>();
+      scratch_arena_ = owned_scratch_arena_.get();
+    }
+    return scratch_arena_;
+  }
+
  protected:
+  // Runs |per_function| over every function in the module, fanning the calls
+  // out across up to max_threads() worker threads.  Returns true if any call
+  // returned true (i.e. the module was modified).
+  //
+  // This is only sound for work that touches strictly function-local state:
+  // |per_function| must not allocate ids, create types or constants, or query
+  // analyses that are built lazily on the context (def-use, decorations,
+  // dominators, ...), since those managers are shared and unsynchronized.
+  // Passes opt in per call site after auditing their analysis usage; with
+  // max_threads() <= 1 the calls run serially on the caller's thread and
+  // behaviour is identical to a plain loop.
+  bool ProcessFunctionsInParallel(const ProcessFunction& per_function);
+
+  // Records that |func| was (or may have been) modified by this pass, so
+  // that Run() drops its per-function analysis state.  Only meaningful for
+  // passes that override GetPreservedAnalysesForUnmodifiedFunctions().
+  void MarkFunctionModified(const Function* func) {
+    modified_functions_.insert(func);
+  }
+
   // Constructs a new pass.
   //
   // The constructed instance will have an empty message consumer, which just
@@ -159,6 +240,18 @@ class Pass {
   // enforce proper resetting of internal state for each instance.  This member
   // is used to check that we do not run the same instance twice.
   bool already_run_;
+
+  // Maximum number of worker threads available to ProcessFunctionsInParallel.
+  size_t max_threads_ = 1;
+
+  // Arena for transient allocations, reset by the pass manager after Run().
+  utils::ScratchArena* scratch_arena_ = nullptr;
+
+  // Backing arena used when no pass manager provided one.
+  std::unique_ptr<utils::ScratchArena> owned_scratch_arena_;
+
+  // The functions reported through MarkFunctionModified().
+  std::unordered_set<const Function*> modified_functions_;
 };
 
 inline Pass::Status CombineStatus(Pass::Status a, Pass::Status b) {
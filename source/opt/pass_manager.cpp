@@ -14,17 +14,79 @@
 
 #include "source/opt/pass_manager.h"
 
+#include <chrono>
+#include <ctime>
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/opt/ir_context.h"
+#include "source/util/make_unique.h"
+#include "source/util/profiler.h"
 #include "source/util/timer.h"
 #include "spirv-tools/libspirv.hpp"
 
 namespace spvtools {
 
 namespace opt {
+namespace {
+
+// Returns the process's peak resident set size in kilobytes, or -1 when the
+// platform does not report it.  Like utils::Timer, this relies on getrusage,
+// which is only pulled in when SPIRV_TIMER_ENABLED is defined.
+long GetPeakRSS() {
+#if defined(SPIRV_TIMER_ENABLED)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  return usage.ru_maxrss;
+#else
+  return -1;
+#endif
+}
+
+// Returns the number of instructions in the module owned by |context|,
+// including debug and annotation instructions.
+uint64_t CountInstructions(IRContext* context) {
+  uint64_t count = 0;
+  context->module()->ForEachInst([&count](Instruction*) { ++count; },
+                                 /* run_on_debug_line_insts = */ true);
+  return count;
+}
+
+// Computes the ModuleTrait bits present in the module owned by |context|
+// with one linear scan, building no analyses.
+uint32_t ComputeModuleTraits(IRContext* context) {
+  constexpr uint32_t kAllTraits = kTraitMaybeHasLoops |
+                                  kTraitHasFunctionCalls |
+                                  kTraitHasFunctionVariables;
+  uint32_t traits = kTraitNone;
+  std::unordered_set<uint32_t> seen_labels;
+  for (Function& function : *context->module()) {
+    seen_labels.clear();
+    for (BasicBlock& block : function) {
+      seen_labels.insert(block.id());
+      for (Instruction& inst : block) {
+        if (inst.opcode() == spv::Op::OpFunctionCall) {
+          traits |= kTraitHasFunctionCalls;
+        } else if (inst.opcode() == spv::Op::OpVariable) {
+          traits |= kTraitHasFunctionVariables;
+        }
+      }
+      if ((traits & kTraitMaybeHasLoops) == 0) {
+        block.ForEachSuccessorLabel([&traits, &seen_labels](uint32_t label) {
+          if (seen_labels.count(label)) traits |= kTraitMaybeHasLoops;
+        });
+      }
+      if (traits == kAllTraits) return traits;
+    }
+  }
+  return traits;
+}
+
+}  // namespace
 
 Pass::Status PassManager::Run(IRContext* context) {
   auto status = Pass::Status::SuccessWithoutChange;
@@ -51,26 +113,160 @@ Pass::Status PassManager::Run(IRContext* context) {
     }
   };
 
+  // Returns the cost of the module under the configured speculation metric.
+  auto speculation_cost = [this](IRContext* c) {
+    return speculation_cost_fn_ ? speculation_cost_fn_(c)
+                                : CountInstructions(c);
+  };
+
+  // Number of passes so far that reported changing the module, plus that
+  // number as it stood after the last no-change run of each pass name.  A
+  // pass whose recorded count still matches sees the exact module it already
+  // left untouched, so running it again is provably a no-op.
+  size_t changes_seen = 0;
+  std::unordered_map<std::string, size_t> changes_at_last_no_change_run;
+
+  // Module traits, computed lazily for the first pass that declares a
+  // requirement and reused until some pass changes the module.
+  uint32_t module_traits = kTraitNone;
+  bool module_traits_valid = false;
+
+  // One validator is shared by every validate-after-all run so that its
+  // context-level function-body cache carries across passes: bodies a pass
+  // left untouched skip the per-instruction checks on the next validation.
+  std::unique_ptr<SpirvTools> validator;
+  bool validated_once = false;
+
   SPIRV_TIMER_DESCRIPTION(time_report_stream_, /* measure_mem_usage = */ true);
   for (auto& pass : passes_) {
+    if (skip_redundant_reruns_) {
+      const auto rerun_iter = changes_at_last_no_change_run.find(pass->name());
+      if (rerun_iter != changes_at_last_no_change_run.end() &&
+          rerun_iter->second == changes_seen) {
+        pass.reset(nullptr);
+        continue;
+      }
+    }
+
+    const uint32_t required_traits = pass->RequiredModuleTraits();
+    if (required_traits != kTraitNone) {
+      if (!module_traits_valid) {
+        module_traits = ComputeModuleTraits(context);
+        module_traits_valid = true;
+      }
+      if ((module_traits & required_traits) != required_traits) {
+        // The module provably contains nothing for the pass to act on, so
+        // skip it and record the skip as a no-change run.
+        if (skip_redundant_reruns_) {
+          changes_at_last_no_change_run[pass->name()] = changes_seen;
+        }
+        continue;
+      }
+    }
+
     print_disassembly("; IR before pass ", pass.get());
     SPIRV_TIMER_SCOPED(time_report_stream_, (pass ? pass->name() : ""), true);
-    const auto one_status = pass->Run(context);
+    pass->SetMaxThreads(parallelism_);
+
+    // Checkpoint the module before a speculative pass so that a change
+    // which makes the module worse under the cost metric can be undone.
+    const bool speculative = speculative_passes_.count(pass->name()) != 0;
+    std::unique_ptr<IRContext> checkpoint;
+    uint64_t cost_before = 0;
+    if (speculative) {
+      cost_before = speculation_cost(context);
+      checkpoint = context->Clone();
+    }
+
+    // Gather the "before" half of the pass report only when a consumer is
+    // registered; counting instructions walks the whole module.
+    PassReport report;
+    uint32_t analyses_before = 0;
+    std::chrono::steady_clock::time_point wall_before;
+    std::clock_t cpu_before = 0;
+    long rss_before = -1;
+    if (pass_report_consumer_) {
+      report.pass_name = pass->name();
+      report.instruction_count_before = CountInstructions(context);
+      report.id_bound_before = context->module()->IdBound();
+      analyses_before = static_cast<uint32_t>(context->GetValidAnalyses());
+      rss_before = GetPeakRSS();
+      cpu_before = std::clock();
+      wall_before = std::chrono::steady_clock::now();
+    }
+
+    pass->SetScratchArena(&scratch_arena_);
+    Pass::Status one_status;
+    {
+      // Named after the pass so that analysis rebuilds triggered inside it
+      // show up as its children in the profile.
+      SPIRV_PROFILE_SCOPED(pass->name());
+      one_status = pass->Run(context);
+    }
+    // Reclaim the pass's transient allocations; the blocks are reused by the
+    // next pass.
+    scratch_arena_.Reset();
+
+    // Roll a speculative pass back when it changed the module for the
+    // worse.  The restored module is the exact module the pass saw, so the
+    // run is reported as a no-change run from here on.
+    if (speculative && one_status == Pass::Status::SuccessWithChange &&
+        speculation_cost(context) > cost_before) {
+      context->RestoreFrom(*checkpoint);
+      one_status = Pass::Status::SuccessWithoutChange;
+    }
+
+    if (pass_report_consumer_) {
+      report.wall_time = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - wall_before)
+                             .count();
+      const std::clock_t cpu_after = std::clock();
+      report.cpu_time =
+          (cpu_before == static_cast<std::clock_t>(-1) ||
+           cpu_after == static_cast<std::clock_t>(-1))
+              ? -1.0
+              : static_cast<double>(cpu_after - cpu_before) / CLOCKS_PER_SEC;
+      const long rss_after = GetPeakRSS();
+      report.peak_rss_delta =
+          (rss_before < 0 || rss_after < 0) ? -1 : rss_after - rss_before;
+      report.changed = one_status == Pass::Status::SuccessWithChange;
+      report.instruction_count_after = CountInstructions(context);
+      report.id_bound_after = context->module()->IdBound();
+      const uint32_t analyses_after =
+          static_cast<uint32_t>(context->GetValidAnalyses());
+      report.analyses_invalidated = analyses_before & ~analyses_after;
+      report.analyses_built = analyses_after & ~analyses_before;
+      pass_report_consumer_(report);
+    }
+
     if (one_status == Pass::Status::Failure) return one_status;
-    if (one_status == Pass::Status::SuccessWithChange) status = one_status;
+    if (one_status == Pass::Status::SuccessWithChange) {
+      status = one_status;
+      ++changes_seen;
+      changes_at_last_no_change_run.erase(pass->name());
+      module_traits_valid = false;
+    } else if (skip_redundant_reruns_) {
+      changes_at_last_no_change_run[pass->name()] = changes_seen;
+    }
 
-    if (validate_after_all_) {
-      spvtools::SpirvTools tools(target_env_);
-      tools.SetMessageConsumer(consumer());
+    // A no-change pass left the exact module the previous validation in
+    // this pipeline saw, so there is nothing new to check.
+    if (validate_after_all_ &&
+        (one_status == Pass::Status::SuccessWithChange || !validated_once)) {
+      if (validator == nullptr) {
+        validator = MakeUnique<SpirvTools>(target_env_);
+        validator->SetMessageConsumer(consumer());
+      }
       std::vector<uint32_t> binary;
       context->module()->ToBinary(&binary, true);
-      if (!tools.Validate(binary.data(), binary.size(), val_options_)) {
+      if (!validator->Validate(binary.data(), binary.size(), val_options_)) {
         std::string msg = "Validation failed after pass ";
         msg += pass->name();
         spv_position_t null_pos{0, 0, 0};
         consumer()(SPV_MSG_INTERNAL_ERROR, "", null_pos, msg.c_str());
         return Pass::Status::Failure;
       }
+      validated_once = true;
     }
 
     // Reset the pass to free any memory used by the pass.
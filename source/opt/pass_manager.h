@@ -15,8 +15,11 @@
 #ifndef SOURCE_OPT_PASS_MANAGER_H_
 #define SOURCE_OPT_PASS_MANAGER_H_
 
+#include <functional>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -26,6 +29,7 @@
 
 #include "source/opt/ir_context.h"
 #include "spirv-tools/libspirv.hpp"
+#include "spirv-tools/optimizer.hpp"
 
 namespace spvtools {
 namespace opt {
@@ -110,6 +114,61 @@ class PassManager {
     return *this;
   }
 
+  // Sets the option to skip a pass when its previous run in this pipeline
+  // reported Status::SuccessWithoutChange and no later pass has changed the
+  // module since: such a run sees the exact module it already left alone.
+  // Repeated passes are matched by name, so this must only be enabled for
+  // pipelines whose behaviour is fully determined by the pass name (it is
+  // not safe if the same pass name is registered twice with different
+  // constructor arguments).
+  PassManager& SetSkipRedundantReruns(bool skip) {
+    skip_redundant_reruns_ = skip;
+    return *this;
+  }
+
+  // Sets the callback that receives a PassReport after each pass finishes
+  // running.  Reports are gathered only while a callback is registered, so
+  // the default (null) callback makes Run() skip the bookkeeping entirely.
+  PassManager& SetPassReportConsumer(PassReportConsumer consumer) {
+    pass_report_consumer_ = std::move(consumer);
+    return *this;
+  }
+
+  // The cost metric used to judge speculative passes.  Takes the context
+  // after a candidate pass has run; lower is better.
+  using SpeculationCostFn = std::function<uint64_t(IRContext*)>;
+
+  // Runs the passes named in |pass_names| speculatively.  Before such a
+  // pass runs, the module is checkpointed with IRContext::Clone(); if the
+  // pass changes the module but the cost metric reports a higher cost than
+  // before, the change is rolled back and the pass is treated as a
+  // no-change run.  This replaces running the whole pipeline twice with
+  // different pass lists and keeping the better result: only the passes
+  // that actually pessimize a given module pay for the rollback.
+  PassManager& SetSpeculativePasses(std::vector<std::string> pass_names) {
+    speculative_passes_.clear();
+    speculative_passes_.insert(pass_names.begin(), pass_names.end());
+    return *this;
+  }
+
+  // Sets the cost metric used to judge speculative passes.  The default
+  // (null) metric counts instructions; callers wanting a different notion
+  // of "worse", such as estimated register pressure from RegisterLiveness,
+  // supply their own.
+  PassManager& SetSpeculationCostFunction(SpeculationCostFn fn) {
+    speculation_cost_fn_ = std::move(fn);
+    return *this;
+  }
+
+  // Sets the number of worker threads made available to passes that fan
+  // function-local work out across threads.  The default of 1 keeps every
+  // pass serial.  Passes that do not support parallel execution ignore the
+  // setting.
+  PassManager& SetParallelism(size_t num_threads) {
+    parallelism_ = num_threads == 0 ? 1 : num_threads;
+    return *this;
+  }
+
  private:
   // Consumer for messages.
   MessageConsumer consumer_;
@@ -127,6 +186,21 @@ class PassManager {
   spv_validator_options val_options_;
   // Controls whether validation occurs after every pass.
   bool validate_after_all_;
+  // Receives a structured report after each pass runs.  May be null, in
+  // which case no per-pass statistics are gathered.
+  PassReportConsumer pass_report_consumer_;
+  // Number of worker threads made available to passes; 1 means serial.
+  size_t parallelism_ = 1;
+  // Controls whether provably no-op re-runs of passes are skipped.
+  bool skip_redundant_reruns_ = false;
+  // Names of the passes run speculatively, with commit or rollback decided
+  // by the cost metric.
+  std::unordered_set<std::string> speculative_passes_;
+  // Cost metric for speculative passes; null selects instruction count.
+  SpeculationCostFn speculation_cost_fn_;
+  // Scratch arena shared by the passes, reset after each pass runs so its
+  // blocks are reused across the whole pipeline.
+  utils::ScratchArena scratch_arena_;
 };
 
 inline void PassManager::AddPass(std::unique_ptr<Pass> pass) {
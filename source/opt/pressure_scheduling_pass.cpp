@@ -0,0 +1,191 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/pressure_scheduling_pass.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "source/opt/def_use_manager.h"
+#include "source/opt/function.h"
+
+namespace spvtools {
+namespace opt {
+
+Pass::Status PressureSchedulingPass::Process() {
+  bool modified = false;
+  for (Function& function : *get_module()) {
+    for (BasicBlock& bb : function) {
+      modified |= ScheduleBlock(&bb);
+    }
+  }
+  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+}
+
+bool PressureSchedulingPass::IsSchedulable(const Instruction* inst) const {
+  return inst->result_id() != 0 && inst->opcode() != spv::Op::OpLoad &&
+         inst->IsOpcodeCodeMotionSafe();
+}
+
+bool PressureSchedulingPass::ScheduleBlock(BasicBlock* bb) {
+  analysis::DefUseManager* def_use = get_def_use_mgr();
+
+  // The schedulable region: everything after the phis, terminator included.
+  // Phis must stay at the top and are never reordered.
+  std::vector<Instruction*> original;
+  for (Instruction& inst : *bb) {
+    if (inst.opcode() == spv::Op::OpPhi) continue;
+    original.push_back(&inst);
+  }
+  // With fewer than two instructions before the terminator no reordering is
+  // possible.
+  if (original.size() < 3) return false;
+
+  std::unordered_map<Instruction*, size_t> position;
+  for (size_t i = 0; i < original.size(); ++i) position[original[i]] = i;
+
+  // The position of the last use of each id within the region.  An operand
+  // dies at an instruction exactly when that instruction is its last use.
+  std::unordered_map<uint32_t, size_t> last_use;
+  for (size_t i = 0; i < original.size(); ++i) {
+    original[i]->ForEachInId(
+        [&last_use, i](const uint32_t* id) { last_use[*id] = i; });
+  }
+
+  // Decide which instructions may sink.  |first_use| holds, for each sinking
+  // instruction, the original position of its first user in the region;
+  // instructions whose users are all phis or in other blocks get the
+  // terminator's position, i.e. they sink to the bottom of the block.
+  std::unordered_set<Instruction*> sinkable;
+  std::unordered_map<Instruction*, size_t> first_use;
+  for (size_t i = 0; i + 1 < original.size(); ++i) {
+    Instruction* inst = original[i];
+    if (!IsSchedulable(inst)) continue;
+
+    size_t first = original.size() - 1;
+    bool has_user = false;
+    def_use->ForEachUser(inst, [&position, &first, &has_user](
+                                   Instruction* user) {
+      has_user = true;
+      auto it = position.find(user);
+      if (it != position.end() && user->opcode() != spv::Op::OpPhi) {
+        first = std::min(first, it->second);
+      }
+    });
+    // Leave dead instructions alone; removing them is DCE's job, and moving
+    // them down would only stretch their operands' live ranges.
+    if (!has_user) continue;
+
+    // Sinking |inst| shortens its result's live range but extends the range
+    // of every operand dying here, unless that operand's definition sinks
+    // along with it (it does when |inst| is its first user).  Allow the move
+    // only when at most one operand range grows, so the live-value count
+    // never increases over the crossed region.
+    std::vector<uint32_t> ids;
+    inst->ForEachInId([&ids](const uint32_t* id) {
+      if (std::find(ids.begin(), ids.end(), *id) == ids.end()) {
+        ids.push_back(*id);
+      }
+    });
+    size_t num_extended = 0;
+    for (uint32_t id : ids) {
+      if (last_use[id] != i) continue;
+      Instruction* def = def_use->GetDef(id);
+      auto first_it = def == nullptr ? first_use.end() : first_use.find(def);
+      const bool sinks_along = first_it != first_use.end() &&
+                               sinkable.count(def) != 0 &&
+                               first_it->second == i;
+      if (!sinks_along) ++num_extended;
+    }
+    if (num_extended > 1) continue;
+
+    sinkable.insert(inst);
+    first_use[inst] = first;
+  }
+  if (sinkable.empty()) return false;
+
+  // Build the new order.  Anchors (everything that does not sink) keep their
+  // original relative order; before each one, emit the not-yet-emitted
+  // sinking instructions it uses, operands first, so each sunk expression
+  // tree materializes contiguously right before its first user.
+  std::vector<Instruction*> scheduled;
+  scheduled.reserve(original.size());
+  std::unordered_set<Instruction*> emitted;
+  auto emit = [&def_use, &position, &sinkable, &scheduled,
+               &emitted](Instruction* root) {
+    std::vector<Instruction*> stack(1, root);
+    while (!stack.empty()) {
+      Instruction* inst = stack.back();
+      if (emitted.count(inst) != 0) {
+        stack.pop_back();
+        continue;
+      }
+      std::vector<Instruction*> pending;
+      inst->ForEachInId(
+          [&def_use, &position, &sinkable, &emitted, &pending](
+              const uint32_t* id) {
+            Instruction* def = def_use->GetDef(*id);
+            if (def != nullptr && position.count(def) != 0 &&
+                sinkable.count(def) != 0 && emitted.count(def) == 0) {
+              pending.push_back(def);
+            }
+          });
+      if (pending.empty()) {
+        emitted.insert(inst);
+        scheduled.push_back(inst);
+        stack.pop_back();
+      } else {
+        // Push in reverse so the first operand is emitted first.
+        stack.insert(stack.end(), pending.rbegin(), pending.rend());
+      }
+    }
+  };
+  // A merge instruction must stay second-to-last in its block, so nothing
+  // may be emitted between it and the terminator.
+  const size_t tail = bb->GetMergeInst() != nullptr ? original.size() - 2
+                                                    : original.size() - 1;
+  for (size_t i = 0; i < tail; ++i) {
+    if (sinkable.count(original[i]) == 0) emit(original[i]);
+  }
+  // Whatever remains is used only by the terminator, by phis, or by other
+  // blocks; it lands at the bottom of the block, in its original relative
+  // order, followed by the terminator's own operand trees.
+  for (size_t i = 0; i < tail; ++i) emit(original[i]);
+  original.back()->ForEachInId(
+      [&def_use, &position, &sinkable, &emit](const uint32_t* id) {
+        Instruction* def = def_use->GetDef(*id);
+        if (def != nullptr && position.count(def) != 0 &&
+            sinkable.count(def) != 0) {
+          emit(def);
+        }
+      });
+  for (size_t i = tail; i < original.size(); ++i) emit(original[i]);
+
+  if (scheduled == original) return false;
+
+  // Relink the list back to front; the terminator never moves, and each
+  // instruction slots in directly before its successor in the new order.
+  Instruction* next = scheduled.back();
+  for (auto it = scheduled.rbegin() + 1; it != scheduled.rend(); ++it) {
+    Instruction* inst = *it;
+    if (inst->NextNode() != next) inst->InsertBefore(next);
+    next = inst;
+  }
+  return true;
+}
+
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,71 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_PRESSURE_SCHEDULING_PASS_H_
+#define SOURCE_OPT_PRESSURE_SCHEDULING_PASS_H_
+
+#include "source/opt/basic_block.h"
+#include "source/opt/instruction.h"
+#include "source/opt/ir_context.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Reorders instructions within each basic block to shorten live ranges, so
+// that downstream register allocators see fewer simultaneously live values.
+//
+// Side-effect-free instructions are sunk, together with their pure operand
+// chains, to immediately before their first use in the block; values used
+// only by other blocks or by phis sink to the bottom of the block.  Whole
+// expression trees therefore materialize contiguously at their use, which is
+// the classic low-pressure evaluation order.  Everything else - loads,
+// stores, calls, barriers, phis and terminators - keeps its original
+// relative order and anchors the schedule, so memory ordering is never
+// changed.
+//
+// Sinking a definition shortens the live range of its result but can extend
+// the live ranges of operands that die at that instruction.  An instruction
+// is only allowed to move when at most one operand range would be extended,
+// so a move never increases the number of simultaneously live values over
+// the region it crosses.
+class PressureSchedulingPass : public Pass {
+ public:
+  const char* name() const override { return "pressure-scheduling"; }
+  Status Process() override;
+
+  IRContext::Analysis GetPreservedAnalyses() override {
+    return IRContext::kAnalysisDefUse |
+           IRContext::kAnalysisInstrToBlockMapping |
+           IRContext::kAnalysisCombinators | IRContext::kAnalysisCFG |
+           IRContext::kAnalysisDominatorAnalysis |
+           IRContext::kAnalysisLoopAnalysis | IRContext::kAnalysisNameMap |
+           IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
+  }
+
+ private:
+  // Reorders the instructions of |bb| as described above.  Returns true if
+  // the block changed.
+  bool ScheduleBlock(BasicBlock* bb);
+
+  // Returns true if |inst| computes a result from its operands without
+  // touching memory, so it may be moved down within its block.  Loads are
+  // excluded: sinking one past a store could change the loaded value.
+  bool IsSchedulable(const Instruction* inst) const;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_PRESSURE_SCHEDULING_PASS_H_
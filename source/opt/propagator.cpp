@@ -51,8 +51,9 @@ void SSAPropagator::AddSSAEdges(Instruction* instr) {
           return;
         }
 
-        if (ShouldSimulateAgain(use_instr)) {
-          ssa_edge_uses_.push(use_instr);
+        if (ShouldSimulateAgain(use_instr) &&
+            pending_ssa_uses_.insert(use_instr).second) {
+          ssa_edge_uses_.push({OrderOf(use_instr), use_instr});
         }
       });
 }
@@ -207,6 +208,17 @@ bool SSAPropagator::Simulate(BasicBlock* block) {
 }
 
 void SSAPropagator::Initialize(Function* fn) {
+  // Assign every reachable instruction its position in a reverse-postorder
+  // walk of the CFG.  The SSA work list pops positions in increasing order,
+  // which groups the simulation into dependency wavefronts.
+  uint32_t order = 0;
+  ctx_->cfg()->ForEachBlockInReversePostOrder(
+      fn->entry().get(), [this, &order](BasicBlock* block) {
+        block->ForEachInst([this, &order](Instruction* instr) {
+          instruction_order_[instr] = order++;
+        });
+      });
+
   // Compute predecessor and successor blocks for every block in |fn|'s CFG.
   // TODO(dnovillo): Move this to CFG and always build them. Alternately,
   // move it to IRContext and build CFG preds/succs on-demand.
@@ -250,11 +262,12 @@ bool SSAPropagator::Run(Function* fn) {
       continue;
     }
 
-    // Simulate edges from the SSA queue.
+    // Simulate edges from the SSA work list, earliest wavefront first.
     if (!ssa_edge_uses_.empty()) {
-      Instruction* instr = ssa_edge_uses_.front();
-      changed |= Simulate(instr);
+      Instruction* instr = ssa_edge_uses_.top().second;
       ssa_edge_uses_.pop();
+      pending_ssa_uses_.erase(instr);
+      changed |= Simulate(instr);
     }
   }
 
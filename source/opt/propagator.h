@@ -15,6 +15,7 @@
 #ifndef SOURCE_OPT_PROPAGATOR_H_
 #define SOURCE_OPT_PROPAGATOR_H_
 
+#include <cstdint>
 #include <functional>
 #include <queue>
 #include <set>
@@ -277,9 +278,33 @@ class SSAPropagator {
   // track of interesting values by storing them in some user-provided map.
   VisitFunction visit_fn_;
 
-  // SSA def-use edges to traverse. Each entry is a destination statement for an
-  // SSA def-use edge as returned by |def_use_manager_|.
-  std::queue<Instruction*> ssa_edge_uses_;
+  // Returns the reverse-postorder position assigned to |instr| during
+  // Initialize().  Instructions outside the walk sort last.
+  uint32_t OrderOf(Instruction* instr) const {
+    auto it = instruction_order_.find(instr);
+    return it == instruction_order_.end() ? UINT32_MAX : it->second;
+  }
+
+  // SSA def-use edges to traverse. Each entry is a destination statement for
+  // an SSA def-use edge as returned by |def_use_manager_|, keyed by the
+  // statement's position in a reverse-postorder walk of the CFG.  Popping the
+  // smallest position first simulates the function wavefront by wavefront: a
+  // statement is normally only visited once all its operands have settled, so
+  // acyclic dependency chains converge in a single sweep.  Loop back edges
+  // (including irreducible regions) simply re-enqueue their consumers, which
+  // degrades gracefully to the classic worklist iteration.
+  std::priority_queue<std::pair<uint32_t, Instruction*>,
+                      std::vector<std::pair<uint32_t, Instruction*>>,
+                      std::greater<std::pair<uint32_t, Instruction*>>>
+      ssa_edge_uses_;
+
+  // Statements currently in |ssa_edge_uses_|, so a statement is enqueued at
+  // most once no matter how many of its operands change.
+  std::unordered_set<Instruction*> pending_ssa_uses_;
+
+  // Position of every reachable instruction in the reverse-postorder walk,
+  // assigned by Initialize().
+  std::unordered_map<Instruction*, uint32_t> instruction_order_;
 
   // Blocks to simulate.
   std::queue<BasicBlock*> blocks_;
@@ -21,7 +21,14 @@ namespace opt {
 
 Pass::Status RedundancyEliminationPass::Process() {
   bool modified = false;
-  ValueNumberTable vnTable(context());
+  const ValueNumberTable& vnTable = *context()->GetValueNumberTable();
+
+  // For each value number, the id that holds that value in the scope of the
+  // block currently being processed.  Entries are rolled back when the
+  // dominator tree traversal leaves the node that added them, so the array
+  // never needs to be copied.
+  std::vector<uint32_t> value_to_ids(vnTable.NumValueNumbers(), 0);
+  std::vector<uint32_t> assigned_values;
 
   for (auto& func : *get_module()) {
     if (func.IsDeclaration()) {
@@ -33,12 +40,8 @@ Pass::Status RedundancyEliminationPass::Process() {
     DominatorTree& dom_tree =
         context()->GetDominatorAnalysis(&func)->GetDomTree();
 
-    // Keeps track of all ids that contain a given value number. We keep
-    // track of multiple values because they could have the same value, but
-    // different decorations.
-    std::map<uint32_t, uint32_t> value_to_ids;
-
-    if (EliminateRedundanciesFrom(dom_tree.GetRoot(), vnTable, value_to_ids)) {
+    if (EliminateRedundanciesFrom(dom_tree.GetRoot(), vnTable, &value_to_ids,
+                                  &assigned_values)) {
       modified = true;
     }
   }
@@ -47,11 +50,23 @@ Pass::Status RedundancyEliminationPass::Process() {
 
 bool RedundancyEliminationPass::EliminateRedundanciesFrom(
     DominatorTreeNode* bb, const ValueNumberTable& vnTable,
-    std::map<uint32_t, uint32_t> value_to_ids) {
-  bool modified = EliminateRedundanciesInBB(bb->bb_, vnTable, &value_to_ids);
+    std::vector<uint32_t>* value_to_ids,
+    std::vector<uint32_t>* assigned_values) {
+  // The entries |bb| adds stay visible while the blocks it dominates are
+  // processed, and are rolled back once they have all been visited.
+  const size_t scope_begin = assigned_values->size();
+  bool modified =
+      EliminateRedundanciesInBB(bb->bb_, vnTable, value_to_ids,
+                                assigned_values);
 
   for (auto dominated_bb : bb->children_) {
-    modified |= EliminateRedundanciesFrom(dominated_bb, vnTable, value_to_ids);
+    modified |= EliminateRedundanciesFrom(dominated_bb, vnTable, value_to_ids,
+                                          assigned_values);
+  }
+
+  while (assigned_values->size() > scope_begin) {
+    (*value_to_ids)[assigned_values->back()] = 0;
+    assigned_values->pop_back();
   }
 
   return modified;
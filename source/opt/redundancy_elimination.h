@@ -15,7 +15,7 @@
 #ifndef SOURCE_OPT_REDUNDANCY_ELIMINATION_H_
 #define SOURCE_OPT_REDUNDANCY_ELIMINATION_H_
 
-#include <map>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 #include "source/opt/local_redundancy_elimination.h"
@@ -40,14 +40,18 @@ class RedundancyEliminationPass : public LocalRedundancyEliminationPass {
   // |vnTable| must have computed a value number for every result id defined
   // in the function containing |bb|.
   //
-  // |value_to_ids| is a map from value number to ids.  If {vn, id} is in
-  // |value_to_ids| then vn is the value number of id, and the definition of id
-  // dominates |bb|.
+  // |value_to_ids| is indexed by value number, as described for
+  // EliminateRedundanciesInBB.  Instead of copying the array for every
+  // dominator tree node, the entries added while processing |bb| and the
+  // blocks it dominates are recorded in |assigned_values| and rolled back
+  // before returning, so on exit the array holds exactly the ids whose
+  // definitions dominate |bb| that it held on entry.
   //
   // Returns true if at least one instruction is deleted.
   bool EliminateRedundanciesFrom(DominatorTreeNode* bb,
                                  const ValueNumberTable& vnTable,
-                                 std::map<uint32_t, uint32_t> value_to_ids);
+                                 std::vector<uint32_t>* value_to_ids,
+                                 std::vector<uint32_t>* assigned_values);
 };
 
 }  // namespace opt
@@ -94,7 +94,11 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
 
   analysis::TypeManager type_manager(context()->consumer(), context());
 
-  std::vector<Instruction*> visited_types;
+  // Visited types, bucketed by the structural hash the type system already
+  // provides.  Candidate duplicates necessarily share a hash, so each new
+  // type is only compared against structurally identical candidates instead
+  // of every type seen so far.
+  std::unordered_map<size_t, std::vector<Instruction*>> visited_types;
   std::vector<analysis::ForwardPointer> visited_forward_pointers;
   std::vector<Instruction*> to_delete;
   for (auto* i = &*context()->types_values_begin(); i; i = i->NextNode()) {
@@ -111,9 +115,8 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
       spv::Id id_to_keep = 0u;
       analysis::Type* i_type = type_manager.GetType(i->result_id());
       assert(i_type);
-      // TODO(dneto0): Use a trie to avoid quadratic behaviour? Extract the
-      // ResultIdTrie from unify_const_pass.cpp for this.
-      for (auto j : visited_types) {
+      std::vector<Instruction*>& bucket = visited_types[i_type->HashValue()];
+      for (auto j : bucket) {
         analysis::Type* j_type = type_manager.GetType(j->result_id());
         assert(j_type);
         if (*i_type == *j_type) {
@@ -124,7 +127,7 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
 
       if (id_to_keep == 0u) {
         // This is a never seen before type, keep it around.
-        visited_types.emplace_back(i);
+        bucket.emplace_back(i);
       } else {
         // The same type has already been seen before, remove this one.
         context()->KillNamesAndDecorates(i->result_id());
@@ -176,25 +179,47 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
 bool RemoveDuplicatesPass::RemoveDuplicateDecorations() const {
   bool modified = false;
 
-  std::vector<const Instruction*> visited_decorations;
+  // AreDecorationsTheSame only ever matches OpDecorate, OpMemberDecorate,
+  // OpDecorateId and OpDecorateString instructions, and compares them by
+  // opcode and in-operands.  Hash over exactly those fields so candidate
+  // duplicates can be found in their bucket instead of by scanning every
+  // decoration seen so far.
+  const auto decoration_hash = [](const Instruction* inst) {
+    size_t hash = std::hash<uint32_t>()(static_cast<uint32_t>(inst->opcode()));
+    for (uint32_t i = 0u; i < inst->NumInOperands(); ++i) {
+      const Operand& operand = inst->GetInOperand(i);
+      hash = hash * 31 +
+             std::hash<uint32_t>()(static_cast<uint32_t>(operand.type));
+      for (uint32_t word : operand.words) hash = hash * 31 + word;
+    }
+    return hash;
+  };
+  std::unordered_map<size_t, std::vector<const Instruction*>>
+      visited_decorations;
 
   analysis::DecorationManager decoration_manager(context()->module());
   for (auto* i = &*context()->annotation_begin(); i;) {
     // Is the current decoration equal to one of the decorations we have
     // already visited?
     bool already_visited = false;
-    // TODO(dneto0): Use a trie to avoid quadratic behaviour? Extract the
-    // ResultIdTrie from unify_const_pass.cpp for this.
-    for (const Instruction* j : visited_decorations) {
-      if (decoration_manager.AreDecorationsTheSame(&*i, j, false)) {
-        already_visited = true;
-        break;
+    const bool is_comparable = i->opcode() == spv::Op::OpDecorate ||
+                               i->opcode() == spv::Op::OpMemberDecorate ||
+                               i->opcode() == spv::Op::OpDecorateId ||
+                               i->opcode() == spv::Op::OpDecorateStringGOOGLE;
+    if (is_comparable) {
+      std::vector<const Instruction*>& bucket =
+          visited_decorations[decoration_hash(&*i)];
+      for (const Instruction* j : bucket) {
+        if (decoration_manager.AreDecorationsTheSame(&*i, j, false)) {
+          already_visited = true;
+          break;
+        }
       }
+      if (!already_visited) bucket.emplace_back(&*i);
     }
 
     if (!already_visited) {
       // This is a never seen before decoration, keep it around.
-      visited_decorations.emplace_back(&*i);
       i = i->NextNode();
     } else {
       // The same decoration has already been seen before, remove this one.
@@ -14,11 +14,13 @@
 
 #include "source/opt/scalar_analysis.h"
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <utility>
 
 #include "source/opt/ir_context.h"
+#include "source/util/slot_pool.h"
 
 // Transforms a given scalar operation instruction into a DAG representation.
 //
@@ -47,6 +49,32 @@ namespace opt {
 
 uint32_t SENode::NumberOfNodes = 0;
 
+namespace {
+// Every SENode subclass fits in one pool slot; see source/util/slot_pool.h.
+constexpr size_t kSENodeSlotBytes =
+    std::max({sizeof(SEConstantNode), sizeof(SERecurrentNode),
+              sizeof(SEAddNode), sizeof(SEMultiplyNode), sizeof(SENegative),
+              sizeof(SEValueUnknown), sizeof(SECantCompute)});
+constexpr size_t kSENodeSlotAlign =
+    std::max({alignof(SEConstantNode), alignof(SERecurrentNode),
+              alignof(SEAddNode), alignof(SEMultiplyNode), alignof(SENegative),
+              alignof(SEValueUnknown), alignof(SECantCompute)});
+using SENodePool = utils::SlotPool<kSENodeSlotBytes, kSENodeSlotAlign>;
+}  // namespace
+
+void* SENode::operator new(size_t size) {
+  if (size > kSENodeSlotBytes) return ::operator new(size);
+  return SENodePool::ThreadLocal().Allocate();
+}
+
+void SENode::operator delete(void* ptr, size_t size) {
+  if (size > kSENodeSlotBytes) {
+    ::operator delete(ptr);
+    return;
+  }
+  SENodePool::ThreadLocal().Deallocate(ptr);
+}
+
 ScalarEvolutionAnalysis::ScalarEvolutionAnalysis(IRContext* context)
     : context_(context), pretend_equal_{} {
   // Create and cached the CantComputeNode.
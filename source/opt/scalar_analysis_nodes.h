@@ -189,6 +189,13 @@ class SENode {
     return parent_analysis_;
   }
 
+  // SENodes are allocated in very large numbers during dependence analysis,
+  // and simplification creates many short-lived nodes that are discarded as
+  // soon as the cache reports an equivalent one, so allocation goes through
+  // a pool of fixed-size slots instead of the global heap.
+  void* operator new(size_t size);
+  void operator delete(void* ptr, size_t size);
+
  protected:
   ChildContainerType children_;
 
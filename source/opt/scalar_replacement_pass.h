@@ -60,6 +60,10 @@ class ScalarReplacementPass : public MemPass {
   // SuccessWithChange if any change is made.
   Status Process() override;
 
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitHasFunctionVariables;
+  }
+
   IRContext::Analysis GetPreservedAnalyses() override {
     return IRContext::kAnalysisDefUse |
            IRContext::kAnalysisInstrToBlockMapping |
@@ -22,15 +22,65 @@
 namespace spvtools {
 namespace opt {
 
+bool SimplificationPass::RewriteInstruction(Instruction* inst) {
+  return context()->get_instruction_folder().FoldInstruction(inst);
+}
+
 Pass::Status SimplificationPass::Process() {
   bool modified = false;
 
+  // If a previous run of this pass left a dirty-block record behind, only
+  // rescan the blocks that intervening passes touched.
+  std::unordered_set<uint32_t> blocks_to_scan;
+  bool have_blocks_to_scan = context()->HasDirtyBlockTracking() &&
+                             ComputeBlocksToScan(&blocks_to_scan);
+
   for (Function& function : *get_module()) {
-    modified |= SimplifyFunction(&function);
+    modified |= SimplifyFunction(
+        &function, have_blocks_to_scan ? &blocks_to_scan : nullptr);
   }
+
+  // Record the blocks later passes touch, so that the next run of this pass
+  // can limit its scan to them.
+  context()->StartDirtyBlockTracking();
   return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
 }
 
+bool SimplificationPass::ComputeBlocksToScan(
+    std::unordered_set<uint32_t>* blocks) {
+  if (!context()->AreAnalysesValid(IRContext::kAnalysisDefUse |
+                                   IRContext::kAnalysisInstrToBlockMapping)) {
+    return false;
+  }
+
+  analysis::DefUseManager* def_use_mgr = get_def_use_mgr();
+  auto add_user_blocks = [this, def_use_mgr, blocks](Instruction* inst) {
+    def_use_mgr->ForEachUser(inst, [this, blocks](Instruction* user) {
+      if (BasicBlock* bb = context()->get_instr_block(user)) {
+        blocks->insert(bb->id());
+      }
+    });
+  };
+
+  // A changed instruction can enable a fold in each of its users, so scan the
+  // users' blocks as well.  Changes cascading from those folds are followed
+  // by the worklist during the run itself.
+  for (uint32_t block_id : context()->dirty_blocks()) {
+    Instruction* label = def_use_mgr->GetDef(block_id);
+    if (label == nullptr) continue;
+    BasicBlock* bb = context()->get_instr_block(label);
+    if (bb == nullptr) continue;
+    blocks->insert(block_id);
+    bb->ForEachInst(add_user_blocks);
+  }
+  for (uint32_t global_id : context()->dirty_global_ids()) {
+    Instruction* def = def_use_mgr->GetDef(global_id);
+    if (def == nullptr) continue;
+    add_user_blocks(def);
+  }
+  return true;
+}
+
 void SimplificationPass::AddNewOperands(
     Instruction* folded_inst, std::unordered_set<Instruction*>* inst_seen,
     std::vector<Instruction*>* work_list) {
@@ -43,7 +93,8 @@ void SimplificationPass::AddNewOperands(
       });
 }
 
-bool SimplificationPass::SimplifyFunction(Function* function) {
+bool SimplificationPass::SimplifyFunction(
+    Function* function, const std::unordered_set<uint32_t>* blocks_to_scan) {
   if (function->IsDeclaration()) {
     return false;
   }
@@ -60,12 +111,14 @@ bool SimplificationPass::SimplifyFunction(Function* function) {
   std::unordered_set<Instruction*> inst_to_kill;
   std::unordered_set<Instruction*> in_work_list;
   std::unordered_set<Instruction*> inst_seen;
-  const InstructionFolder& folder = context()->get_instruction_folder();
 
   cfg()->ForEachBlockInReversePostOrder(
       function->entry().get(),
       [&modified, &process_phis, &work_list, &in_work_list, &inst_to_kill,
-       &folder, &inst_seen, this](BasicBlock* bb) {
+       &inst_seen, blocks_to_scan, this](BasicBlock* bb) {
+        if (blocks_to_scan != nullptr && blocks_to_scan->count(bb->id()) == 0) {
+          return;
+        }
         for (Instruction* inst = &*bb->begin(); inst; inst = inst->NextNode()) {
           inst_seen.insert(inst);
           if (inst->opcode() == spv::Op::OpPhi) {
@@ -77,13 +130,18 @@ bool SimplificationPass::SimplifyFunction(Function* function) {
               context()->get_decoration_mgr()->HaveSubsetOfDecorations(
                   inst->result_id(), inst->GetSingleWordInOperand(0));
 
-          if (is_foldable_copy || folder.FoldInstruction(inst)) {
+          if (is_foldable_copy || RewriteInstruction(inst)) {
             modified = true;
             context()->AnalyzeUses(inst);
+            // When the scan is restricted to a subset of the blocks, a user
+            // in a skipped block will not be reached by this traversal, so
+            // every user has to go through the work list.
             get_def_use_mgr()->ForEachUser(inst, [&work_list, &process_phis,
-                                                  &in_work_list](
+                                                  &in_work_list,
+                                                  blocks_to_scan](
                                                      Instruction* use) {
-              if (process_phis.count(use) && in_work_list.insert(use).second) {
+              if ((process_phis.count(use) || blocks_to_scan != nullptr) &&
+                  in_work_list.insert(use).second) {
                 work_list.push_back(use);
               }
             });
@@ -124,7 +182,7 @@ bool SimplificationPass::SimplifyFunction(Function* function) {
         context()->get_decoration_mgr()->HaveSubsetOfDecorations(
             inst->result_id(), inst->GetSingleWordInOperand(0));
 
-    if (is_foldable_copy || folder.FoldInstruction(inst)) {
+    if (is_foldable_copy || RewriteInstruction(inst)) {
       modified = true;
       context()->AnalyzeUses(inst);
       get_def_use_mgr()->ForEachUser(
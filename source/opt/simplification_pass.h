@@ -37,11 +37,28 @@ class SimplificationPass : public Pass {
            IRContext::kAnalysisTypes;
   }
 
+ protected:
+  // Applies the peephole rewrites to |inst|.  Returns true if the
+  // instruction changed; the caller re-analyzes its uses and follows them
+  // through the work list.  The base pass applies the instruction folder;
+  // FusedPeepholePass overrides this to apply fused rule sets in the same
+  // traversal.
+  virtual bool RewriteInstruction(Instruction* inst);
+
  private:
   // Returns true if the module was changed.  The simplifier is called on every
   // instruction in |function| until nothing else in the function can be
-  // simplified.
-  bool SimplifyFunction(Function* function);
+  // simplified.  If |blocks_to_scan| is not null, the initial scan only
+  // visits the blocks whose ids it contains; the worklist still follows
+  // simplifications into other blocks.
+  bool SimplifyFunction(Function* function,
+                        const std::unordered_set<uint32_t>* blocks_to_scan);
+
+  // Fills |blocks| with the blocks that may simplify differently than they
+  // did in the previous run: the blocks recorded as dirty by the IRContext
+  // plus every block holding a user of an instruction in them.  Returns
+  // false if the record cannot be used and all blocks must be scanned.
+  bool ComputeBlocksToScan(std::unordered_set<uint32_t>* blocks);
 
   // FactorAddMul can create |folded_inst| Mul of new Add. If Mul, push any Add
   // operand not in |seen_inst| into |worklist|. This is heavily restricted to
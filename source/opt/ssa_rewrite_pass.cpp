@@ -48,6 +48,7 @@
 #include "source/opt/cfg.h"
 #include "source/opt/mem_pass.h"
 #include "source/opt/types.h"
+#include "source/util/small_map.h"
 
 // Debug logging (0: Off, 1-N: Verbosity level).  Replace this with the
 // implementation done for
@@ -240,17 +241,30 @@ uint32_t SSARewriter::AddPhiOperands(PhiCandidate* phi_candidate) {
   return repl_id;
 }
 
+uint32_t SSARewriter::VarIndex(uint32_t var_id) {
+  // The mapped value is the pre-insertion size of the map, so the first
+  // variable gets index 0, the second index 1, and so on.
+  return var_index_.emplace(var_id, static_cast<uint32_t>(var_index_.size()))
+      .first->second;
+}
+
+void SSARewriter::WriteVariable(uint32_t var_id, BasicBlock* bb,
+                                uint32_t val_id) {
+  std::vector<uint32_t>& defs = defs_at_block_[BlockIndex(bb)];
+  const uint32_t var_ix = VarIndex(var_id);
+  if (defs.size() <= var_ix) defs.resize(var_ix + 1, 0);
+  defs[var_ix] = val_id;
+  if (auto* pc = GetPhiCandidate(val_id)) {
+    pc->AddUser(bb->id());
+  }
+}
+
 uint32_t SSARewriter::GetValueAtBlock(uint32_t var_id, BasicBlock* bb) {
   assert(bb != nullptr);
-  const auto& bb_it = defs_at_block_.find(bb);
-  if (bb_it != defs_at_block_.end()) {
-    const auto& current_defs = bb_it->second;
-    const auto& var_it = current_defs.find(var_id);
-    if (var_it != current_defs.end()) {
-      return var_it->second;
-    }
-  }
-  return 0;
+  const auto var_it = var_index_.find(var_id);
+  if (var_it == var_index_.end()) return 0;
+  const std::vector<uint32_t>& defs = defs_at_block_[BlockIndex(bb)];
+  return var_it->second < defs.size() ? defs[var_it->second] : 0;
 }
 
 uint32_t SSARewriter::GetReachingDef(uint32_t var_id, BasicBlock* bb) {
@@ -290,10 +304,10 @@ uint32_t SSARewriter::GetReachingDef(uint32_t var_id, BasicBlock* bb) {
 }
 
 void SSARewriter::SealBlock(BasicBlock* bb) {
-  auto result = sealed_blocks_.insert(bb);
-  (void)result;
-  assert(result.second == true &&
+  const uint32_t block_ix = BlockIndex(bb);
+  assert(!sealed_blocks_[block_ix] &&
          "Tried to seal the same basic block more than once.");
+  sealed_blocks_[block_ix] = true;
 }
 
 void SSARewriter::ProcessStore(Instruction* inst, BasicBlock* bb) {
@@ -504,63 +518,81 @@ bool SSARewriter::ApplyReplacements() {
   std::cerr << "\n\n";
 #endif
 
-  // Add Phi instructions from completed Phi candidates.
-  std::vector<Instruction*> generated_phis;
+  // Bucket the completed Phi candidates by basic block, so that each block's
+  // Phis are materialized in one batch below.
+  std::vector<std::vector<const PhiCandidate*>> block_phis(
+      defs_at_block_.size());
   for (const PhiCandidate* phi_candidate : phis_to_generate_) {
-#if SSA_REWRITE_DEBUGGING_LEVEL > 2
-    std::cerr << "Phi candidate: " << phi_candidate->PrettyPrint(pass_->cfg())
-              << "\n";
-#endif
-
     assert(phi_candidate->is_complete() &&
            "Tried to instantiate a Phi instruction from an incomplete Phi "
            "candidate");
+    block_phis[BlockIndex(phi_candidate->bb())].push_back(phi_candidate);
+  }
 
-    auto* local_var = pass_->get_def_use_mgr()->GetDef(phi_candidate->var_id());
+  // Add Phi instructions from completed Phi candidates, one block at a time.
+  // Every Phi of a block is inserted before the block's original first
+  // instruction; iterating each bucket in reverse reproduces the order of
+  // repeated insertions at the block start, so the emitted IR is the same as
+  // with per-candidate insertion.
+  std::vector<Instruction*> generated_phis;
+  for (const std::vector<const PhiCandidate*>& bucket : block_phis) {
+    if (bucket.empty()) continue;
+    BasicBlock* bb = bucket.front()->bb();
+    auto insert_point = bb->begin();
+    for (auto it = bucket.rbegin(); it != bucket.rend(); ++it) {
+      const PhiCandidate* phi_candidate = *it;
+#if SSA_REWRITE_DEBUGGING_LEVEL > 2
+      std::cerr << "Phi candidate: "
+                << phi_candidate->PrettyPrint(pass_->cfg()) << "\n";
+#endif
 
-    // Build the vector of operands for the new OpPhi instruction.
-    uint32_t type_id = pass_->GetPointeeTypeId(local_var);
-    std::vector<Operand> phi_operands;
-    uint32_t arg_ix = 0;
-    std::unordered_map<uint32_t, uint32_t> already_seen;
-    for (uint32_t pred_label : pass_->cfg()->preds(phi_candidate->bb()->id())) {
-      uint32_t op_val_id = GetPhiArgument(phi_candidate, arg_ix++);
-      if (already_seen.count(pred_label) == 0) {
-        phi_operands.push_back(
-            {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {op_val_id}});
-        phi_operands.push_back(
-            {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {pred_label}});
-        already_seen[pred_label] = op_val_id;
-      } else {
-        // It is possible that there are two edges from the same parent block.
-        // Since the OpPhi can have only one entry for each parent, we have to
-        // make sure the two edges are consistent with each other.
-        assert(already_seen[pred_label] == op_val_id &&
-               "Inconsistent value for duplicate edges.");
+      auto* local_var =
+          pass_->get_def_use_mgr()->GetDef(phi_candidate->var_id());
+
+      // Build the vector of operands for the new OpPhi instruction.
+      uint32_t type_id = pass_->GetPointeeTypeId(local_var);
+      std::vector<Operand> phi_operands;
+      uint32_t arg_ix = 0;
+      utils::SmallMap<uint32_t, uint32_t, 8> already_seen;
+      for (uint32_t pred_label : pass_->cfg()->preds(bb->id())) {
+        uint32_t op_val_id = GetPhiArgument(phi_candidate, arg_ix++);
+        if (already_seen.count(pred_label) == 0) {
+          phi_operands.push_back(
+              {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {op_val_id}});
+          phi_operands.push_back(
+              {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {pred_label}});
+          already_seen[pred_label] = op_val_id;
+        } else {
+          // It is possible that there are two edges from the same parent
+          // block.  Since the OpPhi can have only one entry for each parent,
+          // we have to make sure the two edges are consistent with each
+          // other.
+          assert(already_seen[pred_label] == op_val_id &&
+                 "Inconsistent value for duplicate edges.");
+        }
       }
-    }
 
-    // Generate a new OpPhi instruction and insert it in its basic
-    // block.
-    std::unique_ptr<Instruction> phi_inst(
-        new Instruction(pass_->context(), spv::Op::OpPhi, type_id,
-                        phi_candidate->result_id(), phi_operands));
-    generated_phis.push_back(phi_inst.get());
-    pass_->get_def_use_mgr()->AnalyzeInstDef(&*phi_inst);
-    pass_->context()->set_instr_block(&*phi_inst, phi_candidate->bb());
-    auto insert_it = phi_candidate->bb()->begin();
-    insert_it = insert_it.InsertBefore(std::move(phi_inst));
-    pass_->context()->get_decoration_mgr()->CloneDecorations(
-        phi_candidate->var_id(), phi_candidate->result_id(),
-        {spv::Decoration::RelaxedPrecision});
-
-    // Add DebugValue for the new OpPhi instruction.
-    insert_it->SetDebugScope(local_var->GetDebugScope());
-    pass_->context()->get_debug_info_mgr()->AddDebugValueForVariable(
-        &*insert_it, phi_candidate->var_id(), phi_candidate->result_id(),
-        &*insert_it);
-
-    modified = true;
+      // Generate a new OpPhi instruction and insert it in its basic
+      // block.
+      std::unique_ptr<Instruction> phi_inst(
+          new Instruction(pass_->context(), spv::Op::OpPhi, type_id,
+                          phi_candidate->result_id(), phi_operands));
+      generated_phis.push_back(phi_inst.get());
+      pass_->get_def_use_mgr()->AnalyzeInstDef(&*phi_inst);
+      pass_->context()->set_instr_block(&*phi_inst, bb);
+      auto inserted_it = insert_point.InsertBefore(std::move(phi_inst));
+      pass_->context()->get_decoration_mgr()->CloneDecorations(
+          phi_candidate->var_id(), phi_candidate->result_id(),
+          {spv::Decoration::RelaxedPrecision});
+
+      // Add DebugValue for the new OpPhi instruction.
+      inserted_it->SetDebugScope(local_var->GetDebugScope());
+      pass_->context()->get_debug_info_mgr()->AddDebugValueForVariable(
+          &*inserted_it, phi_candidate->var_id(), phi_candidate->result_id(),
+          &*inserted_it);
+
+      modified = true;
+    }
   }
 
   // Scan uses for all inserted Phi instructions. Do this separately from the
@@ -575,7 +607,13 @@ bool SSARewriter::ApplyReplacements() {
                "corresponding SSA id\n\n";
 #endif
 
-  // Apply replacements from the load replacement table.
+  // Apply replacements from the load replacement table.  Def-use maintenance
+  // is batched: an instruction whose operands refer to several replaced loads
+  // is re-analyzed once when the batch commits instead of once per replaced
+  // operand.  Replacement values are fully resolved by GetReplacement(), so
+  // no instruction rewritten here gains a use that a later iteration needs to
+  // query.
+  pass_->context()->BeginDefUseBatch();
   for (auto& repl : load_replacement_) {
     uint32_t load_id = repl.first;
     uint32_t val_id = GetReplacement(repl);
@@ -598,6 +636,7 @@ bool SSARewriter::ApplyReplacements() {
     pass_->context()->KillInst(load_inst);
     modified = true;
   }
+  pass_->context()->CommitDefUseBatch();
 
   return modified;
 }
@@ -653,6 +692,16 @@ Pass::Status SSARewriter::RewriteFunctionIntoSSA(Function* fp) {
             << fp->PrettyPrint(0) << "\n\n\n";
 #endif
 
+  // Number the basic blocks of |fp| densely.  All per-block state (current
+  // definitions, sealed flags, Phi buckets) lives in flat arrays indexed by
+  // these numbers instead of maps keyed by block.
+  for (auto& bb : *fp) {
+    const uint32_t block_ix = static_cast<uint32_t>(block_index_.size());
+    block_index_[bb.id()] = block_ix;
+  }
+  defs_at_block_.resize(block_index_.size());
+  sealed_blocks_.resize(block_index_.size(), false);
+
   // Collect variables that can be converted into SSA IDs.
   pass_->CollectTargetVars(fp);
 
@@ -18,7 +18,6 @@
 #include <queue>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -120,11 +119,6 @@ class SSARewriter {
     std::vector<uint32_t> users_;
   };
 
-  // Type used to keep track of store operations in each basic block.
-  typedef std::unordered_map<BasicBlock*,
-                             std::unordered_map<uint32_t, uint32_t>>
-      BlockDefsMap;
-
   // Generates all the SSA rewriting decisions for basic block |bb|.  This
   // populates the Phi candidate table (|phi_candidate_|) and the load
   // replacement table (|load_replacement_).  Returns true if successful.
@@ -135,7 +129,17 @@ class SSARewriter {
   void SealBlock(BasicBlock* bb);
 
   // Returns true if |bb| has been sealed.
-  bool IsBlockSealed(BasicBlock* bb) { return sealed_blocks_.count(bb) != 0; }
+  bool IsBlockSealed(BasicBlock* bb) { return sealed_blocks_[BlockIndex(bb)]; }
+
+  // Returns the dense index assigned to variable |var_id|, assigning the
+  // next free index when |var_id| is seen for the first time.
+  uint32_t VarIndex(uint32_t var_id);
+
+  // Returns the dense index assigned to basic block |bb| when the function
+  // was numbered at the start of RewriteFunctionIntoSSA().
+  uint32_t BlockIndex(BasicBlock* bb) const {
+    return block_index_.at(bb->id());
+  }
 
   // Returns the Phi candidate with result ID |id| if it exists in the table
   // |phi_candidates_|. If no such Phi candidate exists, it returns nullptr.
@@ -185,12 +189,7 @@ class SSARewriter {
 
   // Registers a definition for variable |var_id| in basic block |bb| with
   // value |val_id|.
-  void WriteVariable(uint32_t var_id, BasicBlock* bb, uint32_t val_id) {
-    defs_at_block_[bb][var_id] = val_id;
-    if (auto* pc = GetPhiCandidate(val_id)) {
-      pc->AddUser(bb->id());
-    }
-  }
+  void WriteVariable(uint32_t var_id, BasicBlock* bb, uint32_t val_id);
 
   // Returns the value of |var_id| at |bb| if |defs_at_block_| contains it.
   // Otherwise, returns 0.
@@ -199,7 +198,7 @@ class SSARewriter {
   // Processes the store operation |inst| in basic block |bb|. This extracts
   // the variable ID being stored into, determines whether the variable is an
   // SSA-target variable, and, if it is, it stores its value in the
-  // |defs_at_block_| map.
+  // |defs_at_block_| table.
   void ProcessStore(Instruction* inst, BasicBlock* bb);
 
   // Processes the load operation |inst| in basic block |bb|. This extracts
@@ -259,11 +258,19 @@ class SSARewriter {
   // Prints the load replacement table to std::cerr.
   void PrintReplacementTable() const;
 
-  // Map holding the value of every SSA-target variable at every basic block
-  // where the variable is stored. defs_at_block_[block][var_id] = val_id
-  // means that there is a store or Phi instruction for variable |var_id| at
-  // basic block |block| with value |val_id|.
-  BlockDefsMap defs_at_block_;
+  // Value of every SSA-target variable at every basic block where the
+  // variable is stored.  Indexed by dense block index; each entry is a flat
+  // slice indexed by dense variable index, allocated and grown the first
+  // time the block defines a variable.  A zero (or missing) slot means the
+  // block has no definition for that variable.
+  std::vector<std::vector<uint32_t>> defs_at_block_;
+
+  // Dense index for each SSA-target variable, assigned in first-use order
+  // by VarIndex().
+  std::unordered_map<uint32_t, uint32_t> var_index_;
+
+  // Dense index for each basic block of the function, keyed by block id.
+  std::unordered_map<uint32_t, uint32_t> block_index_;
 
   // Map, indexed by Phi ID, holding all the Phi candidates created during SSA
   // rewriting.  |phi_candidates_[id]| returns the Phi candidate whose result
@@ -285,8 +292,8 @@ class SSARewriter {
   // is done to replace all uses of the original load ID with the value ID.
   std::unordered_map<uint32_t, uint32_t> load_replacement_;
 
-  // Set of blocks that have been sealed already.
-  std::unordered_set<BasicBlock*> sealed_blocks_;
+  // Sealed state of every basic block, indexed by dense block index.
+  std::vector<bool> sealed_blocks_;
 
   // Memory pass requesting the SSA rewriter.
   MemPass* pass_;
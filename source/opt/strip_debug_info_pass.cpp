@@ -95,8 +95,8 @@ Pass::Status StripDebugInfoPass::Process() {
 
   // clear OpLine information
   context()->module()->ForEachInst([&modified](Instruction* inst) {
-    modified |= !inst->dbg_line_insts().empty();
-    inst->dbg_line_insts().clear();
+    modified |= inst->has_dbg_line_insts();
+    inst->clear_dbg_line_insts();
   });
 
   if (!get_module()->trailing_dbg_line_info().empty()) {
@@ -23,19 +23,63 @@ constexpr uint32_t kMergeNodeIndex = 0;
 constexpr uint32_t kContinueNodeIndex = 1;
 }  // namespace
 
-StructuredCFGAnalysis::StructuredCFGAnalysis(IRContext* ctx) : context_(ctx) {
-  // If this is not a shader, there are no merge instructions, and not
-  // structured CFG to analyze.
-  if (!context_->get_feature_mgr()->HasCapability(spv::Capability::Shader)) {
+StructuredCFGAnalysis::StructuredCFGAnalysis(IRContext* ctx)
+    : context_(ctx),
+      // If this is not a shader, there are no merge instructions, and no
+      // structured CFG to analyze.
+      is_shader_(ctx->get_feature_mgr()->HasCapability(
+          spv::Capability::Shader)) {}
+
+void StructuredCFGAnalysis::InvalidateFunction(const Function* func) {
+  auto it = analyzed_funcs_.find(func);
+  if (it == analyzed_funcs_.end()) {
     return;
   }
 
-  for (auto& func : *context_->module()) {
-    AddBlocksInFunction(&func);
+  for (uint32_t block_id : it->second.block_ids) {
+    bb_to_construct_.erase(block_id);
   }
+  for (uint32_t merge_id : it->second.merge_block_ids) {
+    merge_blocks_.Clear(merge_id);
+  }
+  analyzed_funcs_.erase(it);
+}
+
+void StructuredCFGAnalysis::AnalyzeFunctionIfNeeded(Function* func) {
+  if (!is_shader_) {
+    return;
+  }
+
+  if (analyzed_funcs_.count(func) != 0) {
+    return;
+  }
+  AddBlocksInFunction(func);
+}
+
+const StructuredCFGAnalysis::ConstructInfo*
+StructuredCFGAnalysis::GetConstructInfo(uint32_t bb_id) {
+  auto it = bb_to_construct_.find(bb_id);
+  if (it == bb_to_construct_.end()) {
+    // The block's function may not have been analyzed yet.  Analyze it on
+    // demand, so that callers only pay for the functions they query.
+    BasicBlock* bb = context_->cfg()->LookupBlock(bb_id);
+    if (bb == nullptr || bb->GetParent() == nullptr) {
+      return nullptr;
+    }
+
+    AnalyzeFunctionIfNeeded(bb->GetParent());
+    it = bb_to_construct_.find(bb_id);
+    if (it == bb_to_construct_.end()) {
+      return nullptr;
+    }
+  }
+  return &it->second;
 }
 
 void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
+  // Mark |func| as analyzed even if it has no blocks, so that it is not
+  // traversed again until it is invalidated.
+  FunctionRecord& record = analyzed_funcs_[func];
   if (func->begin() == func->end()) return;
 
   std::list<BasicBlock*> order;
@@ -73,7 +117,11 @@ void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
       state.back().cinfo.in_continue = true;
     }
 
-    bb_to_construct_.emplace(std::make_pair(block->id(), state.back().cinfo));
+    if (bb_to_construct_
+            .emplace(std::make_pair(block->id(), state.back().cinfo))
+            .second) {
+      record.block_ids.push_back(block->id());
+    }
 
     if (Instruction* merge_inst = block->GetMergeInst()) {
       TraversalInfo new_state;
@@ -107,6 +155,7 @@ void StructuredCFGAnalysis::AddBlocksInFunction(Function* func) {
 
       state.emplace_back(new_state);
       merge_blocks_.Set(new_state.merge_node);
+      record.merge_block_ids.push_back(new_state.merge_node);
     }
   }
 }
@@ -193,11 +242,8 @@ bool StructuredCFGAnalysis::IsContinueBlock(uint32_t bb_id) {
 
 bool StructuredCFGAnalysis::IsInContainingLoopsContinueConstruct(
     uint32_t bb_id) {
-  auto it = bb_to_construct_.find(bb_id);
-  if (it == bb_to_construct_.end()) {
-    return false;
-  }
-  return it->second.in_continue;
+  const ConstructInfo* info = GetConstructInfo(bb_id);
+  return info ? info->in_continue : false;
 }
 
 bool StructuredCFGAnalysis::IsInContinueConstruct(uint32_t bb_id) {
@@ -211,6 +257,9 @@ bool StructuredCFGAnalysis::IsInContinueConstruct(uint32_t bb_id) {
 }
 
 bool StructuredCFGAnalysis::IsMergeBlock(uint32_t bb_id) {
+  // Make sure the function containing |bb_id| has been analyzed, so that
+  // |merge_blocks_| covers it.
+  GetConstructInfo(bb_id);
   return merge_blocks_.Get(bb_id);
 }
 
@@ -222,6 +271,7 @@ StructuredCFGAnalysis::FindFuncsCalledFromContinue() {
   // First collect the functions that are called directly from a continue
   // construct.
   for (Function& func : *context_->module()) {
+    AnalyzeFunctionIfNeeded(&func);
     for (auto& bb : func) {
       if (IsInContainingLoopsContinueConstruct(bb.id())) {
         for (const Instruction& inst : bb) {
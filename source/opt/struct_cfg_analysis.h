@@ -17,6 +17,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "source/opt/function.h"
 #include "source/util/bit_vector.h"
@@ -28,19 +29,27 @@ class IRContext;
 
 // An analysis that, for each basic block, finds the constructs in which it is
 // contained, so we can easily get headers and merge nodes.
+//
+// The analysis is built one function at a time, on demand: querying a block
+// analyzes only the function that contains it.  A single function's cached
+// information can be dropped with |InvalidateFunction| and will be recomputed
+// the next time one of its blocks is queried, so transformations that change
+// one function do not force the whole module to be re-analyzed.
 class StructuredCFGAnalysis {
  public:
   explicit StructuredCFGAnalysis(IRContext* ctx);
 
+  // Drops the cached information for |func|.  The function will be
+  // re-analyzed the next time one of its blocks is queried.  This is cheaper
+  // than invalidating |kAnalysisStructuredCFG|, which drops every function.
+  void InvalidateFunction(const Function* func);
+
   // Returns the id of the header of the innermost merge construct
   // that contains |bb_id|.  Returns |0| if |bb_id| is not contained in any
   // merge construct.
   uint32_t ContainingConstruct(uint32_t bb_id) {
-    auto it = bb_to_construct_.find(bb_id);
-    if (it == bb_to_construct_.end()) {
-      return 0;
-    }
-    return it->second.containing_construct;
+    const ConstructInfo* info = GetConstructInfo(bb_id);
+    return info ? info->containing_construct : 0;
   }
 
   // Returns the id of the header of the innermost merge construct
@@ -62,11 +71,8 @@ class StructuredCFGAnalysis {
   // that contains |bb_id|.  Return |0| if |bb_id| is not contained in any loop
   // construct.
   uint32_t ContainingLoop(uint32_t bb_id) {
-    auto it = bb_to_construct_.find(bb_id);
-    if (it == bb_to_construct_.end()) {
-      return 0;
-    }
-    return it->second.containing_loop;
+    const ConstructInfo* info = GetConstructInfo(bb_id);
+    return info ? info->containing_loop : 0;
   }
 
   // Returns the id of the merge block of the innermost loop construct
@@ -90,11 +96,8 @@ class StructuredCFGAnalysis {
   // that contains |bb_id| as long as there is no intervening loop.  Returns |0|
   // if no such construct exists.
   uint32_t ContainingSwitch(uint32_t bb_id) {
-    auto it = bb_to_construct_.find(bb_id);
-    if (it == bb_to_construct_.end()) {
-      return 0;
-    }
-    return it->second.containing_switch;
+    const ConstructInfo* info = GetConstructInfo(bb_id);
+    return info ? info->containing_switch : 0;
   }
   // Returns the id of the merge block of the innermost switch construct
   // that contains |bb_id| as long as there is no intervening loop.  Return |0|
@@ -143,16 +146,41 @@ class StructuredCFGAnalysis {
     bool in_continue;
   };
 
+  // The per-function records needed to invalidate a single function: the ids
+  // of the blocks it added to |bb_to_construct_| and the merge nodes it set in
+  // |merge_blocks_|.
+  struct FunctionRecord {
+    std::vector<uint32_t> block_ids;
+    std::vector<uint32_t> merge_block_ids;
+  };
+
   // Populates |bb_to_construct_| with the innermost containing merge and loop
   // constructs for each basic block in |func|.
   void AddBlocksInFunction(Function* func);
 
+  // Analyzes |func| if it has not been analyzed since it was last
+  // invalidated.
+  void AnalyzeFunctionIfNeeded(Function* func);
+
+  // Returns the construct information for |bb_id|, analyzing the function
+  // that contains the block if needed.  Returns nullptr if |bb_id| is not a
+  // known basic block or is not contained in any construct.
+  const ConstructInfo* GetConstructInfo(uint32_t bb_id);
+
   IRContext* context_;
 
+  // True if the module declares the Shader capability.  Otherwise there are
+  // no merge instructions, and no structured CFG to analyze.
+  bool is_shader_;
+
   // A map from a basic block to the headers of its inner most containing
   // constructs.
   std::unordered_map<uint32_t, ConstructInfo> bb_to_construct_;
   utils::BitVector merge_blocks_;
+
+  // The functions that have been analyzed, with the entries they contributed
+  // to |bb_to_construct_| and |merge_blocks_|.
+  std::unordered_map<const Function*, FunctionRecord> analyzed_funcs_;
 };
 
 }  // namespace opt
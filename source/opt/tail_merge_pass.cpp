@@ -0,0 +1,282 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/tail_merge_pass.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "source/opt/ir_context.h"
+#include "source/operand.h"
+#include "source/spirv_constant.h"
+#include "source/util/hash_combine.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+// Returns true if |opcode| ends the function outright, so a block it
+// terminates has no successors.
+bool IsFunctionEndingTerminator(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpReturn:
+    case spv::Op::OpReturnValue:
+    case spv::Op::OpUnreachable:
+    case spv::Op::OpKill:
+    case spv::Op::OpTerminateInvocation:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if |opcode| is a terminator whose targets may be redirected
+// to a surviving duplicate.
+bool IsBranchOpcode(spv::Op opcode) {
+  switch (opcode) {
+    case spv::Op::OpBranch:
+    case spv::Op::OpBranchConditional:
+    case spv::Op::OpSwitch:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+Pass::Status TailMergePass::Process() {
+  // Plan every merge against the unmodified module, then apply them all:
+  // tails have no successors, so one merge can never change whether
+  // another pair of tails matches.
+  std::vector<TailMerge> merges;
+  std::vector<Function*> touched;
+  for (Function& func : *get_module()) {
+    const size_t merges_before = merges.size();
+    CollectMerges(&func, &merges);
+    if (merges.size() > merges_before) touched.push_back(&func);
+  }
+  if (merges.empty()) return Status::SuccessWithoutChange;
+
+  // The rewrites change branch targets, so drop the control-flow analyses
+  // now instead of updating them piecemeal.
+  context()->InvalidateAnalyses(IRContext::kAnalysisCFG |
+                                IRContext::kAnalysisStructuredCFG);
+  for (const TailMerge& merge : merges) {
+    ApplyMerge(merge);
+  }
+  for (Function* func : touched) {
+    func->RemoveEmptyBlocks();
+  }
+  return Status::SuccessWithChange;
+}
+
+void TailMergePass::CollectMerges(Function* func,
+                                  std::vector<TailMerge>* merges) {
+  if (func->IsDeclaration()) return;
+
+  // Group candidate tails by fingerprint, remembering each one's innermost
+  // construct: merging across constructs would redirect a branch out of
+  // its construct, which structured control flow forbids.
+  StructuredCFGAnalysis* struct_cfg = context()->GetStructuredCFGAnalysis();
+  std::unordered_map<uint64_t, std::vector<std::pair<BasicBlock*, uint32_t>>>
+      buckets;
+  bool is_entry_block = true;
+  for (BasicBlock& block : *func) {
+    if (is_entry_block) {
+      // The entry block is never a branch target.
+      is_entry_block = false;
+      continue;
+    }
+    if (!IsMergeableTail(&block)) continue;
+    buckets[TailFingerprint(&block)].push_back(
+        {&block, struct_cfg->ContainingConstruct(block.id())});
+  }
+
+  // SPIR-V 1.6 forbids OpBranchConditional from naming the same label as
+  // both targets, so from that version on a merge must not leave such a
+  // branch behind.  |redirects| accumulates the merges already planned for
+  // this function so the check sees the branch targets as they will be
+  // after rewriting.
+  const bool forbid_identical_targets =
+      get_module()->version() >= SPV_SPIRV_VERSION_WORD(1, 6);
+  std::unordered_map<uint32_t, uint32_t> redirects;
+  for (auto& bucket : buckets) {
+    auto& tails = bucket.second;
+    if (tails.size() < 2) continue;
+    std::vector<bool> consumed(tails.size(), false);
+    for (size_t i = 0; i < tails.size(); ++i) {
+      if (consumed[i]) continue;
+      for (size_t j = i + 1; j < tails.size(); ++j) {
+        if (consumed[j]) continue;
+        if (tails[j].second != tails[i].second) continue;
+        if (!IsRemovableTail(tails[j].first)) continue;
+        if (!TailsMatch(tails[i].first, tails[j].first)) continue;
+        if (forbid_identical_targets &&
+            WouldCreateIdenticalConditionalTargets(
+                tails[j].first, tails[i].first->id(), redirects)) {
+          continue;
+        }
+        merges->push_back({tails[j].first, tails[i].first->id()});
+        redirects[tails[j].first->id()] = tails[i].first->id();
+        consumed[j] = true;
+      }
+    }
+  }
+}
+
+bool TailMergePass::WouldCreateIdenticalConditionalTargets(
+    BasicBlock* victim, uint32_t survivor_id,
+    const std::unordered_map<uint32_t, uint32_t>& redirects) const {
+  const auto final_target = [&redirects, victim,
+                             survivor_id](uint32_t label) {
+    if (label == victim->id()) return survivor_id;
+    auto redirected = redirects.find(label);
+    return redirected != redirects.end() ? redirected->second : label;
+  };
+  return !get_def_use_mgr()->WhileEachUser(
+      victim->id(), [&final_target](Instruction* user) {
+        if (user->opcode() != spv::Op::OpBranchConditional) return true;
+        return final_target(user->GetSingleWordInOperand(1)) !=
+               final_target(user->GetSingleWordInOperand(2));
+      });
+}
+
+bool TailMergePass::IsMergeableTail(BasicBlock* block) const {
+  if (!IsFunctionEndingTerminator(block->terminator()->opcode())) {
+    return false;
+  }
+  if (block->begin() != block->end() &&
+      block->begin()->opcode() == spv::Op::OpPhi) {
+    return false;
+  }
+  // Every value the tail defines must be used only inside it; otherwise
+  // removing a duplicate would strand the use.
+  for (Instruction& inst : *block) {
+    if (inst.result_id() == 0) continue;
+    const bool only_local_users = get_def_use_mgr()->WhileEachUser(
+        inst.result_id(), [this, block](Instruction* user) {
+          return context()->get_instr_block(user) == block;
+        });
+    if (!only_local_users) return false;
+  }
+  return true;
+}
+
+bool TailMergePass::IsRemovableTail(BasicBlock* block) const {
+  // The label may only be referenced as a branch target or by a name: a
+  // tail that also serves as a merge target must stay in place.
+  return get_def_use_mgr()->WhileEachUser(
+      block->id(), [](Instruction* user) {
+        return IsBranchOpcode(user->opcode()) ||
+               user->opcode() == spv::Op::OpName;
+      });
+}
+
+uint64_t TailMergePass::TailFingerprint(BasicBlock* block) const {
+  std::unordered_map<uint32_t, uint32_t> local_ids;
+  uint64_t fingerprint = 0xcbf29ce484222325ull;
+  for (Instruction& inst : *block) {
+    fingerprint = utils::hash_combine(fingerprint,
+                                      static_cast<uint32_t>(inst.opcode()),
+                                      inst.type_id(), inst.NumInOperands());
+    for (uint32_t i = 0; i < inst.NumInOperands(); ++i) {
+      const Operand& operand = inst.GetInOperand(i);
+      if (spvIsInIdType(operand.type)) {
+        auto local = local_ids.find(operand.words[0]);
+        // Ids defined by the tail itself hash as their definition order so
+        // that identical tails with different ids collide.
+        fingerprint = utils::hash_combine(
+            fingerprint,
+            local != local_ids.end() ? 0x80000000u | local->second
+                                     : operand.words[0]);
+      } else {
+        for (uint32_t word : operand.words) {
+          fingerprint = utils::hash_combine(fingerprint, word);
+        }
+      }
+    }
+    if (inst.result_id() != 0) {
+      local_ids[inst.result_id()] =
+          static_cast<uint32_t>(local_ids.size());
+    }
+  }
+  return fingerprint;
+}
+
+bool TailMergePass::TailsMatch(BasicBlock* a, BasicBlock* b) const {
+  // Maps each result id defined by |a| to the id defined at the same
+  // position in |b|.
+  std::unordered_map<uint32_t, uint32_t> id_map;
+  auto a_iter = a->begin();
+  auto b_iter = b->begin();
+  for (; a_iter != a->end() && b_iter != b->end(); ++a_iter, ++b_iter) {
+    if (a_iter->opcode() != b_iter->opcode() ||
+        a_iter->type_id() != b_iter->type_id() ||
+        a_iter->NumInOperands() != b_iter->NumInOperands() ||
+        (a_iter->result_id() == 0) != (b_iter->result_id() == 0)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < a_iter->NumInOperands(); ++i) {
+      const Operand& a_operand = a_iter->GetInOperand(i);
+      const Operand& b_operand = b_iter->GetInOperand(i);
+      if (a_operand.type != b_operand.type) return false;
+      if (spvIsInIdType(a_operand.type)) {
+        const uint32_t a_id = a_operand.words[0];
+        const uint32_t b_id = b_operand.words[0];
+        auto mapped = id_map.find(a_id);
+        if (mapped != id_map.end()) {
+          // A use of a value defined by |a| must line up with the
+          // corresponding value defined by |b|.
+          if (mapped->second != b_id) return false;
+        } else if (a_id != b_id) {
+          // Ids defined outside the tails must be identical.
+          return false;
+        }
+      } else {
+        if (a_operand.words.size() != b_operand.words.size() ||
+            !std::equal(a_operand.words.begin(), a_operand.words.end(),
+                        b_operand.words.begin())) {
+          return false;
+        }
+      }
+    }
+    if (a_iter->result_id() != 0) {
+      id_map[a_iter->result_id()] = b_iter->result_id();
+    }
+  }
+  return a_iter == a->end() && b_iter == b->end();
+}
+
+void TailMergePass::ApplyMerge(const TailMerge& merge) {
+  const uint32_t victim_id = merge.victim->id();
+  context()->ReplaceAllUsesWithPredicate(
+      victim_id, merge.survivor_id,
+      [](Instruction* user) { return IsBranchOpcode(user->opcode()); });
+  context()->KillNamesAndDecorates(victim_id);
+
+  // Kill the tail's instructions, then its label; RemoveEmptyBlocks sweeps
+  // the emptied block.
+  std::vector<Instruction*> to_kill;
+  for (Instruction& inst : *merge.victim) {
+    to_kill.push_back(&inst);
+  }
+  for (Instruction* inst : to_kill) {
+    context()->KillInst(inst);
+  }
+  context()->KillInst(merge.victim->GetLabelInst());
+}
+
+}  // namespace opt
+}  // namespace spvtools
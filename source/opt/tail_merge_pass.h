@@ -0,0 +1,98 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_TAIL_MERGE_PASS_H_
+#define SOURCE_OPT_TAIL_MERGE_PASS_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "source/opt/basic_block.h"
+#include "source/opt/function.h"
+#include "source/opt/pass.h"
+
+namespace spvtools {
+namespace opt {
+
+// Merges duplicated tail blocks.  Switch-heavy shaders frequently end many
+// case constructs in near-identical tails; BlockMergePass only merges
+// straight-line pairs, so those duplicates survive every other pass.
+//
+// Two blocks are merged when they end the function (OpReturn,
+// OpReturnValue, OpUnreachable, OpKill, or OpTerminateInvocation), contain
+// no OpPhi, define no values used outside themselves, lie in the same
+// innermost structured construct (so redirected branches do not jump
+// between constructs), and their instruction streams are identical once the
+// blocks' own result ids are matched positionally.  Branches to the
+// duplicate are redirected to the surviving block and the duplicate is
+// removed, along with its names and decorations; any debug line
+// information unique to the duplicate is lost.
+//
+// This is primarily a code-size reduction: drivers compile the
+// deduplicated module faster and instruction caches see one tail instead
+// of many.
+class TailMergePass : public Pass {
+ public:
+  const char* name() const override { return "tail-merge"; }
+  Status Process() override;
+
+ private:
+  // A planned merge: every branch to |victim| is redirected to the block
+  // labelled |survivor_id|, then |victim| is removed.
+  struct TailMerge {
+    BasicBlock* victim;
+    uint32_t survivor_id;
+  };
+
+  // Appends to |merges| one entry per duplicated tail block of |func|,
+  // using only analyses of the unmodified function.
+  void CollectMerges(Function* func, std::vector<TailMerge>* merges);
+
+  // Returns true if |block| is a tail that may be merged with an identical
+  // one: it ends the function, has no OpPhi, and defines no values used
+  // outside itself.
+  bool IsMergeableTail(BasicBlock* block) const;
+
+  // Returns true if |block| may be removed once its branches are
+  // redirected, i.e. its label has no uses other than branch targets,
+  // names, and decorations.
+  bool IsRemovableTail(BasicBlock* block) const;
+
+  // Returns true if redirecting the branches of |victim| to |survivor_id|
+  // would leave an OpBranchConditional with the same label as both targets,
+  // which SPIR-V 1.6 forbids.  |redirects| holds the victim-to-survivor
+  // redirections already planned for the function, so targets are compared
+  // as they will be after all rewrites.
+  bool WouldCreateIdenticalConditionalTargets(
+      BasicBlock* victim, uint32_t survivor_id,
+      const std::unordered_map<uint32_t, uint32_t>& redirects) const;
+
+  // Returns a fingerprint of |block|'s instruction stream with the block's
+  // own result ids replaced by their definition order, so identical tails
+  // with different ids collide.
+  uint64_t TailFingerprint(BasicBlock* block) const;
+
+  // Returns true if |a| and |b| contain the same instruction stream once
+  // |a|'s result ids are matched positionally with |b|'s.
+  bool TailsMatch(BasicBlock* a, BasicBlock* b) const;
+
+  // Redirects every branch to |merge.victim| and removes the block's
+  // instructions, leaving an empty block for RemoveEmptyBlocks.
+  void ApplyMerge(const TailMerge& merge);
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_TAIL_MERGE_PASS_H_
@@ -56,14 +56,16 @@ struct HashTypeUniquePointer {
 struct CompareTypePointers {
   bool operator()(const Type* lhs, const Type* rhs) const {
     assert(lhs && rhs);
-    return lhs->IsSame(rhs);
+    // Registered types are canonical: probes with a pointer owned by the type
+    // pool match on identity without a deep traversal.
+    return lhs == rhs || lhs->IsSame(rhs);
   }
 };
 struct CompareTypeUniquePointers {
   bool operator()(const std::unique_ptr<Type>& lhs,
                   const std::unique_ptr<Type>& rhs) const {
     assert(lhs && rhs);
-    return lhs->IsSame(rhs.get());
+    return lhs.get() == rhs.get() || lhs->IsSame(rhs.get());
   }
 };
 
@@ -243,8 +243,14 @@ size_t Type::ComputeHashValue(size_t hash, SeenTypes* seen) const {
 }
 
 size_t Type::HashValue() const {
-  SeenTypes seen;
-  return ComputeHashValue(0, &seen);
+  // Type pointers are hashed on every probe of the type pool and the
+  // type-to-id map, so cache the deep traversal.  A computed hash of 0 is
+  // indistinguishable from "not computed" and is simply recomputed.
+  if (cached_hash_value_ == 0) {
+    SeenTypes seen;
+    cached_hash_value_ = ComputeHashValue(0, &seen);
+  }
+  return cached_hash_value_;
 }
 
 uint64_t Type::NumberOfComponents() const {
@@ -498,6 +504,7 @@ void Struct::AddMemberDecoration(uint32_t index,
   }
 
   element_decorations_[index].push_back(std::move(decoration));
+  InvalidateHashValue();
 }
 
 bool Struct::IsSameImpl(const Type* that, IsSameCache* seen) const {
@@ -589,7 +596,10 @@ size_t Pointer::ComputeExtraStateHash(size_t hash, SeenTypes* seen) const {
   return pointee_type_->ComputeHashValue(hash, seen);
 }
 
-void Pointer::SetPointeeType(const Type* type) { pointee_type_ = type; }
+void Pointer::SetPointeeType(const Type* type) {
+  pointee_type_ = type;
+  InvalidateHashValue();
+}
 
 Function::Function(const Type* ret_type, const std::vector<const Type*>& params)
     : Type(kFunction), return_type_(ret_type), param_types_(params) {}
@@ -627,7 +637,10 @@ size_t Function::ComputeExtraStateHash(size_t hash, SeenTypes* seen) const {
   return return_type_->ComputeHashValue(hash, seen);
 }
 
-void Function::SetReturnType(const Type* type) { return_type_ = type; }
+void Function::SetReturnType(const Type* type) {
+  return_type_ = type;
+  InvalidateHashValue();
+}
 
 bool Pipe::IsSameImpl(const Type* that, IsSameCache*) const {
   const Pipe* pt = that->AsPipe();
@@ -112,6 +112,7 @@ class Type {
   // Attaches a decoration directly on this type.
   void AddDecoration(std::vector<uint32_t>&& d) {
     decorations_.push_back(std::move(d));
+    InvalidateHashValue();
   }
   // Returns the decorations on this type as a string.
   std::string GetDecorationStr() const;
@@ -161,7 +162,8 @@ class Type {
 
   bool operator==(const Type& other) const;
 
-  // Returns the hash value of this type.
+  // Returns the hash value of this type.  The value is computed once and
+  // cached; mutations that change the hash must call |InvalidateHashValue|.
   size_t HashValue() const;
 
   size_t ComputeHashValue(size_t hash, SeenTypes* seen) const;
@@ -209,6 +211,11 @@ protected:
   // Add any type-specific state to |hash| and returns new hash.
   virtual size_t ComputeExtraStateHash(size_t hash, SeenTypes* seen) const = 0;
 
+  // Drops the cached hash value.  Every mutation that changes the hash of the
+  // type must call this, so that |HashValue| recomputes the value on the next
+  // request.
+  void InvalidateHashValue() { cached_hash_value_ = 0; }
+
  protected:
   // Decorations attached to this type. Each decoration is encoded as a vector
   // of uint32_t numbers. The first uint32_t number is the decoration value,
@@ -218,9 +225,15 @@ protected:
  private:
   // Removes decorations on this type. For struct types, also removes element
   // decorations.
-  virtual void ClearDecorations() { decorations_.clear(); }
+  virtual void ClearDecorations() {
+    decorations_.clear();
+    InvalidateHashValue();
+  }
 
   Kind kind_;
+
+  // Cached result of |HashValue|; 0 means the hash has not been computed yet.
+  mutable size_t cached_hash_value_ = 0;
 };
 // clang-format on
 
@@ -465,6 +478,7 @@ class Struct : public Type {
   void ClearDecorations() override {
     decorations_.clear();
     element_decorations_.clear();
+    InvalidateHashValue();
   }
 
   std::vector<const Type*> element_types_;
@@ -576,7 +590,10 @@ class ForwardPointer : public Type {
   ForwardPointer(const ForwardPointer&) = default;
 
   uint32_t target_id() const { return target_id_; }
-  void SetTargetPointer(const Pointer* pointer) { pointer_ = pointer; }
+  void SetTargetPointer(const Pointer* pointer) {
+    pointer_ = pointer;
+    InvalidateHashValue();
+  }
   spv::StorageClass storage_class() const { return storage_class_; }
   const Pointer* target_pointer() const { return pointer_; }
 
@@ -15,6 +15,7 @@
 #include "source/opt/value_number_table.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "source/opt/cfg.h"
 #include "source/opt/ir_context.h"
@@ -26,19 +27,22 @@ uint32_t ValueNumberTable::GetValueNumber(Instruction* inst) const {
   assert(inst->result_id() != 0 &&
          "inst must have a result id to get a value number.");
 
-  // Check if this instruction already has a value.
-  auto result_id_to_val = id_to_value_.find(inst->result_id());
-  if (result_id_to_val != id_to_value_.end()) {
-    return result_id_to_val->second;
-  }
-  return 0;
+  return ValueForId(inst->result_id());
 }
 
 uint32_t ValueNumberTable::GetValueNumber(uint32_t id) const {
-  return GetValueNumber(context()->get_def_use_mgr()->GetDef(id));
+  return ValueForId(id);
+}
+
+void ValueNumberTable::SetValueForId(uint32_t id, uint32_t value) {
+  if (id >= id_to_value_.size()) {
+    id_to_value_.resize(std::max<size_t>(id + 1, 2 * id_to_value_.size()), 0);
+  }
+  id_to_value_[id] = value;
 }
 
-uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
+uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst,
+                                             InstructionValueTable* table) {
   // If it already has a value return that.
   uint32_t value = GetValueNumber(inst);
   if (value != 0) {
@@ -52,7 +56,7 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
   if (!context()->IsCombinatorInstruction(inst) &&
       !inst->IsCommonDebugInstr()) {
     value = TakeNextValueNumber();
-    id_to_value_[inst->result_id()] = value;
+    SetValueForId(inst->result_id(), value);
     return value;
   }
 
@@ -61,7 +65,7 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
     case spv::Op::OpImage:
     case spv::Op::OpVariable:
       value = TakeNextValueNumber();
-      id_to_value_[inst->result_id()] = value;
+      SetValueForId(inst->result_id(), value);
       return value;
     default:
       break;
@@ -75,7 +79,7 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
   // will have to add a new case for volatile loads.
   if (inst->IsLoad() && !inst->IsReadOnlyLoad()) {
     value = TakeNextValueNumber();
-    id_to_value_[inst->result_id()] = value;
+    SetValueForId(inst->result_id(), value);
     return value;
   }
 
@@ -87,7 +91,7 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
                                       inst->GetSingleWordInOperand(0))) {
     value = GetValueNumber(inst->GetSingleWordInOperand(0));
     if (value != 0) {
-      id_to_value_[inst->result_id()] = value;
+      SetValueForId(inst->result_id(), value);
       return value;
     }
   }
@@ -106,7 +110,7 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
         }
       }
       if (value != 0) {
-        id_to_value_[inst->result_id()] = value;
+        SetValueForId(inst->result_id(), value);
         return value;
       }
     }
@@ -120,9 +124,9 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
     const Operand& op = inst->GetInOperand(o);
     if (spvIsIdType(op.type)) {
       uint32_t id_value = op.words[0];
-      auto use_id_to_val = id_to_value_.find(id_value);
-      if (use_id_to_val != id_to_value_.end()) {
-        id_value = (1 << 31) | use_id_to_val->second;
+      uint32_t operand_value = ValueForId(id_value);
+      if (operand_value != 0) {
+        id_value = (1 << 31) | operand_value;
       }
       value_ins.AddOperand(Operand(op.type, {id_value}));
     } else {
@@ -134,21 +138,39 @@ uint32_t ValueNumberTable::AssignValueNumber(Instruction* inst) {
   // addition.  This will let us know that a+b is the same value as b+a.
 
   // Otherwise, we check if this value has been computed before.
-  auto value_iterator = instruction_to_value_.find(value_ins);
-  if (value_iterator != instruction_to_value_.end()) {
-    value = id_to_value_[value_iterator->first.result_id()];
-    id_to_value_[inst->result_id()] = value;
+  auto value_iterator = table->find(value_ins);
+  if (value_iterator != table->end()) {
+    value = ValueForId(value_iterator->first.result_id());
+    SetValueForId(inst->result_id(), value);
     return value;
   }
 
   // If not, assign it a new value number.
   value = TakeNextValueNumber();
-  id_to_value_[inst->result_id()] = value;
-  instruction_to_value_[value_ins] = value;
+  SetValueForId(inst->result_id(), value);
+  (*table)[value_ins] = value;
   return value;
 }
 
+void ValueNumberTable::NumberSingleBlockFunction(BasicBlock* block) {
+  // Straight-line code is numbered against a table local to the function, so
+  // the hot expression lookups stay in a small, cache-friendly table instead
+  // of the one covering the whole module.
+  InstructionValueTable local_table;
+  for (Instruction& inst : *block) {
+    if (inst.result_id() != 0) {
+      AssignValueNumber(&inst, &local_table);
+    }
+  }
+  // Splice the new entries into the shared table so that later functions and
+  // instructions added through |AddInstruction| still deduplicate against
+  // these expressions.  This moves nodes without rehashing the values.
+  instruction_to_value_.merge(local_table);
+}
+
 void ValueNumberTable::BuildDominatorTreeValueNumberTable() {
+  id_to_value_.resize(context()->module()->IdBound(), 0);
+
   // First value number the headers.
   for (auto& inst : context()->annotations()) {
     if (inst.result_id() != 0) {
@@ -181,6 +203,12 @@ void ValueNumberTable::BuildDominatorTreeValueNumberTable() {
   }
 
   for (Function& func : *context()->module()) {
+    // Single-block functions, which dominate post-inlining modules, take the
+    // straight-line fast path.
+    if (!func.IsDeclaration() && std::next(func.begin()) == func.end()) {
+      NumberSingleBlockFunction(&*func.begin());
+      continue;
+    }
     // For best results we want to traverse the code in reverse post order.
     // This happens naturally because of the forward referencing rules.
     for (BasicBlock& block : func) {
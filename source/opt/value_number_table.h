@@ -17,12 +17,14 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 #include "source/opt/instruction.h"
 
 namespace spvtools {
 namespace opt {
 
+class BasicBlock;
 class IRContext;
 
 // Returns true if the two instructions compute the same value.  Used by the
@@ -49,8 +51,20 @@ class ValueTableHash {
 // The main difference is that because we do not perform redundancy elimination
 // as we build the value number table, we do not have to deal with cleaning up
 // the scope.
+//
+// Value numbers are assigned densely starting at 1, so they can be used as
+// direct indices into an array of |NumValueNumbers()| entries.  The table can
+// be maintained as code is added: IRContext::AnalyzeDefUse numbers every new
+// instruction through |AddInstruction|, so inserting instructions does not
+// force a rebuild of the analysis.
 class ValueNumberTable {
  public:
+  // The hash table mapping expressions (instructions with their id operands
+  // replaced by value numbers) to their value number.
+  using InstructionValueTable =
+      std::unordered_map<Instruction, uint32_t, ValueTableHash,
+                         ComputeSameValue>;
+
   ValueNumberTable(IRContext* ctx) : context_(ctx), next_value_number_(1) {
     BuildDominatorTreeValueNumberTable();
   }
@@ -64,6 +78,18 @@ class ValueNumberTable {
   // has not been assigned a value number.
   uint32_t GetValueNumber(uint32_t id) const;
 
+  // Assigns a value number to |inst|, which must have a result id, and
+  // returns it.  If the result id already has a value number, that number is
+  // returned unchanged.  IRContext calls this when a new instruction is
+  // registered with the valid analyses, so that adding code keeps the table
+  // up to date.
+  uint32_t AddInstruction(Instruction* inst) { return AssignValueNumber(inst); }
+
+  // Returns one past the largest value number assigned so far.  Value numbers
+  // are dense, starting at 1, so this is the size an array must have to be
+  // indexed by value number.
+  uint32_t NumValueNumbers() const { return next_value_number_; }
+
   IRContext* context() const { return context_; }
 
  private:
@@ -73,14 +99,41 @@ class ValueNumberTable {
   // Returns the new value number.
   uint32_t TakeNextValueNumber() { return next_value_number_++; }
 
+  // Numbers the body of a single-block function in one linear scan.  The
+  // expressions are deduplicated against a table local to |block|, which is
+  // then spliced into the shared table so that later functions and
+  // incrementally added instructions still match them.  Keeping the hot
+  // lookups in a table sized to the function rather than the whole module is
+  // a significant win on post-inlining modules, where most functions have a
+  // single block.
+  void NumberSingleBlockFunction(BasicBlock* block);
+
   // Assigns a new value number to the result of |inst| if it does not already
   // have one.  Return the value number for |inst|.  |inst| must have a result
   // id.
-  uint32_t AssignValueNumber(Instruction* inst);
+  uint32_t AssignValueNumber(Instruction* inst) {
+    return AssignValueNumber(inst, &instruction_to_value_);
+  }
+
+  // Same as above, deduplicating expressions against |table| instead of the
+  // shared table.
+  uint32_t AssignValueNumber(Instruction* inst, InstructionValueTable* table);
+
+  // Returns the value number held by |id|, or 0 if it has not been assigned
+  // one yet.
+  uint32_t ValueForId(uint32_t id) const {
+    return id < id_to_value_.size() ? id_to_value_[id] : 0;
+  }
+
+  // Records |value| as the value number of |id|, growing the table if needed.
+  void SetValueForId(uint32_t id, uint32_t value);
 
-  std::unordered_map<Instruction, uint32_t, ValueTableHash, ComputeSameValue>
-      instruction_to_value_;
-  std::unordered_map<uint32_t, uint32_t> id_to_value_;
+  InstructionValueTable instruction_to_value_;
+  // The value number of each result id, indexed by id.  Ids at or beyond the
+  // end of the vector have not been assigned a number.  A plain array rather
+  // than a map because it is consulted for every id operand of every
+  // instruction that gets numbered.
+  std::vector<uint32_t> id_to_value_;
   IRContext* context_;
   uint32_t next_value_number_;
 };
@@ -33,14 +33,14 @@ Pass::Status VectorDCE::Process() {
 }
 
 bool VectorDCE::VectorDCEFunction(Function* function) {
-  LiveComponentMap live_components;
+  LiveComponentMap live_components(scratch());
   FindLiveComponents(function, &live_components);
   return RewriteInstructions(function, live_components);
 }
 
 void VectorDCE::FindLiveComponents(Function* function,
                                    LiveComponentMap* live_components) {
-  std::vector<WorkListItem> work_list;
+  WorkList work_list(scratch());
 
   // Prime the work list.  We will assume that any instruction that does
   // not result in a vector is live.
@@ -96,7 +96,7 @@ void VectorDCE::FindLiveComponents(Function* function,
 void VectorDCE::MarkExtractUseAsLive(const Instruction* current_inst,
                                      const utils::BitVector& live_elements,
                                      LiveComponentMap* live_components,
-                                     std::vector<WorkListItem>* work_list) {
+                                     WorkList* work_list) {
   analysis::DefUseManager* def_use_mgr = context()->get_def_use_mgr();
   uint32_t operand_id =
       current_inst->GetSingleWordInOperand(kExtractCompositeIdInIdx);
@@ -121,7 +121,7 @@ void VectorDCE::MarkExtractUseAsLive(const Instruction* current_inst,
 void VectorDCE::MarkInsertUsesAsLive(
     const VectorDCE::WorkListItem& current_item,
     LiveComponentMap* live_components,
-    std::vector<VectorDCE::WorkListItem>* work_list) {
+    VectorDCE::WorkList* work_list) {
   analysis::DefUseManager* def_use_mgr = context()->get_def_use_mgr();
 
   if (current_item.instruction->NumInOperands() > 2) {
@@ -168,7 +168,7 @@ void VectorDCE::MarkInsertUsesAsLive(
 void VectorDCE::MarkVectorShuffleUsesAsLive(
     const WorkListItem& current_item,
     VectorDCE::LiveComponentMap* live_components,
-    std::vector<WorkListItem>* work_list) {
+    WorkList* work_list) {
   analysis::DefUseManager* def_use_mgr = context()->get_def_use_mgr();
 
   WorkListItem first_operand;
@@ -202,7 +202,7 @@ void VectorDCE::MarkVectorShuffleUsesAsLive(
 void VectorDCE::MarkCompositeContructUsesAsLive(
     VectorDCE::WorkListItem work_item,
     VectorDCE::LiveComponentMap* live_components,
-    std::vector<VectorDCE::WorkListItem>* work_list) {
+    VectorDCE::WorkList* work_list) {
   analysis::DefUseManager* def_use_mgr = context()->get_def_use_mgr();
 
   uint32_t current_component = 0;
@@ -240,7 +240,7 @@ void VectorDCE::MarkCompositeContructUsesAsLive(
 void VectorDCE::MarkUsesAsLive(
     Instruction* current_inst, const utils::BitVector& live_elements,
     LiveComponentMap* live_components,
-    std::vector<VectorDCE::WorkListItem>* work_list) {
+    VectorDCE::WorkList* work_list) {
   analysis::DefUseManager* def_use_mgr = context()->get_def_use_mgr();
 
   current_inst->ForEachInId([&work_list, &live_elements, this, live_components,
@@ -413,7 +413,7 @@ void VectorDCE::MarkDebugValueUsesAsDead(
 
 void VectorDCE::AddItemToWorkListIfNeeded(
     WorkListItem work_item, VectorDCE::LiveComponentMap* live_components,
-    std::vector<WorkListItem>* work_list) {
+    WorkList* work_list) {
   Instruction* current_inst = work_item.instruction;
   auto it = live_components->find(current_inst->result_id());
   if (it == live_components->end()) {
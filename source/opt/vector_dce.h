@@ -20,13 +20,16 @@
 
 #include "source/opt/mem_pass.h"
 #include "source/util/bit_vector.h"
+#include "source/util/scratch_arena.h"
 
 namespace spvtools {
 namespace opt {
 
 class VectorDCE : public MemPass {
  private:
-  using LiveComponentMap = std::unordered_map<uint32_t, utils::BitVector>;
+  // The component-liveness map and worklist are rebuilt for every function,
+  // so they draw from the pass's scratch arena (see Pass::scratch()).
+  using LiveComponentMap = utils::ScratchMap<uint32_t, utils::BitVector>;
 
   // According to the SPEC the maximum size for a vector is 16.  See the data
   // rules in the universal validation rules (section 2.16.1).
@@ -39,6 +42,8 @@ class VectorDCE : public MemPass {
     utils::BitVector components;
   };
 
+  using WorkList = utils::ScratchVector<WorkListItem>;
+
  public:
   VectorDCE() : all_components_live_(kMaxVectorSize) {
     for (uint32_t i = 0; i < kMaxVectorSize; i++) {
@@ -108,7 +113,7 @@ class VectorDCE : public MemPass {
   // |work_item| is now live.
   void AddItemToWorkListIfNeeded(WorkListItem work_item,
                                  LiveComponentMap* live_components,
-                                 std::vector<WorkListItem>* work_list);
+                                 WorkList* work_list);
 
   // Marks the components |live_elements| of the uses in |current_inst| as live
   // according to |live_components|. If they were not live before, then they are
@@ -116,7 +121,7 @@ class VectorDCE : public MemPass {
   void MarkUsesAsLive(Instruction* current_inst,
                       const utils::BitVector& live_elements,
                       LiveComponentMap* live_components,
-                      std::vector<WorkListItem>* work_list);
+                      WorkList* work_list);
 
   // Marks the uses in the OpVectorShuffle instruction in |current_item| as live
   // based on the live components in |current_item|. If anything becomes live
@@ -124,7 +129,7 @@ class VectorDCE : public MemPass {
   // accordingly.
   void MarkVectorShuffleUsesAsLive(const WorkListItem& current_item,
                                    VectorDCE::LiveComponentMap* live_components,
-                                   std::vector<WorkListItem>* work_list);
+                                   WorkList* work_list);
 
   // Marks the uses in the OpCompositeInsert instruction in |current_item| as
   // live based on the live components in |current_item|. If anything becomes
@@ -132,7 +137,7 @@ class VectorDCE : public MemPass {
   // accordingly.
   void MarkInsertUsesAsLive(const WorkListItem& current_item,
                             LiveComponentMap* live_components,
-                            std::vector<WorkListItem>* work_list);
+                            WorkList* work_list);
 
   // Marks the uses in the OpCompositeExtract instruction |current_inst| as
   // live. If anything becomes live they are added to |work_list| and
@@ -140,14 +145,14 @@ class VectorDCE : public MemPass {
   void MarkExtractUseAsLive(const Instruction* current_inst,
                             const utils::BitVector& live_elements,
                             LiveComponentMap* live_components,
-                            std::vector<WorkListItem>* work_list);
+                            WorkList* work_list);
 
   // Marks the uses in the OpCompositeConstruct instruction |current_inst| as
   // live. If anything becomes live they are added to |work_list| and
   // |live_components| is updated accordingly.
   void MarkCompositeContructUsesAsLive(WorkListItem work_item,
                                        LiveComponentMap* live_components,
-                                       std::vector<WorkListItem>* work_list);
+                                       WorkList* work_list);
 
   // A BitVector that can always be used to say that all components of a vector
   // are live.
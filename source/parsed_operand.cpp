@@ -17,9 +17,44 @@
 #include "source/parsed_operand.h"
 
 #include <cassert>
+#include "source/util/decimal_format.h"
 #include "source/util/hex_float.h"
 
 namespace spvtools {
+namespace {
+
+// Writes the decimal form of |value| to |out| with a single stream write,
+// bypassing the iostream numeric formatting machinery.
+template <typename T>
+void EmitDecimal(std::ostream* out, T value) {
+  char buffer[utils::kMaxDecimalChars];
+  const size_t num_chars = utils::FormatDecimal(value, buffer);
+  out->write(buffer, static_cast<std::streamsize>(num_chars));
+}
+
+// Writes |value| to |out| in the syntax the assembler accepts: zero and
+// normal values in decimal with enough digits to reproduce the value
+// exactly, other values (subnormal, NaN, and infinity) as a hex float.
+// This matches what streaming the FloatProxy would print, but formats the
+// common case without iostreams and independently of the global locale.
+template <typename T>
+void EmitFloat(std::ostream* out, utils::FloatProxy<T> value) {
+  const T float_value = value.getAsFloat();
+  switch (std::fpclassify(float_value)) {
+    case FP_ZERO:
+    case FP_NORMAL: {
+      char buffer[utils::kMaxDecimalChars];
+      const size_t num_chars = utils::FormatGeneralFloat(
+          float_value, std::numeric_limits<T>::max_digits10, buffer);
+      out->write(buffer, static_cast<std::streamsize>(num_chars));
+    } break;
+    default:
+      *out << utils::HexFloat<utils::FloatProxy<T>>(value);
+      break;
+  }
+}
+
+}  // namespace
 
 void EmitNumericLiteral(std::ostream* out, const spv_parsed_instruction_t& inst,
                         const spv_parsed_operand_t& operand) {
@@ -36,18 +71,19 @@ void EmitNumericLiteral(std::ostream* out, const spv_parsed_instruction_t& inst,
   if (operand.num_words == 1) {
     switch (operand.number_kind) {
       case SPV_NUMBER_SIGNED_INT:
-        *out << int32_t(word);
+        EmitDecimal(out, int64_t(int32_t(word)));
         break;
       case SPV_NUMBER_UNSIGNED_INT:
-        *out << word;
+        EmitDecimal(out, uint64_t(word));
         break;
       case SPV_NUMBER_FLOATING:
         if (operand.number_bit_width == 16) {
+          // 16-bit floats always print as a hex float.
           *out << spvtools::utils::FloatProxy<spvtools::utils::Float16>(
               uint16_t(word & 0xFFFF));
         } else {
           // Assume 32-bit floats.
-          *out << spvtools::utils::FloatProxy<float>(word);
+          EmitFloat(out, spvtools::utils::FloatProxy<float>(word));
         }
         break;
       default:
@@ -59,14 +95,14 @@ void EmitNumericLiteral(std::ostream* out, const spv_parsed_instruction_t& inst,
         uint64_t(word) | (uint64_t(inst.words[operand.offset + 1]) << 32);
     switch (operand.number_kind) {
       case SPV_NUMBER_SIGNED_INT:
-        *out << int64_t(bits);
+        EmitDecimal(out, int64_t(bits));
         break;
       case SPV_NUMBER_UNSIGNED_INT:
-        *out << bits;
+        EmitDecimal(out, bits);
         break;
       case SPV_NUMBER_FLOATING:
         // Assume only 64-bit floats.
-        *out << spvtools::utils::FloatProxy<double>(bits);
+        EmitFloat(out, spvtools::utils::FloatProxy<double>(bits));
         break;
       default:
         break;
@@ -30,6 +30,8 @@ class MergeBlocksReductionOpportunityFinder
 
   std::string GetName() const final;
 
+  Scope GetScope() const final { return Scope::kBlock; }
+
   std::vector<std::unique_ptr<ReductionOpportunity>> GetAvailableOpportunities(
       opt::IRContext* context, uint32_t target_function) const final;
 
@@ -14,6 +14,8 @@
 
 #include "source/reduce/reducer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <sstream>
 
@@ -31,9 +33,70 @@
 #include "source/reduce/structured_construct_to_block_reduction_opportunity_finder.h"
 #include "source/reduce/structured_loop_to_selection_reduction_opportunity_finder.h"
 #include "source/spirv_reducer_options.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace reduce {
+namespace {
+
+// Sizing for the tested-state cache: the Bloom filter spans 2^20 bits and
+// the exact LRU window holds the most recently tested states.
+constexpr size_t kBloomBits = size_t(1) << 20;
+constexpr size_t kLruCapacity = 4096;
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+// FNV-1a 64-bit hash of the binary's words, used to key the tested-state
+// cache.
+uint64_t HashBinary(const std::vector<uint32_t>& binary) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (uint32_t word : binary) {
+    for (int byte = 0; byte < 4; ++byte) {
+      hash = (hash ^ ((word >> (8 * byte)) & 0xffu)) * kFnvPrime;
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+Reducer::TestedStateCache::TestedStateCache() : bloom_(kBloomBits / 64, 0) {}
+
+bool Reducer::TestedStateCache::ProbablyTested(uint64_t hash) {
+  auto it = lru_index_.find(hash);
+  if (it != lru_index_.end()) {
+    // Exact hit; move it to the front of the window.
+    lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
+    return true;
+  }
+  const size_t bit1 = static_cast<uint32_t>(hash) % kBloomBits;
+  const size_t bit2 = static_cast<uint32_t>(hash >> 32) % kBloomBits;
+  return (bloom_[bit1 / 64] & (uint64_t(1) << (bit1 % 64))) != 0 &&
+         (bloom_[bit2 / 64] & (uint64_t(1) << (bit2 % 64))) != 0;
+}
+
+void Reducer::TestedStateCache::RecordUninteresting(uint64_t hash) {
+  const size_t bit1 = static_cast<uint32_t>(hash) % kBloomBits;
+  const size_t bit2 = static_cast<uint32_t>(hash >> 32) % kBloomBits;
+  bloom_[bit1 / 64] |= uint64_t(1) << (bit1 % 64);
+  bloom_[bit2 / 64] |= uint64_t(1) << (bit2 % 64);
+  if (lru_index_.count(hash)) {
+    return;
+  }
+  lru_order_.push_front(hash);
+  lru_index_[hash] = lru_order_.begin();
+  if (lru_order_.size() > kLruCapacity) {
+    lru_index_.erase(lru_order_.back());
+    lru_order_.pop_back();
+  }
+}
+
+void Reducer::TestedStateCache::Clear() {
+  std::fill(bloom_.begin(), bloom_.end(), 0);
+  lru_order_.clear();
+  lru_index_.clear();
+}
 
 Reducer::Reducer(spv_target_env target_env) : target_env_(target_env) {}
 
@@ -60,6 +123,9 @@ Reducer::ReductionResultStatus Reducer::Run(
     spv_validator_options validator_options) {
   std::vector<uint32_t> current_binary(binary_in);
 
+  // States tested by a previous call to Run say nothing about this one.
+  tested_states_.Clear();
+
   spvtools::SpirvTools tools(target_env_);
   assert(tools.IsValid() && "Failed to create SPIRV-Tools interface");
 
@@ -82,13 +148,52 @@ Reducer::ReductionResultStatus Reducer::Run(
     return Reducer::ReductionResultStatus::kInitialStateNotInteresting;
   }
 
+  std::vector<ReductionPass*> passes;
+  for (auto& pass : passes_) {
+    passes.push_back(pass.get());
+  }
+
   Reducer::ReductionResultStatus result =
-      RunPasses(&passes_, options, validator_options, tools, &current_binary,
-                &reductions_applied);
+      Reducer::ReductionResultStatus::kComplete;
+
+  if (options->hierarchical_reduction) {
+    // Hierarchical descent: run the passes that remove whole functions to
+    // completion, then those that remove blocks, before the main loop over
+    // every pass gets to work at instruction granularity.  On large modules
+    // this discards most of the code in a few coarse steps that the full
+    // round-robin would otherwise only reach after many fruitless fine-
+    // grained attempts.
+    for (auto scope : {ReductionOpportunityFinder::Scope::kFunction,
+                       ReductionOpportunityFinder::Scope::kBlock}) {
+      std::vector<ReductionPass*> tier;
+      for (ReductionPass* pass : passes) {
+        if (pass->GetScope() == scope) {
+          tier.push_back(pass);
+        }
+      }
+      if (tier.empty()) {
+        continue;
+      }
+      result = RunPasses(tier, options, validator_options, tools,
+                         &current_binary, &reductions_applied);
+      if (result != Reducer::ReductionResultStatus::kComplete) {
+        break;
+      }
+    }
+  }
+
+  if (result == Reducer::ReductionResultStatus::kComplete) {
+    result = RunPasses(passes, options, validator_options, tools,
+                       &current_binary, &reductions_applied);
+  }
 
   if (result == Reducer::ReductionResultStatus::kComplete) {
     // Cleanup passes.
-    result = RunPasses(&cleanup_passes_, options, validator_options, tools,
+    std::vector<ReductionPass*> cleanup_passes;
+    for (auto& pass : cleanup_passes_) {
+      cleanup_passes.push_back(pass.get());
+    }
+    result = RunPasses(cleanup_passes, options, validator_options, tools,
                        &current_binary, &reductions_applied);
   }
 
@@ -158,7 +263,7 @@ bool Reducer::ReachedStepLimit(uint32_t current_step,
 }
 
 Reducer::ReductionResultStatus Reducer::RunPasses(
-    std::vector<std::unique_ptr<ReductionPass>>* passes,
+    const std::vector<ReductionPass*>& passes,
     spv_const_reducer_options options, spv_validator_options validator_options,
     const SpirvTools& tools, std::vector<uint32_t>* current_binary,
     uint32_t* const reductions_applied) {
@@ -166,6 +271,11 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
   // worthwhile trying a further round.
   bool another_round_worthwhile = true;
 
+  const uint32_t parallelism =
+      options->parallelism == 0
+          ? static_cast<uint32_t>(utils::ThreadPool::DefaultThreadCount())
+          : options->parallelism;
+
   // Apply round after round of reduction passes until we hit the reduction
   // step limit, or deem that another round is not going to be worthwhile.
   while (!ReachedStepLimit(*reductions_applied, options) &&
@@ -175,7 +285,7 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
     another_round_worthwhile = false;
 
     // Iterate through the available passes.
-    for (auto& pass : *passes) {
+    for (ReductionPass* pass : passes) {
       // If this pass hasn't reached its minimum granularity then it's
       // worth eventually doing another round of reductions, in order to
       // try this pass at a finer granularity.
@@ -185,6 +295,17 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
       // working or we hit the reduction step limit.
       consumer_(SPV_MSG_INFO, nullptr, {},
                 ("Trying pass " + pass->GetName() + ".").c_str());
+      if (parallelism > 1) {
+        // Evaluate several candidate reduction steps from this pass
+        // concurrently, committing the first interesting one.
+        auto status = RunPassInParallel(
+            pass, parallelism, options, validator_options, tools,
+            current_binary, reductions_applied, &another_round_worthwhile);
+        if (status != Reducer::ReductionResultStatus::kComplete) {
+          return status;
+        }
+        continue;
+      }
       do {
         auto maybe_result =
             pass->TryApplyReduction(*current_binary, options->target_function);
@@ -203,8 +324,14 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
         stringstream << "Pass " << pass->GetName() << " made reduction step "
                      << *reductions_applied << ".";
         consumer_(SPV_MSG_INFO, nullptr, {}, (stringstream.str().c_str()));
-        if (!tools.Validate(&maybe_result[0], maybe_result.size(),
-                            validator_options)) {
+        const uint64_t state_hash = HashBinary(maybe_result);
+        if (tested_states_.ProbablyTested(state_hash)) {
+          // An earlier reduction path already validated this exact state and
+          // found it uninteresting, so skip the external test.
+          consumer_(SPV_MSG_INFO, nullptr, {},
+                    "Skipping already-tested state.");
+        } else if (!tools.Validate(&maybe_result[0], maybe_result.size(),
+                                   validator_options)) {
           // The reduction step went wrong and an invalid binary was produced.
           // By design, this shouldn't happen; this is a safeguard to stop an
           // invalid binary from being regarded as interesting.
@@ -225,6 +352,8 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
           *current_binary = std::move(maybe_result);
           interesting = true;
           another_round_worthwhile = true;
+        } else {
+          tested_states_.RecordUninteresting(state_hash);
         }
         // We must call this before the next call to TryApplyReduction.
         pass->NotifyInteresting(interesting);
@@ -245,5 +374,136 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
   return Reducer::ReductionResultStatus::kComplete;
 }
 
+Reducer::ReductionResultStatus Reducer::RunPassInParallel(
+    ReductionPass* pass, uint32_t parallelism,
+    spv_const_reducer_options options, spv_validator_options validator_options,
+    const SpirvTools& tools, std::vector<uint32_t>* current_binary,
+    uint32_t* const reductions_applied, bool* another_round_worthwhile) {
+  do {
+    // Never request more candidates than there are reduction steps left, so
+    // that the step count at which the limit is detected matches the
+    // single-threaded loop.  Like that loop, one final attempt is still made
+    // once the limit has been reached.
+    const uint32_t remaining_steps =
+        options->step_limit > *reductions_applied
+            ? options->step_limit - *reductions_applied
+            : 1u;
+    std::vector<std::vector<uint32_t>> candidates =
+        pass->TryApplyReductionBatch(*current_binary, options->target_function,
+                                     std::min(parallelism, remaining_steps));
+    if (candidates.empty()) {
+      // For this round, the pass has no more opportunities (chunks) to apply,
+      // so move on to the next pass.
+      consumer_(SPV_MSG_INFO, nullptr, {},
+                ("Pass " + pass->GetName() + " did not make a reduction step.")
+                    .c_str());
+      return Reducer::ReductionResultStatus::kComplete;
+    }
+
+    // Validate the candidates and run the interestingness test on them
+    // concurrently.  A worker skips any candidate that comes after an
+    // already-discovered interesting one; as the index of the first
+    // interesting candidate only ever decreases, every candidate up to and
+    // including the one that eventually gets committed is fully evaluated.
+    struct CandidateOutcome {
+      bool valid = false;
+      bool interesting = false;
+    };
+    std::vector<CandidateOutcome> outcomes(candidates.size());
+
+    // Check each candidate against the tested-state cache on this thread
+    // before any workers run; the cache is not thread safe.  A hit means the
+    // candidate was validated and found uninteresting on an earlier path, so
+    // its outcome is known without scheduling it.
+    std::vector<uint64_t> candidate_hashes(candidates.size());
+    std::vector<bool> already_tested(candidates.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(candidates.size()); ++i) {
+      candidate_hashes[i] = HashBinary(candidates[i]);
+      already_tested[i] = tested_states_.ProbablyTested(candidate_hashes[i]);
+      if (already_tested[i]) {
+        outcomes[i].valid = true;
+      }
+    }
+
+    std::atomic<uint32_t> first_interesting(
+        static_cast<uint32_t>(candidates.size()));
+    const uint32_t base_step = *reductions_applied;
+    {
+      utils::ThreadPool pool(std::min<size_t>(parallelism, candidates.size()));
+      for (uint32_t i = 0; i < static_cast<uint32_t>(candidates.size()); ++i) {
+        if (already_tested[i]) {
+          continue;
+        }
+        pool.Schedule([this, &tools, &candidates, &outcomes,
+                       &first_interesting, validator_options, base_step, i] {
+          if (i > first_interesting.load()) {
+            // An earlier candidate is already known to be interesting, so
+            // this one can never be committed.
+            return;
+          }
+          CandidateOutcome& outcome = outcomes[i];
+          outcome.valid = tools.Validate(candidates[i].data(),
+                                         candidates[i].size(),
+                                         validator_options);
+          if (outcome.valid &&
+              interestingness_function_(candidates[i], base_step + i + 1)) {
+            outcome.interesting = true;
+            uint32_t expected = first_interesting.load();
+            while (i < expected &&
+                   !first_interesting.compare_exchange_weak(expected, i)) {
+            }
+          }
+        });
+      }
+      pool.Wait();
+    }
+
+    // Replay the outcomes in candidate order, stopping at the first
+    // interesting one; candidates beyond it are discarded without being
+    // counted, as the single-threaded loop would never have tried them.
+    const uint32_t winner = first_interesting.load();
+    for (uint32_t i = 0;
+         i < static_cast<uint32_t>(candidates.size()) && i <= winner; ++i) {
+      std::stringstream stringstream;
+      (*reductions_applied)++;
+      stringstream << "Pass " << pass->GetName() << " made reduction step "
+                   << *reductions_applied << ".";
+      consumer_(SPV_MSG_INFO, nullptr, {}, (stringstream.str().c_str()));
+      if (already_tested[i]) {
+        // An earlier reduction path already validated this exact state and
+        // found it uninteresting, so the external test was skipped.
+        consumer_(SPV_MSG_INFO, nullptr, {},
+                  "Skipping already-tested state.");
+      } else if (!outcomes[i].valid) {
+        // The reduction step went wrong and an invalid binary was produced.
+        // By design, this shouldn't happen; this is a safeguard to stop an
+        // invalid binary from being regarded as interesting.
+        consumer_(SPV_MSG_INFO, nullptr, {},
+                  "Reduction step produced an invalid binary.");
+        if (options->fail_on_validation_error) {
+          // In this mode, we fail, so we update the current binary so it is
+          // output for debugging.
+          *current_binary = std::move(candidates[i]);
+          return Reducer::ReductionResultStatus::kStateInvalid;
+        }
+      } else if (outcomes[i].interesting) {
+        // Success!  The binary produced by this reduction step is
+        // interesting, so make it the binary of interest henceforth, and
+        // note that it's worth doing another round of reduction passes.
+        consumer_(SPV_MSG_INFO, nullptr, {}, "Reduction step succeeded.");
+        *current_binary = std::move(candidates[i]);
+        *another_round_worthwhile = true;
+      } else {
+        tested_states_.RecordUninteresting(candidate_hashes[i]);
+      }
+    }
+    pass->NotifyBatchInteresting(static_cast<uint32_t>(candidates.size()),
+                                 winner);
+    // Bail out if the reduction step limit has been reached.
+  } while (!ReachedStepLimit(*reductions_applied, options));
+
+  return Reducer::ReductionResultStatus::kComplete;
+}
+
 }  // namespace reduce
 }  // namespace spvtools
@@ -16,7 +16,10 @@
 #define SOURCE_REDUCE_REDUCER_H_
 
 #include <functional>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "source/reduce/reduction_pass.h"
 #include "spirv-tools/libspirv.hpp"
@@ -100,20 +103,70 @@ class Reducer {
                             spv_validator_options validator_options);
 
  private:
+  // Remembers module states that were already submitted to the
+  // interestingness test and found uninteresting.  Different opportunity
+  // orders often converge to the same module, and the external test is by
+  // far the most expensive part of a reduction step, so repeats are skipped.
+  // Recent states are held exactly in a bounded LRU; older ones are only
+  // remembered by a Bloom filter, whose rare false positives at worst skip a
+  // reduction step that would have been attempted.  Interesting states are
+  // never recorded, so a skip never discards a state that should have been
+  // committed.
+  class TestedStateCache {
+   public:
+    TestedStateCache();
+
+    // Returns true if |hash| was recorded as uninteresting before, with a
+    // small chance of a false positive once the exact window has been
+    // outgrown.  On an exact hit the state's recency is refreshed.
+    bool ProbablyTested(uint64_t hash);
+
+    // Records that the state hashing to |hash| was tested and found
+    // uninteresting.
+    void RecordUninteresting(uint64_t hash);
+
+    // Forgets all recorded states.
+    void Clear();
+
+   private:
+    // Bloom filter over every recorded hash; kBloomBits bits, two probes.
+    std::vector<uint64_t> bloom_;
+    // Exact window of the most recently recorded hashes, newest first.
+    std::list<uint64_t> lru_order_;
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> lru_index_;
+  };
+
   static bool ReachedStepLimit(uint32_t current_step,
                                spv_const_reducer_options options);
 
   ReductionResultStatus RunPasses(
-      std::vector<std::unique_ptr<ReductionPass>>* passes,
+      const std::vector<ReductionPass*>& passes,
       spv_const_reducer_options options,
       spv_validator_options validator_options, const SpirvTools& tools,
       std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
 
+  // Runs |pass| over |current_binary| until it stops making reduction steps,
+  // evaluating up to |parallelism| candidate steps concurrently per batch.
+  // The candidates that get committed, the step count and the messages
+  // emitted match what the single-threaded loop in RunPasses would have
+  // produced.  Returns kStateInvalid if a step produced an invalid binary and
+  // the fail-on-validation-error option is set, and kComplete otherwise;
+  // reaching the step limit is left for the caller to detect.
+  ReductionResultStatus RunPassInParallel(
+      ReductionPass* pass, uint32_t parallelism,
+      spv_const_reducer_options options,
+      spv_validator_options validator_options, const SpirvTools& tools,
+      std::vector<uint32_t>* current_binary, uint32_t* reductions_applied,
+      bool* another_round_worthwhile);
+
   const spv_target_env target_env_;
   MessageConsumer consumer_;
   InterestingnessFunction interestingness_function_;
   std::vector<std::unique_ptr<ReductionPass>> passes_;
   std::vector<std::unique_ptr<ReductionPass>> cleanup_passes_;
+  // States found uninteresting so far in the current call to Run.  Checked
+  // and updated only on the thread running Run, never from worker threads.
+  TestedStateCache tested_states_;
 };
 
 }  // namespace reduce
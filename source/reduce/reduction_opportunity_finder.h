@@ -26,10 +26,25 @@ namespace reduce {
 // Abstract class for finding opportunities for reducing a SPIR-V module.
 class ReductionOpportunityFinder {
  public:
+  // The granularity of program construct that a finder's opportunities
+  // remove or simplify.  Hierarchical reduction runs coarser scopes to
+  // completion before descending to finer ones, so that (say) a whole
+  // unneeded function disappears in one step instead of instruction by
+  // instruction.
+  enum class Scope {
+    kFunction,
+    kBlock,
+    kInstruction,
+  };
+
   ReductionOpportunityFinder() = default;
 
   virtual ~ReductionOpportunityFinder() = default;
 
+  // Returns the scope of the constructs this finder's opportunities act on.
+  // Finders act on individual instructions unless they say otherwise.
+  virtual Scope GetScope() const { return Scope::kInstruction; }
+
   // Finds and returns the reduction opportunities relevant to this pass that
   // could be applied to SPIR-V module |context|.
   //
@@ -17,52 +17,100 @@
 #include <algorithm>
 
 #include "source/opt/build_module.h"
+#include "source/util/hash_combine.h"
 
 namespace spvtools {
 namespace reduce {
+namespace {
+
+// Returns a hash of |binary| and |target_function| for the empty-scan cache.
+uint64_t HashScanInputs(const std::vector<uint32_t>& binary,
+                        uint32_t target_function) {
+  size_t hash = utils::hash_combine(0, target_function, binary.size());
+  for (uint32_t word : binary) {
+    hash = utils::hash_combine(hash, word);
+  }
+  return hash;
+}
+
+}  // namespace
 
 std::vector<uint32_t> ReductionPass::TryApplyReduction(
     const std::vector<uint32_t>& binary, uint32_t target_function) {
-  // We represent modules as binaries because (a) attempts at reduction need to
-  // end up in binary form to be passed on to SPIR-V-consuming tools, and (b)
-  // when we apply a reduction step we need to do it on a fresh version of the
-  // module as if the reduction step proves to be uninteresting we need to
-  // backtrack; re-parsing from binary provides a very clean way of cloning the
-  // module.
-  std::unique_ptr<opt::IRContext> context =
-      BuildModule(target_env_, consumer_, binary.data(), binary.size());
-  assert(context);
-
-  std::vector<std::unique_ptr<ReductionOpportunity>> opportunities =
-      finder_->GetAvailableOpportunities(context.get(), target_function);
-
-  // There is no point in having a granularity larger than the number of
-  // opportunities, so reduce the granularity in this case.
-  if (granularity_ > opportunities.size()) {
-    granularity_ = std::max((uint32_t)1, (uint32_t)opportunities.size());
+  std::vector<std::vector<uint32_t>> batch =
+      TryApplyReductionBatch(binary, target_function, 1);
+  if (batch.empty()) {
+    return std::vector<uint32_t>();
   }
+  return std::move(batch[0]);
+}
 
-  assert(granularity_ > 0);
-
-  if (index_ >= opportunities.size()) {
-    // We have reached the end of the available opportunities and, therefore,
-    // the end of the round for this pass, so reset the index and decrease the
-    // granularity for the next round. Return an empty vector to signal the end
-    // of the round.
+std::vector<std::vector<uint32_t>> ReductionPass::TryApplyReductionBatch(
+    const std::vector<uint32_t>& binary, uint32_t target_function,
+    uint32_t max_chunks) {
+  // We represent modules as binaries because attempts at reduction need to
+  // end up in binary form to be passed on to SPIR-V-consuming tools.  The
+  // binary of interest is parsed once per batch; each candidate is then
+  // applied to a structural clone of the parsed module, which is much cheaper
+  // than re-parsing and backtracks just as cleanly: if a reduction step
+  // proves to be uninteresting its clone is simply discarded.
+  const uint64_t scan_hash = HashScanInputs(binary, target_function);
+  if (last_scan_empty_ && scan_hash == empty_scan_hash_) {
+    // The finder found nothing in this very binary last time, and finders
+    // are deterministic, so the round is over before it starts.  This takes
+    // the same end-of-round exit as an empty scan below would.
     index_ = 0;
-    granularity_ = std::max((uint32_t)1, granularity_ / 2);
-    return std::vector<uint32_t>();
+    granularity_ = 1;
+    return std::vector<std::vector<uint32_t>>();
   }
 
-  for (uint32_t i = index_;
-       i < std::min(index_ + granularity_, (uint32_t)opportunities.size());
-       ++i) {
-    opportunities[i]->TryToApply();
+  std::unique_ptr<opt::IRContext> parsed_context =
+      BuildModule(target_env_, consumer_, binary.data(), binary.size());
+  assert(parsed_context);
+  std::vector<std::vector<uint32_t>> candidates;
+  for (uint32_t chunk = 0; chunk < max_chunks; ++chunk) {
+    std::unique_ptr<opt::IRContext> context = parsed_context->Clone();
+
+    std::vector<std::unique_ptr<ReductionOpportunity>> opportunities =
+        finder_->GetAvailableOpportunities(context.get(), target_function);
+
+    if (chunk == 0) {
+      last_scan_empty_ = opportunities.empty();
+      empty_scan_hash_ = scan_hash;
+    }
+
+    // There is no point in having a granularity larger than the number of
+    // opportunities, so reduce the granularity in this case.
+    if (granularity_ > opportunities.size()) {
+      granularity_ = std::max((uint32_t)1, (uint32_t)opportunities.size());
+    }
+
+    assert(granularity_ > 0);
+
+    const uint32_t chunk_start = index_ + chunk * granularity_;
+    if (chunk_start >= opportunities.size()) {
+      if (candidates.empty()) {
+        // We have reached the end of the available opportunities and,
+        // therefore, the end of the round for this pass, so reset the index
+        // and decrease the granularity for the next round. Return an empty
+        // vector to signal the end of the round.
+        index_ = 0;
+        granularity_ = std::max((uint32_t)1, granularity_ / 2);
+      }
+      break;
+    }
+
+    const uint32_t chunk_end = std::min(chunk_start + granularity_,
+                                        (uint32_t)opportunities.size());
+    for (uint32_t i = chunk_start; i < chunk_end; ++i) {
+      opportunities[i]->TryToApply();
+    }
+
+    std::vector<uint32_t> result;
+    context->module()->ToBinary(&result, false);
+    candidates.push_back(std::move(result));
   }
-
-  std::vector<uint32_t> result;
-  context->module()->ToBinary(&result, false);
-  return result;
+  return candidates;
 }
 
 void ReductionPass::SetMessageConsumer(MessageConsumer consumer) {
@@ -77,9 +125,15 @@ bool ReductionPass::ReachedMinimumGranularity() const {
 std::string ReductionPass::GetName() const { return finder_->GetName(); }
 
 void ReductionPass::NotifyInteresting(bool interesting) {
-  if (!interesting) {
-    index_ += granularity_;
-  }
+  NotifyBatchInteresting(1, interesting ? 0 : 1);
+}
+
+void ReductionPass::NotifyBatchInteresting(uint32_t batch_size,
+                                           uint32_t first_interesting) {
+  // Chunks that preceded the first interesting candidate were uninteresting,
+  // so the index moves past them; the interesting chunk itself, and anything
+  // after it, will be re-examined against the new binary of interest.
+  index_ += std::min(first_interesting, batch_size) * granularity_;
 }
 
 }  // namespace reduce
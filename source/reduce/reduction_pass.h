@@ -56,11 +56,33 @@ class ReductionPass {
   std::vector<uint32_t> TryApplyReduction(const std::vector<uint32_t>& binary,
                                           uint32_t target_function);
 
+  // Applies up to |max_chunks| consecutive chunks of reduction opportunities,
+  // each to a fresh clone of the module represented by |binary|, and returns
+  // the resulting binaries in the order in which repeated calls to
+  // TryApplyReduction would have produced them.  Fewer than |max_chunks|
+  // binaries are returned when the current round runs out of chunks, and an
+  // empty vector indicates the end of the round, exactly as for
+  // TryApplyReduction.  Before the next call to this method or to
+  // TryApplyReduction the caller must invoke NotifyBatchInteresting(...) to
+  // report which candidate, if any, was interesting.
+  //
+  // |target_function| is interpreted as for TryApplyReduction.
+  std::vector<std::vector<uint32_t>> TryApplyReductionBatch(
+      const std::vector<uint32_t>& binary, uint32_t target_function,
+      uint32_t max_chunks);
+
   // Notifies the reduction pass whether the binary returned from
   // TryApplyReduction is interesting, so that the next call to
   // TryApplyReduction will avoid applying the same chunk of opportunities.
   void NotifyInteresting(bool interesting);
 
+  // Analogue of NotifyInteresting for TryApplyReductionBatch:
+  // |first_interesting| is the index within the returned batch of the first
+  // interesting binary, or at least |batch_size| if none was interesting.
+  // Candidates that came after the first interesting one are treated as never
+  // having been tried, so their chunks remain available in this round.
+  void NotifyBatchInteresting(uint32_t batch_size, uint32_t first_interesting);
+
   // Sets a consumer to which relevant messages will be directed.
   void SetMessageConsumer(MessageConsumer consumer);
 
@@ -72,12 +94,25 @@ class ReductionPass {
   // associated finder).
   std::string GetName() const;
 
+  // Returns the scope of the constructs the associated finder acts on.
+  ReductionOpportunityFinder::Scope GetScope() const {
+    return finder_->GetScope();
+  }
+
  private:
   const spv_target_env target_env_;
   const std::unique_ptr<ReductionOpportunityFinder> finder_;
   MessageConsumer consumer_;
   uint32_t index_;
   uint32_t granularity_;
+
+  // When true, the last scan of a binary found no opportunities at all, and
+  // |empty_scan_hash_| is a hash of that binary together with the target
+  // function.  A binary that hashes the same again can then be declared
+  // exhausted without being re-parsed and re-scanned, which matters in the
+  // late rounds of a reduction where most passes repeatedly come up empty.
+  bool last_scan_empty_ = false;
+  uint64_t empty_scan_hash_ = 0;
 };
 
 }  // namespace reduce
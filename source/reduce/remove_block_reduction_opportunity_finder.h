@@ -33,6 +33,8 @@ class RemoveBlockReductionOpportunityFinder
 
   std::string GetName() const final;
 
+  Scope GetScope() const final { return Scope::kBlock; }
+
   std::vector<std::unique_ptr<ReductionOpportunity>> GetAvailableOpportunities(
       opt::IRContext* context, uint32_t target_function) const final;
 
@@ -30,6 +30,8 @@ class RemoveFunctionReductionOpportunityFinder
 
   std::string GetName() const final;
 
+  Scope GetScope() const final { return Scope::kFunction; }
+
   std::vector<std::unique_ptr<ReductionOpportunity>> GetAvailableOpportunities(
       opt::IRContext* context, uint32_t target_function) const final;
 
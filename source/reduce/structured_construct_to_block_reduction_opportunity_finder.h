@@ -32,6 +32,8 @@ class StructuredConstructToBlockReductionOpportunityFinder
 
   std::string GetName() const final;
 
+  Scope GetScope() const final { return Scope::kBlock; }
+
   std::vector<std::unique_ptr<ReductionOpportunity>> GetAvailableOpportunities(
       opt::IRContext* context, uint32_t target_function) const final;
 
@@ -0,0 +1,163 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "spirv-tools/reflection.hpp"
+
+#include <unordered_map>
+#include <utility>
+
+#include "source/latest_version_spirv_header.h"
+#include "source/table.h"
+
+namespace spvtools {
+namespace {
+
+// Accumulates reflection data from the header and instruction callbacks of
+// spvBinaryParse.  Decorations precede the variables they apply to, so they
+// are buffered and joined with the variable records once parsing ends.
+class ReflectionParser {
+ public:
+  explicit ReflectionParser(ReflectionInfo* info) : info_(*info) {}
+
+  spv_result_t HandleHeader(uint32_t version, uint32_t id_bound) {
+    info_.version = version;
+    info_.id_bound = id_bound;
+    return SPV_SUCCESS;
+  }
+
+  spv_result_t HandleInstruction(const spv_parsed_instruction_t& inst);
+
+  // Joins the buffered decorations with the collected variables.
+  void Finalize();
+
+ private:
+  ReflectionInfo& info_;
+  std::unordered_map<uint32_t, uint32_t> descriptor_sets_;
+  std::unordered_map<uint32_t, uint32_t> bindings_;
+  std::unordered_map<uint32_t, uint32_t> locations_;
+};
+
+spv_result_t ReflectionParser::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  switch (spv::Op(inst.opcode)) {
+    case spv::Op::OpEntryPoint: {
+      ReflectedEntryPoint entry_point;
+      entry_point.execution_model = inst.words[1];
+      entry_point.function_id = inst.words[2];
+      entry_point.name =
+          reinterpret_cast<const char*>(inst.words + inst.operands[2].offset);
+      // The interface ids follow the name.
+      for (uint16_t i = 3; i < inst.num_operands; ++i) {
+        entry_point.interface_ids.push_back(
+            inst.words[inst.operands[i].offset]);
+      }
+      info_.entry_points.push_back(std::move(entry_point));
+      break;
+    }
+    case spv::Op::OpExecutionMode:
+      if (spv::ExecutionMode(inst.words[2]) == spv::ExecutionMode::LocalSize) {
+        for (auto& entry_point : info_.entry_points) {
+          if (entry_point.function_id == inst.words[1]) {
+            entry_point.local_size[0] = inst.words[3];
+            entry_point.local_size[1] = inst.words[4];
+            entry_point.local_size[2] = inst.words[5];
+          }
+        }
+      }
+      break;
+    case spv::Op::OpDecorate:
+      switch (spv::Decoration(inst.words[2])) {
+        case spv::Decoration::DescriptorSet:
+          descriptor_sets_[inst.words[1]] = inst.words[3];
+          break;
+        case spv::Decoration::Binding:
+          bindings_[inst.words[1]] = inst.words[3];
+          break;
+        case spv::Decoration::Location:
+          locations_[inst.words[1]] = inst.words[3];
+          break;
+        default:
+          break;
+      }
+      break;
+    case spv::Op::OpVariable: {
+      // Only module-scope variables are seen: parsing stops before the first
+      // function body.
+      ReflectedVariable variable;
+      variable.id = inst.result_id;
+      variable.type_id = inst.type_id;
+      variable.storage_class = inst.words[3];
+      info_.variables.push_back(variable);
+      break;
+    }
+    case spv::Op::OpFunction:
+      // Everything reflection needs precedes the function bodies.
+      return SPV_REQUESTED_TERMINATION;
+    default:
+      break;
+  }
+  return SPV_SUCCESS;
+}
+
+void ReflectionParser::Finalize() {
+  for (ReflectedVariable& variable : info_.variables) {
+    auto iter = descriptor_sets_.find(variable.id);
+    if (iter != descriptor_sets_.end()) variable.descriptor_set = iter->second;
+    iter = bindings_.find(variable.id);
+    if (iter != bindings_.end()) variable.binding = iter->second;
+    iter = locations_.find(variable.id);
+    if (iter != locations_.end()) variable.location = iter->second;
+  }
+}
+
+spv_result_t HandleHeader(void* user_data, spv_endianness_t, uint32_t,
+                          uint32_t version, uint32_t, uint32_t id_bound,
+                          uint32_t) {
+  return static_cast<ReflectionParser*>(user_data)->HandleHeader(version,
+                                                                 id_bound);
+}
+
+spv_result_t HandleInstruction(
+    void* user_data, const spv_parsed_instruction_t* parsed_instruction) {
+  return static_cast<ReflectionParser*>(user_data)->HandleInstruction(
+      *parsed_instruction);
+}
+
+}  // namespace
+
+spv_result_t GetReflectionInfo(const Context& context, const uint32_t* binary,
+                               const size_t binary_size,
+                               ReflectionInfo* info) {
+  if (info == nullptr) return SPV_ERROR_INVALID_POINTER;
+  *info = ReflectionInfo();
+
+  ReflectionParser parser(info);
+  spv_diagnostic diagnostic = nullptr;
+  spv_result_t status =
+      spvBinaryParse(context.CContext(), &parser, binary, binary_size,
+                     HandleHeader, HandleInstruction, &diagnostic);
+  // Stopping at the first function is the expected way out of the parse.
+  if (status == SPV_REQUESTED_TERMINATION) status = SPV_SUCCESS;
+
+  if (status == SPV_SUCCESS) {
+    parser.Finalize();
+  } else if (diagnostic != nullptr && context.CContext()->consumer != nullptr) {
+    context.CContext()->consumer(SPV_MSG_ERROR, "", diagnostic->position,
+                                 diagnostic->error);
+  }
+  spvDiagnosticDestroy(diagnostic);
+  return status;
+}
+
+}  // namespace spvtools
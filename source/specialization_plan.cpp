@@ -0,0 +1,133 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unordered_map>
+#include <vector>
+
+#include "source/latest_version_spirv_header.h"
+#include "source/spirv_constant.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace {
+
+// Returns the opcode half of instruction word |word0|.
+inline spv::Op OpcodeOf(uint32_t word0) {
+  return static_cast<spv::Op>(word0 & 0xffffu);
+}
+
+// Returns the word count half of instruction word |word0|.
+inline uint32_t WordCountOf(uint32_t word0) { return word0 >> 16u; }
+
+}  // namespace
+
+bool SpecializationPlan::Analyze(const uint32_t* binary,
+                                 const size_t binary_size) {
+  constants_.clear();
+  num_words_ = 0;
+  if (binary == nullptr || binary_size < SPV_INDEX_INSTRUCTION) return false;
+  if (binary[SPV_INDEX_MAGIC_NUMBER] != spv::MagicNumber) return false;
+
+  // Pass 1: record the location and literal width of every scalar spec
+  // constant, keyed by result id.  Decorations precede the constants they
+  // apply to, so SpecIds are collected in the same walk and joined below.
+  std::unordered_map<uint32_t, SpecConstant> constants_by_result_id;
+  std::unordered_map<uint32_t, uint32_t> spec_id_by_result_id;
+  size_t offset = SPV_INDEX_INSTRUCTION;
+  while (offset < binary_size) {
+    const uint32_t word0 = binary[offset];
+    const uint32_t num_words = WordCountOf(word0);
+    if (num_words == 0 || offset + num_words > binary_size) {
+      constants_.clear();
+      return false;
+    }
+    const spv::Op opcode = OpcodeOf(word0);
+    switch (opcode) {
+      case spv::Op::OpDecorate:
+        if (num_words >= 4 &&
+            static_cast<spv::Decoration>(binary[offset + 2]) ==
+                spv::Decoration::SpecId) {
+          spec_id_by_result_id[binary[offset + 1]] = binary[offset + 3];
+        }
+        break;
+      case spv::Op::OpSpecConstantTrue:
+      case spv::Op::OpSpecConstantFalse:
+        constants_by_result_id[binary[offset + 2]] = {offset, 0};
+        break;
+      case spv::Op::OpSpecConstant:
+        // Literal words follow the type and result ids.  Constants wider
+        // than 64 bits have no uint64_t representation and are skipped.
+        if (num_words >= 4 && num_words <= 5) {
+          constants_by_result_id[binary[offset + 2]] = {offset, num_words - 3};
+        }
+        break;
+      case spv::Op::OpFunction:
+        // Constants and decorations only appear before the first function.
+        offset = binary_size;
+        continue;
+      default:
+        break;
+    }
+    offset += num_words;
+  }
+
+  for (const auto& kv : constants_by_result_id) {
+    const auto spec_id_iter = spec_id_by_result_id.find(kv.first);
+    if (spec_id_iter != spec_id_by_result_id.end()) {
+      constants_[spec_id_iter->second] = kv.second;
+    }
+  }
+  num_words_ = binary_size;
+  return true;
+}
+
+bool SpecializationPlan::Analyze(const std::vector<uint32_t>& binary) {
+  return Analyze(binary.data(), binary.size());
+}
+
+bool SpecializationPlan::HasSpecId(uint32_t spec_id) const {
+  return constants_.find(spec_id) != constants_.end();
+}
+
+bool SpecializationPlan::Specialize(
+    std::vector<uint32_t>* binary,
+    const std::unordered_map<uint32_t, uint64_t>& values) const {
+  if (binary == nullptr || binary->size() != num_words_ || num_words_ == 0) {
+    return false;
+  }
+  uint32_t* words = binary->data();
+  for (const auto& kv : values) {
+    const auto constant_iter = constants_.find(kv.first);
+    if (constant_iter == constants_.end()) continue;
+    const SpecConstant& constant = constant_iter->second;
+    if (constant.num_value_words == 0) {
+      // Booleans carry their value in the opcode.  Keep the word count and
+      // swap between the true and false forms.
+      const spv::Op opcode = kv.second != 0 ? spv::Op::OpSpecConstantTrue
+                                            : spv::Op::OpSpecConstantFalse;
+      words[constant.opcode_offset] =
+          (WordCountOf(words[constant.opcode_offset]) << 16u) |
+          static_cast<uint32_t>(opcode);
+    } else {
+      words[constant.opcode_offset + 3] = static_cast<uint32_t>(kv.second);
+      if (constant.num_value_words == 2) {
+        words[constant.opcode_offset + 4] =
+            static_cast<uint32_t>(kv.second >> 32u);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace spvtools
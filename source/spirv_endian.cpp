@@ -46,6 +46,25 @@ uint64_t spvFixDoubleWord(const uint32_t low, const uint32_t high,
   return (uint64_t(spvFixWord(high, endian)) << 32) | spvFixWord(low, endian);
 }
 
+void spvFixWords(const uint32_t* in, uint32_t* out, const size_t count,
+                 const spv_endianness_t endian) {
+  if ((SPV_ENDIANNESS_LITTLE == endian && I32_ENDIAN_HOST == I32_ENDIAN_BIG) ||
+      (SPV_ENDIANNESS_BIG == endian && I32_ENDIAN_HOST == I32_ENDIAN_LITTLE)) {
+    for (size_t i = 0; i < count; ++i) {
+      const uint32_t word = in[i];
+      out[i] = (word & 0x000000ff) << 24 | (word & 0x0000ff00) << 8 |
+               (word & 0x00ff0000) >> 8 | (word & 0xff000000) >> 24;
+    }
+  } else if (in != out) {
+    memcpy(out, in, count * sizeof(uint32_t));
+  }
+}
+
+spv_endianness_t spvHostEndianness() {
+  return I32_ENDIAN_HOST == I32_ENDIAN_LITTLE ? SPV_ENDIANNESS_LITTLE
+                                              : SPV_ENDIANNESS_BIG;
+}
+
 spv_result_t spvBinaryEndianness(spv_const_binary binary,
                                  spv_endianness_t* pEndian) {
   if (!binary->code || !binary->wordCount) return SPV_ERROR_INVALID_BINARY;
@@ -25,6 +25,18 @@ uint32_t spvFixWord(const uint32_t word, const spv_endianness_t endianness);
 uint64_t spvFixDoubleWord(const uint32_t low, const uint32_t high,
                           const spv_endianness_t endianness);
 
+// Copies |count| words from |in| to |out|, converting them from the specified
+// endianness to the host native endianness.  The ranges must not partially
+// overlap.  When no conversion is needed this is a plain copy (and a no-op if
+// |in| equals |out|); otherwise the conversion runs as one tight byte-shuffle
+// loop over the whole range, which compilers vectorize, instead of a call per
+// word.
+void spvFixWords(const uint32_t* in, uint32_t* out, const size_t count,
+                 const spv_endianness_t endianness);
+
+// Returns the host native endianness.
+spv_endianness_t spvHostEndianness();
+
 // Gets the endianness of the SPIR-V module given in the binary parameter.
 // Returns SPV_ENDIANNESS_UNKNOWN if the SPIR-V magic number is invalid,
 // otherwise writes the determined endianness into *endian.
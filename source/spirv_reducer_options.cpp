@@ -25,7 +25,9 @@ const uint32_t kDefaultStepLimit = 2500;
 spv_reducer_options_t::spv_reducer_options_t()
     : step_limit(kDefaultStepLimit),
       fail_on_validation_error(false),
-      target_function(0) {}
+      target_function(0),
+      parallelism(1),
+      hierarchical_reduction(false) {}
 
 SPIRV_TOOLS_EXPORT spv_reducer_options spvReducerOptionsCreate() {
   return new spv_reducer_options_t();
@@ -49,3 +51,13 @@ SPIRV_TOOLS_EXPORT void spvReducerOptionsSetTargetFunction(
     spv_reducer_options options, uint32_t target_function) {
   options->target_function = target_function;
 }
+
+SPIRV_TOOLS_EXPORT void spvReducerOptionsSetParallelism(
+    spv_reducer_options options, uint32_t parallelism) {
+  options->parallelism = parallelism;
+}
+
+SPIRV_TOOLS_EXPORT void spvReducerOptionsSetHierarchicalReduction(
+    spv_reducer_options options, bool hierarchical_reduction) {
+  options->hierarchical_reduction = hierarchical_reduction;
+}
@@ -33,6 +33,12 @@ struct spv_reducer_options_t {
 
   // See spvReducerOptionsSetTargetFunction.
   uint32_t target_function;
+
+  // See spvReducerOptionsSetParallelism.
+  uint32_t parallelism;
+
+  // See spvReducerOptionsSetHierarchicalReduction.
+  bool hierarchical_reduction;
 };
 
 #endif  // SOURCE_SPIRV_REDUCER_OPTIONS_H_
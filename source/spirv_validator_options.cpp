@@ -130,3 +130,8 @@ void spvValidatorOptionsSetFriendlyNames(spv_validator_options options,
                                          bool val) {
   options->use_friendly_names = val;
 }
+
+void spvValidatorOptionsSetParallelValidation(spv_validator_options options,
+                                              uint32_t num_threads) {
+  options->parallel_validation_threads = num_threads;
+}
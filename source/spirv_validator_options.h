@@ -49,7 +49,8 @@ struct spv_validator_options_t {
         skip_block_layout(false),
         allow_localsizeid(false),
         before_hlsl_legalization(false),
-        use_friendly_names(true) {}
+        use_friendly_names(true),
+        parallel_validation_threads(1) {}
 
   validator_universal_limits_t universal_limits_;
   bool relax_struct_store;
@@ -62,6 +63,9 @@ struct spv_validator_options_t {
   bool allow_localsizeid;
   bool before_hlsl_legalization;
   bool use_friendly_names;
+  // Number of threads used to validate function bodies.  1 means validate
+  // on the calling thread only; 0 means one thread per hardware context.
+  uint32_t parallel_validation_threads;
 };
 
 #endif  // SOURCE_SPIRV_VALIDATOR_OPTIONS_H_
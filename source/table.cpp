@@ -14,40 +14,94 @@
 
 #include "source/table.h"
 
+#include <algorithm>
+#include <map>
 #include <utility>
 
-spv_context spvContextCreate(spv_target_env env) {
-  switch (env) {
-    case SPV_ENV_UNIVERSAL_1_0:
-    case SPV_ENV_VULKAN_1_0:
-    case SPV_ENV_UNIVERSAL_1_1:
-    case SPV_ENV_OPENCL_1_2:
-    case SPV_ENV_OPENCL_EMBEDDED_1_2:
-    case SPV_ENV_OPENCL_2_0:
-    case SPV_ENV_OPENCL_EMBEDDED_2_0:
-    case SPV_ENV_OPENCL_2_1:
-    case SPV_ENV_OPENCL_EMBEDDED_2_1:
-    case SPV_ENV_OPENCL_2_2:
-    case SPV_ENV_OPENCL_EMBEDDED_2_2:
-    case SPV_ENV_OPENGL_4_0:
-    case SPV_ENV_OPENGL_4_1:
-    case SPV_ENV_OPENGL_4_2:
-    case SPV_ENV_OPENGL_4_3:
-    case SPV_ENV_OPENGL_4_5:
-    case SPV_ENV_UNIVERSAL_1_2:
-    case SPV_ENV_UNIVERSAL_1_3:
-    case SPV_ENV_VULKAN_1_1:
-    case SPV_ENV_VULKAN_1_1_SPIRV_1_4:
-    case SPV_ENV_UNIVERSAL_1_4:
-    case SPV_ENV_UNIVERSAL_1_5:
-    case SPV_ENV_VULKAN_1_2:
-    case SPV_ENV_UNIVERSAL_1_6:
-    case SPV_ENV_VULKAN_1_3:
-      break;
-    default:
-      return nullptr;
+#include "source/enum_string_mapping.h"
+#include "source/spirv_target_env.h"
+
+namespace {
+
+// Returns true when |entry| should stay in a table subsetted to the given
+// profile.  Mirrors the availability rule the table lookups apply - an
+// entry counts as available when the target version admits it or when an
+// extension or capability enables it - with the extension and capability
+// wildcards narrowed to the profile's lists.  An entry whose capability
+// requirement cannot be met under the profile, or that is out of version
+// range with none of its enabling extensions listed, can never be used and
+// is dropped.
+template <typename Desc>
+bool KeptForProfile(const Desc& entry, uint32_t version,
+                    const std::unordered_set<uint32_t>& capabilities,
+                    const std::unordered_set<uint32_t>& extensions) {
+  bool capability_ok = entry.numCapabilities == 0;
+  for (uint32_t i = 0; !capability_ok && i < entry.numCapabilities; ++i) {
+    capability_ok =
+        capabilities.count(static_cast<uint32_t>(entry.capabilities[i])) != 0;
+  }
+  if (!capability_ok) return false;
+
+  if (version >= entry.minVersion && version <= entry.lastVersion) return true;
+  if (entry.numCapabilities > 0) return true;
+  for (uint32_t i = 0; i < entry.numExtensions; ++i) {
+    if (extensions.count(static_cast<uint32_t>(entry.extensions[i]))) {
+      return true;
+    }
   }
+  return false;
+}
+
+std::shared_ptr<const spvtools::SubsettedGrammar> BuildSubsettedGrammar(
+    spv_target_env env, const std::unordered_set<uint32_t>& capabilities,
+    const std::unordered_set<uint32_t>& extensions) {
+  auto grammar = std::make_shared<spvtools::SubsettedGrammar>();
+  const uint32_t version = spvVersionForTargetEnv(env);
+
+  spv_opcode_table opcode_table;
+  spvOpcodeTableGet(&opcode_table, env);
+  for (uint32_t i = 0; i < opcode_table->count; ++i) {
+    const spv_opcode_desc_t& entry = opcode_table->entries[i];
+    if (KeptForProfile(entry, version, capabilities, extensions)) {
+      grammar->opcode_entries.push_back(entry);
+    }
+  }
+  grammar->opcode_table.reset(new spv_opcode_table_t{
+      static_cast<uint32_t>(grammar->opcode_entries.size()),
+      grammar->opcode_entries.data()});
+
+  spv_operand_table operand_table;
+  spvOperandTableGet(&operand_table, env);
+  grammar->operand_entries.resize(operand_table->count);
+  grammar->operand_groups.reserve(operand_table->count);
+  for (uint32_t g = 0; g < operand_table->count; ++g) {
+    const spv_operand_desc_group_t& group = operand_table->types[g];
+    std::vector<spv_operand_desc_t>& entries = grammar->operand_entries[g];
+    for (uint32_t i = 0; i < group.count; ++i) {
+      if (KeptForProfile(group.entries[i], version, capabilities,
+                         extensions)) {
+        entries.push_back(group.entries[i]);
+      }
+    }
+    grammar->operand_groups.push_back(spv_operand_desc_group_t{
+        group.type, static_cast<uint32_t>(entries.size()), entries.data()});
+  }
+  grammar->operand_table.reset(new spv_operand_table_t{
+      static_cast<uint32_t>(grammar->operand_groups.size()),
+      grammar->operand_groups.data()});
+
+  return grammar;
+}
 
+}  // anonymous namespace
+
+spv_context spvContextCreate(spv_target_env env) {
+  if (!spvIsValidEnv(env)) return nullptr;
+
+  // The grammar tables are constant-initialized data baked into the binary
+  // image: the *TableGet functions only hand out pointers into it, so
+  // creating a context costs one small allocation regardless of how many
+  // contexts the process has already created.
   spv_opcode_table opcode_table;
   spv_operand_table operand_table;
   spv_ext_inst_table ext_inst_table;
@@ -56,13 +110,84 @@ spv_context spvContextCreate(spv_target_env env) {
   spvOperandTableGet(&operand_table, env);
   spvExtInstTableGet(&ext_inst_table, env);
 
-  return new spv_context_t{env, opcode_table, operand_table, ext_inst_table,
-                           nullptr /* a null default consumer */};
+  return new spv_context_t{
+      env, opcode_table, operand_table, ext_inst_table,
+      nullptr /* a null default consumer */, true /* consumer_needs_text */,
+      std::make_shared<spvtools::val::ValidatedFunctionHashes>(),
+      nullptr /* no grammar subsetting */};
+}
+
+spv_context spvContextCreateForProfile(spv_target_env env,
+                                       const uint32_t* capabilities,
+                                       size_t capability_count,
+                                       const char* const* extensions,
+                                       size_t extension_count) {
+  if (!spvIsValidEnv(env)) return nullptr;
+  if (capability_count > 0 && capabilities == nullptr) return nullptr;
+  if (extension_count > 0 && extensions == nullptr) return nullptr;
+
+  std::unordered_set<uint32_t> capability_set(
+      capabilities, capabilities + capability_count);
+  std::unordered_set<uint32_t> extension_set;
+  for (size_t i = 0; i < extension_count; ++i) {
+    if (extensions[i] == nullptr) return nullptr;
+    spvtools::Extension extension;
+    // An unknown extension name cannot enable any table entry, so it does
+    // not affect the subset.
+    if (spvtools::GetExtensionFromString(extensions[i], &extension)) {
+      extension_set.insert(static_cast<uint32_t>(extension));
+    }
+  }
+
+  // One profile's tables are built once and shared by every context created
+  // for it.  The filtered copies are small, so cache entries are kept for
+  // the life of the process.
+  std::vector<uint32_t> key;
+  key.reserve(2 + capability_set.size() + extension_set.size());
+  key.push_back(static_cast<uint32_t>(env));
+  key.insert(key.end(), capability_set.begin(), capability_set.end());
+  std::sort(key.begin() + 1, key.end());
+  key.push_back(0xffffffffu);  // Separates capabilities from extensions.
+  const size_t extensions_begin = key.size();
+  key.insert(key.end(), extension_set.begin(), extension_set.end());
+  std::sort(key.begin() + extensions_begin, key.end());
+
+  static std::mutex cache_mutex;
+  static std::map<std::vector<uint32_t>,
+                  std::shared_ptr<const spvtools::SubsettedGrammar>>
+      cache;
+  std::shared_ptr<const spvtools::SubsettedGrammar> grammar;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto& slot = cache[key];
+    if (!slot) slot = BuildSubsettedGrammar(env, capability_set,
+                                            extension_set);
+    grammar = slot;
+  }
+
+  spv_ext_inst_table ext_inst_table;
+  spvExtInstTableGet(&ext_inst_table, env);
+
+  // The extended-instruction tables are not subsetted: availability of
+  // their entries is governed by the imported instruction set, not by
+  // capabilities or extensions.
+  return new spv_context_t{
+      env, grammar->opcode_table.get(), grammar->operand_table.get(),
+      ext_inst_table, nullptr /* a null default consumer */,
+      true /* consumer_needs_text */,
+      std::make_shared<spvtools::val::ValidatedFunctionHashes>(), grammar};
 }
 
 void spvContextDestroy(spv_context context) { delete context; }
 
 void spvtools::SetContextMessageConsumer(spv_context context,
                                          spvtools::MessageConsumer consumer) {
+  SetContextMessageConsumer(context, std::move(consumer), true);
+}
+
+void spvtools::SetContextMessageConsumer(spv_context context,
+                                         spvtools::MessageConsumer consumer,
+                                         bool needs_text) {
   context->consumer = std::move(consumer);
+  context->consumer_needs_text = needs_text;
 }
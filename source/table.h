@@ -15,6 +15,12 @@
 #ifndef SOURCE_TABLE_H_
 #define SOURCE_TABLE_H_
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
 #include "source/extensions.h"
 #include "source/latest_version_spirv_header.h"
 #include "spirv-tools/libspirv.hpp"
@@ -106,12 +112,61 @@ typedef const spv_opcode_table_t* spv_opcode_table;
 typedef const spv_operand_table_t* spv_operand_table;
 typedef const spv_ext_inst_table_t* spv_ext_inst_table;
 
+namespace spvtools {
+
+// Owned storage backing a context created by spvContextCreateForProfile.
+// The vectors hold grammar entries filtered to the profile and re-packed
+// dense; the table structs point into them.  One instance is shared by
+// every context created for the same profile, so repeated creations reuse
+// one filtered copy.
+struct SubsettedGrammar {
+  std::vector<spv_opcode_desc_t> opcode_entries;
+  std::unique_ptr<spv_opcode_table_t> opcode_table;
+  // One entry vector per operand-type group, in the full table's group
+  // order.  A group whose entries are all filtered out stays in place with
+  // a count of zero.
+  std::vector<std::vector<spv_operand_desc_t>> operand_entries;
+  std::vector<spv_operand_desc_group_t> operand_groups;
+  std::unique_ptr<spv_operand_table_t> operand_table;
+};
+
+namespace val {
+
+// Hashes of function bodies that already passed the validator's
+// per-instruction checks using one spv_context.  Keyed across validation
+// runs, so validating many module variants that share most of their
+// functions only pays the per-instruction checks for bodies it has not
+// seen before.  The mutex guards the set: one context may be used by
+// several validation runs at once.
+struct ValidatedFunctionHashes {
+  std::mutex mutex;
+  std::unordered_set<uint64_t> hashes;
+};
+
+}  // namespace val
+}  // namespace spvtools
+
 struct spv_context_t {
   const spv_target_env target_env;
   const spv_opcode_table opcode_table;
   const spv_operand_table operand_table;
   const spv_ext_inst_table ext_inst_table;
   spvtools::MessageConsumer consumer;
+  // Whether |consumer| reads the message string.  When false, diagnostics
+  // are still delivered once per message, but their text may be empty so
+  // hot failure paths can skip formatting; see spvtools::DiagnosticStream.
+  bool consumer_needs_text;
+  // Hashes of function bodies (with their referenced module-scope slice)
+  // that already passed the validator's per-instruction checks with this
+  // context.  Shared across validation runs so repeated validation of
+  // identical functions can skip those checks; see
+  // val::ValidatedFunctionHashes.
+  std::shared_ptr<spvtools::val::ValidatedFunctionHashes>
+      validated_function_hashes;
+  // Owned grammar storage when this context was created for a profile by
+  // spvContextCreateForProfile; null for contexts over the full grammar.
+  // When set, opcode_table and operand_table point into it.
+  std::shared_ptr<const spvtools::SubsettedGrammar> subsetted_grammar;
 };
 
 namespace spvtools {
@@ -119,6 +174,11 @@ namespace spvtools {
 // Sets the message consumer to |consumer| in the given |context|. The original
 // message consumer will be overwritten.
 void SetContextMessageConsumer(spv_context context, MessageConsumer consumer);
+
+// Same as above, but additionally records whether the consumer reads the
+// message string; see spv_context_t::consumer_needs_text.
+void SetContextMessageConsumer(spv_context context, MessageConsumer consumer,
+                               bool needs_text);
 }  // namespace spvtools
 
 // Populates *table with entries for env.
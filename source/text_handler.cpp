@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <tuple>
 
 #include "source/assembly_grammar.h"
@@ -34,25 +36,60 @@
 namespace spvtools {
 namespace {
 
+// Classification bits for each byte, used by the scanning loops below.  A
+// single table lookup replaces the per-character switch, so the hot loops can
+// skip over long runs of ordinary word or whitespace characters cheaply.
+enum CharacterClass : uint8_t {
+  kCharSpace = 1 << 0,          // ' ', '\t' or '\r'
+  kCharNewline = 1 << 1,        // '\n'
+  kCharComment = 1 << 2,        // ';'
+  kCharWordEnd = 1 << 3,        // any unquoted character that ends a word
+  kCharQuoteOrEscape = 1 << 4,  // '"' or '\\'
+};
+
+// Returns the 256-entry byte classification table.
+const uint8_t* GetCharClasses() {
+  static const struct Table {
+    Table() {
+      memset(classes, 0, sizeof(classes));
+      classes[uint8_t(' ')] = kCharSpace | kCharWordEnd;
+      classes[uint8_t('\t')] = kCharSpace | kCharWordEnd;
+      classes[uint8_t('\r')] = kCharSpace | kCharWordEnd;
+      classes[uint8_t('\n')] = kCharNewline | kCharWordEnd;
+      classes[uint8_t(';')] = kCharComment | kCharWordEnd;
+      classes[uint8_t('\0')] = kCharWordEnd;
+      classes[uint8_t('"')] = kCharQuoteOrEscape;
+      classes[uint8_t('\\')] = kCharQuoteOrEscape;
+    }
+    uint8_t classes[256];
+  } table;
+  return table.classes;
+}
+
 // Advances |text| to the start of the next line and writes the new position to
 // |position|.
 spv_result_t advanceLine(spv_text text, spv_position position) {
-  while (true) {
-    if (position->index >= text->length) return SPV_END_OF_STREAM;
-    switch (text->str[position->index]) {
-      case '\0':
-        return SPV_END_OF_STREAM;
-      case '\n':
-        position->column = 0;
-        position->line++;
-        position->index++;
-        return SPV_SUCCESS;
-      default:
-        position->column++;
-        position->index++;
-        break;
-    }
+  const char* line = text->str + position->index;
+  const size_t remaining = text->length - position->index;
+  const char* newline =
+      static_cast<const char*>(memchr(line, '\n', remaining));
+  const size_t line_length = newline ? size_t(newline - line) : remaining;
+  // A null terminator before the newline ends the stream.
+  const char* nul = static_cast<const char*>(memchr(line, '\0', line_length));
+  if (nul) {
+    position->column += nul - line;
+    position->index += nul - line;
+    return SPV_END_OF_STREAM;
+  }
+  if (!newline) {
+    position->column += line_length;
+    position->index += line_length;
+    return SPV_END_OF_STREAM;
   }
+  position->column = 0;
+  position->line++;
+  position->index += line_length + 1;
+  return SPV_SUCCESS;
 }
 
 // Advances |text| to first non white space character and writes the new
@@ -61,29 +98,35 @@ spv_result_t advanceLine(spv_text text, spv_position position) {
 // returned, SPV_SUCCESS otherwise. No error checking is performed on the
 // parameters, its the users responsibility to ensure these are non null.
 spv_result_t advance(spv_text text, spv_position position) {
+  const uint8_t* classes = GetCharClasses();
   // NOTE: Consume white space, otherwise don't advance.
   while (true) {
     if (position->index >= text->length) return SPV_END_OF_STREAM;
-    switch (text->str[position->index]) {
-      case '\0':
-        return SPV_END_OF_STREAM;
-      case ';':
-        if (spv_result_t error = advanceLine(text, position)) return error;
-        continue;
-      case ' ':
-      case '\t':
-      case '\r':
-        position->column++;
-        position->index++;
-        continue;
-      case '\n':
-        position->column = 0;
-        position->line++;
-        position->index++;
-        continue;
-      default:
-        return SPV_SUCCESS;
+    const char ch = text->str[position->index];
+    const uint8_t char_class = classes[static_cast<uint8_t>(ch)];
+    if (char_class & kCharSpace) {
+      // Skip the whole run of spaces, tabs and carriage returns at once.
+      size_t index = position->index + 1;
+      while (index < text->length &&
+             (classes[static_cast<uint8_t>(text->str[index])] & kCharSpace)) {
+        index++;
+      }
+      position->column += index - position->index;
+      position->index = index;
+      continue;
     }
+    if (char_class & kCharNewline) {
+      position->column = 0;
+      position->line++;
+      position->index++;
+      continue;
+    }
+    if (char_class & kCharComment) {
+      if (spv_result_t error = advanceLine(text, position)) return error;
+      continue;
+    }
+    if (ch == '\0') return SPV_END_OF_STREAM;
+    return SPV_SUCCESS;
   }
 }
 
@@ -102,8 +145,22 @@ spv_result_t getWord(spv_text text, spv_position position, std::string* word) {
   bool quoting = false;
   bool escaping = false;
 
+  const uint8_t* classes = GetCharClasses();
+
   // NOTE: Assumes first character is not white space!
   while (true) {
+    if (!escaping) {
+      // Skip the run of ordinary characters in front of the cursor; they
+      // cannot end the word or change the quoting state regardless of
+      // whether we are inside a quoted string.
+      size_t index = position->index;
+      while (index < text->length &&
+             classes[static_cast<uint8_t>(text->str[index])] == 0) {
+        index++;
+      }
+      position->column += index - position->index;
+      position->index = index;
+    }
     if (position->index >= text->length) {
       word->assign(text->str + start_index, text->str + position->index);
       return SPV_SUCCESS;
@@ -149,10 +206,69 @@ bool startsWithOp(spv_text text, spv_position position) {
   return ('O' == ch0 && 'p' == ch1 && ('A' <= ch2 && ch2 <= 'Z'));
 }
 
+// Parses |text| as a canonical decimal numeral: digits only, no leading
+// zero unless the numeral is "0" itself, and a value that fits in 32 bits.
+// Returns true on success and stores the value in |*value|.  Any other
+// spelling of a number ("0x1A", "007") is rejected so that the caller can
+// treat canonical numerals and all remaining names uniformly as distinct
+// strings.
+bool ParseCanonicalNumeral(const char* text, uint32_t* value) {
+  if (text[0] < '0' || text[0] > '9') return false;
+  if (text[0] == '0' && text[1] != '\0') return false;
+  uint64_t parsed = 0;
+  for (const char* p = text; *p; ++p) {
+    if (*p < '0' || *p > '9') return false;
+    parsed = parsed * 10 + static_cast<uint64_t>(*p - '0');
+    if (parsed > std::numeric_limits<uint32_t>::max()) return false;
+  }
+  *value = static_cast<uint32_t>(parsed);
+  return true;
+}
+
 }  // namespace
 
 const IdType kUnknownType = {0, false, IdTypeClass::kBottom};
 
+uint64_t NamedIdTable::HashName(const char* name) {
+  // FNV-1a, as elsewhere in this code base.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char* p = name; *p; ++p) {
+    hash = (hash ^ static_cast<uint8_t>(*p)) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+void NamedIdTable::Grow() {
+  std::vector<uint32_t> new_slots(slots_.size() * 2, 0);
+  const size_t mask = new_slots.size() - 1;
+  for (uint32_t index = 0; index < entries_.size(); ++index) {
+    size_t slot = HashName(entries_[index].first.c_str()) & mask;
+    while (new_slots[slot] != 0) slot = (slot + 1) & mask;
+    new_slots[slot] = index + 1;
+  }
+  slots_.swap(new_slots);
+}
+
+uint32_t& NamedIdTable::FindOrCreate(const char* name, bool* added) {
+  // Keep the table at most three-quarters full so probe sequences stay short.
+  if ((entries_.size() + 1) * 4 > slots_.size() * 3) Grow();
+
+  const size_t mask = slots_.size() - 1;
+  size_t slot = HashName(name) & mask;
+  while (slots_[slot] != 0) {
+    std::pair<std::string, uint32_t>& entry = entries_[slots_[slot] - 1];
+    if (entry.first == name) {
+      *added = false;
+      return entry.second;
+    }
+    slot = (slot + 1) & mask;
+  }
+  entries_.emplace_back(name, 0u);
+  slots_[slot] = static_cast<uint32_t>(entries_.size());
+  *added = true;
+  return entries_.back().second;
+}
+
 // TODO(dneto): Reorder AssemblyContext definitions to match declaration order.
 
 // This represents all of the data that is only valid for the duration of
@@ -168,21 +284,43 @@ uint32_t AssemblyContext::spvNamedIdAssignOrGet(const char* textValue) {
     }
   }
 
-  const auto it = named_ids_.find(textValue);
-  if (it == named_ids_.end()) {
-    uint32_t id = next_id_++;
-    if (!ids_to_preserve_.empty()) {
-      while (ids_to_preserve_.find(id) != ids_to_preserve_.end()) {
-        id = next_id_++;
-      }
+  // Machine-generated assembly writes every ID as a canonical decimal
+  // numeral, so resolve those through a dense array instead of the string
+  // hash table.  Whether a name takes this path depends only on its
+  // spelling, never on table state, so each distinct name consistently
+  // resolves through exactly one of the two tables.
+  uint32_t numeral = 0;
+  if (ParseCanonicalNumeral(textValue, &numeral) &&
+      numeral <= kMaxNumericName) {
+    if (numeral >= numeric_name_to_id_.size()) {
+      numeric_name_to_id_.resize(
+          std::max<size_t>(numeral + 1, 2 * numeric_name_to_id_.size()), 0);
+    }
+    uint32_t& id_slot = numeric_name_to_id_[numeral];
+    if (id_slot == 0) {
+      id_slot = AssignFreshId();
     }
+    return id_slot;
+  }
 
-    named_ids_.emplace(textValue, id);
-    bound_ = std::max(bound_, id + 1);
-    return id;
+  bool added = false;
+  uint32_t& id_slot = named_ids_.FindOrCreate(textValue, &added);
+  if (added) {
+    id_slot = AssignFreshId();
   }
 
-  return it->second;
+  return id_slot;
+}
+
+uint32_t AssemblyContext::AssignFreshId() {
+  uint32_t id = next_id_++;
+  if (!ids_to_preserve_.empty()) {
+    while (ids_to_preserve_.find(id) != ids_to_preserve_.end()) {
+      id = next_id_++;
+    }
+  }
+  bound_ = std::max(bound_, id + 1);
+  return id;
 }
 
 uint32_t AssemblyContext::getBound() const { return bound_; }
@@ -384,7 +522,12 @@ spv_ext_inst_type_t AssemblyContext::getExtInstTypeForId(uint32_t id) const {
 
 std::set<uint32_t> AssemblyContext::GetNumericIds() const {
   std::set<uint32_t> ids;
-  for (const auto& kv : named_ids_) {
+  for (uint32_t numeral = 0;
+       numeral < static_cast<uint32_t>(numeric_name_to_id_.size());
+       ++numeral) {
+    if (numeric_name_to_id_[numeral] != 0) ids.insert(numeral);
+  }
+  for (const auto& kv : named_ids_.entries()) {
     uint32_t id;
     if (spvtools::utils::ParseNumber(kv.first.c_str(), &id)) ids.insert(id);
   }
@@ -22,6 +22,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "source/diagnostic.h"
 #include "source/instruction.h"
@@ -117,6 +118,42 @@ class ClampToZeroIfUnsignedType<
   }
 };
 
+// Maps ID names to their numeric ids through an open-addressing hash table.
+// The characters of each distinct name are stored once, on first insertion;
+// looking a name up hashes and compares the caller's characters in place, so
+// a name that has been seen before costs no allocation.  This matters because
+// the assembler queries this table for every ID use in the source text.
+class NamedIdTable {
+ public:
+  NamedIdTable() : slots_(kInitialSlotCount, 0) {}
+
+  // Returns a reference to the numeric id slot for |name|.  If the name has
+  // not been seen before a new entry with an id of 0 is inserted and |*added|
+  // is set to true; otherwise |*added| is set to false.
+  uint32_t& FindOrCreate(const char* name, bool* added);
+
+  // Returns the (name, id) pairs, in insertion order.
+  const std::vector<std::pair<std::string, uint32_t>>& entries() const {
+    return entries_;
+  }
+
+ private:
+  // The initial size of slots_.  Must be a power of two.
+  static constexpr size_t kInitialSlotCount = 64;
+
+  // Returns a FNV-1a hash of the characters of |name|.
+  static uint64_t HashName(const char* name);
+
+  // Doubles the slot count and re-disperses the entries.
+  void Grow();
+
+  // The (name, id) entries, in insertion order.
+  std::vector<std::pair<std::string, uint32_t>> entries_;
+  // Open-addressed, linearly probed table of indices-plus-one into entries_,
+  // where 0 marks an empty slot.  The size is always a power of two.
+  std::vector<uint32_t> slots_;
+};
+
 // Encapsulates the data used during the assembly of a SPIR-V module.
 class AssemblyContext {
  public:
@@ -239,14 +276,28 @@ class AssemblyContext {
   std::set<uint32_t> GetNumericIds() const;
 
  private:
-  // Maps ID names to their corresponding numerical ids.
-  using spv_named_id_table = std::unordered_map<std::string, uint32_t>;
   // Maps type-defining IDs to their IdType.
   using spv_id_to_type_map = std::unordered_map<uint32_t, IdType>;
   // Maps Ids to the id of their type.
   using spv_id_to_type_id = std::unordered_map<uint32_t, uint32_t>;
 
-  spv_named_id_table named_ids_;
+  // Returns a fresh numerical id, skipping over the ids to preserve, and
+  // accounts for it in the module's id bound.
+  uint32_t AssignFreshId();
+
+  // The largest ID name value served by the dense numeric-name fast path.
+  // This matches the maximum valid id bound, so the fast-path array can
+  // never grow past the ids a well-formed module could use.
+  static constexpr uint32_t kMaxNumericName = 0x3FFFFF;
+
+  // Maps ID names to their corresponding numerical ids.
+  NamedIdTable named_ids_;
+  // Fast path for machine-generated assembly, which writes every ID as a
+  // canonical decimal numeral: entry |n| holds the id assigned to the name
+  // "n", or 0 if that name has not been seen.  Non-canonical numerals
+  // (leading zeros, out-of-range values) go through named_ids_ instead so
+  // that distinct names always map to distinct ids.
+  std::vector<uint32_t> numeric_name_to_id_;
   spv_id_to_type_map types_;
   spv_id_to_type_id value_types_;
   // Maps an extended instruction import Id to the extended instruction type.
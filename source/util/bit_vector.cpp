@@ -22,15 +22,7 @@ namespace utils {
 
 void BitVector::ReportDensity(std::ostream& out) {
   uint32_t count = 0;
-
-  for (BitContainer e : bits_) {
-    while (e != 0) {
-      if ((e & 1) != 0) {
-        ++count;
-      }
-      e = e >> 1;
-    }
-  }
+  ForEachSetBit([&count](uint32_t) { ++count; });
 
   out << "count=" << count
       << ", total size (bytes)=" << bits_.size() * sizeof(BitContainer)
@@ -39,23 +31,19 @@ void BitVector::ReportDensity(std::ostream& out) {
 }
 
 bool BitVector::Or(const BitVector& other) {
-  auto this_it = this->bits_.begin();
-  auto other_it = other.bits_.begin();
-  bool modified = false;
+  if (other.bits_.size() > bits_.size()) {
+    bits_.resize(other.bits_.size(), 0);
+    summary_.resize((bits_.size() - 1) / kBitContainerSize + 1, 0);
+  }
 
-  while (this_it != this->bits_.end() && other_it != other.bits_.end()) {
-    auto temp = *this_it | *other_it;
-    if (temp != *this_it) {
+  bool modified = false;
+  for (size_t i = 0; i < other.bits_.size(); ++i) {
+    BitContainer temp = bits_[i] | other.bits_[i];
+    if (temp != bits_[i]) {
       modified = true;
-      *this_it = temp;
+      bits_[i] = temp;
+      SetSummaryBit(i);
     }
-    ++this_it;
-    ++other_it;
-  }
-
-  if (other_it != other.bits_.end()) {
-    modified = true;
-    this->bits_.insert(this->bits_.end(), other_it, other.bits_.end());
   }
 
   return modified;
@@ -63,17 +51,7 @@ bool BitVector::Or(const BitVector& other) {
 
 std::ostream& operator<<(std::ostream& out, const BitVector& bv) {
   out << "{";
-  for (uint32_t i = 0; i < bv.bits_.size(); ++i) {
-    BitVector::BitContainer b = bv.bits_[i];
-    uint32_t j = 0;
-    while (b != 0) {
-      if (b & 1) {
-        out << ' ' << i * BitVector::kBitContainerSize + j;
-      }
-      ++j;
-      b = b >> 1;
-    }
-  }
+  bv.ForEachSetBit([&out](uint32_t i) { out << ' ' << i; });
   out << "}";
   return out;
 }
@@ -15,16 +15,26 @@
 #ifndef SOURCE_UTIL_BIT_VECTOR_H_
 #define SOURCE_UTIL_BIT_VECTOR_H_
 
+#include <cassert>
 #include <cstdint>
 #include <iosfwd>
 #include <vector>
 
+#include "source/util/bitutils.h"
+
 namespace spvtools {
 namespace utils {
 
 // Implements a bit vector class.
 //
 // All bits default to zero, and the upper bound is 2^32-1.
+//
+// The words holding the bits are backed by a summary level with one bit per
+// word, telling whether that word holds any set bit at all.  Iteration and
+// emptiness tests use the summary to skip over empty regions, so their cost
+// scales with the number of set bits rather than with the size of the
+// vector; this matters to users like ADCE whose liveness sets span millions
+// of instruction ordinals of which only a few percent are ever live.
 class BitVector {
  private:
   using BitContainer = uint64_t;
@@ -34,7 +44,8 @@ class BitVector {
  public:
   // Creates a bit vector containing 0s.
   BitVector(uint32_t reserved_size = kInitialNumBits)
-      : bits_((reserved_size - 1) / kBitContainerSize + 1, 0) {}
+      : bits_((reserved_size - 1) / kBitContainerSize + 1, 0),
+        summary_((bits_.size() - 1) / kBitContainerSize + 1, 0) {}
 
   // Sets the |i|th bit to 1.  Returns the |i|th bit before it was set.
   bool Set(uint32_t i) {
@@ -43,6 +54,7 @@ class BitVector {
 
     if (element_index >= bits_.size()) {
       bits_.resize(element_index + 1, 0);
+      summary_.resize(element_index / kBitContainerSize + 1, 0);
     }
 
     BitContainer original = bits_[element_index];
@@ -52,6 +64,7 @@ class BitVector {
       return true;
     } else {
       bits_[element_index] = original | ith_bit;
+      SetSummaryBit(element_index);
       return false;
     }
   }
@@ -72,6 +85,9 @@ class BitVector {
       return false;
     } else {
       bits_[element_index] = original & (~ith_bit);
+      if (bits_[element_index] == 0) {
+        ClearSummaryBit(element_index);
+      }
       return true;
     }
   }
@@ -91,7 +107,7 @@ class BitVector {
 
   // Returns true if every bit is 0.
   bool Empty() const {
-    for (BitContainer b : bits_) {
+    for (BitContainer b : summary_) {
       if (b != 0) {
         return false;
       }
@@ -99,6 +115,26 @@ class BitVector {
     return true;
   }
 
+  // Invokes |f| with the index of every set bit, in increasing order.  The
+  // summary level skips runs of empty words, and count-trailing-zeros jumps
+  // from one set bit to the next inside a word.
+  template <typename Callable>
+  void ForEachSetBit(Callable f) const {
+    for (size_t summary_index = 0; summary_index < summary_.size();
+         ++summary_index) {
+      for (BitContainer summary_word = summary_[summary_index];
+           summary_word != 0; summary_word &= summary_word - 1) {
+        const size_t element_index = summary_index * kBitContainerSize +
+                                     CountTrailingZeros(summary_word);
+        for (BitContainer word = bits_[element_index]; word != 0;
+             word &= word - 1) {
+          f(static_cast<uint32_t>(element_index * kBitContainerSize +
+                                  CountTrailingZeros(word)));
+        }
+      }
+    }
+  }
+
   // Print a report on the densicy of the bit vector, number of 1 bits, number
   // of bytes, and average bytes for 1 bit, to |out|.
   void ReportDensity(std::ostream& out);
@@ -110,7 +146,21 @@ class BitVector {
   bool Or(const BitVector& that);
 
  private:
+  // Records in the summary that the word at |element_index| has a set bit.
+  void SetSummaryBit(size_t element_index) {
+    summary_[element_index / kBitContainerSize] |=
+        static_cast<BitContainer>(1) << (element_index % kBitContainerSize);
+  }
+
+  // Records in the summary that the word at |element_index| is all zeros.
+  void ClearSummaryBit(size_t element_index) {
+    summary_[element_index / kBitContainerSize] &=
+        ~(static_cast<BitContainer>(1) << (element_index % kBitContainerSize));
+  }
+
   std::vector<BitContainer> bits_;
+  // One bit per entry of |bits_|, telling whether that word is non-zero.
+  std::vector<BitContainer> summary_;
 };
 
 }  // namespace utils
@@ -20,6 +20,10 @@
 #include <cstring>
 #include <type_traits>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace spvtools {
 namespace utils {
 
@@ -33,6 +37,25 @@ Dest BitwiseCast(Src source) {
   return dest;
 }
 
+// Returns the index of the lowest set bit of |word|, which must not be 0.
+inline uint32_t CountTrailingZeros(uint64_t word) {
+  assert(word != 0 && "The count is undefined for 0");
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long result;
+  _BitScanForward64(&result, word);
+  return static_cast<uint32_t>(result);
+#elif defined(_MSC_VER)
+  unsigned long result;
+  if (_BitScanForward(&result, static_cast<uint32_t>(word))) {
+    return static_cast<uint32_t>(result);
+  }
+  _BitScanForward(&result, static_cast<uint32_t>(word >> 32));
+  return static_cast<uint32_t>(result) + 32;
+#else
+  return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+}
+
 // Calculates the bit width of the integer type |T|.
 template <typename T>
 struct IntegerBitWidth {
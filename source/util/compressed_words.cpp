@@ -0,0 +1,206 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/compressed_words.h"
+
+#include <cstring>
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+// The first byte of a compressed buffer selects the representation.
+constexpr uint8_t kFormatRaw = 0;   // Followed by the original bytes.
+constexpr uint8_t kFormatLz77 = 1;  // Followed by the token stream.
+
+// A sequence is a token byte holding a literal count and a match length,
+// each saturating into extension bytes of 255.  Matches are at least
+// kMinMatch long; the stored match length is biased by that minimum.
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 0xffff;
+constexpr uint32_t kHashLog = 13;
+
+// Matching stops this many bytes before the end so the final sequence is
+// always a pure literal run, which keeps the decoder's copy loops simple.
+constexpr size_t kTailLiterals = 12;
+
+uint32_t Read32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t Hash(const uint8_t* p) {
+  return (Read32(p) * 2654435761u) >> (32 - kHashLog);
+}
+
+// Appends |value| as a saturating count: the low nibble (or literal nibble)
+// already holds min(value, 15); this emits the remainder.
+void AppendExtension(size_t value, std::vector<uint8_t>* out) {
+  if (value < 15) return;
+  value -= 15;
+  while (value >= 255) {
+    out->push_back(255);
+    value -= 255;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+// Reads a saturating count whose low nibble was |nibble|.  Returns false on
+// a truncated stream.
+bool ReadExtension(const uint8_t* data, size_t size, size_t* pos,
+                   size_t nibble, size_t* value) {
+  *value = nibble;
+  if (nibble < 15) return true;
+  for (;;) {
+    if (*pos >= size) return false;
+    const uint8_t byte = data[(*pos)++];
+    *value += byte;
+    if (byte != 255) return true;
+  }
+}
+
+}  // namespace
+
+std::vector<uint8_t> CompressWords(const uint32_t* words, size_t num_words) {
+  if (words == nullptr || num_words == 0) return {kFormatRaw};
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(words);
+  const size_t src_size = num_words * sizeof(uint32_t);
+
+  std::vector<uint8_t> out;
+  out.reserve(src_size / 2 + 16);
+  out.push_back(kFormatLz77);
+
+  // Positions of recently seen 4-byte groups, biased by one so that zero
+  // means empty.
+  std::vector<uint32_t> table(size_t(1) << kHashLog, 0);
+
+  const size_t match_end = src_size > kTailLiterals ? src_size - kTailLiterals
+                                                    : 0;
+  size_t ip = 0;
+  size_t anchor = 0;
+  while (ip < match_end) {
+    const uint32_t hash = Hash(src + ip);
+    const size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(ip + 1);
+    if (candidate == 0 || ip - (candidate - 1) > kMaxOffset ||
+        Read32(src + candidate - 1) != Read32(src + ip)) {
+      ++ip;
+      continue;
+    }
+
+    const size_t match_pos = candidate - 1;
+    size_t match_len = kMinMatch;
+    while (ip + match_len < match_end &&
+           src[match_pos + match_len] == src[ip + match_len]) {
+      ++match_len;
+    }
+
+    const size_t literal_len = ip - anchor;
+    const uint8_t literal_nibble =
+        static_cast<uint8_t>(literal_len < 15 ? literal_len : 15);
+    const size_t biased_match = match_len - kMinMatch;
+    const uint8_t match_nibble =
+        static_cast<uint8_t>(biased_match < 15 ? biased_match : 15);
+    out.push_back(static_cast<uint8_t>((literal_nibble << 4) | match_nibble));
+    AppendExtension(literal_len, &out);
+    out.insert(out.end(), src + anchor, src + ip);
+    const size_t offset = ip - match_pos;
+    out.push_back(static_cast<uint8_t>(offset & 0xff));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    AppendExtension(biased_match, &out);
+
+    ip += match_len;
+    anchor = ip;
+  }
+
+  // The remaining bytes form a final literal-only sequence.
+  const size_t literal_len = src_size - anchor;
+  const uint8_t literal_nibble =
+      static_cast<uint8_t>(literal_len < 15 ? literal_len : 15);
+  out.push_back(static_cast<uint8_t>(literal_nibble << 4));
+  AppendExtension(literal_len, &out);
+  out.insert(out.end(), src + anchor, src + src_size);
+
+  if (out.size() > src_size + 1) {
+    // Incompressible input; store it verbatim.
+    out.clear();
+    out.push_back(kFormatRaw);
+    out.insert(out.end(), src, src + src_size);
+  }
+  out.shrink_to_fit();
+  return out;
+}
+
+bool DecompressWords(const std::vector<uint8_t>& data, size_t num_words,
+                     std::vector<uint32_t>* out) {
+  out->clear();
+  const size_t dst_size = num_words * sizeof(uint32_t);
+  if (data.empty()) return false;
+
+  if (data[0] == kFormatRaw) {
+    if (data.size() != dst_size + 1) return false;
+    out->resize(num_words);
+    if (dst_size != 0) std::memcpy(out->data(), data.data() + 1, dst_size);
+    return true;
+  }
+  if (data[0] != kFormatLz77) return false;
+
+  std::vector<uint8_t> dst(dst_size);
+  size_t pos = 1;
+  size_t written = 0;
+  while (pos < data.size()) {
+    const uint8_t token = data[pos++];
+
+    size_t literal_len;
+    if (!ReadExtension(data.data(), data.size(), &pos, token >> 4,
+                       &literal_len)) {
+      return false;
+    }
+    if (pos + literal_len > data.size() || written + literal_len > dst_size) {
+      return false;
+    }
+    std::memcpy(dst.data() + written, data.data() + pos, literal_len);
+    pos += literal_len;
+    written += literal_len;
+
+    // A stream ends on the literals of its last sequence.
+    if (pos == data.size()) break;
+
+    if (pos + 2 > data.size()) return false;
+    const size_t offset = data[pos] | (size_t(data[pos + 1]) << 8);
+    pos += 2;
+    size_t match_len;
+    if (!ReadExtension(data.data(), data.size(), &pos, token & 0xf,
+                       &match_len)) {
+      return false;
+    }
+    match_len += kMinMatch;
+    if (offset == 0 || offset > written || written + match_len > dst_size) {
+      return false;
+    }
+    // Byte-at-a-time copy: the match may overlap its own output.
+    for (size_t i = 0; i < match_len; ++i, ++written) {
+      dst[written] = dst[written - offset];
+    }
+  }
+  if (written != dst_size) return false;
+
+  out->resize(num_words);
+  if (dst_size != 0) std::memcpy(out->data(), dst.data(), dst_size);
+  return true;
+}
+
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,49 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_COMPRESSED_WORDS_H_
+#define SOURCE_UTIL_COMPRESSED_WORDS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A byte-oriented LZ77 codec for SPIR-V word buffers, used to keep modules
+// that are at rest (queued for a batch tool, retained for later reuse)
+// compact in memory.  The format is a token stream in the style of the LZ4
+// block format: each sequence is a run of literal bytes followed by a
+// back-reference of at least four bytes within a 64KiB window.  SPIR-V
+// modules are full of repeated word patterns (type and constant sections,
+// decoration blocks, similar instructions), which greedy matching captures
+// well at a small, one-pass cost.
+//
+// Buffers that do not shrink are stored verbatim behind the same interface,
+// so compression never costs more than one byte of overhead.
+
+// Compresses |num_words| words of |words| and returns the compressed bytes.
+std::vector<uint8_t> CompressWords(const uint32_t* words, size_t num_words);
+
+// Decompresses |data| produced by CompressWords into |out|, which receives
+// exactly |num_words| words.  Returns false if |data| is malformed or does
+// not decompress to |num_words| words; |out| is then left empty.
+bool DecompressWords(const std::vector<uint8_t>& data, size_t num_words,
+                     std::vector<uint32_t>* out);
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_COMPRESSED_WORDS_H_
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/decimal_format.h"
+
+#include <cassert>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+// The two decimal digits of every value in [0, 100), so the integer
+// formatter emits two digits per division.
+const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+}  // namespace
+
+size_t FormatDecimal(uint64_t value, char* buffer) {
+  // Generate digits from least significant into the tail of a scratch
+  // buffer, two at a time.
+  char digits[20];
+  size_t pos = sizeof(digits);
+  while (value >= 100) {
+    const size_t pair = static_cast<size_t>(value % 100) * 2;
+    value /= 100;
+    pos -= 2;
+    digits[pos] = kDigitPairs[pair];
+    digits[pos + 1] = kDigitPairs[pair + 1];
+  }
+  if (value >= 10) {
+    const size_t pair = static_cast<size_t>(value) * 2;
+    pos -= 2;
+    digits[pos] = kDigitPairs[pair];
+    digits[pos + 1] = kDigitPairs[pair + 1];
+  } else {
+    digits[--pos] = static_cast<char>('0' + value);
+  }
+  const size_t num_chars = sizeof(digits) - pos;
+  memcpy(buffer, digits + pos, num_chars);
+  return num_chars;
+}
+
+size_t FormatDecimal(int64_t value, char* buffer) {
+  uint64_t magnitude = static_cast<uint64_t>(value);
+  size_t num_chars = 0;
+  if (value < 0) {
+    buffer[num_chars++] = '-';
+    // Negating the unsigned bit pattern is well defined even for the most
+    // negative value.
+    magnitude = 0 - magnitude;
+  }
+  return num_chars + FormatDecimal(magnitude, buffer + num_chars);
+}
+
+size_t FormatGeneralFloat(double value, int precision, char* buffer) {
+  char scratch[kMaxDecimalChars + 1];
+  const int num_chars =
+      snprintf(scratch, sizeof(scratch), "%.*g", precision, value);
+  assert(num_chars > 0 && static_cast<size_t>(num_chars) < sizeof(scratch) &&
+         "The buffer must be large enough for any %g conversion.");
+
+  // snprintf honours LC_NUMERIC but the emitted text must not.  The only
+  // locale-dependent piece a "%g" conversion can produce is the decimal
+  // point, so rewrite it to '.' when the locale uses something else.
+  const char* point = localeconv()->decimal_point;
+  const size_t point_len = strlen(point);
+  if (point_len == 1 && point[0] == '.') {
+    memcpy(buffer, scratch, static_cast<size_t>(num_chars));
+    return static_cast<size_t>(num_chars);
+  }
+  size_t out = 0;
+  for (int i = 0; i < num_chars;) {
+    if (strncmp(scratch + i, point, point_len) == 0) {
+      buffer[out++] = '.';
+      i += static_cast<int>(point_len);
+    } else {
+      buffer[out++] = scratch[i++];
+    }
+  }
+  return out;
+}
+
+}  // namespace utils
+}  // namespace spvtools
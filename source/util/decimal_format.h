@@ -0,0 +1,52 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_DECIMAL_FORMAT_H_
+#define SOURCE_UTIL_DECIMAL_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace spvtools {
+namespace utils {
+
+// Fast, locale-independent formatting of numeric literals into character
+// buffers.  The functions produce exactly the characters that the
+// default-formatted std::ostream insertion operators produce in the classic
+// locale, without the sentry, virtual dispatch, and locale machinery of
+// iostreams, and without depending on the global locale.
+
+// Big enough for any value the formatters below can produce: a 64-bit
+// integer needs at most 20 digits plus a sign, and "%.17g" output needs at
+// most 25 characters.
+constexpr size_t kMaxDecimalChars = 32;
+
+// Writes the decimal digits of |value| to |buffer|, which must have room
+// for at least kMaxDecimalChars characters, and returns the number of
+// characters written.  No terminating null is written.
+size_t FormatDecimal(uint64_t value, char* buffer);
+size_t FormatDecimal(int64_t value, char* buffer);
+
+// Writes |value| to |buffer|, which must have room for at least
+// kMaxDecimalChars characters, formatted as the classic-locale "%.*g"
+// printf conversion with |precision| significant digits — the same
+// characters a default-formatted stream insertion with that precision
+// produces — and returns the number of characters written.  No terminating
+// null is written.
+size_t FormatGeneralFloat(double value, int precision, char* buffer);
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_DECIMAL_FORMAT_H_
@@ -0,0 +1,111 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/numa_thread_pool.h"
+
+#include <utility>
+
+#include "source/util/make_unique.h"
+
+#if defined(SPIRV_LINUX)
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+#if defined(SPIRV_LINUX)
+// Fills |cpus| with the CPUs of NUMA node |node| as listed in sysfs, e.g.
+// "0-23,48-71".  Returns false if the node's cpulist cannot be read, in
+// which case workers stay unpinned.
+bool ReadNodeCpus(size_t node, cpu_set_t* cpus) {
+  std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+  std::string cpulist;
+  if (!file || !std::getline(file, cpulist)) return false;
+
+  CPU_ZERO(cpus);
+  std::istringstream ranges(cpulist);
+  std::string range;
+  bool any = false;
+  while (std::getline(ranges, range, ',')) {
+    unsigned long first = 0;
+    unsigned long last = 0;
+    const size_t dash = range.find('-');
+    first = std::strtoul(range.c_str(), nullptr, 10);
+    last = dash == std::string::npos
+               ? first
+               : std::strtoul(range.c_str() + dash + 1, nullptr, 10);
+    for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(static_cast<int>(cpu), cpus);
+      any = true;
+    }
+  }
+  return any;
+}
+
+// Pins the calling thread to the CPUs of NUMA node |node|.  Best effort:
+// an unpinned worker only costs locality, not correctness.
+void PinToNode(size_t node) {
+  cpu_set_t cpus;
+  if (!ReadNodeCpus(node, &cpus)) return;
+  pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+#endif  // defined(SPIRV_LINUX)
+
+}  // anonymous namespace
+
+NumaThreadPool::NumaThreadPool(size_t num_nodes, size_t threads_per_node) {
+  if (num_nodes == 0) num_nodes = 1;
+  node_pools_.reserve(num_nodes);
+  for (size_t node = 0; node < num_nodes; ++node) {
+#if defined(SPIRV_LINUX)
+    node_pools_.push_back(MakeUnique<ThreadPool>(
+        threads_per_node, [node](size_t) { PinToNode(node); }));
+#else
+    node_pools_.push_back(MakeUnique<ThreadPool>(threads_per_node));
+#endif
+  }
+}
+
+void NumaThreadPool::Schedule(size_t affinity_key,
+                              std::function<void()> task) {
+  node_pools_[affinity_key % node_pools_.size()]->Schedule(std::move(task));
+}
+
+void NumaThreadPool::Wait() {
+  for (auto& pool : node_pools_) pool->Wait();
+}
+
+size_t NumaThreadPool::DefaultNodeCount() {
+#if defined(SPIRV_LINUX)
+  size_t count = 0;
+  while (std::ifstream("/sys/devices/system/node/node" +
+                       std::to_string(count) + "/cpulist")) {
+    ++count;
+  }
+  if (count > 0) return count;
+#endif
+  return 1;
+}
+
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,73 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_NUMA_THREAD_POOL_H_
+#define SOURCE_UTIL_NUMA_THREAD_POOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "source/util/thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+
+// A worker pool partitioned into one sub-pool per NUMA node, for batches of
+// independent jobs (for example one module each).
+//
+// Every task carries an affinity key, and all tasks with the same key run in
+// the same sub-pool.  On Linux the workers of each sub-pool are pinned to
+// the CPUs of their node, so with the kernel's default first-touch policy
+// everything a job allocates lands on the node that keeps processing it:
+// give all tasks touching one module the same key and its IRContext stays
+// node-local.  Tasks never migrate between sub-pools, so work is stolen
+// only within a node.
+//
+// On other platforms, and on single-node machines, this degrades to plain
+// ThreadPool behaviour with key-based sharding.
+class NumaThreadPool {
+ public:
+  // Creates |num_nodes| sub-pools with |threads_per_node| workers each.
+  // A |num_nodes| of 0 is treated as 1.  As with ThreadPool, a
+  // |threads_per_node| of 0 or 1 creates no worker threads: tasks then run
+  // on the caller's thread inside Wait().
+  NumaThreadPool(size_t num_nodes, size_t threads_per_node);
+
+  NumaThreadPool(const NumaThreadPool&) = delete;
+  NumaThreadPool& operator=(const NumaThreadPool&) = delete;
+
+  // Enqueues |task| on the sub-pool selected by |affinity_key|.  Tasks with
+  // equal keys always run on the same node.
+  void Schedule(size_t affinity_key, std::function<void()> task);
+
+  // Blocks until every task scheduled so far has finished executing.
+  void Wait();
+
+  // Returns the number of sub-pools.
+  size_t num_nodes() const { return node_pools_.size(); }
+
+  // Returns the number of NUMA nodes on this machine, or 1 when the
+  // topology cannot be determined (including on non-Linux platforms).
+  static size_t DefaultNodeCount();
+
+ private:
+  std::vector<std::unique_ptr<ThreadPool>> node_pools_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_NUMA_THREAD_POOL_H_
@@ -0,0 +1,110 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_ORDERED_COLLECTOR_H_
+#define SOURCE_UTIL_ORDERED_COLLECTOR_H_
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// Retires results produced out of order by parallel workers in sequence
+// order, as each becomes the oldest outstanding one.
+//
+// Results carry a dense sequence number starting at 0.  A wheel of slots
+// holds results that completed ahead of their turn; the emit callback runs
+// as soon as a delivered result, and then everything stored directly behind
+// it, is next in line.  The callback runs on the thread that delivered the
+// unblocking result, never concurrently with itself, and sees strictly
+// increasing sequence numbers, so batch loops get deterministic output
+// without buffering the whole batch or dedicating a thread to reordering.
+//
+// Deliver() blocks while the result is further ahead of the oldest
+// unemitted sequence than the wheel has slots.  That cannot stall a
+// ThreadPool whose tasks deliver their own index and were scheduled in
+// index order: the pool runs tasks FIFO, so the oldest unemitted sequence
+// is always executing or already delivered, never queued behind a blocked
+// later task.
+//
+// |Result| must be default-constructible and movable.
+template <typename Result>
+class OrderedCollector {
+ public:
+  // Creates a collector retiring results through |emit|.  |capacity| is the
+  // number of slots in the wheel and bounds how far ahead of the oldest
+  // unemitted sequence a worker may deliver without blocking; a small
+  // multiple of the worker count is usually right.
+  OrderedCollector(size_t capacity, std::function<void(size_t, Result&&)> emit)
+      : emit_(std::move(emit)),
+        slots_(capacity == 0 ? 1 : capacity),
+        occupied_(slots_.size(), false) {}
+
+  OrderedCollector(const OrderedCollector&) = delete;
+  OrderedCollector& operator=(const OrderedCollector&) = delete;
+
+  ~OrderedCollector() {
+    assert(std::find(occupied_.begin(), occupied_.end(), true) ==
+               occupied_.end() &&
+           "destroyed with results that were never retired; a sequence "
+           "number was skipped");
+  }
+
+  // Hands over the result for |sequence|.  Every sequence from 0 on up must
+  // be delivered exactly once.  Safe to call from any thread; blocks while
+  // the wheel has no slot for |sequence| yet.  The callback must not call
+  // back into the collector.
+  void Deliver(size_t sequence, Result result) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_freed_.wait(lock, [this, sequence] {
+      return sequence < next_to_emit_ + slots_.size();
+    });
+    assert(sequence >= next_to_emit_ && !occupied_[sequence % slots_.size()] &&
+           "sequence delivered twice");
+    slots_[sequence % slots_.size()] = std::move(result);
+    occupied_[sequence % slots_.size()] = true;
+    if (sequence != next_to_emit_) return;
+
+    // Retire this result and every stored successor.  Emitting under the
+    // lock keeps emissions serialized and in order.
+    while (occupied_[next_to_emit_ % slots_.size()]) {
+      const size_t current = next_to_emit_;
+      Result retired = std::move(slots_[current % slots_.size()]);
+      occupied_[current % slots_.size()] = false;
+      ++next_to_emit_;
+      emit_(current, std::move(retired));
+    }
+    slot_freed_.notify_all();
+  }
+
+ private:
+  std::function<void(size_t, Result&&)> emit_;
+  std::vector<Result> slots_;
+  std::vector<bool> occupied_;
+  size_t next_to_emit_ = 0;
+  std::mutex mutex_;
+  std::condition_variable slot_freed_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_ORDERED_COLLECTOR_H_
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/ordered_diagnostics.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace spvtools {
+namespace utils {
+
+MessageConsumer OrderedDiagnostics::Buffer::GetConsumer() {
+  return [this](spv_message_level_t level, const char* source,
+                const spv_position_t& position, const char* text) {
+    // Relaxed is enough: the tag only has to be unique and monotone with
+    // respect to other tags; the buffers themselves are published to the
+    // replaying thread by the caller's join.
+    const uint64_t sequence =
+        owner_->next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    messages_.push_back({sequence, level, source == nullptr ? "" : source,
+                         position, text == nullptr ? "" : text});
+  };
+}
+
+OrderedDiagnostics::Buffer* OrderedDiagnostics::CreateBuffer() {
+  buffers_.emplace_back(new Buffer(this));
+  return buffers_.back().get();
+}
+
+void OrderedDiagnostics::Replay() {
+  std::vector<const Buffer::Message*> all_messages;
+  for (const auto& buffer : buffers_) {
+    for (const Buffer::Message& message : buffer->messages_) {
+      all_messages.push_back(&message);
+    }
+  }
+  std::sort(all_messages.begin(), all_messages.end(),
+            [](const Buffer::Message* lhs, const Buffer::Message* rhs) {
+              return lhs->sequence < rhs->sequence;
+            });
+
+  if (downstream_ != nullptr) {
+    for (const Buffer::Message* message : all_messages) {
+      downstream_(message->level, message->source.c_str(), message->position,
+                  message->text.c_str());
+    }
+  }
+  for (auto& buffer : buffers_) {
+    buffer->messages_.clear();
+  }
+}
+
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,91 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_ORDERED_DIAGNOSTICS_H_
+#define SOURCE_UTIL_ORDERED_DIAGNOSTICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace utils {
+
+// Collects diagnostics from several worker threads and replays them to a
+// single downstream MessageConsumer in the order they were produced.
+//
+// Each worker records into its own buffer, so no lock is taken on the
+// message path; the only shared state is an atomic counter that stamps every
+// message with a module-wide sequence tag.  Replay merges the buffers by
+// tag, which recovers the global production order.
+//
+// Intended use mirrors ThreadPool: the coordinating thread creates one
+// buffer per worker before scheduling, each task records through its
+// buffer's consumer, and after ThreadPool::Wait() the coordinator calls
+// Replay().  Creating buffers and replaying are not thread-safe; recording
+// is, as long as each buffer is used by one thread at a time.
+class OrderedDiagnostics {
+ public:
+  // One worker's private diagnostic store.
+  class Buffer {
+   public:
+    // Returns a consumer recording into this buffer.  The returned consumer
+    // may outlive copies of itself but not the buffer.
+    MessageConsumer GetConsumer();
+
+   private:
+    friend class OrderedDiagnostics;
+
+    explicit Buffer(OrderedDiagnostics* owner) : owner_(owner) {}
+
+    struct Message {
+      uint64_t sequence;
+      spv_message_level_t level;
+      std::string source;
+      spv_position_t position;
+      std::string text;
+    };
+
+    OrderedDiagnostics* owner_;
+    std::vector<Message> messages_;
+  };
+
+  // Creates a collector replaying into |downstream|.
+  explicit OrderedDiagnostics(MessageConsumer downstream)
+      : downstream_(std::move(downstream)) {}
+
+  OrderedDiagnostics(const OrderedDiagnostics&) = delete;
+  OrderedDiagnostics& operator=(const OrderedDiagnostics&) = delete;
+
+  // Creates a new worker buffer.  The buffer lives as long as this object.
+  Buffer* CreateBuffer();
+
+  // Forwards every recorded message to the downstream consumer, ordered by
+  // sequence tag, then forgets them.  Must not race with recording.
+  void Replay();
+
+ private:
+  MessageConsumer downstream_;
+  std::atomic<uint64_t> next_sequence_{0};
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_ORDERED_DIAGNOSTICS_H_
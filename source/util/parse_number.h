@@ -15,9 +15,12 @@
 #ifndef SOURCE_UTIL_PARSE_NUMBER_H_
 #define SOURCE_UTIL_PARSE_NUMBER_H_
 
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 #include "source/util/hex_float.h"
 #include "spirv-tools/libspirv.h"
@@ -160,6 +163,86 @@ bool CheckRangeAndIfHexThenSignExtend(T value, const NumberType& type,
   return true;
 }
 
+// Fast path for the common plain decimal and hexadecimal integer literals,
+// selected for integral |T|.  Returns true if it claims |text|, i.e. the
+// text is an optionally negated run of decimal digits or a 0x/0X-prefixed
+// run of hex digits with nothing trailing; |*parse_ok| then holds the final
+// verdict (false for out-of-range values) and, when successful,
+// |*value_pointer| holds the value.  Returns false for any other form, in
+// which case the caller falls back to the stream-based parse below.
+template <typename T>
+bool TryFastParseNumber(const char* text, T* value_pointer, bool* parse_ok,
+                        std::true_type /* is_integral */) {
+  const char* cursor = text;
+  const bool is_negative = *cursor == '-';
+  if (is_negative) ++cursor;
+
+  uint64_t magnitude = 0;
+  if (cursor[0] == '0' && (cursor[1] == 'x' || cursor[1] == 'X')) {
+    cursor += 2;
+    const char* digits = cursor;
+    for (;; ++cursor) {
+      uint32_t digit;
+      if (*cursor >= '0' && *cursor <= '9') {
+        digit = *cursor - '0';
+      } else if (*cursor >= 'a' && *cursor <= 'f') {
+        digit = *cursor - 'a' + 10;
+      } else if (*cursor >= 'A' && *cursor <= 'F') {
+        digit = *cursor - 'A' + 10;
+      } else {
+        break;
+      }
+      if (magnitude > (std::numeric_limits<uint64_t>::max() >> 4)) {
+        // More than 64 bits of magnitude cannot fit any supported type.
+        *parse_ok = false;
+        return true;
+      }
+      magnitude = (magnitude << 4) | digit;
+    }
+    if (cursor == digits || *cursor != '\0') return false;
+  } else {
+    const char* digits = cursor;
+    for (; *cursor >= '0' && *cursor <= '9'; ++cursor) {
+      const uint32_t digit = *cursor - '0';
+      if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+        *parse_ok = false;
+        return true;
+      }
+      magnitude = magnitude * 10 + digit;
+    }
+    if (cursor == digits || *cursor != '\0') return false;
+    // A leading zero makes the literal octal in the stream path; leave such
+    // text to the fallback.
+    if (digits[0] == '0' && cursor - digits > 1) return false;
+  }
+
+  if (is_negative) {
+    if (std::is_unsigned<T>::value) {
+      // Match the stream path combined with ClampToZeroIfUnsignedType:
+      // "-0" parses as zero, any other negative value is rejected.
+      *parse_ok = magnitude == 0;
+      if (*parse_ok) *value_pointer = 0;
+      return true;
+    }
+    const uint64_t limit =
+        static_cast<uint64_t>(std::numeric_limits<T>::max()) + 1;
+    *parse_ok = magnitude <= limit;
+    if (*parse_ok) *value_pointer = static_cast<T>(-magnitude);
+    return true;
+  }
+
+  *parse_ok = magnitude <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+  if (*parse_ok) *value_pointer = static_cast<T>(magnitude);
+  return true;
+}
+
+// Non-integral overload; such types never take the fast path.
+template <typename T>
+bool TryFastParseNumber(const char*, T*, bool*,
+                        std::false_type /* is_integral */) {
+  return false;
+}
+
 // Parses a numeric value of a given type from the given text.  The number
 // should take up the entire string, and should be within bounds for the target
 // type. On success, returns true and populates the object referenced by
@@ -173,6 +256,15 @@ bool ParseNumber(const char* text, T* value_pointer) {
                 "Single-byte types are not supported in this parse method");
 
   if (!text) return false;
+
+  // Common decimal and hex literals avoid the istringstream round trip,
+  // whose construction alone dominates literal parsing on large modules.
+  bool parse_ok = false;
+  if (TryFastParseNumber(text, value_pointer, &parse_ok,
+                         std::is_integral<T>())) {
+    return parse_ok;
+  }
+
   std::istringstream text_stream(text);
   // Allow both decimal and hex input for integers.
   // It also allows octal input, but we don't care about that case.
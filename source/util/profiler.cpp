@@ -0,0 +1,146 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/profiler.h"
+
+#if defined(SPIRV_TIMER_ENABLED)
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "source/util/make_unique.h"
+
+namespace spvtools {
+namespace utils {
+
+// The events recorded by one thread, in opening order.  Owned by the
+// Profiler registry so the data survives thread exit; the recording thread
+// holds only a raw pointer.
+class ThreadEventBuffer {
+ public:
+  // Opens an event named |name| nested in the innermost open event, and
+  // returns its index.
+  uint32_t OpenEvent(const char* name) {
+    const uint32_t index = static_cast<uint32_t>(events_.size());
+    const uint32_t parent = open_.empty() ? kNoParentEvent : open_.back();
+    events_.push_back({name, ProfileTicksNow(), 0, parent});
+    open_.push_back(index);
+    return index;
+  }
+
+  // Closes the event at |index| and any events still open inside it.
+  void CloseEvent(uint32_t index) {
+    events_[index].end_ticks = ProfileTicksNow();
+    while (!open_.empty() && open_.back() >= index) {
+      open_.pop_back();
+    }
+  }
+
+  const std::vector<ProfileEvent>& events() const { return events_; }
+
+  void Clear() {
+    events_.clear();
+    open_.clear();
+  }
+
+ private:
+  std::vector<ProfileEvent> events_;
+  // The indices of the currently open events, outermost first.
+  std::vector<uint32_t> open_;
+};
+
+Profiler& Profiler::Get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::~Profiler() = default;
+
+ThreadEventBuffer* Profiler::GetThreadBuffer() {
+  thread_local ThreadEventBuffer* buffer = nullptr;
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(MakeUnique<ThreadEventBuffer>());
+    buffer = buffers_.back().get();
+  }
+  return buffer;
+}
+
+void Profiler::Write(std::ostream* out) {
+  if (out == nullptr) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Ticks attributed to each distinct stack itself, excluding child scopes.
+  // An ordered map keeps the output deterministic.
+  std::map<std::string, uint64_t> self_ticks;
+  for (const std::unique_ptr<ThreadEventBuffer>& buffer : buffers_) {
+    const std::vector<ProfileEvent>& events = buffer->events();
+    std::vector<uint64_t> child_ticks(events.size(), 0);
+    std::vector<std::string> stacks(events.size());
+    // Children open after their parent, so a single forward walk sees every
+    // parent's stack before its children and accumulates each child's
+    // duration into its parent before the second walk reads it.
+    for (size_t i = 0; i < events.size(); ++i) {
+      const ProfileEvent& event = events[i];
+      stacks[i] = (event.parent == kNoParentEvent)
+                      ? event.name
+                      : stacks[event.parent] + ";" + event.name;
+      if (event.end_ticks != 0 && event.parent != kNoParentEvent) {
+        child_ticks[event.parent] += event.end_ticks - event.begin_ticks;
+      }
+    }
+    for (size_t i = 0; i < events.size(); ++i) {
+      const ProfileEvent& event = events[i];
+      if (event.end_ticks == 0) continue;
+      const uint64_t duration = event.end_ticks - event.begin_ticks;
+      self_ticks[stacks[i]] +=
+          duration - std::min(child_ticks[i], duration);
+    }
+  }
+
+  for (const auto& entry : self_ticks) {
+    *out << entry.first << " " << entry.second << "\n";
+  }
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const std::unique_ptr<ThreadEventBuffer>& buffer : buffers_) {
+    buffer->Clear();
+  }
+}
+
+ProfileScope::ProfileScope(const char* name) {
+  Profiler& profiler = Profiler::Get();
+  if (!profiler.enabled()) {
+    buffer_ = nullptr;
+    index_ = 0;
+    return;
+  }
+  buffer_ = profiler.GetThreadBuffer();
+  index_ = buffer_->OpenEvent(name);
+}
+
+ProfileScope::~ProfileScope() {
+  if (buffer_ != nullptr) {
+    buffer_->CloseEvent(index_);
+  }
+}
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // defined(SPIRV_TIMER_ENABLED)
@@ -0,0 +1,165 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Hierarchical scoped profiler.  Unlike utils::Timer, which issues system
+// calls and prints a report per scope, this facility records begin/end
+// timestamps from the processor cycle counter into a thread-local buffer and
+// aggregates them after the run, so scopes are cheap enough to nest inside
+// hot loops.
+
+#ifndef SOURCE_UTIL_PROFILER_H_
+#define SOURCE_UTIL_PROFILER_H_
+
+#if defined(SPIRV_TIMER_ENABLED)
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Opens a profiling scope named |name| that lasts until the end of the
+// surrounding block.  |name| must be a string that outlives the profiler,
+// such as a string literal or a pass name.  Does nothing unless
+// spvtools::utils::Profiler has been enabled.
+#define SPIRV_PROFILE_SCOPED(name) \
+  spvtools::utils::ProfileScope spirv_profile_scope##__LINE__(name)
+
+// Starts recording profiling scopes on all threads.
+#define SPIRV_PROFILE_ENABLE() spvtools::utils::Profiler::Get().Enable()
+
+// Stops recording profiling scopes.
+#define SPIRV_PROFILE_DISABLE() spvtools::utils::Profiler::Get().Disable()
+
+// Writes the aggregated profile to the given std::ostream*.
+#define SPIRV_PROFILE_WRITE(out) spvtools::utils::Profiler::Get().Write(out)
+
+// Discards all recorded profiling events.
+#define SPIRV_PROFILE_RESET() spvtools::utils::Profiler::Get().Reset()
+
+namespace spvtools {
+namespace utils {
+
+// The parent index of an event that has no enclosing scope.
+constexpr uint32_t kNoParentEvent = 0xffffffffu;
+
+// Returns the current timestamp in ticks.  On x86 hosts this reads the
+// processor cycle counter, which costs a handful of cycles; elsewhere it
+// falls back to the steady clock in nanoseconds.
+inline uint64_t ProfileTicksNow() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// One scope recorded in a thread's event buffer.
+struct ProfileEvent {
+  // The scope name.  Must point at storage that outlives the profiler.
+  const char* name;
+  uint64_t begin_ticks;
+  // Zero while the scope is still open.
+  uint64_t end_ticks;
+  // The index of the enclosing event in the same buffer, or kNoParentEvent.
+  uint32_t parent;
+};
+
+class ThreadEventBuffer;
+
+// The process-wide registry of recorded events.  Scopes record into
+// thread-local buffers without synchronization; the registry owns the buffers
+// so their contents survive thread exit.  Write() and Reset() must not run
+// concurrently with open scopes.
+class Profiler {
+ public:
+  // Returns the singleton profiler.
+  static Profiler& Get();
+
+  void Enable() { enabled_.store(true, std::memory_order_relaxed); }
+  void Disable() { enabled_.store(false, std::memory_order_relaxed); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Writes one line per distinct scope stack seen on any thread: the scope
+  // names from the outermost scope joined with ';', a space, and the ticks
+  // spent in that stack itself, excluding child scopes.  This is the
+  // collapsed-stack format consumed by flame graph tools.  Scopes that are
+  // still open are skipped.  Does nothing if |out| is null.
+  void Write(std::ostream* out);
+
+  // Discards all recorded events.
+  void Reset();
+
+ private:
+  friend class ProfileScope;
+
+  Profiler() = default;
+  ~Profiler();
+
+  // Returns the calling thread's event buffer, registering one on first use.
+  ThreadEventBuffer* GetThreadBuffer();
+
+  std::atomic<bool> enabled_{false};
+
+  // Guards |buffers_|.  Recording threads take it only when registering
+  // their buffer; every event afterwards is recorded without locking.
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadEventBuffer>> buffers_;
+};
+
+// Opens an event in the calling thread's buffer on construction and closes
+// it on destruction.  Does nothing when the profiler is disabled.  Use the
+// SPIRV_PROFILE_SCOPED macro so the scope compiles away entirely in builds
+// without SPIRV_TIMER_ENABLED.
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char* name);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  // The calling thread's buffer, or null when the profiler is disabled.
+  ThreadEventBuffer* buffer_;
+  // The index of the event opened by this scope.
+  uint32_t index_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#else  // defined(SPIRV_TIMER_ENABLED)
+
+#define SPIRV_PROFILE_SCOPED(name)
+#define SPIRV_PROFILE_ENABLE()
+#define SPIRV_PROFILE_DISABLE()
+#define SPIRV_PROFILE_WRITE(out)
+#define SPIRV_PROFILE_RESET()
+
+#endif  // defined(SPIRV_TIMER_ENABLED)
+
+#endif  // SOURCE_UTIL_PROFILER_H_
@@ -0,0 +1,68 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/scratch_arena.h"
+
+#if defined(SPIRV_LINUX)
+#include <sys/mman.h>
+#endif
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+// Threshold at and above which blocks are mapped for huge-page backing.
+// This matches the x86-64 and AArch64 2MB huge page size; on kernels with a
+// different size MADV_HUGEPAGE is simply advisory and still correct.
+constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+}  // anonymous namespace
+
+char* ScratchArena::AllocateBlock(size_t* size, bool* huge_page) {
+  *huge_page = false;
+#if defined(SPIRV_LINUX)
+  if (*size >= kHugePageBytes) {
+    // Round to whole huge pages so the advice can cover the entire block,
+    // and let the kernel pick a suitably aligned region.
+    const size_t rounded =
+        (*size + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+    void* mapping = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping != MAP_FAILED) {
+      // Best effort: without the advice (or with THP disabled) the mapping
+      // is still a valid block on normal pages.
+      madvise(mapping, rounded, MADV_HUGEPAGE);
+      *size = rounded;
+      *huge_page = true;
+      return static_cast<char*>(mapping);
+    }
+  }
+#endif
+  return new char[*size];
+}
+
+void ScratchArena::FreeBlock(char* data, size_t size, bool huge_page) {
+#if defined(SPIRV_LINUX)
+  if (huge_page) {
+    munmap(data, size);
+    return;
+  }
+#endif
+  (void)size;
+  (void)huge_page;
+  delete[] data;
+}
+
+}  // namespace utils
+}  // namespace spvtools
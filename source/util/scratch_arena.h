@@ -0,0 +1,194 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_SCRATCH_ARENA_H_
+#define SOURCE_UTIL_SCRATCH_ARENA_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A monotonic bump allocator for transient, same-lifetime allocations.
+// Allocate() carves memory out of geometrically growing blocks and individual
+// deallocation is a no-op; Reset() rewinds to the first block so the blocks
+// are reused by the next round of allocations.  This makes repeated
+// build-then-discard workloads (per-pass worklists, visited sets, ...) cost a
+// pointer bump instead of a heap round trip per node.
+//
+// Blocks of 2MB and larger are backed by transparent huge pages where the
+// platform supports it (see AllocateBlock), cutting TLB pressure for the
+// largest modules; smaller blocks and platforms without support fall back
+// to the plain heap.
+//
+// Not thread-safe: an arena must only be used from one thread at a time.
+class ScratchArena {
+ public:
+  ScratchArena() = default;
+
+  ~ScratchArena() {
+    for (const Block& block : blocks_) {
+      FreeBlock(block.data, block.size, block.huge_page);
+    }
+  }
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  // Returns |bytes| bytes of storage aligned to |alignment|, which must be a
+  // power of two.  The storage is valid until the next Reset().
+  void* Allocate(size_t bytes, size_t alignment) {
+    uintptr_t aligned = Align(reinterpret_cast<uintptr_t>(cursor_), alignment);
+    if (cursor_ == nullptr ||
+        aligned + bytes > reinterpret_cast<uintptr_t>(block_end_)) {
+      NextBlock(bytes + alignment);
+      aligned = Align(reinterpret_cast<uintptr_t>(cursor_), alignment);
+    }
+    cursor_ = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  // Invalidates all storage handed out so far and makes it available for
+  // reuse.  The blocks themselves are kept.
+  void Reset() {
+    current_block_ = 0;
+    if (blocks_.empty()) {
+      cursor_ = nullptr;
+      block_end_ = nullptr;
+    } else {
+      cursor_ = blocks_[0].data;
+      block_end_ = cursor_ + blocks_[0].size;
+    }
+  }
+
+ private:
+  // Size of the first block; each additional block doubles the previous one.
+  static constexpr size_t kFirstBlockBytes = size_t(64) << 10;
+
+  struct Block {
+    char* data;
+    size_t size;
+    // True when the block was mapped for huge-page backing and must be
+    // released with the matching primitive.
+    bool huge_page;
+  };
+
+  // Allocates a block of at least |*size| bytes.  When the block is large
+  // enough and the platform supports it, the block is mapped on a 2MB
+  // boundary, advised for transparent huge pages, and |*size| is rounded up
+  // to a whole number of huge pages; |*huge_page| records which release
+  // path FreeBlock must take.  Falls back to the plain heap.
+  static char* AllocateBlock(size_t* size, bool* huge_page);
+
+  // Releases a block obtained from AllocateBlock.
+  static void FreeBlock(char* data, size_t size, bool huge_page);
+
+  static uintptr_t Align(uintptr_t value, size_t alignment) {
+    assert((alignment & (alignment - 1)) == 0 &&
+           "Alignment must be a power of two.");
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+
+  // Moves the cursor to the next block holding at least |min_bytes|,
+  // appending a new block if no remaining block is large enough.
+  void NextBlock(size_t min_bytes) {
+    // Reuse a block kept from before the last Reset() if one is big enough.
+    for (size_t next = blocks_.empty() ? 0 : current_block_ + 1;
+         next < blocks_.size(); ++next) {
+      if (blocks_[next].size >= min_bytes) {
+        current_block_ = next;
+        cursor_ = blocks_[next].data;
+        block_end_ = cursor_ + blocks_[next].size;
+        return;
+      }
+    }
+    size_t size = blocks_.empty() ? kFirstBlockBytes : blocks_.back().size * 2;
+    while (size < min_bytes) {
+      size *= 2;
+    }
+    bool huge_page = false;
+    char* data = AllocateBlock(&size, &huge_page);
+    blocks_.push_back({data, size, huge_page});
+    current_block_ = blocks_.size() - 1;
+    cursor_ = data;
+    block_end_ = cursor_ + size;
+  }
+
+  std::vector<Block> blocks_;
+  size_t current_block_ = 0;
+  char* cursor_ = nullptr;
+  char* block_end_ = nullptr;
+};
+
+// An STL-compatible allocator drawing from a ScratchArena.  deallocate() is a
+// no-op; memory comes back when the arena is Reset().  The arena pointer
+// converts implicitly so containers can be constructed directly from one,
+// e.g. |std::vector<uint32_t, ScratchAllocator<uint32_t>> v(arena);|.
+template <typename T>
+class ScratchAllocator {
+ public:
+  using value_type = T;
+
+  ScratchAllocator(ScratchArena* arena) : arena_(arena) {}
+
+  template <typename U>
+  ScratchAllocator(const ScratchAllocator<U>& that) : arena_(that.arena()) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) {}
+
+  ScratchArena* arena() const { return arena_; }
+
+ private:
+  ScratchArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ScratchAllocator<T>& lhs,
+                const ScratchAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ScratchAllocator<T>& lhs,
+                const ScratchAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+// Shorthands for the common scratch-backed containers.
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+template <typename T>
+using ScratchSet = std::unordered_set<T, std::hash<T>, std::equal_to<T>,
+                                      ScratchAllocator<T>>;
+
+template <typename K, typename V>
+using ScratchMap =
+    std::unordered_map<K, V, std::hash<K>, std::equal_to<K>,
+                       ScratchAllocator<std::pair<const K, V>>>;
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_SCRATCH_ARENA_H_
@@ -0,0 +1,126 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_SLOT_POOL_H_
+#define SOURCE_UTIL_SLOT_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+
+namespace spvtools {
+namespace utils {
+
+// A chunked free-list pool of fixed-size memory slots, intended to back a
+// class-level operator new/delete for a small object type that is allocated
+// and freed in large numbers.  Allocation and deallocation go through a
+// thread-local free list and are lock-free; slots are carved out of chunks
+// of kChunkSize slots, threaded onto the list in address order so that
+// consecutive allocations are adjacent in memory.
+//
+// Chunk memory is retained for the lifetime of the process: an object may
+// be created on one thread and destroyed on another (e.g. modules built on
+// worker threads and consumed by the caller), so slot memory must not
+// vanish when the allocating thread exits.  Exiting threads instead donate
+// their unused slots to shared state, guarded by a mutex that is only
+// touched when a pool runs dry or a thread exits, so other threads can
+// reuse them.
+//
+// Each distinct instantiation of the template has its own thread-local
+// pools and its own shared state.
+template <size_t kSlotBytes, size_t kSlotAlign>
+class SlotPool {
+ public:
+  // Number of slots carved out of each chunk.
+  static constexpr size_t kChunkSize = 256;
+
+  // Returns the pool of the calling thread.
+  static SlotPool& ThreadLocal() {
+    thread_local SlotPool pool;
+    return pool;
+  }
+
+  void* Allocate() {
+    if (!free_list_ && !AdoptOrphanedSlots()) {
+      AllocateChunk();
+    }
+    FreeNode* node = free_list_;
+    free_list_ = node->next;
+    return node;
+  }
+
+  void Deallocate(void* ptr) {
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = free_list_;
+    free_list_ = node;
+  }
+
+  ~SlotPool() {
+    // Donate the remaining free slots so other threads can reuse them.  The
+    // chunks themselves are never freed; see the class comment.
+    if (!free_list_) return;
+    FreeNode* tail = free_list_;
+    while (tail->next) tail = tail->next;
+    SharedState& shared = GetSharedState();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    tail->next = shared.orphaned_slots;
+    shared.orphaned_slots = free_list_;
+  }
+
+ private:
+  // A free-list node overlaying a slot.
+  union FreeNode {
+    FreeNode* next;
+    alignas(kSlotAlign) char storage[kSlotBytes];
+  };
+
+  // Slots donated by exited threads, shared between all pools of this
+  // instantiation.
+  struct SharedState {
+    std::mutex mutex;
+    FreeNode* orphaned_slots = nullptr;
+  };
+
+  static SharedState& GetSharedState() {
+    // Deliberately leaked: slots may still be freed during static
+    // destruction, after a function-local static would have been destroyed.
+    static SharedState* state = new SharedState;
+    return *state;
+  }
+
+  // Takes over all slots donated by exited threads.  Returns true if any
+  // were available.
+  bool AdoptOrphanedSlots() {
+    SharedState& shared = GetSharedState();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (!shared.orphaned_slots) return false;
+    free_list_ = shared.orphaned_slots;
+    shared.orphaned_slots = nullptr;
+    return true;
+  }
+
+  void AllocateChunk() {
+    char* chunk =
+        static_cast<char*>(::operator new(kChunkSize * sizeof(FreeNode)));
+    for (size_t i = kChunkSize; i > 0; --i) {
+      Deallocate(chunk + (i - 1) * sizeof(FreeNode));
+    }
+  }
+
+  FreeNode* free_list_ = nullptr;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_SLOT_POOL_H_
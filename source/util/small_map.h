@@ -0,0 +1,126 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_SMALL_MAP_H_
+#define SOURCE_UTIL_SMALL_MAP_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "source/util/small_vector.h"
+
+namespace spvtools {
+namespace utils {
+
+// The |SmallMap| class is a map optimized for a small number of entries,
+// the common shape of the transient per-block and per-instruction maps
+// passes allocate.  Entries live in insertion order in an inline
+// |SmallVector|; lookups scan it linearly while the map holds at most
+// |small_size| entries, so small maps never touch the heap.  Once the map
+// outgrows |small_size|, a hash index over the keys is built and kept up to
+// date, so lookups stay O(1).
+//
+// Only the operations the transient-map pattern needs are implemented:
+// entries can be inserted, found and updated but not individually erased,
+// and iteration is in insertion order.
+template <class Key, class Value, size_t small_size,
+          class Hash = std::hash<Key>, class EqualTo = std::equal_to<Key>>
+class SmallMap {
+ public:
+  using value_type = std::pair<Key, Value>;
+  using iterator = typename SmallVector<value_type, small_size>::iterator;
+  using const_iterator =
+      typename SmallVector<value_type, small_size>::const_iterator;
+
+  SmallMap() = default;
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  void clear() {
+    entries_.clear();
+    index_.clear();
+  }
+
+  // Returns 1 if |key| is in the map, and 0 otherwise.
+  size_t count(const Key& key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  // Returns an iterator to the entry for |key|, or |end()| if there is
+  // none.
+  iterator find(const Key& key) {
+    if (!index_.empty()) {
+      auto where = index_.find(key);
+      return where == index_.end() ? entries_.end()
+                                   : entries_.begin() + where->second;
+    }
+    EqualTo equal;
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (equal(it->first, key)) return it;
+    }
+    return entries_.end();
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_cast<SmallMap*>(this)->find(key);
+  }
+
+  // Inserts |entry| if its key is not already in the map.  Returns an
+  // iterator to the entry for the key and whether an insertion took place.
+  std::pair<iterator, bool> insert(const value_type& entry) {
+    iterator it = find(entry.first);
+    if (it != entries_.end()) return {it, false};
+    if (!index_.empty()) {
+      index_.emplace(entry.first, static_cast<uint32_t>(entries_.size()));
+    }
+    entries_.push_back(entry);
+    if (index_.empty() && entries_.size() > small_size) BuildIndex();
+    return {entries_.end() - 1, true};
+  }
+
+  // Returns the value for |key|, default-constructing it first if |key| is
+  // not already in the map.
+  Value& operator[](const Key& key) {
+    return insert({key, Value()}).first->second;
+  }
+
+ private:
+  // Indexes every current entry.  Called once, when the map outgrows its
+  // inline storage; from then on |index_| mirrors |entries_|.
+  void BuildIndex() {
+    index_.reserve(entries_.size());
+    uint32_t position = 0;
+    for (const value_type& entry : entries_) {
+      index_.emplace(entry.first, position++);
+    }
+  }
+
+  // The entries, in insertion order.
+  SmallVector<value_type, small_size> entries_;
+  // Maps a key to its position in |entries_|.  Empty until the map outgrows
+  // |small_size|.
+  std::unordered_map<Key, uint32_t, Hash, EqualTo> index_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_SMALL_MAP_H_
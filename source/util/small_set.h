@@ -0,0 +1,107 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_SMALL_SET_H_
+#define SOURCE_UTIL_SMALL_SET_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "source/util/small_vector.h"
+
+namespace spvtools {
+namespace utils {
+
+// The |SmallSet| class is a set optimized for a small number of elements,
+// the common shape of the transient visited-sets and seen-sets passes
+// allocate per block or per instruction.  Elements live in insertion order
+// in an inline |SmallVector|; membership queries scan it linearly while the
+// set holds at most |small_size| elements, so small sets never touch the
+// heap.  Once the set outgrows |small_size|, a hash index over the elements
+// is built and kept up to date, so lookups stay O(1).
+//
+// Only the operations the transient-set pattern needs are implemented:
+// elements can be inserted and counted but not individually erased, and
+// iteration is const and in insertion order.
+template <class T, size_t small_size, class Hash = std::hash<T>,
+          class EqualTo = std::equal_to<T>>
+class SmallSet {
+ public:
+  using const_iterator = typename SmallVector<T, small_size>::const_iterator;
+
+  SmallSet() = default;
+
+  const_iterator begin() const { return elements_.begin(); }
+  const_iterator end() const { return elements_.end(); }
+  size_t size() const { return elements_.size(); }
+  bool empty() const { return elements_.empty(); }
+
+  void clear() {
+    elements_.clear();
+    index_.clear();
+  }
+
+  // Returns 1 if |value| is in the set, and 0 otherwise.
+  size_t count(const T& value) const {
+    if (!index_.empty()) return index_.count(value);
+    EqualTo equal;
+    for (const T& element : elements_) {
+      if (equal(element, value)) return 1;
+    }
+    return 0;
+  }
+
+  // Inserts |value| if it is not already in the set.  Returns an iterator to
+  // the element and whether an insertion took place.
+  std::pair<const_iterator, bool> insert(const T& value) {
+    if (index_.empty()) {
+      EqualTo equal;
+      for (auto it = elements_.begin(); it != elements_.end(); ++it) {
+        if (equal(*it, value)) return {it, false};
+      }
+      elements_.push_back(value);
+      if (elements_.size() > small_size) BuildIndex();
+    } else {
+      auto where =
+          index_.emplace(value, static_cast<uint32_t>(elements_.size()));
+      if (!where.second) {
+        return {elements_.begin() + where.first->second, false};
+      }
+      elements_.push_back(value);
+    }
+    return {elements_.end() - 1, true};
+  }
+
+ private:
+  // Indexes every current element.  Called once, when the set outgrows its
+  // inline storage; from then on |index_| mirrors |elements_|.
+  void BuildIndex() {
+    index_.reserve(elements_.size());
+    uint32_t position = 0;
+    for (const T& element : elements_) index_.emplace(element, position++);
+  }
+
+  // The elements, in insertion order.
+  SmallVector<T, small_size> elements_;
+  // Maps an element to its position in |elements_|.  Empty until the set
+  // outgrows |small_size|.
+  std::unordered_map<T, uint32_t, Hash, EqualTo> index_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_SMALL_SET_H_
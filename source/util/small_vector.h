@@ -15,10 +15,12 @@
 #ifndef SOURCE_UTIL_SMALL_VECTOR_H_
 #define SOURCE_UTIL_SMALL_VECTOR_H_
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -46,10 +48,7 @@ class SmallVector {
   using iterator = T*;
   using const_iterator = const T*;
 
-  SmallVector()
-      : size_(0),
-        small_data_(reinterpret_cast<T*>(buffer)),
-        large_data_(nullptr) {}
+  SmallVector() : size_(0), large_data_(nullptr) {}
 
   SmallVector(const SmallVector& that) : SmallVector() { *this = that; }
 
@@ -59,9 +58,9 @@ class SmallVector {
     if (vec.size() > small_size) {
       large_data_ = MakeUnique<std::vector<T>>(vec);
     } else {
-      size_ = vec.size();
+      size_ = static_cast<uint32_t>(vec.size());
       for (uint32_t i = 0; i < size_; i++) {
-        new (small_data_ + i) T(vec[i]);
+        new (small_data() + i) T(vec[i]);
       }
     }
   }
@@ -75,18 +74,18 @@ class SmallVector {
     if (vec.size() > small_size) {
       large_data_ = MakeUnique<std::vector<T>>(std::move(vec));
     } else {
-      size_ = vec.size();
+      size_ = static_cast<uint32_t>(vec.size());
       for (uint32_t i = 0; i < size_; i++) {
-        new (small_data_ + i) T(std::move(vec[i]));
+        new (small_data() + i) T(std::move(vec[i]));
       }
     }
     vec.clear();
   }
 
   SmallVector(std::initializer_list<T> init_list) : SmallVector() {
-    if (init_list.size() < small_size) {
+    if (init_list.size() <= small_size) {
       for (auto it = init_list.begin(); it != init_list.end(); ++it) {
-        new (small_data_ + (size_++)) T(std::move(*it));
+        new (small_data() + (size_++)) T(std::move(*it));
       }
     } else {
       large_data_ = MakeUnique<std::vector<T>>(std::move(init_list));
@@ -95,14 +94,13 @@ class SmallVector {
 
   SmallVector(size_t s, const T& v) : SmallVector() { resize(s, v); }
 
-  virtual ~SmallVector() {
-    for (T* p = small_data_; p < small_data_ + size_; ++p) {
+  ~SmallVector() {
+    for (T* p = small_data(); p < small_data() + size_; ++p) {
       p->~T();
     }
   }
 
   SmallVector& operator=(const SmallVector& that) {
-    assert(small_data_);
     if (that.large_data_) {
       if (large_data_) {
         *large_data_ = *that.large_data_;
@@ -114,20 +112,20 @@ class SmallVector {
       size_t i = 0;
       // Do a copy for any element in |this| that is already constructed.
       for (; i < size_ && i < that.size_; ++i) {
-        small_data_[i] = that.small_data_[i];
+        small_data()[i] = that.small_data()[i];
       }
 
       if (i >= that.size_) {
         // If the size of |this| becomes smaller after the assignment, then
         // destroy any extra elements.
         for (; i < size_; ++i) {
-          small_data_[i].~T();
+          small_data()[i].~T();
         }
       } else {
         // If the size of |this| becomes larger after the assignement, copy
         // construct the new elements that are needed.
         for (; i < that.size_; ++i) {
-          new (small_data_ + i) T(that.small_data_[i]);
+          new (small_data() + i) T(that.small_data()[i]);
         }
       }
       size_ = that.size_;
@@ -143,20 +141,20 @@ class SmallVector {
       size_t i = 0;
       // Do a move for any element in |this| that is already constructed.
       for (; i < size_ && i < that.size_; ++i) {
-        small_data_[i] = std::move(that.small_data_[i]);
+        small_data()[i] = std::move(that.small_data()[i]);
       }
 
       if (i >= that.size_) {
         // If the size of |this| becomes smaller after the assignment, then
         // destroy any extra elements.
         for (; i < size_; ++i) {
-          small_data_[i].~T();
+          small_data()[i].~T();
         }
       } else {
         // If the size of |this| becomes larger after the assignement, move
         // construct the new elements that are needed.
         for (; i < that.size_; ++i) {
-          new (small_data_ + i) T(std::move(that.small_data_[i]));
+          new (small_data() + i) T(std::move(that.small_data()[i]));
         }
       }
       size_ = that.size_;
@@ -199,7 +197,7 @@ class SmallVector {
 
   T& operator[](size_t i) {
     if (!large_data_) {
-      return small_data_[i];
+      return small_data()[i];
     } else {
       return (*large_data_)[i];
     }
@@ -207,7 +205,7 @@ class SmallVector {
 
   const T& operator[](size_t i) const {
     if (!large_data_) {
-      return small_data_[i];
+      return small_data()[i];
     } else {
       return (*large_data_)[i];
     }
@@ -225,7 +223,7 @@ class SmallVector {
     if (large_data_) {
       return large_data_->data();
     } else {
-      return small_data_;
+      return small_data();
     }
   }
 
@@ -233,7 +231,7 @@ class SmallVector {
     if (large_data_) {
       return large_data_->data();
     } else {
-      return small_data_;
+      return small_data();
     }
   }
 
@@ -243,7 +241,7 @@ class SmallVector {
     if (large_data_) {
       return large_data_->data() + large_data_->size();
     } else {
-      return small_data_ + size_;
+      return small_data() + size_;
     }
   }
 
@@ -251,7 +249,7 @@ class SmallVector {
     if (large_data_) {
       return large_data_->data() + large_data_->size();
     } else {
-      return small_data_ + size_;
+      return small_data() + size_;
     }
   }
 
@@ -303,13 +301,13 @@ class SmallVector {
     }
 
     // Update the size.
-    size_ -= num_of_del_elements;
+    size_ -= static_cast<uint32_t>(num_of_del_elements);
     return ret;
   }
 
   void push_back(const T& value) {
     if (!large_data_ && size_ == small_size) {
-      MoveToLargeData();
+      MoveToLargeData(size_ + 1);
     }
 
     if (large_data_) {
@@ -317,13 +315,13 @@ class SmallVector {
       return;
     }
 
-    new (small_data_ + size_) T(value);
+    new (small_data() + size_) T(value);
     ++size_;
   }
 
   void push_back(T&& value) {
     if (!large_data_ && size_ == small_size) {
-      MoveToLargeData();
+      MoveToLargeData(size_ + 1);
     }
 
     if (large_data_) {
@@ -331,7 +329,7 @@ class SmallVector {
       return;
     }
 
-    new (small_data_ + size_) T(std::move(value));
+    new (small_data() + size_) T(std::move(value));
     ++size_;
   }
 
@@ -340,7 +338,7 @@ class SmallVector {
       large_data_->pop_back();
     } else {
       --size_;
-      small_data_[size_].~T();
+      small_data()[size_].~T();
     }
   }
 
@@ -350,7 +348,7 @@ class SmallVector {
     size_t num_of_new_elements = std::distance(first, last);
     size_t new_size = size_ + num_of_new_elements;
     if (!large_data_ && new_size > small_size) {
-      MoveToLargeData();
+      MoveToLargeData(new_size);
     }
 
     if (large_data_) {
@@ -375,7 +373,7 @@ class SmallVector {
     // Copy the new elements into position.
     iterator p = pos;
     for (; first != last; ++p, ++first) {
-      if (p >= small_data_ + size_) {
+      if (p >= small_data() + size_) {
         new (p) T(*first);
       } else {
         *p = *first;
@@ -383,7 +381,7 @@ class SmallVector {
     }
 
     // Update the size.
-    size_ += num_of_new_elements;
+    size_ += static_cast<uint32_t>(num_of_new_elements);
     return pos;
   }
 
@@ -405,20 +403,20 @@ class SmallVector {
   template <class... Args>
   void emplace_back(Args&&... args) {
     if (!large_data_ && size_ == small_size) {
-      MoveToLargeData();
+      MoveToLargeData(size_ + 1);
     }
 
     if (large_data_) {
       large_data_->emplace_back(std::forward<Args>(args)...);
     } else {
-      new (small_data_ + size_) T(std::forward<Args>(args)...);
+      new (small_data() + size_) T(std::forward<Args>(args)...);
       ++size_;
     }
   }
 
   void resize(size_t new_size, const T& v) {
     if (!large_data_ && new_size > small_size) {
-      MoveToLargeData();
+      MoveToLargeData(new_size);
     }
 
     if (large_data_) {
@@ -428,40 +426,60 @@ class SmallVector {
 
     // If |new_size| < |size_|, then destroy the extra elements.
     for (size_t i = new_size; i < size_; ++i) {
-      small_data_[i].~T();
+      small_data()[i].~T();
     }
 
     // If |new_size| > |size_|, the copy construct the new elements.
     for (size_t i = size_; i < new_size; ++i) {
-      new (small_data_ + i) T(v);
+      new (small_data() + i) T(v);
     }
 
     // Update the size.
-    size_ = new_size;
+    size_ = static_cast<uint32_t>(new_size);
   }
 
  private:
-  // Moves all of the element from |small_data_| into a new std::vector that can
-  // be access through |large_data|.
-  void MoveToLargeData() {
+  // Returns a pointer to the array of elements stored inline in |buffer|.
+  // The pointer is computed on demand instead of being stored as a member so
+  // that every |SmallVector| (and therefore every |Operand| in a module) is a
+  // pointer smaller.
+  T* small_data() { return reinterpret_cast<T*>(buffer); }
+  const T* small_data() const { return reinterpret_cast<const T*>(buffer); }
+
+  // The heap capacity reserved when the vector first outgrows its small
+  // buffer.  Doubling the small size means the elements that just spilled
+  // fill at most half of the allocation, so the push that caused the spill
+  // and the ones immediately following it do not reallocate again.
+  static constexpr size_t kSpillCapacity = 2 * small_size;
+
+  // Moves all of the elements from |small_data()| into a new std::vector that
+  // can be accessed through |large_data_|.  The vector reserves space for at
+  // least |capacity_hint| elements before the move, so each element is moved
+  // exactly once and the operation that triggered the spill does not cause a
+  // second allocation.
+  void MoveToLargeData(size_t capacity_hint) {
     assert(!large_data_);
     large_data_ = MakeUnique<std::vector<T>>();
-    for (size_t i = 0; i < size_; ++i) {
-      large_data_->emplace_back(std::move(small_data_[i]));
-    }
+    large_data_->reserve(std::max(capacity_hint, kSpillCapacity));
+    large_data_->insert(large_data_->end(),
+                        std::make_move_iterator(small_data()),
+                        std::make_move_iterator(small_data() + size_));
     DestructSmallData();
   }
 
-  // Destroys all of the elements in |small_data_| that have been constructed.
+  // Destroys all of the elements in |small_data()| that have been constructed.
   void DestructSmallData() {
     for (size_t i = 0; i < size_; ++i) {
-      small_data_[i].~T();
+      small_data()[i].~T();
     }
     size_ = 0;
   }
 
-  // The number of elements in |small_data_| that have been constructed.
-  size_t size_;
+  // The number of elements in |small_data()| that have been constructed.
+  // Kept as a 32-bit count so that, together with a small |buffer|, the
+  // whole vector packs into two pointers' worth of space.  Vectors larger
+  // than that live in |large_data_|, which tracks its own size.
+  uint32_t size_;
 
   // A type with the same alignment and size as T, but will is POD.
   struct alignas(T) PodType {
@@ -469,16 +487,12 @@ class SmallVector {
   };
 
   // The actual data used to store the array elements.  It must never be used
-  // directly, but must only be accessed through |small_data_|.
+  // directly, but must only be accessed through |small_data()|.
   PodType buffer[small_size];
 
-  // The pointed used to access the array of elements when the number of
-  // elements is small.
-  T* small_data_;
-
   // A pointer to a vector that is used to store the elements of the vector when
   // this size exceeds |small_size|.  If |large_data_| is nullptr, then the data
-  // is stored in |small_data_|.  Otherwise, the data is stored in
+  // is stored in |small_data()|.  Otherwise, the data is stored in
   // |large_data_|.
   std::unique_ptr<std::vector<T>> large_data_;
 };  // namespace utils
@@ -0,0 +1,109 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/thread_pool.h"
+
+#include <utility>
+
+namespace spvtools {
+namespace utils {
+
+ThreadPool::ThreadPool(size_t num_threads) : ThreadPool(num_threads, {}) {}
+
+ThreadPool::ThreadPool(size_t num_threads,
+                       std::function<void(size_t)> on_worker_start) {
+  if (num_threads <= 1) return;
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i, on_worker_start] {
+      if (on_worker_start) on_worker_start(i);
+      WorkerLoop();
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  Wait();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    shutting_down_ = true;
+  }
+  task_available_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+void ThreadPool::Schedule(std::function<void()> task) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    ++outstanding_tasks_;
+  }
+  task_available_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  if (threads_.empty()) {
+    DrainOnCallingThread();
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  task_done_.wait(lock, [this] { return outstanding_tasks_ == 0; });
+}
+
+size_t ThreadPool::DefaultThreadCount() {
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw == 0 ? 1 : hw;
+}
+
+void ThreadPool::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(
+          lock, [this] { return shutting_down_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;  // Only reached when shutting down.
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (--outstanding_tasks_ == 0) task_done_.notify_all();
+    }
+  }
+}
+
+void ThreadPool::DrainOnCallingThread() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (tasks_.empty()) {
+        outstanding_tasks_ = 0;
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      --outstanding_tasks_;
+    }
+  }
+}
+
+}  // namespace utils
+}  // namespace spvtools
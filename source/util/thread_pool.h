@@ -0,0 +1,88 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_THREAD_POOL_H_
+#define SOURCE_UTIL_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A fixed-size pool of worker threads executing scheduled tasks in FIFO
+// order.  Tasks must not throw.  The pool makes no attempt to propagate
+// results or errors; callers communicate through state captured by the task,
+// and are responsible for making that state safe to share.
+class ThreadPool {
+ public:
+  // Creates a pool with |num_threads| workers.  A |num_threads| of 0 or 1
+  // creates no worker threads: tasks then run on the caller's thread inside
+  // Wait(), which keeps single-threaded behaviour (and stack traces)
+  // identical to not using a pool at all.
+  explicit ThreadPool(size_t num_threads);
+
+  // As above, but each worker thread calls |on_worker_start| with its index
+  // in [0, num_threads) before pulling any task.  Used to set thread
+  // attributes such as CPU affinity.  The hook is not called when the pool
+  // has no workers.
+  ThreadPool(size_t num_threads, std::function<void(size_t)> on_worker_start);
+
+  // Waits for all scheduled tasks to finish, then joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Enqueues |task| for execution.  Safe to call from any thread, including
+  // from inside a running task.
+  void Schedule(std::function<void()> task);
+
+  // Blocks until every task scheduled so far has finished executing.
+  void Wait();
+
+  // Returns the number of worker threads, which may be 0.
+  size_t num_threads() const { return threads_.size(); }
+
+  // Returns a reasonable default worker count for this machine: the hardware
+  // concurrency, or 1 if that cannot be determined.
+  static size_t DefaultThreadCount();
+
+ private:
+  // Body of each worker thread: pulls tasks until shutdown.
+  void WorkerLoop();
+
+  // Runs queued tasks on the calling thread until the queue is empty.  Used
+  // by Wait() when the pool has no workers.
+  void DrainOnCallingThread();
+
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::condition_variable task_done_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  // Number of tasks that are queued or currently executing.
+  size_t outstanding_tasks_ = 0;
+  bool shutting_down_ = false;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_THREAD_POOL_H_
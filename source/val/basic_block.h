@@ -50,6 +50,15 @@ class BasicBlock {
   /// Returns the id of the BasicBlock
   uint32_t id() const { return id_; }
 
+  /// Returns the dense per-function index of the BasicBlock, used to index
+  /// the flattened augmented-CFG adjacency tables (see
+  /// Function::ComputeAugmentedCFG).  Unset until the function end has been
+  /// registered.
+  uint32_t cfg_index() const { return cfg_index_; }
+
+  /// Sets the dense per-function index of the BasicBlock
+  void set_cfg_index(uint32_t index) { cfg_index_ = index; }
+
   /// Returns the predecessors of the BasicBlock
   const std::vector<BasicBlock*>* predecessors() const {
     return &predecessors_;
@@ -270,6 +279,12 @@ class BasicBlock {
   /// Id of the BasicBlock
   const uint32_t id_;
 
+  /// Dense per-function index; see cfg_index().  The out-of-range default
+  /// makes unindexed blocks (never-defined branch targets) fail the bounds
+  /// checks in the flattened-adjacency accessors and fall back to their own
+  /// adjacency lists.
+  uint32_t cfg_index_ = 0xffffffffu;
+
   /// Pointer to the immediate dominator of the BasicBlock
   BasicBlock* immediate_dominator_;
 
@@ -247,37 +247,38 @@ std::pair<BasicBlock*, bool> Function::GetBlock(uint32_t block_id) {
 
 Function::GetBlocksFunction Function::AugmentedCFGSuccessorsFunction() const {
   return [this](const BasicBlock* block) {
-    auto where = augmented_successors_map_.find(block);
-    return where == augmented_successors_map_.end() ? block->successors()
-                                                    : &(*where).second;
+    const uint32_t index = block->cfg_index();
+    return index < augmented_successors_.size() ? augmented_successors_[index]
+                                                : block->successors();
   };
 }
 
 Function::GetBlocksFunction Function::AugmentedCFGPredecessorsFunction() const {
   return [this](const BasicBlock* block) {
-    auto where = augmented_predecessors_map_.find(block);
-    return where == augmented_predecessors_map_.end() ? block->predecessors()
-                                                      : &(*where).second;
+    const uint32_t index = block->cfg_index();
+    return index < augmented_predecessors_.size()
+               ? augmented_predecessors_[index]
+               : block->predecessors();
   };
 }
 
 Function::GetBlocksFunction Function::AugmentedStructuralCFGSuccessorsFunction()
     const {
   return [this](const BasicBlock* block) {
-    auto where = augmented_successors_map_.find(block);
-    return where == augmented_successors_map_.end()
-               ? block->structural_successors()
-               : &(*where).second;
+    const uint32_t index = block->cfg_index();
+    return index < augmented_structural_successors_.size()
+               ? augmented_structural_successors_[index]
+               : block->structural_successors();
   };
 }
 
 Function::GetBlocksFunction
 Function::AugmentedStructuralCFGPredecessorsFunction() const {
   return [this](const BasicBlock* block) {
-    auto where = augmented_predecessors_map_.find(block);
-    return where == augmented_predecessors_map_.end()
-               ? block->structural_predecessors()
-               : &(*where).second;
+    const uint32_t index = block->cfg_index();
+    return index < augmented_structural_predecessors_.size()
+               ? augmented_structural_predecessors_[index]
+               : block->structural_predecessors();
   };
 }
 
@@ -294,6 +295,42 @@ void Function::ComputeAugmentedCFG() {
       ordered_blocks_, &pseudo_entry_block_, &pseudo_exit_block_,
       &augmented_successors_map_, &augmented_predecessors_map_, succ_func,
       pred_func);
+
+  // Flatten the augmented adjacency into arrays indexed by the blocks'
+  // dense per-function indexes.  The CFG checks traverse these lists many
+  // times per block, so the accessors above should be array loads rather
+  // than hash lookups.  Blocks that never received an index (targets of a
+  // branch that were never defined) fall back to their own lists, exactly
+  // as a map miss used to.
+  uint32_t index = 0;
+  for (BasicBlock* block : ordered_blocks_) block->set_cfg_index(index++);
+  pseudo_entry_block_.set_cfg_index(index++);
+  pseudo_exit_block_.set_cfg_index(index++);
+
+  augmented_successors_.resize(index);
+  augmented_predecessors_.resize(index);
+  augmented_structural_successors_.resize(index);
+  augmented_structural_predecessors_.resize(index);
+  auto set_defaults = [this](const BasicBlock& block) {
+    const uint32_t i = block.cfg_index();
+    augmented_successors_[i] = block.successors();
+    augmented_predecessors_[i] = block.predecessors();
+    augmented_structural_successors_[i] = block.structural_successors();
+    augmented_structural_predecessors_[i] = block.structural_predecessors();
+  };
+  for (const BasicBlock* block : ordered_blocks_) set_defaults(*block);
+  set_defaults(pseudo_entry_block_);
+  set_defaults(pseudo_exit_block_);
+  for (const auto& entry : augmented_successors_map_) {
+    const uint32_t i = entry.first->cfg_index();
+    augmented_successors_[i] = &entry.second;
+    augmented_structural_successors_[i] = &entry.second;
+  }
+  for (const auto& entry : augmented_predecessors_map_) {
+    const uint32_t i = entry.first->cfg_index();
+    augmented_predecessors_[i] = &entry.second;
+    augmented_structural_predecessors_[i] = &entry.second;
+  }
 }
 
 Construct& Function::AddConstruct(const Construct& new_construct) {
@@ -226,6 +226,14 @@ class Function {
   bool CheckLimitations(const ValidationState_t& _, const Function* entry_point,
                         std::string* reason) const;
 
+  /// Returns the number of limitation functors registered on this function.
+  /// Skipping the per-instruction checks for a cached function body would
+  /// also skip the registrations they perform, so only bodies that register
+  /// no limitations enter the validation cache.
+  size_t num_limitations() const {
+    return execution_model_limitations_.size() + limitations_.size();
+  }
+
   /// Returns true if the given execution model passes the limitations stored in
   /// execution_model_limitations_. Returns false otherwise and fills optional
   /// |reason| parameter.
@@ -346,6 +354,18 @@ class Function {
   std::unordered_map<const BasicBlock*, std::vector<BasicBlock*>>
       augmented_predecessors_map_;
 
+  // The augmented-CFG adjacency above, flattened into arrays indexed by
+  // BasicBlock::cfg_index() so the hot accessors used by the CFG checks are
+  // array loads instead of hash lookups.  Each slot points either at the
+  // block's own (structural) adjacency list or at its entry in the maps
+  // above.  Built by ComputeAugmentedCFG().
+  std::vector<const std::vector<BasicBlock*>*> augmented_successors_;
+  std::vector<const std::vector<BasicBlock*>*> augmented_predecessors_;
+  std::vector<const std::vector<BasicBlock*>*>
+      augmented_structural_successors_;
+  std::vector<const std::vector<BasicBlock*>*>
+      augmented_structural_predecessors_;
+
   // Maps a structured loop header to its CFG successors and also its
   // continue target if that continue target is not the loop header
   // itself. This might have duplicates.
@@ -0,0 +1,154 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "source/assembly_grammar.h"
+#include "source/opcode.h"
+#include "source/spirv_constant.h"
+#include "source/spirv_endian.h"
+#include "source/table.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+
+struct StreamingValidator::Impl {
+  Impl(spv_target_env env, spv_validator_options options_arg)
+      : context(spvContextCreate(env)), options(options_arg) {}
+  ~Impl() { spvContextDestroy(context); }
+
+  // Reports an early-rejection error at instruction |instruction_number| (or
+  // 0 for header errors) and latches the failed state.
+  void Fail(const std::string& message) {
+    failed = true;
+    if (context->consumer) {
+      spv_position_t position = {0, 0, instruction_count};
+      context->consumer(SPV_MSG_ERROR, "", position, message.c_str());
+    }
+  }
+
+  // Runs the early checks over any instructions that are now complete,
+  // starting at |scanned_words|.  Stops at the first incomplete instruction.
+  void ScanCompletedInstructions();
+
+  spv_context context;             // C interface context object.
+  spv_validator_options options;   // Not owned; may be null.
+  std::vector<uint32_t> words;     // Accumulated module, in host endianness.
+  size_t scanned_words = 0;        // Words covered by the early checks.
+  size_t instruction_count = 0;    // Instructions seen by the early checks.
+  spv_endianness_t endian = SPV_ENDIANNESS_LITTLE;
+  bool endian_known = false;
+  bool requires_conversion = false;
+  bool header_checked = false;
+  bool failed = false;
+};
+
+void StreamingValidator::Impl::ScanCompletedInstructions() {
+  if (!header_checked) {
+    if (words.size() < SPV_INDEX_INSTRUCTION) return;
+    const spv_const_binary_t binary{words.data(), words.size()};
+    if (spvBinaryEndianness(&binary, &endian)) {
+      Fail("Invalid SPIR-V magic number.");
+      return;
+    }
+    endian_known = true;
+    requires_conversion = !spvIsHostEndian(endian);
+    if (requires_conversion) {
+      // Convert the words buffered so far; later pushes convert on arrival.
+      for (auto& word : words) word = spvFixWord(word, endian);
+    }
+    const uint32_t version = words[SPV_INDEX_VERSION_NUMBER];
+    if ((version & 0x000000ff) || (version & 0xff000000) ||
+        version < SPV_SPIRV_VERSION_WORD(1, 0) || version > SPV_VERSION) {
+      Fail("Invalid SPIR-V version in module header.");
+      return;
+    }
+    header_checked = true;
+    scanned_words = SPV_INDEX_INSTRUCTION;
+  }
+
+  const AssemblyGrammar grammar(context);
+  while (scanned_words < words.size()) {
+    uint16_t inst_word_count = 0;
+    uint16_t opcode = 0;
+    spvOpcodeSplit(words[scanned_words], &inst_word_count, &opcode);
+    if (inst_word_count < 1) {
+      Fail("Invalid instruction word count: 0.");
+      return;
+    }
+    spv_opcode_desc opcode_desc;
+    if (grammar.lookupOpcode(static_cast<spv::Op>(opcode), &opcode_desc)) {
+      Fail("Invalid opcode: " + std::to_string(opcode) + ".");
+      return;
+    }
+    if (scanned_words + inst_word_count > words.size()) {
+      // The instruction is not complete yet; resume here on the next push.
+      return;
+    }
+    scanned_words += inst_word_count;
+    ++instruction_count;
+  }
+}
+
+StreamingValidator::StreamingValidator(spv_target_env env,
+                                       spv_validator_options options)
+    : impl_(new Impl(env, options)) {}
+
+StreamingValidator::~StreamingValidator() {}
+
+void StreamingValidator::SetMessageConsumer(MessageConsumer consumer) {
+  SetContextMessageConsumer(impl_->context, std::move(consumer));
+}
+
+bool StreamingValidator::PushWords(const uint32_t* words, size_t num_words) {
+  if (impl_->failed) return false;
+  const size_t old_size = impl_->words.size();
+  impl_->words.resize(old_size + num_words);
+  if (impl_->endian_known && impl_->requires_conversion) {
+    for (size_t i = 0; i < num_words; ++i) {
+      impl_->words[old_size + i] = spvFixWord(words[i], impl_->endian);
+    }
+  } else {
+    memcpy(impl_->words.data() + old_size, words,
+           num_words * sizeof(uint32_t));
+  }
+  impl_->ScanCompletedInstructions();
+  return !impl_->failed;
+}
+
+bool StreamingValidator::Finish() {
+  if (impl_->failed) return false;
+  if (!impl_->header_checked) {
+    impl_->Fail("Module has incomplete header: only " +
+                std::to_string(impl_->words.size()) + " words instead of " +
+                std::to_string(SPV_INDEX_INSTRUCTION) + ".");
+    return false;
+  }
+  if (impl_->scanned_words != impl_->words.size()) {
+    impl_->Fail("Module ends in the middle of an instruction.");
+    return false;
+  }
+  // The buffered words are already in host endianness.  Passing a null
+  // diagnostic routes messages to the context's consumer.
+  const spv_const_binary_t binary{impl_->words.data(), impl_->words.size()};
+  const spv_result_t result =
+      impl_->options ? spvValidateWithOptions(impl_->context, impl_->options,
+                                              &binary, nullptr)
+                     : spvValidate(impl_->context, &binary, nullptr);
+  return result == SPV_SUCCESS;
+}
+
+}  // namespace spvtools
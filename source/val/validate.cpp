@@ -17,7 +17,9 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "source/binary.h"
@@ -25,9 +27,12 @@
 #include "source/enum_string_mapping.h"
 #include "source/extensions.h"
 #include "source/opcode.h"
+#include "source/operand.h"
 #include "source/spirv_constant.h"
 #include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
+#include "source/table.h"
+#include "source/util/thread_pool.h"
 #include "source/val/construct.h"
 #include "source/val/instruction.h"
 #include "source/val/validation_state.h"
@@ -144,6 +149,312 @@ spv_result_t ValidateEntryPoints(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
+// Per-run dispatch gates for the category passes whose opcodes all require
+// specific capabilities.  CapabilityPass has already rejected any such opcode
+// in a module that does not declare a corresponding capability, so when none
+// of the capabilities are present the pass cannot match any instruction and
+// is skipped for the whole run.  Built once per validation run, after all
+// OpCapability instructions have been registered.
+struct CapabilityGatedPasses {
+  explicit CapabilityGatedPasses(const ValidationState_t& _)
+      : run_derivatives(_.HasCapability(spv::Capability::Shader)),
+        run_non_uniform(
+            _.HasCapability(spv::Capability::GroupNonUniform) ||
+            _.HasCapability(spv::Capability::GroupNonUniformRotateKHR) ||
+            _.HasCapability(spv::Capability::GroupNonUniformPartitionedNV)),
+        run_ray_query(_.HasCapability(spv::Capability::RayQueryKHR)),
+        run_ray_tracing(_.HasCapability(spv::Capability::RayTracingKHR) ||
+                        _.HasCapability(spv::Capability::RayTracingNV)),
+        run_ray_reorder(
+            _.HasCapability(spv::Capability::ShaderInvocationReorderNV)),
+        run_mesh_shading(_.HasCapability(spv::Capability::MeshShadingEXT) ||
+                         _.HasCapability(spv::Capability::MeshShadingNV)) {}
+
+  const bool run_derivatives;
+  const bool run_non_uniform;
+  const bool run_ray_query;
+  const bool run_ray_tracing;
+  const bool run_ray_reorder;
+  const bool run_mesh_shading;
+};
+
+// Runs the per-instruction validation passes that follow ID-use analysis on a
+// single instruction.
+spv_result_t ValidateOpcodePasses(ValidationState_t& _,
+                                  const Instruction* instruction,
+                                  const CapabilityGatedPasses& gates) {
+  // Keep these passes in the order they appear in the SPIR-V specification
+  // sections to maintain test consistency.
+  if (auto error = MiscPass(_, instruction)) return error;
+  if (auto error = DebugPass(_, instruction)) return error;
+  if (auto error = AnnotationPass(_, instruction)) return error;
+  if (auto error = ExtensionPass(_, instruction)) return error;
+  if (auto error = ModeSettingPass(_, instruction)) return error;
+  if (auto error = TypePass(_, instruction)) return error;
+  if (auto error = ConstantPass(_, instruction)) return error;
+  if (auto error = MemoryPass(_, instruction)) return error;
+  if (auto error = FunctionPass(_, instruction)) return error;
+  if (auto error = ImagePass(_, instruction)) return error;
+  if (auto error = ConversionPass(_, instruction)) return error;
+  if (auto error = CompositesPass(_, instruction)) return error;
+  if (auto error = ArithmeticsPass(_, instruction)) return error;
+  if (auto error = BitwisePass(_, instruction)) return error;
+  if (auto error = LogicalsPass(_, instruction)) return error;
+  if (auto error = ControlFlowPass(_, instruction)) return error;
+  if (gates.run_derivatives) {
+    if (auto error = DerivativesPass(_, instruction)) return error;
+  }
+  if (auto error = AtomicsPass(_, instruction)) return error;
+  if (auto error = PrimitivesPass(_, instruction)) return error;
+  if (auto error = BarriersPass(_, instruction)) return error;
+  // Group
+  // Device-Side Enqueue
+  // Pipe
+  if (gates.run_non_uniform) {
+    if (auto error = NonUniformPass(_, instruction)) return error;
+  }
+
+  if (auto error = LiteralsPass(_, instruction)) return error;
+  if (gates.run_ray_query) {
+    if (auto error = RayQueryPass(_, instruction)) return error;
+  }
+  if (gates.run_ray_tracing) {
+    if (auto error = RayTracingPass(_, instruction)) return error;
+  }
+  if (gates.run_ray_reorder) {
+    if (auto error = RayReorderNVPass(_, instruction)) return error;
+  }
+  if (gates.run_mesh_shading) {
+    if (auto error = MeshShadingPass(_, instruction)) return error;
+  }
+  return SPV_SUCCESS;
+}
+
+// FNV-1a 64-bit hashing used to key the per-context validation cache.
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+uint64_t HashWord(uint64_t hash, uint32_t word) {
+  for (int byte = 0; byte < 4; ++byte) {
+    hash = (hash ^ ((word >> (8 * byte)) & 0xffu)) * kFnvPrime;
+  }
+  return hash;
+}
+
+uint64_t HashWords(uint64_t hash, const std::vector<uint32_t>& words) {
+  for (uint32_t word : words) hash = HashWord(hash, word);
+  return hash;
+}
+
+// Mixes in the validator option fields that can change a validation outcome.
+// Fields are hashed one by one since hashing the raw struct bytes would pick
+// up padding.  The thread count and the friendly-name flag only affect
+// scheduling and message text, never outcomes, so they are left out.
+uint64_t HashValidatorOptions(uint64_t hash,
+                              const spv_validator_options_t& options) {
+  const validator_universal_limits_t& limits = options.universal_limits_;
+  const uint32_t limit_fields[] = {
+      limits.max_struct_members,      limits.max_struct_depth,
+      limits.max_local_variables,     limits.max_global_variables,
+      limits.max_switch_branches,     limits.max_function_args,
+      limits.max_control_flow_nesting_depth,
+      limits.max_access_chain_indexes, limits.max_id_bound};
+  for (uint32_t field : limit_fields) hash = HashWord(hash, field);
+  const bool flag_fields[] = {options.relax_struct_store,
+                              options.relax_logical_pointer,
+                              options.relax_block_layout,
+                              options.uniform_buffer_standard_layout,
+                              options.scalar_block_layout,
+                              options.workgroup_scalar_block_layout,
+                              options.skip_block_layout,
+                              options.allow_localsizeid,
+                              options.before_hlsl_legalization};
+  for (bool field : flag_fields) hash = HashWord(hash, field ? 1u : 0u);
+  return hash;
+}
+
+// Hashes everything the per-instruction passes can observe when run over the
+// function body in |instructions[begin, end)|: the body's own words, the
+// words of every module-scope instruction it references (transitively,
+// through FindDef), the module's version, capabilities, extensions and
+// memory model, and the validator options.  Two bodies with equal hashes
+// present identical inputs to those passes, so one body's outcome can stand
+// in for the other's.
+uint64_t HashFunctionRange(const ValidationState_t& _,
+                           size_t first_function_index, size_t begin,
+                           size_t end) {
+  const auto& instructions = _.ordered_instructions();
+  uint64_t hash = HashWord(kFnvOffsetBasis, _.version());
+  for (size_t i = 0; i < first_function_index; ++i) {
+    const spv::Op opcode = instructions[i].opcode();
+    if (opcode == spv::Op::OpCapability || opcode == spv::Op::OpExtension ||
+        opcode == spv::Op::OpMemoryModel) {
+      hash = HashWords(hash, instructions[i].words());
+    }
+  }
+  hash = HashValidatorOptions(hash, *_.options());
+
+  std::unordered_set<uint32_t> visited;
+  std::vector<const Instruction*> worklist;
+  auto enqueue_referenced_defs = [&_, &visited,
+                                  &worklist](const Instruction& inst) {
+    for (const auto& operand : inst.operands()) {
+      if (!spvIsIdType(operand.type)) continue;
+      const uint32_t id = inst.word(operand.offset);
+      if (!visited.insert(id).second) continue;
+      const Instruction* def = _.FindDef(id);
+      if (def && def->function() == nullptr) worklist.push_back(def);
+    }
+  };
+  for (size_t i = begin; i < end; ++i) {
+    hash = HashWords(hash, instructions[i].words());
+    enqueue_referenced_defs(instructions[i]);
+  }
+  // The worklist fills in a deterministic order, so the hash is stable for a
+  // given body and module-scope section.
+  while (!worklist.empty()) {
+    const Instruction* def = worklist.back();
+    worklist.pop_back();
+    hash = HashWords(hash, def->words());
+    enqueue_referenced_defs(*def);
+  }
+  return hash;
+}
+
+// Records |hash| in the context's validation cache once the body of the
+// function defined by |function_id| has passed the per-instruction passes.
+// Bodies that registered limitation functors are not cached: skipping their
+// checks on a later run would also skip those registrations, which
+// ValidateExecutionLimitations consults when checking entry points.
+void RecordValidatedBody(ValidationState_t* vstate, uint32_t function_id,
+                         uint64_t hash) {
+  auto* cache = vstate->context()->validated_function_hashes.get();
+  if (cache == nullptr) return;
+  const Function* func = vstate->function(function_id);
+  if (func == nullptr || func->num_limitations() != 0) return;
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  cache->hashes.insert(hash);
+}
+
+// Runs the per-instruction validation passes over the whole module.  When the
+// validator options request more than one thread, the function bodies are
+// checked on worker threads: these passes only read module-scope state and
+// only mutate the val::Function the instruction belongs to, so distinct
+// functions can be checked concurrently.  Module-scope instructions, whose
+// passes register execution modes, decorations, types and constants, are
+// always handled first, in order, on the calling thread.  Diagnostics from
+// worker threads are buffered and replayed in instruction order, so the
+// reported messages and the returned code match a single-threaded run.
+//
+// Function bodies are also checked against the spv_context's validation
+// cache: a body whose hash (see HashFunctionRange) passed these passes in an
+// earlier run with the same context is not re-checked.  This makes repeated
+// validation of module variants that share most of their functions pay the
+// per-instruction checks only for bodies it has not seen before.
+spv_result_t ValidateIndividualOpcodes(ValidationState_t* vstate) {
+  const auto& instructions = vstate->ordered_instructions();
+  const CapabilityGatedPasses gates(*vstate);
+
+  // Find where the function section starts.  The module layout pass has
+  // already checked that no module-scope instruction follows it.
+  size_t first_function_index = instructions.size();
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    if (instructions[i].opcode() == spv::Op::OpFunction) {
+      first_function_index = i;
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < first_function_index; ++i) {
+    if (auto error = ValidateOpcodePasses(*vstate, &instructions[i], gates))
+      return error;
+  }
+
+  // A contiguous range of instructions making up one function body, together
+  // with the outcome of validating it.
+  struct FunctionRange {
+    size_t begin;
+    size_t end;
+    spv_result_t result = SPV_SUCCESS;
+    std::vector<ValidationState_t::BufferedDiagnostic> diagnostics;
+  };
+
+  std::vector<FunctionRange> ranges;
+  for (size_t i = first_function_index; i < instructions.size(); ++i) {
+    if (instructions[i].opcode() == spv::Op::OpFunction || ranges.empty()) {
+      ranges.push_back({i, i, SPV_SUCCESS, {}});
+    }
+    ranges.back().end = i + 1;
+  }
+
+  // Look up each body in the context's validation cache.  A hit means an
+  // identical body, referencing an identical module-scope slice, already
+  // passed these passes with this context, so the body is skipped below.
+  auto* cache = vstate->context()->validated_function_hashes.get();
+  std::vector<uint64_t> range_hashes(ranges.size(), 0);
+  std::vector<bool> already_validated(ranges.size(), false);
+  if (cache != nullptr) {
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      range_hashes[i] = HashFunctionRange(*vstate, first_function_index,
+                                          ranges[i].begin, ranges[i].end);
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      already_validated[i] = cache->hashes.count(range_hashes[i]) != 0;
+    }
+  }
+
+  size_t num_threads = vstate->options()->parallel_validation_threads;
+  if (num_threads == 0) num_threads = utils::ThreadPool::DefaultThreadCount();
+
+  if (num_threads <= 1 || ranges.size() < 2) {
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      if (already_validated[i]) continue;
+      for (size_t j = ranges[i].begin; j < ranges[i].end; ++j) {
+        if (auto error =
+                ValidateOpcodePasses(*vstate, &instructions[j], gates)) {
+          return error;
+        }
+      }
+      RecordValidatedBody(vstate, instructions[ranges[i].begin].id(),
+                          range_hashes[i]);
+    }
+    return SPV_SUCCESS;
+  }
+
+  vstate->EnterParallelValidation();
+  {
+    utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      if (already_validated[i]) continue;
+      auto& range = ranges[i];
+      pool.Schedule([vstate, &instructions, &range, &gates] {
+        vstate->BeginThreadLocalDiagnostics(&range.diagnostics);
+        for (size_t j = range.begin; j < range.end; ++j) {
+          range.result = ValidateOpcodePasses(*vstate, &instructions[j], gates);
+          if (range.result != SPV_SUCCESS) break;
+        }
+        vstate->EndThreadLocalDiagnostics();
+      });
+    }
+    pool.Wait();
+  }
+  vstate->LeaveParallelValidation();
+
+  // Replay diagnostics in instruction order, stopping at the first failing
+  // function, exactly as the single-threaded loop would have done.
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    vstate->ReplayDiagnostics(ranges[i].diagnostics);
+    if (ranges[i].result != SPV_SUCCESS) return ranges[i].result;
+    if (!already_validated[i]) {
+      RecordValidatedBody(vstate, instructions[ranges[i].begin].id(),
+                          range_hashes[i]);
+    }
+  }
+
+  return SPV_SUCCESS;
+}
+
 spv_result_t ValidateBinaryUsingContextAndValidationState(
     const spv_context_t& context, const uint32_t* words, const size_t num_words,
     spv_diagnostic* pDiagnostic, ValidationState_t* vstate) {
@@ -324,42 +635,7 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
   }
 
   // Validate individual opcodes.
-  for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
-    auto& instruction = vstate->ordered_instructions()[i];
-
-    // Keep these passes in the order they appear in the SPIR-V specification
-    // sections to maintain test consistency.
-    if (auto error = MiscPass(*vstate, &instruction)) return error;
-    if (auto error = DebugPass(*vstate, &instruction)) return error;
-    if (auto error = AnnotationPass(*vstate, &instruction)) return error;
-    if (auto error = ExtensionPass(*vstate, &instruction)) return error;
-    if (auto error = ModeSettingPass(*vstate, &instruction)) return error;
-    if (auto error = TypePass(*vstate, &instruction)) return error;
-    if (auto error = ConstantPass(*vstate, &instruction)) return error;
-    if (auto error = MemoryPass(*vstate, &instruction)) return error;
-    if (auto error = FunctionPass(*vstate, &instruction)) return error;
-    if (auto error = ImagePass(*vstate, &instruction)) return error;
-    if (auto error = ConversionPass(*vstate, &instruction)) return error;
-    if (auto error = CompositesPass(*vstate, &instruction)) return error;
-    if (auto error = ArithmeticsPass(*vstate, &instruction)) return error;
-    if (auto error = BitwisePass(*vstate, &instruction)) return error;
-    if (auto error = LogicalsPass(*vstate, &instruction)) return error;
-    if (auto error = ControlFlowPass(*vstate, &instruction)) return error;
-    if (auto error = DerivativesPass(*vstate, &instruction)) return error;
-    if (auto error = AtomicsPass(*vstate, &instruction)) return error;
-    if (auto error = PrimitivesPass(*vstate, &instruction)) return error;
-    if (auto error = BarriersPass(*vstate, &instruction)) return error;
-    // Group
-    // Device-Side Enqueue
-    // Pipe
-    if (auto error = NonUniformPass(*vstate, &instruction)) return error;
-
-    if (auto error = LiteralsPass(*vstate, &instruction)) return error;
-    if (auto error = RayQueryPass(*vstate, &instruction)) return error;
-    if (auto error = RayTracingPass(*vstate, &instruction)) return error;
-    if (auto error = RayReorderNVPass(*vstate, &instruction)) return error;
-    if (auto error = MeshShadingPass(*vstate, &instruction)) return error;
-  }
+  if (auto error = ValidateIndividualOpcodes(vstate)) return error;
 
   // Validate the preconditions involving adjacent instructions. e.g.
   // spv::Op::OpPhi must only be preceded by spv::Op::OpLabel, spv::Op::OpPhi,
@@ -876,6 +876,12 @@ spv_result_t StructuredControlFlowChecks(
 }
 
 spv_result_t PerformCfgChecks(ValidationState_t& _) {
+  // Scratch containers shared by the traversals of every function so their
+  // storage is allocated once per validation run instead of per function.
+  CFA<BasicBlock>::TraversalWorkspace workspace;
+  std::vector<const BasicBlock*> postorder;
+  std::vector<const BasicBlock*> postdom_postorder;
+  std::vector<std::pair<uint32_t, uint32_t>> back_edges;
   for (auto& function : _.functions()) {
     // Check all referenced blocks are defined within a function
     if (function.undefined_block_count() != 0) {
@@ -899,7 +905,7 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
     // We want to analyze all the blocks in the function, even in degenerate
     // control flow cases including unreachable blocks.  So use the augmented
     // CFG to ensure we cover all the blocks.
-    std::vector<const BasicBlock*> postorder;
+    postorder.clear();
     auto ignore_block = [](const BasicBlock*) {};
     auto no_terminal_blocks = [](const BasicBlock*) { return false; };
     if (!function.ordered_blocks().empty()) {
@@ -907,7 +913,7 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
       CFA<BasicBlock>::DepthFirstTraversal(
           function.first_block(), function.AugmentedCFGSuccessorsFunction(),
           ignore_block, [&](const BasicBlock* b) { postorder.push_back(b); },
-          no_terminal_blocks);
+          /* backedge = */ {}, no_terminal_blocks, &workspace);
       auto edges = CFA<BasicBlock>::CalculateDominators(
           postorder, function.AugmentedCFGPredecessorsFunction());
       for (auto edge : edges) {
@@ -950,15 +956,15 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
     if (_.HasCapability(spv::Capability::Shader)) {
       // Calculate structural dominance.
       postorder.clear();
-      std::vector<const BasicBlock*> postdom_postorder;
-      std::vector<std::pair<uint32_t, uint32_t>> back_edges;
+      postdom_postorder.clear();
+      back_edges.clear();
       if (!function.ordered_blocks().empty()) {
         /// calculate dominators
         CFA<BasicBlock>::DepthFirstTraversal(
             function.first_block(),
             function.AugmentedStructuralCFGSuccessorsFunction(), ignore_block,
             [&](const BasicBlock* b) { postorder.push_back(b); },
-            no_terminal_blocks);
+            /* backedge = */ {}, no_terminal_blocks, &workspace);
         auto edges = CFA<BasicBlock>::CalculateDominators(
             postorder, function.AugmentedStructuralCFGPredecessorsFunction());
         for (auto edge : edges) {
@@ -971,7 +977,7 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
             function.pseudo_exit_block(),
             function.AugmentedStructuralCFGPredecessorsFunction(), ignore_block,
             [&](const BasicBlock* b) { postdom_postorder.push_back(b); },
-            no_terminal_blocks);
+            /* backedge = */ {}, no_terminal_blocks, &workspace);
         auto postdom_edges = CFA<BasicBlock>::CalculateDominators(
             postdom_postorder,
             function.AugmentedStructuralCFGSuccessorsFunction());
@@ -990,7 +996,7 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
                 if (succ == to) back_edges.emplace_back(from->id(), to->id());
               }
             },
-            no_terminal_blocks);
+            no_terminal_blocks, &workspace);
       }
       UpdateContinueConstructExitBlocks(function, back_edges);
 
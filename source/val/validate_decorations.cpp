@@ -415,6 +415,30 @@ bool IsAlignedTo(uint32_t offset, uint32_t alignment) {
   return 0 == (offset % alignment);
 }
 
+// Layout-affecting validator options and environment facts, resolved once
+// per run.  The layout loops below consult these per member; reading them
+// from plain const bools keeps the option predicates loop-invariant instead
+// of re-chasing the options pointer on every iteration.
+struct LayoutRules {
+  bool skip_block_layout;
+  bool uniform_buffer_standard_layout;
+  bool scalar_block_layout;
+  bool workgroup_scalar_block_layout;
+  bool relaxed_block_layout;
+};
+
+LayoutRules GetLayoutRules(const ValidationState_t& vstate) {
+  LayoutRules rules;
+  rules.skip_block_layout = vstate.options()->skip_block_layout;
+  rules.uniform_buffer_standard_layout =
+      vstate.options()->uniform_buffer_standard_layout;
+  rules.scalar_block_layout = vstate.options()->scalar_block_layout;
+  rules.workgroup_scalar_block_layout =
+      vstate.options()->workgroup_scalar_block_layout;
+  rules.relaxed_block_layout = vstate.IsRelaxedBlockLayout();
+  return rules;
+}
+
 // Returns SPV_SUCCESS if the given struct satisfies standard layout rules for
 // Block or BufferBlocks in Vulkan.  Otherwise emits a diagnostic and returns
 // something other than SPV_SUCCESS.  Matrices inherit the specified column
@@ -424,17 +448,18 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
                          bool scalar_block_layout,
                          uint32_t incoming_offset,
                          MemberConstraints& constraints,
+                         const LayoutRules& rules,
                          ValidationState_t& vstate) {
-  if (vstate.options()->skip_block_layout) return SPV_SUCCESS;
+  if (rules.skip_block_layout) return SPV_SUCCESS;
 
   // blockRules are the same as bufferBlock rules if the uniform buffer
   // standard layout extension is being used.
-  if (vstate.options()->uniform_buffer_standard_layout) blockRules = false;
+  if (rules.uniform_buffer_standard_layout) blockRules = false;
 
   // Relaxed layout and scalar layout can both be in effect at the same time.
   // For example, relaxed layout is implied by Vulkan 1.1.  But scalar layout
   // is more permissive than relaxed layout.
-  const bool relaxed_block_layout = vstate.IsRelaxedBlockLayout();
+  const bool relaxed_block_layout = rules.relaxed_block_layout;
 
   auto fail = [&vstate, struct_id, storage_class_str, decoration_str,
                blockRules, relaxed_block_layout,
@@ -545,7 +570,8 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (spv::Op::OpTypeStruct == opcode &&
         SPV_SUCCESS != (recursive_status = checkLayout(
                             id, storage_class_str, decoration_str, blockRules,
-                            scalar_block_layout, offset, constraints, vstate)))
+                            scalar_block_layout, offset, constraints, rules,
+                            vstate)))
       return recursive_status;
     // Check matrix stride.
     if (spv::Op::OpTypeMatrix == opcode) {
@@ -602,7 +628,8 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
           if (SPV_SUCCESS !=
               (recursive_status = checkLayout(
                    typeId, storage_class_str, decoration_str, blockRules,
-                   scalar_block_layout, next_offset, constraints, vstate)))
+                   scalar_block_layout, next_offset, constraints, rules,
+                   vstate)))
             return recursive_status;
 
           seen[next_offset % 16] = true;
@@ -1021,6 +1048,14 @@ void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
 spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
   // Set of entry points that are known to use a push constant.
   std::unordered_set<uint32_t> uses_push_constant;
+  // Member constraints and layout checks depend only on the struct type and
+  // the layout rules in effect, not on the variable referencing the struct.
+  // Compute and check each distinct combination once per module; descriptor-
+  // heavy modules reference the same block type from many variables.
+  MemberConstraints constraints;
+  std::unordered_set<uint32_t> constraints_computed;
+  std::unordered_set<std::pair<uint32_t, uint32_t>, PairHash> checked_layouts;
+  const LayoutRules layout_rules = GetLayoutRules(vstate);
   for (const auto& inst : vstate.ordered_instructions()) {
     const auto& words = inst.words();
     if (spv::Op::OpVariable == inst.opcode()) {
@@ -1117,9 +1152,10 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
         }
         // Struct requirement is checked on variables so just move on here.
         if (spv::Op::OpTypeStruct != id_inst->opcode()) continue;
-        MemberConstraints constraints;
-        ComputeMemberConstraintsForStruct(&constraints, id, LayoutConstraints(),
-                                          vstate);
+        if (constraints_computed.insert(id).second) {
+          ComputeMemberConstraintsForStruct(&constraints, id,
+                                            LayoutConstraints(), vstate);
+        }
         // Prepare for messages
         const char* sc_str =
             uniform ? "Uniform"
@@ -1211,9 +1247,14 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
           if (blockRules || bufferRules) {
             const char* deco_str = blockDeco ? "Block" : "BufferBlock";
             spv_result_t recursive_status = SPV_SUCCESS;
-            const bool scalar_block_layout = workgroup ?
-                vstate.options()->workgroup_scalar_block_layout :
-                vstate.options()->scalar_block_layout;
+            const bool scalar_block_layout =
+                workgroup ? layout_rules.workgroup_scalar_block_layout
+                          : layout_rules.scalar_block_layout;
+
+            // Skip if this layout was already checked under the same rules.
+            const auto layout_key = std::make_pair(
+                id, (blockRules ? 1u : 0u) | (scalar_block_layout ? 2u : 0u));
+            if (!checked_layouts.insert(layout_key).second) continue;
 
             if (isMissingOffsetInStruct(id, vstate)) {
               return vstate.diag(SPV_ERROR_INVALID_ID, vstate.FindDef(id))
@@ -1260,16 +1301,17 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
             }
 
             if (spvIsVulkanEnv(vstate.context()->target_env)) {
-              if (blockRules && (SPV_SUCCESS != (recursive_status = checkLayout(
-                                                     id, sc_str, deco_str, true,
-                                                     scalar_block_layout, 0,
-                                                     constraints, vstate)))) {
+              if (blockRules &&
+                  (SPV_SUCCESS !=
+                   (recursive_status = checkLayout(
+                        id, sc_str, deco_str, true, scalar_block_layout, 0,
+                        constraints, layout_rules, vstate)))) {
                 return recursive_status;
               } else if (bufferRules &&
                          (SPV_SUCCESS !=
                           (recursive_status = checkLayout(
                                id, sc_str, deco_str, false, scalar_block_layout,
-                               0, constraints, vstate)))) {
+                               0, constraints, layout_rules, vstate)))) {
                 return recursive_status;
               }
             }
@@ -1403,8 +1445,8 @@ spv_result_t CheckVulkanMemoryModelDeprecatedDecorations(
 
   std::string msg;
   std::ostringstream str(msg);
-  for (const auto& def : vstate.all_definitions()) {
-    const auto inst = def.second;
+  for (const auto* inst : vstate.all_definitions()) {
+    if (inst == nullptr) continue;
     const auto id = inst->id();
     for (const auto& dec : vstate.id_decorations(id)) {
       const auto member = dec.struct_member_index();
@@ -77,48 +77,19 @@ bool CheckAllImageOperandsHandled() {
   return false;
 }
 
-// Used by GetImageTypeInfo. See OpTypeImage spec for more information.
-struct ImageTypeInfo {
-  uint32_t sampled_type = 0;
-  spv::Dim dim = spv::Dim::Max;
-  uint32_t depth = 0;
-  uint32_t arrayed = 0;
-  uint32_t multisampled = 0;
-  uint32_t sampled = 0;
-  spv::ImageFormat format = spv::ImageFormat::Max;
-  spv::AccessQualifier access_qualifier = spv::AccessQualifier::Max;
-};
-
 // Provides information on image type. |id| should be object of either
 // OpTypeImage or OpTypeSampledImage type. Returns false in case of failure
-// (not a valid id, failed to parse the instruction, etc).
+// (not a valid id, failed to parse the instruction, etc).  The descriptors
+// themselves are decoded once per type when the module is registered; see
+// ValidationState_t::GetImageTypeInfo.
 bool GetImageTypeInfo(const ValidationState_t& _, uint32_t id,
                       ImageTypeInfo* info) {
   if (!id || !info) return false;
 
-  const Instruction* inst = _.FindDef(id);
-  assert(inst);
-
-  if (inst->opcode() == spv::Op::OpTypeSampledImage) {
-    inst = _.FindDef(inst->word(2));
-    assert(inst);
-  }
+  const ImageTypeInfo* cached = _.GetImageTypeInfo(id);
+  if (!cached) return false;
 
-  if (inst->opcode() != spv::Op::OpTypeImage) return false;
-
-  const size_t num_words = inst->words().size();
-  if (num_words != 9 && num_words != 10) return false;
-
-  info->sampled_type = inst->word(2);
-  info->dim = static_cast<spv::Dim>(inst->word(3));
-  info->depth = inst->word(4);
-  info->arrayed = inst->word(5);
-  info->multisampled = inst->word(6);
-  info->sampled = inst->word(7);
-  info->format = static_cast<spv::ImageFormat>(inst->word(8));
-  info->access_qualifier =
-      num_words < 10 ? spv::AccessQualifier::Max
-                     : static_cast<spv::AccessQualifier>(inst->word(9));
+  *info = *cached;
   return true;
 }
 
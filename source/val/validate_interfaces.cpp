@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "source/spirv_constant.h"
@@ -46,10 +48,32 @@ bool is_interface_variable(const Instruction* inst, bool is_spv_1_4) {
   }
 }
 
+// The interface ids of one OpEntryPoint, as a set for O(1) membership tests.
+// Entry points are indexed by id; one id can have several descriptions when
+// the same function is exported under several names.
+using EntryPointInterfaceSets =
+    std::unordered_map<uint32_t, std::vector<std::unordered_set<uint32_t>>>;
+
+// Returns the interface sets of entry point |id|, building and caching them
+// on first use so the operand lists are only scanned once per entry point.
+const std::vector<std::unordered_set<uint32_t>>& GetEntryPointInterfaceSets(
+    ValidationState_t& _, uint32_t id, EntryPointInterfaceSets* cache) {
+  auto where = cache->find(id);
+  if (where == cache->end()) {
+    auto& sets = (*cache)[id];
+    for (const auto& desc : _.entry_point_descriptions(id)) {
+      sets.emplace_back(desc.interfaces.begin(), desc.interfaces.end());
+    }
+    return sets;
+  }
+  return where->second;
+}
+
 // Checks that \c var is listed as an interface in all the entry points that use
 // it.
 spv_result_t check_interface_variable(ValidationState_t& _,
-                                      const Instruction* var) {
+                                      const Instruction* var,
+                                      EntryPointInterfaceSets* interface_sets) {
   std::vector<const Function*> functions;
   std::vector<const Instruction*> uses;
   for (auto use : var->uses()) {
@@ -88,15 +112,10 @@ spv_result_t check_interface_variable(ValidationState_t& _,
                      entry_points.end());
 
   for (auto id : entry_points) {
-    for (const auto& desc : _.entry_point_descriptions(id)) {
-      bool found = false;
-      for (auto interface : desc.interfaces) {
-        if (var->id() == interface) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
+    const auto& sets = GetEntryPointInterfaceSets(_, id, interface_sets);
+    for (size_t i = 0; i < sets.size(); ++i) {
+      if (sets[i].count(var->id()) == 0) {
+        const auto& desc = _.entry_point_descriptions(id)[i];
         return _.diag(SPV_ERROR_INVALID_ID, var)
                << "Interface variable id <" << var->id()
                << "> is used by entry point '" << desc.name << "' id <" << id
@@ -214,17 +233,39 @@ uint32_t NumConsumedComponents(ValidationState_t& _, const Instruction* type) {
   return num_components;
 }
 
-// Populates |locations| (and/or |output_index1_locations|) with the use
-// location and component coordinates for |variable|. Indices are calculated as
-// 4 * location + component.
-spv_result_t GetLocationsForVariable(
-    ValidationState_t& _, const Instruction* entry_point,
-    const Instruction* variable, std::unordered_set<uint32_t>* locations,
-    std::unordered_set<uint32_t>* output_index1_locations) {
-  const bool is_fragment = entry_point->GetOperandAs<spv::ExecutionModel>(0) ==
-                           spv::ExecutionModel::Fragment;
+// One location-component slot consumed by a variable, together with the
+// coordinates used to report a conflict on that slot.
+struct VariableLocationSlot {
+  uint32_t index;  // Calculated as 4 * location + component.
+  uint32_t reported_location;
+  uint32_t reported_component;
+};
+
+// The slots consumed by one interface variable under one execution model.
+// The footprint only depends on the variable and the execution model, so it
+// is cached across entry points within a validation run; conflicts between
+// variables are still detected per entry point when footprints are merged.
+struct VariableLocations {
+  bool is_output = false;
+  // True when the slots land in the index 1 output set (dual-source
+  // blending) instead of the index 0 one.
+  bool use_index1 = false;
+  std::vector<VariableLocationSlot> slots;
+};
+
+// Cache of VariableLocations keyed by execution model and variable id.
+using VariableLocationsCache = std::unordered_map<uint64_t, VariableLocations>;
+
+// Populates |result| with the use location and component coordinates for
+// |variable| under execution model |model|.  Built-ins consume no slots.
+spv_result_t ComputeLocationsForVariable(ValidationState_t& _,
+                                         spv::ExecutionModel model,
+                                         const Instruction* variable,
+                                         VariableLocations* result) {
+  const bool is_fragment = model == spv::ExecutionModel::Fragment;
   const bool is_output =
       variable->GetOperandAs<spv::StorageClass>(2) == spv::StorageClass::Output;
+  result->is_output = is_output;
   auto ptr_type_id = variable->GetOperandAs<uint32_t>(0);
   auto ptr_type = _.FindDef(ptr_type_id);
   auto type_id = ptr_type->GetOperandAs<uint32_t>(2);
@@ -296,7 +337,7 @@ spv_result_t GetLocationsForVariable(
   // tessellation control, evaluation and geometry per-vertex inputs have a
   // layer of arraying that is not included in interface matching.
   bool is_arrayed = false;
-  switch (entry_point->GetOperandAs<spv::ExecutionModel>(0)) {
+  switch (model) {
     case spv::ExecutionModel::TessellationControl:
       if (!has_patch) {
         is_arrayed = true;
@@ -346,8 +387,8 @@ spv_result_t GetLocationsForVariable(
            << _.VkErrorID(vuid) << "Variable must be decorated with a location";
   }
 
-  const std::string storage_class = is_output ? "output" : "input";
   if (has_location) {
+    result->use_index1 = has_index && index == 1;
     auto sub_type = type;
     bool is_int = false;
     bool is_const = false;
@@ -382,17 +423,8 @@ spv_result_t GetLocationsForVariable(
         end = array_location * 4 + component + num_components;
       }
 
-      auto locs = locations;
-      if (has_index && index == 1) locs = output_index1_locations;
-
       for (uint32_t i = start; i < end; ++i) {
-        if (!locs->insert(i).second) {
-          return _.diag(SPV_ERROR_INVALID_DATA, entry_point)
-                 << (is_output ? _.VkErrorID(8722) : _.VkErrorID(8721))
-                 << "Entry-point has conflicting " << storage_class
-                 << " location assignment at location " << i / 4
-                 << ", component " << i % 4;
-        }
+        result->slots.push_back({i, i / 4, i % 4});
       }
     }
   } else {
@@ -457,14 +489,7 @@ spv_result_t GetLocationsForVariable(
         // size, calculate the used locations in a strided manner.
         for (uint32_t l = location; l < num_locations + location; ++l) {
           for (uint32_t c = component; c < component + num_components; ++c) {
-            uint32_t check = 4 * l + c;
-            if (!locations->insert(check).second) {
-              return _.diag(SPV_ERROR_INVALID_DATA, entry_point)
-                     << (is_output ? _.VkErrorID(8722) : _.VkErrorID(8721))
-                     << "Entry-point has conflicting " << storage_class
-                     << " location assignment at location " << l
-                     << ", component " << c;
-            }
+            result->slots.push_back({4 * l + c, l, c});
           }
         }
       } else {
@@ -476,13 +501,7 @@ spv_result_t GetLocationsForVariable(
           end = location * 4 + component + num_components;
         }
         for (uint32_t l = start; l < end; ++l) {
-          if (!locations->insert(l).second) {
-            return _.diag(SPV_ERROR_INVALID_DATA, entry_point)
-                   << (is_output ? _.VkErrorID(8722) : _.VkErrorID(8721))
-                   << "Entry-point has conflicting " << storage_class
-                   << " location assignment at location " << l / 4
-                   << ", component " << l % 4;
-          }
+          result->slots.push_back({l, l / 4, l % 4});
         }
       }
     }
@@ -492,7 +511,8 @@ spv_result_t GetLocationsForVariable(
 }
 
 spv_result_t ValidateLocations(ValidationState_t& _,
-                               const Instruction* entry_point) {
+                               const Instruction* entry_point,
+                               VariableLocationsCache* cache) {
   // According to Vulkan 14.1 only the following execution models have
   // locations assigned.
   // TODO(dneto): SPV_NV_ray_tracing also uses locations on interface variables,
@@ -509,6 +529,8 @@ spv_result_t ValidateLocations(ValidationState_t& _,
       return SPV_SUCCESS;
   }
 
+  const auto model = entry_point->GetOperandAs<spv::ExecutionModel>(0);
+
   // Locations are stored as a combined location and component values.
   std::unordered_set<uint32_t> input_locations;
   std::unordered_set<uint32_t> output_locations_index0;
@@ -528,12 +550,33 @@ spv_result_t ValidateLocations(ValidationState_t& _,
       continue;
     }
 
+    const uint64_t key =
+        (static_cast<uint64_t>(model) << 32) | interface_id;
+    auto where = cache->find(key);
+    if (where == cache->end()) {
+      VariableLocations computed;
+      if (auto error =
+              ComputeLocationsForVariable(_, model, interface_var, &computed))
+        return error;
+      where = cache->emplace(key, std::move(computed)).first;
+    }
+    const VariableLocations& var_locations = where->second;
+
     auto locations = (storage_class == spv::StorageClass::Input)
                          ? &input_locations
-                         : &output_locations_index0;
-    if (auto error = GetLocationsForVariable(
-            _, entry_point, interface_var, locations, &output_locations_index1))
-      return error;
+                         : var_locations.use_index1 ? &output_locations_index1
+                                                    : &output_locations_index0;
+    for (const auto& slot : var_locations.slots) {
+      if (!locations->insert(slot.index).second) {
+        return _.diag(SPV_ERROR_INVALID_DATA, entry_point)
+               << (var_locations.is_output ? _.VkErrorID(8722)
+                                           : _.VkErrorID(8721))
+               << "Entry-point has conflicting "
+               << (var_locations.is_output ? "output" : "input")
+               << " location assignment at location " << slot.reported_location
+               << ", component " << slot.reported_component;
+      }
+    }
   }
 
   return SPV_SUCCESS;
@@ -543,18 +586,20 @@ spv_result_t ValidateLocations(ValidationState_t& _,
 
 spv_result_t ValidateInterfaces(ValidationState_t& _) {
   bool is_spv_1_4 = _.version() >= SPV_SPIRV_VERSION_WORD(1, 4);
+  EntryPointInterfaceSets interface_sets;
   for (auto& inst : _.ordered_instructions()) {
     if (is_interface_variable(&inst, is_spv_1_4)) {
-      if (auto error = check_interface_variable(_, &inst)) {
+      if (auto error = check_interface_variable(_, &inst, &interface_sets)) {
         return error;
       }
     }
   }
 
   if (spvIsVulkanEnv(_.context()->target_env)) {
+    VariableLocationsCache location_cache;
     for (auto& inst : _.ordered_instructions()) {
       if (inst.opcode() == spv::Op::OpEntryPoint) {
-        if (auto error = ValidateLocations(_, &inst)) {
+        if (auto error = ValidateLocations(_, &inst, &location_cache)) {
           return error;
         }
       }
@@ -14,6 +14,7 @@
 
 #include "source/val/validation_state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stack>
 #include <utility>
@@ -265,19 +266,15 @@ std::vector<uint32_t> ValidationState_t::UnresolvedForwardIds() const {
 }
 
 bool ValidationState_t::IsDefinedId(uint32_t id) const {
-  return all_definitions_.find(id) != std::end(all_definitions_);
+  return id < all_definitions_.size() && all_definitions_[id] != nullptr;
 }
 
 const Instruction* ValidationState_t::FindDef(uint32_t id) const {
-  auto it = all_definitions_.find(id);
-  if (it == all_definitions_.end()) return nullptr;
-  return it->second;
+  return id < all_definitions_.size() ? all_definitions_[id] : nullptr;
 }
 
 Instruction* ValidationState_t::FindDef(uint32_t id) {
-  auto it = all_definitions_.find(id);
-  if (it == all_definitions_.end()) return nullptr;
-  return it->second;
+  return id < all_definitions_.size() ? all_definitions_[id] : nullptr;
 }
 
 ModuleLayoutSection ValidationState_t::current_layout_section() const {
@@ -302,9 +299,17 @@ bool ValidationState_t::IsOpcodeInCurrentLayoutSection(spv::Op op) {
   return IsInstructionInLayoutSection(current_layout_section_, op);
 }
 
+// Where diagnostics produced by the calling thread are buffered during
+// parallel function-body validation.  Null outside of that mode.
+static thread_local std::vector<ValidationState_t::BufferedDiagnostic>*
+    tl_diagnostic_buffer = nullptr;
+
 DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
                                          const Instruction* inst) {
-  if (error_code == SPV_WARNING) {
+  // When validating in parallel, the warning cap is enforced during replay
+  // instead, so that it suppresses the same warnings a single-threaded
+  // validation would have suppressed.
+  if (error_code == SPV_WARNING && !in_parallel_validation_) {
     if (num_of_warnings_ == max_num_of_warnings_) {
       DiagnosticStream({0, 0, 0}, context_->consumer, "", error_code)
           << "Other warnings have been suppressed.\n";
@@ -315,11 +320,81 @@ DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
     ++num_of_warnings_;
   }
 
+  const spv_position_t position = {0, 0, inst ? inst->LineNum() : 0};
+
+  // With no registered consumer every message is dropped, so skip the
+  // disassembly and capture below; the stream still carries the error code.
+  if (context_->consumer == nullptr) {
+    return DiagnosticStream(position, nullptr, "", error_code);
+  }
+
   std::string disassembly;
-  if (inst) disassembly = Disassemble(*inst);
+  if (inst && context_->consumer_needs_text) {
+    if (in_parallel_validation_) {
+      // The name mapper used by Disassemble is shared between threads.
+      std::lock_guard<std::mutex> lock(parallel_diag_mutex_);
+      disassembly = Disassemble(*inst);
+    } else {
+      disassembly = Disassemble(*inst);
+    }
+  }
+
+  if (in_parallel_validation_ && tl_diagnostic_buffer) {
+    // Capture the message into the calling thread's buffer.  It is replayed
+    // deterministically after the worker threads have joined.
+    auto* buffer = tl_diagnostic_buffer;
+    MessageConsumer capture = [buffer](spv_message_level_t level,
+                                       const char* /*source*/,
+                                       const spv_position_t& pos,
+                                       const char* message) {
+      buffer->push_back({level, pos, std::string(message)});
+    };
+    return DiagnosticStream(position, capture, disassembly, error_code,
+                            context_->consumer_needs_text);
+  }
+
+  return DiagnosticStream(position, context_->consumer, disassembly, error_code,
+                          context_->consumer_needs_text);
+}
+
+void ValidationState_t::EnterParallelValidation() {
+  assert(!in_parallel_validation_);
+  in_parallel_validation_ = true;
+}
+
+void ValidationState_t::LeaveParallelValidation() {
+  assert(in_parallel_validation_);
+  in_parallel_validation_ = false;
+}
 
-  return DiagnosticStream({0, 0, inst ? inst->LineNum() : 0},
-                          context_->consumer, disassembly, error_code);
+void ValidationState_t::BeginThreadLocalDiagnostics(
+    std::vector<BufferedDiagnostic>* buffer) {
+  assert(tl_diagnostic_buffer == nullptr);
+  tl_diagnostic_buffer = buffer;
+}
+
+void ValidationState_t::EndThreadLocalDiagnostics() {
+  tl_diagnostic_buffer = nullptr;
+}
+
+void ValidationState_t::ReplayDiagnostics(
+    const std::vector<BufferedDiagnostic>& buffer) {
+  for (const auto& diagnostic : buffer) {
+    if (diagnostic.level == SPV_MSG_WARNING) {
+      if (num_of_warnings_ == max_num_of_warnings_) {
+        DiagnosticStream({0, 0, 0}, context_->consumer, "", SPV_WARNING)
+            << "Other warnings have been suppressed.\n";
+      }
+      if (num_of_warnings_ >= max_num_of_warnings_) {
+        continue;
+      }
+      ++num_of_warnings_;
+    }
+    if (context_->consumer) {
+      context_->consumer(diagnostic.level, "", diagnostic.position,
+                         diagnostic.message.c_str());
+    }
+  }
 }
 
 std::vector<Function>& ValidationState_t::functions() {
@@ -554,7 +629,42 @@ void ValidationState_t::RegisterDebugInstruction(const Instruction* inst) {
 }
 
 void ValidationState_t::RegisterInstruction(Instruction* inst) {
-  if (inst->id()) all_definitions_.insert(std::make_pair(inst->id(), inst));
+  if (inst->id()) {
+    if (inst->id() >= all_definitions_.size()) {
+      // Grow geometrically so that registering ids in increasing order stays
+      // amortized constant time.
+      all_definitions_.resize(std::max<size_t>(inst->id() + 1,
+                                               2 * all_definitions_.size()));
+    }
+    all_definitions_[inst->id()] = inst;
+  }
+
+  // Decode image types once so the image checks can read a flat descriptor
+  // instead of re-unpacking the type operands per instruction.
+  if (inst->opcode() == spv::Op::OpTypeImage) {
+    const size_t num_words = inst->words().size();
+    if (num_words == 9 || num_words == 10) {
+      ImageTypeInfo info;
+      info.sampled_type = inst->word(2);
+      info.dim = static_cast<spv::Dim>(inst->word(3));
+      info.depth = inst->word(4);
+      info.arrayed = inst->word(5);
+      info.multisampled = inst->word(6);
+      info.sampled = inst->word(7);
+      info.format = static_cast<spv::ImageFormat>(inst->word(8));
+      info.access_qualifier =
+          num_words < 10 ? spv::AccessQualifier::Max
+                         : static_cast<spv::AccessQualifier>(inst->word(9));
+      image_type_info_[inst->id()] = info;
+    }
+  } else if (inst->opcode() == spv::Op::OpTypeSampledImage) {
+    // Alias the descriptor of the underlying image type, which the layout
+    // rules require to be declared first.
+    auto iter = image_type_info_.find(inst->word(2));
+    if (iter != image_type_info_.end()) {
+      image_type_info_[inst->id()] = iter->second;
+    }
+  }
 
   // Some validation checks are easier by getting all the consumers
   for (size_t i = 0; i < inst->operands().size(); ++i) {
@@ -593,6 +703,11 @@ void ValidationState_t::RegisterInstruction(Instruction* inst) {
   }
 }
 
+const ImageTypeInfo* ValidationState_t::GetImageTypeInfo(uint32_t id) const {
+  auto iter = image_type_info_.find(id);
+  return iter == image_type_info_.end() ? nullptr : &iter->second;
+}
+
 std::vector<Instruction*> ValidationState_t::getSampledImageConsumers(
     uint32_t sampled_image_id) const {
   std::vector<Instruction*> result;
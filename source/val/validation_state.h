@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
@@ -60,6 +61,19 @@ enum ModuleLayoutSection {
   kLayoutFunctionDefinitions       /// < Section 2.4 #12
 };
 
+/// The operands of an OpTypeImage, decoded once when the type is registered.
+/// See the OpTypeImage spec for more information.
+struct ImageTypeInfo {
+  uint32_t sampled_type = 0;
+  spv::Dim dim = spv::Dim::Max;
+  uint32_t depth = 0;
+  uint32_t arrayed = 0;
+  uint32_t multisampled = 0;
+  uint32_t sampled = 0;
+  spv::ImageFormat format = spv::ImageFormat::Max;
+  spv::AccessQualifier access_qualifier = spv::AccessQualifier::Max;
+};
+
 /// This class manages the state of the SPIR-V validation as it is being parsed.
 class ValidationState_t {
  public:
@@ -192,6 +206,34 @@ class ValidationState_t {
 
   DiagnosticStream diag(spv_result_t error_code, const Instruction* inst);
 
+  /// A diagnostic captured on a worker thread while function bodies are
+  /// validated in parallel.  Buffered diagnostics are replayed through the
+  /// real message consumer once the workers have joined, so the output is
+  /// identical to a front-to-back single-threaded validation.
+  struct BufferedDiagnostic {
+    spv_message_level_t level;
+    spv_position_t position;
+    std::string message;
+  };
+
+  /// Enters or leaves parallel function-body validation.  While in this mode,
+  /// diag() routes messages into the buffer registered by the calling thread
+  /// instead of the message consumer, and the warning cap is applied at
+  /// replay time rather than at capture time.
+  void EnterParallelValidation();
+  void LeaveParallelValidation();
+  bool InParallelValidation() const { return in_parallel_validation_; }
+
+  /// Registers |buffer| as the destination for diagnostics produced by the
+  /// calling thread, until the matching EndThreadLocalDiagnostics() call.
+  void BeginThreadLocalDiagnostics(std::vector<BufferedDiagnostic>* buffer);
+  void EndThreadLocalDiagnostics();
+
+  /// Replays diagnostics captured in |buffer| through the message consumer,
+  /// enforcing the warning cap exactly as diag() would have done had the
+  /// messages been produced on the validation thread.
+  void ReplayDiagnostics(const std::vector<BufferedDiagnostic>& buffer);
+
   /// Returns the function states
   std::vector<Function>& functions();
 
@@ -385,6 +427,13 @@ class ValidationState_t {
   /// definitions and register sampled image consumers.
   void RegisterInstruction(Instruction* inst);
 
+  /// Returns the decoded descriptor of the OpTypeImage with the given result
+  /// id, or of the image type underlying the OpTypeSampledImage with that id.
+  /// Returns nullptr when |id| does not name such a type.  Descriptors are
+  /// decoded once at registration time, so the image checks can consult them
+  /// for thousands of instructions without re-unpacking the type operands.
+  const ImageTypeInfo* GetImageTypeInfo(uint32_t id) const;
+
   /// Registers the debug instruction information.
   void RegisterDebugInstruction(const Instruction* inst);
 
@@ -472,8 +521,9 @@ class ValidationState_t {
     return ordered_instructions_;
   }
 
-  /// Returns a map of instructions mapped by their result id
-  const std::unordered_map<uint32_t, Instruction*>& all_definitions() const {
+  /// Returns the definitions, indexed by result id.  Entries for ids that
+  /// have no definition are null.
+  const std::vector<Instruction*>& all_definitions() const {
     return all_definitions_;
   }
 
@@ -820,6 +870,12 @@ class ValidationState_t {
   std::unordered_map<uint32_t, std::vector<Instruction*>>
       sampled_image_consumers_;
 
+  /// Image type descriptors decoded from OpTypeImage and OpTypeSampledImage
+  /// declarations, indexed by the type's result id.  Filled when the type
+  /// instructions are registered and read-only afterwards, so it is safe to
+  /// consult from parallel function validation.
+  std::unordered_map<uint32_t, ImageTypeInfo> image_type_info_;
+
   /// A map of operand IDs and their names defined by the OpName instruction
   std::unordered_map<uint32_t, std::string> operand_names_;
 
@@ -840,8 +896,10 @@ class ValidationState_t {
   /// List of all instructions in the order they appear in the binary
   std::vector<Instruction> ordered_instructions_;
 
-  /// Instructions that can be referenced by Ids
-  std::unordered_map<uint32_t, Instruction*> all_definitions_;
+  /// Instructions that can be referenced by Ids, indexed by the id.  Result
+  /// ids are dense and bounded by the header's id bound, so a flat array
+  /// with direct indexing beats hashing; entries for undefined ids are null.
+  std::vector<Instruction*> all_definitions_;
 
   /// IDs that are entry points, ie, arguments to OpEntryPoint.
   std::vector<uint32_t> entry_points_;
@@ -876,7 +934,10 @@ class ValidationState_t {
   std::unordered_map<uint32_t, bool>
       struct_has_nested_blockorbufferblock_struct_;
 
-  /// Stores the list of decorations for a given <id>
+  /// Stores the list of decorations for a given <id>.  This stays an ordered
+  /// map rather than an id-indexed array: decorated ids are sparse relative
+  /// to the id bound, and the set references handed out by |id_decorations|
+  /// must remain stable while further decorations are registered.
   std::map<uint32_t, std::set<Decoration>> id_decorations_;
 
   /// Stores type declarations which need to be unique (i.e. non-aggregates),
@@ -945,6 +1006,13 @@ class ValidationState_t {
   /// Variables used to reduce the number of diagnostic messages.
   uint32_t num_of_warnings_;
   uint32_t max_num_of_warnings_;
+
+  /// True while function bodies are being validated on worker threads.
+  bool in_parallel_validation_ = false;
+
+  /// Serializes diagnostic construction on worker threads, since the name
+  /// mapper used for disassembly in messages is shared.
+  std::mutex parallel_diag_mutex_;
 };
 
 }  // namespace val
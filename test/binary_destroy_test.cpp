@@ -40,5 +40,29 @@ TEST_F(BinaryDestroySomething, Default) {
   spvBinaryDestroy(my_binary);
 }
 
+TEST(BinaryViewDestroy, Null) {
+  // Check for the ability to call the API without abnormal termination.
+  spvBinaryViewDestroy(nullptr);
+}
+
+TEST(BinaryView, AliasesCallerWords) {
+  const uint32_t words[] = {0xdeadbeef, 0xcafe};
+  spv_binary view = nullptr;
+  ASSERT_EQ(SPV_SUCCESS, spvBinaryViewCreate(words, 2, &view));
+  ASSERT_NE(nullptr, view);
+  // The view must alias the caller's buffer, not copy it.
+  EXPECT_EQ(words, view->code);
+  EXPECT_EQ(2u, view->wordCount);
+  spvBinaryViewDestroy(view);
+}
+
+TEST(BinaryView, RejectsNullArguments) {
+  const uint32_t words[] = {0u};
+  spv_binary view = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_POINTER, spvBinaryViewCreate(nullptr, 1, &view));
+  EXPECT_EQ(SPV_ERROR_INVALID_POINTER,
+            spvBinaryViewCreate(words, 1, nullptr));
+}
+
 }  // namespace
 }  // namespace spvtools
@@ -834,6 +834,75 @@ TEST_F(CxxBinaryParseTest, ExtendedInstruction) {
   EXPECT_EQ(nullptr, diagnostic_);
 }
 
+TEST_F(BinaryParseTest, ExtendedInstructionInCrossEndianModule) {
+  // Strings are encoded in the word values, so the words of the import name
+  // are byte-swapped along with everything else in a cross-endian module.
+  // The parser must decode "OpenCL.std" from the endian-corrected words;
+  // decoding the raw words garbles the name and rejects the module.
+  const auto words = CompileSuccessfully(
+      "%extcl = OpExtInstImport \"OpenCL.std\" "
+      "%result = OpExtInst %float %extcl sqrt %x");
+  EXPECT_HEADER(5).WillOnce(Return(SPV_SUCCESS));
+  EXPECT_CALL(client_, Instruction(_)).WillOnce(Return(SPV_SUCCESS));
+  // We're only interested in the second call to Instruction():
+  const auto operands = std::vector<spv_parsed_operand_t>{
+      MakeSimpleOperand(1, SPV_OPERAND_TYPE_TYPE_ID),
+      MakeSimpleOperand(2, SPV_OPERAND_TYPE_RESULT_ID),
+      MakeSimpleOperand(3,
+                        SPV_OPERAND_TYPE_ID),  // Extended instruction set Id
+      MakeSimpleOperand(4, SPV_OPERAND_TYPE_EXTENSION_INSTRUCTION_NUMBER),
+      MakeSimpleOperand(5, SPV_OPERAND_TYPE_ID),  // Id of the argument
+  };
+  const auto instruction = MakeInstruction(
+      spv::Op::OpExtInst,
+      {2, 3, 1, static_cast<uint32_t>(OpenCLLIB::Entrypoints::Sqrt), 4});
+  EXPECT_CALL(client_,
+              Instruction(ParsedInstruction(spv_parsed_instruction_t{
+                  instruction.data(), static_cast<uint16_t>(instruction.size()),
+                  uint16_t(spv::Op::OpExtInst), SPV_EXT_INST_TYPE_OPENCL_STD,
+                  2 /*type id*/, 3 /*result id*/, operands.data(),
+                  static_cast<uint16_t>(operands.size())})))
+      .WillOnce(Return(SPV_SUCCESS));
+  Parse(words, SPV_SUCCESS, true);
+  EXPECT_EQ(nullptr, diagnostic_);
+}
+
+TEST_F(BinaryParseTest, CrossEndianModuleRoundTripsLiteralStrings) {
+  // Parsing a cross-endian module containing OpName and OpString must hand
+  // back the original host-endian instruction words, so that
+  // spvDecodeLiteralStringOperand recovers the original strings.
+  const auto name_words = MakeVector("cross-endian name");
+  const auto string_words = MakeVector("cross-endian source");
+  const auto opname = MakeInstruction(spv::Op::OpName, {1}, name_words);
+  const auto opstring = MakeInstruction(spv::Op::OpString, {2}, string_words);
+  const auto words = Concatenate({ExpectedHeaderForBound(3), opname, opstring});
+  InSequence calls_expected_in_specific_order;
+  EXPECT_HEADER(3).WillOnce(Return(SPV_SUCCESS));
+  const auto opname_operands = std::vector<spv_parsed_operand_t>{
+      MakeSimpleOperand(1, SPV_OPERAND_TYPE_ID),
+      MakeLiteralStringOperand(2, static_cast<uint16_t>(name_words.size()))};
+  EXPECT_CALL(client_,
+              Instruction(ParsedInstruction(spv_parsed_instruction_t{
+                  opname.data(), static_cast<uint16_t>(opname.size()),
+                  uint16_t(spv::Op::OpName), SPV_EXT_INST_TYPE_NONE,
+                  0 /*type id*/, 0 /* No result id for OpName*/,
+                  opname_operands.data(),
+                  static_cast<uint16_t>(opname_operands.size())})))
+      .WillOnce(Return(SPV_SUCCESS));
+  const auto opstring_operands = std::vector<spv_parsed_operand_t>{
+      MakeSimpleOperand(1, SPV_OPERAND_TYPE_RESULT_ID),
+      MakeLiteralStringOperand(2, static_cast<uint16_t>(string_words.size()))};
+  EXPECT_CALL(client_,
+              Instruction(ParsedInstruction(spv_parsed_instruction_t{
+                  opstring.data(), static_cast<uint16_t>(opstring.size()),
+                  uint16_t(spv::Op::OpString), SPV_EXT_INST_TYPE_NONE,
+                  0 /*type id*/, 2 /*result id*/, opstring_operands.data(),
+                  static_cast<uint16_t>(opstring_operands.size())})))
+      .WillOnce(Return(SPV_SUCCESS));
+  Parse(words, SPV_SUCCESS, true);
+  EXPECT_EQ(nullptr, diagnostic_);
+}
+
 // A binary parser diagnostic test case where we provide the words array
 // pointer and word count explicitly.
 struct WordsAndCountDiagnosticCase {
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "gmock/gmock.h"
+#include "source/disassemble.h"
 #include "source/spirv_constant.h"
 #include "test/test_fixture.h"
 #include "test/unit_spirv.h"
@@ -112,6 +113,96 @@ TEST_F(BinaryToText, Print) {
   spvTextDestroy(text);
 }
 
+TEST_F(BinaryToText, ReusableContextMatchesSingleShotDisassembly) {
+  const uint32_t options = SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES;
+  spv_text text = nullptr;
+  spv_diagnostic diagnostic = nullptr;
+  ASSERT_EQ(SPV_SUCCESS, spvBinaryToText(context, binary->code,
+                                         binary->wordCount, options, &text,
+                                         &diagnostic));
+  const std::string expected(text->str, text->length);
+  spvTextDestroy(text);
+
+  DisassemblyContext disassembly_context(SPV_ENV_UNIVERSAL_1_0, options);
+  ASSERT_TRUE(disassembly_context.IsValid());
+  std::string actual = "stale text from a previous module";
+  EXPECT_TRUE(
+      disassembly_context.Disassemble(binary->code, binary->wordCount,
+                                      &actual));
+  EXPECT_EQ(expected, actual);
+  // Running a module through the same session again must give the same text.
+  EXPECT_TRUE(
+      disassembly_context.Disassemble(binary->code, binary->wordCount,
+                                      &actual));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST_F(BinaryToText, DisassembleToCallerProvidedSink) {
+  DisassemblyContext disassembly_context(SPV_ENV_UNIVERSAL_1_0,
+                                         SPV_BINARY_TO_TEXT_OPTION_NONE);
+  ASSERT_TRUE(disassembly_context.IsValid());
+  std::string via_string;
+  ASSERT_TRUE(disassembly_context.Disassemble(binary->code, binary->wordCount,
+                                              &via_string));
+
+  // Writing to a stream sink must produce the same text, byte for byte.
+  std::ostringstream sink;
+  EXPECT_TRUE(disassembly_context.Disassemble(
+      binary->code, binary->wordCount, static_cast<std::ostream*>(&sink)));
+  EXPECT_EQ(via_string, sink.str());
+}
+
+TEST_F(BinaryToText, StreamedMatchesBufferedDisassembly) {
+  spv_text text = nullptr;
+  spv_diagnostic diagnostic = nullptr;
+  ASSERT_EQ(
+      SPV_SUCCESS,
+      spvBinaryToText(context, binary->code, binary->wordCount,
+                      SPV_BINARY_TO_TEXT_OPTION_NONE, &text, &diagnostic));
+  const std::string expected(text->str, text->length);
+  spvTextDestroy(text);
+
+  // Concatenating the streamed chunks must reproduce the buffered text,
+  // byte for byte.
+  std::string streamed;
+  auto sink = [](void* user_data, const char* chunk, size_t length) {
+    static_cast<std::string*>(user_data)->append(chunk, length);
+    return SPV_SUCCESS;
+  };
+  EXPECT_EQ(SPV_SUCCESS,
+            spvBinaryToTextStreamed(context, binary->code, binary->wordCount,
+                                    SPV_BINARY_TO_TEXT_OPTION_NONE, sink,
+                                    &streamed, &diagnostic));
+  EXPECT_EQ(expected, streamed);
+}
+
+TEST_F(BinaryToText, StreamedSinkFailureIsReported) {
+  auto sink = [](void*, const char*, size_t) { return SPV_UNSUPPORTED; };
+  spv_diagnostic diagnostic = nullptr;
+  EXPECT_EQ(SPV_UNSUPPORTED,
+            spvBinaryToTextStreamed(context, binary->code, binary->wordCount,
+                                    SPV_BINARY_TO_TEXT_OPTION_NONE, sink,
+                                    nullptr, &diagnostic));
+}
+
+TEST_F(BinaryToText, DisassembleBatchReportsPerModuleResults) {
+  std::vector<std::vector<uint32_t>> binaries(
+      3,
+      std::vector<uint32_t>(binary->code, binary->code + binary->wordCount));
+  // The middle entry is not a SPIR-V module at all.
+  binaries[1].assign(1, 0xdeadbeef);
+
+  DisassemblyContext disassembly_context(SPV_ENV_UNIVERSAL_1_0,
+                                         SPV_BINARY_TO_TEXT_OPTION_NONE);
+  ASSERT_TRUE(disassembly_context.IsValid());
+  std::vector<std::string> texts;
+  EXPECT_FALSE(disassembly_context.DisassembleBatch(binaries, &texts));
+  ASSERT_EQ(3u, texts.size());
+  EXPECT_FALSE(texts[0].empty());
+  EXPECT_TRUE(texts[1].empty());
+  EXPECT_EQ(texts[0], texts[2]);
+}
+
 TEST_F(BinaryToText, MissingModule) {
   spv_text text;
   spv_diagnostic diagnostic = nullptr;
@@ -28,6 +28,21 @@ void SetContextMessageConsumer(spv_context context, MessageConsumer consumer) {
 void SetContextMessageConsumer(spv_context, MessageConsumer) {}
 #endif
 
+// Contexts never build private copies of the grammar tables: every context
+// points at the same constant-initialized tables baked into the binary
+// image, so creating one is a single small allocation.
+TEST(CInterface, ContextsShareStaticGrammarTables) {
+  auto context_a = spvContextCreate(SPV_ENV_UNIVERSAL_1_1);
+  auto context_b = spvContextCreate(SPV_ENV_UNIVERSAL_1_1);
+  ASSERT_NE(nullptr, context_a);
+  ASSERT_NE(nullptr, context_b);
+  EXPECT_EQ(context_a->opcode_table, context_b->opcode_table);
+  EXPECT_EQ(context_a->operand_table, context_b->operand_table);
+  EXPECT_EQ(context_a->ext_inst_table, context_b->ext_inst_table);
+  spvContextDestroy(context_b);
+  spvContextDestroy(context_a);
+}
+
 // The default consumer is a null std::function.
 TEST(CInterface, DefaultConsumerNullDiagnosticForValidInput) {
   auto context = spvContextCreate(SPV_ENV_UNIVERSAL_1_1);
@@ -0,0 +1,139 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "gmock/gmock.h"
+#include "source/table.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace {
+
+constexpr spv_target_env kEnv = SPV_ENV_UNIVERSAL_1_3;
+
+TEST(ContextProfileTest, InvalidEnvironmentFails) {
+  EXPECT_EQ(nullptr,
+            spvContextCreateForProfile(static_cast<spv_target_env>(~0u),
+                                       nullptr, 0, nullptr, 0));
+}
+
+TEST(ContextProfileTest, NullArrayWithNonzeroCountFails) {
+  EXPECT_EQ(nullptr, spvContextCreateForProfile(kEnv, nullptr, 1, nullptr, 0));
+  EXPECT_EQ(nullptr, spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 1));
+}
+
+TEST(ContextProfileTest, SubsetIsSmallerThanFullGrammar) {
+  spv_context full = spvContextCreate(kEnv);
+  spv_context profile =
+      spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  ASSERT_NE(nullptr, profile);
+  EXPECT_GT(profile->opcode_table->count, 0u);
+  EXPECT_LT(profile->opcode_table->count, full->opcode_table->count);
+  // Subsetting drops entries, never whole operand-type groups.
+  EXPECT_EQ(profile->operand_table->count, full->operand_table->count);
+  spvContextDestroy(profile);
+  spvContextDestroy(full);
+}
+
+TEST(ContextProfileTest, CoreOpcodeIsStillFound) {
+  spv_context profile =
+      spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  ASSERT_NE(nullptr, profile);
+  spv_opcode_desc entry = nullptr;
+  EXPECT_EQ(SPV_SUCCESS,
+            spvOpcodeTableValueLookup(kEnv, profile->opcode_table,
+                                      spv::Op::OpIAdd, &entry));
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(spv::Op::OpIAdd, entry->opcode);
+  EXPECT_EQ(SPV_SUCCESS, spvOpcodeTableNameLookup(kEnv, profile->opcode_table,
+                                                  "IAdd", &entry));
+  spvContextDestroy(profile);
+}
+
+TEST(ContextProfileTest, CapabilityGatedOpcodeFollowsProfile) {
+  // OpTypeMatrix requires the Matrix capability.
+  spv_context without =
+      spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  spv_opcode_desc entry = nullptr;
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOpcodeTableValueLookup(kEnv, without->opcode_table,
+                                      spv::Op::OpTypeMatrix, &entry));
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOpcodeTableNameLookup(kEnv, without->opcode_table, "TypeMatrix",
+                                     &entry));
+  spvContextDestroy(without);
+
+  const uint32_t caps[] = {static_cast<uint32_t>(spv::Capability::Matrix)};
+  spv_context with = spvContextCreateForProfile(kEnv, caps, 1, nullptr, 0);
+  EXPECT_EQ(SPV_SUCCESS,
+            spvOpcodeTableValueLookup(kEnv, with->opcode_table,
+                                      spv::Op::OpTypeMatrix, &entry));
+  spvContextDestroy(with);
+}
+
+TEST(ContextProfileTest, CapabilityGatedOperandFollowsProfile) {
+  // The Output storage class requires the Shader capability;
+  // UniformConstant is available unconditionally.
+  spv_context without =
+      spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  spv_operand_desc entry = nullptr;
+  EXPECT_EQ(SPV_SUCCESS,
+            spvOperandTableValueLookup(
+                kEnv, without->operand_table, SPV_OPERAND_TYPE_STORAGE_CLASS,
+                uint32_t(spv::StorageClass::UniformConstant), &entry));
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableValueLookup(
+                kEnv, without->operand_table, SPV_OPERAND_TYPE_STORAGE_CLASS,
+                uint32_t(spv::StorageClass::Output), &entry));
+  spvContextDestroy(without);
+
+  const uint32_t caps[] = {static_cast<uint32_t>(spv::Capability::Shader)};
+  spv_context with = spvContextCreateForProfile(kEnv, caps, 1, nullptr, 0);
+  EXPECT_EQ(SPV_SUCCESS,
+            spvOperandTableValueLookup(
+                kEnv, with->operand_table, SPV_OPERAND_TYPE_STORAGE_CLASS,
+                uint32_t(spv::StorageClass::Output), &entry));
+  EXPECT_EQ(SPV_SUCCESS, spvOperandTableNameLookup(
+                             kEnv, with->operand_table,
+                             SPV_OPERAND_TYPE_STORAGE_CLASS, "Output",
+                             strlen("Output"), &entry));
+  spvContextDestroy(with);
+}
+
+TEST(ContextProfileTest, SameProfileSharesTables) {
+  spv_context first = spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  spv_context second =
+      spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  EXPECT_EQ(first->opcode_table, second->opcode_table);
+  EXPECT_EQ(first->operand_table, second->operand_table);
+  spvContextDestroy(second);
+  spvContextDestroy(first);
+}
+
+TEST(ContextProfileTest, UnknownExtensionIsIgnored) {
+  const char* extensions[] = {"SPV_EXAMPLE_not_a_real_extension"};
+  spv_context with_unknown =
+      spvContextCreateForProfile(kEnv, nullptr, 0, extensions, 1);
+  ASSERT_NE(nullptr, with_unknown);
+  // An unknown extension cannot enable anything, so the profile is the same
+  // as one without it and shares its cached tables.
+  spv_context plain = spvContextCreateForProfile(kEnv, nullptr, 0, nullptr, 0);
+  EXPECT_EQ(plain->opcode_table, with_unknown->opcode_table);
+  spvContextDestroy(plain);
+  spvContextDestroy(with_unknown);
+}
+
+}  // namespace
+}  // namespace spvtools
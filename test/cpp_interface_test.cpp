@@ -12,12 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdio>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "source/spirv_constant.h"
 #include "spirv-tools/optimizer.hpp"
 #include "spirv/unified1/spirv.hpp11"
 
@@ -222,6 +224,212 @@ TEST(CppInterface, ValidateWithOptionsFail) {
           "Number of OpTypeStruct members (10) has exceeded the limit (9)"));
 }
 
+TEST(CppInterface, ValidationCachePersistsAcrossInstances) {
+  const std::string cache_path =
+      ::testing::TempDir() + "/spirv_tools_validation_cache_persist";
+  std::remove(cache_path.c_str());
+
+  std::vector<uint32_t> binary;
+  {
+    SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+    EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+    EXPECT_TRUE(t.EnableValidationCache(cache_path));
+    EXPECT_TRUE(t.Validate(binary));
+  }
+  {
+    // A fresh instance reading the same cache file must agree.
+    SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+    EXPECT_TRUE(t.EnableValidationCache(cache_path));
+    EXPECT_TRUE(t.Validate(binary));
+  }
+  std::remove(cache_path.c_str());
+}
+
+TEST(CppInterface, ValidationCacheDoesNotCacheFailures) {
+  const std::string cache_path =
+      ::testing::TempDir() + "/spirv_tools_validation_cache_failures";
+  std::remove(cache_path.c_str());
+
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  int invocation_count = 0;
+  t.SetMessageConsumer([&invocation_count](spv_message_level_t, const char*,
+                                           const spv_position_t&, const char*) {
+    ++invocation_count;
+  });
+  EXPECT_TRUE(t.EnableValidationCache(cache_path));
+
+  ValidatorOptions opts;
+  opts.SetUniversalLimit(spv_validator_limit_max_struct_members, 9);
+  // Failing results are re-validated every time and re-report diagnostics.
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), opts));
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), opts));
+  EXPECT_EQ(2, invocation_count);
+  std::remove(cache_path.c_str());
+}
+
+TEST(CppInterface, ValidationCacheKeyedOnOptions) {
+  const std::string cache_path =
+      ::testing::TempDir() + "/spirv_tools_validation_cache_options";
+  std::remove(cache_path.c_str());
+
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  EXPECT_TRUE(t.EnableValidationCache(cache_path));
+
+  // Cache a success under the default limits, then check that a stricter
+  // limit still fails: the differing options must not hit the cached entry.
+  EXPECT_TRUE(t.Validate(binary.data(), binary.size(), ValidatorOptions()));
+  ValidatorOptions strict;
+  strict.SetUniversalLimit(spv_validator_limit_max_struct_members, 9);
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), strict));
+  std::remove(cache_path.c_str());
+}
+
+TEST(CppInterface, InMemoryValidationCache) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  t.EnableInMemoryValidationCache(16);
+
+  // Repeated validations of the same words agree; the second one is served
+  // from the cache.
+  EXPECT_TRUE(t.Validate(binary));
+  EXPECT_TRUE(t.Validate(binary));
+
+  // Failing results are not cached: the same module under stricter options
+  // fails every time and re-reports its diagnostic.
+  int invocation_count = 0;
+  t.SetMessageConsumer([&invocation_count](spv_message_level_t, const char*,
+                                           const spv_position_t&, const char*) {
+    ++invocation_count;
+  });
+  ValidatorOptions strict;
+  strict.SetUniversalLimit(spv_validator_limit_max_struct_members, 9);
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), strict));
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), strict));
+  EXPECT_EQ(2, invocation_count);
+}
+
+TEST(CppInterface, ContentHashIgnoresGeneratorAndBound) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(Header(), &binary));
+
+  const uint64_t hash = SpirvTools::ComputeContentHash(binary);
+  EXPECT_NE(0u, hash);
+
+  // Rewriting the generator and bound header words does not change the key.
+  std::vector<uint32_t> relabeled = binary;
+  relabeled[SPV_INDEX_GENERATOR_NUMBER] ^= 0xdeadbeef;
+  relabeled[SPV_INDEX_BOUND] += 100;
+  EXPECT_EQ(hash, SpirvTools::ComputeContentHash(relabeled));
+
+  // Changing an instruction word does.
+  std::vector<uint32_t> modified = binary;
+  modified.back() ^= 1;
+  EXPECT_NE(hash, SpirvTools::ComputeContentHash(modified));
+
+  // A buffer shorter than a module header has no content to hash.
+  EXPECT_EQ(0u, SpirvTools::ComputeContentHash(binary.data(), 4));
+}
+
+TEST(CppInterface, StructuralEquivalenceIgnoresIdsAndNames) {
+  const std::string renamed = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpName %7 "main"
+%1 = OpTypeVoid
+%3 = OpTypeFunction %1
+%7 = OpFunction %1 None %3
+%9 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  const std::string stripped = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%2 = OpTypeVoid
+%4 = OpTypeFunction %2
+%6 = OpFunction %2 None %4
+%8 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> renamed_binary;
+  std::vector<uint32_t> stripped_binary;
+  ASSERT_TRUE(t.Assemble(renamed, &renamed_binary,
+                         SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS));
+  ASSERT_TRUE(t.Assemble(stripped, &stripped_binary,
+                         SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS));
+
+  // Different id numbering and a dropped OpName are not semantic changes.
+  EXPECT_TRUE(t.AreStructurallyEquivalent(renamed_binary, renamed_binary));
+  EXPECT_TRUE(t.AreStructurallyEquivalent(renamed_binary, stripped_binary));
+
+  // Changing an instruction is.
+  std::vector<uint32_t> modified;
+  const std::string unreachable =
+      stripped.substr(0, stripped.find("OpReturn")) +
+      "OpUnreachable\nOpFunctionEnd\n";
+  ASSERT_TRUE(t.Assemble(unreachable, &modified,
+                         SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS));
+  EXPECT_FALSE(t.AreStructurallyEquivalent(stripped_binary, modified));
+
+  // A truncated module cannot be compared.
+  EXPECT_FALSE(t.AreStructurallyEquivalent(
+      stripped_binary.data(), 4, stripped_binary.data(),
+      stripped_binary.size()));
+}
+
+TEST(CppInterface, SpecializationPlanPatchesScalarConstants) {
+  const std::string input = R"(OpCapability Shader
+OpCapability Int64
+OpMemoryModel Logical GLSL450
+OpDecorate %flag SpecId 0
+OpDecorate %count SpecId 1
+OpDecorate %mask SpecId 2
+%bool = OpTypeBool
+%u32 = OpTypeInt 32 0
+%u64 = OpTypeInt 64 0
+%flag = OpSpecConstantTrue %bool
+%count = OpSpecConstant %u32 4
+%mask = OpSpecConstant %u64 1
+)";
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(t.Assemble(input, &binary));
+
+  SpecializationPlan plan;
+  ASSERT_TRUE(plan.Analyze(binary));
+  EXPECT_EQ(3u, plan.NumSpecConstants());
+  EXPECT_TRUE(plan.HasSpecId(0));
+  EXPECT_TRUE(plan.HasSpecId(2));
+  EXPECT_FALSE(plan.HasSpecId(3));
+
+  // Flip the boolean, change the count, and widen the mask.  SpecId 99 has
+  // no constant in the module and is silently ignored.
+  std::vector<uint32_t> specialized = binary;
+  EXPECT_TRUE(plan.Specialize(
+      &specialized,
+      {{0, 0}, {1, 42}, {2, 0x100000002ull}, {99, 7}}));
+
+  std::string disassembly;
+  ASSERT_TRUE(t.Disassemble(specialized, &disassembly));
+  EXPECT_NE(std::string::npos,
+            disassembly.find("OpSpecConstantFalse %bool"));
+  EXPECT_NE(std::string::npos, disassembly.find("OpSpecConstant %uint 42"));
+  EXPECT_NE(std::string::npos,
+            disassembly.find("OpSpecConstant %ulong 4294967298"));
+
+  // A binary of the wrong size cannot have come from this plan.
+  std::vector<uint32_t> truncated(binary.begin(), binary.end() - 1);
+  EXPECT_FALSE(plan.Specialize(&truncated, {{1, 1}}));
+}
+
 // Checks that after running the given optimizer |opt| on the given |original|
 // source code, we can get the given |optimized| source code.
 void CheckOptimization(const std::string& original,
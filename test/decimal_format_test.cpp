@@ -0,0 +1,97 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "source/util/decimal_format.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+std::string FormattedUnsigned(uint64_t value) {
+  char buffer[kMaxDecimalChars];
+  return std::string(buffer, FormatDecimal(value, buffer));
+}
+
+std::string FormattedSigned(int64_t value) {
+  char buffer[kMaxDecimalChars];
+  return std::string(buffer, FormatDecimal(value, buffer));
+}
+
+std::string FormattedFloat(double value, int precision) {
+  char buffer[kMaxDecimalChars];
+  return std::string(buffer, FormatGeneralFloat(value, precision, buffer));
+}
+
+// The stream output the formatters must reproduce byte for byte.
+std::string StreamedFloat(double value, int precision) {
+  std::ostringstream out;
+  out.precision(precision);
+  out << value;
+  return out.str();
+}
+
+TEST(DecimalFormat, UnsignedMatchesToString) {
+  const uint64_t cases[] = {0,
+                            1,
+                            9,
+                            10,
+                            99,
+                            100,
+                            101,
+                            999,
+                            1000,
+                            12345,
+                            4294967295u,
+                            4294967296u,
+                            std::numeric_limits<uint64_t>::max()};
+  for (uint64_t value : cases) {
+    EXPECT_EQ(std::to_string(value), FormattedUnsigned(value)) << value;
+  }
+}
+
+TEST(DecimalFormat, SignedMatchesToString) {
+  const int64_t cases[] = {0,
+                           1,
+                           -1,
+                           -9,
+                           -10,
+                           -100,
+                           2147483647,
+                           -2147483647 - 1,
+                           std::numeric_limits<int64_t>::min(),
+                           std::numeric_limits<int64_t>::max()};
+  for (int64_t value : cases) {
+    EXPECT_EQ(std::to_string(value), FormattedSigned(value)) << value;
+  }
+}
+
+TEST(DecimalFormat, GeneralFloatMatchesStreamOutput) {
+  const double cases[] = {0.0,    -0.0,  0.5,       -0.5,   1.0,
+                          0.1,    1.0 / 3.0,        1e30,   -1e30,
+                          1e-30,  1e8,   1e9,       1e-5,   123456.789,
+                          3.14159265358979};
+  for (double value : cases) {
+    EXPECT_EQ(StreamedFloat(value, 9), FormattedFloat(value, 9)) << value;
+    EXPECT_EQ(StreamedFloat(value, 17), FormattedFloat(value, 17)) << value;
+  }
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
@@ -124,6 +124,29 @@ TEST(DiagnosticStream, MoveConstructorCanBeDirectlyShiftedTo) {
   EXPECT_THAT(messages.str(), Eq("FirstSecond"));
 }
 
+TEST(DiagnosticStream, TextFreeConsumerIsInvokedWithoutFormattedText) {
+  int message_count = 0;
+  std::string last_message = "sentinel";
+  auto consumer = [&message_count, &last_message](spv_message_level_t,
+                                                  const char*,
+                                                  const spv_position_t&,
+                                                  const char* msg) {
+    message_count++;
+    last_message = msg;
+  };
+
+  // Enclose the DiagnosticStream variable in a scope to force destruction.
+  {
+    DiagnosticStream ds0({}, consumer, "disassembly", SPV_ERROR_INVALID_BINARY,
+                         /* consumer_needs_text = */ false);
+    ds0 << "First";
+  }
+  // The consumer is still invoked once per message, but the streamed values
+  // and the disassembly are dropped without being formatted.
+  EXPECT_THAT(message_count, Eq(1));
+  EXPECT_THAT(last_message, Eq(""));
+}
+
 TEST(DiagnosticStream, DiagnosticFromLambdaReturnCanStillBeUsed) {
   std::ostringstream messages;
   int message_count = 0;
@@ -287,5 +287,40 @@ INSTANTIATE_TEST_SUITE_P(
           static_cast<spv::Capability>(0x7fffffff)}},
     }));
 
+TEST(CapabilitySetAddAll, MergesMaskAndOverflowMembers) {
+  CapabilitySet set{spv::Capability::Matrix,
+                    static_cast<spv::Capability>(100)};
+  const CapabilitySet other{spv::Capability::Shader,
+                            static_cast<spv::Capability>(200)};
+  set.AddAll(other);
+  EXPECT_THAT(ElementsIn(set),
+              Eq(std::vector<spv::Capability>{
+                  spv::Capability::Matrix, spv::Capability::Shader,
+                  static_cast<spv::Capability>(100),
+                  static_cast<spv::Capability>(200)}));
+
+  // Adding an empty set changes nothing.
+  const CapabilitySet before = set;
+  set.AddAll(CapabilitySet());
+  EXPECT_TRUE(set == before);
+}
+
+TEST(CapabilitySetIntersectWith, KeepsOnlyCommonMembers) {
+  CapabilitySet set{spv::Capability::Matrix, spv::Capability::Shader,
+                    static_cast<spv::Capability>(100),
+                    static_cast<spv::Capability>(200)};
+  set.IntersectWith(CapabilitySet{spv::Capability::Shader,
+                                  static_cast<spv::Capability>(200),
+                                  static_cast<spv::Capability>(300)});
+  EXPECT_THAT(ElementsIn(set),
+              Eq(std::vector<spv::Capability>{
+                  spv::Capability::Shader,
+                  static_cast<spv::Capability>(200)}));
+
+  set.IntersectWith(CapabilitySet());
+  EXPECT_TRUE(set.IsEmpty());
+  EXPECT_TRUE(set == CapabilitySet());
+}
+
 }  // namespace
 }  // namespace spvtools
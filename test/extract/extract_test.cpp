@@ -0,0 +1,126 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spirv-tools/extract.hpp"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+constexpr spv_target_env kEnv = SPV_ENV_UNIVERSAL_1_3;
+
+// Two compute entry points.  "bar" loads a built-in input variable that
+// "foo" never touches; %uint_7 is referenced by nothing at all.
+const char* kTwoEntryPoints = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %foo "foo"
+OpEntryPoint GLCompute %bar "bar" %bvar
+OpExecutionMode %foo LocalSize 1 1 1
+OpExecutionMode %bar LocalSize 2 2 2
+OpName %bvar "bvar"
+OpDecorate %bvar BuiltIn GlobalInvocationId
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%v3uint = OpTypeVector %uint 3
+%ptr = OpTypePointer Input %v3uint
+%bvar = OpVariable %ptr Input
+%uint_7 = OpConstant %uint 7
+%foo = OpFunction %void None %fnty
+%fe = OpLabel
+OpReturn
+OpFunctionEnd
+%bar = OpFunction %void None %fnty
+%be = OpLabel
+%ld = OpLoad %v3uint %bvar
+OpReturn
+OpFunctionEnd
+)";
+
+std::vector<uint32_t> Assemble(const std::string& text) {
+  SpirvTools tools(kEnv);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+  return binary;
+}
+
+std::string Disassemble(const std::vector<uint32_t>& binary) {
+  SpirvTools tools(kEnv);
+  std::string text;
+  EXPECT_TRUE(tools.Disassemble(binary, &text,
+                                SPV_BINARY_TO_TEXT_OPTION_NO_HEADER));
+  return text;
+}
+
+TEST(ExtractTest, DropsOtherEntryPointAndItsGlobals) {
+  const std::vector<uint32_t> binary = Assemble(kTwoEntryPoints);
+  std::vector<uint32_t> extracted;
+  Context context(kEnv);
+  ASSERT_EQ(SPV_SUCCESS, Extract(context, binary, "foo", &extracted));
+
+  SpirvTools tools(kEnv);
+  EXPECT_TRUE(tools.Validate(extracted));
+
+  const std::string text = Disassemble(extracted);
+  EXPECT_THAT(text, HasSubstr("\"foo\""));
+  EXPECT_THAT(text, HasSubstr("LocalSize 1 1 1"));
+  EXPECT_THAT(text, Not(HasSubstr("\"bar\"")));
+  EXPECT_THAT(text, Not(HasSubstr("LocalSize 2 2 2")));
+  // bar's input variable goes away along with its name, decoration, and the
+  // types and constants nothing references anymore.
+  EXPECT_THAT(text, Not(HasSubstr("OpVariable")));
+  EXPECT_THAT(text, Not(HasSubstr("GlobalInvocationId")));
+  EXPECT_THAT(text, Not(HasSubstr("bvar")));
+  EXPECT_THAT(text, Not(HasSubstr("OpConstant")));
+  EXPECT_THAT(text, Not(HasSubstr("OpTypeVector")));
+}
+
+TEST(ExtractTest, KeepsGlobalsOfKeptEntryPoint) {
+  const std::vector<uint32_t> binary = Assemble(kTwoEntryPoints);
+  std::vector<uint32_t> extracted;
+  Context context(kEnv);
+  ASSERT_EQ(SPV_SUCCESS, Extract(context, binary, "bar", &extracted));
+
+  SpirvTools tools(kEnv);
+  EXPECT_TRUE(tools.Validate(extracted));
+
+  const std::string text = Disassemble(extracted);
+  EXPECT_THAT(text, HasSubstr("\"bar\""));
+  EXPECT_THAT(text, HasSubstr("LocalSize 2 2 2"));
+  EXPECT_THAT(text, HasSubstr("OpVariable"));
+  EXPECT_THAT(text, HasSubstr("GlobalInvocationId"));
+  EXPECT_THAT(text, Not(HasSubstr("\"foo\"")));
+  // The constant is unused by both entry points.
+  EXPECT_THAT(text, Not(HasSubstr("OpConstant %uint 7")));
+}
+
+TEST(ExtractTest, UnknownEntryPointIsAnError) {
+  const std::vector<uint32_t> binary = Assemble(kTwoEntryPoints);
+  std::vector<uint32_t> extracted;
+  Context context(kEnv);
+  EXPECT_EQ(SPV_ERROR_INVALID_VALUE,
+            Extract(context, binary, "baz", &extracted));
+  EXPECT_TRUE(extracted.empty());
+}
+
+}  // namespace
+}  // namespace spvtools
@@ -1721,6 +1721,25 @@ void RunFuzzerAndReplayer(const std::string& shader,
     ASSERT_EQ(fuzzer_transformations_string, replayer_transformations_string);
     ASSERT_TRUE(IsEqual(env, transformed_binary,
                         replayer_result.transformed_module.get()));
+
+    // The staged replay engine, which validates snapshots of the module once
+    // per stage on worker threads, must arrive at exactly the same module and
+    // applied sequence as the classic engine.
+    auto staged_replayer_result =
+        Replayer(env, kConsoleMessageConsumer, binary_in, initial_facts,
+                 fuzzer.GetTransformationSequence(),
+                 static_cast<uint32_t>(
+                     fuzzer.GetTransformationSequence().transformation_size()),
+                 true, validator_options)
+            .RunStaged(33);
+    ASSERT_EQ(Replayer::ReplayerResultStatus::kComplete,
+              staged_replayer_result.status);
+    std::string staged_transformations_string;
+    staged_replayer_result.applied_transformations.SerializeToString(
+        &staged_transformations_string);
+    ASSERT_EQ(fuzzer_transformations_string, staged_transformations_string);
+    ASSERT_TRUE(IsEqual(env, transformed_binary,
+                        staged_replayer_result.transformed_module.get()));
   }
 }
 
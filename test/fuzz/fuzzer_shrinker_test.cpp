@@ -983,6 +983,10 @@ class InterestingThenRandom : public InterestingnessTest {
 //
 // The |validator_options| parameter provides validator options that should be
 // used during shrinking.
+//
+// The |num_threads| parameter controls how many chunk removals the shrinker
+// speculates on in parallel; the interestingness function must be safe to
+// invoke concurrently when it is larger than 1.
 void RunAndCheckShrinker(
     const spv_target_env& target_env, const std::vector<uint32_t>& binary_in,
     const protobufs::FactSequence& initial_facts,
@@ -990,12 +994,12 @@ void RunAndCheckShrinker(
     const Shrinker::InterestingnessFunction& interestingness_function,
     const std::vector<uint32_t>& expected_binary_out,
     uint32_t expected_transformations_out_size, uint32_t step_limit,
-    spv_validator_options validator_options) {
+    spv_validator_options validator_options, uint32_t num_threads = 1) {
   // Run the shrinker.
   auto shrinker_result =
       Shrinker(target_env, kConsoleMessageConsumer, binary_in, initial_facts,
                transformation_sequence_in, interestingness_function, step_limit,
-               false, validator_options)
+               false, validator_options, num_threads)
           .Run();
 
   ASSERT_TRUE(Shrinker::ShrinkerResultStatus::kComplete ==
@@ -1086,6 +1090,13 @@ void RunFuzzerAndShrinker(const std::string& shader,
                       AlwaysInteresting().AsFunction(), binary_in, 0,
                       kReasonableStepLimit, validator_options);
 
+  // Parallel speculation should reach the same fully-shrunk result:
+  // AlwaysInteresting accepts every removal, so every batch merges cleanly.
+  RunAndCheckShrinker(env, binary_in, initial_facts,
+                      fuzzer.GetTransformationSequence(),
+                      AlwaysInteresting().AsFunction(), binary_in, 0,
+                      kReasonableStepLimit, validator_options, 4);
+
   // With the OnlyInterestingFirstTime test, no shrinking should be achieved.
   RunAndCheckShrinker(
       env, binary_in, initial_facts, fuzzer.GetTransformationSequence(),
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test/link/linker_fixture.h"
+
+namespace spvtools {
+namespace {
+
+using ::testing::HasSubstr;
+using ParallelLink = spvtest::LinkerTest;
+
+std::vector<std::string> MakeExporterAndImporters() {
+  const std::string exporter = R"(
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %1 LinkageAttributes "foo" Export
+%2 = OpTypeFloat 32
+%1 = OpVariable %2 Uniform
+)";
+  const std::string importer = R"(
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %1 LinkageAttributes "foo" Import
+%2 = OpTypeFloat 32
+%1 = OpVariable %2 Uniform
+)";
+  return {exporter, importer, importer, importer};
+}
+
+TEST_F(ParallelLink, ProducesSameBinaryAsSerialLink) {
+  const std::vector<std::string> bodies = MakeExporterAndImporters();
+
+  spvtest::Binary serial_binary;
+  LinkerOptions serial_options;
+  ASSERT_EQ(SPV_SUCCESS, AssembleAndLink(bodies, &serial_binary,
+                                         serial_options))
+      << GetErrorMessage();
+
+  spvtest::Binary parallel_binary;
+  LinkerOptions parallel_options;
+  parallel_options.SetParallelism(4u);
+  ASSERT_EQ(SPV_SUCCESS, AssembleAndLink(bodies, &parallel_binary,
+                                         parallel_options))
+      << GetErrorMessage();
+
+  EXPECT_EQ(serial_binary, parallel_binary);
+}
+
+TEST_F(ParallelLink, ReportsUnparsableModuleDeterministically) {
+  std::vector<std::string> bodies = MakeExporterAndImporters();
+  spvtest::Binaries binaries(bodies.size());
+  for (size_t i = 0u; i < bodies.size(); ++i) {
+    ASSERT_TRUE(
+        spvtools::SpirvTools(SPV_ENV_UNIVERSAL_1_2)
+            .Assemble(bodies[i], &binaries[i]));
+  }
+  // Corrupt the third module past its header, so parsing fails.
+  binaries[2].resize(6u);
+  binaries[2][5] = 0xffffffffu;
+
+  spvtest::Binary linked_binary;
+  LinkerOptions options;
+  options.SetParallelism(4u);
+  spvtools::Context context(SPV_ENV_UNIVERSAL_1_2);
+  std::string message;
+  context.SetMessageConsumer([&message](spv_message_level_t, const char*,
+                                        const spv_position_t&, const char* m) {
+    if (!message.empty()) message += "\n";
+    message += m;
+  });
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY,
+            spvtools::Link(context, binaries, &linked_binary, options));
+  EXPECT_THAT(message, HasSubstr("Failed to build module 3 out of 4."));
+}
+
+}  // namespace
+}  // namespace spvtools
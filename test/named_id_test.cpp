@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,41 @@ TEST_F(NamedIdTest, Default) {
   EXPECT_EQ(output, EncodeAndDecodeSuccessfully(input));
 }
 
+TEST_F(NamedIdTest, ManyDistinctNames) {
+  // Use enough distinct names to force the assembler's name table to grow,
+  // and re-reference an early name afterwards.
+  std::ostringstream input;
+  std::ostringstream expected;
+  input << "%voidt = OpTypeVoid\n";
+  expected << "%1 = OpTypeVoid\n";
+  for (int i = 0; i < 200; i++) {
+    input << "%fn_" << i << " = OpTypeFunction %voidt\n";
+    expected << "%" << i + 2 << " = OpTypeFunction %1\n";
+  }
+  input << "%fn_last = OpTypeFunction %voidt\n";
+  expected << "%202 = OpTypeFunction %1\n";
+  EXPECT_EQ(expected.str(), EncodeAndDecodeSuccessfully(input.str()));
+}
+
+TEST_F(NamedIdTest, NumeralNamesStayDistinctFromOtherNames) {
+  // Canonical decimal numerals resolve through a fast path in the
+  // assembler; names that merely look numeric (leading zeros, values past
+  // the maximum id bound) do not.  All of them must behave as ordinary
+  // distinct names.
+  const std::string input = R"(
+%5 = OpTypeVoid
+%05 = OpTypeFunction %5
+%9999999 = OpTypeFunction %5
+%fn = OpTypeFunction %05
+)";
+  const std::string output =
+      "%1 = OpTypeVoid\n"
+      "%2 = OpTypeFunction %1\n"
+      "%3 = OpTypeFunction %1\n"
+      "%4 = OpTypeFunction %2\n";
+  EXPECT_EQ(output, EncodeAndDecodeSuccessfully(input));
+}
+
 struct IdCheckCase {
   std::string id;
   bool valid;
@@ -0,0 +1,136 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using AnalysisMetadataTest = PassTest<::testing::Test>;
+
+// A compute shader with one counted loop, so both a dominator tree record
+// and a loop record get embedded.
+const char kLoopShaderBody[] = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%void_fn = OpTypeFunction %void
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpBranch %header
+%header = OpLabel
+%i = OpPhi %int %int_0 %entry %next_i %continue
+%cmp = OpSLessThan %bool %i %int_10
+OpLoopMerge %merge %continue None
+OpBranchConditional %cmp %body %merge
+%body = OpLabel
+OpBranch %continue
+%continue = OpLabel
+%next_i = OpIAdd %int %i %int_1
+OpBranch %header
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+// Returns the number of metadata instructions in |context|.
+int CountMetadataRecords(IRContext* context) {
+  const uint32_t set_id =
+      context->module()->GetExtInstImportId(kAnalysisMetadataSetName);
+  if (set_id == 0) return 0;
+  int count = 0;
+  context->module()->ForEachInst([set_id, &count](Instruction* inst) {
+    if (inst->opcode() == spv::Op::OpExtInst &&
+        inst->GetSingleWordInOperand(0) == set_id) {
+      ++count;
+    }
+  });
+  return count;
+}
+
+TEST_F(AnalysisMetadataTest, EmbedsDominatorTreeAndLoops) {
+  const std::string text = std::string(R"(
+; CHECK: OpExtension "SPV_KHR_non_semantic_info"
+; CHECK: [[set:%\w+]] = OpExtInstImport "NonSemantic.SPIRV-Tools.Analysis
+; CHECK: OpExtInst %void [[set]] 1
+; CHECK: OpExtInst %void [[set]] 2
+)") + kLoopShaderBody;
+
+  SinglePassRunAndMatch<EmbedAnalysisMetadataPass>(text, true);
+}
+
+TEST_F(AnalysisMetadataTest, RoundTripRehydratesDominatorTrees) {
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kLoopShaderBody,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  EmbedAnalysisMetadataPass pass;
+  pass.Run(context.get());
+
+  std::vector<uint32_t> binary;
+  context->module()->ToBinary(&binary, /* skip_nop = */ false);
+  std::unique_ptr<IRContext> loaded = BuildModule(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_TRUE(loaded->LoadEmbeddedAnalysisMetadata(/* verify = */ true));
+
+  // The rehydrated trees must agree with freshly computed ones.
+  std::unique_ptr<IRContext> recomputed = BuildModule(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, recomputed);
+  for (Function& function : *loaded->module()) {
+    Function* reference = recomputed->GetFunction(function.result_id());
+    ASSERT_NE(nullptr, reference);
+    DominatorAnalysis* actual = loaded->GetDominatorAnalysis(&function);
+    DominatorAnalysis* expected = recomputed->GetDominatorAnalysis(reference);
+    for (BasicBlock& block : function) {
+      BasicBlock* actual_idom = actual->ImmediateDominator(block.id());
+      BasicBlock* expected_idom = expected->ImmediateDominator(block.id());
+      EXPECT_EQ(expected_idom == nullptr ? 0 : expected_idom->id(),
+                actual_idom == nullptr ? 0 : actual_idom->id())
+          << "immediate dominator mismatch for block " << block.id();
+    }
+  }
+}
+
+TEST_F(AnalysisMetadataTest, ReplacesEarlierMetadata) {
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kLoopShaderBody,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+
+  EmbedAnalysisMetadataPass pass;
+  pass.Run(context.get());
+  EXPECT_EQ(2, CountMetadataRecords(context.get()));
+
+  // A second run replaces the records instead of accumulating them.
+  EmbedAnalysisMetadataPass second_pass;
+  second_pass.Run(context.get());
+  EXPECT_EQ(2, CountMetadataRecords(context.get()));
+}
+
+}  // namespace opt
+}  // namespace spvtools
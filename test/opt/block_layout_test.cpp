@@ -0,0 +1,210 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using BlockLayoutTest = PassTest<::testing::Test>;
+
+TEST_F(BlockLayoutTest, TrueArmFallsThroughBeforeMerge) {
+  // The false arm precedes the true arm in the binary; the true target of
+  // the branch is preferred, so the pass moves the true arm up and keeps
+  // the merge block after both arms.
+  const std::string text = R"(
+; CHECK: OpBranchConditional {{%\w+}} [[then:%\w+]] [[else:%\w+]]
+; CHECK: [[then]] = OpLabel
+; CHECK: [[else]] = OpLabel
+; CHECK: [[merge:%\w+]] = OpLabel
+; CHECK-NEXT: OpReturn
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpSelectionMerge %merge None
+OpBranchConditional %true %then %else
+%else = OpLabel
+OpStore %var %uint_0
+OpBranch %merge
+%then = OpLabel
+OpStore %var %uint_1
+OpBranch %merge
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<BlockLayoutPass>(text, true);
+}
+
+TEST_F(BlockLayoutTest, KeepsLoopBodyContiguous) {
+  // The loop merge block sits between the header and the body in the
+  // binary.  The branch that exits the loop is assumed not taken, so the
+  // body and continue block move up and the merge block moves after them.
+  const std::string text = R"(
+; CHECK: [[header:%\w+]] = OpLabel
+; CHECK: OpBranchConditional {{%\w+}} [[body:%\w+]] [[merge:%\w+]]
+; CHECK: [[body]] = OpLabel
+; CHECK: [[cont:%\w+]] = OpLabel
+; CHECK: OpBranch [[header]]
+; CHECK: [[merge]] = OpLabel
+; CHECK-NEXT: OpReturn
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpBranch %header
+%header = OpLabel
+OpLoopMerge %merge %cont None
+OpBranchConditional %true %body %merge
+%merge = OpLabel
+OpReturn
+%body = OpLabel
+OpBranch %cont
+%cont = OpLabel
+OpBranch %header
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<BlockLayoutPass>(text, true);
+}
+
+TEST_F(BlockLayoutTest, BranchWeightsOverrideHeuristics) {
+  // The false target carries the larger branch weight, so it is laid out
+  // first even though the true target is otherwise preferred.
+  const std::string text = R"(
+; CHECK: OpBranchConditional {{%\w+}} [[then:%\w+]] [[else:%\w+]] 1 9
+; CHECK: [[else]] = OpLabel
+; CHECK: [[then]] = OpLabel
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpSelectionMerge %merge None
+OpBranchConditional %true %then %else 1 9
+%then = OpLabel
+OpStore %var %uint_1
+OpBranch %merge
+%else = OpLabel
+OpStore %var %uint_0
+OpBranch %merge
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<BlockLayoutPass>(text, true);
+}
+
+TEST_F(BlockLayoutTest, LeavesGoodLayoutUnchanged) {
+  // The blocks are already in the order the pass would choose, so it must
+  // report no change.
+  const std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpSelectionMerge %merge None
+OpBranchConditional %true %then %else
+%then = OpLabel
+OpBranch %merge
+%else = OpLabel
+OpBranch %merge
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  auto result = SinglePassRunAndDisassemble<BlockLayoutPass>(
+      text, /* skip_nop = */ true, /* do_validation = */ false);
+  EXPECT_EQ(Pass::Status::SuccessWithoutChange, std::get<1>(result));
+}
+
+TEST_F(BlockLayoutTest, UnreachableBlockStaysAtEnd) {
+  // The unreachable block is not part of any chain; it must survive the
+  // reordering at the end of the function.
+  const std::string text = R"(
+; CHECK: OpBranchConditional {{%\w+}} [[then:%\w+]] [[else:%\w+]]
+; CHECK: [[then]] = OpLabel
+; CHECK: [[else]] = OpLabel
+; CHECK: [[merge:%\w+]] = OpLabel
+; CHECK: [[dead:%\w+]] = OpLabel
+; CHECK-NEXT: OpUnreachable
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpSelectionMerge %merge None
+OpBranchConditional %true %then %else
+%else = OpLabel
+OpBranch %merge
+%then = OpLabel
+OpBranch %merge
+%dead = OpLabel
+OpUnreachable
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<BlockLayoutPass>(text, true);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
@@ -0,0 +1,123 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/opt/build_module.h"
+#include "source/opt/columnar_module.h"
+#include "source/opt/ir_context.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+const std::string kShader = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%uint_2 = OpConstant %uint 2
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%sum = OpIAdd %uint %uint_1 %uint_2
+OpReturn
+OpFunctionEnd
+)";
+
+std::vector<uint32_t> Assemble(const std::string& text) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_2);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(text, &binary));
+  return binary;
+}
+
+TEST(ColumnarModuleTest, MatchesInstructionRepresentation) {
+  const std::vector<uint32_t> binary = Assemble(kShader);
+  std::unique_ptr<ColumnarModule> columns = ColumnarModule::Build(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, columns);
+
+  std::unique_ptr<IRContext> context = BuildModule(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, context);
+
+  // Every instruction must report the same opcode, ids and input operand
+  // words as the object representation, in module order.
+  uint32_t index = 0;
+  context->module()->ForEachInst([&columns, &index](Instruction* inst) {
+    ASSERT_LT(index, columns->NumInstructions());
+    ColumnarModule::Inst column_inst = columns->GetInst(index);
+    EXPECT_EQ(inst->opcode(), column_inst.opcode());
+    EXPECT_EQ(inst->result_id(), column_inst.result_id());
+    EXPECT_EQ(inst->type_id(), column_inst.type_id());
+    ASSERT_EQ(inst->NumInOperands(), column_inst.NumInOperands());
+    for (uint32_t i = 0; i < inst->NumInOperands(); ++i) {
+      if (!column_inst.IsInOperandId(i)) continue;
+      EXPECT_EQ(inst->GetSingleWordInOperand(i),
+                column_inst.GetSingleWordInOperand(i));
+    }
+    ++index;
+  });
+  EXPECT_EQ(columns->NumInstructions(), index);
+}
+
+TEST(ColumnarModuleTest, DefColumnLocatesDefiningInstructions) {
+  const std::vector<uint32_t> binary = Assemble(kShader);
+  std::unique_ptr<ColumnarModule> columns = ColumnarModule::Build(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, columns);
+
+  for (uint32_t id = 1; id < columns->IdBound(); ++id) {
+    const uint32_t def_index = columns->GetDefIndex(id);
+    ASSERT_NE(ColumnarModule::kNoInst, def_index);
+    EXPECT_EQ(id, columns->GetInst(def_index).result_id());
+  }
+}
+
+TEST(ColumnarModuleTest, OperandWordsFollowTheBinary) {
+  const std::vector<uint32_t> binary = Assemble(kShader);
+  std::unique_ptr<ColumnarModule> columns = ColumnarModule::Build(
+      SPV_ENV_UNIVERSAL_1_2, nullptr, binary.data(), binary.size());
+  ASSERT_NE(nullptr, columns);
+
+  // Find the OpIAdd and check its operands are the two constant ids.
+  uint32_t add_index = ColumnarModule::kNoInst;
+  for (uint32_t i = 0; i < columns->NumInstructions(); ++i) {
+    if (columns->GetInst(i).opcode() == spv::Op::OpIAdd) add_index = i;
+  }
+  ASSERT_NE(ColumnarModule::kNoInst, add_index);
+  ColumnarModule::Inst add_inst = columns->GetInst(add_index);
+  ASSERT_EQ(2u, add_inst.NumInOperands());
+  EXPECT_TRUE(add_inst.IsInOperandId(0));
+  EXPECT_TRUE(add_inst.IsInOperandId(1));
+  ColumnarModule::Inst op0 = columns->GetInst(
+      columns->GetDefIndex(add_inst.GetSingleWordInOperand(0)));
+  ColumnarModule::Inst op1 = columns->GetInst(
+      columns->GetDefIndex(add_inst.GetSingleWordInOperand(1)));
+  EXPECT_EQ(spv::Op::OpConstant, op0.opcode());
+  EXPECT_EQ(spv::Op::OpConstant, op1.opcode());
+  EXPECT_EQ(1u, op0.GetSingleWordInOperand(1));
+  EXPECT_EQ(2u, op1.GetSingleWordInOperand(1));
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
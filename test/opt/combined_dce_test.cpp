@@ -0,0 +1,109 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using CombinedDceTest = PassTest<::testing::Test>;
+
+TEST_F(CombinedDceTest, RemovesInstructionLevelDeadCode) {
+  // A plain dead instruction is removed by the instruction-granularity
+  // engine on the first round.
+  const std::string text = R"(
+; CHECK-NOT: OpFAdd
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%float_1 = OpConstant %float 1
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%add = OpFAdd %float %float_1 %float_1
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<CombinedDcePass>(text, true);
+}
+
+TEST_F(CombinedDceTest, VectorDceExposesInstructionDeadCode) {
+  // The first insert into component 0 is overwritten by the second one.
+  // Vector DCE rewrites the second insert to bypass the first, which makes
+  // the first insert and the whole OpFAdd chain feeding it dead at
+  // instruction granularity.  One invocation of the combined pass removes
+  // all of it; the separate passes would need vector-dce followed by
+  // another run of adce.
+  const std::string text = R"(
+; CHECK: [[ld:%\w+]] = OpLoad %v2float %In2
+; CHECK-NOT: OpFAdd
+; CHECK: [[ins:%\w+]] = OpCompositeInsert %v2float %float_0 [[ld]] 0
+; CHECK-NOT: OpFAdd
+; CHECK: {{%\w+}} = OpVectorShuffle %v4float [[ins]] [[ins]] 0 1 0 1
+OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main" %In2 %In0 %In1 %OutColor
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 450
+OpName %main "main"
+OpName %In2 "In2"
+OpName %In0 "In0"
+OpName %In1 "In1"
+OpName %OutColor "OutColor"
+OpDecorate %In2 Location 2
+OpDecorate %In0 Location 0
+OpDecorate %In1 Location 1
+OpDecorate %OutColor Location 0
+%void = OpTypeVoid
+%11 = OpTypeFunction %void
+%float = OpTypeFloat 32
+%v2float = OpTypeVector %float 2
+%_ptr_Input_v2float = OpTypePointer Input %v2float
+%In2 = OpVariable %_ptr_Input_v2float Input
+%_ptr_Input_float = OpTypePointer Input %float
+%In0 = OpVariable %_ptr_Input_float Input
+%In1 = OpVariable %_ptr_Input_float Input
+%float_0 = OpConstant %float 0
+%v4float = OpTypeVector %float 4
+%_ptr_Output_v4float = OpTypePointer Output %v4float
+%OutColor = OpVariable %_ptr_Output_v4float Output
+%main = OpFunction %void None %11
+%25 = OpLabel
+%26 = OpLoad %v2float %In2
+%27 = OpLoad %float %In0
+%28 = OpLoad %float %In1
+%29 = OpFAdd %float %27 %28
+%35 = OpCompositeInsert %v2float %29 %26 0
+%37 = OpCompositeInsert %v2float %float_0 %35 0
+%33 = OpVectorShuffle %v4float %37 %37 0 1 0 1
+OpStore %OutColor %33
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<CombinedDcePass>(text, true);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
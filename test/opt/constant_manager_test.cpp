@@ -102,6 +102,31 @@ TEST_F(ConstantManagerTest, GetDefiningInstructionIdOverflow) {
   EXPECT_EQ(inst, nullptr);
 }
 
+TEST_F(ConstantManagerTest, RemoveIdKeepsValueEqualSiblings) {
+  const std::string text = R"(
+%1 = OpTypeInt 32 0
+%2 = OpConstant %1 42
+%3 = OpConstant %1 42
+  )";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(context, nullptr);
+
+  // %2 and %3 intern to the same Constant instance.  Removing %2 must not
+  // forget that %3 still declares the value.
+  ConstantManager* const_mgr = context->get_constant_mgr();
+  const Constant* value = const_mgr->FindDeclaredConstant(2);
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value, const_mgr->FindDeclaredConstant(3));
+
+  const_mgr->RemoveId(2);
+  EXPECT_EQ(const_mgr->FindDeclaredConstant(2), nullptr);
+  EXPECT_EQ(const_mgr->FindDeclaredConstant(3), value);
+  EXPECT_EQ(const_mgr->FindDeclaredConstant(value, 1), 3u);
+}
+
 }  // namespace
 }  // namespace analysis
 }  // namespace opt
@@ -44,6 +44,24 @@ struct VisitOrder : public ForwardDataFlowAnalysis {
   }
 };
 
+// Same as VisitOrder, but with |final| hooks and the statically dispatched
+// fixpoint loop.
+struct StaticVisitOrder : public ForwardDataFlowAnalysis {
+  std::vector<uint32_t> visited_result_ids;
+
+  StaticVisitOrder(IRContext& context, LabelPosition label_position)
+      : ForwardDataFlowAnalysis(context, label_position) {}
+
+  void Run(Function* function) { RunImpl(this, function); }
+
+  VisitResult Visit(Instruction* inst) final {
+    if (inst->HasResultId()) {
+      visited_result_ids.push_back(inst->result_id());
+    }
+    return DataFlowAnalysis::VisitResult::kResultFixed;
+  }
+};
+
 // For each block, stores the set of blocks it can be preceded by.
 // For example, with the following CFG:
 //    V-----------.
@@ -166,6 +184,11 @@ TEST_F(DataFlowTest, ReversePostOrder) {
     VisitOrder analysis(*context, test_case.first);
     analysis.Run(function);
     EXPECT_EQ(test_case.second, analysis.visited_result_ids);
+
+    // The statically dispatched loop must visit in exactly the same order.
+    StaticVisitOrder static_analysis(*context, test_case.first);
+    static_analysis.Run(function);
+    EXPECT_EQ(test_case.second, static_analysis.visited_result_ids);
   }
 }
 
@@ -37,6 +37,31 @@ namespace opt {
 namespace analysis {
 namespace {
 
+TEST(DebugInfoManager, StrippedModuleQueriesWithoutIndexing) {
+  // A module with no debug-info ExtInstImport takes the bail-out path: every
+  // query answers from empty indices without walking the module.
+  const std::string text = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %main "main"
+               OpExecutionMode %main OriginUpperLeft
+       %void = OpTypeVoid
+          %3 = OpTypeFunction %void
+       %main = OpFunction %void None %3
+          %4 = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  DebugInfoManager manager(context.get());
+  EXPECT_EQ(nullptr, manager.GetDebugInlinedAt(100));
+  EXPECT_EQ(nullptr, manager.GetDebugFunction(4));
+  EXPECT_FALSE(manager.IsVariableDebugDeclared(4));
+  EXPECT_FALSE(manager.KillDebugDeclares(4));
+}
+
 TEST(DebugInfoManager, GetDebugInlinedAt) {
   const std::string text = R"(
                OpCapability Shader
@@ -182,6 +207,72 @@ void main(float in_var_color : COLOR) {
       100U);
 }
 
+TEST(DebugInfoManager, CreateDebugInlinedAtReusesExistingNode) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "OpenCL.DebugInfo.100"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %main "main" %in_var_COLOR
+               OpExecutionMode %main OriginUpperLeft
+          %5 = OpString "ps.hlsl"
+         %14 = OpString "#line 1 \"ps.hlsl\"
+void main(float in_var_color : COLOR) {
+  float color = in_var_color;
+}
+"
+         %17 = OpString "float"
+         %21 = OpString "main"
+         %24 = OpString "color"
+               OpName %in_var_COLOR "in.var.COLOR"
+               OpName %main "main"
+               OpDecorate %in_var_COLOR Location 0
+       %uint = OpTypeInt 32 0
+    %uint_32 = OpConstant %uint 32
+      %float = OpTypeFloat 32
+%_ptr_Input_float = OpTypePointer Input %float
+       %void = OpTypeVoid
+         %27 = OpTypeFunction %void
+%_ptr_Function_float = OpTypePointer Function %float
+%in_var_COLOR = OpVariable %_ptr_Input_float Input
+         %13 = OpExtInst %void %1 DebugExpression
+         %15 = OpExtInst %void %1 DebugSource %5 %14
+         %16 = OpExtInst %void %1 DebugCompilationUnit 1 4 %15 HLSL
+         %18 = OpExtInst %void %1 DebugTypeBasic %17 %uint_32 Float
+         %20 = OpExtInst %void %1 DebugTypeFunction FlagIsProtected|FlagIsPrivate %18 %18
+         %22 = OpExtInst %void %1 DebugFunction %21 %20 %15 1 1 %16 %21 FlagIsProtected|FlagIsPrivate 1 %main
+        %100 = OpExtInst %void %1 DebugInlinedAt 7 %22
+       %main = OpFunction %void None %27
+         %28 = OpLabel
+         %31 = OpLoad %float %in_var_COLOR
+               OpStore %100 %31
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  DebugInfoManager manager(context.get());
+
+  const uint32_t line_number = 7U;
+  Instruction line(context.get(), spv::Op::OpLine);
+  line.SetInOperands({
+      {spv_operand_type_t::SPV_OPERAND_TYPE_ID, {5U}},
+      {spv_operand_type_t::SPV_OPERAND_TYPE_LITERAL_INTEGER, {line_number}},
+      {spv_operand_type_t::SPV_OPERAND_TYPE_LITERAL_INTEGER, {0U}},
+  });
+
+  // The module already has a DebugInlinedAt with the same line and scope.
+  DebugScope scope(22U, 0U);
+  EXPECT_EQ(manager.CreateDebugInlinedAt(&line, scope), 100U);
+
+  // Creating the same node twice must return a single instruction.
+  DebugScope inlined_scope(22U, 100U);
+  uint32_t inlined_at_id = manager.CreateDebugInlinedAt(&line, inlined_scope);
+  EXPECT_NE(inlined_at_id, 100U);
+  EXPECT_EQ(manager.CreateDebugInlinedAt(&line, inlined_scope), inlined_at_id);
+}
+
 TEST(DebugInfoManager, CreateDebugInlinedAtWithConstantManager) {
   // Show that CreateDebugInlinedAt will use the Constant manager to generate
   // its line operand if the Constant and DefUse managers are valid. This is
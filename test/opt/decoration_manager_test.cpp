@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -321,6 +322,55 @@ TEST_F(DecorationManagerTest,
   EXPECT_FALSE(decoManager->AreDecorationsTheSame(&inst1, &inst2, false));
 }
 
+TEST_F(DecorationManagerTest, RemapAllIds) {
+  const std::string spirv = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %1 Constant
+OpDecorate %2 Restrict
+%2      = OpDecorationGroup
+OpGroupDecorate %2 %1 %3
+%4   = OpTypeInt 32 0
+%1      = OpVariable %4 Uniform
+%3      = OpVariable %4 Uniform
+)";
+  DecorationManager* decoManager = GetDecorationManager(spirv);
+  EXPECT_THAT(GetErrorMessage(), "");
+
+  // Swap the ids of the two variables; the group and the type are untouched.
+  const std::unordered_map<uint32_t, uint32_t> id_map = {{1u, 3u}, {3u, 1u}};
+  decoManager->RemapAllIds(id_map);
+
+  // Both variables keep some decorations, so the index must now answer for
+  // the renamed targets.
+  auto decorations = decoManager->GetDecorationsFor(1u, false);
+  EXPECT_THAT(GetErrorMessage(), "");
+  const std::string expected_decorations_1 = R"(OpDecorate %2 Restrict
+)";
+  EXPECT_THAT(ToText(decorations), expected_decorations_1);
+
+  decorations = decoManager->GetDecorationsFor(3u, false);
+  EXPECT_THAT(GetErrorMessage(), "");
+  const std::string expected_decorations_3 = R"(OpDecorate %3 Constant
+OpDecorate %2 Restrict
+)";
+  EXPECT_THAT(ToText(decorations), expected_decorations_3);
+
+  const std::string expected_binary = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %3 Constant
+OpDecorate %2 Restrict
+%2 = OpDecorationGroup
+OpGroupDecorate %2 %3 %1
+%4 = OpTypeInt 32 0
+%1 = OpVariable %4 Uniform
+%3 = OpVariable %4 Uniform
+)";
+  EXPECT_THAT(ModuleToText(), expected_binary);
+}
+
 TEST_F(DecorationManagerTest, RemoveDecorationFromVariable) {
   const std::string spirv = R"(
 OpCapability Shader
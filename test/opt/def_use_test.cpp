@@ -1400,6 +1400,78 @@ TEST(AnalyzeInstDefUse, UseWithNoResultId) {
   CheckUse(expected, &manager, context.module()->IdBound());
 }
 
+TEST(AnalyzeInstDefUse, BatchedUpdates) {
+  const std::string input = "%1 = OpTypeBool";
+
+  // Build module.
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+
+  // Analyze the instructions.
+  DefUseManager manager(context->module());
+
+  // Buffer two new instructions that reference each other's ids, recording
+  // them in use-before-def order; the commit must still resolve them.
+  Instruction constInst(context.get(), spv::Op::OpConstantTrue, 1, 2, {});
+  Instruction copyInst(context.get(), spv::Op::OpCopyObject, 1, 3,
+                       {{SPV_OPERAND_TYPE_ID, {2}}});
+  manager.BeginBatchedUpdates();
+  EXPECT_TRUE(manager.BatchingUpdates());
+  manager.RecordModifiedInst(&copyInst);
+  manager.RecordModifiedInst(&constInst);
+  manager.EndBatchedUpdates();
+  EXPECT_FALSE(manager.BatchingUpdates());
+
+  InstDefUse expected = {
+      {
+          // defs
+          {1, "%1 = OpTypeBool"},
+          {2, "%2 = OpConstantTrue %1"},
+          {3, "%3 = OpCopyObject %1 %2"},
+      },
+      {
+          // uses
+          {1, {"%2 = OpConstantTrue %1", "%3 = OpCopyObject %1 %2"}},
+          {2, {"%3 = OpCopyObject %1 %2"}},
+      },
+  };
+
+  CheckDef(expected, manager.id_to_defs());
+  CheckUse(expected, &manager, context->module()->IdBound());
+}
+
+TEST(AnalyzeInstDefUse, BatchedDeletionDropsPendingRecord) {
+  const std::string input = "%1 = OpTypeBool";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+
+  DefUseManager manager(context->module());
+
+  Instruction constInst(context.get(), spv::Op::OpConstantTrue, 1, 2, {});
+  manager.AnalyzeInstDefUse(&constInst);
+
+  manager.BeginBatchedUpdates();
+  manager.RecordModifiedInst(&constInst);
+  manager.RecordDeletedInst(&constInst);
+  manager.EndBatchedUpdates();
+
+  InstDefUse expected = {
+      {
+          // defs
+          {1, "%1 = OpTypeBool"},
+      },
+      {
+          // uses
+      },
+  };
+
+  CheckDef(expected, manager.id_to_defs());
+  CheckUse(expected, &manager, context->module()->IdBound());
+}
+
 TEST(AnalyzeInstDefUse, AddNewInstruction) {
   const std::string input = "%1 = OpTypeBool";
 
@@ -1430,6 +1502,75 @@ TEST(AnalyzeInstDefUse, AddNewInstruction) {
   CheckUse(expected, &manager, context->module()->IdBound());
 }
 
+TEST(AnalyzeInstDefUse, FunctionScopedUserWalks) {
+  const std::string input = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %c RelaxedPrecision
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%float = OpTypeFloat 32
+%c = OpConstant %float 1
+%f = OpFunction %void None %fnty
+%fb = OpLabel
+%add = OpFAdd %float %c %c
+OpReturn
+OpFunctionEnd
+%g = OpFunction %void None %fnty
+%gb = OpLabel
+%mul = OpFMul %float %c %c
+OpReturn
+OpFunctionEnd
+)";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+
+  DefUseManager manager(context->module());
+
+  Instruction* constant = nullptr;
+  for (Instruction& inst : context->module()->types_values()) {
+    if (inst.opcode() == spv::Op::OpConstant) constant = &inst;
+  }
+  ASSERT_NE(nullptr, constant);
+  Function* f = &*context->module()->begin();
+  Function* g = &*(++context->module()->begin());
+
+  // Each function-scoped walk sees only the use sites in that function;
+  // the module-scope decoration is visited by neither.
+  std::vector<spv::Op> f_users;
+  manager.ForEachUser(constant, f, [&f_users](Instruction* user) {
+    f_users.push_back(user->opcode());
+  });
+  EXPECT_THAT(f_users, UnorderedElementsAre(spv::Op::OpFAdd));
+
+  std::vector<spv::Op> g_users;
+  manager.ForEachUser(constant, g, [&g_users](Instruction* user) {
+    g_users.push_back(user->opcode());
+  });
+  EXPECT_THAT(g_users, UnorderedElementsAre(spv::Op::OpFMul));
+
+  uint32_t all_users = 0;
+  manager.ForEachUser(constant, [&all_users](Instruction*) { ++all_users; });
+  EXPECT_EQ(3u, all_users);
+
+  // A user analyzed before it is placed in any block has no containing
+  // function: the unscoped walk sees it, function-scoped walks do not.
+  Instruction detached(context.get(), spv::Op::OpCopyObject,
+                       constant->type_id(), 100,
+                       {{SPV_OPERAND_TYPE_ID, {constant->result_id()}}});
+  manager.AnalyzeInstDefUse(&detached);
+  f_users.clear();
+  manager.ForEachUser(constant, f, [&f_users](Instruction* user) {
+    f_users.push_back(user->opcode());
+  });
+  EXPECT_THAT(f_users, UnorderedElementsAre(spv::Op::OpFAdd));
+  all_users = 0;
+  manager.ForEachUser(constant, [&all_users](Instruction*) { ++all_users; });
+  EXPECT_EQ(4u, all_users);
+}
+
 struct KillInstTestCase {
   const char* before;
   std::unordered_set<uint32_t> indices_for_inst_to_kill;
@@ -2280,7 +2280,79 @@ INSTANTIATE_TEST_SUITE_P(FloatConstantFoldingTest, FloatInstructionFoldingTest,
             "%2 = OpFDiv %float %float_0 %float_n0\n" +
             "OpReturn\n" +
             "OpFunctionEnd",
-        2, std::numeric_limits<float>::quiet_NaN())
+        2, std::numeric_limits<float>::quiet_NaN()),
+    // Test case 47: Round 0.5
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Round %float_0p5\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 1.0),
+    // Test case 48: Trunc 0.2
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Trunc %float_0p2\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 0.0),
+    // Test case 49: FAbs -1.0
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 FAbs %float_n1\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 1.0),
+    // Test case 50: FSign -1.0
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 FSign %float_n1\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, -1.0),
+    // Test case 51: Floor 0.5
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Floor %float_0p5\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 0.0),
+    // Test case 52: Ceil 0.2
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Ceil %float_0p2\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 1.0),
+    // Test case 53: Fract 0.5
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Fract %float_0p5\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 0.5),
+    // Test case 54: InverseSqrt 4.0
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 InverseSqrt %float_4\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 0.5),
+    // Test case 55: Sinh 0.0
+    InstructionFoldingCase<float>(
+        Header() + "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpExtInst %float %1 Sinh %float_0\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        2, 0.0)
 ));
 // clang-format on
 
@@ -5102,6 +5174,78 @@ INSTANTIATE_TEST_SUITE_P(RedundantIntegerMatching, MatchingInstructionFoldingTes
         2, true)
 ));
 
+INSTANTIATE_TEST_SUITE_P(GlslStd450AlgebraicMatching, MatchingInstructionFoldingTest,
+::testing::Values(
+    // Test case 0: min(min(x, y), x) = min(x, y)
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: %5 = OpExtInst %float %1 FMin %3 %4\n" +
+            "; CHECK: %2 = OpCopyObject %float %5\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%n = OpVariable %_ptr_float Function\n" +
+            "%m = OpVariable %_ptr_float Function\n" +
+            "%3 = OpLoad %float %n\n" +
+            "%4 = OpLoad %float %m\n" +
+            "%5 = OpExtInst %float %1 FMin %3 %4\n" +
+            "%2 = OpExtInst %float %1 FMin %5 %3\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd\n",
+        2, true),
+    // Test case 1: min(y, min(x, y)) = min(x, y) via SMin
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: %5 = OpExtInst %int %1 SMin %3 %4\n" +
+            "; CHECK: %2 = OpCopyObject %int %5\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%n = OpVariable %_ptr_int Function\n" +
+            "%m = OpVariable %_ptr_int Function\n" +
+            "%3 = OpLoad %int %n\n" +
+            "%4 = OpLoad %int %m\n" +
+            "%5 = OpExtInst %int %1 SMin %3 %4\n" +
+            "%2 = OpExtInst %int %1 SMin %4 %5\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd\n",
+        2, true),
+    // Test case 2: pow(x, 1.0) = x
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: %2 = OpCopyObject %float %3\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%n = OpVariable %_ptr_float Function\n" +
+            "%3 = OpLoad %float %n\n" +
+            "%2 = OpExtInst %float %1 Pow %3 %float_1\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd\n",
+        2, true),
+    // Test case 3: pow(x, 2.0) = x * x
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: %2 = OpFMul %float %3 %3\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%n = OpVariable %_ptr_float Function\n" +
+            "%3 = OpLoad %float %n\n" +
+            "%2 = OpExtInst %float %1 Pow %3 %float_2\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd\n",
+        2, true),
+    // Test case 4: pow(x, 0.5) = sqrt(x)
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: %2 = OpExtInst %float %1 Sqrt %3\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%n = OpVariable %_ptr_float Function\n" +
+            "%3 = OpLoad %float %n\n" +
+            "%2 = OpExtInst %float %1 Pow %3 %float_0p5\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd\n",
+        2, true)
+));
+
 INSTANTIATE_TEST_SUITE_P(MergeNegateTest, MatchingInstructionFoldingTest,
 ::testing::Values(
   // Test case 0: fold consecutive fnegate
@@ -7505,14 +7649,14 @@ INSTANTIATE_TEST_SUITE_P(DotProductMatchingTest, MatchingInstructionFoldingTest,
 
 INSTANTIATE_TEST_SUITE_P(VectorShuffleMatchingTest, MatchingInstructionFoldingTest,
 ::testing::Values(
-    // Test case 0: Using OpDot to extract last element.
+    // Test case 0: A shuffle of a shuffle collapses to read the surviving
+    // vector directly; the undefined lane in the feeder stays undefined.
     InstructionFoldingCase<bool>(
         Header() +
             "; CHECK: [[int:%\\w+]] = OpTypeInt 32 1\n" +
             "; CHECK: [[v2int:%\\w+]] = OpTypeVector [[int]] 2{{[[:space:]]}}\n" +
-            "; CHECK: [[null:%\\w+]] = OpConstantNull [[v2int]]\n" +
-            "; CHECK: OpVectorShuffle\n" +
-            "; CHECK: %3 = OpVectorShuffle [[v2int]] [[null]] {{%\\w+}} 4294967295 2\n" +
+            "; CHECK: %2 = OpVectorShuffle [[v2int]] {{%\\w+}} [[c23:%\\w+]] 3 4294967295\n" +
+            "; CHECK: %3 = OpVectorShuffle [[v2int]] [[c23]] [[c23]] 4294967295 0\n" +
             "%main = OpFunction %void None %void_func\n" +
             "%main_lab = OpLabel\n" +
             "%n = OpVariable %_ptr_int Function\n" +
@@ -8037,14 +8181,12 @@ INSTANTIATE_TEST_SUITE_P(VectorShuffleMatchingTest, MatchingInstructionWithNoRes
             "OpReturn\n" +
             "OpFunctionEnd",
         9, true),
-    // Test case 10: Replace unused operand with null.
+    // Test case 10: The feeder is fully bypassed, so the collapsed shuffle
+    // reads the other vector alone.
     InstructionFoldingCase<bool>(
         Header() +
-            "; CHECK: [[double:%\\w+]] = OpTypeFloat 64\n" +
-            "; CHECK: [[v4double:%\\w+]] = OpTypeVector [[double]] 2\n" +
-            "; CHECK: [[null:%\\w+]] = OpConstantNull [[v4double]]\n" +
             "; CHECK: OpVectorShuffle\n" +
-            "; CHECK: OpVectorShuffle {{%\\w+}} [[null]] %7 4 2 5 3\n" +
+            "; CHECK: OpVectorShuffle {{%\\w+}} %7 %7 2 0 3 1\n" +
             "; CHECK: OpReturn\n" +
             "%main = OpFunction %void None %void_func\n" +
             "%main_lab = OpLabel\n" +
@@ -8059,14 +8201,12 @@ INSTANTIATE_TEST_SUITE_P(VectorShuffleMatchingTest, MatchingInstructionWithNoRes
             "OpReturn\n" +
             "OpFunctionEnd",
         9, true),
-    // Test case 11: Replace unused operand with null.
+    // Test case 11: Both operands feed through the same shuffle; the chain
+    // collapses to read the original vector directly.
     InstructionFoldingCase<bool>(
         Header() +
-            "; CHECK: [[double:%\\w+]] = OpTypeFloat 64\n" +
-            "; CHECK: [[v4double:%\\w+]] = OpTypeVector [[double]] 2\n" +
-            "; CHECK: [[null:%\\w+]] = OpConstantNull [[v4double]]\n" +
             "; CHECK: OpVectorShuffle\n" +
-            "; CHECK: OpVectorShuffle {{%\\w+}} [[null]] %5 2 2 5 5\n" +
+            "; CHECK: OpVectorShuffle {{%\\w+}} %5 %5 0 0 3 3\n" +
             "; CHECK: OpReturn\n" +
             "%main = OpFunction %void None %void_func\n" +
             "%main_lab = OpLabel\n" +
@@ -8079,14 +8219,12 @@ INSTANTIATE_TEST_SUITE_P(VectorShuffleMatchingTest, MatchingInstructionWithNoRes
             "OpReturn\n" +
             "OpFunctionEnd",
         9, true),
-    // Test case 12: Replace unused operand with null.
+    // Test case 12: The unused feeder operand is dropped in favor of
+    // reading the used vector through both slots.
     InstructionFoldingCase<bool>(
         Header() +
-            "; CHECK: [[double:%\\w+]] = OpTypeFloat 64\n" +
-            "; CHECK: [[v4double:%\\w+]] = OpTypeVector [[double]] 2\n" +
-            "; CHECK: [[null:%\\w+]] = OpConstantNull [[v4double]]\n" +
             "; CHECK: OpVectorShuffle\n" +
-            "; CHECK: OpVectorShuffle {{%\\w+}} %7 [[null]] 2 0 1 3\n" +
+            "; CHECK: OpVectorShuffle {{%\\w+}} %7 %7 2 0 1 3\n" +
             "; CHECK: OpReturn\n" +
             "%main = OpFunction %void None %void_func\n" +
             "%main_lab = OpLabel\n" +
@@ -8142,7 +8280,44 @@ INSTANTIATE_TEST_SUITE_P(VectorShuffleMatchingTest, MatchingInstructionWithNoRes
             "%9 = OpVectorShuffle %v4double %8 %7 0 1 2 4294967295\n" +
             "OpReturn\n" +
             "OpFunctionEnd",
-        9, true)
+        9, true),
+    // Test case 15: A three-shuffle chain reading two vectors collapses in
+    // a single folding step.
+    InstructionFoldingCase<bool>(
+        Header() +
+            "; CHECK: OpVectorShuffle\n" +
+            "; CHECK: OpVectorShuffle\n" +
+            "; CHECK: OpVectorShuffle {{%\\w+}} %6 %5 0 6 5 4\n" +
+            "; CHECK: OpReturn\n" +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpVariable %_ptr_v4double Function\n" +
+            "%3 = OpVariable %_ptr_v4double Function\n" +
+            "%5 = OpLoad %v4double %2\n" +
+            "%6 = OpLoad %v4double %3\n" +
+            "%8 = OpVectorShuffle %v4double %5 %6 2 3 4 5\n" +
+            "%9 = OpVectorShuffle %v4double %8 %5 0 2 4 5\n" +
+            "%10 = OpVectorShuffle %v4double %9 %9 1 0 7 6\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        10, true),
+    // Test case 16: Don't fold.  The chain ultimately reads three distinct
+    // vectors, which a single shuffle cannot express.
+    InstructionFoldingCase<bool>(
+        Header() +
+            "%main = OpFunction %void None %void_func\n" +
+            "%main_lab = OpLabel\n" +
+            "%2 = OpVariable %_ptr_v4double Function\n" +
+            "%3 = OpVariable %_ptr_v4double Function\n" +
+            "%4 = OpVariable %_ptr_v4double Function\n" +
+            "%5 = OpLoad %v4double %2\n" +
+            "%6 = OpLoad %v4double %3\n" +
+            "%7 = OpLoad %v4double %4\n" +
+            "%8 = OpVectorShuffle %v4double %5 %6 2 3 4 5\n" +
+            "%9 = OpVectorShuffle %v4double %7 %8 0 1 4 6\n" +
+            "OpReturn\n" +
+            "OpFunctionEnd",
+        9, false)
 ));
 
 using EntryPointFoldingTest =
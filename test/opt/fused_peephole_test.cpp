@@ -0,0 +1,120 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <tuple>
+
+#include "gmock/gmock.h"
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using FusedPeepholeTest = PassTest<::testing::Test>;
+
+// One run must apply both rule sets: the multiply by 8 is strength-reduced
+// to a shift, and the multiply by 1 is folded away by the simplification
+// rules.
+TEST_F(FusedPeepholeTest, AppliesBothRuleSetsInOneRun) {
+  const std::string text = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Vertex %main "main"
+OpName %main "main"
+%void = OpTypeVoid
+%4 = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%uint_8 = OpConstant %uint 8
+%_ptr_Function_uint = OpTypePointer Function %uint
+%main = OpFunction %void None %4
+%8 = OpLabel
+%v = OpVariable %_ptr_Function_uint Function
+%ld = OpLoad %uint %v
+%mul8 = OpIMul %uint %ld %uint_8
+%mul1 = OpIMul %uint %mul8 %uint_1
+OpStore %v %mul1
+OpReturn
+OpFunctionEnd
+)";
+
+  auto result = SinglePassRunAndDisassemble<FusedPeepholePass>(
+      text, /* skip_nop = */ true, /* do_validation = */ false);
+
+  EXPECT_EQ(Pass::Status::SuccessWithChange, std::get<1>(result));
+  const std::string& output = std::get<0>(result);
+  EXPECT_THAT(output, Not(HasSubstr("OpIMul")));
+  EXPECT_THAT(output, HasSubstr("OpShiftLeftLogical %uint"));
+  EXPECT_THAT(output, HasSubstr("%uint_3"));
+}
+
+// A caller-registered rule takes part in the same traversal.
+TEST_F(FusedPeepholeTest, AppliesRegisteredRules) {
+  const std::string text = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Vertex %main "main"
+OpName %main "main"
+%void = OpTypeVoid
+%4 = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%_ptr_Function_uint = OpTypePointer Function %uint
+%main = OpFunction %void None %4
+%8 = OpLabel
+%v = OpVariable %_ptr_Function_uint Function
+%ld = OpLoad %uint %v
+%neg = OpNot %uint %ld
+%neg2 = OpNot %uint %neg
+OpStore %v %neg2
+OpReturn
+OpFunctionEnd
+)";
+
+  FusedPeepholePass pass;
+  pass.AddRule([](IRContext* context, Instruction* inst) {
+    // Rewrites OpNot(OpNot(x)) to a copy of x.
+    if (inst->opcode() != spv::Op::OpNot) return false;
+    Instruction* operand =
+        context->get_def_use_mgr()->GetDef(inst->GetSingleWordInOperand(0));
+    if (operand->opcode() != spv::Op::OpNot) return false;
+    inst->SetOpcode(spv::Op::OpCopyObject);
+    inst->SetInOperands(
+        {{SPV_OPERAND_TYPE_ID, {operand->GetSingleWordInOperand(0)}}});
+    return true;
+  });
+
+  std::vector<uint32_t> binary;
+  Pass::Status status;
+  std::tie(binary, status) = OptimizeToBinary(&pass, text,
+                                              /* skip_nop = */ true);
+  EXPECT_EQ(Pass::Status::SuccessWithChange, status);
+
+  std::string output;
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  ASSERT_TRUE(tools.Disassemble(binary, &output));
+  // The second OpNot is rewritten to a copy of the original value and the
+  // copy is propagated away, leaving only the first OpNot behind.
+  const size_t first = output.find("OpNot");
+  ASSERT_NE(std::string::npos, first);
+  EXPECT_EQ(std::string::npos, output.find("OpNot", first + 1));
+  EXPECT_THAT(output, Not(HasSubstr("OpCopyObject")));
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
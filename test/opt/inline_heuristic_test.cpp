@@ -0,0 +1,105 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <tuple>
+
+#include "gmock/gmock.h"
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using InlineHeuristicTest = PassTest<::testing::Test>;
+
+// A compute shader calling a small helper twice: once from the entry block
+// and once from inside a loop.  The loop-nested site must win when the
+// budget only covers one expansion.
+const std::string kTwoCallSites = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpName %ca "ca"
+OpName %cb "cb"
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uintfn = OpTypeFunction %uint
+%uint_1 = OpConstant %uint 1
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%ptr = OpTypePointer Function %uint
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%va = OpVariable %ptr Function
+%vb = OpVariable %ptr Function
+%ca = OpFunctionCall %uint %foo
+OpStore %va %ca
+OpBranch %loop
+%loop = OpLabel
+OpLoopMerge %merge %cont None
+OpBranch %body
+%body = OpLabel
+%cb = OpFunctionCall %uint %foo
+OpStore %vb %cb
+OpBranch %cont
+%cont = OpLabel
+OpBranchConditional %true %loop %merge
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+%foo = OpFunction %uint None %uintfn
+%fe = OpLabel
+%r = OpIAdd %uint %uint_1 %uint_1
+OpReturnValue %r
+OpFunctionEnd
+)";
+
+TEST_F(InlineHeuristicTest, GenerousBudgetInlinesEveryCall) {
+  auto result = SinglePassRunAndDisassemble<InlineHeuristicPass>(
+      kTwoCallSites, /* skip_nop = */ true, /* do_validation = */ false,
+      /* growth_budget_percent = */ 1000);
+
+  EXPECT_EQ(Pass::Status::SuccessWithChange, std::get<1>(result));
+  EXPECT_THAT(std::get<0>(result), Not(HasSubstr("OpFunctionCall")));
+}
+
+TEST_F(InlineHeuristicTest, ZeroBudgetLeavesModuleUnchanged) {
+  auto result = SinglePassRunAndDisassemble<InlineHeuristicPass>(
+      kTwoCallSites, /* skip_nop = */ true, /* do_validation = */ false,
+      /* growth_budget_percent = */ 0);
+
+  EXPECT_EQ(Pass::Status::SuccessWithoutChange, std::get<1>(result));
+}
+
+TEST_F(InlineHeuristicTest, PrefersLoopNestedCallSiteWhenBudgetCoversOne) {
+  // An 18 percent budget covers a single expansion of %foo, so the site
+  // inside the loop is expanded and the entry-block site stays a call.
+  auto result = SinglePassRunAndDisassemble<InlineHeuristicPass>(
+      kTwoCallSites, /* skip_nop = */ true, /* do_validation = */ false,
+      /* growth_budget_percent = */ 18);
+
+  EXPECT_EQ(Pass::Status::SuccessWithChange, std::get<1>(result));
+  const std::string& output = std::get<0>(result);
+  EXPECT_THAT(output, HasSubstr("%ca = OpFunctionCall"));
+  EXPECT_THAT(output, Not(HasSubstr("%cb = OpFunctionCall")));
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
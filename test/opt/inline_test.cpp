@@ -4131,7 +4131,8 @@ TEST_F(InlineTest, NestedWithAnExistingDebugInlinedAt) {
   // When a DebugScope instruction in a callee function already has a
   // DebugInlinedAt information, we have to create a recursive
   // DebugInlinedAt chain. See inlined_to_zoo and inlined_to_bar in
-  // the following code.
+  // the following code. The DebugInlinedAt to main is shared by both
+  // chains instead of being cloned for each of them.
   const std::string text = R"(
 ; CHECK: [[main:%\d+]] = OpString "main"
 ; CHECK: [[foo:%\d+]] = OpString "foo"
@@ -4146,7 +4147,6 @@ TEST_F(InlineTest, NestedWithAnExistingDebugInlinedAt) {
 ; CHECK: [[dbg_zoo:%\d+]] = OpExtInst %void [[ext]] DebugFunction [[zoo]]
 ; CHECK: [[inlined_to_main:%\d+]] = OpExtInst %void [[ext]] DebugInlinedAt 10 [[dbg_main]]
 ; CHECK: [[inlined_to_zoo:%\d+]] = OpExtInst %void [[ext]] DebugInlinedAt 7 [[dbg_zoo]] [[inlined_to_main]]
-; CHECK: [[inlined_to_main:%\d+]] = OpExtInst %void [[ext]] DebugInlinedAt 10 [[dbg_main]]
 ; CHECK: [[inlined_to_bar:%\d+]] = OpExtInst %void [[ext]] DebugInlinedAt 4 [[dbg_bar]] [[inlined_to_zoo]]
 ; CHECK: {{%\d+}} = OpExtInst %void [[ext]] DebugScope [[dbg_foo]] [[inlined_to_bar]]
 ; CHECK: OpStore [[foo_ret:%\d+]] [[v4f1]]
@@ -259,6 +259,30 @@ TEST(InstructionTest, ForInIdNonstandardIdTypes) {
   EXPECT_THAT(ids, Eq(std::vector<uint32_t>{100, 101, 102}));
 }
 
+TEST(InstructionTest, IdWordIteration) {
+  IRContext context(SPV_ENV_UNIVERSAL_1_2, nullptr);
+  Instruction inst(&context, kSampleAccessChainInstruction);
+
+  // ForEachIdWord visits every id, including the result id and type id.
+  std::vector<uint32_t> ids;
+  inst.ForEachIdWord([&ids](const uint32_t* idptr) { ids.push_back(*idptr); });
+  EXPECT_THAT(ids, Eq(std::vector<uint32_t>{100, 101, 102, 103, 104, 105}));
+
+  // ForEachInIdWord visits only the input ids.
+  ids.clear();
+  inst.ForEachInIdWord(
+      [&ids](const uint32_t* idptr) { ids.push_back(*idptr); });
+  EXPECT_THAT(ids, Eq(std::vector<uint32_t>{102, 103, 104, 105}));
+
+  // WhileEachInIdWord stops as soon as the functor returns false.
+  ids.clear();
+  inst.WhileEachInIdWord([&ids](const uint32_t* idptr) {
+    ids.push_back(*idptr);
+    return false;
+  });
+  EXPECT_THAT(ids, Eq(std::vector<uint32_t>{102}));
+}
+
 TEST(InstructionTest, UniqueIds) {
   IRContext context(SPV_ENV_UNIVERSAL_1_2, nullptr);
   Instruction inst1(&context);
@@ -0,0 +1,213 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using IPConstantPropTest = PassTest<::testing::Test>;
+
+TEST_F(IPConstantPropTest, PropagatesAgreeingConstantArguments) {
+  const std::string text = R"(
+; CHECK: OpIAdd %int %int_3 %int_3
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+      %int_3 = OpConstant %int 3
+    %void_fn = OpTypeFunction %void
+     %int_fn = OpTypeFunction %int %int
+       %main = OpFunction %void None %void_fn
+ %main_entry = OpLabel
+      %call1 = OpFunctionCall %int %callee %int_3
+      %call2 = OpFunctionCall %int %callee %int_3
+               OpReturn
+               OpFunctionEnd
+     %callee = OpFunction %int None %int_fn
+      %param = OpFunctionParameter %int
+       %body = OpLabel
+        %sum = OpIAdd %int %param %param
+               OpReturnValue %sum
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<IPConstantPropPass>(text, true);
+}
+
+TEST_F(IPConstantPropTest, PropagatesValueEqualArgumentsWithDistinctIds) {
+  const std::string text = R"(
+; CHECK: OpIAdd %int %int_3 %int_3
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+      %int_3 = OpConstant %int 3
+    %int_3_0 = OpConstant %int 3
+    %void_fn = OpTypeFunction %void
+     %int_fn = OpTypeFunction %int %int
+       %main = OpFunction %void None %void_fn
+ %main_entry = OpLabel
+      %call1 = OpFunctionCall %int %callee %int_3
+      %call2 = OpFunctionCall %int %callee %int_3_0
+               OpReturn
+               OpFunctionEnd
+     %callee = OpFunction %int None %int_fn
+      %param = OpFunctionParameter %int
+       %body = OpLabel
+        %sum = OpIAdd %int %param %param
+               OpReturnValue %sum
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<IPConstantPropPass>(text, true);
+}
+
+TEST_F(IPConstantPropTest, DoesNotPropagateDisagreeingArguments) {
+  const std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %1 "main"
+OpExecutionMode %1 LocalSize 1 1 1
+%void = OpTypeVoid
+%int = OpTypeInt 32 1
+%int_3 = OpConstant %int 3
+%int_4 = OpConstant %int 4
+%6 = OpTypeFunction %void
+%7 = OpTypeFunction %int %int
+%1 = OpFunction %void None %6
+%8 = OpLabel
+%9 = OpFunctionCall %int %10 %int_3
+%11 = OpFunctionCall %int %10 %int_4
+OpReturn
+OpFunctionEnd
+%10 = OpFunction %int None %7
+%12 = OpFunctionParameter %int
+%13 = OpLabel
+%14 = OpIAdd %int %12 %12
+OpReturnValue %14
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<IPConstantPropPass>(text, text, false);
+}
+
+TEST_F(IPConstantPropTest, PropagatesThroughForwardedParameter) {
+  const std::string text = R"(
+; CHECK: OpFunctionCall %int {{%\w+}} %int_7
+; CHECK: OpFunctionCall %int {{%\w+}} %int_7
+; CHECK: OpIMul %int %int_7 %int_7
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+      %int_7 = OpConstant %int 7
+    %void_fn = OpTypeFunction %void
+     %int_fn = OpTypeFunction %int %int
+       %main = OpFunction %void None %void_fn
+ %main_entry = OpLabel
+      %call1 = OpFunctionCall %int %forward %int_7
+               OpReturn
+               OpFunctionEnd
+    %forward = OpFunction %int None %int_fn
+     %param1 = OpFunctionParameter %int
+      %body1 = OpLabel
+      %call2 = OpFunctionCall %int %square %param1
+               OpReturnValue %call2
+               OpFunctionEnd
+     %square = OpFunction %int None %int_fn
+     %param2 = OpFunctionParameter %int
+      %body2 = OpLabel
+       %prod = OpIMul %int %param2 %param2
+               OpReturnValue %prod
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<IPConstantPropPass>(text, true);
+}
+
+TEST_F(IPConstantPropTest, SelfForwardingRecursionDoesNotBlockPropagation) {
+  const std::string text = R"(
+; CHECK: OpIEqual %bool %int_5 %int_0
+; CHECK: OpReturnValue %int_5
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+       %bool = OpTypeBool
+      %int_0 = OpConstant %int 0
+      %int_5 = OpConstant %int 5
+    %void_fn = OpTypeFunction %void
+     %int_fn = OpTypeFunction %int %int
+       %main = OpFunction %void None %void_fn
+ %main_entry = OpLabel
+      %call1 = OpFunctionCall %int %recurse %int_5
+               OpReturn
+               OpFunctionEnd
+    %recurse = OpFunction %int None %int_fn
+      %param = OpFunctionParameter %int
+       %body = OpLabel
+         %eq = OpIEqual %bool %param %int_0
+               OpSelectionMerge %merge None
+               OpBranchConditional %eq %merge %again
+      %again = OpLabel
+      %call2 = OpFunctionCall %int %recurse %param
+               OpBranch %merge
+      %merge = OpLabel
+               OpReturnValue %param
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<IPConstantPropPass>(text, true);
+}
+
+TEST_F(IPConstantPropTest, ExportedFunctionIsNotChanged) {
+  const std::string text = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %1 LinkageAttributes "exported" Export
+%int = OpTypeInt 32 1
+%int_3 = OpConstant %int 3
+%4 = OpTypeFunction %int %int
+%5 = OpFunction %int None %4
+%6 = OpFunctionParameter %int
+%7 = OpLabel
+%8 = OpFunctionCall %int %1 %int_3
+OpReturnValue %8
+OpFunctionEnd
+%1 = OpFunction %int None %4
+%9 = OpFunctionParameter %int
+%10 = OpLabel
+%11 = OpIAdd %int %9 %9
+OpReturnValue %11
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<IPConstantPropPass>(text, text, false);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
@@ -62,6 +62,25 @@ class NoopPassPreservesAll : public Pass {
   Status status_to_return_;
 };
 
+class NoopPassPreservesPerFunction : public Pass {
+ public:
+  explicit NoopPassPreservesPerFunction(const Function* modified)
+      : modified_(modified) {}
+
+  const char* name() const override { return "noop-pass"; }
+  Status Process() override {
+    MarkFunctionModified(modified_);
+    return Status::SuccessWithChange;
+  }
+
+  Analysis GetPreservedAnalysesForUnmodifiedFunctions() override {
+    return IRContext::kPerFunctionAnalyses;
+  }
+
+ private:
+  const Function* modified_;
+};
+
 class NoopPassPreservesFirst : public Pass {
  public:
   NoopPassPreservesFirst(Status s) : Pass(), status_to_return_(s) {}
@@ -302,6 +321,53 @@ TEST_F(IRContextTest, TakeNextUniqueIdIncrementing) {
     EXPECT_EQ(i, localContext.TakeNextUniqueId());
 }
 
+TEST_F(IRContextTest, DefUseBatchAppliesDeferredUpdatesOnCommit) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeInt 32 0
+          %6 = OpConstant %5 1
+          %7 = OpConstant %5 2
+          %2 = OpFunction %3 None %4
+          %8 = OpLabel
+          %9 = OpIAdd %5 %6 %6
+         %10 = OpIAdd %5 %9 %6
+               OpReturn
+               OpFunctionEnd
+)";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  analysis::DefUseManager* def_use_mgr = context->get_def_use_mgr();
+  Instruction* add = def_use_mgr->GetDef(9);
+  Instruction* second_add = def_use_mgr->GetDef(10);
+
+  // Rewrite one operand of each addition from %6 to %7 inside a batch; the
+  // use records must be correct once the batch commits.
+  context->BeginDefUseBatch();
+  context->ForgetUses(add);
+  add->SetInOperand(1, {7});
+  context->AnalyzeUses(add);
+  context->ForgetUses(second_add);
+  second_add->SetInOperand(1, {7});
+  context->AnalyzeUses(second_add);
+  context->CommitDefUseBatch();
+
+  EXPECT_EQ(def_use_mgr->NumUses(6), 1u);
+  EXPECT_EQ(def_use_mgr->NumUses(7), 2u);
+  std::vector<uint32_t> users_of_7;
+  def_use_mgr->ForEachUser(7, [&users_of_7](Instruction* user) {
+    users_of_7.push_back(user->result_id());
+  });
+  EXPECT_THAT(users_of_7, UnorderedElementsAre(9, 10));
+}
+
 TEST_F(IRContextTest, KillGroupDecorationWitNoDecorations) {
   const std::string text = R"(
                OpCapability Shader
@@ -830,6 +896,119 @@ OpFunctionEnd)";
   EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
 }
 
+TEST_F(IRContextTest, InvalidateAnalysesForFunction) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpFunction %1 None %2
+%4 = OpLabel
+OpReturn
+OpFunctionEnd
+%5 = OpFunction %1 None %2
+%6 = OpLabel
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+
+  ASSERT_TRUE(ctx->module()->begin() != ctx->module()->end());
+  Function* fn1 = &*ctx->module()->begin();
+  Function* fn2 = &*(++ctx->module()->begin());
+
+  ctx->GetDominatorAnalysis(fn1);
+  DominatorAnalysis* dom2 = ctx->GetDominatorAnalysis(fn2);
+
+  // Dropping the dominator information for |fn1| must leave the analysis
+  // valid, and must not touch the tree cached for |fn2|.
+  ctx->InvalidateAnalysesForFunction(fn1,
+                                     IRContext::kAnalysisDominatorAnalysis);
+  EXPECT_TRUE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
+  EXPECT_EQ(dom2, ctx->GetDominatorAnalysis(fn2));
+
+  // Analyses without per-function state fall back to module-wide
+  // invalidation.
+  ctx->BuildInvalidAnalyses(IRContext::kAnalysisDefUse);
+  ctx->InvalidateAnalysesForFunction(fn1, IRContext::kAnalysisDefUse);
+  EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisDefUse));
+}
+
+TEST_F(IRContextTest, ScopedPreservationKeepsUnmodifiedFunctions) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpFunction %1 None %2
+%4 = OpLabel
+OpReturn
+OpFunctionEnd
+%5 = OpFunction %1 None %2
+%6 = OpLabel
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+
+  Function* fn1 = &*ctx->module()->begin();
+  Function* fn2 = &*(++ctx->module()->begin());
+  ctx->GetDominatorAnalysis(fn1);
+  DominatorAnalysis* dom2 = ctx->GetDominatorAnalysis(fn2);
+  ctx->BuildInvalidAnalyses(IRContext::kAnalysisDefUse);
+
+  // A pass that declares per-function preservation and reports |fn1| as
+  // modified keeps the dominator analysis valid, dropping only the tree
+  // cached for |fn1|; analyses it does not preserve at all still go away.
+  NoopPassPreservesPerFunction pass(fn1);
+  Pass::Status s = pass.Run(ctx.get());
+  EXPECT_EQ(s, Pass::Status::SuccessWithChange);
+  EXPECT_TRUE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
+  EXPECT_EQ(dom2, ctx->GetDominatorAnalysis(fn2));
+  EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisDefUse));
+}
+
+TEST_F(IRContextTest, FreezeMaterializesAnalyses) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpFunction %1 None %2
+%4 = OpLabel
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+
+  EXPECT_FALSE(ctx->IsFrozen());
+  ctx->Freeze();
+  EXPECT_TRUE(ctx->IsFrozen());
+
+  // Everything a read-only query could need has been built up front, so
+  // const-style queries no longer construct analysis state lazily.
+  EXPECT_TRUE(ctx->AreAnalysesValid(
+      IRContext::kAnalysisDefUse | IRContext::kAnalysisInstrToBlockMapping |
+      IRContext::kAnalysisDecorations | IRContext::kAnalysisCFG |
+      IRContext::kAnalysisDominatorAnalysis | IRContext::kAnalysisNameMap |
+      IRContext::kAnalysisStructuredCFG | IRContext::kAnalysisIdToFuncMapping |
+      IRContext::kAnalysisConstants | IRContext::kAnalysisTypes));
+
+  Function* fn = &*ctx->module()->begin();
+  EXPECT_NE(nullptr, ctx->GetDominatorAnalysis(fn));
+  EXPECT_NE(nullptr, ctx->GetPostDominatorAnalysis(fn));
+  EXPECT_NE(nullptr, ctx->get_instr_block(4));
+}
+
 TEST_F(IRContextTest, AsanErrorTest) {
   std::string shader = R"(
                OpCapability Shader
@@ -1233,6 +1412,50 @@ INSTANTIATE_TEST_SUITE_P(
         TargetEnvCompareTestData{SPV_ENV_VULKAN_1_3, SPV_ENV_UNIVERSAL_1_5},
         TargetEnvCompareTestData{SPV_ENV_VULKAN_1_3, SPV_ENV_UNIVERSAL_1_6}));
 
+TEST_F(IRContextTest, KillCapabilityKeepsFeatureManagerCurrent) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Tessellation
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+)";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  EXPECT_TRUE(
+      context->get_feature_mgr()->HasCapability(spv::Capability::Shader));
+
+  auto find_capability = [&context](spv::Capability cap) -> Instruction* {
+    for (Instruction& inst : context->module()->capabilities()) {
+      if (inst.GetSingleWordInOperand(0) == static_cast<uint32_t>(cap)) {
+        return &inst;
+      }
+    }
+    return nullptr;
+  };
+
+  // Killing the explicit Shader declaration must keep Shader enabled: it is
+  // still implied by Tessellation.
+  Instruction* shader_decl = find_capability(spv::Capability::Shader);
+  ASSERT_NE(nullptr, shader_decl);
+  context->KillInst(shader_decl);
+  EXPECT_TRUE(
+      context->get_feature_mgr()->HasCapability(spv::Capability::Shader));
+  EXPECT_TRUE(context->get_feature_mgr()->HasCapability(
+      spv::Capability::Tessellation));
+
+  // Once Tessellation goes too, both disappear.
+  Instruction* tess_decl = find_capability(spv::Capability::Tessellation);
+  ASSERT_NE(nullptr, tess_decl);
+  context->KillInst(tess_decl);
+  EXPECT_FALSE(
+      context->get_feature_mgr()->HasCapability(spv::Capability::Shader));
+  EXPECT_FALSE(context->get_feature_mgr()->HasCapability(
+      spv::Capability::Tessellation));
+}
+
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -712,6 +712,292 @@ TEST_F(FusionPassTest, TooManyRegisters) {
   SinglePassRunAndMatch<LoopFusionPass>(text, true, 5);
 }
 
+/*
+Generated from the following GLSL + --eliminate-local-multi-store
+
+#version 440 core
+void main() {
+  int[10] a;
+  int[10] b;
+  for (int i = 0; i < 10; i++) {
+    a[i] = a[i]*2;
+  }
+  for (int i = 0; i < 10; i++) {
+    b[i] = a[i]+2;
+  }
+}
+
+The loops share the stream a[i], so the cost model considers fusion
+profitable and the loops are fused.
+*/
+TEST_F(FusionPassTest, CostModelSharedStreamFused) {
+  const std::string text = R"(
+; CHECK: OpPhi
+; CHECK: OpLoad
+; CHECK: OpStore
+; CHECK-NOT: OpPhi
+; CHECK: OpLoad
+; CHECK: OpStore
+
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource GLSL 440
+               OpName %4 "main"
+               OpName %8 "i"
+               OpName %23 "a"
+               OpName %34 "i"
+               OpName %42 "b"
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %9 = OpConstant %6 0
+         %16 = OpConstant %6 10
+         %17 = OpTypeBool
+         %19 = OpTypeInt 32 0
+         %20 = OpConstant %19 10
+         %21 = OpTypeArray %6 %20
+         %22 = OpTypePointer Function %21
+         %28 = OpConstant %6 2
+         %32 = OpConstant %6 1
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+          %8 = OpVariable %7 Function
+         %23 = OpVariable %22 Function
+         %34 = OpVariable %7 Function
+         %42 = OpVariable %22 Function
+               OpStore %8 %9
+               OpBranch %10
+         %10 = OpLabel
+         %51 = OpPhi %6 %9 %5 %33 %13
+               OpLoopMerge %12 %13 None
+               OpBranch %14
+         %14 = OpLabel
+         %18 = OpSLessThan %17 %51 %16
+               OpBranchConditional %18 %11 %12
+         %11 = OpLabel
+         %26 = OpAccessChain %7 %23 %51
+         %27 = OpLoad %6 %26
+         %29 = OpIMul %6 %27 %28
+         %30 = OpAccessChain %7 %23 %51
+               OpStore %30 %29
+               OpBranch %13
+         %13 = OpLabel
+         %33 = OpIAdd %6 %51 %32
+               OpStore %8 %33
+               OpBranch %10
+         %12 = OpLabel
+               OpStore %34 %9
+               OpBranch %35
+         %35 = OpLabel
+         %52 = OpPhi %6 %9 %12 %50 %38
+               OpLoopMerge %37 %38 None
+               OpBranch %39
+         %39 = OpLabel
+         %41 = OpSLessThan %17 %52 %16
+               OpBranchConditional %41 %36 %37
+         %36 = OpLabel
+         %45 = OpAccessChain %7 %23 %52
+         %46 = OpLoad %6 %45
+         %47 = OpIAdd %6 %46 %28
+         %48 = OpAccessChain %7 %42 %52
+               OpStore %48 %47
+               OpBranch %38
+         %38 = OpLabel
+         %50 = OpIAdd %6 %52 %32
+               OpStore %34 %50
+               OpBranch %35
+         %37 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  SinglePassRunAndMatch<LoopFusionPass>(text, true, 20, 8, 1);
+}
+
+/*
+As CostModelSharedStreamFused, but the second loop reads b[i] and writes
+c[i], so the loops share no access streams.  The cost model sees no reuse
+to exploit and the loops are not fused, even though fusion would be legal.
+*/
+TEST_F(FusionPassTest, CostModelDisjointStreamsNotFused) {
+  const std::string text = R"(
+; CHECK: OpLoopMerge
+; CHECK: OpLoopMerge
+
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource GLSL 440
+               OpName %4 "main"
+               OpName %8 "i"
+               OpName %23 "a"
+               OpName %34 "i"
+               OpName %42 "b"
+               OpName %53 "c"
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %9 = OpConstant %6 0
+         %16 = OpConstant %6 10
+         %17 = OpTypeBool
+         %19 = OpTypeInt 32 0
+         %20 = OpConstant %19 10
+         %21 = OpTypeArray %6 %20
+         %22 = OpTypePointer Function %21
+         %28 = OpConstant %6 2
+         %32 = OpConstant %6 1
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+          %8 = OpVariable %7 Function
+         %23 = OpVariable %22 Function
+         %34 = OpVariable %7 Function
+         %42 = OpVariable %22 Function
+         %53 = OpVariable %22 Function
+               OpStore %8 %9
+               OpBranch %10
+         %10 = OpLabel
+         %51 = OpPhi %6 %9 %5 %33 %13
+               OpLoopMerge %12 %13 None
+               OpBranch %14
+         %14 = OpLabel
+         %18 = OpSLessThan %17 %51 %16
+               OpBranchConditional %18 %11 %12
+         %11 = OpLabel
+         %26 = OpAccessChain %7 %23 %51
+         %27 = OpLoad %6 %26
+         %29 = OpIMul %6 %27 %28
+         %30 = OpAccessChain %7 %23 %51
+               OpStore %30 %29
+               OpBranch %13
+         %13 = OpLabel
+         %33 = OpIAdd %6 %51 %32
+               OpStore %8 %33
+               OpBranch %10
+         %12 = OpLabel
+               OpStore %34 %9
+               OpBranch %35
+         %35 = OpLabel
+         %52 = OpPhi %6 %9 %12 %50 %38
+               OpLoopMerge %37 %38 None
+               OpBranch %39
+         %39 = OpLabel
+         %41 = OpSLessThan %17 %52 %16
+               OpBranchConditional %41 %36 %37
+         %36 = OpLabel
+         %45 = OpAccessChain %7 %42 %52
+         %46 = OpLoad %6 %45
+         %47 = OpIAdd %6 %46 %28
+         %48 = OpAccessChain %7 %53 %52
+               OpStore %48 %47
+               OpBranch %38
+         %38 = OpLabel
+         %50 = OpIAdd %6 %52 %32
+               OpStore %34 %50
+               OpBranch %35
+         %37 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  SinglePassRunAndMatch<LoopFusionPass>(text, true, 20, 8, 1);
+}
+
+/*
+As CostModelSharedStreamFused, but the fused loop would touch two distinct
+streams while the footprint budget only allows one, so the loops are not
+fused.
+*/
+TEST_F(FusionPassTest, CostModelFootprintLimitNotFused) {
+  const std::string text = R"(
+; CHECK: OpLoopMerge
+; CHECK: OpLoopMerge
+
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource GLSL 440
+               OpName %4 "main"
+               OpName %8 "i"
+               OpName %23 "a"
+               OpName %34 "i"
+               OpName %42 "b"
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %9 = OpConstant %6 0
+         %16 = OpConstant %6 10
+         %17 = OpTypeBool
+         %19 = OpTypeInt 32 0
+         %20 = OpConstant %19 10
+         %21 = OpTypeArray %6 %20
+         %22 = OpTypePointer Function %21
+         %28 = OpConstant %6 2
+         %32 = OpConstant %6 1
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+          %8 = OpVariable %7 Function
+         %23 = OpVariable %22 Function
+         %34 = OpVariable %7 Function
+         %42 = OpVariable %22 Function
+               OpStore %8 %9
+               OpBranch %10
+         %10 = OpLabel
+         %51 = OpPhi %6 %9 %5 %33 %13
+               OpLoopMerge %12 %13 None
+               OpBranch %14
+         %14 = OpLabel
+         %18 = OpSLessThan %17 %51 %16
+               OpBranchConditional %18 %11 %12
+         %11 = OpLabel
+         %26 = OpAccessChain %7 %23 %51
+         %27 = OpLoad %6 %26
+         %29 = OpIMul %6 %27 %28
+         %30 = OpAccessChain %7 %23 %51
+               OpStore %30 %29
+               OpBranch %13
+         %13 = OpLabel
+         %33 = OpIAdd %6 %51 %32
+               OpStore %8 %33
+               OpBranch %10
+         %12 = OpLabel
+               OpStore %34 %9
+               OpBranch %35
+         %35 = OpLabel
+         %52 = OpPhi %6 %9 %12 %50 %38
+               OpLoopMerge %37 %38 None
+               OpBranch %39
+         %39 = OpLabel
+         %41 = OpSLessThan %17 %52 %16
+               OpBranchConditional %41 %36 %37
+         %36 = OpLabel
+         %45 = OpAccessChain %7 %23 %52
+         %46 = OpLoad %6 %45
+         %47 = OpIAdd %6 %46 %28
+         %48 = OpAccessChain %7 %42 %52
+               OpStore %48 %47
+               OpBranch %38
+         %38 = OpLabel
+         %50 = OpIAdd %6 %52 %32
+               OpStore %34 %50
+               OpBranch %35
+         %37 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  SinglePassRunAndMatch<LoopFusionPass>(text, true, 20, 1, 1);
+}
+
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -0,0 +1,296 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "source/opt/licm_pass.h"
+#include "test/opt/pass_fixture.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using PassClassTest = PassTest<::testing::Test>;
+
+/*
+  Tests for the LICM pass using the per-loop summaries to hoist loads of
+  variables that nothing in the loop can write.
+
+  Generated from the following GLSL fragment shader
+#version 440 core
+void main() {
+  int n = 10;
+  int s = 0;
+  for (int i = 0; i < 10; i++) {
+    s = n;
+  }
+}
+*/
+TEST_F(PassClassTest, HoistLoadOfVariableNotWrittenInLoop) {
+  const std::string before_hoist = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 440
+OpName %main "main"
+OpName %n "n"
+OpName %s "s"
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%_ptr_Function_int = OpTypePointer Function %int
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%bool = OpTypeBool
+%main = OpFunction %void None %6
+%13 = OpLabel
+%n = OpVariable %_ptr_Function_int Function
+%s = OpVariable %_ptr_Function_int Function
+OpStore %n %int_10
+OpStore %s %int_0
+OpBranch %14
+%14 = OpLabel
+%15 = OpPhi %int %int_0 %13 %16 %17
+OpLoopMerge %18 %17 None
+OpBranch %19
+%19 = OpLabel
+%20 = OpSLessThan %bool %15 %int_10
+OpBranchConditional %20 %21 %18
+%21 = OpLabel
+%22 = OpLoad %int %n
+OpStore %s %22
+OpBranch %17
+%17 = OpLabel
+%16 = OpIAdd %int %15 %int_1
+OpBranch %14
+%18 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  const std::string after_hoist = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 440
+OpName %main "main"
+OpName %n "n"
+OpName %s "s"
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%_ptr_Function_int = OpTypePointer Function %int
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%bool = OpTypeBool
+%main = OpFunction %void None %6
+%13 = OpLabel
+%n = OpVariable %_ptr_Function_int Function
+%s = OpVariable %_ptr_Function_int Function
+OpStore %n %int_10
+OpStore %s %int_0
+%22 = OpLoad %int %n
+OpBranch %14
+%14 = OpLabel
+%15 = OpPhi %int %int_0 %13 %16 %17
+OpLoopMerge %18 %17 None
+OpBranch %19
+%19 = OpLabel
+%20 = OpSLessThan %bool %15 %int_10
+OpBranchConditional %20 %21 %18
+%21 = OpLabel
+OpStore %s %22
+OpBranch %17
+%17 = OpLabel
+%16 = OpIAdd %int %15 %int_1
+OpBranch %14
+%18 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<LICMPass>(before_hoist, after_hoist, true);
+}
+
+/*
+  As above, but a function called inside the loop may write any variable, so
+  the load must stay in the loop.
+*/
+TEST_F(PassClassTest, DontHoistLoadPastFunctionCall) {
+  const std::string text = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 440
+OpName %main "main"
+OpName %n "n"
+OpName %s "s"
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%_ptr_Function_int = OpTypePointer Function %int
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%bool = OpTypeBool
+%main = OpFunction %void None %6
+%13 = OpLabel
+%n = OpVariable %_ptr_Function_int Function
+%s = OpVariable %_ptr_Function_int Function
+OpStore %n %int_10
+OpStore %s %int_0
+OpBranch %14
+%14 = OpLabel
+%15 = OpPhi %int %int_0 %13 %16 %17
+OpLoopMerge %18 %17 None
+OpBranch %19
+%19 = OpLabel
+%20 = OpSLessThan %bool %15 %int_10
+OpBranchConditional %20 %21 %18
+%21 = OpLabel
+%22 = OpFunctionCall %void %23
+%24 = OpLoad %int %n
+OpStore %s %24
+OpBranch %17
+%17 = OpLabel
+%16 = OpIAdd %int %15 %int_1
+OpBranch %14
+%18 = OpLabel
+OpReturn
+OpFunctionEnd
+%23 = OpFunction %void None %6
+%25 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<LICMPass>(text, text, true);
+}
+
+/*
+  As above, but the load is volatile and must not be moved even though
+  nothing in the loop writes the variable.
+*/
+TEST_F(PassClassTest, DontHoistVolatileLoad) {
+  const std::string text = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 440
+OpName %main "main"
+OpName %n "n"
+OpName %s "s"
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%_ptr_Function_int = OpTypePointer Function %int
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%bool = OpTypeBool
+%main = OpFunction %void None %6
+%13 = OpLabel
+%n = OpVariable %_ptr_Function_int Function
+%s = OpVariable %_ptr_Function_int Function
+OpStore %n %int_10
+OpStore %s %int_0
+OpBranch %14
+%14 = OpLabel
+%15 = OpPhi %int %int_0 %13 %16 %17
+OpLoopMerge %18 %17 None
+OpBranch %19
+%19 = OpLabel
+%20 = OpSLessThan %bool %15 %int_10
+OpBranchConditional %20 %21 %18
+%21 = OpLabel
+%22 = OpLoad %int %n Volatile
+OpStore %s %22
+OpBranch %17
+%17 = OpLabel
+%16 = OpIAdd %int %15 %int_1
+OpBranch %14
+%18 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<LICMPass>(text, text, true);
+}
+
+/*
+  As above, but the loop contains a GLSL.std.450 Modf that stores its
+  integral part through a pointer to the loaded variable, so the load must
+  stay in the loop.
+*/
+TEST_F(PassClassTest, DontHoistLoadOfVariableWrittenByModf) {
+  const std::string text = R"(OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpSource GLSL 440
+OpName %main "main"
+OpName %n "n"
+OpName %s "s"
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%_ptr_Function_float = OpTypePointer Function %float
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%float_0 = OpConstant %float 0
+%float_1_5 = OpConstant %float 1.5
+%bool = OpTypeBool
+%main = OpFunction %void None %6
+%13 = OpLabel
+%n = OpVariable %_ptr_Function_float Function
+%s = OpVariable %_ptr_Function_float Function
+OpStore %n %float_0
+OpStore %s %float_0
+OpBranch %14
+%14 = OpLabel
+%15 = OpPhi %int %int_0 %13 %16 %17
+OpLoopMerge %18 %17 None
+OpBranch %19
+%19 = OpLabel
+%20 = OpSLessThan %bool %15 %int_10
+OpBranchConditional %20 %21 %18
+%21 = OpLabel
+%22 = OpExtInst %float %1 Modf %float_1_5 %n
+%23 = OpLoad %float %n
+OpStore %s %23
+OpBranch %17
+%17 = OpLabel
+%16 = OpIAdd %int %15 %int_1
+OpBranch %14
+%18 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<LICMPass>(text, text, true);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
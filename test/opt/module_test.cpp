@@ -74,6 +74,90 @@ TEST(ModuleTest, ComputeIdBound) {
                 ->ComputeIdBound());
 }
 
+TEST(ModuleTest, ComputeContentHash) {
+  const std::string globals = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fn_ty = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%u1 = OpConstant %uint 1
+%u2 = OpConstant %uint 2
+)";
+  auto with_body = [&globals](const std::string& body) {
+    return globals + "%f = OpFunction %void None %fn_ty
+%entry = OpLabel
+" +
+           body + "OpReturn
+OpFunctionEnd
+";
+  };
+
+  const auto hash_a =
+      BuildModule(with_body("%sum = OpIAdd %uint %u1 %u1
+"))
+          ->module()
+          ->ComputeContentHash();
+  const auto hash_b =
+      BuildModule(with_body("%sum = OpIAdd %uint %u1 %u2
+"))
+          ->module()
+          ->ComputeContentHash();
+
+  // Only the function body differs, so the other sections hash equal.
+  EXPECT_EQ(hash_a.preamble, hash_b.preamble);
+  EXPECT_EQ(hash_a.debug_and_annotations, hash_b.debug_and_annotations);
+  EXPECT_EQ(hash_a.types_and_globals, hash_b.types_and_globals);
+  ASSERT_EQ(1u, hash_a.functions.size());
+  ASSERT_EQ(1u, hash_b.functions.size());
+  EXPECT_EQ(hash_a.functions.begin()->first, hash_b.functions.begin()->first);
+  EXPECT_NE(hash_a.functions.begin()->second,
+            hash_b.functions.begin()->second);
+  EXPECT_NE(hash_a.combined, hash_b.combined);
+
+  // Re-building the same text reproduces the same hashes.
+  const auto hash_c =
+      BuildModule(with_body("%sum = OpIAdd %uint %u1 %u1
+"))
+          ->module()
+          ->ComputeContentHash();
+  EXPECT_EQ(hash_a.combined, hash_c.combined);
+}
+
+TEST(ModuleTest, CloneInto) {
+  const std::string text = R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpName %7 "restrict"
+OpDecorate %8 Restrict
+%9 = OpTypeVoid
+%10 = OpTypeInt 32 0
+%12 = OpTypePointer Function %10
+%7 = OpTypeFunction %9
+%1 = OpFunction %9 None %7
+%2 = OpLabel
+%8 = OpVariable %12 Function
+%4 = OpLoad %10 %8
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> context = BuildModule(text);
+  IRContext clone_context(SPV_ENV_UNIVERSAL_1_1, nullptr);
+  context->module()->CloneInto(&clone_context);
+
+  // The clone assembles to the same binary as the original module.
+  std::vector<uint32_t> original_binary;
+  context->module()->ToBinary(&original_binary, false);
+  std::vector<uint32_t> clone_binary;
+  clone_context.module()->ToBinary(&clone_binary, false);
+  EXPECT_EQ(original_binary, clone_binary);
+
+  // The clone is independent of the original module.
+  clone_context.module()->SetIdBound(context->module()->IdBound() + 1);
+  EXPECT_NE(GetIdBound(*context->module()),
+            GetIdBound(*clone_context.module()));
+}
+
 TEST(ModuleTest, OstreamOperator) {
   const std::string text = R"(OpCapability Shader
 OpCapability Linkage
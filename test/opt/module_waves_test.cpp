@@ -0,0 +1,141 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/opt/module_waves.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using ::testing::HasSubstr;
+
+std::vector<uint32_t> Assemble(const std::string& text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary)) << text;
+  return binary;
+}
+
+std::string Disassemble(const std::vector<uint32_t>& binary) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  std::string text;
+  EXPECT_TRUE(tools.Disassemble(binary, &text));
+  return text;
+}
+
+const char* kTwoFunctionModule = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %1 "main"
+OpExecutionMode %1 LocalSize 1 1 1
+%void = OpTypeVoid
+%int = OpTypeInt 32 1
+%int_3 = OpConstant %int 3
+%6 = OpTypeFunction %void
+%7 = OpTypeFunction %int %int
+%1 = OpFunction %void None %6
+%8 = OpLabel
+%9 = OpFunctionCall %int %10 %int_3
+OpReturn
+OpFunctionEnd
+%10 = OpFunction %int None %7
+%11 = OpFunctionParameter %int
+%12 = OpLabel
+%13 = OpIAdd %int %11 %11
+OpReturnValue %13
+OpFunctionEnd
+)";
+
+TEST(ModuleWavesTest, UnoptimizedWavesRoundTrip) {
+  const std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleWaves waves;
+  ASSERT_TRUE(waves.Split(binary.data(), binary.size(), nullptr));
+  ASSERT_EQ(waves.function_count(), 2u);
+
+  // Accepting each single-function wave unchanged must reproduce the
+  // original module.
+  for (size_t i = 0; i < waves.function_count(); ++i) {
+    ASSERT_TRUE(waves.AcceptWaveBinary(waves.MakeWaveBinary(i, 1), nullptr));
+  }
+  EXPECT_EQ(waves.Finish(), binary);
+}
+
+TEST(ModuleWavesTest, WaveHoldsDeclarationsForOutOfWaveFunctions) {
+  const std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleWaves waves;
+  ASSERT_TRUE(waves.Split(binary.data(), binary.size(), nullptr));
+
+  // The wave holding only the entry point still declares the callee: its
+  // OpFunction and OpFunctionParameter remain, its body does not.
+  const std::string wave_text = Disassemble(waves.MakeWaveBinary(0, 1));
+  EXPECT_THAT(wave_text, HasSubstr("OpFunctionCall %int %10 %int_3"));
+  EXPECT_THAT(wave_text, HasSubstr("%10 = OpFunction %int None %7"));
+  EXPECT_THAT(wave_text, HasSubstr("%11 = OpFunctionParameter %int"));
+  EXPECT_THAT(wave_text, ::testing::Not(HasSubstr("OpIAdd")));
+}
+
+TEST(ModuleWavesTest, RejectsWaveMissingPinnedInstruction) {
+  const std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleWaves waves;
+  ASSERT_TRUE(waves.Split(binary.data(), binary.size(), nullptr));
+
+  // Drop the %int_3 constant from the wave's module-scope section, as a
+  // pass stripping unused globals would.
+  std::vector<uint32_t> wave = waves.MakeWaveBinary(0, 2);
+  const std::string wave_text = Disassemble(wave);
+  std::string without_constant = wave_text;
+  const std::string constant_line = "%int_3 = OpConstant %int 3\n";
+  const size_t pos = without_constant.find(constant_line);
+  ASSERT_NE(pos, std::string::npos);
+  without_constant.erase(pos, constant_line.size());
+
+  std::string error;
+  auto consumer = [&error](spv_message_level_t, const char*,
+                           const spv_position_t&, const char* message) {
+    error = message;
+  };
+  EXPECT_FALSE(waves.AcceptWaveBinary(Assemble(without_constant), consumer));
+  EXPECT_THAT(error, HasSubstr("pinned module-scope instruction"));
+}
+
+TEST(ModuleWavesTest, RejectsWaveMissingWindowFunction) {
+  const std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleWaves waves;
+  ASSERT_TRUE(waves.Split(binary.data(), binary.size(), nullptr));
+
+  // Feed the wave holding only the callee back as if a pass had removed the
+  // callee's body.
+  std::vector<uint32_t> wave_without_body = waves.MakeWaveBinary(0, 1);
+  waves.MakeWaveBinary(1, 1);
+
+  std::string error;
+  auto consumer = [&error](spv_message_level_t, const char*,
+                           const spv_position_t&, const char* message) {
+    error = message;
+  };
+  EXPECT_FALSE(waves.AcceptWaveBinary(wave_without_body, consumer));
+  EXPECT_THAT(error, HasSubstr("removed function"));
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
@@ -35,6 +35,128 @@ OpMemoryModel Logical GLSL450
 )";
 }
 
+TEST(Optimizer, OptimizeBatchProcessesEveryModule) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(8);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    ASSERT_TRUE(tools.Assemble(
+        Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid", &binaries[i]));
+  }
+
+  std::vector<std::vector<uint32_t>> optimized;
+  EXPECT_TRUE(OptimizeBatch(SPV_ENV_UNIVERSAL_1_0, {"--strip-debug"}, binaries,
+                            &optimized, nullptr, 4));
+  ASSERT_EQ(binaries.size(), optimized.size());
+  for (const auto& binary_out : optimized) {
+    std::string disassembly;
+    ASSERT_TRUE(
+        tools.Disassemble(binary_out.data(), binary_out.size(), &disassembly));
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+}
+
+TEST(Optimizer, OptimizeBatchReportsFailedModules) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(2);
+  ASSERT_TRUE(tools.Assemble(Header() + "%foo = OpTypeVoid", &binaries[0]));
+  binaries[1] = {0xdeadbeefu};  // Not a SPIR-V module.
+
+  std::vector<std::vector<uint32_t>> optimized;
+  EXPECT_FALSE(OptimizeBatch(SPV_ENV_UNIVERSAL_1_0, {"--strip-debug"},
+                             binaries, &optimized, nullptr, 2));
+  ASSERT_EQ(2u, optimized.size());
+  EXPECT_FALSE(optimized[0].empty());
+  EXPECT_TRUE(optimized[1].empty());
+}
+
+TEST(Optimizer, OptimizeBatchRoundTripsCompressedBinaries) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(tools.Assemble(
+      Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid", &binary));
+  std::vector<CompressedBinary> binaries(4, CompressedBinary(binary));
+
+  std::vector<CompressedBinary> optimized;
+  EXPECT_TRUE(OptimizeBatch(SPV_ENV_UNIVERSAL_1_0, {"--strip-debug"}, binaries,
+                            &optimized, nullptr, 2));
+  ASSERT_EQ(binaries.size(), optimized.size());
+  for (const auto& compressed : optimized) {
+    std::vector<uint32_t> words;
+    ASSERT_TRUE(compressed.Decompress(&words));
+    std::string disassembly;
+    ASSERT_TRUE(tools.Disassemble(words, &disassembly));
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+}
+
+TEST(Optimizer, ResultCacheServesRepeatedRuns) {
+  const std::string cache_dir = ::testing::TempDir();
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(tools.Assemble(
+      Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid", &binary));
+
+  std::vector<uint32_t> first;
+  {
+    Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+    opt.RegisterPass(CreateStripDebugInfoPass())
+        .SetResultCacheDirectory(cache_dir);
+    ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &first));
+  }
+
+  // A fresh optimizer with the same pipeline is served from the cache and
+  // must agree with the first run.
+  std::vector<uint32_t> second;
+  {
+    Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+    opt.RegisterPass(CreateStripDebugInfoPass())
+        .SetResultCacheDirectory(cache_dir);
+    ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &second));
+  }
+  EXPECT_THAT(second, Eq(first));
+  std::string disassembly;
+  ASSERT_TRUE(tools.Disassemble(second, &disassembly));
+  EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+
+  // A different pipeline over the same input must not hit the entry stored
+  // above: the null pass keeps the debug instructions.
+  std::vector<uint32_t> unstripped;
+  {
+    Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+    opt.RegisterPass(CreateNullPass()).SetResultCacheDirectory(cache_dir);
+    ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &unstripped));
+  }
+  ASSERT_TRUE(tools.Disassemble(unstripped, &disassembly));
+  EXPECT_THAT(disassembly,
+              Eq(Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid\n"));
+}
+
+TEST(Optimizer, EmitsModuleSummary) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(tools.Assemble(
+      Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid", &binary));
+
+  std::vector<uint32_t> optimized;
+  std::vector<uint32_t> summary;
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateStripDebugInfoPass()).SetEmitModuleSummary(&summary);
+  ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &optimized));
+
+  // Header() declares two capabilities, a memory model, a void type and no
+  // entry points; the OpName is stripped before the summary is taken.
+  ASSERT_EQ(9u, summary.size());
+  EXPECT_EQ(kModuleSummaryMagic, summary[0]);
+  EXPECT_EQ(kModuleSummaryVersion, summary[1]);
+  EXPECT_EQ(optimized[3], summary[2]);  // Id bound.
+  EXPECT_EQ(4u, summary[3]);            // Instruction count.
+  EXPECT_EQ(0u, summary[4]);            // No debug info.
+  EXPECT_EQ(2u, summary[5]);            // Capability count.
+  EXPECT_EQ(0u, summary[6]);            // Entry point count.
+  EXPECT_EQ(static_cast<uint32_t>(spv::Capability::Shader), summary[7]);
+  EXPECT_EQ(static_cast<uint32_t>(spv::Capability::Linkage), summary[8]);
+}
+
 TEST(Optimizer, CanRunNullPassWithDistinctInputOutputVectors) {
   SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
   std::vector<uint32_t> binary_in;
@@ -222,6 +344,45 @@ TEST(Optimizer, CanRegisterPassesFromFlags) {
 }
 
 
+TEST(Optimizer, PassPipelineConfiguresManyOptimizersFromOneParse) {
+  PassPipeline pipeline;
+  ASSERT_TRUE(pipeline.Parse({"--strip-debug", "--eliminate-dead-const"},
+                             nullptr));
+  EXPECT_EQ(pipeline.size(), 2u);
+
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary_in;
+  ASSERT_TRUE(tools.Assemble(
+      Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid", &binary_in));
+
+  // Pass objects are consumed by Run(), so each run gets a fresh Optimizer
+  // configured from the same parsed pipeline.
+  for (int i = 0; i < 2; ++i) {
+    Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+    pipeline.RegisterTo(&opt);
+    std::vector<uint32_t> binary_out;
+    ASSERT_TRUE(opt.Run(binary_in.data(), binary_in.size(), &binary_out));
+
+    std::string disassembly;
+    ASSERT_TRUE(
+        tools.Disassemble(binary_out.data(), binary_out.size(), &disassembly));
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+}
+
+TEST(Optimizer, PassPipelineRejectsInvalidFlagUpFront) {
+  std::string error;
+  auto consumer = [&error](spv_message_level_t, const char*,
+                           const spv_position_t&, const char* message) {
+    error = message;
+  };
+
+  PassPipeline pipeline;
+  EXPECT_FALSE(pipeline.Parse({"--strip-debug", "--no-such-pass"}, consumer));
+  EXPECT_THAT(error, ::testing::HasSubstr("no-such-pass"));
+  EXPECT_EQ(pipeline.size(), 0u);
+}
+
 TEST(Optimizer, RemoveNop) {
   // Test that OpNops are removed even if no optimizations are run.
   const std::string before = R"(OpCapability Shader
@@ -388,6 +549,65 @@ OpFunctionEnd
       << "Was expecting the result id of DebugScope to have been changed.";
 }
 
+std::string TwoEntryPointModule() {
+  return R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %1 "main1"
+OpEntryPoint GLCompute %2 "main2"
+OpExecutionMode %1 LocalSize 1 1 1
+OpExecutionMode %2 LocalSize 1 1 1
+%void = OpTypeVoid
+%4 = OpTypeFunction %void
+%1 = OpFunction %void None %4
+%5 = OpLabel
+OpReturn
+OpFunctionEnd
+%2 = OpFunction %void None %4
+%6 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+}
+
+TEST(Optimizer, RestrictToEntryPointsKeepsOnlyRequestedSlice) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(tools.Assemble(TwoEntryPointModule(), &binary));
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_1);
+  opt.RegisterPass(CreateNullPass());
+  opt.RestrictToEntryPoints({"main2"});
+  std::vector<uint32_t> optimized;
+  ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &optimized));
+
+  std::string disassembly;
+  ASSERT_TRUE(
+      tools.Disassemble(optimized.data(), optimized.size(), &disassembly));
+  EXPECT_THAT(disassembly, ::testing::HasSubstr("\"main2\""));
+  EXPECT_THAT(disassembly,
+              ::testing::Not(::testing::HasSubstr("\"main1\"")));
+
+  // The function of the removed entry point must be gone too.
+  size_t function_count = 0;
+  for (size_t pos = disassembly.find("OpFunctionEnd"); pos != std::string::npos;
+       pos = disassembly.find("OpFunctionEnd", pos + 1)) {
+    ++function_count;
+  }
+  EXPECT_EQ(1u, function_count);
+}
+
+TEST(Optimizer, RestrictToEntryPointsRejectsUnknownName) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  ASSERT_TRUE(tools.Assemble(TwoEntryPointModule(), &binary));
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_1);
+  opt.RegisterPass(CreateNullPass());
+  opt.RestrictToEntryPoints({"main3"});
+  std::vector<uint32_t> optimized;
+  EXPECT_FALSE(opt.Run(binary.data(), binary.size(), &optimized));
+}
+
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -186,6 +186,134 @@ TEST(PassManager, RecomputeIdBoundAutomatically) {
   EXPECT_THAT(GetIdBound(*context.module()), Eq(201u));
 }
 
+// A pass that counts how often it runs and never changes the module.
+class CountRunsPass : public Pass {
+ public:
+  explicit CountRunsPass(uint32_t* run_count) : run_count_(run_count) {}
+
+  const char* name() const override { return "CountRuns"; }
+  Status Process() override {
+    ++*run_count_;
+    return Status::SuccessWithoutChange;
+  }
+
+ private:
+  uint32_t* run_count_;
+};
+
+TEST(PassManager, SkipRedundantReruns) {
+  PassManager manager;
+  manager.SetSkipRedundantReruns(true);
+  std::unique_ptr<Module> module(new Module());
+  IRContext context(SPV_ENV_UNIVERSAL_1_2, std::move(module),
+                    manager.consumer());
+
+  // The second run would see the exact module the first run left untouched,
+  // so it is skipped.
+  uint32_t run_count = 0;
+  manager.AddPass(MakeUnique<CountRunsPass>(&run_count));
+  manager.AddPass(MakeUnique<CountRunsPass>(&run_count));
+  manager.Run(&context);
+  EXPECT_THAT(run_count, Eq(1u));
+
+  // A pass that changes the module in between makes the re-run meaningful
+  // again.
+  run_count = 0;
+  manager.AddPass(MakeUnique<CountRunsPass>(&run_count));
+  manager.AddPass<AppendOpNopPass>();
+  manager.AddPass(MakeUnique<CountRunsPass>(&run_count));
+  manager.Run(&context);
+  EXPECT_THAT(run_count, Eq(2u));
+}
+
+// A pass that counts its runs and declares it can only act on loops.
+class NeedsLoopsPass : public CountRunsPass {
+ public:
+  using CountRunsPass::CountRunsPass;
+  const char* name() const override { return "NeedsLoops"; }
+  uint32_t RequiredModuleTraits() const override {
+    return kTraitMaybeHasLoops;
+  }
+};
+
+TEST(PassManager, SkipsPassWhenRequiredTraitIsAbsent) {
+  // An empty module trivially has no loops, so the pass never runs.
+  PassManager manager;
+  std::unique_ptr<Module> module(new Module());
+  IRContext context(SPV_ENV_UNIVERSAL_1_2, std::move(module),
+                    manager.consumer());
+
+  uint32_t run_count = 0;
+  manager.AddPass(MakeUnique<NeedsLoopsPass>(&run_count));
+  EXPECT_THAT(manager.Run(&context), Eq(Pass::Status::SuccessWithoutChange));
+  EXPECT_THAT(run_count, Eq(0u));
+}
+
+TEST(PassManager, RunsPassWhenRequiredTraitIsPresent) {
+  const std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%false = OpConstantFalse %bool
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+OpBranch %header
+%header = OpLabel
+OpLoopMerge %merge %continue None
+OpBranch %body
+%body = OpLabel
+OpBranchConditional %false %merge %continue
+%continue = OpLabel
+OpBranch %header
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  ASSERT_NE(nullptr, context);
+
+  PassManager manager;
+  uint32_t run_count = 0;
+  manager.AddPass(MakeUnique<NeedsLoopsPass>(&run_count));
+  manager.Run(context.get());
+  EXPECT_THAT(run_count, Eq(1u));
+}
+
+TEST(PassManager, SpeculativePassRollsBackWhenCostGrows) {
+  PassManager manager;
+  manager.SetSpeculativePasses({"AppendOpNop"});
+  std::unique_ptr<Module> module(new Module());
+  IRContext context(SPV_ENV_UNIVERSAL_1_2, std::move(module),
+                    manager.consumer());
+
+  // Appending an OpNop grows the instruction count, so under the default
+  // cost metric the speculative run is rolled back and the pipeline
+  // reports no change.
+  manager.AddPass<AppendOpNopPass>();
+  EXPECT_THAT(manager.Run(&context), Eq(Pass::Status::SuccessWithoutChange));
+  EXPECT_THAT(context.module()->debug1_begin() ==
+                  context.module()->debug1_end(),
+              Eq(true));
+
+  // Under a cost metric that rewards more instructions, the same pass
+  // commits.
+  manager.SetSpeculativePasses({"AppendOpNop"});
+  manager.SetSpeculationCostFunction([](IRContext* c) {
+    uint64_t count = 0;
+    c->module()->ForEachInst([&count](Instruction*) { ++count; }, true);
+    return UINT64_MAX - count;
+  });
+  manager.AddPass<AppendOpNopPass>();
+  EXPECT_THAT(manager.Run(&context), Eq(Pass::Status::SuccessWithChange));
+  EXPECT_THAT(context.module()->debug1_begin() ==
+                  context.module()->debug1_end(),
+              Eq(false));
+}
+
 }  // anonymous namespace
 }  // namespace opt
 }  // namespace spvtools
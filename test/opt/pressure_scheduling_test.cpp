@@ -0,0 +1,155 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using PressureSchedulingTest = PassTest<::testing::Test>;
+
+TEST_F(PressureSchedulingTest, SinksComputationChainToFirstUse) {
+  // %b is defined early but first used by %c after the store; the whole pure
+  // chain %b -> %c should materialize contiguously before the final store.
+  const std::string text = R"(
+; CHECK: [[a:%\w+]] = OpLoad %int
+; CHECK-NEXT: OpStore {{%\w+}} [[a]]
+; CHECK-NEXT: [[b:%\w+]] = OpIAdd %int [[a]] %int_1
+; CHECK-NEXT: [[c:%\w+]] = OpIMul %int [[b]] [[b]]
+; CHECK-NEXT: OpStore {{%\w+}} [[c]]
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+      %int_1 = OpConstant %int 1
+        %ptr = OpTypePointer Function %int
+    %void_fn = OpTypeFunction %void
+       %main = OpFunction %void None %void_fn
+      %entry = OpLabel
+          %x = OpVariable %ptr Function
+          %y = OpVariable %ptr Function
+          %a = OpLoad %int %x
+          %b = OpIAdd %int %a %int_1
+               OpStore %x %a
+          %c = OpIMul %int %b %b
+               OpStore %y %c
+               OpReturn
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<PressureSchedulingPass>(text, true);
+}
+
+TEST_F(PressureSchedulingTest, KeepsMemoryOperationsInOrder) {
+  // The loads and stores must keep their relative order, and the pure add is
+  // already adjacent to its only use, so nothing changes.
+  const std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%int = OpTypeInt 32 1
+%ptr = OpTypePointer Function %int
+%void_fn = OpTypeFunction %void
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%x = OpVariable %ptr Function
+%y = OpVariable %ptr Function
+%a = OpLoad %int %x
+%sum = OpIAdd %int %a %a
+OpStore %x %sum
+%b = OpLoad %int %y
+OpStore %y %b
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<PressureSchedulingPass>(text, text, false, true);
+}
+
+TEST_F(PressureSchedulingTest, DoesNotSinkWhenTwoOperandsWouldStayLive) {
+  // Both %a and %b die at %t; sinking %t past the stores would keep two
+  // values live instead of one, so the block must stay as it is.
+  const std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%int = OpTypeInt 32 1
+%int_0 = OpConstant %int 0
+%ptr = OpTypePointer Function %int
+%void_fn = OpTypeFunction %void
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%x = OpVariable %ptr Function
+%y = OpVariable %ptr Function
+%a = OpLoad %int %x
+%b = OpLoad %int %y
+%t = OpIAdd %int %a %b
+OpStore %x %int_0
+OpStore %y %int_0
+OpStore %x %t
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndCheck<PressureSchedulingPass>(text, text, false, true);
+}
+
+TEST_F(PressureSchedulingTest, KeepsMergeInstructionSecondToLast) {
+  // The branch condition sinks to the bottom of the block, but never between
+  // the selection merge and the terminator.
+  const std::string text = R"(
+; CHECK: OpStore {{%\w+}} [[a:%\w+]]
+; CHECK-NEXT: [[cmp:%\w+]] = OpIEqual %bool [[a]] %int_0
+; CHECK-NEXT: OpSelectionMerge
+; CHECK-NEXT: OpBranchConditional [[cmp]]
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+       %void = OpTypeVoid
+        %int = OpTypeInt 32 1
+       %bool = OpTypeBool
+      %int_0 = OpConstant %int 0
+        %ptr = OpTypePointer Function %int
+    %void_fn = OpTypeFunction %void
+       %main = OpFunction %void None %void_fn
+      %entry = OpLabel
+          %x = OpVariable %ptr Function
+          %y = OpVariable %ptr Function
+          %a = OpLoad %int %x
+        %cmp = OpIEqual %bool %a %int_0
+               OpStore %y %a
+               OpSelectionMerge %merge None
+               OpBranchConditional %cmp %then %merge
+       %then = OpLabel
+               OpBranch %merge
+      %merge = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<PressureSchedulingPass>(text, true);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
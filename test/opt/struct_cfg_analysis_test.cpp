@@ -1525,6 +1525,45 @@ TEST_F(StructCFGAnalysisTest, SingleBlockLoop) {
 
   EXPECT_TRUE(analysis.IsInContinueConstruct(3));
 }
+
+TEST_F(StructCFGAnalysisTest, InvalidateFunction) {
+  const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+%void = OpTypeVoid
+%bool = OpTypeBool
+%bool_undef = OpUndef %bool
+%void_func = OpTypeFunction %void
+%main = OpFunction %void None %void_func
+%1 = OpLabel
+OpSelectionMerge %3 None
+OpBranchConditional %bool_undef %2 %3
+%2 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+
+  StructuredCFGAnalysis analysis(context.get());
+
+  EXPECT_EQ(analysis.ContainingConstruct(2), 1);
+  EXPECT_TRUE(analysis.IsMergeBlock(3));
+
+  // Remove the selection construct, and invalidate the function.  The
+  // analysis must pick up the new structure when it is queried again.
+  Function* func = &*context->module()->begin();
+  context->KillInst(func->begin()->GetMergeInst());
+  analysis.InvalidateFunction(func);
+
+  EXPECT_EQ(analysis.ContainingConstruct(2), 0);
+  EXPECT_FALSE(analysis.IsMergeBlock(3));
+}
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -0,0 +1,275 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "test/opt/pass_fixture.h"
+#include "test/opt/pass_utils.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+using TailMergeTest = PassTest<::testing::Test>;
+
+TEST_F(TailMergeTest, MergesIdenticalSwitchCaseTails) {
+  // Both switch cases end in the same store-and-return tail; the second
+  // case must be redirected to the first and its block removed.
+  const std::string text = R"(
+; CHECK: OpSwitch {{%\w+}} {{%\w+}} 0 [[tail:%\w+]] 1 [[tail]]
+; CHECK: [[tail]] = OpLabel
+; CHECK-NEXT: OpStore
+; CHECK-NEXT: OpReturn
+; CHECK-NOT: OpStore
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%ld = OpLoad %uint %var
+OpSelectionMerge %merge None
+OpSwitch %ld %merge 0 %case0 1 %case1
+%case0 = OpLabel
+OpStore %var %uint_1
+OpReturn
+%case1 = OpLabel
+OpStore %var %uint_1
+OpReturn
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+TEST_F(TailMergeTest, MergesValueTailsWithDifferentIds) {
+  // The tails define their own result ids, so they only match once the ids
+  // are paired up positionally.
+  const std::string text = R"(
+; CHECK: OpSwitch {{%\w+}} {{%\w+}} 0 [[tail:%\w+]] 1 [[tail]]
+; CHECK: [[tail]] = OpLabel
+; CHECK-NEXT: [[sum:%\w+]] = OpIAdd
+; CHECK-NEXT: OpReturnValue [[sum]]
+; CHECK-NOT: OpIAdd
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%uint_fn = OpTypeFunction %uint %uint
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+%helper = OpFunction %uint None %uint_fn
+%param = OpFunctionParameter %uint
+%hentry = OpLabel
+OpSelectionMerge %hmerge None
+OpSwitch %param %hmerge 0 %h0 1 %h1
+%h0 = OpLabel
+%sum0 = OpIAdd %uint %param %uint_1
+OpReturnValue %sum0
+%h1 = OpLabel
+%sum1 = OpIAdd %uint %param %uint_1
+OpReturnValue %sum1
+%hmerge = OpLabel
+OpReturnValue %uint_0
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+TEST_F(TailMergeTest, DoesNotMergeAcrossConstructs) {
+  // The first tail is inside the selection construct and the second is at
+  // function level; redirecting a branch between them would jump out of
+  // the construct, so both tails must survive.
+  const std::string text = R"(
+; CHECK: OpStore
+; CHECK: OpReturn
+; CHECK: OpStore
+; CHECK: OpReturn
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%ld = OpLoad %uint %var
+%cond = OpIEqual %bool %ld %uint_0
+OpSelectionMerge %merge None
+OpBranchConditional %cond %then %merge
+%then = OpLabel
+OpStore %var %uint_1
+OpReturn
+%merge = OpLabel
+OpBranch %tail
+%tail = OpLabel
+OpStore %var %uint_1
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+TEST_F(TailMergeTest, DoesNotMergeTailWithNamedValue) {
+  // %sum0 is referenced by an OpName outside its block, so its tail is
+  // conservatively kept as-is.
+  const std::string text = R"(
+; CHECK: OpIAdd
+; CHECK: OpIAdd
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+OpName %sum0 "sum0"
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%uint_fn = OpTypeFunction %uint %uint
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+%helper = OpFunction %uint None %uint_fn
+%param = OpFunctionParameter %uint
+%hentry = OpLabel
+OpSelectionMerge %hmerge None
+OpSwitch %param %hmerge 0 %h0 1 %h1
+%h0 = OpLabel
+%sum0 = OpIAdd %uint %param %uint_1
+OpReturnValue %sum0
+%h1 = OpLabel
+%sum1 = OpIAdd %uint %param %uint_1
+OpReturnValue %sum1
+%hmerge = OpLabel
+OpReturnValue %uint_0
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+TEST_F(TailMergeTest, MergesBothArmsOfConditionalBeforeSpirv16) {
+  // Before SPIR-V 1.6 a conditional branch may name the same label as both
+  // targets, so identical then/else tails may be merged.
+  const std::string text = R"(
+; CHECK: OpBranchConditional {{%\w+}} [[tail:%\w+]] [[tail]]
+; CHECK: [[tail]] = OpLabel
+; CHECK-NEXT: OpStore
+; CHECK-NEXT: OpReturn
+; CHECK-NOT: OpStore
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%ld = OpLoad %uint %var
+%cond = OpIEqual %bool %ld %uint_0
+OpSelectionMerge %merge None
+OpBranchConditional %cond %then %else
+%then = OpLabel
+OpStore %var %uint_1
+OpReturn
+%else = OpLabel
+OpStore %var %uint_1
+OpReturn
+%merge = OpLabel
+OpUnreachable
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+TEST_F(TailMergeTest, DoesNotCreateIdenticalConditionalTargetsInSpirv16) {
+  // From SPIR-V 1.6 on, OpBranchConditional must name two different
+  // labels, so merging one arm of the if into the other would make the
+  // module invalid; both tails must survive.
+  const std::string text = R"(
+; CHECK: OpBranchConditional {{%\w+}} [[then:%\w+]] [[else:%\w+]]
+; CHECK: [[then]] = OpLabel
+; CHECK-NEXT: OpStore
+; CHECK-NEXT: OpReturn
+; CHECK: [[else]] = OpLabel
+; CHECK-NEXT: OpStore
+; CHECK-NEXT: OpReturn
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint GLCompute %main "main"
+OpExecutionMode %main LocalSize 1 1 1
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%bool = OpTypeBool
+%uint = OpTypeInt 32 0
+%uint_0 = OpConstant %uint 0
+%uint_1 = OpConstant %uint 1
+%ptr = OpTypePointer Private %uint
+%var = OpVariable %ptr Private
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+%ld = OpLoad %uint %var
+%cond = OpIEqual %bool %ld %uint_0
+OpSelectionMerge %merge None
+OpBranchConditional %cond %then %else
+%then = OpLabel
+OpStore %var %uint_1
+OpReturn
+%else = OpLabel
+OpStore %var %uint_1
+OpReturn
+%merge = OpLabel
+OpUnreachable
+OpFunctionEnd
+)";
+
+  SetTargetEnv(SPV_ENV_UNIVERSAL_1_6);
+  SinglePassRunAndMatch<TailMergePass>(text, true);
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
 
 #include "gmock/gmock.h"
@@ -826,6 +827,46 @@ TEST_F(ValueTableTest, DifferentDebugDeclareSameValue) {
   EXPECT_EQ(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
 }
 
+TEST_F(ValueTableTest, NewInstructionNumberedOnInsertion) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Function %5
+          %2 = OpFunction %3 None %4
+          %7 = OpLabel
+          %8 = OpVariable %6 Function
+          %9 = OpLoad %5 %8
+         %10 = OpFAdd %5 %9 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  ValueNumberTable* vtable = context->GetValueNumberTable();
+  Instruction* add = context->get_def_use_mgr()->GetDef(10);
+
+  // Inserting a copy of the add and registering it with the context must
+  // number it without rebuilding the table, and it must get the same value
+  // number as the instruction it copies.
+  Instruction* new_add = add->Clone(context.get());
+  new_add->SetResultId(context->TakeNextId());
+  add->InsertBefore(std::unique_ptr<Instruction>(new_add));
+  context->AnalyzeDefUse(new_add);
+
+  EXPECT_TRUE(context->AreAnalysesValid(IRContext::kAnalysisValueNumberTable));
+  EXPECT_EQ(vtable, context->GetValueNumberTable());
+  uint32_t value = vtable->GetValueNumber(new_add);
+  EXPECT_NE(value, 0u);
+  EXPECT_EQ(value, vtable->GetValueNumber(add));
+  EXPECT_LT(value, vtable->NumValueNumbers());
+}
+
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
@@ -132,6 +132,14 @@ TEST(ParseUnsignedIntegers, Sample) {
   EXPECT_FALSE(ParseNumber("-1", &u32));
 }
 
+TEST(ParseUnsignedIntegers, LeadingZeroIsOctal) {
+  uint32_t u32;
+  EXPECT_TRUE(ParseNumber("010", &u32));
+  EXPECT_EQ(8u, u32);
+  EXPECT_TRUE(ParseNumber("0x0010", &u32));
+  EXPECT_EQ(16u, u32);
+}
+
 TEST(ParseWideSignedIntegers, Sample) {
   int64_t i64;
   EXPECT_FALSE(ParseNumber(nullptr, &i64));
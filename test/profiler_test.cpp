@@ -0,0 +1,102 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "source/util/profiler.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+// Splits the collapsed-stack |report| into its stack names, dropping the
+// tick counts.
+std::vector<std::string> StackNames(const std::string& report) {
+  std::vector<std::string> names;
+  std::istringstream lines(report);
+  std::string line;
+  while (std::getline(lines, line)) {
+    names.push_back(line.substr(0, line.rfind(' ')));
+  }
+  return names;
+}
+
+TEST(ProfilerTest, CollapsedStacksFollowScopeNesting) {
+  Profiler& profiler = Profiler::Get();
+  profiler.Reset();
+  profiler.Enable();
+  {
+    SPIRV_PROFILE_SCOPED("outer");
+    {
+      SPIRV_PROFILE_SCOPED("inner");
+    }
+    {
+      SPIRV_PROFILE_SCOPED("inner");
+    }
+  }
+  {
+    SPIRV_PROFILE_SCOPED("other");
+  }
+  profiler.Disable();
+
+  std::ostringstream report;
+  profiler.Write(&report);
+  profiler.Reset();
+
+  // The two "inner" scopes collapse into one stack, and the report is
+  // sorted by stack name.
+  EXPECT_EQ(StackNames(report.str()),
+            std::vector<std::string>({"other", "outer", "outer;inner"}));
+}
+
+TEST(ProfilerTest, TickCountsParseAsNumbers) {
+  Profiler& profiler = Profiler::Get();
+  profiler.Reset();
+  profiler.Enable();
+  {
+    SPIRV_PROFILE_SCOPED("scope");
+  }
+  profiler.Disable();
+
+  std::ostringstream report;
+  profiler.Write(&report);
+  profiler.Reset();
+
+  std::istringstream line(report.str());
+  std::string name;
+  uint64_t ticks = 0;
+  line >> name >> ticks;
+  EXPECT_EQ(name, "scope");
+  EXPECT_FALSE(line.fail());
+}
+
+TEST(ProfilerTest, RecordsNothingWhileDisabled) {
+  Profiler& profiler = Profiler::Get();
+  profiler.Reset();
+  profiler.Disable();
+  {
+    SPIRV_PROFILE_SCOPED("ignored");
+  }
+
+  std::ostringstream report;
+  profiler.Write(&report);
+  EXPECT_TRUE(report.str().empty());
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
@@ -558,6 +558,74 @@ TEST(ReducerTest, ShaderReduceWhileDivReachable) {
   ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
 }
 
+TEST(ReducerTest, ParallelReductionMatchesSerialReduction) {
+  // The outcome of a reduction must not depend on how many candidate steps
+  // are evaluated concurrently, as long as the interestingness function is a
+  // pure function of the binary, which InterestingWhileIMulReachable is.
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+  ASSERT_TRUE(
+      t.Assemble(kShaderWithLoopsDivAndMul, &binary_in, kReduceAssembleOption));
+
+  auto reduce = [&binary_in](uint32_t parallelism,
+                             std::vector<uint32_t>* binary_out) {
+    Reducer reducer(kEnv);
+    reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+    reducer.AddDefaultReductionPasses();
+    reducer.SetMessageConsumer(kMessageConsumer);
+
+    spvtools::ReducerOptions reducer_options;
+    reducer_options.set_step_limit(500);
+    reducer_options.set_fail_on_validation_error(true);
+    reducer_options.set_parallelism(parallelism);
+    spvtools::ValidatorOptions validator_options;
+
+    return reducer.Run(binary_in, binary_out, reducer_options,
+                       validator_options);
+  };
+
+  std::vector<uint32_t> serial_binary;
+  ASSERT_EQ(Reducer::ReductionResultStatus::kComplete,
+            reduce(1, &serial_binary));
+
+  std::vector<uint32_t> parallel_binary;
+  ASSERT_EQ(Reducer::ReductionResultStatus::kComplete,
+            reduce(4, &parallel_binary));
+
+  ASSERT_EQ(serial_binary, parallel_binary);
+}
+
+TEST(ReducerTest, HierarchicalReductionReachesAnInterestingFixedPoint) {
+  // Hierarchical reduction takes a different route through the search space
+  // - functions first, then blocks, then everything - but must still end on
+  // an interesting binary that no pass can reduce further.
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+  ASSERT_TRUE(
+      t.Assemble(kShaderWithLoopsDivAndMul, &binary_in, kReduceAssembleOption));
+
+  Reducer reducer(kEnv);
+  reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  reducer.AddDefaultReductionPasses();
+  reducer.SetMessageConsumer(kMessageConsumer);
+
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+  reducer_options.set_hierarchical_reduction(true);
+  spvtools::ValidatorOptions validator_options;
+
+  std::vector<uint32_t> binary_out;
+  Reducer::ReductionResultStatus status =
+      reducer.Run(std::move(binary_in), &binary_out, reducer_options,
+                  validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+
+  // The result must still satisfy the interestingness test.
+  ASSERT_TRUE(InterestingWhileIMulReachable(binary_out, 0));
+}
+
 // Computes an instruction count for each function in the module represented by
 // |binary|.
 std::unordered_map<uint32_t, uint32_t> GetFunctionInstructionCount(
@@ -622,6 +690,71 @@ TEST(ReducerTest, SingleFunctionReduction) {
   ASSERT_EQ(5, final_instruction_count.at(13));
 }
 
+TEST(ReducerTest, UninterestingStateIsNeverTestedTwice) {
+  // As passes revisit the same module at different granularities, they often
+  // regenerate states that an earlier path already proved uninteresting.
+  // The tested-state cache must keep such repeats away from the
+  // interestingness function.
+  std::string original = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeFloat 32
+          %7 = OpConstant %6 1
+          %8 = OpConstant %6 2
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+         %10 = OpFAdd %6 %7 %8
+         %11 = OpFMul %6 %10 %7
+         %12 = OpFSub %6 %11 %8
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  Reducer reducer(kEnv);
+  reducer.SetMessageConsumer(kMessageConsumer);
+  std::vector<std::vector<uint32_t>> tested;
+  uint32_t invocations = 0;
+  reducer.SetInterestingnessFunction(
+      [&tested, &invocations](const std::vector<uint32_t>& binary,
+                              uint32_t) -> bool {
+        // The first invocation checks the initial state, which must be
+        // interesting; everything after that is rejected and recorded.
+        if (invocations++ == 0) {
+          return true;
+        }
+        tested.push_back(binary);
+        return false;
+      });
+  reducer.AddDefaultReductionPasses();
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+
+  ASSERT_TRUE(t.Assemble(original, &binary_in, kReduceAssembleOption));
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+  spvtools::ValidatorOptions validator_options;
+
+  Reducer::ReductionResultStatus status = reducer.Run(
+      std::move(binary_in), &binary_out, reducer_options, validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+
+  for (size_t i = 0; i < tested.size(); ++i) {
+    for (size_t j = i + 1; j < tested.size(); ++j) {
+      ASSERT_NE(tested[i], tested[j])
+          << "states " << i << " and " << j << " are identical";
+    }
+  }
+}
+
 }  // namespace
 }  // namespace reduce
 }  // namespace spvtools
@@ -0,0 +1,109 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "source/latest_version_spirv_header.h"
+#include "spirv-tools/reflection.hpp"
+#include "test/test_fixture.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace {
+
+using ReflectionTest = spvtest::TextToBinaryTestBase<::testing::Test>;
+
+TEST_F(ReflectionTest, EntryPointsAndBindings) {
+  const std::string text = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main" %in_var
+               OpExecutionMode %main LocalSize 8 4 1
+               OpDecorate %in_var Location 2
+               OpDecorate %buf_var DescriptorSet 1
+               OpDecorate %buf_var Binding 3
+       %void = OpTypeVoid
+     %voidfn = OpTypeFunction %void
+      %float = OpTypeFloat 32
+     %ptr_in = OpTypePointer Input %float
+    %ptr_buf = OpTypePointer StorageBuffer %float
+     %in_var = OpVariable %ptr_in Input
+    %buf_var = OpVariable %ptr_buf StorageBuffer
+       %main = OpFunction %void None %voidfn
+      %entry = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+  const auto words = CompileSuccessfully(text, SPV_ENV_UNIVERSAL_1_3);
+  Context context(SPV_ENV_UNIVERSAL_1_3);
+  ReflectionInfo info;
+  ASSERT_EQ(GetReflectionInfo(context, words.data(), words.size(), &info),
+            SPV_SUCCESS);
+
+  EXPECT_NE(info.version, 0u);
+  EXPECT_NE(info.id_bound, 0u);
+
+  ASSERT_EQ(info.entry_points.size(), 1u);
+  const ReflectedEntryPoint& entry_point = info.entry_points[0];
+  EXPECT_EQ(entry_point.execution_model,
+            uint32_t(spv::ExecutionModel::GLCompute));
+  EXPECT_EQ(entry_point.name, "main");
+  EXPECT_EQ(entry_point.local_size[0], 8u);
+  EXPECT_EQ(entry_point.local_size[1], 4u);
+  EXPECT_EQ(entry_point.local_size[2], 1u);
+  ASSERT_EQ(entry_point.interface_ids.size(), 1u);
+
+  ASSERT_EQ(info.variables.size(), 2u);
+  const ReflectedVariable* in_var = nullptr;
+  const ReflectedVariable* buf_var = nullptr;
+  for (const ReflectedVariable& variable : info.variables) {
+    if (variable.storage_class == uint32_t(spv::StorageClass::Input)) {
+      in_var = &variable;
+    } else {
+      buf_var = &variable;
+    }
+  }
+  ASSERT_NE(in_var, nullptr);
+  EXPECT_EQ(in_var->id, entry_point.interface_ids[0]);
+  EXPECT_EQ(in_var->location, 2u);
+  EXPECT_EQ(in_var->descriptor_set, kReflectionUnset);
+  EXPECT_EQ(in_var->binding, kReflectionUnset);
+
+  ASSERT_NE(buf_var, nullptr);
+  EXPECT_EQ(buf_var->storage_class, uint32_t(spv::StorageClass::StorageBuffer));
+  EXPECT_EQ(buf_var->descriptor_set, 1u);
+  EXPECT_EQ(buf_var->binding, 3u);
+  EXPECT_EQ(buf_var->location, kReflectionUnset);
+}
+
+TEST_F(ReflectionTest, ModuleWithoutEntryPoints) {
+  const std::string text = R"(
+               OpCapability Kernel
+               OpCapability Linkage
+               OpMemoryModel Logical OpenCL
+)";
+
+  const auto words = CompileSuccessfully(text, SPV_ENV_UNIVERSAL_1_3);
+  Context context(SPV_ENV_UNIVERSAL_1_3);
+  ReflectionInfo info;
+  ASSERT_EQ(GetReflectionInfo(context, words.data(), words.size(), &info),
+            SPV_SUCCESS);
+  EXPECT_TRUE(info.entry_points.empty());
+  EXPECT_TRUE(info.variables.empty());
+}
+
+}  // namespace
+}  // namespace spvtools
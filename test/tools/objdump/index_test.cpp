@@ -0,0 +1,136 @@
+// Copyright (c) 2023 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/objdump/index.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "source/opt/build_module.h"
+#include "source/opt/ir_context.h"
+#include "spirv-tools/libspirv.hpp"
+#include "tools/util/cli_consumer.h"
+
+namespace {
+
+constexpr auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_6;
+
+std::vector<uint32_t> Assemble(const std::string& spv_source) {
+  std::unique_ptr<spvtools::opt::IRContext> ctx = spvtools::BuildModule(
+      kDefaultEnvironment, spvtools::utils::CLIMessageConsumer, spv_source,
+      spvtools::SpirvTools::kDefaultAssembleOption |
+          SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  std::vector<uint32_t> binary;
+  ctx->module()->ToBinary(&binary, /* skip_nop = */ false);
+  return binary;
+}
+
+const char kTwoFunctionModule[] = R"(
+      OpCapability Shader
+      OpMemoryModel Logical GLSL450
+      OpEntryPoint GLCompute %1 "compute_1"
+      OpExecutionMode %1 LocalSize 1 1 1
+ %3 = OpTypeVoid
+ %4 = OpTypeFunction %3
+ %1 = OpFunction %3 None %4
+ %5 = OpLabel
+      OpReturn
+      OpFunctionEnd
+ %6 = OpFunction %3 None %4
+ %7 = OpLabel
+      OpReturn
+      OpFunctionEnd
+)";
+
+}  // namespace
+
+TEST(ObjdumpIndexTest, IndexesFunctionsAndEntryPoints) {
+  std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleIndex index;
+  ASSERT_TRUE(BuildModuleIndex(binary, &index));
+
+  EXPECT_EQ(index.id_bound, 8u);
+  ASSERT_EQ(index.entry_points.size(), 1u);
+  EXPECT_EQ(index.entry_points[0].function_id, 1u);
+  EXPECT_EQ(index.entry_points[0].name, "compute_1");
+
+  ASSERT_EQ(index.functions.size(), 2u);
+  EXPECT_EQ(index.functions[0].id, 1u);
+  EXPECT_EQ(index.functions[1].id, 6u);
+
+  // The preamble starts right after the header and runs up to the first
+  // function; the functions tile the rest of the binary.
+  EXPECT_EQ(index.globals_byte_offset, 20u);
+  EXPECT_EQ(index.globals_byte_offset + index.globals_byte_size,
+            index.functions[0].byte_offset);
+  EXPECT_EQ(index.functions[0].byte_offset + index.functions[0].byte_size,
+            index.functions[1].byte_offset);
+  EXPECT_EQ(index.functions[1].byte_offset + index.functions[1].byte_size,
+            binary.size() * 4u);
+}
+
+TEST(ObjdumpIndexTest, SerializationRoundTrip) {
+  std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleIndex index;
+  ASSERT_TRUE(BuildModuleIndex(binary, &index));
+
+  ModuleIndex reloaded;
+  ASSERT_TRUE(DeserializeModuleIndex(SerializeModuleIndex(index), &reloaded));
+
+  EXPECT_EQ(reloaded.id_bound, index.id_bound);
+  EXPECT_EQ(reloaded.globals_byte_offset, index.globals_byte_offset);
+  EXPECT_EQ(reloaded.globals_byte_size, index.globals_byte_size);
+  ASSERT_EQ(reloaded.entry_points.size(), index.entry_points.size());
+  EXPECT_EQ(reloaded.entry_points[0].name, index.entry_points[0].name);
+  ASSERT_EQ(reloaded.functions.size(), index.functions.size());
+  for (size_t i = 0; i < index.functions.size(); ++i) {
+    EXPECT_EQ(reloaded.functions[i].id, index.functions[i].id);
+    EXPECT_EQ(reloaded.functions[i].byte_offset,
+              index.functions[i].byte_offset);
+    EXPECT_EQ(reloaded.functions[i].byte_size, index.functions[i].byte_size);
+  }
+}
+
+TEST(ObjdumpIndexTest, ExtractedFunctionDisassembles) {
+  std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleIndex index;
+  ASSERT_TRUE(BuildModuleIndex(binary, &index));
+
+  std::vector<uint32_t> function_binary;
+  ASSERT_TRUE(ExtractFunctionBinary(binary, index, 6u, &function_binary));
+
+  spvtools::SpirvTools tools(kDefaultEnvironment);
+  tools.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+  std::string disassembly;
+  ASSERT_TRUE(tools.Disassemble(function_binary, &disassembly,
+                                SPV_BINARY_TO_TEXT_OPTION_NO_COLOR));
+
+  EXPECT_NE(disassembly.find("%6 = OpFunction"), std::string::npos);
+  EXPECT_EQ(disassembly.find("%1 = OpFunction"), std::string::npos);
+}
+
+TEST(ObjdumpIndexTest, UnknownFunctionIdFails) {
+  std::vector<uint32_t> binary = Assemble(kTwoFunctionModule);
+
+  ModuleIndex index;
+  ASSERT_TRUE(BuildModuleIndex(binary, &index));
+
+  std::vector<uint32_t> function_binary;
+  EXPECT_FALSE(ExtractFunctionBinary(binary, index, 42u, &function_binary));
+}
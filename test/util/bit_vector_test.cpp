@@ -147,6 +147,52 @@ TEST(BitVectorTest, ResizingOrTest) {
   EXPECT_TRUE(bvec1.Get(10000));
 }
 
+TEST(BitVectorTest, Empty) {
+  BitVector bvec;
+  EXPECT_TRUE(bvec.Empty());
+
+  // A bit far past the initial size exercises the summary maintenance in the
+  // resizing code.
+  bvec.Set(100000);
+  EXPECT_FALSE(bvec.Empty());
+
+  // Clearing the only set bit must clear the summary as well.
+  bvec.Clear(100000);
+  EXPECT_TRUE(bvec.Empty());
+}
+
+TEST(BitVectorTest, ForEachSetBit) {
+  BitVector bvec;
+
+  // Use a sparse pattern so whole summary blocks are empty.
+  std::vector<uint32_t> expected;
+  for (int i = 3; i < 1000000; i *= 7) {
+    bvec.Set(i);
+    expected.push_back(i);
+  }
+
+  // The callback must see every set bit, in increasing order.
+  std::vector<uint32_t> visited;
+  bvec.ForEachSetBit([&visited](uint32_t i) { visited.push_back(i); });
+  EXPECT_EQ(visited, expected);
+}
+
+TEST(BitVectorTest, ForEachSetBitAfterOr) {
+  BitVector bvec1;
+  bvec1.Set(3);
+
+  BitVector bvec2;
+  bvec2.Set(64);
+  bvec2.Set(10000);
+
+  // Bits merged in by |Or|, including those in newly appended words, must be
+  // visited too.
+  EXPECT_TRUE(bvec1.Or(bvec2));
+  std::vector<uint32_t> visited;
+  bvec1.ForEachSetBit([&visited](uint32_t i) { visited.push_back(i); });
+  EXPECT_EQ(visited, std::vector<uint32_t>({3, 64, 10000}));
+}
+
 TEST(BitVectorTest, SubsetOrTest) {
   BitVector bvec1;
   bvec1.Set(3);
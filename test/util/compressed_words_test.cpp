@@ -0,0 +1,74 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/compressed_words.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(CompressedWords, RoundTripsRepetitiveData) {
+  // Repeated word patterns, like the type and decoration sections of a
+  // module, should both round trip and shrink.
+  std::vector<uint32_t> words;
+  for (uint32_t i = 0; i < 4096; ++i) {
+    words.push_back(0x00040047u);  // An OpDecorate-shaped word.
+    words.push_back(i % 32);
+    words.push_back(35u);
+    words.push_back(i % 8);
+  }
+
+  const std::vector<uint8_t> data = CompressWords(words.data(), words.size());
+  EXPECT_LT(data.size(), words.size() * sizeof(uint32_t) / 2);
+
+  std::vector<uint32_t> round_tripped;
+  ASSERT_TRUE(DecompressWords(data, words.size(), &round_tripped));
+  EXPECT_EQ(words, round_tripped);
+}
+
+TEST(CompressedWords, RoundTripsIncompressibleData) {
+  // Random words do not shrink; they are stored verbatim with one byte of
+  // overhead and still round trip.
+  std::mt19937 rng(42);
+  std::vector<uint32_t> words(1024);
+  for (uint32_t& word : words) word = rng();
+
+  const std::vector<uint8_t> data = CompressWords(words.data(), words.size());
+  EXPECT_LE(data.size(), words.size() * sizeof(uint32_t) + 1);
+
+  std::vector<uint32_t> round_tripped;
+  ASSERT_TRUE(DecompressWords(data, words.size(), &round_tripped));
+  EXPECT_EQ(words, round_tripped);
+}
+
+TEST(CompressedWords, RejectsWrongWordCountAndTruncation) {
+  std::vector<uint32_t> words(256, 0x12345678u);
+  const std::vector<uint8_t> data = CompressWords(words.data(), words.size());
+
+  std::vector<uint32_t> out;
+  EXPECT_FALSE(DecompressWords(data, words.size() - 1, &out));
+  EXPECT_FALSE(DecompressWords(data, words.size() + 1, &out));
+
+  std::vector<uint8_t> truncated(data.begin(), data.end() - 1);
+  EXPECT_FALSE(DecompressWords(truncated, words.size(), &out));
+  EXPECT_FALSE(DecompressWords({}, words.size(), &out));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
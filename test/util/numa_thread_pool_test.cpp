@@ -0,0 +1,79 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "gmock/gmock.h"
+
+#include "source/util/numa_thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(NumaThreadPoolTest, RunsAllTasks) {
+  std::atomic<int> counter(0);
+  NumaThreadPool pool(2, 2);
+  EXPECT_EQ(2u, pool.num_nodes());
+  for (size_t i = 0; i < 100; ++i) {
+    pool.Schedule(i, [&counter] { ++counter; });
+  }
+  pool.Wait();
+  EXPECT_EQ(100, counter.load());
+}
+
+TEST(NumaThreadPoolTest, ZeroNodesTreatedAsOne) {
+  NumaThreadPool pool(0, 2);
+  EXPECT_EQ(1u, pool.num_nodes());
+  int counter = 0;
+  pool.Schedule(7, [&counter] { ++counter; });
+  pool.Wait();
+  EXPECT_EQ(1, counter);
+}
+
+TEST(NumaThreadPoolTest, EqualKeysStayOnTheSameNode) {
+  // With two sub-pools of two workers, the worker threads that run
+  // even-keyed tasks must be disjoint from those that run odd-keyed
+  // tasks: tasks never migrate between sub-pools.
+  std::mutex mutex;
+  std::set<std::thread::id> even_threads;
+  std::set<std::thread::id> odd_threads;
+
+  NumaThreadPool pool(2, 2);
+  for (size_t i = 0; i < 200; ++i) {
+    auto* threads = (i % 2 == 0) ? &even_threads : &odd_threads;
+    pool.Schedule(i, [&mutex, threads] {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads->insert(std::this_thread::get_id());
+    });
+  }
+  pool.Wait();
+
+  EXPECT_LE(even_threads.size(), 2u);
+  EXPECT_LE(odd_threads.size(), 2u);
+  for (const auto& id : even_threads) {
+    EXPECT_EQ(0u, odd_threads.count(id));
+  }
+}
+
+TEST(NumaThreadPoolTest, DefaultNodeCountIsPositive) {
+  EXPECT_GE(NumaThreadPool::DefaultNodeCount(), 1u);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/ordered_collector.h"
+#include "source/util/thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(OrderedCollectorTest, EmitsInOrderWhenDeliveredInOrder) {
+  std::vector<size_t> emitted;
+  OrderedCollector<int> collector(4, [&emitted](size_t sequence, int&& value) {
+    EXPECT_EQ(static_cast<int>(sequence), value);
+    emitted.push_back(sequence);
+  });
+  for (int i = 0; i < 10; ++i) {
+    collector.Deliver(i, i);
+  }
+  EXPECT_EQ(10u, emitted.size());
+  for (size_t i = 0; i < emitted.size(); ++i) EXPECT_EQ(i, emitted[i]);
+}
+
+TEST(OrderedCollectorTest, HoldsEarlyResultUntilPredecessorArrives) {
+  std::vector<size_t> emitted;
+  OrderedCollector<std::string> collector(
+      4, [&emitted](size_t sequence, std::string&&) {
+        emitted.push_back(sequence);
+      });
+  collector.Deliver(1, "b");
+  collector.Deliver(3, "d");
+  EXPECT_TRUE(emitted.empty());
+  collector.Deliver(0, "a");
+  EXPECT_THAT(emitted, testing::ElementsAre(0u, 1u));
+  collector.Deliver(2, "c");
+  EXPECT_THAT(emitted, testing::ElementsAre(0u, 1u, 2u, 3u));
+}
+
+TEST(OrderedCollectorTest, OrdersResultsFromThreadPool) {
+  const size_t kNumTasks = 1000;
+  std::vector<size_t> emitted;
+  OrderedCollector<size_t> collector(
+      8, [&emitted](size_t sequence, size_t&& value) {
+        EXPECT_EQ(sequence, value);
+        emitted.push_back(sequence);
+      });
+  ThreadPool pool(4);
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    pool.Schedule([&collector, i] { collector.Deliver(i, size_t(i)); });
+  }
+  pool.Wait();
+  ASSERT_EQ(kNumTasks, emitted.size());
+  for (size_t i = 0; i < kNumTasks; ++i) EXPECT_EQ(i, emitted[i]);
+}
+
+TEST(OrderedCollectorTest, MovesResultsOnce) {
+  // The collector must hand each stored result to the callback by move, not
+  // by copy, so results can carry large buffers.
+  std::vector<std::vector<int>> retired;
+  OrderedCollector<std::vector<int>> collector(
+      2, [&retired](size_t, std::vector<int>&& value) {
+        retired.push_back(std::move(value));
+      });
+  collector.Deliver(1, std::vector<int>(100, 1));
+  collector.Deliver(0, std::vector<int>(100, 0));
+  ASSERT_EQ(2u, retired.size());
+  EXPECT_EQ(0, retired[0][0]);
+  EXPECT_EQ(1, retired[1][0]);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/ordered_diagnostics.h"
+#include "source/util/thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(OrderedDiagnosticsTest, ReplaysInRecordingOrder) {
+  std::vector<std::string> replayed;
+  OrderedDiagnostics diagnostics(
+      [&replayed](spv_message_level_t, const char*, const spv_position_t&,
+                  const char* text) { replayed.push_back(text); });
+
+  MessageConsumer first = diagnostics.CreateBuffer()->GetConsumer();
+  MessageConsumer second = diagnostics.CreateBuffer()->GetConsumer();
+
+  // Interleave recording across the two buffers; replay must recover the
+  // global order, not the per-buffer order.
+  first(SPV_MSG_ERROR, "", {}, "a");
+  second(SPV_MSG_ERROR, "", {}, "b");
+  first(SPV_MSG_ERROR, "", {}, "c");
+
+  diagnostics.Replay();
+  EXPECT_THAT(replayed, testing::ElementsAre("a", "b", "c"));
+
+  // Replay drains the buffers; a second replay adds nothing.
+  diagnostics.Replay();
+  EXPECT_EQ(3u, replayed.size());
+}
+
+TEST(OrderedDiagnosticsTest, ConcurrentRecording) {
+  std::vector<std::string> replayed;
+  OrderedDiagnostics diagnostics(
+      [&replayed](spv_message_level_t, const char*, const spv_position_t&,
+                  const char* text) { replayed.push_back(text); });
+
+  constexpr size_t kWorkers = 4;
+  constexpr int kMessagesPerWorker = 100;
+  std::vector<OrderedDiagnostics::Buffer*> buffers;
+  for (size_t i = 0; i < kWorkers; ++i) {
+    buffers.push_back(diagnostics.CreateBuffer());
+  }
+
+  ThreadPool pool(kWorkers);
+  for (size_t i = 0; i < kWorkers; ++i) {
+    OrderedDiagnostics::Buffer* buffer = buffers[i];
+    pool.Schedule([buffer, i] {
+      MessageConsumer consumer = buffer->GetConsumer();
+      for (int m = 0; m < kMessagesPerWorker; ++m) {
+        consumer(SPV_MSG_WARNING, "", {},
+                 (std::to_string(i) + ":" + std::to_string(m)).c_str());
+      }
+    });
+  }
+  pool.Wait();
+
+  diagnostics.Replay();
+  ASSERT_EQ(kWorkers * kMessagesPerWorker, replayed.size());
+
+  // Each worker's own messages must appear in the order it emitted them.
+  std::vector<int> last_seen(kWorkers, -1);
+  for (const std::string& text : replayed) {
+    const size_t colon = text.find(':');
+    const int worker = std::stoi(text.substr(0, colon));
+    const int message = std::stoi(text.substr(colon + 1));
+    EXPECT_EQ(last_seen[worker] + 1, message);
+    last_seen[worker] = message;
+  }
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
@@ -0,0 +1,87 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "gmock/gmock.h"
+
+#include "source/util/scratch_arena.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(ScratchArenaTest, AllocationsAreAlignedAndDisjoint) {
+  ScratchArena arena;
+  char* a = static_cast<char*>(arena.Allocate(3, 1));
+  char* b = static_cast<char*>(arena.Allocate(8, 8));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 8);
+  // |b| must start at or after the end of |a|.
+  EXPECT_GE(b, a + 3);
+}
+
+TEST(ScratchArenaTest, ResetReusesStorage) {
+  ScratchArena arena;
+  void* first = arena.Allocate(16, 8);
+  arena.Reset();
+  // After a reset the arena hands out the same storage again.
+  EXPECT_EQ(first, arena.Allocate(16, 8));
+}
+
+TEST(ScratchArenaTest, GrowsPastTheFirstBlock) {
+  ScratchArena arena;
+  // Larger than the 64K first block, forcing a dedicated block.
+  void* big = arena.Allocate(1 << 20, 8);
+  void* small = arena.Allocate(8, 8);
+  EXPECT_NE(nullptr, big);
+  EXPECT_NE(nullptr, small);
+}
+
+TEST(ScratchArenaTest, HugeBlocksAreUsableAndReusable) {
+  ScratchArena arena;
+  // At least 2MB, which takes the huge-page backed path where supported.
+  const size_t bytes = size_t(4) << 20;
+  char* big = static_cast<char*>(arena.Allocate(bytes, 64));
+  ASSERT_NE(nullptr, big);
+  big[0] = 1;
+  big[bytes - 1] = 2;
+  EXPECT_EQ(1, big[0]);
+  EXPECT_EQ(2, big[bytes - 1]);
+
+  arena.Reset();
+  char* again = static_cast<char*>(arena.Allocate(bytes, 64));
+  EXPECT_NE(nullptr, again);
+  again[bytes - 1] = 3;
+}
+
+TEST(ScratchArenaTest, ContainersUseTheArena) {
+  ScratchArena arena;
+  ScratchVector<uint32_t> vec(&arena);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    vec.push_back(i);
+  }
+  ScratchSet<uint32_t> set(&arena);
+  ScratchMap<uint32_t, uint32_t> map(&arena);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    set.insert(i);
+    map[i] = i * 2;
+  }
+  EXPECT_EQ(999u, vec.back());
+  EXPECT_EQ(1u, set.count(500));
+  EXPECT_EQ(1000u, map[500]);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
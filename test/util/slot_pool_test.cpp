@@ -0,0 +1,68 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/slot_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+using TestPool = SlotPool<32, 8>;
+
+TEST(SlotPoolTest, ReusesFreedSlotFirst) {
+  TestPool& pool = TestPool::ThreadLocal();
+  void* first = pool.Allocate();
+  pool.Deallocate(first);
+  // The free list is LIFO, so the most recently freed slot comes back.
+  EXPECT_EQ(first, pool.Allocate());
+  pool.Deallocate(first);
+}
+
+TEST(SlotPoolTest, AllocationsAreDistinctAndAligned) {
+  TestPool& pool = TestPool::ThreadLocal();
+  std::vector<void*> slots;
+  std::set<void*> unique;
+  for (int i = 0; i < 1000; ++i) {
+    void* slot = pool.Allocate();
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(slot) % 8);
+    unique.insert(slot);
+    slots.push_back(slot);
+  }
+  EXPECT_EQ(slots.size(), unique.size());
+  for (void* slot : slots) pool.Deallocate(slot);
+}
+
+TEST(SlotPoolTest, SlotsSurviveTheAllocatingThread) {
+  // A slot allocated on a worker thread must remain usable after that
+  // thread, and with it the thread-local pool, has gone away.
+  void* slot = nullptr;
+  std::thread worker(
+      [&slot] { slot = SlotPool<64, 8>::ThreadLocal().Allocate(); });
+  worker.join();
+  ASSERT_NE(nullptr, slot);
+  memset(slot, 0xab, 64);
+  SlotPool<64, 8>::ThreadLocal().Deallocate(slot);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
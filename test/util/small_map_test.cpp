@@ -0,0 +1,96 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/small_map.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(SmallMapTest, InsertAndFindBelowThreshold) {
+  SmallMap<uint32_t, std::string, 4> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.insert({1, "one"}).second);
+  EXPECT_TRUE(map.insert({2, "two"}).second);
+  EXPECT_FALSE(map.insert({1, "uno"}).second);
+  EXPECT_EQ(map.size(), 2u);
+  auto it = map.find(1);
+  ASSERT_NE(it, map.end());
+  EXPECT_EQ(it->second, "one");
+  EXPECT_EQ(map.find(3), map.end());
+  EXPECT_EQ(map.count(2), 1u);
+  EXPECT_EQ(map.count(3), 0u);
+}
+
+TEST(SmallMapTest, GrowsPastThreshold) {
+  SmallMap<uint32_t, uint32_t, 4> map;
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(map.insert({i, i * i}).second);
+  }
+  EXPECT_EQ(map.size(), 100u);
+  for (uint32_t i = 0; i < 100; ++i) {
+    auto it = map.find(i);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->second, i * i);
+  }
+  EXPECT_EQ(map.find(100), map.end());
+}
+
+TEST(SmallMapTest, SubscriptInsertsAndUpdates) {
+  SmallMap<uint32_t, uint32_t, 2> map;
+  map[5] = 50;
+  EXPECT_EQ(map[5], 50u);
+  map[5] = 55;
+  EXPECT_EQ(map[5], 55u);
+  // A fresh key default-constructs its value.
+  EXPECT_EQ(map[6], 0u);
+  EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(SmallMapTest, IteratesInInsertionOrder) {
+  SmallMap<uint32_t, uint32_t, 2> map;
+  const std::vector<uint32_t> keys = {5, 1, 9, 3, 7};
+  for (uint32_t key : keys) map[key] = key + 1;
+  std::vector<uint32_t> seen;
+  for (const auto& entry : map) seen.push_back(entry.first);
+  EXPECT_EQ(seen, keys);
+}
+
+TEST(SmallMapTest, ValuesStayUpdatableAfterGrowth) {
+  SmallMap<uint32_t, uint32_t, 2> map;
+  for (uint32_t i = 0; i < 10; ++i) map[i] = i;
+  map.find(3)->second = 33;
+  EXPECT_EQ(map[3], 33u);
+}
+
+TEST(SmallMapTest, ClearResetsTheMap) {
+  SmallMap<uint32_t, uint32_t, 2> map;
+  for (uint32_t i = 0; i < 10; ++i) map[i] = i;
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(0), map.end());
+  map[0] = 7;
+  EXPECT_EQ(map.size(), 1u);
+  EXPECT_EQ(map[0], 7u);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
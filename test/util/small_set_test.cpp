@@ -0,0 +1,83 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/small_set.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(SmallSetTest, InsertAndCountBelowThreshold) {
+  SmallSet<uint32_t, 4> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.insert(3).second);
+  EXPECT_TRUE(set.insert(7).second);
+  EXPECT_FALSE(set.insert(3).second);
+  EXPECT_EQ(set.size(), 2u);
+  EXPECT_EQ(set.count(3), 1u);
+  EXPECT_EQ(set.count(7), 1u);
+  EXPECT_EQ(set.count(4), 0u);
+}
+
+TEST(SmallSetTest, GrowsPastThreshold) {
+  SmallSet<uint32_t, 4> set;
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(set.insert(i).second);
+  }
+  EXPECT_EQ(set.size(), 100u);
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_FALSE(set.insert(i).second);
+    EXPECT_EQ(set.count(i), 1u);
+  }
+  EXPECT_EQ(set.count(100), 0u);
+}
+
+TEST(SmallSetTest, IteratesInInsertionOrder) {
+  SmallSet<uint32_t, 2> set;
+  const std::vector<uint32_t> values = {5, 1, 9, 3, 7};
+  for (uint32_t value : values) {
+    set.insert(value);
+    set.insert(value);  // Duplicates do not disturb the order.
+  }
+  std::vector<uint32_t> seen(set.begin(), set.end());
+  EXPECT_EQ(seen, values);
+}
+
+TEST(SmallSetTest, InsertReportsExistingElement) {
+  SmallSet<uint32_t, 4> set;
+  auto first = set.insert(42);
+  auto second = set.insert(42);
+  EXPECT_FALSE(second.second);
+  EXPECT_EQ(first.first, second.first);
+  EXPECT_EQ(*second.first, 42u);
+}
+
+TEST(SmallSetTest, ClearResetsTheSet) {
+  SmallSet<uint32_t, 2> set;
+  for (uint32_t i = 0; i < 10; ++i) set.insert(i);
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.count(0), 0u);
+  EXPECT_TRUE(set.insert(0).second);
+  EXPECT_EQ(set.size(), 1u);
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
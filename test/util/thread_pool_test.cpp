@@ -0,0 +1,78 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+
+#include "gmock/gmock.h"
+
+#include "source/util/thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(ThreadPoolTest, RunsAllTasksWithWorkers) {
+  std::atomic<int> counter(0);
+  ThreadPool pool(4);
+  EXPECT_EQ(4u, pool.num_threads());
+  for (int i = 0; i < 100; ++i) {
+    pool.Schedule([&counter] { ++counter; });
+  }
+  pool.Wait();
+  EXPECT_EQ(100, counter.load());
+}
+
+TEST(ThreadPoolTest, SerialFallbackRunsOnCallingThread) {
+  // A pool of size 1 creates no worker threads; tasks run inside Wait().
+  ThreadPool pool(1);
+  EXPECT_EQ(0u, pool.num_threads());
+  int counter = 0;
+  const std::thread::id caller = std::this_thread::get_id();
+  std::thread::id task_thread;
+  pool.Schedule([&] {
+    ++counter;
+    task_thread = std::this_thread::get_id();
+  });
+  EXPECT_EQ(0, counter);
+  pool.Wait();
+  EXPECT_EQ(1, counter);
+  EXPECT_EQ(caller, task_thread);
+}
+
+TEST(ThreadPoolTest, WaitIsReusable) {
+  std::atomic<int> counter(0);
+  ThreadPool pool(2);
+  pool.Schedule([&counter] { ++counter; });
+  pool.Wait();
+  EXPECT_EQ(1, counter.load());
+  pool.Schedule([&counter] { ++counter; });
+  pool.Schedule([&counter] { ++counter; });
+  pool.Wait();
+  EXPECT_EQ(3, counter.load());
+}
+
+TEST(ThreadPoolTest, DestructorDrainsPendingTasks) {
+  std::atomic<int> counter(0);
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 10; ++i) {
+      pool.Schedule([&counter] { ++counter; });
+    }
+  }
+  EXPECT_EQ(10, counter.load());
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
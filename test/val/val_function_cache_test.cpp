@@ -0,0 +1,90 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the per-context function validation cache.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+std::vector<uint32_t> AssembleModule(const std::string& text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+  return binary;
+}
+
+// Module-scope declarations followed by one valid function.  Both test
+// modules start with this exact text, so %f1 assembles to the same words in
+// both and the second module's %f1 hits the hashes cached by the first.
+const char kBaseModule[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%one = OpConstant %uint 1
+%float = OpTypeFloat 32
+%fone = OpConstant %float 1
+%f1 = OpFunction %void None %fnty
+%f1e = OpLabel
+%a1 = OpIAdd %uint %one %one
+OpReturn
+OpFunctionEnd
+)";
+
+TEST(FunctionValidationCache, RevalidationWithSameContextPasses) {
+  const std::vector<uint32_t> binary = AssembleModule(kBaseModule);
+  // One SpirvTools instance holds one spv_context, so the second run sees
+  // the hashes cached by the first.
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  EXPECT_TRUE(tools.Validate(binary.data(), binary.size()));
+  EXPECT_TRUE(tools.Validate(binary.data(), binary.size()));
+}
+
+TEST(FunctionValidationCache, CachedFunctionDoesNotMaskNewErrors) {
+  // The second module repeats %f1 word for word and appends a function whose
+  // OpIAdd on a float type must still be rejected.
+  const std::string variant = std::string(kBaseModule) + R"(
+%f2 = OpFunction %void None %fnty
+%f2e = OpLabel
+%bad = OpIAdd %float %fone %fone
+OpReturn
+OpFunctionEnd
+)";
+  const std::vector<uint32_t> base = AssembleModule(kBaseModule);
+  const std::vector<uint32_t> binary = AssembleModule(variant);
+
+  std::string message;
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  tools.SetMessageConsumer(
+      [&message](spv_message_level_t, const char*, const spv_position_t&,
+                 const char* m) { message = m; });
+  EXPECT_TRUE(tools.Validate(base.data(), base.size()));
+  EXPECT_FALSE(tools.Validate(binary.data(), binary.size()));
+  EXPECT_THAT(message, HasSubstr("IAdd"));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
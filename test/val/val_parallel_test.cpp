@@ -0,0 +1,165 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for parallel per-function validation.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+std::vector<uint32_t> AssembleModule(const std::string& text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+  return binary;
+}
+
+// A module with several independent functions, so that the parallel mode has
+// more than one function body to distribute.
+const char kMultiFunctionModule[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%one = OpConstant %uint 1
+%f1 = OpFunction %void None %fnty
+%f1e = OpLabel
+%a1 = OpIAdd %uint %one %one
+OpReturn
+OpFunctionEnd
+%f2 = OpFunction %void None %fnty
+%f2e = OpLabel
+%a2 = OpIMul %uint %one %one
+OpReturn
+OpFunctionEnd
+%f3 = OpFunction %void None %fnty
+%f3e = OpLabel
+%a3 = OpISub %uint %one %one
+OpReturn
+OpFunctionEnd
+%f4 = OpFunction %void None %fnty
+%f4e = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+TEST(ParallelValidation, AcceptsValidMultiFunctionModule) {
+  const std::vector<uint32_t> binary = AssembleModule(kMultiFunctionModule);
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  ValidatorOptions options;
+  options.SetParallelValidation(4);
+  EXPECT_TRUE(tools.Validate(binary.data(), binary.size(), options));
+}
+
+TEST(ParallelValidation, ReportsSameErrorAsSerialValidation) {
+  // OpIAdd on a float type is rejected by the arithmetics checks, which run
+  // in the per-function phase.
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%float = OpTypeFloat 32
+%one = OpConstant %float 1
+%f1 = OpFunction %void None %fnty
+%f1e = OpLabel
+OpReturn
+OpFunctionEnd
+%f2 = OpFunction %void None %fnty
+%f2e = OpLabel
+%bad = OpIAdd %float %one %one
+OpReturn
+OpFunctionEnd
+)";
+  const std::vector<uint32_t> binary = AssembleModule(text);
+
+  std::string serial_message;
+  {
+    SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+    tools.SetMessageConsumer([&serial_message](spv_message_level_t,
+                                               const char*,
+                                               const spv_position_t&,
+                                               const char* m) {
+      serial_message = m;
+    });
+    EXPECT_FALSE(tools.Validate(binary.data(), binary.size()));
+  }
+
+  std::string parallel_message;
+  {
+    SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+    tools.SetMessageConsumer([&parallel_message](spv_message_level_t,
+                                                 const char*,
+                                                 const spv_position_t&,
+                                                 const char* m) {
+      parallel_message = m;
+    });
+    ValidatorOptions options;
+    options.SetParallelValidation(4);
+    EXPECT_FALSE(tools.Validate(binary.data(), binary.size(), options));
+  }
+
+  EXPECT_THAT(parallel_message, HasSubstr("IAdd"));
+  EXPECT_EQ(serial_message, parallel_message);
+}
+
+TEST(ParallelValidation, ReportsErrorFromEarliestFunction) {
+  // Both functions are invalid; the diagnostic must come from the first one,
+  // as in a single-threaded front-to-back validation.
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%float = OpTypeFloat 32
+%one = OpConstant %float 1
+%f1 = OpFunction %void None %fnty
+%f1e = OpLabel
+%bad1 = OpIAdd %float %one %one
+OpReturn
+OpFunctionEnd
+%f2 = OpFunction %void None %fnty
+%f2e = OpLabel
+%bad2 = OpIMul %float %one %one
+OpReturn
+OpFunctionEnd
+)";
+  const std::vector<uint32_t> binary = AssembleModule(text);
+
+  std::string message;
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  tools.SetMessageConsumer(
+      [&message](spv_message_level_t, const char*, const spv_position_t&,
+                 const char* m) { message = m; });
+  ValidatorOptions options;
+  options.SetParallelValidation(2);
+  EXPECT_FALSE(tools.Validate(binary.data(), binary.size(), options));
+  EXPECT_THAT(message, HasSubstr("IAdd"));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
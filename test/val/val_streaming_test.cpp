@@ -0,0 +1,119 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the streaming (chunked-input) validator.
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test/unit_spirv.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+std::vector<uint32_t> AssembleModule(const std::string& text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+  return binary;
+}
+
+const char kValidModule[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fnty = OpTypeFunction %void
+%main = OpFunction %void None %fnty
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+TEST(StreamingValidator, AcceptsValidModulePushedWordByWord) {
+  const std::vector<uint32_t> binary = AssembleModule(kValidModule);
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  for (uint32_t word : binary) {
+    ASSERT_TRUE(validator.PushWords(&word, 1));
+  }
+  EXPECT_TRUE(validator.Finish());
+}
+
+TEST(StreamingValidator, AcceptsValidModulePushedInOneChunk) {
+  const std::vector<uint32_t> binary = AssembleModule(kValidModule);
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  EXPECT_TRUE(validator.PushWords(binary.data(), binary.size()));
+  EXPECT_TRUE(validator.Finish());
+}
+
+TEST(StreamingValidator, RejectsBadMagicBeforeFullDownload) {
+  std::vector<uint32_t> binary = AssembleModule(kValidModule);
+  binary[0] = 0xdeadbeef;
+  std::string message;
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  validator.SetMessageConsumer([&message](spv_message_level_t, const char*,
+                                          const spv_position_t&,
+                                          const char* m) { message = m; });
+  // The header is complete after five words; the stream must be rejected
+  // without seeing the rest of the module.
+  EXPECT_FALSE(validator.PushWords(binary.data(), 5));
+  EXPECT_THAT(message, HasSubstr("magic number"));
+  EXPECT_FALSE(validator.Finish());
+}
+
+TEST(StreamingValidator, RejectsUnknownOpcodeEarly) {
+  std::vector<uint32_t> binary = AssembleModule(kValidModule);
+  // Overwrite the first instruction (OpCapability, two words) with a bogus
+  // opcode and push only up to it.
+  binary[5] = (2u << 16) | 0xffffu;
+  std::string message;
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  validator.SetMessageConsumer([&message](spv_message_level_t, const char*,
+                                          const spv_position_t&,
+                                          const char* m) { message = m; });
+  EXPECT_FALSE(validator.PushWords(binary.data(), 7));
+  EXPECT_THAT(message, HasSubstr("Invalid opcode"));
+}
+
+TEST(StreamingValidator, RejectsTruncatedModuleAtFinish) {
+  const std::vector<uint32_t> binary = AssembleModule(kValidModule);
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  // Drop the last word: the final instruction is incomplete.
+  EXPECT_TRUE(validator.PushWords(binary.data(), binary.size() - 1));
+  EXPECT_FALSE(validator.Finish());
+}
+
+TEST(StreamingValidator, ReportsSemanticErrorsAtFinish) {
+  // Structurally fine but semantically invalid: no memory model.
+  const std::vector<uint32_t> binary = AssembleModule(R"(
+OpCapability Shader
+OpCapability Linkage
+)");
+  std::string message;
+  StreamingValidator validator(SPV_ENV_UNIVERSAL_1_0);
+  validator.SetMessageConsumer([&message](spv_message_level_t, const char*,
+                                          const spv_position_t&,
+                                          const char* m) { message = m; });
+  EXPECT_TRUE(validator.PushWords(binary.data(), binary.size()));
+  EXPECT_FALSE(validator.Finish());
+  EXPECT_FALSE(message.empty());
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -15,11 +15,15 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <string>
 #include <vector>
 
 #include "source/spirv_target_env.h"
+#include "source/util/ordered_collector.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 #include "tools/io.h"
+#include "tools/util/file_list.h"
 #include "tools/util/flags.h"
 
 static const auto kDefaultEnvironment = "spv1.6";
@@ -45,6 +49,21 @@ Options:
                   starting with 1 and going up.
   --target-env    %s
                   Use specified environment.
+  --file-list=<file>
+                  Assemble each file named in <file> instead of a single
+                  input.  Each non-empty line of <file> names an input file,
+                  optionally followed by an output file; '#' starts a comment.
+                  When a line gives no output, the input's extension is
+                  replaced with ".spv".  Use "-" to read the list from
+                  standard input.
+  --jobs=<n>      Number of threads used to process a --file-list.  Defaults
+                  to 0, meaning one thread per hardware thread context.
+  --verify-roundtrip
+                  After assembling, disassemble the binary and reassemble the
+                  result in memory, then check that the words of the two
+                  binaries match.  A mismatch fails the assembly with a
+                  diagnostic naming the first differing word.  No
+                  intermediate files are written.
 )";
 
 // clang-format off
@@ -54,8 +73,141 @@ FLAG_LONG_bool(   version,              /* default_value= */ false,
 FLAG_LONG_bool(   preserve_numeric_ids, /* default_value= */ false,               /* required= */ false);
 FLAG_SHORT_string(o,                    /* default_value= */ "",                  /* required= */ false);
 FLAG_LONG_string( target_env,           /* default_value= */ kDefaultEnvironment, /* required= */ false);
+FLAG_LONG_string( file_list,            /* default_value= */ "",                  /* required= */ false);
+FLAG_LONG_uint(   jobs,                 /* default_value= */ 0,                   /* required= */ false);
+FLAG_LONG_bool(   verify_roundtrip,     /* default_value= */ false,               /* required= */ false);
 // clang-format on
 
+// Disassembles |binary| and reassembles the text with numeric ids preserved,
+// entirely in memory and with the grammar tables already built for
+// |context|.  Returns true when the reassembled module matches |binary|
+// word for word; otherwise fills |error| with a diagnostic naming the first
+// mismatch, prefixed with |input_name|.
+static bool VerifyRoundTrip(spv_context context, const std::string& input_name,
+                            spv_binary binary, std::string* error) {
+  spv_text text = nullptr;
+  spv_diagnostic diagnostic = nullptr;
+  if (spvBinaryToText(context, binary->code, binary->wordCount,
+                      SPV_BINARY_TO_TEXT_OPTION_NONE, &text, &diagnostic)) {
+    *error = "error: " + input_name + ": round-trip disassembly failed";
+    if (diagnostic) {
+      *error += std::string(": ") + diagnostic->error;
+    }
+    spvDiagnosticDestroy(diagnostic);
+    return false;
+  }
+
+  spv_binary reassembled = nullptr;
+  spv_result_t status = spvTextToBinaryWithOptions(
+      context, text->str, text->length,
+      SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS, &reassembled,
+      &diagnostic);
+  spvTextDestroy(text);
+  if (status) {
+    *error = "error: " + input_name + ": round-trip reassembly failed";
+    if (diagnostic) {
+      *error += std::string(": ") + diagnostic->error;
+    }
+    spvDiagnosticDestroy(diagnostic);
+    return false;
+  }
+
+  bool matched = binary->wordCount == reassembled->wordCount;
+  if (!matched) {
+    *error = "error: " + input_name + ": round-trip mismatch: " +
+             std::to_string(binary->wordCount) + " words became " +
+             std::to_string(reassembled->wordCount);
+  } else {
+    for (size_t i = 0; i < binary->wordCount; ++i) {
+      if (binary->code[i] != reassembled->code[i]) {
+        char words[64];
+        snprintf(words, sizeof(words), "0x%08x became 0x%08x",
+                 binary->code[i], reassembled->code[i]);
+        *error = "error: " + input_name + ": round-trip mismatch at word " +
+                 std::to_string(i) + ": " + words;
+        matched = false;
+        break;
+      }
+    }
+  }
+  spvBinaryDestroy(reassembled);
+  return matched;
+}
+
+// Assembles every file named by --file-list on a thread pool, sharing a
+// single assembler context so the grammar tables are built only once.
+// Returns the process exit code.
+static int AssembleFileList(spv_target_env target_env, uint32_t options) {
+  std::vector<FileListEntry> files;
+  if (!ReadFileList(flags::file_list.value().c_str(), ".spv", &files)) {
+    return 1;
+  }
+
+  spv_context context = spvContextCreate(target_env);
+
+  int num_failures = 0;
+  {
+    const size_t num_threads =
+        flags::jobs.value() == 0
+            ? spvtools::utils::ThreadPool::DefaultThreadCount()
+            : flags::jobs.value();
+    // Failure messages are printed in input order as soon as every earlier
+    // file is done, so the output is deterministic.
+    spvtools::utils::OrderedCollector<std::string> collector(
+        2 * num_threads, [&num_failures](size_t, std::string&& error) {
+          if (!error.empty()) {
+            fprintf(stderr, "%s\n", error.c_str());
+            num_failures++;
+          }
+        });
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Schedule([&files, &collector, context, options, i] {
+        std::string error;
+        std::vector<char> contents;
+        if (!ReadTextFile<char>(files[i].input.c_str(), &contents)) {
+          collector.Deliver(i, "error: could not read '" + files[i].input +
+                                   "'");
+          return;
+        }
+        spv_binary binary = nullptr;
+        spv_diagnostic diagnostic = nullptr;
+        spv_result_t status =
+            spvTextToBinaryWithOptions(context, contents.data(),
+                                       contents.size(), options, &binary,
+                                       &diagnostic);
+        if (status) {
+          error = "error: " + files[i].input;
+          if (diagnostic) {
+            error += ":" + std::to_string(diagnostic->position.line + 1) +
+                     ":" + std::to_string(diagnostic->position.column + 1) +
+                     ": " + diagnostic->error;
+          }
+          spvDiagnosticDestroy(diagnostic);
+          collector.Deliver(i, std::move(error));
+          return;
+        }
+        if (flags::verify_roundtrip.value() &&
+            !VerifyRoundTrip(context, files[i].input, binary, &error)) {
+          spvBinaryDestroy(binary);
+          collector.Deliver(i, std::move(error));
+          return;
+        }
+        if (!WriteFile<uint32_t>(files[i].output.c_str(), "wb", binary->code,
+                                 binary->wordCount)) {
+          error = "error: could not write '" + files[i].output + "'";
+        }
+        spvBinaryDestroy(binary);
+        collector.Deliver(i, std::move(error));
+      });
+    }
+    pool.Wait();
+  }
+  spvContextDestroy(context);
+
+  return num_failures == 0 ? 0 : 1;
+}
+
 int main(int, const char** argv) {
   if (!flags::Parse(argv)) {
     return 1;
@@ -99,6 +251,15 @@ int main(int, const char** argv) {
     return 1;
   }
 
+  if (!flags::file_list.value().empty()) {
+    if (!flags::positional_arguments.empty()) {
+      fprintf(stderr,
+              "error: --file-list cannot be combined with an input file.\n");
+      return 1;
+    }
+    return AssembleFileList(target_env, options);
+  }
+
   if (flags::positional_arguments.size() != 1) {
     fprintf(stderr, "error: exactly one input file must be specified.\n");
     return 1;
@@ -113,13 +274,24 @@ int main(int, const char** argv) {
   spv_context context = spvContextCreate(target_env);
   spv_result_t error = spvTextToBinaryWithOptions(
       context, contents.data(), contents.size(), options, &binary, &diagnostic);
-  spvContextDestroy(context);
   if (error) {
+    spvContextDestroy(context);
     spvDiagnosticPrint(diagnostic);
     spvDiagnosticDestroy(diagnostic);
     return error;
   }
 
+  if (flags::verify_roundtrip.value()) {
+    std::string roundtrip_error;
+    if (!VerifyRoundTrip(context, inFile, binary, &roundtrip_error)) {
+      fprintf(stderr, "%s\n", roundtrip_error.c_str());
+      spvBinaryDestroy(binary);
+      spvContextDestroy(context);
+      return 1;
+    }
+  }
+  spvContextDestroy(context);
+
   if (!WriteFile<uint32_t>(outFile.c_str(), "wb", binary->code,
                            binary->wordCount)) {
     spvBinaryDestroy(binary);
@@ -0,0 +1,177 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cfg/bin_to_json.h"
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "source/latest_version_spirv_header.h"
+
+namespace {
+
+// A JsonConverter emits the control flow graph of a SPIR-V module as JSON
+// adjacency lists.  It mirrors the structure of DotConverter in
+// bin_to_dot.cpp, but writes raw ids instead of friendly names so no name
+// mapping pass over the module is needed.
+class JsonConverter {
+ public:
+  explicit JsonConverter(std::iostream* out) : out_(*out) {}
+
+  // Emits the JSON preamble.
+  void Begin() { out_ << "{\"functions\":[\n"; }
+  // Emits the JSON postamble.
+  void End() {
+    if (in_function_) FlushFunction();
+    out_ << "]}\n";
+  }
+
+  // Records the effect of the given instruction on the graph.
+  spv_result_t HandleInstruction(const spv_parsed_instruction_t& inst);
+
+ private:
+  // Ends processing for the current block, emitting its adjacency entry.
+  void FlushBlock(const std::vector<uint32_t>& successors);
+
+  // Ends processing for the current function.
+  void FlushFunction();
+
+  // The ID of the current function, or 0 if outside of a function.
+  uint32_t current_function_id_ = 0;
+
+  // The ID of the current basic block, or 0 if outside of a block.
+  uint32_t current_block_id_ = 0;
+
+  // True while inside a function whose object is still open.
+  bool in_function_ = false;
+
+  // True until the first function/block of the enclosing array is emitted,
+  // to place the separating commas.
+  bool first_function_ = true;
+  bool first_block_ = true;
+
+  // The Id of the merge block for this block if it exists, or 0 otherwise.
+  uint32_t merge_ = 0;
+  // The Id of the continue target block for this block if it exists, or 0
+  // otherwise.
+  uint32_t continue_target_ = 0;
+
+  // The output stream.
+  std::ostream& out_;
+};
+
+spv_result_t JsonConverter::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  switch (spv::Op(inst.opcode)) {
+    case spv::Op::OpFunction:
+      current_function_id_ = inst.result_id;
+      if (!first_function_) out_ << ",\n";
+      first_function_ = false;
+      out_ << "{\"id\":" << current_function_id_ << ",\"blocks\":[";
+      in_function_ = true;
+      first_block_ = true;
+      break;
+    case spv::Op::OpFunctionEnd:
+      FlushFunction();
+      break;
+
+    case spv::Op::OpLabel:
+      current_block_id_ = inst.result_id;
+      break;
+
+    case spv::Op::OpBranch:
+      FlushBlock({inst.words[1]});
+      break;
+    case spv::Op::OpBranchConditional:
+      FlushBlock({inst.words[2], inst.words[3]});
+      break;
+    case spv::Op::OpSwitch: {
+      std::vector<uint32_t> successors{inst.words[2]};
+      for (size_t i = 3; i < inst.num_operands; i += 2) {
+        successors.push_back(inst.words[inst.operands[i].offset]);
+      }
+      FlushBlock(successors);
+    } break;
+
+    case spv::Op::OpKill:
+    case spv::Op::OpReturn:
+    case spv::Op::OpUnreachable:
+    case spv::Op::OpReturnValue:
+      FlushBlock({});
+      break;
+
+    case spv::Op::OpLoopMerge:
+      merge_ = inst.words[1];
+      continue_target_ = inst.words[2];
+      break;
+    case spv::Op::OpSelectionMerge:
+      merge_ = inst.words[1];
+      break;
+    default:
+      break;
+  }
+  return SPV_SUCCESS;
+}
+
+void JsonConverter::FlushBlock(const std::vector<uint32_t>& successors) {
+  if (!first_block_) out_ << ",";
+  first_block_ = false;
+  out_ << "\n{\"id\":" << current_block_id_ << ",\"successors\":[";
+  for (size_t i = 0; i < successors.size(); ++i) {
+    if (i != 0) out_ << ",";
+    out_ << successors[i];
+  }
+  out_ << "]";
+  if (merge_) out_ << ",\"merge\":" << merge_;
+  if (continue_target_) out_ << ",\"continue\":" << continue_target_;
+  out_ << "}";
+
+  // Reset the book-keeping for a block.
+  merge_ = 0;
+  continue_target_ = 0;
+}
+
+void JsonConverter::FlushFunction() {
+  out_ << "]}";
+  current_function_id_ = 0;
+  in_function_ = false;
+}
+
+spv_result_t HandleInstruction(
+    void* user_data, const spv_parsed_instruction_t* parsed_instruction) {
+  assert(user_data);
+  auto converter = static_cast<JsonConverter*>(user_data);
+  return converter->HandleInstruction(*parsed_instruction);
+}
+
+}  // anonymous namespace
+
+spv_result_t BinaryToJson(const spv_const_context context,
+                          const uint32_t* words, size_t num_words,
+                          std::iostream* out, spv_diagnostic* diagnostic) {
+  // Invalid arguments return error codes, but don't necessarily generate
+  // diagnostics.  These are programmer errors, not user errors.
+  if (!diagnostic) return SPV_ERROR_INVALID_DIAGNOSTIC;
+
+  JsonConverter converter(out);
+  converter.Begin();
+  if (auto error = spvBinaryParse(context, &converter, words, num_words,
+                                  nullptr, HandleInstruction, diagnostic)) {
+    return error;
+  }
+  converter.End();
+
+  return SPV_SUCCESS;
+}
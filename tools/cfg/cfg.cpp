@@ -18,9 +18,13 @@
 #include <string>
 #include <vector>
 
+#include "source/util/ordered_collector.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 #include "tools/cfg/bin_to_dot.h"
+#include "tools/cfg/bin_to_json.h"
 #include "tools/io.h"
+#include "tools/util/file_list.h"
 #include "tools/util/flags.h"
 
 static const auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_6;
@@ -40,15 +44,94 @@ Options:
   -o <filename>   Set the output filename.
                   Output goes to standard output if this option is
                   not specified, or if the filename is "-".
+
+  --json          Emit the graph as JSON adjacency lists with raw ids
+                  instead of "dot" text.
+
+  --file-list=<file>
+                  Emit the graph of each file named in <file> instead of a
+                  single input.  Each non-empty line of <file> names an input
+                  file, optionally followed by an output file; '#' starts a
+                  comment.  When a line gives no output, the input's extension
+                  is replaced with ".cfg.json".  This mode always emits JSON
+                  adjacency lists.  Use "-" to read the list from standard
+                  input.
+  --jobs=<n>      Number of threads used to process a --file-list.  Defaults
+                  to 0, meaning one thread per hardware thread context.
 )";
 
 // clang-format off
-FLAG_SHORT_bool(  h,       /* default_value= */ false, /* required= */ false);
-FLAG_LONG_bool(   help,    /* default_value= */ false, /* required= */false);
-FLAG_LONG_bool(   version, /* default_value= */ false, /* required= */ false);
-FLAG_SHORT_string(o,       /* default_value= */ "",    /* required= */ false);
+FLAG_SHORT_bool(  h,         /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool(   help,      /* default_value= */ false, /* required= */false);
+FLAG_LONG_bool(   version,   /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool(   json,      /* default_value= */ false, /* required= */ false);
+FLAG_SHORT_string(o,         /* default_value= */ "",    /* required= */ false);
+FLAG_LONG_string( file_list, /* default_value= */ "",    /* required= */ false);
+FLAG_LONG_uint(   jobs,      /* default_value= */ 0,     /* required= */ false);
 // clang-format on
 
+// Emits the JSON graph of every file named by --file-list on a thread pool,
+// sharing a single spv_context so the grammar tables are built only once.
+// Returns the process exit code.
+static int EmitFileList() {
+  std::vector<FileListEntry> files;
+  if (!ReadFileList(flags::file_list.value().c_str(), ".cfg.json", &files)) {
+    return 1;
+  }
+
+  spv_context context = spvContextCreate(kDefaultEnvironment);
+
+  int num_failures = 0;
+  {
+    const size_t num_threads =
+        flags::jobs.value() == 0
+            ? spvtools::utils::ThreadPool::DefaultThreadCount()
+            : flags::jobs.value();
+    // Failure messages are printed in input order as soon as every earlier
+    // file is done, so the output is deterministic.
+    spvtools::utils::OrderedCollector<std::string> collector(
+        2 * num_threads, [&num_failures](size_t, std::string&& error) {
+          if (!error.empty()) {
+            fprintf(stderr, "%s\n", error.c_str());
+            num_failures++;
+          }
+        });
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Schedule([&files, &collector, context, i] {
+        std::string error;
+        std::vector<uint32_t> contents;
+        if (!ReadBinaryFile<uint32_t>(files[i].input.c_str(), &contents)) {
+          collector.Deliver(i, "error: could not read '" + files[i].input +
+                                   "'");
+          return;
+        }
+        std::stringstream ss;
+        spv_diagnostic diagnostic = nullptr;
+        if (BinaryToJson(context, contents.data(), contents.size(), &ss,
+                         &diagnostic)) {
+          error = "error: could not parse '" + files[i].input + "': " +
+                  (diagnostic ? diagnostic->error : "");
+          spvDiagnosticDestroy(diagnostic);
+          collector.Deliver(i, std::move(error));
+          return;
+        }
+        spvDiagnosticDestroy(diagnostic);
+        const std::string str = ss.str();
+        if (!WriteFile<char>(files[i].output.c_str(), "w", str.data(),
+                             str.size())) {
+          error = "error: could not write '" + files[i].output + "'";
+        }
+        collector.Deliver(i, std::move(error));
+      });
+    }
+    pool.Wait();
+  }
+  spvContextDestroy(context);
+
+  return num_failures == 0 ? 0 : 1;
+}
+
 int main(int, const char** argv) {
   if (!flags::Parse(argv)) {
     return 1;
@@ -65,6 +148,15 @@ int main(int, const char** argv) {
     return 0;
   }
 
+  if (!flags::file_list.value().empty()) {
+    if (!flags::positional_arguments.empty()) {
+      fprintf(stderr,
+              "error: --file-list cannot be combined with an input file.\n");
+      return 1;
+    }
+    return EmitFileList();
+  }
+
   if (flags::positional_arguments.size() != 1) {
     fprintf(stderr, "error: exactly one input file must be specified.\n");
     return 1;
@@ -80,8 +172,11 @@ int main(int, const char** argv) {
   spv_diagnostic diagnostic = nullptr;
 
   std::stringstream ss;
-  auto error =
-      BinaryToDot(context, contents.data(), contents.size(), &ss, &diagnostic);
+  auto error = flags::json.value()
+                   ? BinaryToJson(context, contents.data(), contents.size(),
+                                  &ss, &diagnostic)
+                   : BinaryToDot(context, contents.data(), contents.size(),
+                                 &ss, &diagnostic);
   if (error) {
     spvDiagnosticPrint(diagnostic);
     spvDiagnosticDestroy(diagnostic);
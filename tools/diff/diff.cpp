@@ -66,6 +66,10 @@ logical transformation from src to dst, in src's id-space.
                   Don't use set/binding decorations for variable matching.
   --ignore-location
                   Don't use location decorations for variable matching.
+
+  --jobs=<n>      Number of threads used to match functions between the two
+                  modules.  Defaults to 1; 0 means one thread per hardware
+                  thread context.  The output does not depend on this value.
 )",
          argv0, argv0);
 }
@@ -112,6 +116,7 @@ FLAG_LONG_bool( no_header,          /* default_value= */ false, /* required= */
 FLAG_LONG_bool( with_id_map,        /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool( ignore_set_binding, /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool( ignore_location,    /* default_value= */ false, /* required= */ false);
+FLAG_LONG_uint( jobs,               /* default_value= */ 1,     /* required= */ false);
 // clang-format on
 
 int main(int, const char* argv[]) {
@@ -152,6 +157,7 @@ int main(int, const char* argv[]) {
   options.dump_id_map = flags::with_id_map.value();
   options.ignore_set_binding = flags::ignore_set_binding.value();
   options.ignore_location = flags::ignore_location.value();
+  options.num_threads = flags::jobs.value();
 
   std::unique_ptr<spvtools::opt::IRContext> src = load_module(src_file.c_str());
   std::unique_ptr<spvtools::opt::IRContext> dst = load_module(dst_file.c_str());
@@ -22,8 +22,12 @@
 #include <string>
 #include <vector>
 
+#include "source/disassemble.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 #include "tools/io.h"
+#include "tools/util/async_io.h"
+#include "tools/util/file_list.h"
 #include "tools/util/flags.h"
 
 static const std::string kHelpText = R"(%s - Disassemble a SPIR-V binary module
@@ -57,6 +61,17 @@ Options:
   --offsets       Show byte offsets for each instruction.
 
   --comment       Add comments to make reading easier
+
+  --file-list=<file>
+                  Disassemble each file named in <file> instead of a single
+                  input.  Each non-empty line of <file> names an input file,
+                  optionally followed by an output file; '#' starts a comment.
+                  When a line gives no output, the input's extension is
+                  replaced with ".spvasm".  Use "-" to read the list from
+                  standard input.  Output never goes to standard output in
+                  this mode, so --color has no effect.
+  --jobs=<n>      Number of threads used to process a --file-list.  Defaults
+                  to 0, meaning one thread per hardware thread context.
 )";
 
 // clang-format off
@@ -71,10 +86,75 @@ FLAG_LONG_bool   (no_header, /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool   (raw_id,    /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool   (offsets,   /* default_value= */ false, /* required= */ false);
 FLAG_LONG_bool   (comment,   /* default_value= */ false, /* required= */ false);
+FLAG_LONG_string (file_list, /* default_value= */ "",    /* required= */ false);
+FLAG_LONG_uint   (jobs,      /* default_value= */ 0,     /* required= */ false);
 // clang-format on
 
 static const auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_5;
 
+// Disassembles every file named by --file-list on a thread pool, sharing a
+// single DisassemblyContext so the grammar tables are built only once.
+// Returns the process exit code.
+static int DisassembleFileList(uint32_t options) {
+  std::vector<FileListEntry> files;
+  if (!ReadFileList(flags::file_list.value().c_str(), ".spvasm", &files)) {
+    return 1;
+  }
+
+  spvtools::DisassemblyContext disassembly_context(kDefaultEnvironment,
+                                                   options);
+  if (!disassembly_context.IsValid()) {
+    fprintf(stderr, "error: could not create disassembler context.\n");
+    return 1;
+  }
+
+  // Each worker records failures here; messages are replayed in input order
+  // once all tasks have finished so the output is deterministic.
+  std::vector<std::string> errors(files.size());
+  {
+    const size_t num_threads =
+        flags::jobs.value() == 0
+            ? spvtools::utils::ThreadPool::DefaultThreadCount()
+            : flags::jobs.value();
+    // Inputs are prefetched on a reader thread and outputs retired on a
+    // writer thread, so the workers overlap disassembly of one file with the
+    // read of the next and the write of the previous.
+    std::vector<std::string> inputs;
+    inputs.reserve(files.size());
+    for (const FileListEntry& file : files) inputs.push_back(file.input);
+    AsyncBinaryFileReader reader(std::move(inputs), 2 * num_threads);
+    AsyncFileWriter writer;
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Schedule([&files, &errors, &disassembly_context, &reader, &writer,
+                     i] {
+        std::vector<uint32_t> contents;
+        if (!reader.Take(i, &contents)) {
+          errors[i] = "error: could not read '" + files[i].input + "'";
+          return;
+        }
+        std::string text;
+        if (!disassembly_context.Disassemble(contents, &text)) {
+          errors[i] = "error: could not disassemble '" + files[i].input + "'";
+          return;
+        }
+        writer.Write(files[i].output, "w", std::move(text), &errors[i]);
+      });
+    }
+    pool.Wait();
+    writer.Finish();
+  }
+
+  int num_failures = 0;
+  for (const std::string& error : errors) {
+    if (!error.empty()) {
+      fprintf(stderr, "%s\n", error.c_str());
+      num_failures++;
+    }
+  }
+  return num_failures == 0 ? 0 : 1;
+}
+
 int main(int, const char** argv) {
   if (!flags::Parse(argv)) {
     return 1;
@@ -122,6 +202,15 @@ int main(int, const char** argv) {
 
   if (flags::comment.value()) options |= SPV_BINARY_TO_TEXT_OPTION_COMMENT;
 
+  if (!flags::file_list.value().empty()) {
+    if (!flags::positional_arguments.empty()) {
+      fprintf(stderr,
+              "error: --file-list cannot be combined with an input file.\n");
+      return 1;
+    }
+    return DisassembleFileList(options);
+  }
+
   if (flags::o.value() == "-") {
     // Print to standard output.
     options |= SPV_BINARY_TO_TEXT_OPTION_PRINT;
@@ -170,6 +170,11 @@ Options (in lexicographical order):
   --shrink=
                File from which to read a sequence of transformations to shrink
                (instead of fuzzing)
+  --shrinker-jobs=
+               Unsigned 32-bit integer specifying the number of shrink
+               attempts to try in parallel.  The interestingness test must
+               tolerate concurrent invocations.  The default is 1.  Ignored
+               unless --shrink is used.
   --shrinker-step-limit=
                Unsigned 32-bit integer specifying maximum number of steps the
                shrinker will take before giving up.  Ignored unless --shrink
@@ -211,7 +216,7 @@ FuzzStatus ParseFlags(
     std::string* replay_transformations_file,
     std::vector<std::string>* interestingness_test,
     std::string* shrink_transformations_file,
-    std::string* shrink_temp_file_prefix,
+    std::string* shrink_temp_file_prefix, uint32_t* shrinker_jobs,
     spvtools::fuzz::RepeatedPassStrategy* repeated_pass_strategy,
     FuzzingTarget* fuzzing_target, spvtools::FuzzerOptions* fuzzer_options,
     spvtools::ValidatorOptions* validator_options) {
@@ -311,6 +316,15 @@ FuzzStatus ParseFlags(
             static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
         assert(end != split_flag.second.c_str() && errno == 0);
         fuzzer_options->set_random_seed(seed);
+      } else if (0 == strncmp(cur_arg, "--shrinker-jobs=",
+                              sizeof("--shrinker-jobs=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        char* end = nullptr;
+        errno = 0;
+        const auto jobs =
+            static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
+        assert(end != split_flag.second.c_str() && errno == 0);
+        *shrinker_jobs = jobs;
       } else if (0 == strncmp(cur_arg, "--shrinker-step-limit=",
                               sizeof("--shrinker-step-limit=") - 1)) {
         const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
@@ -514,7 +528,7 @@ bool Shrink(const spv_target_env& target_env,
             const std::vector<uint32_t>& binary_in,
             const spvtools::fuzz::protobufs::FactSequence& initial_facts,
             const std::string& shrink_transformations_file,
-            const std::string& shrink_temp_file_prefix,
+            const std::string& shrink_temp_file_prefix, uint32_t shrinker_jobs,
             const std::vector<std::string>& interestingness_command,
             std::vector<uint32_t>* binary_out,
             spvtools::fuzz::protobufs::TransformationSequence*
@@ -554,7 +568,8 @@ bool Shrink(const spv_target_env& target_env,
           target_env, spvtools::utils::CLIMessageConsumer, binary_in,
           initial_facts, transformation_sequence, interestingness_function,
           fuzzer_options->shrinker_step_limit,
-          fuzzer_options->replay_validation_enabled, validator_options)
+          fuzzer_options->replay_validation_enabled, validator_options,
+          shrinker_jobs)
           .Run();
 
   *binary_out = std::move(shrink_result.transformed_binary);
@@ -700,6 +715,7 @@ int main(int argc, const char** argv) {
   std::vector<std::string> interestingness_test;
   std::string shrink_transformations_file;
   std::string shrink_temp_file_prefix = "temp_";
+  uint32_t shrinker_jobs = 1;
   spvtools::fuzz::RepeatedPassStrategy repeated_pass_strategy;
   auto fuzzing_target = FuzzingTarget::kSpirv;
 
@@ -710,8 +726,8 @@ int main(int argc, const char** argv) {
       ParseFlags(argc, argv, &in_binary_file, &out_binary_file, &donors_file,
                  &replay_transformations_file, &interestingness_test,
                  &shrink_transformations_file, &shrink_temp_file_prefix,
-                 &repeated_pass_strategy, &fuzzing_target, &fuzzer_options,
-                 &validator_options);
+                 &shrinker_jobs, &repeated_pass_strategy, &fuzzing_target,
+                 &fuzzer_options, &validator_options);
 
   if (status.action == FuzzActions::STOP) {
     return status.code;
@@ -777,8 +793,8 @@ int main(int argc, const char** argv) {
       }
       if (!Shrink(target_env, fuzzer_options, validator_options, binary_in,
                   initial_facts, shrink_transformations_file,
-                  shrink_temp_file_prefix, interestingness_test, &binary_out,
-                  &transformations_applied)) {
+                  shrink_temp_file_prefix, shrinker_jobs, interestingness_test,
+                  &binary_out, &transformations_applied)) {
         return 1;
       }
     } break;
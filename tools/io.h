@@ -37,6 +37,13 @@
 #define SET_STDOUT_MODE(mode)
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+#define SPIRV_TOOLS_HAS_MMAP_OUTPUT 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 // Appends the contents of the |file| to |data|, assuming each element in the
 // file is of type |T|.
 template <typename T>
@@ -182,4 +189,49 @@ bool WriteFile(const char* filename, const char* mode, const T* data,
   return true;
 }
 
+// Writes |data|, an array of |count| elements of type |T|, to the binary
+// file named |filename| by growing or shrinking the file to its final size
+// and copying the elements into a writable memory mapping of it.  Compared
+// to WriteFile this skips the stdio buffer, so the data crosses into the
+// page cache exactly once.  Falls back to WriteFile when |filename| names
+// standard output or when the platform or filesystem cannot map the file.
+template <typename T>
+bool WriteFileMapped(const char* filename, const T* data, size_t count) {
+#if defined(SPIRV_TOOLS_HAS_MMAP_OUTPUT)
+  const bool use_stdout =
+      !filename || (filename[0] == '-' && filename[1] == '\0');
+  if (!use_stdout) {
+    const size_t num_bytes = count * sizeof(T);
+    // Do not truncate on open: rewriting a file in place keeps its inode,
+    // and only the pages the copy dirties are written back.
+    const int fd = open(filename, O_RDWR | O_CREAT, 0666);
+    if (fd >= 0) {
+      if (num_bytes == 0) {
+        const bool emptied = ftruncate(fd, 0) == 0;
+        close(fd);
+        if (emptied) return true;
+        fprintf(stderr, "error: could not write to file '%s'\n", filename);
+        return false;
+      }
+      if (ftruncate(fd, static_cast<off_t>(num_bytes)) == 0) {
+        void* mapping = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+          memcpy(mapping, data, num_bytes);
+          const bool flushed = munmap(mapping, num_bytes) == 0;
+          close(fd);
+          if (flushed) return true;
+          fprintf(stderr, "error: could not write to file '%s'\n", filename);
+          return false;
+        }
+      }
+      close(fd);
+      // The file may map poorly (e.g. it lives on a filesystem without mmap
+      // support); rewrite it from scratch through stdio instead.
+    }
+  }
+#endif
+  return WriteFile<T>(filename, "wb", data, count);
+}
+
 #endif  // TOOLS_IO_H_
@@ -0,0 +1,218 @@
+// Copyright (c) 2023 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "index.h"
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "source/opt/log.h"
+#include "spirv-tools/libspirv.hpp"
+#include "spirv/unified1/spirv.hpp"
+#include "tools/util/cli_consumer.h"
+
+namespace {
+
+constexpr auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_6;
+
+// Number of 32-bit words in a SPIR-V module header.
+constexpr uint32_t kHeaderNumWords = 5u;
+
+// The first line of the sidecar format, naming the format and its version.
+constexpr auto kIndexMagic = "SPIRV-OBJDUMP-INDEX 1";
+
+// Reads the NUL-terminated literal string starting at `begin`, stopping at
+// `end` if no terminator is found before it.
+std::string ReadLiteralString(const char* begin, const char* end) {
+  std::string result;
+  for (const char* p = begin; p != end && *p != '\0'; ++p) {
+    result.push_back(*p);
+  }
+  return result;
+}
+
+}  // namespace
+
+bool BuildModuleIndex(const std::vector<uint32_t>& binary,
+                      ModuleIndex* index) {
+  assert(index != nullptr);
+  auto context = spvtools::SpirvTools(kDefaultEnvironment);
+  context.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+
+  *index = ModuleIndex();
+
+  spvtools::HeaderParser headerParser =
+      [index](const spv_endianness_t, const spv_parsed_header_t& header) {
+        index->id_bound = header.bound;
+        return SPV_SUCCESS;
+      };
+
+  // The parser hands out instructions in module order, so the byte offset of
+  // each one is the running word count times the word size.
+  uint32_t wordOffset = kHeaderNumWords;
+  bool sawFunction = false;
+  spvtools::InstructionParser instructionParser =
+      [index, &wordOffset,
+       &sawFunction](const spv_parsed_instruction_t& instruction) {
+        const spv::Op opcode = static_cast<spv::Op>(instruction.opcode);
+        if (opcode == spv::Op::OpEntryPoint) {
+          // Operands are: execution model, function id, name, interface ids.
+          const auto& nameOperand = instruction.operands[2];
+          const char* nameBegin = reinterpret_cast<const char*>(
+              instruction.words + nameOperand.offset);
+          const char* nameEnd = reinterpret_cast<const char*>(
+              instruction.words + nameOperand.offset + nameOperand.num_words);
+          index->entry_points.push_back(
+              {instruction.words[2], ReadLiteralString(nameBegin, nameEnd)});
+        } else if (opcode == spv::Op::OpFunction) {
+          if (!sawFunction) {
+            sawFunction = true;
+            index->globals_byte_offset = kHeaderNumWords * 4u;
+            index->globals_byte_size =
+                (wordOffset - kHeaderNumWords) * 4u;
+          }
+          index->functions.push_back(
+              {instruction.result_id, wordOffset * 4u, 0u});
+        } else if (opcode == spv::Op::OpFunctionEnd) {
+          if (index->functions.empty()) {
+            spvtools::Error(spvtools::utils::CLIMessageConsumer, "", {},
+                            "OpFunctionEnd without a matching OpFunction.");
+            return SPV_ERROR_INVALID_BINARY;
+          }
+          FunctionRange& range = index->functions.back();
+          range.byte_size =
+              (wordOffset + instruction.num_words) * 4u - range.byte_offset;
+        }
+        wordOffset += instruction.num_words;
+        return SPV_SUCCESS;
+      };
+
+  if (!context.Parse(binary, headerParser, instructionParser)) {
+    return false;
+  }
+
+  if (!sawFunction) {
+    // A module without functions is all preamble.
+    index->globals_byte_offset = kHeaderNumWords * 4u;
+    index->globals_byte_size = wordOffset * 4u - index->globals_byte_offset;
+  }
+  return true;
+}
+
+std::string SerializeModuleIndex(const ModuleIndex& index) {
+  std::ostringstream out;
+  out << kIndexMagic << "\n";
+  out << "bound " << index.id_bound << "\n";
+  out << "globals " << index.globals_byte_offset << " "
+      << index.globals_byte_size << "\n";
+  // The name goes last on the line because it may contain spaces.
+  for (const auto& entry_point : index.entry_points) {
+    out << "entrypoint " << entry_point.function_id << " " << entry_point.name
+        << "\n";
+  }
+  for (const auto& function : index.functions) {
+    out << "function " << function.id << " " << function.byte_offset << " "
+        << function.byte_size << "\n";
+  }
+  return out.str();
+}
+
+bool DeserializeModuleIndex(const std::string& text, ModuleIndex* index) {
+  assert(index != nullptr);
+  *index = ModuleIndex();
+
+  std::istringstream in(text);
+  std::string line;
+  if (!std::getline(in, line) || line != kIndexMagic) {
+    spvtools::Error(spvtools::utils::CLIMessageConsumer, "", {},
+                    "Unrecognized index file format.");
+    return false;
+  }
+
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    std::istringstream fields(line);
+    std::string record;
+    fields >> record;
+    if (record == "bound") {
+      fields >> index->id_bound;
+    } else if (record == "globals") {
+      fields >> index->globals_byte_offset >> index->globals_byte_size;
+    } else if (record == "entrypoint") {
+      EntryPointRecord entry_point;
+      fields >> entry_point.function_id;
+      fields.ignore(1);  // Skip the separator before the name.
+      std::getline(fields, entry_point.name);
+      index->entry_points.push_back(std::move(entry_point));
+    } else if (record == "function") {
+      FunctionRange function = {};
+      fields >> function.id >> function.byte_offset >> function.byte_size;
+      index->functions.push_back(function);
+    }
+    if (fields.fail()) {
+      spvtools::Error(spvtools::utils::CLIMessageConsumer, "", {},
+                      "Malformed index record.");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ExtractFunctionBinary(const std::vector<uint32_t>& binary,
+                           const ModuleIndex& index, uint32_t function_id,
+                           std::vector<uint32_t>* output) {
+  assert(output != nullptr);
+
+  const FunctionRange* range = nullptr;
+  for (const auto& function : index.functions) {
+    if (function.id == function_id) {
+      range = &function;
+      break;
+    }
+  }
+  if (range == nullptr) {
+    spvtools::Error(spvtools::utils::CLIMessageConsumer, "", {},
+                    "Function id is not listed in the index.");
+    return false;
+  }
+
+  const uint64_t binary_byte_size = uint64_t(binary.size()) * 4u;
+  const auto rangeIsValid = [binary_byte_size](uint64_t offset,
+                                               uint64_t size) {
+    return offset % 4u == 0 && size % 4u == 0 &&
+           offset + size <= binary_byte_size;
+  };
+  if (binary.size() < kHeaderNumWords ||
+      !rangeIsValid(index.globals_byte_offset, index.globals_byte_size) ||
+      !rangeIsValid(range->byte_offset, range->byte_size)) {
+    spvtools::Error(spvtools::utils::CLIMessageConsumer, "", {},
+                    "Index does not match the binary.");
+    return false;
+  }
+
+  output->clear();
+  output->insert(output->end(), binary.begin(),
+                 binary.begin() + kHeaderNumWords);
+  output->insert(output->end(),
+                 binary.begin() + index.globals_byte_offset / 4u,
+                 binary.begin() + (index.globals_byte_offset +
+                                   index.globals_byte_size) /
+                                      4u);
+  output->insert(output->end(), binary.begin() + range->byte_offset / 4u,
+                 binary.begin() + (range->byte_offset + range->byte_size) /
+                                      4u);
+  return true;
+}
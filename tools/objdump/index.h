@@ -0,0 +1,78 @@
+// Copyright (c) 2023 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDE_SPIRV_TOOLS_OBJDUMP_INDEX_HPP_
+#define INCLUDE_SPIRV_TOOLS_OBJDUMP_INDEX_HPP_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// The byte range of one function definition inside a module, from its
+// OpFunction instruction up to and including its OpFunctionEnd.
+struct FunctionRange {
+  uint32_t id;           // Result id of the OpFunction instruction.
+  uint32_t byte_offset;  // Offset of the OpFunction instruction.
+  uint32_t byte_size;    // Size of the definition, OpFunctionEnd included.
+};
+
+// One OpEntryPoint record: the name under which the entry point is exported,
+// and the id of the function it designates.
+struct EntryPointRecord {
+  uint32_t function_id;
+  std::string name;
+};
+
+// A random-access index over a SPIR-V binary: where each function definition
+// lives, which functions are entry points, and the byte range holding every
+// instruction that precedes the first function (types, constants, global
+// variables and debug instructions).  Together with the 20-byte module
+// header, that preamble is all the context a single function definition
+// needs to disassemble.
+struct ModuleIndex {
+  uint32_t id_bound = 0;
+  uint32_t globals_byte_offset = 0;
+  uint32_t globals_byte_size = 0;
+  std::vector<EntryPointRecord> entry_points;
+  std::vector<FunctionRange> functions;
+};
+
+// Walks `binary` once and fills `index` with its layout.
+//
+// Returns `true` if the walk succeeded, `false` otherwise.
+// `index` value is undefined if `false` is returned.
+bool BuildModuleIndex(const std::vector<uint32_t>& binary, ModuleIndex* index);
+
+// Renders `index` in the sidecar text format, one record per line.
+std::string SerializeModuleIndex(const ModuleIndex& index);
+
+// Parses `text`, produced by SerializeModuleIndex, back into `index`.
+//
+// Returns `true` if the parse succeeded, `false` otherwise.
+// `index` value is undefined if `false` is returned.
+bool DeserializeModuleIndex(const std::string& text, ModuleIndex* index);
+
+// Assembles a standalone module holding only the function `function_id` from
+// `binary`: the module header, the global preamble recorded in `index`, and
+// that function's definition.  Only the indexed byte ranges of `binary` are
+// read.
+//
+// Returns `true` if the function is indexed and its ranges lie inside
+// `binary`, `false` otherwise.  `output` value is undefined if `false` is
+// returned.
+bool ExtractFunctionBinary(const std::vector<uint32_t>& binary,
+                           const ModuleIndex& index, uint32_t function_id,
+                           std::vector<uint32_t>* output);
+
+#endif  // INCLUDE_SPIRV_TOOLS_OBJDUMP_INDEX_HPP_
@@ -12,11 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "extract_source.h"
+#include "index.h"
+#include "text_cache.h"
 #include "source/opt/log.h"
+#include "spirv-tools/libspirv.hpp"
 #include "tools/io.h"
 #include "tools/util/cli_consumer.h"
 #include "tools/util/flags.h"
@@ -32,6 +39,11 @@ one of the following switches must be given:
   --source        Extract source files obtained from debug symbols, output to stdout.
   --entrypoint    Extracts the entrypoint name of the module, output to stdout.
   --compiler-cmd  Extracts the command line used to compile this module, output to stdout.
+  --build-index   Walk the module once and write a sidecar index of its layout
+                  (id bound, entry points, per-function byte ranges).
+  --function      Disassemble a single function, located through the sidecar
+                  index instead of re-parsing the module, output to stdout.
+                  Takes the function's id, or the name of an entry point.
 
 
 General options:
@@ -43,6 +55,17 @@ Source dump options:
   --list          Do not extract source code, only print filenames to stdout.
   --outdir        Where shall the exrtacted HLSL/HLSL files be written to?
                   File written to stdout if '-' is given. Default is `-`.
+
+Index options:
+  --index         Path of the sidecar index to write (with --build-index) or
+                  read (with --function). Written to stdout if '-' is given.
+                  Default is the input filename with `.spvidx` appended.
+  --dis-cache     Directory holding a content-addressed cache of function
+                  disassembly, shared between invocations. With --function,
+                  repeat queries for an unchanged function are answered from
+                  the cache without re-disassembling; stale entries are
+                  evicted least-recently-used. Empty (the default) disables
+                  the cache.
 )";
 
 // Removes trailing '/' from `input`.
@@ -109,6 +132,10 @@ FLAG_SHORT_bool(  f,            /* default_value= */ false, /* required= */ fals
 FLAG_LONG_bool(   force,        /* default_value= */ false, /* required= */ false);
 FLAG_LONG_string( outdir,       /* default_value= */ "-",   /* required= */ false);
 FLAG_LONG_bool(   list,         /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool(   build_index,  /* default_value= */ false, /* required= */ false);
+FLAG_LONG_string( index,        /* default_value= */ "",    /* required= */ false);
+FLAG_LONG_string( function,     /* default_value= */ "",    /* required= */ false);
+FLAG_LONG_string( dis_cache,    /* default_value= */ "",    /* required= */ false);
 // clang-format on
 
 int main(int, const char** argv) {
@@ -169,6 +196,105 @@ int main(int, const char** argv) {
     }
   }
 
+  const std::string index_path =
+      flags::index.value().empty()
+          ? flags::positional_arguments[0] + ".spvidx"
+          : flags::index.value();
+
+  if (flags::build_index.value()) {
+    ModuleIndex index;
+    if (!BuildModuleIndex(binary, &index)) {
+      return 1;
+    }
+
+    const std::string serialized = SerializeModuleIndex(index);
+    if (index_path == "-") {
+      printf("%s", serialized.c_str());
+      return 0;
+    }
+    if (!flags::force.value() && std::filesystem::exists(index_path)) {
+      std::cerr << "file " << index_path
+                << " already exists, aborting (use --force to allow it)."
+                << std::endl;
+      return 1;
+    }
+    if (!WriteFile<char>(index_path.c_str(), "w", serialized.c_str(),
+                         serialized.size())) {
+      return 1;
+    }
+    return 0;
+  }
+
+  if (!flags::function.value().empty()) {
+    std::vector<char> indexText;
+    if (!ReadTextFile(index_path.c_str(), &indexText)) {
+      return 1;
+    }
+    ModuleIndex index;
+    if (!DeserializeModuleIndex(
+            std::string(indexText.begin(), indexText.end()), &index)) {
+      return 1;
+    }
+
+    // The function is designated either by its id or by an entry point name.
+    const std::string& wanted = flags::function.value();
+    uint32_t functionId = 0;
+    if (std::all_of(wanted.begin(), wanted.end(),
+                    [](char c) { return '0' <= c && c <= '9'; })) {
+      functionId =
+          static_cast<uint32_t>(std::strtoul(wanted.c_str(), nullptr, 10));
+    } else {
+      for (const auto& entryPoint : index.entry_points) {
+        if (entryPoint.name == wanted) {
+          functionId = entryPoint.function_id;
+          break;
+        }
+      }
+      if (functionId == 0) {
+        std::cerr << "error: no entry point named '" << wanted
+                  << "' in the index." << std::endl;
+        return 1;
+      }
+    }
+
+    std::vector<uint32_t> functionBinary;
+    if (!ExtractFunctionBinary(binary, index, functionId, &functionBinary)) {
+      return 1;
+    }
+
+    constexpr uint32_t kDisassemblyOptions =
+        SPV_BINARY_TO_TEXT_OPTION_NO_COLOR |
+        SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+        SPV_BINARY_TO_TEXT_OPTION_INDENT;
+
+    // The extracted function (with its module preamble) is self-contained,
+    // so its words and the options fully determine the disassembly; answer
+    // repeat queries from the cache when one is configured.
+    const std::string& cacheDir = flags::dis_cache.value();
+    uint64_t cacheKey = 0;
+    if (!cacheDir.empty()) {
+      cacheKey = DisassemblyCacheKey(functionBinary, kDisassemblyOptions);
+      std::string cached;
+      if (DisassemblyCacheLookup(cacheDir, cacheKey, &cached)) {
+        printf("%s", cached.c_str());
+        return 0;
+      }
+    }
+
+    spvtools::SpirvTools tools(SPV_ENV_UNIVERSAL_1_6);
+    tools.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+    std::string disassembly;
+    if (!tools.Disassemble(functionBinary, &disassembly,
+                           kDisassemblyOptions)) {
+      return 1;
+    }
+    if (!cacheDir.empty()) {
+      DisassemblyCacheStore(cacheDir, cacheKey, disassembly);
+    }
+    printf("%s", disassembly.c_str());
+    return 0;
+  }
+
   // FIXME: implement logic.
   return 0;
 }
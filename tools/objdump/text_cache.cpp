@@ -0,0 +1,107 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "text_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "spirv-tools/libspirv.h"
+#include "tools/io.h"
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+constexpr char kEntryExtension[] = ".spvasm";
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+std::filesystem::path EntryPath(const std::string& dir, uint64_t key) {
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64 "%s", key, kEntryExtension);
+  return std::filesystem::path(dir) / name;
+}
+
+// Removes the oldest entries of `dir` until at most
+// kDisassemblyCacheCapacity remain.  Filesystem errors are swallowed: a
+// failed eviction only means the cache is larger than intended.
+void EvictLeastRecentlyUsed(const std::string& dir) {
+  std::error_code ec;
+  std::vector<std::pair<std::filesystem::file_time_type,
+                        std::filesystem::path>> entries;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.path().extension() != kEntryExtension) continue;
+    std::error_code entry_ec;
+    const auto time = entry.last_write_time(entry_ec);
+    if (entry_ec) continue;
+    entries.emplace_back(time, entry.path());
+  }
+  if (ec || entries.size() <= kDisassemblyCacheCapacity) return;
+  std::sort(entries.begin(), entries.end());
+  const size_t excess = entries.size() - kDisassemblyCacheCapacity;
+  for (size_t i = 0; i < excess; ++i) {
+    std::filesystem::remove(entries[i].second, ec);
+  }
+}
+
+}  // namespace
+
+uint64_t DisassemblyCacheKey(const std::vector<uint32_t>& binary,
+                             uint32_t options) {
+  const char* version = spvSoftwareVersionDetailsString();
+  uint64_t hash = HashBytes(version, strlen(version), kFnvOffsetBasis);
+  hash = HashBytes(&options, sizeof(options), hash);
+  return HashBytes(binary.data(), binary.size() * sizeof(uint32_t), hash);
+}
+
+bool DisassemblyCacheLookup(const std::string& dir, uint64_t key,
+                            std::string* text) {
+  const std::filesystem::path path = EntryPath(dir, key);
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec) || ec) return false;
+  std::vector<char> content;
+  if (!ReadTextFile(path.string().c_str(), &content)) return false;
+  text->assign(content.begin(), content.end());
+  // Refresh the timestamp so eviction is least-recently-used rather than
+  // least-recently-written.
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now(), ec);
+  return true;
+}
+
+bool DisassemblyCacheStore(const std::string& dir, uint64_t key,
+                           const std::string& text) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) return false;
+  const std::filesystem::path path = EntryPath(dir, key);
+  if (!WriteFileMapped<char>(path.string().c_str(), text.c_str(),
+                             text.size())) {
+    return false;
+  }
+  EvictLeastRecentlyUsed(dir);
+  return true;
+}
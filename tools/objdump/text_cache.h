@@ -0,0 +1,52 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDE_SPIRV_TOOLS_OBJDUMP_TEXT_CACHE_HPP_
+#define INCLUDE_SPIRV_TOOLS_OBJDUMP_TEXT_CACHE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// A content-addressed cache of disassembly text for repeatedly inspected
+// functions.  Entries are files in a cache directory, named by the key, so
+// independent invocations of the tool share one cache.  Eviction is least
+// recently used, by file timestamp; a lookup hit refreshes its entry.
+
+// The number of entries kept in a cache directory before the least recently
+// used ones are evicted.
+constexpr size_t kDisassemblyCacheCapacity = 256;
+
+// Computes the cache key for disassembling `binary` with the binary-to-text
+// `options`.  The tool version takes part in the key so that text produced
+// by an older disassembler is never served.
+uint64_t DisassemblyCacheKey(const std::vector<uint32_t>& binary,
+                             uint32_t options);
+
+// Returns `true` and fills `text` when the cache directory `dir` holds an
+// entry for `key`, refreshing the entry's timestamp.  Returns `false` on a
+// miss or when the entry cannot be read.
+bool DisassemblyCacheLookup(const std::string& dir, uint64_t key,
+                            std::string* text);
+
+// Stores `text` under `key` in `dir`, creating the directory if necessary,
+// then evicts the least recently used entries beyond
+// kDisassemblyCacheCapacity.  Returns `false` when the entry cannot be
+// written; the cache is best-effort, so callers may ignore the result.
+bool DisassemblyCacheStore(const std::string& dir, uint64_t key,
+                           const std::string& text);
+
+#endif  // INCLUDE_SPIRV_TOOLS_OBJDUMP_TEXT_CACHE_HPP_
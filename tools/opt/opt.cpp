@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -23,8 +24,11 @@
 #include <vector>
 
 #include "source/opt/log.h"
+#include "source/opt/module_waves.h"
 #include "source/spirv_target_env.h"
+#include "source/util/ordered_collector.h"
 #include "source/util/string_utils.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.hpp"
 #include "spirv-tools/optimizer.hpp"
 #include "tools/io.h"
@@ -79,6 +83,33 @@ std::string GetSizePasses() {
   return GetListOfPassesAsString(optimizer);
 }
 
+// Returns a 64-bit FNV-1a hash of |words|.  Used as a stable fingerprint of
+// the input module so that profile rows from different invocations on the
+// same module can be correlated.
+uint64_t FingerprintWords(const std::vector<uint32_t>& words) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (uint32_t word : words) {
+    for (int byte = 0; byte < 4; ++byte) {
+      hash ^= (word >> (8 * byte)) & 0xffu;
+      hash *= 0x100000001b3ull;
+    }
+  }
+  return hash;
+}
+
+// Options for the concatenated-module container mode (--container).  The
+// pass flags and target environment are recorded during flag parsing so that
+// a fresh Optimizer can be configured for every module in the container.
+struct ContainerOptions {
+  bool enabled = false;
+  size_t num_threads = 0;  // 0 selects one thread per hardware core.
+  // When non-zero, optimize the module in bounded-memory waves of this many
+  // functions (--wave-size).
+  size_t wave_size = 0;
+  spv_target_env target_env = kDefaultEnvironment;
+  std::vector<std::string> pass_flags;
+};
+
 void PrintUsage(const char* program) {
   std::string target_env_list = spvTargetEnvList(16, 80);
   // NOTE: Please maintain flags in lexicographical order.
@@ -126,6 +157,18 @@ Options (in lexicographical order):)",
                Remap result ids to a compact range starting from %%1 and without
                any gaps.)");
   printf(R"(
+  --container
+               Treat <input> and <output> as containers holding a sequence of
+               SPIR-V modules, each prefixed by one 32-bit word holding its
+               word count.  Every module is optimized with the same passes,
+               spread across worker threads (see -j), and the optimized
+               modules are written in their original order.)");
+  printf(R"(
+  -j <N>
+               In --container mode, optimize modules on N worker threads.  An
+               N of 0 selects one thread per hardware core, and is the
+               default.)");
+  printf(R"(
   --convert-local-access-chains
                Convert constant index access chain loads/stores into
                equivalent load/stores with inserts and extracts. Performed
@@ -231,6 +274,19 @@ Options (in lexicographical order):)",
                loads and stores. Performed only on entry point call tree
                functions.)");
   printf(R"(
+  --embed-analysis-metadata
+               Serialize each function's dominator tree and loop structure
+               into a non-semantic extended instruction set, so downstream
+               consumers of the module can reuse them instead of recomputing
+               them. Replaces metadata embedded by an earlier run.)");
+  printf(R"(
+  --emit-summary=<file>
+               Write a compact binary summary of the optimized module to
+               <file>: id bound, instruction count, capabilities, entry
+               point execution models and a debug-info flag.  The layout is
+               documented on Optimizer::SetEmitModuleSummary() and can be
+               read without parsing SPIR-V.)");
+  printf(R"(
   --fix-func-call-param
                fix non memory argument for the function call, replace 
                accesschain pointer argument with a variable.)");
@@ -248,6 +304,11 @@ Options (in lexicographical order):)",
                Freeze the values of specialization constants to their default
                values.)");
   printf(R"(
+  --fused-peephole
+               Apply several compatible peephole rule sets in a single module
+               traversal: strength reduction of integer multiplies by constant
+               powers of two plus the simplify-instructions rewrites.)");
+  printf(R"(
   --graphics-robust-access
                Clamp indices used to access buffers and internal composite
                values, providing guarantees that satisfy Vulkan's
@@ -261,6 +322,19 @@ Options (in lexicographical order):)",
                functions. Currently does not inline calls to functions with
                early return in a loop.)");
   printf(R"(
+  --inline-heuristic[=<growth_percent>]
+               Inline the most profitable call sites first, stopping once the
+               module has grown by <growth_percent> percent of its starting
+               size (default 25). Call sites in deeply nested loops are
+               expanded before others, and smaller callees before larger
+               ones.)");
+  printf(R"(
+  --ip-constant-prop
+               Propagate constant arguments across function calls. Parameters
+               that receive the same constant value from every call site have
+               their uses replaced by that constant. Entry points and exported
+               functions are not changed.)");
+  printf(R"(
   --legalize-hlsl
                Runs a series of optimizations that attempts to take SPIR-V
                generated by an HLSL front-end and generates legal Vulkan SPIR-V.
@@ -396,6 +470,12 @@ Options (in lexicographical order):)",
                Ensure that the optimizer preserves all specialization constants declared
                within the module, even when those constants are unused.)");
   printf(R"(
+  --pressure-scheduling
+               Reorder instructions within each basic block to shorten live
+               ranges and reduce register pressure. Pure instructions move to
+               just before their first use; memory operations, calls and
+               barriers are never reordered.)");
+  printf(R"(
   --print-all
                Print SPIR-V assembly to standard error output before each pass
                and after the last pass.)");
@@ -404,6 +484,14 @@ Options (in lexicographical order):)",
                Change the scope of private variables that are used in a single
                function to that function.)");
   printf(R"(
+  --profile-out=<file>
+               Append one CSV row per executed pass to <file>, recording the
+               input module's fingerprint (content hash, word count, id
+               bound) together with the pass name, wall and CPU time,
+               instruction and id-bound deltas, and analysis churn.  A header
+               row is written when <file> is new or empty, so repeated
+               invocations accumulate a single machine-readable log.)");
+  printf(R"(
   --reduce-load-size[=<threshold>]
                Replaces loads of composite objects where not every component is
                used by loads of just the elements that are used.  If the ratio
@@ -446,6 +534,13 @@ Options (in lexicographical order):)",
                but not for the current shader stage.  To have an effect, all
                entry points must have the same execution model.)");
   printf(R"(
+  --result-cache-dir=<directory>
+               Cache optimized binaries in <directory>, which must already
+               exist.  When the same module is optimized again with the same
+               passes and options, the result is read back from the cache
+               instead of being recomputed.  The cache can be shared between
+               concurrent invocations.)");
+  printf(R"(
   --ssa-rewrite
                Replace loads and stores to function local variables with
                operations on SSA IDs.)");
@@ -520,6 +615,14 @@ Options (in lexicographical order):)",
                removes them from the vector.  Note this would still leave around
                lots of dead code that a pass of ADCE will be able to remove.)");
   printf(R"(
+  --wave-size=<n>
+               Optimize the module in waves of <n> functions to bound peak
+               memory: each wave is loaded, optimized with the registered
+               passes, and serialized back before the next one, with
+               module-scope instructions pinned.  Passes that remove
+               module-scope instructions or whole functions cannot be used in
+               this mode; validation of the intermediate waves is skipped.)");
+  printf(R"(
   --workaround-1209
                Rewrites instructions for which there are known driver bugs to
                avoid triggering those bugs.
@@ -600,7 +703,9 @@ OptStatus ParseFlags(int argc, const char** argv,
                      spvtools::Optimizer* optimizer, const char** in_file,
                      const char** out_file,
                      spvtools::ValidatorOptions* validator_options,
-                     spvtools::OptimizerOptions* optimizer_options);
+                     spvtools::OptimizerOptions* optimizer_options,
+                     ContainerOptions* container_options,
+                     std::string* summary_file, std::string* profile_file);
 
 // Parses and handles the -Oconfig flag. |prog_name| contains the name of
 // the spirv-opt binary (used to build a new argv vector for the recursive
@@ -613,7 +718,10 @@ OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
                            spvtools::Optimizer* optimizer, const char** in_file,
                            const char** out_file,
                            spvtools::ValidatorOptions* validator_options,
-                           spvtools::OptimizerOptions* optimizer_options) {
+                           spvtools::OptimizerOptions* optimizer_options,
+                           ContainerOptions* container_options,
+                           std::string* summary_file,
+                           std::string* profile_file) {
   std::vector<std::string> flags;
   flags.push_back(prog_name);
 
@@ -636,9 +744,10 @@ OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
     new_argv[i] = flags[i].c_str();
   }
 
-  auto ret_val =
-      ParseFlags(static_cast<int>(flags.size()), new_argv, optimizer, in_file,
-                 out_file, validator_options, optimizer_options);
+  auto ret_val = ParseFlags(static_cast<int>(flags.size()), new_argv,
+                            optimizer, in_file, out_file, validator_options,
+                            optimizer_options, container_options,
+                            summary_file, profile_file);
   delete[] new_argv;
   return ret_val;
 }
@@ -688,14 +797,18 @@ std::string CanonicalizeFlag(const char** argv, int argc, int* argi) {
 // Optimizer instance used to optimize the program.
 //
 // On return, this function stores the name of the input program in |in_file|.
-// The name of the output file in |out_file|. The return value indicates whether
+// The name of the output file in |out_file|. When --emit-summary is given,
+// the summary file name is stored in |summary_file|.
+// The return value indicates whether
 // optimization should continue and a status code indicating an error or
 // success.
 OptStatus ParseFlags(int argc, const char** argv,
                      spvtools::Optimizer* optimizer, const char** in_file,
                      const char** out_file,
                      spvtools::ValidatorOptions* validator_options,
-                     spvtools::OptimizerOptions* optimizer_options) {
+                     spvtools::OptimizerOptions* optimizer_options,
+                     ContainerOptions* container_options,
+                     std::string* summary_file, std::string* profile_file) {
   std::vector<std::string> pass_flags;
   for (int argi = 1; argi < argc; ++argi) {
     const char* cur_arg = argv[argi];
@@ -724,12 +837,32 @@ OptStatus ParseFlags(int argc, const char** argv,
           return {OPT_STOP, 1};
         }
       } else if (0 == strncmp(cur_arg, "-Oconfig=", sizeof("-Oconfig=") - 1)) {
-        OptStatus status =
-            ParseOconfigFlag(argv[0], cur_arg, optimizer, in_file, out_file,
-                             validator_options, optimizer_options);
+        OptStatus status = ParseOconfigFlag(
+            argv[0], cur_arg, optimizer, in_file, out_file, validator_options,
+            optimizer_options, container_options, summary_file, profile_file);
         if (status.action != OPT_CONTINUE) {
           return status;
         }
+      } else if (0 == strcmp(cur_arg, "--container")) {
+        container_options->enabled = true;
+      } else if (0 == strcmp(cur_arg, "-j")) {
+        unsigned count = 0;
+        if (argi + 1 >= argc || !sscanf(argv[++argi], "%u", &count)) {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "Missing or invalid argument to -j");
+          return {OPT_STOP, 1};
+        }
+        container_options->num_threads = count;
+      } else if (0 == strncmp(cur_arg, "--wave-size=",
+                              sizeof("--wave-size=") - 1)) {
+        unsigned count = 0;
+        auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        if (!sscanf(split_flag.second.c_str(), "%u", &count) || count == 0) {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "Invalid argument to --wave-size");
+          return {OPT_STOP, 1};
+        }
+        container_options->wave_size = count;
       } else if (0 == strcmp(cur_arg, "--skip-validation")) {
         optimizer_options->set_run_validator(false);
       } else if (0 == strcmp(cur_arg, "--print-all")) {
@@ -740,6 +873,33 @@ OptStatus ParseFlags(int argc, const char** argv,
         optimizer_options->set_preserve_spec_constants(true);
       } else if (0 == strcmp(cur_arg, "--time-report")) {
         optimizer->SetTimeReport(&std::cerr);
+      } else if (0 == strncmp(cur_arg, "--result-cache-dir=",
+                              sizeof("--result-cache-dir=") - 1)) {
+        auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        if (split_flag.second.empty()) {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "Missing argument to --result-cache-dir");
+          return {OPT_STOP, 1};
+        }
+        optimizer->SetResultCacheDirectory(split_flag.second);
+      } else if (0 == strncmp(cur_arg, "--emit-summary=",
+                              sizeof("--emit-summary=") - 1)) {
+        auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        if (split_flag.second.empty()) {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "Missing argument to --emit-summary");
+          return {OPT_STOP, 1};
+        }
+        *summary_file = split_flag.second;
+      } else if (0 == strncmp(cur_arg, "--profile-out=",
+                              sizeof("--profile-out=") - 1)) {
+        auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        if (split_flag.second.empty()) {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "Missing argument to --profile-out");
+          return {OPT_STOP, 1};
+        }
+        *profile_file = split_flag.second;
       } else if (0 == strcmp(cur_arg, "--relax-struct-store")) {
         validator_options->SetRelaxStructStore(true);
       } else if (0 == strncmp(cur_arg, "--max-id-bound=",
@@ -770,6 +930,7 @@ OptStatus ParseFlags(int argc, const char** argv,
           return {OPT_STOP, 1};
         }
         optimizer->SetTargetEnv(target_env);
+        container_options->target_env = target_env;
       } else if (0 == strcmp(cur_arg, "--validate-after-all")) {
         optimizer->SetValidateAfterAll(true);
       } else if (0 == strcmp(cur_arg, "--before-hlsl-legalization")) {
@@ -811,10 +972,153 @@ OptStatus ParseFlags(int argc, const char** argv,
   if (!optimizer->RegisterPassesFromFlags(pass_flags)) {
     return {OPT_STOP, 1};
   }
+  // Record the flags so container mode can configure a fresh Optimizer per
+  // module.  Appending mirrors the registration order: an -Oconfig file's
+  // flags are appended during the recursive ParseFlags call above, exactly
+  // when they are registered with |optimizer|.
+  container_options->pass_flags.insert(container_options->pass_flags.end(),
+                                       pass_flags.begin(), pass_flags.end());
 
   return {OPT_CONTINUE, 0};
 }
 
+// Reads the module container in |in_file|, optimizes every module it holds
+// on worker threads, and writes the optimized container to |out_file| with
+// the modules in their original order.  In a container every module is
+// prefixed by one 32-bit word holding its word count.  Each module is
+// streamed to |out_file| as soon as it and all its predecessors are done,
+// so the write overlaps the optimization of the later modules.  Returns the
+// process exit code.
+int RunContainer(const char* in_file, const char* out_file,
+                 const ContainerOptions& container_options,
+                 spvtools::OptimizerOptions& optimizer_options) {
+  std::vector<uint32_t> words;
+  if (!ReadBinaryFile<uint32_t>(in_file, &words)) return 1;
+
+  // A module's words inside |words|.
+  struct ModuleRange {
+    size_t begin;
+    size_t count;
+  };
+
+  std::vector<ModuleRange> modules;
+  for (size_t offset = 0; offset < words.size();) {
+    const size_t count = words[offset++];
+    if (count == 0 || count > words.size() - offset) {
+      spvtools::Error(opt_diagnostic, nullptr, {},
+                      "Malformed module container: bad module word count");
+      return 1;
+    }
+    modules.push_back({offset, count});
+    offset += count;
+  }
+
+  size_t num_threads = container_options.num_threads;
+  if (num_threads == 0) {
+    num_threads = spvtools::utils::ThreadPool::DefaultThreadCount();
+  }
+  bool all_ok = true;
+  bool write_ok = true;
+  {
+    OutputFile file(out_file, "wb");
+    FILE* fp = file.GetFileHandle();
+    if (fp == nullptr) {
+      fprintf(stderr, "error: could not open file '%s'\n", out_file);
+      return 1;
+    }
+
+    // The outcome of optimizing one module.
+    struct ModuleResult {
+      std::vector<uint32_t> optimized;
+      bool ok = false;
+    };
+    // Modules are written in container order as soon as each one and all of
+    // its predecessors are optimized; the collector's window also bounds how
+    // many optimized modules can pile up waiting for a slow predecessor.
+    spvtools::utils::OrderedCollector<ModuleResult> collector(
+        2 * num_threads,
+        [fp, out_file, &all_ok, &write_ok](size_t, ModuleResult&& result) {
+          all_ok = all_ok && result.ok;
+          if (!write_ok) return;
+          const uint32_t count =
+              static_cast<uint32_t>(result.optimized.size());
+          if (fwrite(&count, sizeof(count), 1, fp) != 1 ||
+              fwrite(result.optimized.data(), sizeof(uint32_t), count, fp) !=
+                  count) {
+            fprintf(stderr, "error: could not write to file '%s'\n",
+                    out_file);
+            write_ok = false;
+          }
+        });
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < modules.size(); ++i) {
+      const ModuleRange module = modules[i];
+      pool.Schedule([&words, &container_options, &optimizer_options,
+                     &collector, module, i] {
+        // PassManager consumes its passes after one run, so each module gets
+        // a freshly configured Optimizer.
+        ModuleResult result;
+        spvtools::Optimizer optimizer(container_options.target_env);
+        optimizer.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+        if (optimizer.RegisterPassesFromFlags(container_options.pass_flags)) {
+          result.ok = optimizer.Run(words.data() + module.begin, module.count,
+                                    &result.optimized, optimizer_options);
+        }
+        collector.Deliver(i, std::move(result));
+      });
+    }
+    pool.Wait();
+  }
+  return all_ok && write_ok ? 0 : 1;
+}
+
+// Optimizes |binary| in waves of |container_options.wave_size| functions to
+// bound peak memory (--wave-size), and writes the stitched module to
+// |out_file|.  Returns the process exit code.
+int RunWaves(const std::vector<uint32_t>& binary, const char* out_file,
+             const ContainerOptions& container_options,
+             spvtools::OptimizerOptions& optimizer_options) {
+  spvtools::opt::ModuleWaves waves;
+  if (!waves.Split(binary.data(), binary.size(),
+                   spvtools::utils::CLIMessageConsumer)) {
+    return 1;
+  }
+
+  // Wave modules hold body-less declarations for the out-of-wave functions,
+  // which the validator rejects.
+  optimizer_options.set_run_validator(false);
+
+  for (size_t first = 0; first < waves.function_count();
+       first += container_options.wave_size) {
+    const size_t count =
+        std::min(container_options.wave_size, waves.function_count() - first);
+    std::vector<uint32_t> wave = waves.MakeWaveBinary(first, count);
+    // PassManager consumes its passes after one run, so each wave gets a
+    // freshly configured Optimizer.
+    spvtools::Optimizer optimizer(container_options.target_env);
+    optimizer.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+    if (!optimizer.RegisterPassesFromFlags(container_options.pass_flags)) {
+      return 1;
+    }
+    std::vector<uint32_t> optimized;
+    if (!optimizer.Run(wave.data(), wave.size(), &optimized,
+                       optimizer_options)) {
+      return 1;
+    }
+    if (!waves.AcceptWaveBinary(optimized,
+                                spvtools::utils::CLIMessageConsumer)) {
+      return 1;
+    }
+  }
+
+  const std::vector<uint32_t> out_words = waves.Finish();
+  if (!WriteFileMapped<uint32_t>(out_file, out_words.data(),
+                                 out_words.size())) {
+    return 1;
+  }
+  return 0;
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
@@ -828,8 +1132,13 @@ int main(int argc, const char** argv) {
 
   spvtools::ValidatorOptions validator_options;
   spvtools::OptimizerOptions optimizer_options;
-  OptStatus status = ParseFlags(argc, argv, &optimizer, &in_file, &out_file,
-                                &validator_options, &optimizer_options);
+  ContainerOptions container_options;
+  std::string summary_file;
+  std::string profile_file;
+  OptStatus status =
+      ParseFlags(argc, argv, &optimizer, &in_file, &out_file,
+                 &validator_options, &optimizer_options, &container_options,
+                 &summary_file, &profile_file);
   optimizer_options.set_validator_options(validator_options);
 
   if (status.action == OPT_STOP) {
@@ -841,17 +1150,97 @@ int main(int argc, const char** argv) {
     return 1;
   }
 
+  if (container_options.enabled && container_options.wave_size > 0) {
+    spvtools::Error(opt_diagnostic, nullptr, {},
+                    "--wave-size cannot be combined with --container");
+    return 1;
+  }
+
+  if (!summary_file.empty() &&
+      (container_options.enabled || container_options.wave_size > 0)) {
+    spvtools::Error(
+        opt_diagnostic, nullptr, {},
+        "--emit-summary cannot be combined with --container or --wave-size");
+    return 1;
+  }
+
+  if (!profile_file.empty() &&
+      (container_options.enabled || container_options.wave_size > 0)) {
+    spvtools::Error(
+        opt_diagnostic, nullptr, {},
+        "--profile-out cannot be combined with --container or --wave-size");
+    return 1;
+  }
+
+  if (container_options.enabled) {
+    return RunContainer(in_file, out_file, container_options,
+                        optimizer_options);
+  }
+
   std::vector<uint32_t> binary;
   if (!ReadBinaryFile<uint32_t>(in_file, &binary)) {
     return 1;
   }
 
+  if (container_options.wave_size > 0) {
+    return RunWaves(binary, out_file, container_options, optimizer_options);
+  }
+
+  std::vector<uint32_t> summary;
+  if (!summary_file.empty()) {
+    optimizer.SetEmitModuleSummary(&summary);
+  }
+
+  // The stream must outlive optimizer.Run(), which delivers one report per
+  // executed pass.
+  std::ofstream profile_stream;
+  if (!profile_file.empty()) {
+    profile_stream.open(profile_file, std::ios::app);
+    if (!profile_stream) {
+      spvtools::Error(opt_diagnostic, nullptr, {},
+                      "Could not open the --profile-out file");
+      return 1;
+    }
+    if (profile_stream.tellp() == std::ofstream::pos_type(0)) {
+      profile_stream << "module_hash,module_words,module_id_bound,pass_name,"
+                        "changed,wall_time,cpu_time,peak_rss_delta_kb,"
+                        "instructions_before,instructions_after,"
+                        "id_bound_before,id_bound_after,"
+                        "analyses_invalidated,analyses_built\n";
+    }
+    char module_hash[17];
+    snprintf(module_hash, sizeof(module_hash), "%016llx",
+             static_cast<unsigned long long>(FingerprintWords(binary)));
+    const std::string fingerprint =
+        std::string(module_hash) + "," + std::to_string(binary.size()) + "," +
+        std::to_string(binary.size() > 3 ? binary[3] : 0);
+    optimizer.SetPassReportConsumer(
+        [&profile_stream, fingerprint](const spvtools::PassReport& report) {
+          profile_stream << fingerprint << ',' << report.pass_name << ','
+                         << (report.changed ? 1 : 0) << ',' << report.wall_time
+                         << ',' << report.cpu_time << ','
+                         << report.peak_rss_delta << ','
+                         << report.instruction_count_before << ','
+                         << report.instruction_count_after << ','
+                         << report.id_bound_before << ','
+                         << report.id_bound_after << ','
+                         << report.analyses_invalidated << ','
+                         << report.analyses_built << '\n';
+        });
+  }
+
   // By using the same vector as input and output, we save time in the case
   // that there was no change.
   bool ok =
       optimizer.Run(binary.data(), binary.size(), &binary, optimizer_options);
 
-  if (!WriteFile<uint32_t>(out_file, "wb", binary.data(), binary.size())) {
+  if (!WriteFileMapped<uint32_t>(out_file, binary.data(), binary.size())) {
+    return 1;
+  }
+
+  if (ok && !summary_file.empty() &&
+      !WriteFile<uint32_t>(summary_file.c_str(), "wb", summary.data(),
+                           summary.size())) {
     return 1;
   }
 
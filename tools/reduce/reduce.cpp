@@ -16,7 +16,10 @@
 #include <cerrno>
 #include <cstring>
 #include <functional>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "source/opt/build_module.h"
 #include "source/opt/ir_context.h"
@@ -24,8 +27,10 @@
 #include "source/reduce/reducer.h"
 #include "source/spirv_reducer_options.h"
 #include "source/util/string_utils.h"
+#include "source/util/thread_pool.h"
 #include "tools/io.h"
 #include "tools/util/cli_consumer.h"
+#include "tools/util/file_list.h"
 
 namespace {
 
@@ -47,6 +52,47 @@ bool ExecuteCommand(const std::string& command) {
   return status == 0;
 }
 
+// Hashes a SPIR-V binary for use as an unordered_map key (FNV-1a).
+struct BinaryHash {
+  size_t operator()(const std::vector<uint32_t>& binary) const {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t word : binary) {
+      hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+// A thread-safe memo of interestingness-test verdicts, keyed by module
+// content.  Reduction steps frequently re-derive identical intermediate
+// modules - both within one reduction and across reductions of related
+// inputs - and the external interestingness test is by far the most
+// expensive part of a step, so repeated verdicts are served from the memo
+// instead of re-invoking the test.
+class InterestingnessCache {
+ public:
+  // Returns true and sets |*verdict| if a verdict for |binary| is cached.
+  bool Lookup(const std::vector<uint32_t>& binary, bool* verdict) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = verdicts_.find(binary);
+    if (it == verdicts_.end()) {
+      return false;
+    }
+    *verdict = it->second;
+    return true;
+  }
+
+  // Records |verdict| for |binary|.
+  void Insert(const std::vector<uint32_t>& binary, bool verdict) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    verdicts_.emplace(binary, verdict);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::vector<uint32_t>, bool, BinaryHash> verdicts_;
+};
+
 // Status and actions to perform after parsing command-line arguments.
 enum ReduceActions { REDUCE_CONTINUE, REDUCE_STOP };
 
@@ -95,11 +141,40 @@ NOTE: The reducer is a work in progress.
 
 Options (in lexicographical order):
 
+  --batch=<file>
+               Reduce every file named in <file> ("-" means standard input)
+               against the same interestingness test, instead of a single
+               input.  Each non-empty line names an input file, optionally
+               followed by an output file; when no output is given, one is
+               derived by replacing the input's extension with .reduced.spv.
+               Lines starting with '#' are comments.  All reductions share a
+               cache of interestingness verdicts keyed by module content, so
+               an intermediate module that has already been tested - by any
+               of the reductions - never re-invokes the test.  Cannot be
+               combined with an input file or -o.
   --fail-on-validation-error
                Stop reduction with an error if any reduction step produces a
                SPIR-V module that fails to validate.
   -h, --help
                Print this help.
+  --hierarchical
+               Reduce hierarchically: first try to remove whole functions,
+               then whole blocks, and only then descend to individual
+               instructions.  Large modules typically reach a reduced form in
+               far fewer invocations of the interestingness test this way.
+  --jobs=
+               32-bit unsigned integer specifying how many reductions from a
+               --batch file list run concurrently.  Defaults to 1; 0 uses one
+               reduction per hardware thread.
+  --parallelism=
+               32-bit unsigned integer specifying how many candidate reduction
+               steps may be evaluated concurrently, running the
+               interestingness test on each of them in parallel.  The default
+               of 1 keeps reduction single-threaded, and 0 uses one candidate
+               per hardware thread.  The reduced binary is the same regardless
+               of this setting.  The interestingness test must tolerate
+               concurrent invocations, which is the case for tests that derive
+               any temporary file names from the step number they are given.
   --step-limit=
                32-bit unsigned integer specifying maximum number of steps the
                reducer will take before giving up.
@@ -147,6 +222,7 @@ ReduceStatus ParseFlags(int argc, const char** argv,
                         std::string* out_binary_file,
                         std::vector<std::string>* interestingness_test,
                         std::string* temp_file_prefix,
+                        std::string* batch_file_list, uint32_t* jobs,
                         spvtools::ReducerOptions* reducer_options,
                         spvtools::ValidatorOptions* validator_options) {
   uint32_t positional_arg_index = 0;
@@ -187,6 +263,27 @@ ReduceStatus ParseFlags(int argc, const char** argv,
             static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
         assert(end != split_flag.second.c_str() && errno == 0);
         reducer_options->set_target_function(target_function);
+      } else if (0 == strncmp(cur_arg,
+                              "--parallelism=", sizeof("--parallelism=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        char* end = nullptr;
+        errno = 0;
+        const auto parallelism =
+            static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
+        assert(end != split_flag.second.c_str() && errno == 0);
+        reducer_options->set_parallelism(parallelism);
+      } else if (0 == strncmp(cur_arg, "--batch=", sizeof("--batch=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        *batch_file_list = std::string(split_flag.second);
+      } else if (0 == strncmp(cur_arg, "--jobs=", sizeof("--jobs=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        char* end = nullptr;
+        errno = 0;
+        *jobs =
+            static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
+        assert(end != split_flag.second.c_str() && errno == 0);
+      } else if (0 == strcmp(cur_arg, "--hierarchical")) {
+        reducer_options->set_hierarchical_reduction(true);
       } else if (0 == strcmp(cur_arg, "--fail-on-validation-error")) {
         reducer_options->set_fail_on_validation_error(true);
       } else if (0 == strcmp(cur_arg, "--before-hlsl-legalization")) {
@@ -224,14 +321,22 @@ ReduceStatus ParseFlags(int argc, const char** argv,
     }
   }
 
-  if (in_binary_file->empty()) {
-    spvtools::Error(ReduceDiagnostic, nullptr, {}, "No input file specified");
-    return {REDUCE_STOP, 1};
-  }
+  if (!batch_file_list->empty()) {
+    if (!in_binary_file->empty() || !out_binary_file->empty()) {
+      spvtools::Error(ReduceDiagnostic, nullptr, {},
+                      "--batch cannot be combined with an input file or -o");
+      return {REDUCE_STOP, 1};
+    }
+  } else {
+    if (in_binary_file->empty()) {
+      spvtools::Error(ReduceDiagnostic, nullptr, {}, "No input file specified");
+      return {REDUCE_STOP, 1};
+    }
 
-  if (out_binary_file->empty()) {
-    spvtools::Error(ReduceDiagnostic, nullptr, {}, "-o required");
-    return {REDUCE_STOP, 1};
+    if (out_binary_file->empty()) {
+      spvtools::Error(ReduceDiagnostic, nullptr, {}, "-o required");
+      return {REDUCE_STOP, 1};
+    }
   }
 
   if (interestingness_test->empty()) {
@@ -264,42 +369,30 @@ void DumpShader(spvtools::opt::IRContext* context, const char* filename) {
 
 const auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_6;
 
-int main(int argc, const char** argv) {
-  std::string in_binary_file;
-  std::string out_binary_file;
-  std::vector<std::string> interestingness_test;
-  std::string temp_file_prefix = "temp_";
-
-  spv_target_env target_env = kDefaultEnvironment;
-  spvtools::ReducerOptions reducer_options;
-  spvtools::ValidatorOptions validator_options;
-
-  ReduceStatus status = ParseFlags(
-      argc, argv, &in_binary_file, &out_binary_file, &interestingness_test,
-      &temp_file_prefix, &reducer_options, &validator_options);
-
-  if (status.action == REDUCE_STOP) {
-    return status.code;
-  }
-
-  if (!CheckExecuteCommand()) {
-    std::cerr << "could not find shell interpreter for executing a command"
-              << std::endl;
-    return 2;
-  }
-
-  spvtools::reduce::Reducer reducer(target_env);
-
-  std::stringstream joined;
-  joined << interestingness_test[0];
-  for (size_t i = 1, size = interestingness_test.size(); i < size; ++i) {
-    joined << " " << interestingness_test[i];
-  }
-  std::string interestingness_command_joined = joined.str();
+// Runs a single reduction of |in_binary_file| against the joined
+// interestingness command, writing the result to |out_binary_file|.
+// Candidate modules are written to files named with |temp_file_prefix|.
+// |cache| memoizes interestingness verdicts and may be shared with
+// concurrent reductions of other inputs.  Diagnostics are sent to
+// |consumer|.  Returns the exit code for the reduction.
+static int RunReduction(const std::string& in_binary_file,
+                        const std::string& out_binary_file,
+                        const std::string& interestingness_command_joined,
+                        const std::string& temp_file_prefix,
+                        const spvtools::ReducerOptions& reducer_options,
+                        const spvtools::ValidatorOptions& validator_options,
+                        InterestingnessCache* cache,
+                        const spvtools::MessageConsumer& consumer) {
+  spvtools::reduce::Reducer reducer(kDefaultEnvironment);
 
   reducer.SetInterestingnessFunction(
-      [interestingness_command_joined, temp_file_prefix](
+      [interestingness_command_joined, temp_file_prefix, cache](
           std::vector<uint32_t> binary, uint32_t reductions_applied) -> bool {
+        bool verdict = false;
+        if (cache->Lookup(binary, &verdict)) {
+          return verdict;
+        }
+
         std::stringstream ss;
         ss << temp_file_prefix << std::setw(4) << std::setfill('0')
            << reductions_applied << ".spv";
@@ -310,12 +403,14 @@ int main(int argc, const char** argv) {
             WriteFile(spv_file.c_str(), "wb", &binary[0], binary.size());
         (void)(write_file_succeeded);
         assert(write_file_succeeded);
-        return ExecuteCommand(command);
+        verdict = ExecuteCommand(command);
+        cache->Insert(binary, verdict);
+        return verdict;
       });
 
   reducer.AddDefaultReductionPasses();
 
-  reducer.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+  reducer.SetMessageConsumer(consumer);
 
   std::vector<uint32_t> binary_in;
   if (!ReadBinaryFile<uint32_t>(in_binary_file.c_str(), &binary_in)) {
@@ -326,8 +421,7 @@ int main(int argc, const char** argv) {
   if (target_function) {
     // A target function was specified; check that it exists.
     std::unique_ptr<spvtools::opt::IRContext> context = spvtools::BuildModule(
-        kDefaultEnvironment, spvtools::utils::CLIMessageConsumer,
-        binary_in.data(), binary_in.size());
+        kDefaultEnvironment, consumer, binary_in.data(), binary_in.size());
     bool found_target_function = false;
     for (auto& function : *context->module()) {
       if (function.result_id() == target_function) {
@@ -339,8 +433,7 @@ int main(int argc, const char** argv) {
       std::stringstream strstr;
       strstr << "Target function with id " << target_function
              << " was requested, but not found in the module; stopping.";
-      spvtools::utils::CLIMessageConsumer(SPV_MSG_ERROR, nullptr, {},
-                                          strstr.str().c_str());
+      consumer(SPV_MSG_ERROR, nullptr, {}, strstr.str().c_str());
       return 1;
     }
   }
@@ -366,3 +459,103 @@ int main(int argc, const char** argv) {
 
   return 1;
 }
+
+int main(int argc, const char** argv) {
+  std::string in_binary_file;
+  std::string out_binary_file;
+  std::vector<std::string> interestingness_test;
+  std::string temp_file_prefix = "temp_";
+  std::string batch_file_list;
+  uint32_t jobs = 1;
+
+  spvtools::ReducerOptions reducer_options;
+  spvtools::ValidatorOptions validator_options;
+
+  ReduceStatus status =
+      ParseFlags(argc, argv, &in_binary_file, &out_binary_file,
+                 &interestingness_test, &temp_file_prefix, &batch_file_list,
+                 &jobs, &reducer_options, &validator_options);
+
+  if (status.action == REDUCE_STOP) {
+    return status.code;
+  }
+
+  if (!CheckExecuteCommand()) {
+    std::cerr << "could not find shell interpreter for executing a command"
+              << std::endl;
+    return 2;
+  }
+
+  std::stringstream joined;
+  joined << interestingness_test[0];
+  for (size_t i = 1, size = interestingness_test.size(); i < size; ++i) {
+    joined << " " << interestingness_test[i];
+  }
+  std::string interestingness_command_joined = joined.str();
+
+  // Verdicts can be shared between reductions because every reduction in a
+  // run uses the same interestingness command.
+  InterestingnessCache cache;
+
+  if (batch_file_list.empty()) {
+    return RunReduction(in_binary_file, out_binary_file,
+                        interestingness_command_joined, temp_file_prefix,
+                        reducer_options, validator_options, &cache,
+                        spvtools::utils::CLIMessageConsumer);
+  }
+
+  std::vector<FileListEntry> files;
+  if (!ReadFileList(batch_file_list.c_str(), ".reduced.spv", &files)) {
+    return 1;
+  }
+
+  // Each worker buffers its diagnostics here; they are replayed in input
+  // order once all reductions have finished so the output is deterministic.
+  struct FileResult {
+    int code = 0;
+    std::string messages;
+  };
+  std::vector<FileResult> results(files.size());
+  {
+    const size_t num_threads =
+        jobs == 0 ? spvtools::utils::ThreadPool::DefaultThreadCount() : jobs;
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Schedule([&files, &results, &interestingness_command_joined,
+                     &temp_file_prefix, &reducer_options, &validator_options,
+                     &cache, i] {
+        auto consumer = [&results, i](spv_message_level_t level, const char*,
+                                      const spv_position_t&,
+                                      const char* message) {
+          if (level == SPV_MSG_ERROR || level == SPV_MSG_FATAL ||
+              level == SPV_MSG_INTERNAL_ERROR) {
+            results[i].messages += "error: ";
+          }
+          results[i].messages += message;
+          results[i].messages += "\n";
+        };
+        // Give each reduction its own temporary-file namespace so concurrent
+        // reductions do not overwrite each other's candidates.
+        const std::string prefix = temp_file_prefix + std::to_string(i) + "_";
+        results[i].code = RunReduction(
+            files[i].input, files[i].output, interestingness_command_joined,
+            prefix, reducer_options, validator_options, &cache, consumer);
+      });
+    }
+    pool.Wait();
+  }
+
+  int num_failures = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!results[i].messages.empty()) {
+      fprintf(stderr, "%s:\n%s", files[i].input.c_str(),
+              results[i].messages.c_str());
+    }
+    if (results[i].code != 0) {
+      fprintf(stderr, "error: failed to reduce '%s'\n",
+              files[i].input.c_str());
+      num_failures++;
+    }
+  }
+  return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/stats/spirv_stats.h"
+
+#include "source/enum_string_mapping.h"
+#include "source/opcode.h"
+
+namespace spvtools {
+namespace stats {
+namespace {
+
+spv_result_t HandleHeaderThunk(void* user_data, spv_endianness_t /*endian*/,
+                               uint32_t /*magic*/, uint32_t version,
+                               uint32_t generator, uint32_t id_bound,
+                               uint32_t /*reserved*/) {
+  auto* collectors = static_cast<std::vector<Collector*>*>(user_data);
+  for (Collector* collector : *collectors) {
+    collector->HandleHeader(version, generator, id_bound);
+  }
+  return SPV_SUCCESS;
+}
+
+spv_result_t HandleInstructionThunk(void* user_data,
+                                    const spv_parsed_instruction_t* inst) {
+  auto* collectors = static_cast<std::vector<Collector*>*>(user_data);
+  for (Collector* collector : *collectors) {
+    collector->HandleInstruction(*inst);
+  }
+  return SPV_SUCCESS;
+}
+
+}  // anonymous namespace
+
+spv_result_t StatsAggregator::Aggregate(spv_const_context context,
+                                        const uint32_t* words,
+                                        size_t num_words,
+                                        spv_diagnostic* diagnostic) {
+  const spv_result_t result =
+      spvBinaryParse(context, &collectors_, words, num_words,
+                     HandleHeaderThunk, HandleInstructionThunk, diagnostic);
+  if (result == SPV_SUCCESS) ++num_modules_;
+  return result;
+}
+
+void StatsAggregator::Report(std::ostream& out) const {
+  for (const Collector* collector : collectors_) {
+    collector->Report(out);
+  }
+}
+
+void OpcodeHistogramCollector::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  ++counts_[inst.opcode];
+}
+
+void OpcodeHistogramCollector::Report(std::ostream& out) const {
+  out << "Opcode histogram:\n";
+  for (const auto& pair : counts_) {
+    out << "  " << spvOpcodeString(pair.first) << " " << pair.second << "\n";
+  }
+}
+
+void TypeCountCollector::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  if (spvOpcodeGeneratesType(static_cast<spv::Op>(inst.opcode))) {
+    ++counts_[inst.opcode];
+  }
+}
+
+void TypeCountCollector::Report(std::ostream& out) const {
+  out << "Type declarations:\n";
+  for (const auto& pair : counts_) {
+    out << "  " << spvOpcodeString(pair.first) << " " << pair.second << "\n";
+  }
+}
+
+void CapabilityCollector::HandleHeader(uint32_t /*version*/,
+                                       uint32_t /*generator*/,
+                                       uint32_t /*id_bound*/) {
+  current_module_.clear();
+}
+
+void CapabilityCollector::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  if (static_cast<spv::Op>(inst.opcode) != spv::Op::OpCapability) return;
+  const uint32_t capability = inst.words[1];
+  if (current_module_.insert(capability).second) ++counts_[capability];
+}
+
+void CapabilityCollector::Report(std::ostream& out) const {
+  out << "Capabilities (modules declaring):\n";
+  for (const auto& pair : counts_) {
+    out << "  "
+        << CapabilityToString(static_cast<spv::Capability>(pair.first)) << " "
+        << pair.second << "\n";
+  }
+}
+
+void CfgShapeCollector::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  switch (static_cast<spv::Op>(inst.opcode)) {
+    case spv::Op::OpFunction:
+      ++num_functions_;
+      blocks_in_current_function_ = 0;
+      break;
+    case spv::Op::OpLabel:
+      ++num_blocks_;
+      ++blocks_in_current_function_;
+      if (blocks_in_current_function_ > max_blocks_in_function_) {
+        max_blocks_in_function_ = blocks_in_current_function_;
+      }
+      break;
+    case spv::Op::OpBranch:
+      ++num_branches_;
+      break;
+    case spv::Op::OpBranchConditional:
+      ++num_conditional_branches_;
+      break;
+    case spv::Op::OpSwitch:
+      ++num_switches_;
+      break;
+    case spv::Op::OpLoopMerge:
+      ++num_loop_merges_;
+      break;
+    case spv::Op::OpSelectionMerge:
+      ++num_selection_merges_;
+      break;
+    case spv::Op::OpReturn:
+    case spv::Op::OpReturnValue:
+      ++num_returns_;
+      break;
+    default:
+      break;
+  }
+}
+
+void CfgShapeCollector::Report(std::ostream& out) const {
+  out << "CFG shape:\n";
+  out << "  functions " << num_functions_ << "\n";
+  out << "  blocks " << num_blocks_ << "\n";
+  out << "  max blocks in a function " << max_blocks_in_function_ << "\n";
+  out << "  branches " << num_branches_ << "\n";
+  out << "  conditional branches " << num_conditional_branches_ << "\n";
+  out << "  switches " << num_switches_ << "\n";
+  out << "  loop merges " << num_loop_merges_ << "\n";
+  out << "  selection merges " << num_selection_merges_ << "\n";
+  out << "  returns " << num_returns_ << "\n";
+}
+
+}  // namespace stats
+}  // namespace spvtools
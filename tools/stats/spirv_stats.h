@@ -0,0 +1,141 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOOLS_STATS_SPIRV_STATS_H_
+#define TOOLS_STATS_SPIRV_STATS_H_
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
+#include "spirv-tools/libspirv.h"
+
+namespace spvtools {
+namespace stats {
+
+// A metric gathered over a stream of parsed instructions.  Collectors are
+// registered with a StatsAggregator, which drives them all from a single
+// spvBinaryParse pass over each module so the parse cost is shared by every
+// metric.  Counts accumulate across modules until Report is called.
+class Collector {
+ public:
+  virtual ~Collector() = default;
+
+  // Called once per module, before any instructions, with the module header
+  // fields.
+  virtual void HandleHeader(uint32_t /*version*/, uint32_t /*generator*/,
+                            uint32_t /*id_bound*/) {}
+
+  // Called once per instruction, in stream order.  |inst| is transient: it
+  // must not be retained after the call returns.
+  virtual void HandleInstruction(const spv_parsed_instruction_t& inst) = 0;
+
+  // Writes a human-readable report of the accumulated counts to |out|.
+  virtual void Report(std::ostream& out) const = 0;
+};
+
+// Fuses any number of registered collectors into one streaming pass per
+// module.  Collectors are not owned and must outlive the aggregator.
+class StatsAggregator {
+ public:
+  // Registers |collector| to receive every module header and instruction
+  // from subsequent Aggregate calls.
+  void RegisterCollector(Collector* collector) {
+    collectors_.push_back(collector);
+  }
+
+  // Parses the module in |words| once and feeds each instruction to every
+  // registered collector.  On failure returns the parse status and, if
+  // |diagnostic| is non-null, a diagnostic describing the failure.
+  spv_result_t Aggregate(spv_const_context context, const uint32_t* words,
+                         size_t num_words, spv_diagnostic* diagnostic);
+
+  // Writes the reports of all registered collectors to |out|.
+  void Report(std::ostream& out) const;
+
+  // Returns the number of modules successfully aggregated so far.
+  uint64_t num_modules() const { return num_modules_; }
+
+ private:
+  std::vector<Collector*> collectors_;
+  uint64_t num_modules_ = 0;
+};
+
+// Counts how many times each opcode appears.
+class OpcodeHistogramCollector : public Collector {
+ public:
+  void HandleInstruction(const spv_parsed_instruction_t& inst) override;
+  void Report(std::ostream& out) const override;
+
+  const std::map<uint32_t, uint64_t>& counts() const { return counts_; }
+
+ private:
+  std::map<uint32_t, uint64_t> counts_;
+};
+
+// Counts type declarations, keyed by the type-declaring opcode.
+class TypeCountCollector : public Collector {
+ public:
+  void HandleInstruction(const spv_parsed_instruction_t& inst) override;
+  void Report(std::ostream& out) const override;
+
+  const std::map<uint32_t, uint64_t>& counts() const { return counts_; }
+
+ private:
+  std::map<uint32_t, uint64_t> counts_;
+};
+
+// Counts how many modules declare each capability.
+class CapabilityCollector : public Collector {
+ public:
+  void HandleHeader(uint32_t version, uint32_t generator,
+                    uint32_t id_bound) override;
+  void HandleInstruction(const spv_parsed_instruction_t& inst) override;
+  void Report(std::ostream& out) const override;
+
+  const std::map<uint32_t, uint64_t>& counts() const { return counts_; }
+
+ private:
+  // Capabilities seen in the module currently being parsed, so duplicate
+  // OpCapability declarations are counted once per module.
+  std::set<uint32_t> current_module_;
+  std::map<uint32_t, uint64_t> counts_;
+};
+
+// Measures the shape of the control flow graphs: function and block counts,
+// branch mix, and structured construct counts.
+class CfgShapeCollector : public Collector {
+ public:
+  void HandleInstruction(const spv_parsed_instruction_t& inst) override;
+  void Report(std::ostream& out) const override;
+
+ private:
+  uint64_t num_functions_ = 0;
+  uint64_t num_blocks_ = 0;
+  uint64_t num_branches_ = 0;
+  uint64_t num_conditional_branches_ = 0;
+  uint64_t num_switches_ = 0;
+  uint64_t num_loop_merges_ = 0;
+  uint64_t num_selection_merges_ = 0;
+  uint64_t num_returns_ = 0;
+  uint64_t max_blocks_in_function_ = 0;
+  uint64_t blocks_in_current_function_ = 0;
+};
+
+}  // namespace stats
+}  // namespace spvtools
+
+#endif  // TOOLS_STATS_SPIRV_STATS_H_
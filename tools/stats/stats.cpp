@@ -0,0 +1,104 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "spirv-tools/libspirv.h"
+#include "tools/io.h"
+#include "tools/stats/spirv_stats.h"
+#include "tools/util/flags.h"
+
+static const auto kDefaultEnvironment = SPV_ENV_UNIVERSAL_1_6;
+static const std::string kHelpText =
+    R"(%s - Collect statistics over SPIR-V binaries. EXPERIMENTAL
+
+Usage: %s [options] <filename> [<filename>...]
+
+Each SPIR-V binary is parsed once, and all statistics are gathered from
+that single pass: an opcode histogram, type declaration counts,
+capability usage, and control flow graph shape metrics.  The counts are
+accumulated over all inputs and one combined report is written to
+standard output.
+
+Options:
+
+  -h, --help      Print this help.
+  --version       Display version information.
+)";
+
+// clang-format off
+FLAG_SHORT_bool(h,       /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool( help,    /* default_value= */ false, /* required= */ false);
+FLAG_LONG_bool( version, /* default_value= */ false, /* required= */ false);
+// clang-format on
+
+int main(int, const char** argv) {
+  if (!flags::Parse(argv)) {
+    return 1;
+  }
+
+  if (flags::h.value() || flags::help.value()) {
+    printf(kHelpText.c_str(), argv[0], argv[0]);
+    return 0;
+  }
+
+  if (flags::version.value()) {
+    printf("%s EXPERIMENTAL\n", spvSoftwareVersionDetailsString());
+    printf("Target: %s\n", spvTargetEnvDescription(kDefaultEnvironment));
+    return 0;
+  }
+
+  if (flags::positional_arguments.empty()) {
+    fprintf(stderr, "error: at least one input file must be specified.\n");
+    return 1;
+  }
+
+  spvtools::stats::OpcodeHistogramCollector opcodes;
+  spvtools::stats::TypeCountCollector types;
+  spvtools::stats::CapabilityCollector capabilities;
+  spvtools::stats::CfgShapeCollector cfg_shape;
+
+  spvtools::stats::StatsAggregator aggregator;
+  aggregator.RegisterCollector(&opcodes);
+  aggregator.RegisterCollector(&types);
+  aggregator.RegisterCollector(&capabilities);
+  aggregator.RegisterCollector(&cfg_shape);
+
+  spv_context context = spvContextCreate(kDefaultEnvironment);
+  int num_failures = 0;
+  for (const std::string& input : flags::positional_arguments) {
+    std::vector<uint32_t> contents;
+    if (!ReadBinaryFile<uint32_t>(input.c_str(), &contents)) {
+      num_failures++;
+      continue;
+    }
+    spv_diagnostic diagnostic = nullptr;
+    if (aggregator.Aggregate(context, contents.data(), contents.size(),
+                             &diagnostic) != SPV_SUCCESS) {
+      fprintf(stderr, "error: could not parse '%s': %s\n", input.c_str(),
+              diagnostic ? diagnostic->error : "");
+      num_failures++;
+    }
+    spvDiagnosticDestroy(diagnostic);
+  }
+  spvContextDestroy(context);
+
+  std::cout << "Modules: " << aggregator.num_modules() << "\n";
+  aggregator.Report(std::cout);
+
+  return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOOLS_UTIL_ASYNC_IO_H_
+#define TOOLS_UTIL_ASYNC_IO_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tools/io.h"
+
+// Background file I/O for the batch modes of the command line tools.  A
+// dedicated reader thread issues the read of input N+1 while the tool is
+// still processing input N, and a dedicated writer thread retires the write
+// of result N-1 behind it, so compute threads rarely block on the
+// filesystem.
+
+// Reads a list of binary files on a background thread, ahead of the
+// consumer.  Files are read in list order; consumers pick up each file's
+// contents with Take().  The reader stays at most |lookahead| unconsumed
+// files ahead, which bounds the memory held by prefetched contents.
+class AsyncBinaryFileReader {
+ public:
+  // Starts a background thread reading the files named in |paths|.
+  AsyncBinaryFileReader(std::vector<std::string> paths, size_t lookahead)
+      : paths_(std::move(paths)),
+        entries_(paths_.size()),
+        lookahead_(lookahead == 0 ? 1 : lookahead) {
+    reader_ = std::thread([this] { ReadLoop(); });
+  }
+
+  ~AsyncBinaryFileReader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      abort_ = true;
+    }
+    cond_.notify_all();
+    reader_.join();
+  }
+
+  // Blocks until file |index| has been read, then moves its contents into
+  // |contents|.  Returns false if reading failed; an error message has
+  // already been written to standard error.  Each index must be taken at
+  // most once.
+  bool Take(size_t index, std::vector<uint32_t>* contents) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this, index] { return entries_[index].done; });
+    *contents = std::move(entries_[index].words);
+    entries_[index].words = std::vector<uint32_t>();
+    ++num_taken_;
+    const bool ok = entries_[index].ok;
+    lock.unlock();
+    // The reader may be waiting for the prefetch window to move.
+    cond_.notify_all();
+    return ok;
+  }
+
+ private:
+  struct Entry {
+    std::vector<uint32_t> words;
+    bool done = false;
+    bool ok = false;
+  };
+
+  void ReadLoop() {
+    for (size_t i = 0; i < paths_.size(); ++i) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, i] {
+          return abort_ || i < num_taken_ + lookahead_;
+        });
+        if (abort_) return;
+      }
+      std::vector<uint32_t> words;
+      const bool ok = ReadBinaryFile<uint32_t>(paths_[i].c_str(), &words);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[i].words = std::move(words);
+        entries_[i].ok = ok;
+        entries_[i].done = true;
+      }
+      cond_.notify_all();
+    }
+  }
+
+  std::vector<std::string> paths_;
+  std::vector<Entry> entries_;
+  size_t lookahead_;
+  size_t num_taken_ = 0;
+  bool abort_ = false;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread reader_;
+};
+
+// Writes whole files on a background thread.  Write() queues a file and
+// returns immediately; Finish() drains the queue.  Writes happen in the
+// order they were queued.
+class AsyncFileWriter {
+ public:
+  AsyncFileWriter() { writer_ = std::thread([this] { WriteLoop(); }); }
+
+  ~AsyncFileWriter() {
+    if (writer_.joinable()) Finish();
+  }
+
+  // Queues |contents| to be written to |path| with fopen() mode |mode|.  If
+  // the write fails and |error| is not null, a message naming |path| is
+  // stored there; |*error| must stay alive until Finish() returns and is
+  // not otherwise touched by the caller in the meantime.
+  void Write(std::string path, const char* mode, std::string contents,
+             std::string* error) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back({std::move(path), mode, std::move(contents), error});
+    }
+    cond_.notify_all();
+  }
+
+  // Waits until every queued file has been written.  Returns false if any
+  // write failed; error messages have already been written to standard
+  // error.
+  bool Finish() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cond_.notify_all();
+    writer_.join();
+    return all_ok_;
+  }
+
+ private:
+  struct Job {
+    std::string path;
+    const char* mode;
+    std::string contents;
+    std::string* error;
+  };
+
+  void WriteLoop() {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) return;
+        job = std::move(jobs_.front());
+        jobs_.erase(jobs_.begin());
+      }
+      if (!WriteFile<char>(job.path.c_str(), job.mode, job.contents.data(),
+                           job.contents.size())) {
+        all_ok_ = false;
+        if (job.error) {
+          *job.error = "error: could not write '" + job.path + "'";
+        }
+      }
+    }
+  }
+
+  std::vector<Job> jobs_;
+  bool closed_ = false;
+  bool all_ok_ = true;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread writer_;
+};
+
+#endif  // TOOLS_UTIL_ASYNC_IO_H_
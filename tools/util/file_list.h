@@ -0,0 +1,90 @@
+// Copyright (c) 2023 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOOLS_UTIL_FILE_LIST_H_
+#define TOOLS_UTIL_FILE_LIST_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tools/io.h"
+
+// One entry from a batch file list: an input path, and the output path the
+// result of processing it should be written to.
+struct FileListEntry {
+  std::string input;
+  std::string output;
+};
+
+// Reads the batch file list at |path| ("-" means standard input).  Each
+// non-empty line names an input file, optionally followed by whitespace and
+// an output file; lines whose first non-blank character is '#' are comments.
+// When a line gives no output, one is derived from the input by replacing its
+// file extension with |default_extension| (or appending it when the input has
+// none).  Returns true on success and fills |*entries|; on failure an error
+// message has been written to standard error.
+inline bool ReadFileList(const char* path, const char* default_extension,
+                         std::vector<FileListEntry>* entries) {
+  std::vector<char> contents;
+  if (!ReadTextFile<char>(path, &contents)) return false;
+
+  const std::string text(contents.begin(), contents.end());
+  size_t line_start = 0;
+  while (line_start < text.size()) {
+    size_t line_end = text.find('\n', line_start);
+    if (line_end == std::string::npos) line_end = text.size();
+    std::string line = text.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+
+    const size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] == '#') continue;
+
+    FileListEntry entry;
+    const size_t input_end = line.find_first_of(" \t", first);
+    entry.input = line.substr(
+        first, input_end == std::string::npos ? input_end : input_end - first);
+    if (input_end != std::string::npos) {
+      const size_t second = line.find_first_not_of(" \t", input_end);
+      if (second != std::string::npos) {
+        const size_t output_end = line.find_first_of(" \t", second);
+        entry.output = line.substr(second, output_end == std::string::npos
+                                               ? output_end
+                                               : output_end - second);
+      }
+    }
+    if (entry.output.empty()) {
+      // Replace the input's extension, taking care not to mistake a dot in a
+      // directory name for the start of an extension.
+      const size_t separator = entry.input.find_last_of("/\\");
+      const size_t dot = entry.input.find_last_of('.');
+      if (dot != std::string::npos &&
+          (separator == std::string::npos || dot > separator)) {
+        entry.output = entry.input.substr(0, dot) + default_extension;
+      } else {
+        entry.output = entry.input + default_extension;
+      }
+    }
+    entries->push_back(std::move(entry));
+  }
+
+  if (entries->empty()) {
+    fprintf(stderr, "error: file list '%s' names no input files\n", path);
+    return false;
+  }
+  return true;
+}
+
+#endif  // TOOLS_UTIL_FILE_LIST_H_
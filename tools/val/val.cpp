@@ -15,13 +15,18 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "source/spirv_target_env.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/ordered_collector.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.hpp"
 #include "tools/io.h"
+#include "tools/util/async_io.h"
 #include "tools/util/cli_consumer.h"
 
 void print_usage(char* argv0) {
@@ -68,6 +73,15 @@ Options:
                                    be allowed by the target environment.
   --before-hlsl-legalization       Allows code patterns that are intended to be
                                    fixed by spirv-opt's legalization passes.
+  --batch <filelist>               Validate every file named in <filelist>, one
+                                   path per line, instead of a single input.
+                                   Nothing is printed for files that pass;
+                                   failures are reported per file and a summary
+                                   line gives the aggregate result.  Cannot be
+                                   combined with <filename>.
+  -j <N>                           In --batch mode, validate files on N worker
+                                   threads.  An N of 0 selects one thread per
+                                   hardware core, and is the default.
   --version                        Display validator version information.
   --target-env                     {%s}
                                    Use validation rules from the specified environment.
@@ -75,8 +89,91 @@ Options:
       argv0, argv0, target_env_list.c_str());
 }
 
+// Validates every file named in |filelist| (one path per line) against
+// |target_env| and |options|, spreading the files across |num_threads| worker
+// threads.  The grammar tables behind the shared |spv_context| are read-only,
+// so one context serves every thread; each validation call gets its own
+// diagnostic.  Returns the process exit code: 0 if and only if every file was
+// read and validated successfully.
+int ValidateBatch(const char* filelist, spv_target_env target_env,
+                  const spvtools::ValidatorOptions& options,
+                  size_t num_threads) {
+  std::ifstream list_stream(filelist);
+  if (!list_stream) {
+    fprintf(stderr, "error: failed to open file list '%s'\n", filelist);
+    return 1;
+  }
+  std::vector<std::string> paths;
+  for (std::string line; std::getline(list_stream, line);) {
+    if (!line.empty()) paths.push_back(line);
+  }
+
+  struct FileResult {
+    bool passed = false;
+    std::string message;
+  };
+
+  spv_context context = spvContextCreate(target_env);
+  size_t num_passed = 0;
+  {
+    // Prefetch file contents on a dedicated thread so the workers validate
+    // one file while the next is still being read.  A window of twice the
+    // worker count keeps every worker supplied without buffering the whole
+    // list.
+    const size_t num_workers =
+        num_threads == 0 ? spvtools::utils::ThreadPool::DefaultThreadCount()
+                         : num_threads;
+    AsyncBinaryFileReader reader(paths, 2 * num_workers);
+    // Failures are reported in input order as soon as every earlier file is
+    // done, so output is deterministic regardless of scheduling and nothing
+    // is buffered beyond the collector's window.
+    spvtools::utils::OrderedCollector<FileResult> collector(
+        2 * num_workers,
+        [&paths, &num_passed](size_t i, FileResult&& result) {
+          if (result.passed) {
+            ++num_passed;
+          } else {
+            fprintf(stderr, "error: %s: %s\n", paths[i].c_str(),
+                    result.message.c_str());
+          }
+        });
+    spvtools::utils::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < paths.size(); ++i) {
+      pool.Schedule([&options, &reader, &collector, context, i]() {
+        FileResult result;
+        std::vector<uint32_t> contents;
+        if (!reader.Take(i, &contents)) {
+          result.message = "failed to read file";
+          collector.Deliver(i, std::move(result));
+          return;
+        }
+        spv_const_binary_t binary{contents.data(), contents.size()};
+        spv_diagnostic diagnostic = nullptr;
+        const spv_result_t valid =
+            spvValidateWithOptions(context, options, &binary, &diagnostic);
+        if (valid == SPV_SUCCESS) {
+          result.passed = true;
+        } else if (diagnostic && diagnostic->error) {
+          result.message = diagnostic->error;
+        } else {
+          result.message = "validation failed";
+        }
+        spvDiagnosticDestroy(diagnostic);
+        collector.Deliver(i, std::move(result));
+      });
+    }
+    pool.Wait();
+  }
+  spvContextDestroy(context);
+
+  printf("%zu of %zu files passed validation\n", num_passed, paths.size());
+  return num_passed == paths.size() ? 0 : 1;
+}
+
 int main(int argc, char** argv) {
   const char* inFile = nullptr;
+  const char* batch_filelist = nullptr;
+  size_t num_threads = 0;
   spv_target_env target_env = SPV_ENV_UNIVERSAL_1_6;
   spvtools::ValidatorOptions options;
   bool continue_processing = true;
@@ -144,6 +241,29 @@ int main(int argc, char** argv) {
           continue_processing = false;
           return_code = 1;
         }
+      } else if (0 == strcmp(cur_arg, "--batch")) {
+        if (argi + 1 < argc) {
+          batch_filelist = argv[++argi];
+        } else {
+          fprintf(stderr, "error: Missing argument to --batch\n");
+          continue_processing = false;
+          return_code = 1;
+        }
+      } else if (0 == strcmp(cur_arg, "-j")) {
+        if (argi + 1 < argc) {
+          unsigned count = 0;
+          if (sscanf(argv[++argi], "%u", &count)) {
+            num_threads = count;
+          } else {
+            fprintf(stderr, "error: invalid argument to -j: %s\n", argv[argi]);
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to -j\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == strcmp(cur_arg, "--before-hlsl-legalization")) {
         options.SetBeforeHlslLegalization(true);
       } else if (0 == strcmp(cur_arg, "--relax-logical-pointer")) {
@@ -192,6 +312,18 @@ int main(int argc, char** argv) {
     return return_code;
   }
 
+  if (batch_filelist) {
+    if (inFile) {
+      fprintf(stderr,
+              "error: --batch cannot be combined with an input file\n");
+      return 1;
+    }
+    if (num_threads == 0) {
+      num_threads = spvtools::utils::ThreadPool::DefaultThreadCount();
+    }
+    return ValidateBatch(batch_filelist, target_env, options, num_threads);
+  }
+
   std::vector<uint32_t> contents;
   if (!ReadBinaryFile<uint32_t>(inFile, &contents)) return 1;
 